@@ -0,0 +1,73 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef COMMON_BASE_ARENA_H_
+#define COMMON_BASE_ARENA_H_
+
+#include "base/Base.h"
+
+namespace nebula {
+
+/**
+ * Allocate memory from large blocks, which are freed all together on destruction.
+ *
+ * The memory allocated never moves, so the callers could keep the pointers to it. The
+ * objects placed in the arena are not destructed by it.
+ * */
+class Arena final {
+public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocateAligned(size_t size, size_t align = alignof(std::max_align_t)) {
+        DCHECK(align > 0 && (align & (align - 1)) == 0);
+        if (size > kBlockSize / 4) {
+            // The large ones take their own blocks, so the current block is not wasted
+            blocks_.emplace_back(new char[size]);
+            allocated_ += size;
+            return blocks_.back().get();
+        }
+        auto pad = (align - reinterpret_cast<uintptr_t>(curr_) % align) % align;
+        if (curr_ == nullptr || left_ < pad + size) {
+            blocks_.emplace_back(new char[kBlockSize]);
+            allocated_ += kBlockSize;
+            curr_ = blocks_.back().get();
+            left_ = kBlockSize;
+            pad = 0;
+        }
+        auto* ptr = curr_ + pad;
+        curr_ += pad + size;
+        left_ -= pad + size;
+        return ptr;
+    }
+
+    folly::StringPiece copy(folly::StringPiece str) {
+        if (str.empty()) {
+            return folly::StringPiece();
+        }
+        auto* ptr = static_cast<char*>(allocateAligned(str.size(), 1));
+        memcpy(ptr, str.data(), str.size());
+        return folly::StringPiece(ptr, str.size());
+    }
+
+    // The bytes of all the blocks
+    size_t allocated() const {
+        return allocated_;
+    }
+
+private:
+    static constexpr size_t kBlockSize = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>>    blocks_;
+    char                                   *curr_{nullptr};
+    size_t                                  left_{0};
+    size_t                                  allocated_{0};
+};
+
+}  // namespace nebula
+
+#endif  // COMMON_BASE_ARENA_H_
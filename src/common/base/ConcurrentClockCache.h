@@ -0,0 +1,445 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef COMMON_BASE_CONCURRENTCLOCKCACHE_H_
+#define COMMON_BASE_CONCURRENTCLOCKCACHE_H_
+
+#include "base/Base.h"
+#include "base/StatusOr.h"
+#include <array>
+#include <deque>
+#include <boost/optional.hpp>
+#include <folly/SharedMutex.h>
+#include <folly/ThreadCachedInt.h>
+#include <folly/ThreadLocal.h>
+#include <folly/lang/Bits.h>
+
+namespace nebula {
+
+/**
+ * The bytes charged for an entry of the cache
+ * */
+template<typename T>
+struct CacheCharge {
+    size_t operator()(const T&) const {
+        return sizeof(T);
+    }
+};
+
+template<>
+struct CacheCharge<std::string> {
+    size_t operator()(const std::string& v) const {
+        return sizeof(std::string) + v.size();
+    }
+};
+
+
+/**
+ * A sharded cache with the CLOCK eviction and the TinyLFU admission.
+ *
+ * A lookup only holds the shared lock of its shard and sets the reference bit of the
+ * entry hit, so the readers never serialize on reordering a list as LRU does. The
+ * capacity is in bytes, each entry is charged by the size of its key and value.
+ *
+ * When a shard is full, a new key is admitted only if it has been looked up more often
+ * recently than the victim chosen by CLOCK. The frequencies are estimated by a count-min
+ * sketch, which is halved periodically to forget the old accesses. So a scan over the keys
+ * read only once could not flush the hot ones. Each thread buffers the accesses it records,
+ * and applies them to the sketch in batches, so the readers don't write the shared counters
+ * on every lookup.
+ * */
+template<typename K, typename V>
+class ConcurrentClockCache final {
+public:
+    explicit ConcurrentClockCache(size_t capacity, uint32_t shardsExp = 4)
+        : shardsExp_(shardsExp) {
+        size_t shardsNum = 1UL << shardsExp;
+        CHECK_GE(capacity, shardsNum);
+        for (size_t i = 0; i < shardsNum; i++) {
+            shards_.emplace_back(std::make_unique<Shard>(capacity >> shardsExp));
+        }
+    }
+
+    bool contains(const K& key, int32_t hint = -1) {
+        auto hash = std::hash<K>()(key);
+        return shards_[shardIndex(hash, hint)]->contains(key);
+    }
+
+    /**
+     * Insert the {key, val} if the key does not exist. The key could be rejected if the
+     * shard is full and it is not accessed more frequently than the victim.
+     * */
+    void insert(K key, V val, int32_t hint = -1) {
+        auto hash = std::hash<K>()(key);
+        auto charge = 2 * CacheCharge<K>()(key) + CacheCharge<V>()(val) + kEntryOverhead;
+        auto evicted = shards_[shardIndex(hash, hint)]->insert(std::move(key),
+                                                               std::move(val),
+                                                               folly::hash::twang_mix64(hash),
+                                                               charge);
+        if (evicted < 0) {
+            rejects_++;
+        } else if (evicted > 0) {
+            evicts_ += evicted;
+        }
+    }
+
+    StatusOr<V> get(const K& key, int32_t hint = -1) {
+        auto hash = std::hash<K>()(key);
+        auto v = shards_[shardIndex(hash, hint)]->get(key, folly::hash::twang_mix64(hash));
+        if (v == boost::none) {
+            misses_.increment(1);
+            return Status::Error();
+        }
+        hits_.increment(1);
+        return std::move(v).value();
+    }
+
+    /**
+     * Remove the key if exists, it is not counted as an eviction
+     * */
+    void evict(const K& key, int32_t hint = -1) {
+        auto hash = std::hash<K>()(key);
+        shards_[shardIndex(hash, hint)]->evict(key);
+    }
+
+    void clear() {
+        for (auto& shard : shards_) {
+            shard->clear();
+        }
+        hits_.set(0);
+        misses_.set(0);
+        evicts_ = 0;
+        rejects_ = 0;
+    }
+
+    uint64_t total() const {
+        return hits() + misses();
+    }
+
+    uint64_t hits() const {
+        return hits_.readFull();
+    }
+
+    uint64_t misses() const {
+        return misses_.readFull();
+    }
+
+    // The entries removed to make room for the new ones
+    uint64_t evicts() const {
+        return evicts_;
+    }
+
+    // The keys not admitted
+    uint64_t rejects() const {
+        return rejects_;
+    }
+
+    // The bytes charged by all the entries
+    size_t usage() const {
+        size_t usage = 0;
+        for (auto& shard : shards_) {
+            usage += shard->usage();
+        }
+        return usage;
+    }
+
+    size_t size() const {
+        size_t size = 0;
+        for (auto& shard : shards_) {
+            size += shard->size();
+        }
+        return size;
+    }
+
+private:
+    // The hash node and the slot of an entry
+    static constexpr size_t kEntryOverhead = 64;
+
+    /**
+     * The count-min sketch of the accesses, with 4-bit counters kept in bytes. The racing
+     * updates could lose some counts, which is fine for an estimation.
+     *
+     * The accesses are buffered by each thread and applied every kBufferSize of them, so the
+     * estimation lags behind by at most kBufferSize - 1 accesses of each thread.
+     * */
+    class FrequencySketch {
+    public:
+        explicit FrequencySketch(size_t capacity) {
+            size_t width = std::min<size_t>(std::max<size_t>(capacity / kBytesPerCounter, 1024),
+                                            1UL << kBitsPerRow);
+            width = folly::nextPowTwo(width);
+            mask_ = width - 1;
+            size_ = width * kDepth;
+            counters_ = std::make_unique<std::atomic<uint8_t>[]>(size_);
+            for (size_t i = 0; i < size_; i++) {
+                counters_[i].store(0, std::memory_order_relaxed);
+            }
+            // Halve all counters after every 10 accesses per counter
+            sampleSize_ = width * 10;
+        }
+
+        void record(uint64_t hash) {
+            auto* buffer = buffers_.get();
+            buffer->hashes[buffer->size++] = hash;
+            if (buffer->size == kBufferSize) {
+                apply(buffer);
+            }
+        }
+
+        // Apply the accesses buffered by the current thread
+        void flush() {
+            apply(buffers_.get());
+        }
+
+        uint8_t estimate(uint64_t hash) const {
+            uint8_t count = kMaxCount;
+            for (size_t row = 0; row < kDepth; row++) {
+                count = std::min(count, counterOf(hash, row).load(std::memory_order_relaxed));
+            }
+            return count;
+        }
+
+    private:
+        static constexpr size_t kDepth = 4;
+        static constexpr size_t kBitsPerRow = 16;
+        static constexpr size_t kBytesPerCounter = 64;
+        static constexpr uint8_t kMaxCount = 15;
+        static constexpr size_t kBufferSize = 16;
+
+        struct Buffer {
+            std::array<uint64_t, kBufferSize> hashes;
+            size_t size{0};
+        };
+
+        std::atomic<uint8_t>& counterOf(uint64_t hash, size_t row) const {
+            return counters_[row * (mask_ + 1) + ((hash >> (row * kBitsPerRow)) & mask_)];
+        }
+
+        void apply(Buffer* buffer) {
+            size_t added = 0;
+            for (size_t i = 0; i < buffer->size; i++) {
+                if (increment(buffer->hashes[i])) {
+                    added++;
+                }
+            }
+            buffer->size = 0;
+            if (added > 0
+                    && additions_.fetch_add(added, std::memory_order_relaxed) + added
+                        >= sampleSize_) {
+                age();
+            }
+        }
+
+        // Returns false if all the counters of the hash are saturated
+        bool increment(uint64_t hash) {
+            bool added = false;
+            for (size_t row = 0; row < kDepth; row++) {
+                auto& counter = counterOf(hash, row);
+                auto count = counter.load(std::memory_order_relaxed);
+                // The saturated counters of the hot keys are only read
+                if (count < kMaxCount) {
+                    counter.store(count + 1, std::memory_order_relaxed);
+                    added = true;
+                }
+            }
+            return added;
+        }
+
+        void age() {
+            // The racing threads could halve twice, which only forgets a little faster
+            additions_.store(0, std::memory_order_relaxed);
+            for (size_t i = 0; i < size_; i++) {
+                counters_[i].store(counters_[i].load(std::memory_order_relaxed) >> 1,
+                                   std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        std::unique_ptr<std::atomic<uint8_t>[]> counters_;
+        size_t mask_{0};
+        size_t size_{0};
+        size_t sampleSize_{0};
+        std::atomic<size_t> additions_{0};
+        folly::ThreadLocal<Buffer> buffers_;
+    };
+
+    struct Slot {
+        K key;
+        V val;
+        uint64_t hash{0};
+        size_t charge{0};
+        bool used{false};
+        // Set by the readers holding the shared lock
+        std::atomic<bool> referenced{false};
+    };
+
+    class Shard {
+    public:
+        explicit Shard(size_t capacity)
+            : capacity_(capacity)
+            , sketch_(capacity) {}
+
+        bool contains(const K& key) {
+            folly::SharedMutex::ReadHolder rh(lock_);
+            return index_.find(key) != index_.end();
+        }
+
+        boost::optional<V> get(const K& key, uint64_t hash) {
+            sketch_.record(hash);
+            folly::SharedMutex::ReadHolder rh(lock_);
+            auto it = index_.find(key);
+            if (it == index_.end()) {
+                VLOG(3) << key << " not found!";
+                return boost::none;
+            }
+            auto& slot = slots_[it->second];
+            // Avoid writing the shared cache line if it is referenced already
+            if (!slot.referenced.load(std::memory_order_relaxed)) {
+                slot.referenced.store(true, std::memory_order_relaxed);
+            }
+            return slot.val;
+        }
+
+        // Returns the number of the entries evicted, or -1 if the key is rejected
+        int64_t insert(K&& key, V&& val, uint64_t hash, size_t charge) {
+            if (charge > capacity_) {
+                return -1;
+            }
+            folly::SharedMutex::WriteHolder wh(lock_);
+            if (index_.find(key) != index_.end()) {
+                return 0;
+            }
+            int64_t evicted = 0;
+            if (usage_ + charge > capacity_) {
+                // The lookups of the key just missed by this thread are counted
+                sketch_.flush();
+                auto victim = findVictim();
+                if (sketch_.estimate(hash) <= sketch_.estimate(slots_[victim].hash)) {
+                    VLOG(3) << "Reject key " << key;
+                    return -1;
+                }
+                while (true) {
+                    VLOG(3) << "Evict key " << slots_[victim].key;
+                    remove(victim);
+                    evicted++;
+                    if (usage_ + charge <= capacity_) {
+                        break;
+                    }
+                    victim = findVictim();
+                }
+            }
+
+            size_t idx;
+            if (free_.empty()) {
+                idx = slots_.size();
+                slots_.emplace_back();
+            } else {
+                idx = free_.back();
+                free_.pop_back();
+            }
+            auto& slot = slots_[idx];
+            slot.key = key;
+            slot.val = std::move(val);
+            slot.hash = hash;
+            slot.charge = charge;
+            slot.used = true;
+            // A new entry is the next victim unless it is read again
+            slot.referenced.store(false, std::memory_order_relaxed);
+            index_.emplace(std::move(key), idx);
+            usage_ += charge;
+            return evicted;
+        }
+
+        void evict(const K& key) {
+            folly::SharedMutex::WriteHolder wh(lock_);
+            auto it = index_.find(key);
+            if (it != index_.end()) {
+                remove(it->second);
+            }
+        }
+
+        void clear() {
+            folly::SharedMutex::WriteHolder wh(lock_);
+            index_.clear();
+            slots_.clear();
+            free_.clear();
+            usage_ = 0;
+            hand_ = 0;
+        }
+
+        size_t usage() const {
+            folly::SharedMutex::ReadHolder rh(lock_);
+            return usage_;
+        }
+
+        size_t size() const {
+            folly::SharedMutex::ReadHolder rh(lock_);
+            return index_.size();
+        }
+
+    private:
+        /**
+         * Sweep the slots from the hand, clearing the reference bits, and stop at the first
+         * one not referenced. The hand stays there, so a rejected key does not spare the
+         * victim. Requires the write lock and at least one entry.
+         * */
+        size_t findVictim() {
+            while (true) {
+                if (hand_ >= slots_.size()) {
+                    hand_ = 0;
+                }
+                auto& slot = slots_[hand_];
+                if (slot.used && !slot.referenced.exchange(false, std::memory_order_relaxed)) {
+                    return hand_;
+                }
+                hand_++;
+            }
+        }
+
+        void remove(size_t idx) {
+            auto& slot = slots_[idx];
+            index_.erase(slot.key);
+            usage_ -= slot.charge;
+            slot.key = K();
+            slot.val = V();
+            slot.used = false;
+            free_.emplace_back(idx);
+        }
+
+    private:
+        mutable folly::SharedMutex lock_;
+        std::unordered_map<K, size_t> index_;
+        // The slots never move, so the readers could set the reference bits in place
+        std::deque<Slot> slots_;
+        std::vector<size_t> free_;
+        size_t hand_{0};
+        size_t usage_{0};
+        const size_t capacity_;
+        FrequencySketch sketch_;
+    };
+
+private:
+    /**
+     * If hint is specified, we could use it to cal the shard index directly.
+     * */
+    size_t shardIndex(size_t hash, int32_t hint) const {
+        auto mask = (1UL << shardsExp_) - 1;
+        return hint >= 0 ? (hint & mask) : (hash & mask);
+    }
+
+private:
+    std::vector<std::unique_ptr<Shard>> shards_;
+    uint32_t shardsExp_ = 0;
+
+    folly::ThreadCachedInt<uint64_t> hits_;
+    folly::ThreadCachedInt<uint64_t> misses_;
+    std::atomic<uint64_t> evicts_{0};
+    std::atomic<uint64_t> rejects_{0};
+};
+
+}  // namespace nebula
+
+#endif  // COMMON_BASE_CONCURRENTCLOCKCACHE_H_
@@ -8,6 +8,7 @@
 #define COMMON_BASE_LOGITERATOR_H_
 
 #include "base/Base.h"
+#include <folly/io/IOBuf.h>
 
 namespace nebula {
 
@@ -26,6 +27,12 @@ public:
     virtual TermID logTerm() const = 0;
     virtual ClusterID logSource() const = 0;
     virtual folly::StringPiece logMsg() const = 0;
+
+    // The log message which shares the storage of the iterator if possible,
+    // so it could be kept after the iterator moves on without copying
+    virtual folly::IOBuf logBuf() const {
+        return folly::IOBuf(folly::IOBuf::COPY_BUFFER, logMsg());
+    }
 };
 
 }  // namespace nebula
@@ -34,6 +34,7 @@ enum class NebulaKeyType : uint32_t {
 enum class NebulaSystemKeyType : uint32_t {
     kSystemCommit      = 0x00000001,
     kSystemPart        = 0x00000002,
+    kSystemStats       = 0x00000003,
 };
 
 /**
@@ -59,6 +60,8 @@ public:
 
     static std::string systemPartKey(PartitionID partId);
 
+    static std::string systemStatsKey(PartitionID partId);
+
     static std::string uuidKey(PartitionID partId, const folly::StringPiece& name);
 
     static std::string kvKey(PartitionID partId, const folly::StringPiece& name);
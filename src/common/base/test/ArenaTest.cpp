@@ -0,0 +1,53 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "base/Arena.h"
+#include <gtest/gtest.h>
+
+namespace nebula {
+
+TEST(ArenaTest, CopyTest) {
+    Arena arena;
+    std::vector<folly::StringPiece> pieces;
+    for (auto i = 0; i < 10000; i++) {
+        pieces.emplace_back(arena.copy(folly::stringPrintf("str_%d", i)));
+    }
+    // The large one takes its own block
+    std::string large(1024 * 1024, 'x');
+    auto piece = arena.copy(large);
+    EXPECT_EQ(large, piece.str());
+    EXPECT_TRUE(arena.copy("").empty());
+
+    for (auto i = 0; i < 10000; i++) {
+        EXPECT_EQ(folly::stringPrintf("str_%d", i), pieces[i].str());
+    }
+    EXPECT_LE(large.size() + 10000 * 8, arena.allocated());
+}
+
+
+TEST(ArenaTest, AlignTest) {
+    Arena arena;
+    for (auto i = 0; i < 1000; i++) {
+        arena.allocateAligned(i % 7 + 1, 1);
+        auto* ptr = arena.allocateAligned(sizeof(int64_t), alignof(int64_t));
+        EXPECT_EQ(0, reinterpret_cast<uintptr_t>(ptr) % alignof(int64_t));
+        *static_cast<int64_t*>(ptr) = i;
+        auto* ptr16 = arena.allocateAligned(32, 16);
+        EXPECT_EQ(0, reinterpret_cast<uintptr_t>(ptr16) % 16);
+    }
+}
+
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,94 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include "base/ConcurrentLRUCache.h"
+#include "base/ConcurrentClockCache.h"
+
+DEFINE_int32(cache_keys, 10000, "The keys looked up, all of which are cached");
+DEFINE_int32(cache_lookups, 100000, "The lookups of each thread in one iteration");
+
+/**
+ * The readers hitting the same hot keys concurrently, which is how the vertex cache is
+ * used by the storage processors.
+ * */
+
+namespace nebula {
+
+template <class Cache>
+void readers(size_t iters, int32_t threadsNum) {
+    std::unique_ptr<Cache> cache;
+    BENCHMARK_SUSPEND {
+        // Large enough for all the keys, by the entries of LRU or the bytes of CLOCK
+        cache = std::make_unique<Cache>(1024 * 1024 * 1024);
+        for (int32_t i = 0; i < FLAGS_cache_keys; i++) {
+            cache->insert(i, folly::stringPrintf("%d_val", i));
+        }
+    }
+    for (size_t iter = 0; iter < iters; iter++) {
+        std::vector<std::thread> threads;
+        for (int32_t t = 0; t < threadsNum; t++) {
+            threads.emplace_back([&cache, t] () {
+                int32_t key = t;
+                for (int32_t i = 0; i < FLAGS_cache_lookups; i++) {
+                    key = (key + 7) % FLAGS_cache_keys;
+                    auto v = cache->get(key);
+                    folly::doNotOptimizeAway(v);
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+    BENCHMARK_SUSPEND {
+        cache.reset();
+    }
+}
+
+using LRUCache = ConcurrentLRUCache<int32_t, std::string>;
+using ClockCache = ConcurrentClockCache<int32_t, std::string>;
+
+}  // namespace nebula
+
+BENCHMARK(lru_readers_1, iters) {
+    nebula::readers<nebula::LRUCache>(iters, 1);
+}
+
+BENCHMARK_RELATIVE(clock_readers_1, iters) {
+    nebula::readers<nebula::ClockCache>(iters, 1);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(lru_readers_8, iters) {
+    nebula::readers<nebula::LRUCache>(iters, 8);
+}
+
+BENCHMARK_RELATIVE(clock_readers_8, iters) {
+    nebula::readers<nebula::ClockCache>(iters, 8);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(lru_readers_32, iters) {
+    nebula::readers<nebula::LRUCache>(iters, 32);
+}
+
+BENCHMARK_RELATIVE(clock_readers_32, iters) {
+    nebula::readers<nebula::ClockCache>(iters, 32);
+}
+/*************************
+ * End of benchmarks
+ ************************/
+
+
+int main(int argc, char** argv) {
+    folly::init(&argc, &argv, true);
+    folly::runBenchmarks();
+    return 0;
+}
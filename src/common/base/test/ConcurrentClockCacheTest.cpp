@@ -0,0 +1,172 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "base/ConcurrentClockCache.h"
+#include <gtest/gtest.h>
+
+namespace nebula {
+
+// Each entry of the tests is charged the same
+static std::string valueOf(int32_t i) {
+    auto val = folly::stringPrintf("%d_str", i);
+    val.resize(200, ' ');
+    return val;
+}
+
+static size_t chargeOf(int32_t i) {
+    return 2 * sizeof(int32_t) + sizeof(std::string) + valueOf(i).size() + 64;
+}
+
+// Look up the key, and insert it when missed, as the processors do
+static bool getOrInsert(ConcurrentClockCache<int32_t, std::string>& cache, int32_t i) {
+    auto v = cache.get(i);
+    if (v.ok()) {
+        EXPECT_EQ(valueOf(i), v.value());
+        return true;
+    }
+    cache.insert(i, valueOf(i));
+    return false;
+}
+
+
+TEST(ConcurrentClockCacheTest, SimpleTest) {
+    ConcurrentClockCache<int32_t, std::string> cache(1024 * 1024);
+    cache.insert(10, "ten");
+    {
+        auto v = cache.get(10);
+        EXPECT_TRUE(v.ok());
+        EXPECT_EQ("ten", v.value());
+    }
+    {
+        auto v = cache.get(5);
+        EXPECT_FALSE(v.ok());
+    }
+    EXPECT_TRUE(cache.contains(10));
+    EXPECT_EQ(1, cache.size());
+
+    // The existing key is not overwritten
+    cache.insert(10, "ele");
+    EXPECT_EQ("ten", cache.get(10).value());
+
+    cache.evict(10);
+    EXPECT_FALSE(cache.contains(10));
+    EXPECT_EQ(0, cache.usage());
+
+    EXPECT_EQ(0, cache.evicts());
+    EXPECT_EQ(2, cache.hits());
+    EXPECT_EQ(1, cache.misses());
+    EXPECT_EQ(3, cache.total());
+}
+
+
+TEST(ConcurrentClockCacheTest, CapacityTest) {
+    ConcurrentClockCache<int32_t, std::string> cache(100 * chargeOf(0), 0);
+    for (auto i = 0; i < 100; i++) {
+        cache.insert(i, valueOf(i));
+    }
+    EXPECT_EQ(100, cache.size());
+    EXPECT_EQ(100 * chargeOf(0), cache.usage());
+
+    // The key accessed more frequently than the victim is admitted
+    for (auto i = 0; i < 3; i++) {
+        EXPECT_FALSE(cache.get(1000).ok());
+    }
+    cache.insert(1000, valueOf(1000));
+    EXPECT_TRUE(cache.contains(1000));
+    EXPECT_EQ(100, cache.size());
+    EXPECT_EQ(1, cache.evicts());
+
+    // An entry larger than the capacity is never admitted
+    cache.insert(2000, std::string(200 * chargeOf(0), 'x'));
+    EXPECT_FALSE(cache.contains(2000));
+    EXPECT_EQ(1, cache.rejects());
+    EXPECT_LE(cache.usage(), 100 * chargeOf(0));
+}
+
+
+TEST(ConcurrentClockCacheTest, ScanResistanceTest) {
+    ConcurrentClockCache<int32_t, std::string> cache(100 * chargeOf(0), 0);
+    // The hot keys
+    for (auto round = 0; round < 15; round++) {
+        for (auto i = 0; i < 100; i++) {
+            getOrInsert(cache, i);
+        }
+    }
+    EXPECT_EQ(1400, cache.hits());
+
+    // A scan over the keys read once does not flush the hot keys
+    for (auto i = 1000; i < 3000; i++) {
+        EXPECT_FALSE(getOrInsert(cache, i));
+    }
+    EXPECT_LT(1900, cache.rejects());
+    int32_t hits = 0;
+    for (auto i = 0; i < 100; i++) {
+        if (getOrInsert(cache, i)) {
+            hits++;
+        }
+    }
+    EXPECT_LE(95, hits);
+}
+
+
+TEST(ConcurrentClockCacheTest, ClockTest) {
+    ConcurrentClockCache<int32_t, std::string> cache(100 * chargeOf(0), 0);
+    for (auto i = 0; i < 100; i++) {
+        getOrInsert(cache, i);
+    }
+    // Make the new keys more frequent than all the cached ones, the referenced ones are kept
+    for (auto i = 0; i < 50; i++) {
+        EXPECT_TRUE(getOrInsert(cache, i));
+    }
+    for (auto i = 100; i < 150; i++) {
+        getOrInsert(cache, i);
+        getOrInsert(cache, i);
+        getOrInsert(cache, i);
+    }
+    EXPECT_EQ(50, cache.evicts());
+    for (auto i = 0; i < 50; i++) {
+        EXPECT_TRUE(cache.contains(i));
+    }
+    for (auto i = 50; i < 100; i++) {
+        EXPECT_FALSE(cache.contains(i));
+    }
+}
+
+
+TEST(ConcurrentClockCacheTest, MultiThreadsTest) {
+    ConcurrentClockCache<int32_t, std::string> cache(1000 * chargeOf(0));
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < 10; i++) {
+        threads.emplace_back([&cache, i] () {
+            for (auto round = 0; round < 10; round++) {
+                for (auto j = i * 100; j < (i + 1) * 200; j++) {
+                    getOrInsert(cache, j);
+                    if (j % 10 == 0) {
+                        cache.evict(j);
+                    }
+                }
+            }
+        });
+    }
+    for (auto i = 0; i < 10; i++) {
+        threads[i].join();
+    }
+    EXPECT_LE(cache.usage(), 1000 * chargeOf(0));
+    EXPECT_EQ(cache.total(), cache.hits() + cache.misses());
+    EXPECT_LT(0, cache.hits());
+}
+
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    return RUN_ALL_TESTS();
+}
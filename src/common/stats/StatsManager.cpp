@@ -48,16 +48,14 @@ int32_t StatsManager::registerStats(folly::StringPiece counterName) {
     }
 
     // Insert the Stats
-    sm.stats_.emplace_back(
-        std::make_pair(
-            std::make_unique<std::mutex>(),
-            std::make_unique<StatsType>(
-                60,
-                std::initializer_list<StatsType::Duration>({seconds(5),
-                                                            seconds(60),
-                                                            seconds(600),
-                                                            seconds(3600)}))));
-    int32_t index = sm.stats_.size();
+    auto pos = sm.stats_.add(
+        std::make_unique<StatsType>(
+            60,
+            std::initializer_list<StatsType::Duration>({seconds(5),
+                                                        seconds(60),
+                                                        seconds(600),
+                                                        seconds(3600)})));
+    int32_t index = pos + 1;
     sm.nameMap_[name] = index;
     return index;
 }
@@ -80,15 +78,13 @@ int32_t StatsManager::registerHisto(folly::StringPiece counterName,
     }
 
     // Insert the Histogram
-    sm.histograms_.emplace_back(
-        std::make_pair(
-            std::make_unique<std::mutex>(),
-            std::make_unique<HistogramType>(
-                bucketSize,
-                min,
-                max,
-                StatsType(60, {seconds(5), seconds(60), seconds(600), seconds(3600)}))));
-    int32_t index = - sm.histograms_.size();
+    auto pos = sm.histograms_.add(
+        std::make_unique<HistogramType>(
+            bucketSize,
+            min,
+            max,
+            StatsType(60, {seconds(5), seconds(60), seconds(600), seconds(3600)})));
+    int32_t index = - static_cast<int32_t>(pos + 1);
     sm.nameMap_[name] = index;
 
     LOG(INFO) << "registerHisto, bucketSize: " << bucketSize
@@ -103,18 +99,17 @@ void StatsManager::addValue(int32_t index, VT value) {
     CHECK_NE(index, 0);
 
     auto& sm = get();
+    // The counters never move, so no lock is needed against registering meanwhile
     if (index > 0) {
         // Stats
-        --index;
-        DCHECK_LT(index, sm.stats_.size());
-        std::lock_guard<std::mutex> g(*(sm.stats_[index].first));
-        sm.stats_[index].second->addValue(seconds(time::WallClock::fastNowInSec()), value);
+        auto& counter = sm.stats_[index - 1];
+        std::lock_guard<std::mutex> g(counter.lock);
+        counter.holder->addValue(seconds(time::WallClock::fastNowInSec()), value);
     } else {
         // Histogram
-        index = - (index + 1);
-        DCHECK_LT(index, sm.histograms_.size());
-        std::lock_guard<std::mutex> g(*(sm.histograms_[index].first));
-        sm.histograms_[index].second->addValue(seconds(time::WallClock::fastNowInSec()), value);
+        auto& counter = sm.histograms_[- (index + 1)];
+        std::lock_guard<std::mutex> g(counter.lock);
+        counter.holder->addValue(seconds(time::WallClock::fastNowInSec()), value);
     }
 }
 
@@ -182,6 +177,7 @@ StatusOr<StatsManager::VT> StatsManager::readValue(folly::StringPiece metricName
 // static
 void StatsManager::readAllValue(folly::dynamic& vals) {
     auto& sm = get();
+    folly::RWSpinLock::ReadHolder rh(sm.nameMapLock_);
 
     for (auto &statsName : sm.nameMap_) {
         for (auto method = StatsMethod::SUM; method <= StatsMethod::RATE;
@@ -248,18 +244,16 @@ StatusOr<StatsManager::VT> StatsManager::readStats(int32_t index,
 
     if (index > 0) {
         // stats
-        --index;
-        DCHECK_LT(index, sm.stats_.size());
-        std::lock_guard<std::mutex> g(*(sm.stats_[index].first));
-        sm.stats_[index].second->update(seconds(time::WallClock::fastNowInSec()));
-        return readValue(*(sm.stats_[index].second), range, method);
+        auto& counter = sm.stats_[index - 1];
+        std::lock_guard<std::mutex> g(counter.lock);
+        counter.holder->update(seconds(time::WallClock::fastNowInSec()));
+        return readValue(*counter.holder, range, method);
     } else {
         // histograms_
-        index = - (index + 1);
-        DCHECK_LT(index, sm.histograms_.size());
-        std::lock_guard<std::mutex> g(*(sm.histograms_[index].first));
-        sm.histograms_[index].second->update(seconds(time::WallClock::fastNowInSec()));
-        return readValue(*(sm.histograms_[index].second), range, method);
+        auto& counter = sm.histograms_[- (index + 1)];
+        std::lock_guard<std::mutex> g(counter.lock);
+        counter.holder->update(seconds(time::WallClock::fastNowInSec()));
+        return readValue(*counter.holder, range, method);
     }
 }
 
@@ -274,6 +268,7 @@ StatusOr<StatsManager::VT> StatsManager::readStats(const std::string& counterNam
     int32_t index = 0;
 
     {
+        folly::RWSpinLock::ReadHolder rh(sm.nameMapLock_);
         auto it = sm.nameMap_.find(counterName);
         if (it == sm.nameMap_.end()) {
             // Not found
@@ -297,6 +292,7 @@ StatusOr<StatsManager::VT> StatsManager::readHisto(const std::string& counterNam
     // Look up the counter name
     int32_t index = 0;
     {
+        folly::RWSpinLock::ReadHolder rh(sm.nameMapLock_);
         auto it = sm.nameMap_.find(counterName);
         if (it == sm.nameMap_.end()) {
             // Not found
@@ -314,10 +310,11 @@ StatusOr<StatsManager::VT> StatsManager::readHisto(const std::string& counterNam
         return Status::Error("Invalid stats");
     }
 
-    std::lock_guard<std::mutex> g(*(sm.histograms_[index].first));
-    sm.histograms_[index].second->update(seconds(time::WallClock::fastNowInSec()));
+    auto& counter = sm.histograms_[index];
+    std::lock_guard<std::mutex> g(counter.lock);
+    counter.holder->update(seconds(time::WallClock::fastNowInSec()));
     auto level = static_cast<size_t>(range);
-    return sm.histograms_[index].second->getPercentileEstimate(pct, level);
+    return counter.holder->getPercentileEstimate(pct, level);
 }
 
 }  // namespace stats
@@ -68,8 +68,8 @@ public:
 
     // Both register methods return the index to the internal data structure.
     // This index will be used by addValue() methods.
-    // Both register methods is not thread safe, and user need to register stats one
-    // by onebefore calling addValue, readStats, readHisto and so on.
+    // Both register methods are thread safe, so the counters could be registered at
+    // runtime, e.g. the ones of each part. Registering an existing name returns its index.
     static int32_t registerStats(folly::StringPiece counterName);
     static int32_t registerHisto(folly::StringPiece counterName,
                                  VT bucketSize,
@@ -100,6 +100,38 @@ private:
     template<class StatsHolder>
     static VT readValue(StatsHolder& stats, TimeRange range, StatsMethod method);
 
+    /**
+     * The counters of one kind, kept in the chunks allocated on demand. A counter never moves
+     * once registered, so updating or reading it by the index takes no lock but its own.
+     * The counters are only added under nameMapLock_.
+     * */
+    template<class StatsHolder>
+    class Counters final {
+    public:
+        struct Counter {
+            std::mutex lock;
+            std::unique_ptr<StatsHolder> holder;
+        };
+
+        // Return the position of the counter added
+        size_t add(std::unique_ptr<StatsHolder> holder);
+
+        Counter& operator[](size_t pos) {
+            DCHECK_LT(pos, size());
+            return chunks_[pos / kChunkSize][pos % kChunkSize];
+        }
+
+        size_t size() const {
+            return size_.load(std::memory_order_acquire);
+        }
+
+    private:
+        static constexpr size_t kChunkSize = 64;
+        static constexpr size_t kMaxChunks = 1024;
+
+        std::array<std::unique_ptr<Counter[]>, kMaxChunks> chunks_;
+        std::atomic<size_t> size_{0};
+    };
 
 private:
     std::string domain_;
@@ -113,18 +145,10 @@ private:
     std::unordered_map<std::string, int32_t> nameMap_;
 
     // All time series stats
-    std::vector<
-        std::pair<std::unique_ptr<std::mutex>,
-                  std::unique_ptr<StatsType>
-        >
-    > stats_;
+    Counters<StatsType> stats_;
 
     // All histogram stats
-    std::vector<
-        std::pair<std::unique_ptr<std::mutex>,
-                  std::unique_ptr<HistogramType>
-        >
-    > histograms_;
+    Counters<HistogramType> histograms_;
 };
 
 }  // namespace stats
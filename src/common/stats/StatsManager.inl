@@ -27,6 +27,27 @@ StatsManager::VT StatsManager::readValue(StatsHolder& stats,
     LOG(FATAL) << "Unknown statistic method";
 }
 
+
+template<class StatsHolder>
+constexpr size_t StatsManager::Counters<StatsHolder>::kChunkSize;
+
+template<class StatsHolder>
+constexpr size_t StatsManager::Counters<StatsHolder>::kMaxChunks;
+
+template<class StatsHolder>
+size_t StatsManager::Counters<StatsHolder>::add(std::unique_ptr<StatsHolder> holder) {
+    auto pos = size_.load(std::memory_order_relaxed);
+    CHECK_LT(pos, kChunkSize * kMaxChunks) << "Too many counters";
+    auto& chunk = chunks_[pos / kChunkSize];
+    if (chunk == nullptr) {
+        chunk = std::make_unique<Counter[]>(kChunkSize);
+    }
+    chunk[pos % kChunkSize].holder = std::move(holder);
+    // Publish the counter to the ones reading it by the index without lock
+    size_.store(pos + 1, std::memory_order_release);
+    return pos;
+}
+
 }  // namespace stats
 }  // namespace nebula
 
@@ -91,6 +91,37 @@ TEST(StatsManager, HistogramTest) {
 }
 
 
+TEST(StatsManager, RegisterAtRuntimeTest) {
+    auto statId = StatsManager::registerStats("stat03");
+    // The counters added meanwhile span many chunks, the existing one never moves
+    std::thread registering([] () {
+        for (int i = 0; i < 1000; i++) {
+            auto name = folly::stringPrintf("stat03_%d", i);
+            auto id = i % 2 == 0 ? StatsManager::registerStats(name)
+                                 : StatsManager::registerHisto(name, 10, 1, 100);
+            StatsManager::addValue(id, i);
+            EXPECT_EQ(id, StatsManager::registerStats(name));
+        }
+    });
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([statId] () {
+            for (int k = 0; k < 10000; k++) {
+                StatsManager::addValue(statId, 1);
+            }
+        });
+    }
+    registering.join();
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(40000, StatsManager::readValue("stat03.sum.60").value());
+    EXPECT_EQ(998, StatsManager::readValue("stat03_998.sum.60").value());
+    EXPECT_EQ(999, StatsManager::readValue("stat03_999.sum.60").value());
+}
+
+
 }   // namespace stats
 }   // namespace nebula
 
@@ -21,6 +21,20 @@ enum class ResultType {
 };
 
 
+/**
+ * The header byte of an encoded row is
+ *   bits 0-2 : the number of bytes for each offset - 1
+ *   bit  3   : the row format, see RowFormat
+ *   bits 5-7 : the number of bytes for the schema version
+ * */
+enum class RowFormat : uint8_t {
+    // Offsets for every 16 fields, the fields in one block are skipped one by one
+    V1 = 0,
+    // Offsets for every field, each field is located in O(1)
+    V2 = 1,
+};
+constexpr uint8_t kRowFormatV2Bit = 0x08;
+
 using FieldValue = boost::variant<bool, int64_t, float, double, std::string>;
 #define VALUE_TYPE_BOOL 0
 #define VALUE_TYPE_INT 1
@@ -120,21 +120,9 @@ std::unique_ptr<RowReader> RowReader::getTagPropReader(
         GraphSpaceID space,
         TagID tag) {
     CHECK_NOTNULL(schemaMan);
-    int32_t ver = getSchemaVer(row);
-    if (ver >= 0) {
-        auto schema = schemaMan->getTagSchema(space, tag, ver);
-        if (schema == nullptr) {
-            return nullptr;
-        }
-        return std::unique_ptr<RowReader>(new RowReader(
-            row,
-            schema));
-    } else {
-        // Invalid data
-        // TODO We need a better error handler here
-        LOG(FATAL) << "Invalid schema version in the row data!";
-        return nullptr;
-    }
+    return getPropReader(row, [&] (SchemaVer ver) {
+        return schemaMan->getTagSchema(space, tag, ver);
+    });
 }
 
 
@@ -145,11 +133,49 @@ std::unique_ptr<RowReader> RowReader::getEdgePropReader(
         GraphSpaceID space,
         EdgeType edge) {
     CHECK_NOTNULL(schemaMan);
+    return getPropReader(row, [&] (SchemaVer ver) {
+        return schemaMan->getEdgeSchema(space, edge, ver);
+    });
+}
+
+// static
+std::unique_ptr<RowReader> RowReader::getTagPropReader(
+        meta::PinnedSchemas* schemas,
+        folly::StringPiece row,
+        GraphSpaceID space,
+        TagID tag) {
+    CHECK_NOTNULL(schemas);
+    return getPropReader(row, [&] (SchemaVer ver) {
+        return schemas->getTagSchema(space, tag, ver);
+    });
+}
+
+
+// static
+std::unique_ptr<RowReader> RowReader::getEdgePropReader(
+        meta::PinnedSchemas* schemas,
+        folly::StringPiece row,
+        GraphSpaceID space,
+        EdgeType edge) {
+    CHECK_NOTNULL(schemas);
+    return getPropReader(row, [&] (SchemaVer ver) {
+        return schemas->getEdgeSchema(space, edge, ver);
+    });
+}
+
+// static
+std::unique_ptr<RowReader> RowReader::getPropReader(
+        folly::StringPiece row,
+        folly::FunctionRef<std::shared_ptr<const meta::SchemaProviderIf>(SchemaVer)> getSchema) {
     int32_t ver = getSchemaVer(row);
     if (ver >= 0) {
+        auto schema = getSchema(ver);
+        if (schema == nullptr) {
+            return nullptr;
+        }
         return std::unique_ptr<RowReader>(new RowReader(
             row,
-            schemaMan->getEdgeSchema(space, edge, ver)));
+            std::move(schema)));
     } else {
         // Invalid data
         // TODO We need a better error handler here
@@ -226,9 +252,14 @@ bool RowReader::processHeader(folly::StringPiece row) {
     // schena version. If the number is zero, no schema version
     // presents
     numBytesForOffset_ = (*it & 0x07) + 1;
+    format_ = (*it & kRowFormatV2Bit) ? RowFormat::V2 : RowFormat::V1;
     int32_t verBytes = *(it++) >> 5;
     it += verBytes;
 
+    if (format_ == RowFormat::V2) {
+        return processFieldOffsets(row, it, verBytes);
+    }
+
     // Process the block offsets
     // Block offsets point to the start of every 16 fields, except the
     // first 16 fields
@@ -261,6 +292,40 @@ bool RowReader::processHeader(folly::StringPiece row) {
 }
 
 
+bool RowReader::processFieldOffsets(folly::StringPiece row,
+                                    const uint8_t* it,
+                                    int32_t verBytes) {
+    // The offsets of all fields except the first one are stored
+    // in Little Endian, so every field could be located directly
+    uint32_t numFields = schema_->getNumFields();
+    uint32_t numOffsets = numFields > 0 ? numFields - 1 : 0;
+    if (numBytesForOffset_ * numOffsets + verBytes + 1 > row.size()) {
+        // Data is too short
+        LOG(ERROR) << "Row data is too short";
+        return false;
+    }
+    offsets_.resize(numFields + 1, -1);
+    offsets_[0] = 0;
+    for (uint32_t i = 1; i <= numOffsets; i++) {
+        int64_t offset = 0;
+        for (int32_t j = 0; j < numBytesForOffset_; j++) {
+            offset |= (uint64_t(*(it++)) << (8 * j));
+        }
+        offsets_[i] = offset;
+    }
+    headerLen_ = reinterpret_cast<const char*>(it) - row.begin();
+    offsets_[numFields] = row.size() - headerLen_;
+
+    // Mark all fields in every block as visited, so no field will be skipped
+    uint32_t numBlocks = (numFields >> 4) + 1;
+    blockOffsets_.reserve(numBlocks);
+    for (uint32_t i = 0; i < numBlocks; i++) {
+        blockOffsets_.emplace_back(offsets_[i << 4], 0x0F);
+    }
+    return true;
+}
+
+
 int32_t RowReader::numFields() const noexcept {
     return schema_->getNumFields();
 }
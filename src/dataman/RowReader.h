@@ -9,11 +9,13 @@
 
 #include "base/Base.h"
 #include <gtest/gtest_prod.h>
+#include <folly/Function.h>
 #include "gen-cpp2/graph_types.h"
 #include "interface/gen-cpp2/common_types.h"
 #include "dataman/DataCommon.h"
 #include "meta/SchemaProviderIf.h"
 #include "meta/SchemaManager.h"
+#include "meta/PinnedSchemas.h"
 #include "base/ErrorOr.h"
 
 namespace nebula {
@@ -72,6 +74,7 @@ public:
 
 
 public:
+    // Return nullptr if the schema of the row is not found
     static std::unique_ptr<RowReader> getTagPropReader(
         meta::SchemaManager* schemaMan,
         folly::StringPiece row,
@@ -84,6 +87,20 @@ public:
         GraphSpaceID space,
         EdgeType edge);
 
+    // The same as above, but with the schemas pinned, for reading rows in a loop.
+    // The readers must not outlive the PinnedSchemas
+    static std::unique_ptr<RowReader> getTagPropReader(
+        meta::PinnedSchemas* schemas,
+        folly::StringPiece row,
+        GraphSpaceID space,
+        TagID tag);
+
+    static std::unique_ptr<RowReader> getEdgePropReader(
+        meta::PinnedSchemas* schemas,
+        folly::StringPiece row,
+        GraphSpaceID space,
+        EdgeType edge);
+
     static std::unique_ptr<RowReader> getRowReader(
         folly::StringPiece row,
         std::shared_ptr<const meta::SchemaProviderIf> schema);
@@ -282,6 +299,10 @@ public:
 
     static int32_t getSchemaVer(folly::StringPiece row);
 
+    RowFormat rowFormat() const noexcept {
+        return format_;
+    }
+
     folly::StringPiece getData() const noexcept {
         return data_;
     }
@@ -301,6 +322,7 @@ private:
     folly::StringPiece data_;
     int32_t headerLen_ = 0;
     int32_t numBytesForOffset_ = 0;
+    RowFormat format_{RowFormat::V1};
     // Block offet value is composed by two integers. The first one is
     // the block offset, the second one is the largest index being visited
     // in the block. This index is zero-based
@@ -311,6 +333,11 @@ private:
     RowReader(folly::StringPiece row,
               std::shared_ptr<const meta::SchemaProviderIf> schema);
 
+    // Read the row with the schema of its version got by getSchema
+    static std::unique_ptr<RowReader> getPropReader(
+        folly::StringPiece row,
+        folly::FunctionRef<std::shared_ptr<const meta::SchemaProviderIf>(SchemaVer)> getSchema);
+
     // Process the row header infomation
     // Returns false when the row data is invalid
     bool processHeader(folly::StringPiece row);
@@ -319,6 +346,10 @@ private:
     // Returns false when the row data is invalid
     bool processBlockOffsets(folly::StringPiece row, int32_t verBytes);
 
+    // Process the offsets of all fields of RowFormat::V2
+    // Returns false when the row data is invalid
+    bool processFieldOffsets(folly::StringPiece row, const uint8_t* it, int32_t verBytes);
+
     // Skip to the next field
     // Parameter:
     //  index   : the current field index
@@ -38,7 +38,8 @@ std::string RowUpdater::encode() const noexcept {
 
 
 void RowUpdater::encodeTo(std::string& encoded) const noexcept {
-    RowWriter writer(schema_);
+    // Keep the format of the original row
+    RowWriter writer(schema_, reader_ ? reader_->rowFormat() : RowFormat::V1);
     auto it = schema_->begin();
     while (static_cast<bool>(it)) {
         switch (it->getType().get_type()) {
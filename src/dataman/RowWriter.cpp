@@ -13,8 +13,9 @@ using cpp2::Schema;
 using cpp2::SupportedType;
 using meta::SchemaProviderIf;
 
-RowWriter::RowWriter(std::shared_ptr<const SchemaProviderIf> schema)
-        : schema_(std::move(schema)) {
+RowWriter::RowWriter(std::shared_ptr<const SchemaProviderIf> schema, RowFormat format)
+        : schema_(std::move(schema))
+        , format_(format) {
     if (!schema_) {
         // Need to create a new schema
         schemaWriter_.reset(new SchemaWriter());
@@ -30,7 +31,7 @@ int64_t RowWriter::size() const noexcept {
         verBytes = calcOccupiedBytes(schema_->getVersion());
     }
     return cord_.size()  // data length
-           + offsetBytes * blockOffsets_.size()  // block offsets length
+           + offsetBytes * numHeaderOffsets()  // offsets length
            + verBytes  // version number length
            + 1;  // Header
 }
@@ -39,7 +40,7 @@ int64_t RowWriter::size() const noexcept {
 std::string RowWriter::encode() noexcept {
     std::string encoded;
     // Reserve enough space so resize will not happen
-    encoded.reserve(sizeof(int64_t) * blockOffsets_.size() + cord_.size() + 11);
+    encoded.reserve(sizeof(int64_t) * numHeaderOffsets() + cord_.size() + 11);
     encodeTo(encoded);
 
     return encoded;
@@ -54,6 +55,9 @@ void RowWriter::encodeTo(std::string& encoded) noexcept {
     // Header information
     auto offsetBytes = calcOccupiedBytes(cord_.size());
     char header = offsetBytes - 1;
+    if (format_ == RowFormat::V2) {
+        header |= kRowFormatV2Bit;
+    }
 
     SchemaVer ver = schema_->getVersion();
     if (ver > 0) {
@@ -67,7 +71,9 @@ void RowWriter::encodeTo(std::string& encoded) noexcept {
     }
 
     // Offsets are stored in Little Endian
-    for (auto offset : blockOffsets_) {
+    const auto& offsets = (format_ == RowFormat::V2) ? fieldOffsets_ : blockOffsets_;
+    for (size_t i = 0; i < numHeaderOffsets(); i++) {
+        auto offset = offsets[i];
         encoded.append(reinterpret_cast<char*>(&offset), offsetBytes);
     }
 
@@ -84,6 +90,16 @@ Schema RowWriter::moveSchema() {
 }
 
 
+size_t RowWriter::numHeaderOffsets() const noexcept {
+    if (format_ == RowFormat::V2) {
+        // The first field always starts from 0, and the offset after the last
+        // field is the end of the data, so neither of them is stored
+        return fieldOffsets_.empty() ? 0 : fieldOffsets_.size() - 1;
+    }
+    return blockOffsets_.size();
+}
+
+
 int64_t RowWriter::calcOccupiedBytes(uint64_t v) const noexcept {
     int64_t bytes = 0;
     do {
@@ -251,6 +267,10 @@ RowWriter& RowWriter::operator<<(Skip&& skip) noexcept {
             }
         }
 
+        if (format_ == RowFormat::V2) {
+            fieldOffsets_.emplace_back(cord_.size());
+        }
+
         // Update block offsets
         if (i != 0 && (i >> 4 << 4) == i) {
             // We need to record block offset for every 16 fields
@@ -9,6 +9,7 @@
 
 #include "base/Base.h"
 #include "base/Cord.h"
+#include "dataman/DataCommon.h"
 #include "dataman/SchemaWriter.h"
 
 namespace nebula {
@@ -66,7 +67,8 @@ public:
 public:
     explicit RowWriter(
         std::shared_ptr<const meta::SchemaProviderIf> schema
-            = std::shared_ptr<const meta::SchemaProviderIf>());
+            = std::shared_ptr<const meta::SchemaProviderIf>(),
+        RowFormat format = RowFormat::V1);
 
     // Encode into a binary array
     std::string encode() noexcept;
@@ -116,12 +118,19 @@ private:
     // Block offsets for every 16 fields
     std::vector<int64_t> blockOffsets_;
 
+    RowFormat format_;
+    // The offset of the next field after each field, only used by RowFormat::V2
+    std::vector<int64_t> fieldOffsets_;
+
     template<typename T>
     typename std::enable_if<std::is_integral<T>::value>::type
     writeInt(T v);
 
     // Calculate the number of bytes occupied (ignore the leading 0s)
     int64_t calcOccupiedBytes(uint64_t v) const noexcept;
+
+    // The number of offsets stored in the header, depends on the row format
+    size_t numHeaderOffsets() const noexcept;
 };
 
 }  // namespace nebula
@@ -142,6 +151,9 @@ private:
 
 #define RW_CLEAN_UP_WRITE() \
     colNum_++; \
+    if (format_ == RowFormat::V2) { \
+        fieldOffsets_.emplace_back(cord_.size()); \
+    } \
     if (colNum_ != 0 && (colNum_ >> 4 << 4) == colNum_) { \
         /* We need to record offset for every 16 fields */ \
         blockOffsets_.emplace_back(cord_.size()); \
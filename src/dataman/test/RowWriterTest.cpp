@@ -289,6 +289,55 @@ TEST(RowWriter, skip) {
     EXPECT_DOUBLE_EQ(0.0, dVal);
 }
 
+
+TEST(RowWriter, fixedOffsetFormat) {
+    auto schema = std::make_shared<SchemaWriter>();
+    for (int i = 0; i < 40; i++) {
+        schema->appendCol(folly::stringPrintf("col%d", i),
+                          i % 2 == 0 ? cpp2::SupportedType::INT
+                                     : cpp2::SupportedType::STRING);
+    }
+
+    RowWriter v1Writer(schema);
+    RowWriter v2Writer(schema, RowFormat::V2);
+    for (int i = 0; i < 40; i++) {
+        if (i % 2 == 0) {
+            v1Writer << i * 100;
+            v2Writer << i * 100;
+        } else {
+            v1Writer << folly::stringPrintf("Hello %d", i);
+            v2Writer << folly::stringPrintf("Hello %d", i);
+        }
+    }
+    std::string v1Encoded = v1Writer.encode();
+    std::string v2Encoded = v2Writer.encode();
+
+    EXPECT_EQ(0, v1Encoded[0] & kRowFormatV2Bit);
+    EXPECT_NE(0, v2Encoded[0] & kRowFormatV2Bit);
+    // V2 keeps one offset per field instead of one per 16 fields
+    EXPECT_GT(v2Encoded.size(), v1Encoded.size());
+
+    auto v1Reader = RowReader::getRowReader(v1Encoded, schema);
+    auto v2Reader = RowReader::getRowReader(v2Encoded, schema);
+    EXPECT_EQ(RowFormat::V1, v1Reader->rowFormat());
+    EXPECT_EQ(RowFormat::V2, v2Reader->rowFormat());
+    EXPECT_EQ(40, v2Reader->numFields());
+
+    int64_t iVal;
+    folly::StringPiece sVal;
+    // Access the fields backward, so every field is located by its own offset
+    for (int i = 39; i >= 0; i--) {
+        auto name = folly::stringPrintf("col%d", i);
+        if (i % 2 == 0) {
+            EXPECT_EQ(ResultType::SUCCEEDED, v2Reader->getInt(name, iVal));
+            EXPECT_EQ(i * 100, iVal);
+        } else {
+            EXPECT_EQ(ResultType::SUCCEEDED, v2Reader->getString(name, sVal));
+            EXPECT_EQ(folly::stringPrintf("Hello %d", i), sVal);
+        }
+    }
+}
+
 }  // namespace nebula
 
 
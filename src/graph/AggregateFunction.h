@@ -8,6 +8,7 @@
 #define GRAPH_AGGREGATEFUNCTION_H
 
 #include "base/Base.h"
+#include <folly/hash/SpookyHashV2.h>
 
 namespace nebula {
 namespace graph {
@@ -39,81 +40,59 @@ constexpr char kBitAnd[] = "BIT_AND";
 constexpr char kBitOr[] = "BIT_OR";
 constexpr char kBitXor[] = "BIT_XOR";
 
-class GroupByHash {
-public:
-    GroupByHash() = default;
-    ~GroupByHash() = default;
-
-    static std::size_t getHashVal(const cpp2::ColumnValue &col) {
-        switch (col.getType()) {
-            case ColumnType::bool_type: {
-                return std::hash<bool>()(col.get_bool_val());
-            }
-            case ColumnType::int_type: {
-                return std::hash<int64_t>()(col.get_integer());
-            }
-            case ColumnType::id_type: {
-                return std::hash<int64_t>()(col.get_id());
-            }
-            case ColumnType::float_type: {
-                return std::hash<double>()(col.get_single_precision());
-            }
-            case ColumnType::double_type: {
-                return std::hash<double>()(col.get_double_precision());
-            }
-            case ColumnType::str_type: {
-                return std::hash<std::string>()(col.get_str());
-            }
-            case ColumnType::timestamp_type: {
-                return std::hash<int64_t>()(col.get_timestamp());
-            }
-            case ColumnType::empty_type: {
-                return 0;
-            }
-            default: {
-                LOG(ERROR) << "Untreated value type: " << static_cast<int32_t>(col.getType());
-                return 0;
-            }
+/**
+ * The 64-bit hash of a value, the values of different types are hashed differently
+ */
+inline uint64_t hashColumnValue(const cpp2::ColumnValue &col) {
+    uint64_t hash = 0;
+    switch (col.getType()) {
+        case ColumnType::bool_type:
+            hash = folly::hash::twang_mix64(col.get_bool_val() ? 1 : 0);
+            break;
+        case ColumnType::int_type:
+            hash = folly::hash::twang_mix64(col.get_integer());
+            break;
+        case ColumnType::id_type:
+            hash = folly::hash::twang_mix64(col.get_id());
+            break;
+        case ColumnType::timestamp_type:
+            hash = folly::hash::twang_mix64(col.get_timestamp());
+            break;
+        case ColumnType::float_type:
+        case ColumnType::double_type: {
+            double v = col.getType() == ColumnType::float_type ? col.get_single_precision()
+                                                               : col.get_double_precision();
+            // 0.0 and -0.0 are the same
+            v = v == 0.0 ? 0.0 : v;
+            uint64_t bits = 0;
+            memcpy(&bits, &v, sizeof(bits));
+            hash = folly::hash::twang_mix64(bits);
+            break;
         }
-        return 0;
-    }
-};
-
-
-struct ColVal {
-    cpp2::ColumnValue col;
-
-    bool operator==(const ColVal &other) const {
-        return col == other.col;
-    }
-};
-
-
-struct ColVals {
-    std::vector<cpp2::ColumnValue> vec;
-
-    bool operator==(const ColVals &other) const {
-        return vec == other.vec;
-    }
-};
-
-
-struct ColHasher {
-    std::size_t operator()(const ColVal& k) const {
-        return GroupByHash::getHashVal(k.col);
+        case ColumnType::str_type:
+            hash = folly::hash::SpookyHashV2::Hash64(col.get_str().data(),
+                                                     col.get_str().size(),
+                                                     0);
+            break;
+        case ColumnType::empty_type:
+            break;
+        default:
+            LOG(ERROR) << "Untreated value type: " << static_cast<int32_t>(col.getType());
+            break;
     }
-};
+    return folly::hash::hash_128_to_64(static_cast<uint64_t>(col.getType()), hash);
+}
 
 
-struct ColsHasher {
-    std::size_t operator()(const ColVals& k) const {
-        auto hash_val = GroupByHash::getHashVal(k.vec[0]);
-        for (auto i = 1u; i< k.vec.size(); i++) {
-            hash_val ^= (GroupByHash::getHashVal(k.vec[i]) << 1);
-        }
-        return hash_val;
+/**
+ * The bytes on the heap taken by a value, besides the value itself
+ */
+inline size_t columnValueHeapSize(const cpp2::ColumnValue &col) {
+    if (col.getType() == ColumnType::str_type) {
+        return col.get_str().capacity();
     }
-};
+    return 0;
+}
 
 
 class AggFun {
@@ -124,6 +103,11 @@ public:
 public:
     virtual void apply(cpp2::ColumnValue &val) = 0;
     virtual cpp2::ColumnValue getResult() = 0;
+
+    // The bytes on the heap taken by the state, besides the function itself
+    virtual size_t memoryUsage() const {
+        return 0;
+    }
 };
 
 
@@ -137,6 +121,10 @@ public:
         return col_;
     }
 
+    size_t memoryUsage() const override {
+        return columnValueHeapSize(col_);
+    }
+
 private:
     cpp2::ColumnValue         col_;
 };
@@ -238,22 +226,77 @@ private:
 };
 
 
+/**
+ * Count the distinct values by their 64-bit hashes. The hashes are kept in a set until
+ * there are more than kExactLimit of them, then the count is estimated by HyperLogLog
+ * with 2^kPrecision registers, whose standard error is about 0.8%.
+ */
 class CountDistinct final : public AggFun {
 public:
     void apply(cpp2::ColumnValue &val) override {
-        ColVal col;
-        col.col = val;
-        vec_.emplace(std::move(col));
+        auto hash = hashColumnValue(val);
+        if (registers_.empty()) {
+            exact_.emplace(hash);
+            if (exact_.size() > kExactLimit) {
+                registers_.resize(1UL << kPrecision, 0);
+                for (auto h : exact_) {
+                    addHash(h);
+                }
+                std::unordered_set<uint64_t>().swap(exact_);
+            }
+        } else {
+            addHash(hash);
+        }
     }
 
     cpp2::ColumnValue getResult() override {
         cpp2::ColumnValue col;
-        col.set_integer(vec_.size());
+        if (registers_.empty()) {
+            col.set_integer(exact_.size());
+            return col;
+        }
+        const double m = registers_.size();
+        double sum = 0.0;
+        uint32_t zeros = 0;
+        for (auto r : registers_) {
+            sum += std::ldexp(1.0, -r);
+            if (r == 0) {
+                zeros++;
+            }
+        }
+        double estimate = 0.7213 / (1.0 + 1.079 / m) * m * m / sum;
+        if (estimate <= 2.5 * m && zeros > 0) {
+            // Linear counting for the small cardinalities
+            estimate = m * std::log(m / zeros);
+        }
+        col.set_integer(static_cast<int64_t>(std::llround(estimate)));
         return col;
     }
 
+    size_t memoryUsage() const override {
+        // A node of the set holds the hash and the next pointer, besides the buckets
+        return exact_.bucket_count() * sizeof(void*)
+             + exact_.size() * (sizeof(uint64_t) + sizeof(void*))
+             + registers_.capacity();
+    }
+
+private:
+    static constexpr size_t kExactLimit = 1024;
+    static constexpr uint32_t kPrecision = 14;
+
+    void addHash(uint64_t hash) {
+        auto index = hash >> (64 - kPrecision);
+        // The position of the first 1 bit in the rest bits
+        auto rest = (hash << kPrecision) | (1UL << (kPrecision - 1));
+        uint8_t rank = __builtin_clzll(rest) + 1;
+        if (registers_[index] < rank) {
+            registers_[index] = rank;
+        }
+    }
+
 private:
-    std::unordered_set<ColVal, ColHasher> vec_;
+    std::unordered_set<uint64_t>    exact_;
+    std::vector<uint8_t>            registers_;
 };
 
 
@@ -272,6 +315,10 @@ public:
         return max_;
     }
 
+    size_t memoryUsage() const override {
+        return columnValueHeapSize(max_);
+    }
+
 private:
     bool                  has_{false};
     cpp2::ColumnValue     max_;
@@ -293,45 +340,51 @@ public:
         return min_;
     }
 
+    size_t memoryUsage() const override {
+        return columnValueHeapSize(min_);
+    }
+
 private:
     bool                    has_{false};
     cpp2::ColumnValue       min_;
 };
 
 
+/**
+ * The population standard deviation, computed in one pass by Welford's algorithm
+ */
 class Stdev final : public AggFun {
 public:
     void apply(cpp2::ColumnValue &val) override {
-        avg_.apply(val);
+        double x = 0.0;
         if (val.getType() == ColumnType::int_type) {
-            auto doubleVal = static_cast<double>(val.get_integer());
-            elems_.emplace_back(doubleVal);
+            x = static_cast<double>(val.get_integer());
         } else if (val.getType() == ColumnType::double_type) {
-            auto doubleVal = val.get_double_precision();
-            elems_.emplace_back(doubleVal);
+            x = val.get_double_precision();
+        } else {
+            return;
         }
+        count_++;
+        auto delta = x - mean_;
+        mean_ += delta / count_;
+        m2_ += delta * (x - mean_);
     }
 
     cpp2::ColumnValue getResult() override {
         cpp2::ColumnValue result;
-        if (elems_.empty()) {
+        if (count_ == 0) {
             result.set_integer(0);
             return result;
         }
-        double acc = 0.0;
-        double avg = avg_.getResult().get_double_precision();
-        std::for_each(std::begin(elems_), std::end(elems_), [&](const double elem) {
-            acc += (elem - avg) * (elem - avg);
-        });
-
-        double stdev = std::sqrt(acc/elems_.size());
-        result.set_double_precision(stdev);
+        result.set_double_precision(std::sqrt(m2_ / count_));
         return result;
     }
 
 private:
-    Avg                          avg_;
-    std::vector<double>          elems_;
+    uint64_t                     count_{0};
+    double                       mean_{0.0};
+    // The sum of the squared differences from the mean
+    double                       m2_{0.0};
 };
 
 
@@ -436,6 +489,39 @@ static std::unordered_map<std::string, std::function<std::shared_ptr<AggFun>()>>
 };
 
 
+/**
+ * The aggregate functions of a group are constructed in place, so the states of all the
+ * groups are kept in an arena rather than allocated one by one.
+ */
+struct AggFunMeta {
+    size_t                  size;
+    size_t                  align;
+    AggFun*               (*create)(void *ptr);
+};
+
+template <typename T>
+AggFun* createAggFun(void *ptr) {
+    return new (ptr) T();
+}
+
+#define AGG_FUN_META(T) AggFunMeta{sizeof(T), alignof(T), &createAggFun<T>}
+
+static std::unordered_map<std::string, AggFunMeta> aggFunMetas = {
+    { "", AGG_FUN_META(Group) },
+    { kCount, AGG_FUN_META(Count) },
+    { kCountDist, AGG_FUN_META(CountDistinct) },
+    { kSum, AGG_FUN_META(Sum) },
+    { kAvg, AGG_FUN_META(Avg) },
+    { kMax, AGG_FUN_META(Max) },
+    { kMin, AGG_FUN_META(Min) },
+    { kStd, AGG_FUN_META(Stdev) },
+    { kBitAnd, AGG_FUN_META(BitAnd) },
+    { kBitOr, AGG_FUN_META(BitOr) },
+    { kBitXor, AGG_FUN_META(BitXor) }
+};
+
+#undef AGG_FUN_META
+
 }  // namespace graph
 }  // namespace nebula
 
@@ -6,6 +6,7 @@
 
 #include "base/Base.h"
 #include "graph/Executor.h"
+#include "graph/GraphFlags.h"
 #include "parser/TraverseSentences.h"
 #include "parser/MutateSentences.h"
 #include "parser/MaintainSentences.h"
@@ -279,6 +280,22 @@ Status Executor::writeVariantType(RowWriter &writer, const VariantType &value) {
     return Status::OK();
 }
 
+RowFormat Executor::spaceRowFormat() const {
+    if (FLAGS_fixed_offset_row_spaces.empty()) {
+        return RowFormat::V1;
+    }
+    std::vector<folly::StringPiece> spaces;
+    folly::split(",", FLAGS_fixed_offset_row_spaces, spaces, true);
+    const auto& current = ectx()->rctx()->session()->spaceName();
+    for (auto& space : spaces) {
+        if (folly::trimWhitespace(space) == current) {
+            return RowFormat::V2;
+        }
+    }
+    return RowFormat::V1;
+}
+
+
 bool Executor::checkValueType(const nebula::cpp2::ValueType &type, const VariantType &value) {
     switch (value.which()) {
         case VAR_INT64:
@@ -111,6 +111,9 @@ protected:
         return Status::OK();
     }
 
+    // The format to encode the rows inserted into the current space
+    RowFormat spaceRowFormat() const;
+
     StatusOr<VariantType> transformDefaultValue(nebula::cpp2::SupportedType type,
                                                 std::string& originalValue);
     void doError(Status status, uint32_t count = 1) const;
@@ -148,266 +148,59 @@ void FindPathExecutor::execute() {
         return;
     }
 
-    steps_ = step_.steps_ / 2 + step_.steps_ % 2;
-    fromVids_ = from_.vids_;
-    toVids_ = to_.vids_;
-    visitedFrom_.insert(fromVids_.begin(), fromVids_.end());
-    visitedTo_.insert(toVids_.begin(), toVids_.end());
-    targetNotFound_.insert(toVids_.begin(), toVids_.end());
-    for (auto &v : fromVids_) {
-        Path path;
-        pathFrom_.emplace(v, std::move(path));
-    }
-    for (auto &v : toVids_) {
-        Path path;
-        pathTo_.emplace(v, std::move(path));
-    }
-
+    finder_ = std::make_unique<PathFinder>(from_.vids_, to_.vids_, step_.steps_, shortest_);
     getNeighborsAndFindPath();
 }
 
 void FindPathExecutor::getNeighborsAndFindPath() {
-    // We meet the dead end.
-    if (fromVids_.empty() || toVids_.empty()) {
-        onFinish_(Executor::ProcessControl::kNext);
-        return;
-    }
-
-    fPro_ = std::make_unique<folly::Promise<folly::Unit>>();
-    tPro_ = std::make_unique<folly::Promise<folly::Unit>>();
-    std::vector<folly::Future<folly::Unit>> futures;
-    futures.emplace_back(fPro_->getFuture());
-    futures.emplace_back(tPro_->getFuture());
-
-    auto props = getStepOutProps(false);
-    if (!props.ok()) {
-        doError(std::move(props).status());
+    // We meet the dead end, or the paths are long enough.
+    if (finder_->finished()) {
+        doFinish(Executor::ProcessControl::kNext);
         return;
     }
-    getFromFrontiers(std::move(props).value());
 
-    props = getStepOutProps(true);
+    // Expand the side with the smaller frontier
+    auto reversely = !finder_->isFromNext();
+    auto props = getStepOutProps(reversely);
     if (!props.ok()) {
         doError(std::move(props).status());
         return;
     }
-    getToFrontiers(std::move(props).value());
-
+    auto future = ectx()->getStorageClient()->getNeighbors(
+            spaceId_,
+            finder_->frontier(),
+            reversely ? over_.oppositeTypes_ : over_.edgeTypes_,
+            "",
+            std::move(props).value());
     auto *runner = ectx()->rctx()->runner();
-    auto cb = [this] (auto &&result) {
-        UNUSED(result);
-        if (!fStatus_.ok() || !tStatus_.ok()) {
-            std::string msg = fStatus_.toString() + " " + tStatus_.toString();
-            doError(Status::Error(std::move(msg)));
+    auto cb = [this, reversely] (auto &&result) {
+        auto completeness = result.completeness();
+        if (completeness == 0) {
+            doError(Status::Error("Get neighbors failed."));
             return;
+        } else if (completeness != 100) {
+            LOG(INFO) << "Get neighbors partially failed: "  << completeness << "%";
+            for (auto &error : result.failedParts()) {
+                LOG(ERROR) << "part: " << error.first
+                           << "error code: " << static_cast<int>(error.second);
+            }
         }
-
-        findPath();
+        Frontiers frontiers;
+        auto status = doFilter(std::move(result), where_.filter_, !reversely, frontiers);
+        if (!status.ok()) {
+            doError(std::move(status));
+            return;
+        }
+        finder_->expand(frontiers);
+        VLOG(2) << "Expand the " << (reversely ? "target" : "source") << " side, "
+                << finder_->nodesNum() << " vertices reached";
+        getNeighborsAndFindPath();
     };
     auto error = [this] (auto &&e) {
         LOG(ERROR) << "Exception caught: " << e.what();
         doError(Status::Error("Find path exception: %s", e.what().c_str()));
     };
-    folly::collectAll(futures).via(runner).thenValue(cb).thenError(error);
-}
-
-void FindPathExecutor::findPath() {
-    VLOG(2) << "Find Path.";
-    visitedFrom_.clear();
-    std::multimap<VertexID, Path> pathF;
-    VLOG(2) << "Get froms: " << fromFrontiers_.second.size();
-    VLOG(2) << "Get tos: " << toFrontiers_.second.size();
-    for (auto &frontier : fromFrontiers_.second) {
-        // Notice: we treat edges with different ranking
-        // between two vertices as different path
-        for (auto &neighbor : frontier.second) {
-            auto dstId = std::get<0>(neighbor);
-            VLOG(2) << "src vertex:" << frontier.first;
-            VLOG(2) << "dst vertex:" << dstId;
-            // if frontiers of F are neighbors of visitedByT,
-            // we found an odd path
-            if (visitedTo_.count(dstId) == 1) {
-                meetOddPath(frontier.first, dstId, neighbor);
-            }
-
-            // update the path to frontiers
-            updatePath(frontier.first, pathFrom_, neighbor, pathF, VisitedBy::FROM);
-            visitedFrom_.emplace(dstId);
-        }  // for `neighbor'
-    }  // for `frontier'
-    pathFrom_ = std::move(pathF);
-    fromVids_.clear();
-    fromVids_.reserve(visitedFrom_.size());
-    std::copy(visitedFrom_.begin(),
-              visitedFrom_.end(), std::back_inserter(fromVids_));
-
-    visitedTo_.clear();
-    std::multimap<VertexID, Path> pathT;
-    for (auto &frontier : toFrontiers_.second) {
-        for (auto &neighbor : frontier.second) {
-            auto dstId = std::get<0>(neighbor);
-            // update the path to frontiers
-            updatePath(frontier.first, pathTo_, neighbor, pathT, VisitedBy::TO);
-            visitedTo_.emplace(dstId);
-        }  // for `neighbor'
-    }  // for `frontier'
-    pathTo_ = std::move(pathT);
-    toVids_.clear();
-    toVids_.reserve(visitedTo_.size());
-    std::copy(visitedTo_.begin(),
-              visitedTo_.end(), std::back_inserter(toVids_));
-
-    std::sort(fromVids_.begin(), fromVids_.end());
-    std::sort(toVids_.begin(), toVids_.end());
-    std::set<VertexID> intersect;
-    std::set_intersection(fromVids_.begin(), fromVids_.end(),
-                          toVids_.begin(), toVids_.end(),
-                          std::inserter(intersect, intersect.end()));
-    // if frontiersF meets frontiersT, we found an even path
-    if (!intersect.empty()) {
-        if (shortest_ && targetNotFound_.empty()) {
-            doFinish(Executor::ProcessControl::kNext);
-            return;
-        }
-        for (auto intersectId : intersect) {
-            meetEvenPath(intersectId);
-        }  // `intersectId'
-    }
-
-    if (isFinalStep() ||
-         (shortest_ && targetNotFound_.empty())) {
-        doFinish(Executor::ProcessControl::kNext);
-        return;
-    } else {
-        VLOG(2) << "Current step:" << currentStep_;
-        ++currentStep_;
-    }
-    getNeighborsAndFindPath();
-}
-
-inline void FindPathExecutor::meetOddPath(VertexID src, VertexID dst, Neighbor &neighbor) {
-    VLOG(2) << "Meet Odd Path.";
-    auto rangeF = pathFrom_.equal_range(src);
-    for (auto i = rangeF.first; i != rangeF.second; ++i) {
-        auto rangeT = pathTo_.equal_range(dst);
-        for (auto j = rangeT.first; j != rangeT.second; ++j) {
-            if (j->second.size() + i->second.size() > step_.steps_) {
-                continue;
-            }
-            // Build path:
-            // i->second + (src,type,ranking) + (dst, -type, ranking) + j->second
-            Path path = i->second;
-            auto s0 = std::make_unique<StepOut>(neighbor);
-            std::get<0>(*s0) = src;
-            path.emplace_back(s0.get());
-            stepOutHolder_.emplace(std::move(s0));
-            VLOG(2) << "PathF: " << buildPathString(path);
-
-            auto s1 = std::make_unique<StepOut>(neighbor);
-            std::get<1>(*s1) = - std::get<1>(neighbor);
-            path.emplace_back(s1.get());
-            stepOutHolder_.emplace(std::move(s1));
-            path.insert(path.end(), j->second.begin(), j->second.end());
-            VLOG(2) << "PathT: " << buildPathString(j->second);
-
-            auto target = std::get<0>(*(path.back()));
-            if (shortest_) {
-                targetNotFound_.erase(target);
-                auto pathFound = finalPath_.find(target);
-                if (pathFound != finalPath_.end()
-                        && pathFound->second.size() < path.size()) {
-                    // already found a shorter path
-                    continue;
-                } else {
-                    VLOG(2) << "Found path: " << buildPathString(path);
-                    finalPath_.emplace(std::move(target), std::move(path));
-                }
-            } else {
-                VLOG(2) << "Found path: " << buildPathString(path);
-                finalPath_.emplace(std::move(target), std::move(path));
-            }
-        }  // for `j'
-    }  // for `i'
-}
-
-inline void FindPathExecutor::meetEvenPath(VertexID intersectId) {
-    VLOG(2) << "Meet Even Path.";
-    auto rangeF = pathFrom_.equal_range(intersectId);
-    auto rangeT = pathTo_.equal_range(intersectId);
-    for (auto i = rangeF.first; i != rangeF.second; ++i) {
-        for (auto j = rangeT.first; j != rangeT.second; ++j) {
-            if (j->second.size() + i->second.size() > step_.steps_) {
-                continue;
-            }
-            // Build path:
-            // i->second + (src,type,ranking) + j->second
-            Path path = i->second;
-            VLOG(2) << "PathF: " << buildPathString(path);
-            if (j->second.size() > 0) {
-                StepOut *s = j->second.front();
-                auto s0 = std::make_unique<StepOut>(*s);
-                std::get<0>(*s0) = intersectId;
-                std::get<1>(*s0) = - std::get<1>(*s0);
-                path.emplace_back(s0.get());
-                stepOutHolder_.emplace(std::move(s0));
-                VLOG(2) << "Joiner: " << buildPathString(path);
-            } else if (i->second.size() > 0) {
-                StepOut *s = i->second.back();
-                auto s0 = std::make_unique<StepOut>(*s);
-                std::get<0>(*s0) = intersectId;
-                path.emplace_back(s0.get());
-                stepOutHolder_.emplace(std::move(s0));
-                VLOG(2) << "Joiner: " << buildPathString(path);
-            }
-            VLOG(2) << "PathT: " << buildPathString(j->second);
-            path.insert(path.end(), j->second.begin(), j->second.end());
-            auto target = std::get<0>(*(path.back()));
-            if (shortest_) {
-                auto pathFound = finalPath_.find(target);
-                if (pathFound != finalPath_.end()
-                        && pathFound->second.size() < path.size()) {
-                    // already found a shorter path
-                    continue;
-                } else {
-                    targetNotFound_.erase(target);
-                    VLOG(2) << "Found path: " << buildPathString(path);
-                    finalPath_.emplace(std::move(target), std::move(path));
-                }
-            } else {
-                VLOG(2) << "Found path: " << buildPathString(path);
-                finalPath_.emplace(std::move(target), std::move(path));
-            }
-        }
-    }
-}
-
-inline void FindPathExecutor::updatePath(
-            VertexID &src,
-            std::multimap<VertexID, Path> &pathToSrc,
-            Neighbor &neighbor,
-            std::multimap<VertexID, Path> &pathToNeighbor,
-            VisitedBy visitedBy) {
-    VLOG(2) << "Update Path.";
-    auto range = pathToSrc.equal_range(src);
-    for (auto i = range.first; i != range.second; ++i) {
-        // Build path:
-        // i->second + (src,type,ranking)
-        Path path = i->second;
-        VLOG(2) << "Interim path before :" << buildPathString(path);
-        VLOG(2) << "Interim path length before:" << path.size();
-        auto s = std::make_unique<StepOut>(neighbor);
-        std::get<0>(*s) = src;
-        if (visitedBy == VisitedBy::FROM) {
-            path.emplace_back(s.get());
-        } else {
-            path.emplace(path.begin(), s.get());
-        }
-        VLOG(2) << "Neighbor: " << std::get<0>(neighbor);
-        VLOG(2) << "Interim path:" << buildPathString(path);
-        VLOG(2) << "Interim path length:" << path.size();
-        stepOutHolder_.emplace(std::move(s));
-        pathToNeighbor.emplace(std::get<0>(neighbor), std::move(path));
-    }  // for `i'
+    std::move(future).via(runner, folly::Executor::HI_PRI).thenValue(cb).thenError(error);
 }
 
 Status FindPathExecutor::setupVids() {
@@ -457,82 +250,6 @@ Status FindPathExecutor::setupVidsFromRef(Clause::Vertices &vertices) {
     return Status::OK();
 }
 
-void FindPathExecutor::getFromFrontiers(
-        std::vector<storage::cpp2::PropDef> props) {
-    auto future = ectx()->getStorageClient()->getNeighbors(spaceId_,
-                                                           std::move(fromVids_),
-                                                           over_.edgeTypes_,
-                                                           "",
-                                                           std::move(props));
-    auto *runner = ectx()->rctx()->runner();
-    auto cb = [this] (auto &&result) {
-        Frontiers frontiers;
-        auto completeness = result.completeness();
-        if (completeness == 0) {
-            fStatus_ = Status::Error("Get neighbors failed.");
-            fPro_->setValue();
-            return;
-        } else if (completeness != 100) {
-            LOG(INFO) << "Get neighbors partially failed: "  << completeness << "%";
-            for (auto &error : result.failedParts()) {
-                LOG(ERROR) << "part: " << error.first
-                           << "error code: " << static_cast<int>(error.second);
-            }
-        }
-        auto status = doFilter(std::move(result), where_.filter_, true, frontiers);
-        if (!status.ok()) {
-            fStatus_ = std::move(status);
-            fPro_->setValue();
-            return;
-        }
-        fromFrontiers_ = std::make_pair(VisitedBy::FROM, std::move(frontiers));
-        fPro_->setValue();
-    };
-    auto error = [this] (auto &&e) {
-        LOG(ERROR) << "Exception caught: " << e.what();
-        fStatus_ = Status::Error("Get neighbors exception: %s.", e.what().c_str());
-    };
-    std::move(future).via(runner, folly::Executor::HI_PRI).thenValue(cb).thenError(error);
-}
-
-void FindPathExecutor::getToFrontiers(
-        std::vector<storage::cpp2::PropDef> props) {
-    auto future = ectx()->getStorageClient()->getNeighbors(spaceId_,
-                                                           std::move(toVids_),
-                                                           over_.oppositeTypes_,
-                                                           "",
-                                                           std::move(props));
-    auto *runner = ectx()->rctx()->runner();
-    auto cb = [this] (auto &&result) {
-        Frontiers frontiers;
-        auto completeness = result.completeness();
-        if (completeness == 0) {
-            tStatus_ = Status::Error("Get neighbors failed.");
-            tPro_->setValue();
-            return;
-        } else if (completeness != 100) {
-            LOG(INFO) << "Get neighbors partially failed: "  << completeness << "%";
-            for (auto &error : result.failedParts()) {
-                LOG(ERROR) << "part: " << error.first
-                           << "error code: " << static_cast<int>(error.second);
-            }
-        }
-        auto status = doFilter(std::move(result), where_.filter_, false, frontiers);
-        if (!status.ok()) {
-            tStatus_ = std::move(status);
-            tPro_->setValue();
-            return;
-        }
-        toFrontiers_ = std::make_pair(VisitedBy::TO, std::move(frontiers));
-        tPro_->setValue();
-    };
-    auto error = [this] (auto &&e) {
-        LOG(ERROR) << "Exception caught: " << e.what();
-        tStatus_ = Status::Error("Get neighbors exception: %s.", e.what().c_str());
-    };
-    std::move(future).via(runner, folly::Executor::HI_PRI).thenValue(cb).thenError(error);
-}
-
 Status FindPathExecutor::doFilter(
         storage::StorageRpcResponse<storage::cpp2::QueryResponse> &&result,
         Expression *filter,
@@ -627,88 +344,42 @@ FindPathExecutor::getStepOutProps(bool reversely) {
     return props;
 }
 
-std::string FindPathExecutor::buildPathString(const Path &path) {
+std::string FindPathExecutor::buildPathString(const PathFinder::Path &path) {
     std::string pathStr;
-    auto iter = path.begin();
-    for (; iter != path.end(); ++iter) {
-        auto *step = *iter;
-        auto id = std::get<0>(*step);
-        auto type = std::get<1>(*step);
-        auto ranking = std::get<2>(*step);
-        if (type < 0) {
-            pathStr += folly::to<std::string>(id);
-            ++iter;
-            break;
+    for (auto &step : path) {
+        pathStr += folly::to<std::string>(std::get<0>(step));
+        auto type = std::get<1>(step);
+        if (type != 0) {
+            pathStr += folly::stringPrintf("<%d,%ld>", type, std::get<2>(step));
         }
-
-        pathStr += folly::stringPrintf("%ld<%d,%ld>", id, type, ranking);
-    }
-
-    for (; iter != path.end(); ++iter) {
-        auto *step = *iter;
-        auto id = std::get<0>(*step);
-        auto type = std::get<1>(*step);
-        auto ranking = std::get<2>(*step);
-
-        pathStr += folly::stringPrintf("<%d,%ld>%ld", -type, ranking, id);
     }
-
     return pathStr;
 }
 
-cpp2::RowValue FindPathExecutor::buildPathRow(const Path &path) {
+cpp2::RowValue FindPathExecutor::buildPathRow(const PathFinder::Path &path) {
     cpp2::RowValue rowValue;
     std::vector<cpp2::ColumnValue> row;
     cpp2::Path pathValue;
     auto entryList = pathValue.get_entry_list();
-    auto iter = path.begin();
-    for (; iter != path.end(); ++iter) {
-        auto *step = *iter;
-        auto id = std::get<0>(*step);
-        auto type = std::get<1>(*step);
-        auto ranking = std::get<2>(*step);
-        if (type < 0) {
-            entryList.emplace_back();
-            cpp2::Vertex vertex;
-            vertex.set_id(id);
-            entryList.back().set_vertex(std::move(vertex));
-            ++iter;
-            break;
-        }
+    for (auto &step : path) {
         entryList.emplace_back();
         cpp2::Vertex vertex;
-        vertex.set_id(id);
+        vertex.set_id(std::get<0>(step));
         entryList.back().set_vertex(std::move(vertex));
 
+        auto type = std::get<1>(step);
+        if (type == 0) {
+            break;
+        }
         entryList.emplace_back();
         cpp2::Edge edge;
         auto typeName = edgeTypeNameMap_.find(type);
         DCHECK(typeName != edgeTypeNameMap_.end()) << type;
         edge.set_type(typeName->second);
-        edge.set_ranking(ranking);
+        edge.set_ranking(std::get<2>(step));
         entryList.back().set_edge(std::move(edge));
     }
 
-    for (; iter != path.end(); ++iter) {
-        auto *step = *iter;
-        auto id = std::get<0>(*step);
-        auto type = std::get<1>(*step);
-        auto ranking = std::get<2>(*step);
-
-        entryList.emplace_back();
-        cpp2::Edge edge;
-        auto typeName = edgeTypeNameMap_.find(-type);
-        DCHECK(typeName != edgeTypeNameMap_.end()) << type;
-        edge.set_type(typeName->second);
-        edge.set_ranking(ranking);
-        entryList.back().set_edge(std::move(edge));
-
-        entryList.emplace_back();
-        cpp2::Vertex vertex;
-        vertex.set_id(id);
-        entryList.back().set_vertex(std::move(vertex));
-    }
-
     row.emplace_back();
     pathValue.set_entry_list(std::move(entryList));
     row.back().set_path(std::move(pathValue));
@@ -718,10 +389,12 @@ cpp2::RowValue FindPathExecutor::buildPathRow(const Path &path) {
 
 void FindPathExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
     std::vector<cpp2::RowValue> rows;
-    for (auto &path : finalPath_) {
-        auto row = buildPathRow(path.second);
-        rows.emplace_back(std::move(row));
-        VLOG(1) << "Path: " << buildPathString(path.second);
+    if (finder_ != nullptr) {
+        // The paths are enumerated from the meeting points only now
+        for (auto &path : finder_->paths()) {
+            rows.emplace_back(buildPathRow(path));
+            VLOG(1) << "Path: " << buildPathString(path);
+        }
     }
 
     std::vector<std::string> colNames = {"_path_"};
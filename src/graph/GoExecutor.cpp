@@ -15,6 +15,12 @@
 
 DEFINE_bool(filter_pushdown, true, "If pushdown the filter to storage.");
 DEFINE_bool(trace_go, false, "Whether to dump the detail trace log from one go request");
+DEFINE_int32(go_step_page_size, 0,
+             "The max vertices of each page when stepping out, the steps are pipelined "
+             "by pages if it is greater than 0");
+DEFINE_int64(go_final_step_max_bytes, 512 * 1024 * 1024,
+             "The max bytes of the pages of the final step kept when the steps are "
+             "pipelined by pages, the query fails beyond it. No limit if it is 0");
 
 namespace nebula {
 namespace graph {
@@ -109,6 +115,10 @@ void GoExecutor::execute() {
         }
         starts_ = std::vector<VertexID>(uniqID.begin(), uniqID.end());
     }
+    if (canPipeline()) {
+        pipelinedStepOut();
+        return;
+    }
     stepOut();
 }
 
@@ -456,7 +466,7 @@ void GoExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
 
 void GoExecutor::stepOut() {
     auto spaceId = ectx()->rctx()->session()->space();
-    auto status = getStepOutProps();
+    auto status = getStepOutProps(isFinalStep());
     if (!status.ok()) {
         doError(std::move(status).status());
         return;
@@ -535,6 +545,186 @@ void GoExecutor::onStepOutResponse(RpcResponse &&rpcResp) {
 }
 
 
+bool GoExecutor::canPipeline() const {
+    return FLAGS_go_step_page_size > 0 && (steps_ == 1 || index_ == nullptr);
+}
+
+
+void GoExecutor::pipelinedStepOut() {
+    pipeline_ = std::make_unique<Pipeline>();
+    if (steps_ > 1) {
+        auto status = getStepOutProps(false);
+        if (!status.ok()) {
+            doError(std::move(status).status());
+            return;
+        }
+        pipeline_->stepProps = std::move(status).value();
+    }
+    auto status = getStepOutProps(true);
+    if (!status.ok()) {
+        doError(std::move(status).status());
+        return;
+    }
+    pipeline_->finalProps = std::move(status).value();
+    if (FLAGS_filter_pushdown && direction_ == OverClause::Direction::kForward) {
+        // TODO: not support filter pushdown in reversely traversal now.
+        pipeline_->finalFilter = whereWrapper_->filterPushdown_;
+    }
+    pipeline_->visited.resize(steps_);
+    pipeline_->inflight = 1;
+    if (steps_ == 1) {
+        pipeline_->finalRequests = 1;
+    }
+    stepOutPages(1, std::move(starts_));
+}
+
+
+void GoExecutor::stepOutPages(uint32_t step, std::vector<VertexID> starts) {
+    auto spaceId = ectx()->rctx()->session()->space();
+    auto finalStep = step == steps_;
+    VLOG(1) << "Step " << step << " out by pages, total request vertices " << starts.size();
+    auto future = ectx()->getStorageClient()->getNeighborsPaged(
+        spaceId,
+        starts,
+        edgeTypes_,
+        finalStep ? pipeline_->finalFilter : "",
+        finalStep ? pipeline_->finalProps : pipeline_->stepProps,
+        FLAGS_go_step_page_size,
+        [this, step] (storage::cpp2::QueryResponse &&resp) {
+            return onStepOutPage(step, std::move(resp));
+        });
+    auto *runner = ectx()->rctx()->runner();
+    auto cb = [this] (auto &&result) {
+        auto completeness = result.completeness();
+        if (completeness == 0) {
+            onStepOutPagesDone(Status::Error("Get neighbors failed"));
+            return;
+        } else if (completeness != 100) {
+            LOG(INFO) << "Get neighbors partially failed: "  << completeness << "%";
+            std::lock_guard<std::mutex> g(pipeline_->lock);
+            for (auto &error : result.failedParts()) {
+                LOG(ERROR) << "part: " << error.first
+                           << "error code: " << static_cast<int>(error.second);
+                pipeline_->failedParts.emplace(error.first, error.second);
+            }
+        }
+        onStepOutPagesDone(Status::OK());
+    };
+    auto error = [this] (auto &&e) {
+        LOG(ERROR) << "Exception when handle out-bounds/in-bounds: " << e.what();
+        onStepOutPagesDone(Status::Error("Exeception when handle out-bounds/in-bounds: %s.",
+                                         e.what().c_str()));
+    };
+    std::move(future).via(runner).thenValue(cb).thenError(error);
+}
+
+
+bool GoExecutor::onStepOutPage(uint32_t step, storage::cpp2::QueryResponse &&resp) {
+    if (step == steps_) {
+        auto bytes = pageBytes(resp);
+        std::lock_guard<std::mutex> g(pipeline_->lock);
+        if (!pipeline_->status.ok()) {
+            return false;
+        }
+        pipeline_->finalBytes += bytes;
+        if (FLAGS_go_final_step_max_bytes > 0
+                && pipeline_->finalBytes > static_cast<size_t>(FLAGS_go_final_step_max_bytes)) {
+            pipeline_->status = Status::Error(
+                    "The final step takes more than %ld bytes, see go_final_step_max_bytes",
+                    FLAGS_go_final_step_max_bytes);
+            // The query fails, so the pages are released at once
+            std::vector<storage::cpp2::QueryResponse>().swap(pipeline_->finalPages);
+            return false;
+        }
+        pipeline_->finalPages.emplace_back(std::move(resp));
+        return true;
+    }
+
+    std::vector<VertexID> dsts;
+    {
+        std::lock_guard<std::mutex> g(pipeline_->lock);
+        if (!pipeline_->status.ok()) {
+            return false;
+        }
+        auto *vertices = resp.get_vertices();
+        if (vertices == nullptr) {
+            return true;
+        }
+        // Each vertex is stepped out once at each step, as getDstIdsFromResp does
+        auto &visited = pipeline_->visited[step];
+        for (auto &vdata : *vertices) {
+            for (auto &edata : vdata.edge_data) {
+                for (auto& edge : edata.get_edges()) {
+                    if (visited.emplace(edge.get_dst()).second) {
+                        dsts.emplace_back(edge.get_dst());
+                    }
+                }
+            }
+        }
+        if (dsts.empty()) {
+            return true;
+        }
+        // The request of the next step is counted before this one is done
+        ++pipeline_->inflight;
+        if (step + 1 == steps_) {
+            ++pipeline_->finalRequests;
+        }
+    }
+    stepOutPages(step + 1, std::move(dsts));
+    return true;
+}
+
+
+size_t GoExecutor::pageBytes(const storage::cpp2::QueryResponse &resp) {
+    auto *vertices = resp.get_vertices();
+    if (vertices == nullptr) {
+        return 0;
+    }
+    size_t bytes = 0;
+    for (auto &vdata : *vertices) {
+        bytes += sizeof(vdata);
+        for (auto &tdata : vdata.get_tag_data()) {
+            bytes += sizeof(tdata) + tdata.get_data().size();
+        }
+        for (auto &edata : vdata.get_edge_data()) {
+            for (auto &edge : edata.get_edges()) {
+                bytes += sizeof(edge) + edge.get_props().size();
+            }
+        }
+    }
+    return bytes;
+}
+
+
+void GoExecutor::onStepOutPagesDone(Status status) {
+    {
+        std::lock_guard<std::mutex> g(pipeline_->lock);
+        if (!status.ok() && pipeline_->status.ok()) {
+            pipeline_->status = std::move(status);
+        }
+        if (--pipeline_->inflight != 0) {
+            return;
+        }
+    }
+
+    // All pages of all steps have arrived
+    auto pipeline = std::move(pipeline_);
+    if (!pipeline->status.ok()) {
+        doError(std::move(pipeline->status));
+        return;
+    }
+    if (pipeline->finalRequests == 0) {
+        onEmptyInputs();
+        return;
+    }
+    RpcResponse rpcResp(pipeline->finalRequests);
+    rpcResp.failedParts() = std::move(pipeline->failedParts);
+    rpcResp.responses() = std::move(pipeline->finalPages);
+    curStep_ = steps_;
+    maybeFinishExecution(std::move(rpcResp));
+}
+
+
 void GoExecutor::maybeFinishExecution(RpcResponse &&rpcResp) {
     auto requireDstProps = expCtx_->hasDstTagProp();
 
@@ -709,9 +899,9 @@ StatusOr<std::vector<cpp2::RowValue>> GoExecutor::toThriftResponse(RpcResponse&&
     return rows;
 }
 
-StatusOr<std::vector<storage::cpp2::PropDef>> GoExecutor::getStepOutProps() {
+StatusOr<std::vector<storage::cpp2::PropDef>> GoExecutor::getStepOutProps(bool finalStep) {
     std::vector<storage::cpp2::PropDef> props;
-    if (!isFinalStep()) {
+    if (!finalStep) {
         for (auto &e : edgeTypes_) {
             storage::cpp2::PropDef pd;
             pd.owner = storage::cpp2::PropOwner::EDGE;
@@ -103,7 +103,36 @@ private:
      */
     void onVertexProps(RpcResponse &&rpcResp);
 
-    StatusOr<std::vector<storage::cpp2::PropDef>> getStepOutProps();
+    /**
+     * Whether the steps could be stepped out by pages in a pipeline.
+     * Not if the root of each path is needed, since the steps are interleaved.
+     */
+    bool canPipeline() const;
+
+    /**
+     * To step out all steps by pages. The new destinations of every page are stepped out
+     * for the next step at once, without waiting for the rest of the step. The pages of
+     * the final step are collected and then finished as usual.
+     */
+    void pipelinedStepOut();
+
+    void stepOutPages(uint32_t step, std::vector<VertexID> starts);
+
+    /**
+     * Callback invoked upon a page of the given step arrives, in the IO threads.
+     * Returns false to stop getting the pages once the query fails.
+     */
+    bool onStepOutPage(uint32_t step, storage::cpp2::QueryResponse &&resp);
+
+    // The bytes of the vertices and edges in a page, roughly
+    static size_t pageBytes(const storage::cpp2::QueryResponse &resp);
+
+    /**
+     * Callback invoked when all pages of one paged request have arrived.
+     */
+    void onStepOutPagesDone(Status status);
+
+    StatusOr<std::vector<storage::cpp2::PropDef>> getStepOutProps(bool finalStep);
     StatusOr<std::vector<storage::cpp2::PropDef>> getDstProps();
 
     void fetchVertexProps(std::vector<VertexID> ids, RpcResponse &&rpcResp);
@@ -196,6 +225,25 @@ private:
 
     OptVariantType getPropFromInterim(VertexID id, const std::string &prop) const;
 
+    // The state of stepping out by pages
+    struct Pipeline {
+        std::mutex                                      lock;
+        std::vector<storage::cpp2::PropDef>             stepProps;
+        std::vector<storage::cpp2::PropDef>             finalProps;
+        std::string                                     finalFilter;
+        // The destinations found at each step, which are stepped out by the next step,
+        // indexed by the step. So the first one and the final one are never used.
+        std::vector<std::unordered_set<VertexID>>       visited;
+        // The number of paged requests whose pages have not all arrived
+        size_t                                          inflight{0};
+        size_t                                          finalRequests{0};
+        // The final step is buffered till the end, limited by go_final_step_max_bytes
+        std::vector<storage::cpp2::QueryResponse>       finalPages;
+        size_t                                          finalBytes{0};
+        std::unordered_map<PartitionID, storage::cpp2::ErrorCode> failedParts;
+        Status                                          status;
+    };
+
     enum FromType {
         kInstantExpr,
         kVariable,
@@ -224,6 +272,7 @@ private:
     std::unique_ptr<VertexHolder>               vertexHolder_;
     std::unique_ptr<VertexBackTracker>          backTracker_;
     std::unique_ptr<cpp2::ExecutionResponse>    resp_;
+    std::unique_ptr<Pipeline>                   pipeline_;
     // The name of Tag or Edge, index of prop in data
     using SchemaPropIndex = std::unordered_map<std::pair<std::string, std::string>, int64_t>;
 };
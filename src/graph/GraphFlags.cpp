@@ -32,3 +32,17 @@ DEFINE_bool(local_config, false, "meta client will not retrieve latest configura
 
 DEFINE_string(default_charset, "utf8", "The default charset when a space is created");
 DEFINE_string(default_collate, "utf8_bin", "The default collate when a space is created");
+
+DEFINE_string(fixed_offset_row_spaces, "",
+              "Comma separated names of the spaces, whose inserted rows are encoded "
+              "with the offsets of all fields (RowFormat::V2)");
+
+DEFINE_string(query_spill_path, "/tmp",
+              "Directory of the temporary files, which the queries spill to when they are "
+              "out of the memory budget");
+DEFINE_int64(group_by_memory_budget, 256 * 1024 * 1024,
+             "Bytes of the groups a GROUP BY keeps in memory, the rows of the new groups "
+             "beyond it are spilled to disk");
+DEFINE_int64(order_by_memory_budget, 256 * 1024 * 1024,
+             "Bytes of the sort keys an ORDER BY keeps in memory, the keys beyond it are "
+             "sorted and spilled to disk as runs, which are merged at last");
@@ -30,4 +30,10 @@ DECLARE_string(meta_server_addrs);
 DECLARE_string(default_charset);
 DECLARE_string(default_collate);
 
+DECLARE_string(fixed_offset_row_spaces);
+
+DECLARE_string(query_spill_path);
+DECLARE_int64(group_by_memory_budget);
+DECLARE_int64(order_by_memory_budget);
+
 #endif  // GRAPH_GRAPHFLAGS_H_
@@ -7,6 +7,8 @@
 #include "base/Base.h"
 #include "graph/GroupByExecutor.h"
 #include "graph/AggregateFunction.h"
+#include "graph/GraphFlags.h"
+#include "graph/HashAggregator.h"
 
 namespace nebula {
 namespace graph {
@@ -191,13 +193,6 @@ void GroupByExecutor::execute() {
         doError(std::move(status));
         return;
     }
-    auto ret = inputs_->getRows();
-    if (!ret.ok()) {
-        LOG(ERROR) << "Get rows failed: " << ret.status();
-        doError(std::move(ret).status());
-        return;
-    }
-    rows_ = std::move(ret).value();
     schema_ = inputs_->schema();
 
     status = checkAll();
@@ -232,30 +227,40 @@ void GroupByExecutor::execute() {
 
 
 Status GroupByExecutor::groupingData() {
-    using FunCols = std::vector<std::shared_ptr<AggFun>>;
-    // key : the column values of group by, val: function table of aggregated columns
-    using GroupData = std::unordered_map<ColVals, FunCols, ColsHasher>;
+    std::vector<std::string> funNames;
+    funNames.reserve(yieldCols_.size());
+    for (auto &col : yieldCols_) {
+        funNames.emplace_back(col->getFunName());
+    }
+    HashAggregator aggregator(std::move(funNames), FLAGS_group_by_memory_budget);
 
-    GroupData data;
+    // The input values are read from the columns directly
+    std::vector<cpp2::ColumnValue::Type> inputTypes;
+    inputTypes.reserve(schema_->getNumFields());
+    for (auto i = 0u; i < schema_->getNumFields(); i++) {
+        inputTypes.emplace_back(InterimResult::toColumnValueType(schema_->getFieldType(i).type));
+    }
+
+    size_t row = 0;
+    cpp2::ColumnValue::Type valType = cpp2::ColumnValue::Type::__EMPTY__;
     Getters getters;
-    for (auto& it : rows_) {
-        ColVals groupVals;
-        FunCols calVals;
+    getters.getInputProp = [&] (const std::string &prop) -> OptVariantType {
+        auto indexIt = schemaMap_.find(prop);
+        if (indexIt == schemaMap_.end()) {
+            LOG(ERROR) << prop <<  " is nonexistent";
+            return Status::Error("%s is nonexistent", prop.c_str());
+        }
+        valType = inputTypes[indexIt->second];
+        return inputs_->getColumn(row, indexIt->second);
+    };
 
+    std::vector<cpp2::ColumnValue> groupVals;
+    std::vector<cpp2::ColumnValue> vals;
+    for (row = 0; row < inputs_->rowsNum(); row++) {
         // Firstly: group the cols
+        groupVals.clear();
         for (auto &col : groupCols_) {
-            cpp2::ColumnValue::Type valType = cpp2::ColumnValue::Type::__EMPTY__;
-            getters.getInputProp = [&] (const std::string & prop) -> OptVariantType {
-                auto indexIt = schemaMap_.find(prop);
-                if (indexIt == schemaMap_.end()) {
-                    LOG(ERROR) << prop <<  " is nonexistent";
-                    return Status::Error("%s is nonexistent", prop.c_str());
-                }
-                auto val = it.columns[indexIt->second];
-                valType = val.getType();
-                return toVariantType(val);
-            };
-
+            valType = cpp2::ColumnValue::Type::__EMPTY__;
             auto eval = col->expr()->eval(getters);
             if (!eval.ok()) {
                 return eval.status();
@@ -265,38 +270,14 @@ Status GroupByExecutor::groupingData() {
             if (!cVal.ok()) {
                 return cVal.status();
             }
-            groupVals.vec.emplace_back(std::move(cVal).value());
+            groupVals.emplace_back(std::move(cVal).value());
         }
 
-        auto findIt = data.find(groupVals);
-
         // Secondly: get the value of the aggregated column
-
-        // Get all aggregation function
-        if (findIt == data.end()) {
-            for (auto &col : yieldCols_) {
-                auto funPtr = funVec[col->getFunName()]();
-                calVals.emplace_back(std::move(funPtr));
-            }
-        } else {
-            calVals = findIt->second;
-        }
-
-        // Apply value
-        auto i = 0u;
-        for (auto &col : calVals) {
-            cpp2::ColumnValue::Type valType = cpp2::ColumnValue::Type::__EMPTY__;
-            getters.getInputProp = [&] (const std::string &prop) -> OptVariantType{
-                auto indexIt = schemaMap_.find(prop);
-                if (indexIt == schemaMap_.end()) {
-                    LOG(ERROR) << prop <<  " is nonexistent";
-                    return Status::Error("%s is nonexistent", prop.c_str());
-                }
-                auto val = it.columns[indexIt->second];
-                valType = val.getType();
-                return toVariantType(val);
-            };
-            auto eval = yieldCols_[i]->expr()->eval(getters);
+        vals.clear();
+        for (auto &col : yieldCols_) {
+            valType = cpp2::ColumnValue::Type::__EMPTY__;
+            auto eval = col->expr()->eval(getters);
             if (!eval.ok()) {
                 return eval.status();
             }
@@ -305,27 +286,21 @@ Status GroupByExecutor::groupingData() {
             if (!cVal.ok()) {
                 return cVal.status();
             }
-            col->apply(cVal.value());
-            i++;
+            vals.emplace_back(std::move(cVal).value());
         }
 
-        if (findIt == data.end()) {
-            data.emplace(std::move(groupVals), std::move(calVals));
+        auto status = aggregator.apply(groupVals, vals);
+        if (!status.ok()) {
+            return status;
         }
     }
 
     // Generate result data
     rows_.clear();
-    for (auto& item : data) {
-        std::vector<cpp2::ColumnValue> row;
-        for (auto& col : item.second) {
-            row.emplace_back(col->getResult());
-        }
+    return aggregator.finish([this] (std::vector<cpp2::ColumnValue> cols) {
         rows_.emplace_back();
-        rows_.back().set_columns(std::move(row));
-    }
-
-    return Status::OK();
+        rows_.back().set_columns(std::move(cols));
+    });
 }
 
 
@@ -387,11 +362,12 @@ StatusOr<std::unique_ptr<InterimResult>> GroupByExecutor::setupInterimResult() {
         return result;
     }
     // Generate results
-    std::unique_ptr<RowSetWriter> rsWriter = std::make_unique<RowSetWriter>(resultSchema_);
-
-    InterimResult::getResultWriter(rows_, rsWriter.get());
-    if (rsWriter != nullptr) {
-        result->setInterim(std::move(rsWriter));
+    result->setSchema(resultSchema_);
+    for (auto &row : rows_) {
+        auto status = result->addRow(row);
+        if (!status.ok()) {
+            return status;
+        }
     }
     return result;
 }
@@ -0,0 +1,209 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/HashAggregator.h"
+
+namespace nebula {
+namespace graph {
+
+HashAggregator::HashAggregator(std::vector<std::string> funNames,
+                               int64_t memoryBudget,
+                               uint32_t level)
+    : funNames_(std::move(funNames))
+    , memoryBudget_(memoryBudget)
+    , level_(level)
+    , arena_(std::make_unique<Arena>()) {
+    for (auto &name : funNames_) {
+        auto iter = aggFunMetas.find(name);
+        CHECK(iter != aggFunMetas.end()) << "Unknown aggregate function " << name;
+        auto *meta = &iter->second;
+        statesSize_ = (statesSize_ + meta->align - 1) / meta->align * meta->align;
+        offsets_.emplace_back(statesSize_);
+        statesSize_ += meta->size;
+        statesAlign_ = std::max(statesAlign_, meta->align);
+        funMetas_.emplace_back(meta);
+    }
+    slots_.assign(kMinSlots, 0);
+}
+
+
+HashAggregator::~HashAggregator() {
+    clear();
+}
+
+
+Status HashAggregator::apply(const std::vector<cpp2::ColumnValue> &keys,
+                             std::vector<cpp2::ColumnValue> &vals) {
+    DCHECK_EQ(funMetas_.size(), vals.size());
+    keysNum_ = keys.size();
+    keyBuf_.clear();
+    SpillFile::encodeRow(keys, keyBuf_);
+    // Hash by the level, so the rows of a partition are spread again when spilled
+    auto hash = folly::hash::SpookyHashV2::Hash64(keyBuf_.data(), keyBuf_.size(), level_);
+
+    auto slot = findSlot(keyBuf_, hash);
+    if (slots_[slot] == 0) {
+        if (static_cast<int64_t>(memoryUsage()) >= memoryBudget_ && level_ < kMaxLevel) {
+            return spill(hash, keys, vals);
+        }
+        addGroup(slot, keyBuf_, hash);
+        if (groups_.size() * 2 > slots_.size()) {
+            grow();
+        }
+        slot = findSlot(keyBuf_, hash);
+    }
+
+    auto &group = groups_[slots_[slot] - 1];
+    for (auto i = 0u; i < vals.size(); i++) {
+        auto *fun = group.funs[i];
+        auto before = fun->memoryUsage();
+        fun->apply(vals[i]);
+        funsMemory_ += fun->memoryUsage() - before;
+    }
+    return Status::OK();
+}
+
+
+size_t HashAggregator::findSlot(folly::StringPiece key, uint64_t hash) const {
+    DCHECK(!slots_.empty());
+    auto mask = slots_.size() - 1;
+    auto pos = hash & mask;
+    while (slots_[pos] != 0) {
+        auto &group = groups_[slots_[pos] - 1];
+        if (group.hash == hash && group.key == key) {
+            break;
+        }
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+
+void HashAggregator::addGroup(size_t slot, folly::StringPiece key, uint64_t hash) {
+    Group group;
+    group.key = arena_->copy(key);
+    group.hash = hash;
+    group.funs = static_cast<AggFun**>(
+            arena_->allocateAligned(funMetas_.size() * sizeof(AggFun*), alignof(AggFun*)));
+    auto *states = static_cast<char*>(arena_->allocateAligned(statesSize_, statesAlign_));
+    for (auto i = 0u; i < funMetas_.size(); i++) {
+        group.funs[i] = funMetas_[i]->create(states + offsets_[i]);
+    }
+    groups_.emplace_back(group);
+    slots_[slot] = groups_.size();
+}
+
+
+void HashAggregator::grow() {
+    auto size = slots_.size() * 2;
+    slots_.assign(size, 0);
+    auto mask = size - 1;
+    for (auto i = 0u; i < groups_.size(); i++) {
+        auto pos = groups_[i].hash & mask;
+        while (slots_[pos] != 0) {
+            pos = (pos + 1) & mask;
+        }
+        slots_[pos] = i + 1;
+    }
+}
+
+
+Status HashAggregator::spill(uint64_t hash,
+                             const std::vector<cpp2::ColumnValue> &keys,
+                             const std::vector<cpp2::ColumnValue> &vals) {
+    if (partitions_.empty()) {
+        LOG(INFO) << "Spill the new groups at level " << level_ << ", "
+                  << groups_.size() << " groups take " << memoryUsage() << " bytes";
+        partitions_.resize(1UL << kPartitionBits);
+    }
+    auto &partition = partitions_[hash >> (64 - kPartitionBits)];
+    if (partition == nullptr) {
+        auto ret = SpillFile::create();
+        if (!ret.ok()) {
+            return ret.status();
+        }
+        partition = std::move(ret).value();
+    }
+    std::vector<cpp2::ColumnValue> row;
+    row.reserve(keys.size() + vals.size());
+    row.insert(row.end(), keys.begin(), keys.end());
+    row.insert(row.end(), vals.begin(), vals.end());
+    spilledRows_++;
+    return partition->write(row);
+}
+
+
+Status HashAggregator::finish(Output output) {
+    for (auto &group : groups_) {
+        std::vector<cpp2::ColumnValue> row;
+        row.reserve(funMetas_.size());
+        for (auto i = 0u; i < funMetas_.size(); i++) {
+            row.emplace_back(group.funs[i]->getResult());
+        }
+        output(std::move(row));
+    }
+    // Release the memory before aggregating the partitions
+    clear();
+
+    for (auto &partition : partitions_) {
+        if (partition == nullptr) {
+            continue;
+        }
+        auto status = partition->rewind();
+        if (!status.ok()) {
+            return status;
+        }
+        HashAggregator aggregator(funNames_, memoryBudget_, level_ + 1);
+        std::vector<cpp2::ColumnValue> row;
+        std::vector<cpp2::ColumnValue> keys;
+        std::vector<cpp2::ColumnValue> vals;
+        while (true) {
+            auto ret = partition->read(row);
+            if (!ret.ok()) {
+                return ret.status();
+            }
+            if (!ret.value()) {
+                break;
+            }
+            DCHECK_EQ(keysNum_ + funMetas_.size(), row.size());
+            keys.assign(std::make_move_iterator(row.begin()),
+                        std::make_move_iterator(row.begin() + keysNum_));
+            vals.assign(std::make_move_iterator(row.begin() + keysNum_),
+                        std::make_move_iterator(row.end()));
+            status = aggregator.apply(keys, vals);
+            if (!status.ok()) {
+                return status;
+            }
+        }
+        partition.reset();
+        status = aggregator.finish(output);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    partitions_.clear();
+    return Status::OK();
+}
+
+
+void HashAggregator::clear() {
+    // The functions are constructed in the arena, so they are destructed explicitly
+    for (auto &group : groups_) {
+        for (auto i = 0u; i < funMetas_.size(); i++) {
+            group.funs[i]->~AggFun();
+        }
+    }
+    groups_.clear();
+    groups_.shrink_to_fit();
+    funsMemory_ = 0;
+    slots_.assign(kMinSlots, 0);
+    slots_.shrink_to_fit();
+    arena_ = std::make_unique<Arena>();
+}
+
+}   // namespace graph
+}   // namespace nebula
@@ -0,0 +1,118 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_HASHAGGREGATOR_H_
+#define GRAPH_HASHAGGREGATOR_H_
+
+#include "base/Base.h"
+#include "base/Arena.h"
+#include "base/StatusOr.h"
+#include "graph/AggregateFunction.h"
+#include "graph/SpillFile.h"
+
+namespace nebula {
+namespace graph {
+
+/**
+ * Aggregate the rows by the hash of their group keys.
+ *
+ * The keys are encoded into bytes along with their types, and kept in an arena. They are
+ * looked up in an open addressing table with linear probing. The aggregate functions of
+ * a group are constructed together in the arena as well, so there is no allocation per
+ * group besides the ones made by the functions themselves, which are charged to the budget
+ * by the growth of their memoryUsage() on each apply.
+ *
+ * Once the groups take more memory than the budget, the rows of the new groups are spilled
+ * to the partitions on disk by the hash of their keys, while the groups in memory are still
+ * aggregated as usual. So a group is either in memory or in exactly one partition. The
+ * partitions are aggregated one by one after the groups in memory are output, each of them
+ * could be spilled again with another hash.
+ */
+class HashAggregator final {
+public:
+    using Output = std::function<void(std::vector<cpp2::ColumnValue> row)>;
+
+    // The names of the aggregate functions, each of them is applied to one of the values
+    HashAggregator(std::vector<std::string> funNames, int64_t memoryBudget, uint32_t level = 0);
+
+    ~HashAggregator();
+
+    // Apply the values of a row to the functions of its group
+    Status apply(const std::vector<cpp2::ColumnValue> &keys,
+                 std::vector<cpp2::ColumnValue> &vals);
+
+    // Output the results of the functions of each group, including the spilled ones
+    Status finish(Output output);
+
+    size_t groupsNum() const {
+        return groups_.size();
+    }
+
+    // The rows spilled to the partitions of this level
+    size_t spilledRows() const {
+        return spilledRows_;
+    }
+
+    // The bytes taken by the groups in memory, including the heap of the functions
+    size_t memoryUsage() const {
+        return arena_->allocated()
+             + slots_.capacity() * sizeof(uint32_t)
+             + groups_.capacity() * sizeof(Group)
+             + funsMemory_;
+    }
+
+private:
+    struct Group {
+        folly::StringPiece      key;
+        uint64_t                hash;
+        AggFun                **funs;
+    };
+
+    static constexpr uint32_t kPartitionBits = 4;
+    static constexpr uint32_t kMaxLevel = 3;
+    static constexpr size_t kMinSlots = 1024;
+
+    // Returns the slot of the key, which is empty if the key does not exist
+    size_t findSlot(folly::StringPiece key, uint64_t hash) const;
+
+    void addGroup(size_t slot, folly::StringPiece key, uint64_t hash);
+
+    void grow();
+
+    Status spill(uint64_t hash,
+                 const std::vector<cpp2::ColumnValue> &keys,
+                 const std::vector<cpp2::ColumnValue> &vals);
+
+    void clear();
+
+private:
+    std::vector<std::string>                    funNames_;
+    std::vector<const AggFunMeta*>              funMetas_;
+    // The offsets of the functions in the states of a group
+    std::vector<size_t>                         offsets_;
+    size_t                                      statesSize_{0};
+    size_t                                      statesAlign_{1};
+
+    const int64_t                               memoryBudget_;
+    const uint32_t                              level_;
+
+    std::unique_ptr<Arena>                      arena_;
+    std::vector<Group>                          groups_;
+    // The index of the group plus one, or zero if the slot is empty
+    std::vector<uint32_t>                       slots_;
+    std::string                                 keyBuf_;
+    // The bytes on the heap taken by the functions of all the groups, see AggFun::memoryUsage
+    size_t                                      funsMemory_{0};
+
+    size_t                                      keysNum_{0};
+    std::vector<std::unique_ptr<SpillFile>>     partitions_;
+    size_t                                      spilledRows_{0};
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_HASHAGGREGATOR_H_
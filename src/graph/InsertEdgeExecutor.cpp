@@ -156,7 +156,7 @@ StatusOr<std::vector<storage::cpp2::Edge>> InsertEdgeExecutor::prepareEdges() {
             values.emplace_back(ovalue.value());
         }
 
-        RowWriter writer(schema_);
+        RowWriter writer(schema_, spaceRowFormat());
         int64_t valuesSize = values.size();
         int32_t handleValueNum = 0;
         for (size_t schemaIndex = 0; schemaIndex < schema_->getNumFields(); schemaIndex++) {
@@ -161,7 +161,7 @@ StatusOr<std::vector<storage::cpp2::Vertex>> InsertVertexExecutor::prepareVertic
             auto schema = schemas_[index];
             auto propsPosition = propsPositions_[index];
 
-            RowWriter writer(schema);
+            RowWriter writer(schema, spaceRowFormat());
             VariantType value;
             auto schemaNumFields = schema->getNumFields();
             for (size_t schemaIndex = 0; schemaIndex < schemaNumFields; schemaIndex++) {
@@ -21,52 +21,451 @@ InterimResult::InterimResult(std::vector<std::string> &&colNames) {
     colNames_ = std::move(colNames);
 }
 
+void InterimResult::setSchema(std::shared_ptr<const meta::SchemaProviderIf> schema) {
+    data_ = std::make_shared<Data>();
+    data_->schema = std::move(schema);
+    data_->arena = std::make_shared<Arena>();
+    auto columnCnt = data_->schema->getNumFields();
+    data_->columns.resize(columnCnt);
+    for (auto i = 0u; i < columnCnt; i++) {
+        data_->columns[i].type = data_->schema->getFieldType(i).type;
+    }
+}
+
 void InterimResult::setInterim(std::unique_ptr<RowSetWriter> rsWriter) {
-    rsWriter_ = std::move(rsWriter);
-    rsReader_ = std::make_unique<RowSetReader>(rsWriter_->schema(), rsWriter_->data());
+    using nebula::cpp2::SupportedType;
+    setSchema(rsWriter->schema());
+    RowSetReader rsReader(rsWriter->schema(), rsWriter->data());
+    auto rowIter = rsReader.begin();
+    while (rowIter) {
+        for (auto i = 0u; i < data_->columns.size(); i++) {
+            auto &column = data_->columns[i];
+            auto rc = ResultType::SUCCEEDED;
+            switch (column.type) {
+                case SupportedType::VID: {
+                    int64_t v = 0;
+                    rc = rowIter->getVid(i, v);
+                    column.ints.emplace_back(v);
+                    break;
+                }
+                case SupportedType::INT:
+                case SupportedType::TIMESTAMP: {
+                    int64_t v = 0;
+                    rc = rowIter->getInt(i, v);
+                    column.ints.emplace_back(v);
+                    break;
+                }
+                case SupportedType::FLOAT: {
+                    float v = 0;
+                    rc = rowIter->getFloat(i, v);
+                    column.doubles.emplace_back(v);
+                    break;
+                }
+                case SupportedType::DOUBLE: {
+                    double v = 0;
+                    rc = rowIter->getDouble(i, v);
+                    column.doubles.emplace_back(v);
+                    break;
+                }
+                case SupportedType::BOOL: {
+                    bool v = false;
+                    rc = rowIter->getBool(i, v);
+                    column.bools.emplace_back(v);
+                    break;
+                }
+                case SupportedType::STRING: {
+                    folly::StringPiece v;
+                    rc = rowIter->getString(i, v);
+                    column.strs.emplace_back(data_->arena->copy(v));
+                    break;
+                }
+                default:
+                    LOG(ERROR) << "Unknown Type: " << static_cast<int32_t>(column.type);
+                    column.ints.emplace_back(0);
+                    break;
+            }
+            if (rc != ResultType::SUCCEEDED) {
+                LOG(ERROR) << "Get field " << i << " from interim failed: "
+                           << static_cast<int32_t>(rc);
+            }
+        }
+        data_->rowsNum++;
+        ++rowIter;
+    }
 }
 
-StatusOr<std::vector<VertexID>> InterimResult::getVIDs(const std::string &col) const {
-    if (!vids_.empty()) {
-        DCHECK(rsReader_ == nullptr);
-        return vids_;
+Status InterimResult::appendValue(Column &column, const VariantType &value) {
+    using nebula::cpp2::SupportedType;
+    // The numeric values are converted to the type of the column, as RowWriter does
+    switch (column.type) {
+        case SupportedType::VID:
+        case SupportedType::INT:
+        case SupportedType::TIMESTAMP:
+            switch (value.which()) {
+                case VAR_INT64:
+                    column.ints.emplace_back(boost::get<int64_t>(value));
+                    return Status::OK();
+                case VAR_DOUBLE:
+                    column.ints.emplace_back(static_cast<int64_t>(boost::get<double>(value)));
+                    return Status::OK();
+                case VAR_BOOL:
+                    column.ints.emplace_back(boost::get<bool>(value) ? 1 : 0);
+                    return Status::OK();
+                default:
+                    break;
+            }
+            break;
+        case SupportedType::FLOAT:
+        case SupportedType::DOUBLE:
+            switch (value.which()) {
+                case VAR_INT64:
+                    column.doubles.emplace_back(static_cast<double>(boost::get<int64_t>(value)));
+                    return Status::OK();
+                case VAR_DOUBLE:
+                    column.doubles.emplace_back(boost::get<double>(value));
+                    return Status::OK();
+                case VAR_BOOL:
+                    column.doubles.emplace_back(boost::get<bool>(value) ? 1.0 : 0.0);
+                    return Status::OK();
+                default:
+                    break;
+            }
+            break;
+        case SupportedType::BOOL:
+            if (Expression::isString(value)) {
+                break;
+            }
+            column.bools.emplace_back(Expression::asBool(value));
+            return Status::OK();
+        case SupportedType::STRING:
+            if (!Expression::isString(value)) {
+                break;
+            }
+            column.strs.emplace_back(data_->arena->copy(Expression::asString(value)));
+            return Status::OK();
+        default:
+            break;
+    }
+    return Status::Error("Value of VariantType %d could not be kept as type %d",
+                         value.which(), static_cast<int32_t>(column.type));
+}
+
+Status InterimResult::appendValue(Column &column, const cpp2::ColumnValue &value) {
+    using Type = cpp2::ColumnValue::Type;
+    VariantType v;
+    switch (value.getType()) {
+        case Type::id:
+            v = value.get_id();
+            break;
+        case Type::integer:
+            v = value.get_integer();
+            break;
+        case Type::timestamp:
+            v = value.get_timestamp();
+            break;
+        case Type::single_precision:
+            v = static_cast<double>(value.get_single_precision());
+            break;
+        case Type::double_precision:
+            v = value.get_double_precision();
+            break;
+        case Type::bool_val:
+            v = value.get_bool_val();
+            break;
+        case Type::str:
+            // Copied into the arena once
+            if (column.type != nebula::cpp2::SupportedType::STRING) {
+                return Status::Error("Value of string could not be kept as type %d",
+                                     static_cast<int32_t>(column.type));
+            }
+            column.strs.emplace_back(data_->arena->copy(value.get_str()));
+            return Status::OK();
+        default:
+            LOG(ERROR) << NotSupported << static_cast<int32_t>(value.getType());
+            return Status::Error(NotSupported);
+    }
+    return appendValue(column, v);
+}
+
+void InterimResult::popValue(Column &column) {
+    using nebula::cpp2::SupportedType;
+    switch (column.type) {
+        case SupportedType::FLOAT:
+        case SupportedType::DOUBLE:
+            column.doubles.pop_back();
+            break;
+        case SupportedType::BOOL:
+            column.bools.pop_back();
+            break;
+        case SupportedType::STRING:
+            column.strs.pop_back();
+            break;
+        default:
+            column.ints.pop_back();
+            break;
+    }
+}
+
+Status InterimResult::addRow(const std::vector<VariantType> &row) {
+    DCHECK(hasData());
+    if (row.size() != data_->columns.size()) {
+        return Status::Error("Row of %zu columns, expected %zu",
+                             row.size(), data_->columns.size());
+    }
+    for (auto i = 0u; i < row.size(); i++) {
+        auto status = appendValue(data_->columns[i], row[i]);
+        if (!status.ok()) {
+            for (auto j = 0u; j < i; j++) {
+                popValue(data_->columns[j]);
+            }
+            return status;
+        }
+    }
+    data_->rowsNum++;
+    return Status::OK();
+}
+
+Status InterimResult::addRow(const cpp2::RowValue &row) {
+    DCHECK(hasData());
+    auto &columns = row.get_columns();
+    if (columns.size() != data_->columns.size()) {
+        return Status::Error("Row of %zu columns, expected %zu",
+                             columns.size(), data_->columns.size());
+    }
+    for (auto i = 0u; i < columns.size(); i++) {
+        auto status = appendValue(data_->columns[i], columns[i]);
+        if (!status.ok()) {
+            for (auto j = 0u; j < i; j++) {
+                popValue(data_->columns[j]);
+            }
+            return status;
+        }
+    }
+    data_->rowsNum++;
+    return Status::OK();
+}
+
+void InterimResult::addRow(const InterimResult &other, size_t row) {
+    DCHECK(hasData());
+    DCHECK(other.hasData());
+    DCHECK_EQ(data_->columns.size(), other.data_->columns.size());
+    DCHECK_LT(row, other.rowsNum());
+    // Keep the strings of the other one alive, instead of copying them
+    if (other.data_ != data_) {
+        auto &arena = other.data_->arena;
+        if (std::find(data_->shared.begin(), data_->shared.end(), arena)
+                == data_->shared.end()) {
+            data_->shared.emplace_back(arena);
+            data_->shared.insert(data_->shared.end(),
+                                 other.data_->shared.begin(),
+                                 other.data_->shared.end());
+        }
+    }
+    for (auto i = 0u; i < data_->columns.size(); i++) {
+        auto &dst = data_->columns[i];
+        auto &src = other.data_->columns[i];
+        DCHECK(dst.type == src.type);
+        switch (dst.type) {
+            case nebula::cpp2::SupportedType::FLOAT:
+            case nebula::cpp2::SupportedType::DOUBLE:
+                dst.doubles.emplace_back(src.doubles[row]);
+                break;
+            case nebula::cpp2::SupportedType::BOOL:
+                dst.bools.emplace_back(src.bools[row]);
+                break;
+            case nebula::cpp2::SupportedType::STRING:
+                dst.strs.emplace_back(src.strs[row]);
+                break;
+            default:
+                dst.ints.emplace_back(src.ints[row]);
+                break;
+        }
+    }
+    data_->rowsNum++;
+}
+
+VariantType InterimResult::valueOf(const Column &column, size_t row) {
+    using nebula::cpp2::SupportedType;
+    switch (column.type) {
+        case SupportedType::FLOAT:
+        case SupportedType::DOUBLE:
+            return column.doubles[row];
+        case SupportedType::BOOL:
+            return static_cast<bool>(column.bools[row]);
+        case SupportedType::STRING:
+            return column.strs[row].str();
+        default:
+            return column.ints[row];
+    }
+}
+
+cpp2::ColumnValue::Type InterimResult::toColumnValueType(nebula::cpp2::SupportedType type) {
+    using nebula::cpp2::SupportedType;
+    switch (type) {
+        case SupportedType::VID:
+            return cpp2::ColumnValue::Type::id;
+        case SupportedType::INT:
+            return cpp2::ColumnValue::Type::integer;
+        case SupportedType::TIMESTAMP:
+            return cpp2::ColumnValue::Type::timestamp;
+        // The floats are kept as doubles
+        case SupportedType::FLOAT:
+        case SupportedType::DOUBLE:
+            return cpp2::ColumnValue::Type::double_precision;
+        case SupportedType::BOOL:
+            return cpp2::ColumnValue::Type::bool_val;
+        case SupportedType::STRING:
+            return cpp2::ColumnValue::Type::str;
+        default:
+            return cpp2::ColumnValue::Type::__EMPTY__;
+    }
+}
+
+cpp2::ColumnValue InterimResult::columnValueOf(const Column &column, size_t row) {
+    using Type = cpp2::ColumnValue::Type;
+    cpp2::ColumnValue value;
+    switch (toColumnValueType(column.type)) {
+        case Type::id:
+            value.set_id(column.ints[row]);
+            break;
+        case Type::timestamp:
+            value.set_timestamp(column.ints[row]);
+            break;
+        case Type::double_precision:
+            value.set_double_precision(column.doubles[row]);
+            break;
+        case Type::bool_val:
+            value.set_bool_val(column.bools[row]);
+            break;
+        case Type::str:
+            value.set_str(column.strs[row].str());
+            break;
+        default:
+            value.set_integer(column.ints[row]);
+            break;
     }
+    return value;
+}
+
+OptVariantType InterimResult::getColumn(size_t row, const std::string &col) const {
     if (!hasData()) {
         return Status::Error("Interim has no data.");
     }
-    std::vector<VertexID> result;
-    auto iter = rsReader_->begin();
-    while (iter) {
-        VertexID vid;
-        auto rc = iter->getVid(col, vid);
-        if (rc != ResultType::SUCCEEDED) {
-            return Status::Error("Column `%s' not found", col.c_str());
+    auto index = data_->schema->getFieldIndex(col);
+    if (index < 0) {
+        return Status::Error("Column `%s' not found", col.c_str());
+    }
+    return getColumn(row, static_cast<size_t>(index));
+}
+
+int InterimResult::compare(size_t col, size_t lhs, size_t rhs) const {
+    auto &column = data_->columns[col];
+    switch (column.type) {
+        case nebula::cpp2::SupportedType::FLOAT:
+        case nebula::cpp2::SupportedType::DOUBLE: {
+            auto l = column.doubles[lhs];
+            auto r = column.doubles[rhs];
+            return l < r ? -1 : (r < l ? 1 : 0);
+        }
+        case nebula::cpp2::SupportedType::BOOL:
+            return static_cast<int>(column.bools[lhs]) - static_cast<int>(column.bools[rhs]);
+        case nebula::cpp2::SupportedType::STRING:
+            return column.strs[lhs].compare(column.strs[rhs]);
+        default: {
+            auto l = column.ints[lhs];
+            auto r = column.ints[rhs];
+            return l < r ? -1 : (r < l ? 1 : 0);
         }
-        result.emplace_back(vid);
-        ++iter;
     }
-    return result;
 }
 
-StatusOr<std::vector<VertexID>> InterimResult::getDistinctVIDs(const std::string &col) const {
+namespace {
+
+void appendBigEndian(uint64_t v, std::string &key) {
+    for (auto shift = 56; shift >= 0; shift -= 8) {
+        key.push_back(static_cast<char>((v >> shift) & 0xFF));
+    }
+}
+
+}   // namespace
+
+void InterimResult::encodeSortKey(size_t col,
+                                  size_t row,
+                                  bool descend,
+                                  std::string &key) const {
+    static constexpr uint64_t kSignBit = 1UL << 63;
+    auto &column = data_->columns[col];
+    auto begin = key.size();
+    switch (column.type) {
+        case nebula::cpp2::SupportedType::FLOAT:
+        case nebula::cpp2::SupportedType::DOUBLE: {
+            // Flip all the bits of the negative numbers, and the sign bit of the others
+            auto v = column.doubles[row];
+            uint64_t bits = 0;
+            memcpy(&bits, &v, sizeof(bits));
+            bits = v == 0.0 ? kSignBit : ((bits & kSignBit) ? ~bits : (bits | kSignBit));
+            appendBigEndian(bits, key);
+            break;
+        }
+        case nebula::cpp2::SupportedType::BOOL:
+            key.push_back(column.bools[row] ? 1 : 0);
+            break;
+        case nebula::cpp2::SupportedType::STRING: {
+            // Escape '\0' as "\0\xff" and end with "\0\0", so a string is before the ones
+            // it is a prefix of, no matter what follows it in the key
+            for (auto c : column.strs[row]) {
+                key.push_back(c);
+                if (c == '\0') {
+                    key.push_back('\xff');
+                }
+            }
+            key.append(2, '\0');
+            break;
+        }
+        default:
+            appendBigEndian(static_cast<uint64_t>(column.ints[row]) ^ kSignBit, key);
+            break;
+    }
+    if (descend) {
+        for (auto i = begin; i < key.size(); i++) {
+            key[i] = ~key[i];
+        }
+    }
+}
+
+StatusOr<std::vector<VertexID>> InterimResult::getVIDs(const std::string &col) const {
     if (!vids_.empty()) {
-        DCHECK(rsReader_ == nullptr);
+        DCHECK(data_ == nullptr);
         return vids_;
     }
     if (!hasData()) {
         return Status::Error("Interim has no data.");
     }
-    std::unordered_set<VertexID> uniq;
-    auto iter = rsReader_->begin();
-    while (iter) {
-        VertexID vid;
-        auto rc = iter->getVid(col, vid);
-        if (rc != ResultType::SUCCEEDED) {
-            return Status::Error("Column `%s' not found", col.c_str());
-        }
-        uniq.emplace(vid);
-        ++iter;
+    using nebula::cpp2::SupportedType;
+    auto index = data_->schema->getFieldIndex(col);
+    if (index < 0) {
+        return Status::Error("Column `%s' not found", col.c_str());
+    }
+    // The integers are taken as the ids as well, e.g. the ranks piped in
+    auto type = data_->columns[index].type;
+    if (type != SupportedType::VID
+            && type != SupportedType::INT
+            && type != SupportedType::TIMESTAMP) {
+        return Status::Error("Column `%s' is not of the ids", col.c_str());
+    }
+    return data_->columns[index].ints;
+}
+
+StatusOr<std::vector<VertexID>> InterimResult::getDistinctVIDs(const std::string &col) const {
+    if (!vids_.empty()) {
+        DCHECK(data_ == nullptr);
+        return vids_;
     }
+    auto vids = getVIDs(col);
+    if (!vids.ok()) {
+        return vids;
+    }
+    std::unordered_set<VertexID> uniq(vids.value().begin(), vids.value().end());
     std::vector<VertexID> result(uniq.begin(), uniq.end());
     return result;
 }
@@ -75,101 +474,24 @@ StatusOr<std::vector<cpp2::RowValue>> InterimResult::getRows() const {
     if (!hasData()) {
         return Status::Error("Interim has no data.");
     }
-    auto schema = rsReader_->schema();
-    auto columnCnt = schema->getNumFields();
-    VLOG(1) << "columnCnt: " << columnCnt;
+    for (auto &column : data_->columns) {
+        if (toColumnValueType(column.type) == cpp2::ColumnValue::Type::__EMPTY__) {
+            std::string err =
+                folly::sformat("Unknown Type: {}", static_cast<int32_t>(column.type));
+            LOG(ERROR) << err;
+            return Status::Error(err);
+        }
+    }
     std::vector<cpp2::RowValue> rows;
-    folly::StringPiece piece;
-    using nebula::cpp2::SupportedType;
-    auto rowIter = rsReader_->begin();
-    while (rowIter) {
+    rows.reserve(data_->rowsNum);
+    for (auto i = 0u; i < data_->rowsNum; i++) {
         std::vector<cpp2::ColumnValue> row;
-        row.reserve(columnCnt);
-        auto fieldIter = schema->begin();
-        int64_t cnt = 0;
-        while (fieldIter) {
-            ++cnt;
-            auto type = fieldIter->getType().type;
-            auto field = fieldIter->getName();
-            VLOG(1) << "field: " << field << " type: " << static_cast<int64_t>(type);
-            row.emplace_back();
-            switch (type) {
-                case SupportedType::VID: {
-                    int64_t v;
-                    auto rc = rowIter->getVid(field, v);
-                    if (rc != ResultType::SUCCEEDED) {
-                        return Status::Error(
-                                "Get vid from interim failed, field: %s, index: %ld.",
-                                field, cnt);
-                    }
-                    row.back().set_id(v);
-                    break;
-                }
-                case SupportedType::DOUBLE: {
-                    double v;
-                    auto rc = rowIter->getDouble(field, v);
-                    if (rc != ResultType::SUCCEEDED) {
-                        return Status::Error(
-                                "Get double from interim failed, field: %s, index: %ld.",
-                                field, cnt);
-                    }
-                    row.back().set_double_precision(v);
-                    break;
-                }
-                case SupportedType::BOOL: {
-                    bool v;
-                    auto rc = rowIter->getBool(field, v);
-                    if (rc != ResultType::SUCCEEDED) {
-                        return Status::Error(
-                                "Get bool from interim failed, field: %s, index: %ld.",
-                                field, cnt);
-                    }
-                    row.back().set_bool_val(v);
-                    break;
-                }
-                case SupportedType::STRING: {
-                    auto rc = rowIter->getString(field, piece);
-                    if (rc != ResultType::SUCCEEDED) {
-                        return Status::Error(
-                                "Get string from interim failed, field: %s, index: %ld.",
-                                field, cnt);
-                    }
-                    row.back().set_str(piece.toString());
-                    break;
-                }
-                case SupportedType::INT: {
-                    int64_t v;
-                    auto rc = rowIter->getInt(field, v);
-                    if (rc != ResultType::SUCCEEDED) {
-                        return Status::Error(
-                                "Get int from interim failed, field: %s, index: %ld.",
-                                field, cnt);
-                    }
-                    row.back().set_integer(v);
-                    break;
-                }
-                case SupportedType::TIMESTAMP: {
-                    int64_t v;
-                    auto rc = rowIter->getInt(field, v);
-                    if (rc != ResultType::SUCCEEDED) {
-                        return Status::Error(
-                                "Get timestamp from interim failed, field: %s, index: %ld.",
-                                field, cnt);
-                    }
-                    row.back().set_timestamp(v);
-                    break;
-                }
-                default:
-                    std::string err =
-                        folly::sformat("Unknown Type: %d", static_cast<int32_t>(type));
-                    LOG(ERROR) << err;
-                    return Status::Error(err);
-            }
-            ++fieldIter;
+        row.reserve(data_->columns.size());
+        for (auto &column : data_->columns) {
+            row.emplace_back(columnValueOf(column, i));
         }
         rows.emplace_back();
         rows.back().set_columns(std::move(row));
-        ++rowIter;
     }
     return rows;
 }
@@ -177,16 +499,14 @@ StatusOr<std::vector<cpp2::RowValue>> InterimResult::getRows() const {
 StatusOr<std::unique_ptr<InterimResult::InterimResultIndex>>
 InterimResult::buildIndex(const std::string &vidColumn) const {
     using nebula::cpp2::SupportedType;
-    std::unique_ptr<InterimResultIndex> index;
-
     if (!hasData()) {
         return Status::Error("Interim has no data.");
     }
-    auto schema = rsReader_->schema();
+    auto schema = data_->schema;
     auto columnCnt = schema->getNumFields();
-    uint32_t vidIndex = 0u;
+    int32_t vidIndex = -1;
 
-    index = std::make_unique<InterimResultIndex>();
+    auto index = std::make_unique<InterimResultIndex>();
     for (auto i = 0u; i < columnCnt; i++) {
         auto name = schema->getFieldName(i);
         if (vidColumn == name) {
@@ -201,75 +521,17 @@ InterimResult::buildIndex(const std::string &vidColumn) const {
         }
         index->columnToIndex_[name] = i;
     }
+    if (vidIndex < 0) {
+        return Status::Error("Column `%s' not found", vidColumn.c_str());
+    }
 
-    auto rowIter = rsReader_->begin();
-    auto rowIndex = 0u;
-    while (rowIter) {
-        Row row;
-        row.reserve(columnCnt);
-        for (auto i = 0u; i < columnCnt; i++) {
-            auto type = schema->getFieldType(i).type;
-            switch (type) {
-                case SupportedType::VID: {
-                    int64_t v;
-                    auto rc = rowIter->getVid(i, v);
-                    if (rc != ResultType::SUCCEEDED) {
-                        return Status::Error("Get vid from interim failed.");
-                    }
-                    if (i == vidIndex) {
-                        index->vidToRowIndex_[v] = rowIndex++;
-                    }
-                    row.emplace_back(v);
-                    break;
-                }
-                case SupportedType::DOUBLE: {
-                    double v;
-                    auto rc = rowIter->getDouble(i, v);
-                    if (rc != ResultType::SUCCEEDED) {
-                        return Status::Error("Get double from interim failed.");
-                    }
-                    row.emplace_back(v);
-                    break;
-                }
-                case SupportedType::BOOL: {
-                    bool v;
-                    auto rc = rowIter->getBool(i, v);
-                    if (rc != ResultType::SUCCEEDED) {
-                        return Status::Error("Get bool from interim failed.");
-                    }
-                    row.emplace_back(v);
-                    break;
-                }
-                case SupportedType::STRING: {
-                    folly::StringPiece piece;
-                    auto rc = rowIter->getString(i, piece);
-                    if (rc != ResultType::SUCCEEDED) {
-                        return Status::Error("Get string from interim failed.");
-                    }
-                    row.emplace_back(piece.toString());
-                    break;
-                }
-                case SupportedType::INT:
-                case SupportedType::TIMESTAMP: {
-                    int64_t v;
-                    auto rc = rowIter->getInt(i, v);
-                    if (rc != ResultType::SUCCEEDED) {
-                        return Status::Error("Get int from interim failed.");
-                    }
-                    row.emplace_back(v);
-                    break;
-                }
-                default:
-                    std::string err =
-                        folly::sformat("Unknown Type: %d", static_cast<int32_t>(type));
-                    LOG(ERROR) << err;
-                    return Status::Error(err);
-            }
-        }
-        index->rows_.emplace_back(std::move(row));
-        ++rowIter;
+    auto &vids = data_->columns[vidIndex].ints;
+    index->vidToRowIndex_.reserve(vids.size());
+    for (auto i = 0u; i < vids.size(); i++) {
+        index->vidToRowIndex_[vids[i]] = i;
     }
-    index->schema_ = schema;
+    // The rows are shared with the index rather than copied
+    index->data_ = data_;
     return index;
 }
 
@@ -291,17 +553,26 @@ OptVariantType InterimResult::InterimResultIndex::getColumnWithVID(VertexID id,
         }
         columnIndex = iter->second;
     }
-    return rows_[rowIndex][columnIndex];
+    return valueOf(data_->columns[columnIndex], rowIndex);
+}
+
+
+nebula::cpp2::SupportedType InterimResult::InterimResultIndex::getColumnType(
+    const std::string &col) const {
+    auto iter = columnToIndex_.find(col);
+    if (iter == columnToIndex_.end()) {
+        return nebula::cpp2::SupportedType::UNKNOWN;
+    }
+    return data_->columns[iter->second].type;
 }
 
 
 nebula::cpp2::SupportedType InterimResult::getColumnType(
     const std::string &col) const {
-    auto schema = rsReader_->schema();
-    if (schema == nullptr) {
+    if (!hasData()) {
         return nebula::cpp2::SupportedType::UNKNOWN;
     }
-    auto type = schema->getFieldType(col);
+    auto type = data_->schema->getFieldType(col);
     return type.type;
 }
 
@@ -558,38 +829,6 @@ StatusOr<std::unique_ptr<InterimResult>>
 InterimResult::getInterim(
             std::shared_ptr<const meta::SchemaProviderIf> resultSchema,
             std::vector<cpp2::RowValue> &rows) {
-    auto rsWriter = std::make_unique<RowSetWriter>(resultSchema);
-    for (auto &r : rows) {
-        RowWriter writer(resultSchema);
-        auto &cols = r.get_columns();
-        for (auto &col : cols) {
-            switch (col.getType()) {
-                case cpp2::ColumnValue::Type::id:
-                    writer << col.get_id();
-                    break;
-                case cpp2::ColumnValue::Type::integer:
-                    writer << col.get_integer();
-                    break;
-                case cpp2::ColumnValue::Type::double_precision:
-                    writer << col.get_double_precision();
-                    break;
-                case cpp2::ColumnValue::Type::bool_val:
-                    writer << col.get_bool_val();
-                    break;
-                case cpp2::ColumnValue::Type::str:
-                    writer << col.get_str();
-                    break;
-                case cpp2::ColumnValue::Type::timestamp:
-                    writer << col.get_timestamp();
-                    break;
-                default:
-                    LOG(ERROR) << NotSupported << static_cast<int32_t>(col.getType());
-                    return Status::Error(NotSupported);
-            }
-        }
-        rsWriter->addRow(writer);
-    }
-
     std::vector<std::string> colNames;
     auto iter = resultSchema->begin();
     while (iter) {
@@ -597,63 +836,15 @@ InterimResult::getInterim(
         ++iter;
     }
     auto result = std::make_unique<InterimResult>(std::move(colNames));
-    result->setInterim(std::move(rsWriter));
-    return result;
-}
-
-Status InterimResult::applyTo(std::function<Status(const RowReader *reader)> visitor,
-                              int64_t limit) const {
-    auto status = Status::OK();
-    auto iter = rsReader_->begin();
-    while (iter && (limit > 0)) {
-        status = visitor(&*iter);
+    result->setSchema(std::move(resultSchema));
+    for (auto &r : rows) {
+        auto status = result->addRow(r);
         if (!status.ok()) {
-            break;
+            return status;
         }
-        --limit;
-        ++iter;
     }
-    return status;
+    return result;
 }
 
-Status InterimResult::getResultWriter(const std::vector<cpp2::RowValue> &rows,
-                                      RowSetWriter *rsWriter) {
-    if (rsWriter == nullptr) {
-        return Status::Error("rsWriter is nullptr");
-    }
-    using Type = cpp2::ColumnValue::Type;
-    for (auto &row : rows) {
-        RowWriter writer(rsWriter->schema());
-        auto columns = row.get_columns();
-        for (auto &column : columns) {
-            switch (column.getType()) {
-                case Type::id:
-                    writer << column.get_id();
-                    break;
-                case Type::integer:
-                    writer << column.get_integer();
-                    break;
-                case Type::double_precision:
-                    writer << column.get_double_precision();
-                    break;
-                case Type::bool_val:
-                    writer << column.get_bool_val();
-                    break;
-                case Type::str:
-                    writer << column.get_str();
-                    break;
-                case Type::timestamp:
-                    writer << column.get_timestamp();
-                    break;
-                default:
-                    LOG(ERROR) << "Not Support: " << column.getType();
-                    return Status::Error("Not Support: %d", column.getType());
-            }
-        }
-        rsWriter->addRow(writer);
-    }
-
-    return Status::OK();
-}
 }   // namespace graph
 }   // namespace nebula
@@ -9,6 +9,7 @@
 
 #include "base/Base.h"
 #include "base/StatusOr.h"
+#include "base/Arena.h"
 #include "filter/Expressions.h"
 #include "dataman/RowSetReader.h"
 #include "dataman/RowSetWriter.h"
@@ -18,6 +19,12 @@ namespace nebula {
 namespace graph {
 /**
  * The intermediate form of execution result, used in pipeline and variable.
+ *
+ * The rows are kept by columns, each in a vector of its type, and the strings are kept in
+ * an arena. A result built from the rows of another one, e.g. the sorted or limited ones,
+ * copies only the fixed-size values and shares the arena of the source. So the executors
+ * in a pipeline read and write the values directly, without encoding them into rows and
+ * decoding them back at every stage.
  */
 class InterimResult final {
 public:
@@ -43,24 +50,37 @@ public:
     static Status castToBool(cpp2::ColumnValue *col);
     static Status castToStr(cpp2::ColumnValue *col);
 
-    static Status getResultWriter(const std::vector<cpp2::RowValue> &rows,
-                                  RowSetWriter *rsWriter);
-
     void setColNames(std::vector<std::string> &&colNames) {
         colNames_ = std::move(colNames);
     }
 
+    // Decode the encoded rows into the columns
     void setInterim(std::unique_ptr<RowSetWriter> rsWriter);
 
+    // Start a result of the schema without any rows, the rows are appended by addRow()
+    void setSchema(std::shared_ptr<const meta::SchemaProviderIf> schema);
+
+    // Append a row, the values are converted to the types of the columns
+    Status addRow(const std::vector<VariantType> &row);
+
+    Status addRow(const cpp2::RowValue &row);
+
+    // Append the row of another result with the same schema, sharing its strings
+    void addRow(const InterimResult &other, size_t row);
+
     bool hasData() const {
-        return (rsWriter_ != nullptr) && (rsReader_ != nullptr);
+        return data_ != nullptr;
     }
 
     std::shared_ptr<const meta::SchemaProviderIf> schema() const {
         if (!hasData()) {
             return nullptr;
         }
-        return rsReader_->schema();
+        return data_->schema;
+    }
+
+    size_t rowsNum() const {
+        return hasData() ? data_->rowsNum : 0;
     }
 
     std::vector<std::string> getColNames() const {
@@ -73,15 +93,66 @@ public:
 
     StatusOr<std::vector<cpp2::RowValue>> getRows() const;
 
+    // The value of the column in the row
+    VariantType getColumn(size_t row, size_t col) const {
+        return valueOf(data_->columns[col], row);
+    }
+
+    OptVariantType getColumn(size_t row, const std::string &col) const;
+
+    // Compare the values of the column in two rows, returns <0, 0 or >0
+    int compare(size_t col, size_t lhs, size_t rhs) const;
+
+    /**
+     * Append the value of the column in the row to the sort key. The keys of the rows are
+     * ordered as their values when compared byte by byte, and the bytes are inverted for
+     * the descending order. So the keys of multiple columns are compared without looking
+     * at the types.
+     */
+    void encodeSortKey(size_t col, size_t row, bool descend, std::string &key) const;
+
     class InterimResultIndex;
     StatusOr<std::unique_ptr<InterimResultIndex>>
     buildIndex(const std::string &vidColumn) const;
 
-    Status applyTo(std::function<Status(const RowReader *reader)> visitor,
-                   int64_t limit = INT64_MAX) const;
-
     nebula::cpp2::SupportedType getColumnType(const std::string &col) const;
 
+    // The type of the cpp2 values of a column, __EMPTY__ if not supported
+    static cpp2::ColumnValue::Type toColumnValueType(nebula::cpp2::SupportedType type);
+
+private:
+    struct Column {
+        nebula::cpp2::SupportedType             type;
+        // VID, INT and TIMESTAMP
+        std::vector<int64_t>                    ints;
+        // DOUBLE and FLOAT
+        std::vector<double>                     doubles;
+        std::vector<bool>                       bools;
+        // Refer to the strings in the arena, which never move
+        std::vector<folly::StringPiece>         strs;
+    };
+
+    struct Data {
+        std::shared_ptr<const meta::SchemaProviderIf>       schema;
+        std::vector<Column>                                 columns;
+        size_t                                              rowsNum{0};
+        // The arena of the strings appended, and the ones shared from other results
+        std::shared_ptr<Arena>                              arena;
+        std::vector<std::shared_ptr<Arena>>                 shared;
+    };
+
+    static VariantType valueOf(const Column &column, size_t row);
+
+    static cpp2::ColumnValue columnValueOf(const Column &column, size_t row);
+
+    Status appendValue(Column &column, const VariantType &value);
+
+    Status appendValue(Column &column, const cpp2::ColumnValue &value);
+
+    // Drop the last value of the column, when a row fails to be appended as a whole
+    static void popValue(Column &column);
+
+public:
     class InterimResultIndex final {
     public:
         OptVariantType getColumnWithVID(VertexID id, const std::string &col) const;
@@ -89,19 +160,15 @@ public:
 
     private:
         friend class InterimResult;
-        using Row = std::vector<VariantType>;
-        std::vector<Row>                            rows_;
-        using SchemaPtr = std::shared_ptr<const meta::SchemaProviderIf>;
-        SchemaPtr                                   schema_{nullptr};
+        // Refers to the columns of the result, which are never changed once indexed
+        std::shared_ptr<const Data>                 data_;
         std::unordered_map<std::string, uint32_t>   columnToIndex_;
         std::unordered_map<VertexID, uint32_t>      vidToRowIndex_;
     };
 
 private:
-    using Row = std::vector<VariantType>;
     std::vector<std::string>                    colNames_;
-    std::unique_ptr<RowSetReader>               rsReader_;
-    std::unique_ptr<RowSetWriter>               rsWriter_;
+    std::shared_ptr<Data>                       data_;
     std::vector<VertexID>                       vids_;
 };
 
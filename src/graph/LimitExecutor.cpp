@@ -43,32 +43,19 @@ void LimitExecutor::execute() {
         return;
     }
 
-    auto ret = inputs_->getRows();
+    auto total = inputs_->rowsNum();
+    begin_ = std::min(static_cast<size_t>(offset_), total);
+    end_ = std::min(static_cast<size_t>(offset_ + count_), total);
+
+    auto ret = setupInterimResult();
     if (!ret.ok()) {
-        LOG(ERROR) << "Get rows failed: " << ret.status();
         doError(std::move(ret).status());
         return;
     }
-    auto inRows = std::move(ret).value();
-    if (inRows.size() > static_cast<uint64_t>(offset_ + count_)) {
-        rows_.resize(count_);
-        rows_.assign(std::make_move_iterator(inRows.begin()) + offset_,
-                     std::make_move_iterator(inRows.begin()) + offset_ + count_);
-    } else if (inRows.size() > static_cast<uint64_t>(offset_) &&
-                   inRows.size() <= static_cast<uint64_t>(offset_ + count_)) {
-        rows_.resize(inRows.size() - offset_);
-        rows_.assign(std::make_move_iterator(inRows.begin()) + offset_,
-                     std::make_move_iterator(inRows.end()));
-    }
-
     if (onResult_) {
-        auto status = setupInterimResult();
-        if (!status.ok()) {
-            DCHECK(onError_);
-            onError_(std::move(status).status());
-            return;
-        }
-        onResult_(std::move(status).value());
+        onResult_(std::move(ret).value());
+    } else {
+        result_ = std::move(ret).value();
     }
 
     doFinish(Executor::ProcessControl::kNext);
@@ -77,45 +64,14 @@ void LimitExecutor::execute() {
 
 StatusOr<std::unique_ptr<InterimResult>> LimitExecutor::setupInterimResult() {
     auto result = std::make_unique<InterimResult>(std::move(colNames_));
-    if (rows_.empty()) {
+    if (begin_ >= end_) {
         return result;
     }
 
-    auto rsWriter = std::make_unique<RowSetWriter>(inputs_->schema());
-    using Type = cpp2::ColumnValue::Type;
-    for (auto &row : rows_) {
-        RowWriter writer(inputs_->schema());
-        auto columns = row.get_columns();
-        for (auto &column : columns) {
-            switch (column.getType()) {
-                case cpp2::ColumnValue::Type::id:
-                    writer << column.get_id();
-                    break;
-                case Type::integer:
-                    writer << column.get_integer();
-                    break;
-                case Type::double_precision:
-                    writer << column.get_double_precision();
-                    break;
-                case Type::bool_val:
-                    writer << column.get_bool_val();
-                    break;
-                case Type::str:
-                    writer << column.get_str();
-                    break;
-                case cpp2::ColumnValue::Type::timestamp:
-                    writer << column.get_timestamp();
-                    break;
-                default:
-                    LOG(ERROR) << "Not Support type: " << column.getType();
-                    return Status::Error("Not Support type: %d", column.getType());
-            }
-        }
-        rsWriter->addRow(writer);
-    }
-
-    if (rsWriter != nullptr) {
-        result->setInterim(std::move(rsWriter));
+    // Only the fixed-size values are copied, the strings are shared with the inputs
+    result->setSchema(inputs_->schema());
+    for (auto i = begin_; i < end_; i++) {
+        result->addRow(*inputs_, i);
     }
     return result;
 }
@@ -131,12 +87,21 @@ void LimitExecutor::onEmptyInputs() {
 
 
 void LimitExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
-    resp.set_column_names(std::move(colNames_));
+    if (result_ == nullptr) {
+        resp.set_column_names(std::move(colNames_));
+        return;
+    }
+    resp.set_column_names(result_->getColNames());
 
-    if (rows_.empty()) {
+    if (!result_->hasData()) {
+        return;
+    }
+    auto ret = result_->getRows();
+    if (!ret.ok()) {
+        LOG(ERROR) << "Get rows failed: " << ret.status();
         return;
     }
-    resp.set_rows(std::move(rows_));
+    resp.set_rows(std::move(ret).value());
 }
 }   // namespace graph
 }   // namespace nebula
@@ -35,7 +35,10 @@ private:
 private:
     LimitSentence                                            *sentence_{nullptr};
     std::vector<std::string>                                  colNames_;
-    std::vector<cpp2::RowValue>                               rows_;
+    // The range of the input rows taken
+    size_t                                                    begin_{0};
+    size_t                                                    end_{0};
+    std::unique_ptr<InterimResult>                            result_;
     int64_t                                                   offset_{-1};
     int64_t                                                   count_{-1};
 };
@@ -6,6 +6,8 @@
 
 #include "base/Base.h"
 #include "graph/OrderByExecutor.h"
+#include "graph/GraphFlags.h"
+#include "graph/Sorter.h"
 
 namespace nebula {
 namespace graph {
@@ -86,36 +88,25 @@ void OrderByExecutor::execute() {
         return;
     }
 
-    auto comparator = [this] (cpp2::RowValue& lhs, cpp2::RowValue& rhs) {
-        const auto &lhsColumns = lhs.get_columns();
-        const auto &rhsColumns = rhs.get_columns();
-        for (auto &factor : this->sortFactors_) {
-            auto fieldIndex = factor.first;
-            auto orderType = factor.second;
-            if (lhsColumns[fieldIndex] == rhsColumns[fieldIndex]) {
-                continue;
-            }
-
-            if (orderType == OrderFactor::OrderType::ASCEND) {
-                return lhsColumns[fieldIndex] < rhsColumns[fieldIndex];
-            } else if (orderType == OrderFactor::OrderType::DESCEND) {
-                return lhsColumns[fieldIndex] > rhsColumns[fieldIndex];
-            }
+    if (!sortFactors_.empty() && !indices_.empty()) {
+        status = sort();
+        if (!status.ok()) {
+            doError(std::move(status));
+            return;
         }
-        return false;
-    };
-
-    if (!sortFactors_.empty()) {
-        std::sort(rows_.begin(), rows_.end(), comparator);
+    } else if (limit_ >= 0 && static_cast<int64_t>(indices_.size()) > limit_) {
+        indices_.resize(limit_);
     }
 
+    auto ret = setupInterimResult();
+    if (!ret.ok()) {
+        doError(std::move(ret).status());
+        return;
+    }
     if (onResult_) {
-        auto ret = setupInterimResult();
-        if (!ret.ok()) {
-            onError_(std::move(ret).status());
-            return;
-        }
         onResult_(std::move(ret).value());
+    } else {
+        result_ = std::move(ret).value();
     }
     doFinish(Executor::ProcessControl::kNext);
 }
@@ -134,13 +125,10 @@ Status OrderByExecutor::beforeExecute() {
         return Status::OK();
     }
 
-    auto ret = inputs_->getRows();
-    if (!ret.ok()) {
-        LOG(ERROR) << "Get rows failed: " << ret.status();
-        doError(ret.status());
-        return std::move(ret).status();
+    indices_.resize(inputs_->rowsNum());
+    for (auto i = 0u; i < indices_.size(); i++) {
+        indices_[i] = i;
     }
-    rows_ = std::move(ret).value();
     auto schema = inputs_->schema();
     auto factors = sentence_->factors();
     sortFactors_.reserve(factors.size());
@@ -162,57 +150,65 @@ Status OrderByExecutor::beforeExecute() {
     return Status::OK();
 }
 
+Status OrderByExecutor::sort() {
+    // The top-K rows are kept in a heap, unless all of the rows are output
+    auto limit = limit_;
+    if (limit >= static_cast<int64_t>(indices_.size())) {
+        limit = -1;
+    }
+    Sorter sorter(FLAGS_order_by_memory_budget, limit);
+    // The values of the sort factors are encoded into a key for each row, so the rows are
+    // compared by the keys without looking at the types of the columns
+    std::string key;
+    for (auto index : indices_) {
+        key.clear();
+        for (auto &factor : sortFactors_) {
+            inputs_->encodeSortKey(factor.first,
+                                   index,
+                                   factor.second == OrderFactor::OrderType::DESCEND,
+                                   key);
+        }
+        auto status = sorter.add(key, index);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+
+    indices_.clear();
+    return sorter.finish([this] (uint32_t row) {
+        indices_.emplace_back(row);
+    });
+}
+
 StatusOr<std::unique_ptr<InterimResult>> OrderByExecutor::setupInterimResult() {
     auto result = std::make_unique<InterimResult>(std::move(colNames_));
-    if (rows_.empty()) {
+    if (indices_.empty()) {
         return result;
     }
 
-    auto schema = inputs_->schema();
-    auto rsWriter = std::make_unique<RowSetWriter>(schema);
-    using Type = cpp2::ColumnValue::Type;
-    for (auto &row : rows_) {
-        RowWriter writer(schema);
-        auto columns = row.get_columns();
-        for (auto &column : columns) {
-            switch (column.getType()) {
-                case Type::id:
-                    writer << column.get_id();
-                    break;
-                case Type::integer:
-                    writer << column.get_integer();
-                    break;
-                case Type::double_precision:
-                    writer << column.get_double_precision();
-                    break;
-                case Type::bool_val:
-                    writer << column.get_bool_val();
-                    break;
-                case Type::str:
-                    writer << column.get_str();
-                    break;
-                case Type::timestamp:
-                    writer << column.get_timestamp();
-                    break;
-                default:
-                    LOG(ERROR) << "Not Support type: " << column.getType();
-                    return Status::Error("Not Support type: %d", column.getType());
-            }
-        }
-        rsWriter->addRow(writer);
-    }
-
-    result->setInterim(std::move(rsWriter));
+    // The sorted rows share the strings with the inputs
+    result->setSchema(inputs_->schema());
+    for (auto index : indices_) {
+        result->addRow(*inputs_, index);
+    }
     return result;
 }
 
 void OrderByExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
-    resp.set_column_names(std::move(colNames_));
+    if (result_ == nullptr) {
+        return;
+    }
+    resp.set_column_names(result_->getColNames());
 
-    if (rows_.empty()) {
+    if (!result_->hasData()) {
+        return;
+    }
+    auto ret = result_->getRows();
+    if (!ret.ok()) {
+        LOG(ERROR) << "Get rows failed: " << ret.status();
         return;
     }
-    resp.set_rows(std::move(rows_));
+    resp.set_rows(std::move(ret).value());
 }
 
 }  // namespace graph
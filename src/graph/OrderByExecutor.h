@@ -27,16 +27,26 @@ public:
 
     void setupResponse(cpp2::ExecutionResponse &resp) override;
 
+    // Only the first `limit' rows are sorted and output
+    void setOutputLimit(int64_t limit) override {
+        limit_ = limit;
+    }
+
 private:
     StatusOr<std::unique_ptr<InterimResult>> setupInterimResult();
 
     Status beforeExecute();
 
+    Status sort();
+
 private:
     OrderBySentence                                            *sentence_{nullptr};
     std::vector<std::string>                                    colNames_;
-    std::vector<cpp2::RowValue>                                 rows_;
+    // The indices of the input rows in order
+    std::vector<uint32_t>                                       indices_;
+    std::unique_ptr<InterimResult>                              result_;
     std::vector<std::pair<int64_t, OrderFactor::OrderType>>     sortFactors_;
+    int64_t                                                     limit_{-1};
 };
 }  // namespace graph
 }  // namespace nebula
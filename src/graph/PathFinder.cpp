@@ -0,0 +1,296 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/PathFinder.h"
+
+namespace nebula {
+namespace graph {
+
+constexpr uint32_t PathFinder::kNone;
+
+uint32_t PathFinder::Side::find(VertexID vid, uint32_t origin) const {
+    auto iter = vids.find(vid);
+    if (iter == vids.end()) {
+        return kNone;
+    }
+    for (auto node = iter->second; node != kNone; node = nodes[node].sameVid) {
+        if (nodes[node].origin == origin) {
+            return node;
+        }
+    }
+    return kNone;
+}
+
+
+uint32_t PathFinder::Side::add(VertexID vid, uint32_t origin, uint32_t depth) {
+    Node node;
+    node.vid = vid;
+    node.origin = origin;
+    node.depth = depth;
+    auto index = static_cast<uint32_t>(nodes.size());
+    auto iter = vids.find(vid);
+    if (iter != vids.end()) {
+        node.sameVid = iter->second;
+        iter->second = index;
+    } else {
+        vids.emplace(vid, index);
+    }
+    nodes.emplace_back(node);
+    return index;
+}
+
+
+void PathFinder::Side::addParent(uint32_t node,
+                                 uint32_t parent,
+                                 EdgeType type,
+                                 EdgeRanking rank) {
+    parents.emplace_back(Parent{parent, type, rank, nodes[node].parents});
+    nodes[node].parents = parents.size() - 1;
+}
+
+
+PathFinder::PathFinder(const std::vector<VertexID> &from,
+                       const std::vector<VertexID> &to,
+                       uint32_t steps,
+                       bool shortest)
+    : steps_(steps), shortest_(shortest) {
+    for (auto vid : from) {
+        if (from_.vids.count(vid) == 0) {
+            from_.add(vid, 0, 0);
+        }
+    }
+    uint32_t targets = 0;
+    for (auto vid : to) {
+        if (to_.vids.count(vid) == 0) {
+            to_.add(vid, shortest_ ? targets++ : 0, 0);
+        }
+    }
+    if (shortest_) {
+        lengths_.assign(targets, kNone);
+        meetings_.resize(targets);
+        found_.assign(targets, false);
+    }
+}
+
+
+bool PathFinder::isExpanding(const Side &side, const Node &node) const {
+    return !shortest_ || &side == &from_ || !found_[node.origin];
+}
+
+
+bool PathFinder::isLoop(const Side &side, const Node &node) const {
+    if (node.depth != 0) {
+        return false;
+    }
+    auto isFrom = &side == &from_;
+    auto &other = isFrom ? to_ : from_;
+    auto iter = other.vids.find(node.vid);
+    if (iter == other.vids.end()) {
+        return false;
+    }
+    for (auto i = iter->second; i != kNone; i = other.nodes[i].sameVid) {
+        auto &otherNode = other.nodes[i];
+        if (otherNode.depth == 0 && !found_[isFrom ? otherNode.origin : node.origin]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool PathFinder::finished() const {
+    if (shortest_ && targetsFound_ == found_.size()) {
+        return true;
+    }
+    if (from_.depth + to_.depth >= steps_) {
+        return true;
+    }
+    // The two sides could never meet again if any of them could not go further
+    if (from_.layerSize() == 0) {
+        return true;
+    }
+    for (auto i = to_.layerBegin; i < to_.nodes.size(); i++) {
+        if (isExpanding(to_, to_.nodes[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+std::vector<VertexID> PathFinder::frontier() const {
+    auto &side = isFromNext() ? from_ : to_;
+    std::vector<VertexID> vids;
+    vids.reserve(side.layerSize());
+    for (auto i = side.layerBegin; i < side.nodes.size(); i++) {
+        if (isExpanding(side, side.nodes[i])) {
+            vids.emplace_back(side.nodes[i].vid);
+        }
+    }
+    // A vertex is in the target side once for each target it could reach
+    std::sort(vids.begin(), vids.end());
+    vids.erase(std::unique(vids.begin(), vids.end()), vids.end());
+    return vids;
+}
+
+
+void PathFinder::expand(const Frontiers &frontiers) {
+    auto isFrom = isFromNext();
+    auto &side = isFrom ? from_ : to_;
+    auto &other = isFrom ? to_ : from_;
+
+    folly::F14FastMap<VertexID, std::vector<const Neighbors*>> neighbors;
+    for (auto &frontier : frontiers) {
+        neighbors[frontier.first].emplace_back(&frontier.second);
+    }
+
+    auto layerEnd = static_cast<uint32_t>(side.nodes.size());
+    auto depth = side.depth + 1;
+    for (auto i = side.layerBegin; i < layerEnd; i++) {
+        if (!isExpanding(side, side.nodes[i])) {
+            continue;
+        }
+        // The nodes are appended in the loop, so they are copied rather than referred to
+        auto vid = side.nodes[i].vid;
+        auto origin = side.nodes[i].origin;
+        auto iter = neighbors.find(vid);
+        if (iter == neighbors.end()) {
+            continue;
+        }
+        for (auto *list : iter->second) {
+            for (auto &neighbor : *list) {
+                auto dst = std::get<0>(neighbor);
+                auto type = isFrom ? std::get<1>(neighbor) : -std::get<1>(neighbor);
+                auto node = side.find(dst, origin);
+                if (node != kNone && side.nodes[node].depth != depth) {
+                    if (shortest_ && !isLoop(side, side.nodes[node])) {
+                        // Reached by a shorter distance already
+                        continue;
+                    }
+                    node = kNone;
+                }
+                if (node == kNone) {
+                    node = side.add(dst, origin, depth);
+                    if (shortest_) {
+                        auto iterOther = other.vids.find(dst);
+                        auto otherNode = iterOther == other.vids.end() ? kNone
+                                                                       : iterOther->second;
+                        for (; otherNode != kNone; otherNode = other.nodes[otherNode].sameVid) {
+                            if (isFrom) {
+                                meet(node, otherNode);
+                            } else {
+                                meet(otherNode, node);
+                            }
+                        }
+                    }
+                }
+                side.addParent(node, i, type, std::get<2>(neighbor));
+            }
+        }
+    }
+    side.layerBegin = layerEnd;
+    side.depth = depth;
+
+    for (auto i = 0u; i < lengths_.size(); i++) {
+        if (!found_[i] && lengths_[i] != kNone) {
+            found_[i] = true;
+            targetsFound_++;
+        }
+    }
+}
+
+
+void PathFinder::meet(uint32_t fromNode, uint32_t toNode) {
+    // A path of a target found before could be met at another vertex again
+    auto target = to_.nodes[toNode].origin;
+    if (found_[target]) {
+        return;
+    }
+    auto length = from_.nodes[fromNode].depth + to_.nodes[toNode].depth;
+    if (length == 0 || length > lengths_[target]) {
+        return;
+    }
+    if (length < lengths_[target]) {
+        lengths_[target] = length;
+        meetings_[target].clear();
+    }
+    meetings_[target].emplace_back(fromNode, toNode);
+}
+
+
+std::vector<PathFinder::Path> PathFinder::paths() const {
+    std::vector<Path> paths;
+    Path prefix;
+    if (shortest_) {
+        for (auto &meetings : meetings_) {
+            for (auto &meeting : meetings) {
+                enumerateFrom(meeting.first, meeting.second, prefix, paths);
+            }
+        }
+        return paths;
+    }
+
+    // A path no longer than the source side ends at a target, the longer ones are split
+    // at the last layer of the source side
+    for (auto fromNode = 0u; fromNode < from_.nodes.size(); fromNode++) {
+        auto &node = from_.nodes[fromNode];
+        auto iter = to_.vids.find(node.vid);
+        if (iter == to_.vids.end()) {
+            continue;
+        }
+        for (auto toNode = iter->second; toNode != kNone; toNode = to_.nodes[toNode].sameVid) {
+            auto toDepth = to_.nodes[toNode].depth;
+            if (node.depth + toDepth == 0) {
+                continue;
+            }
+            if (node.depth == from_.depth || toDepth == 0) {
+                enumerateFrom(fromNode, toNode, prefix, paths);
+            }
+        }
+    }
+    return paths;
+}
+
+
+void PathFinder::enumerateFrom(uint32_t fromNode,
+                               uint32_t toNode,
+                               Path &prefix,
+                               std::vector<Path> &paths) const {
+    auto &node = from_.nodes[fromNode];
+    if (node.depth == 0) {
+        // The prefix is built backwards
+        Path path(prefix.rbegin(), prefix.rend());
+        enumerateTo(toNode, path, paths);
+        return;
+    }
+    for (auto i = node.parents; i != kNone; i = from_.parents[i].next) {
+        auto &parent = from_.parents[i];
+        prefix.emplace_back(from_.nodes[parent.node].vid, parent.type, parent.rank);
+        enumerateFrom(parent.node, toNode, prefix, paths);
+        prefix.pop_back();
+    }
+}
+
+
+void PathFinder::enumerateTo(uint32_t toNode, Path &path, std::vector<Path> &paths) const {
+    auto &node = to_.nodes[toNode];
+    if (node.depth == 0) {
+        path.emplace_back(node.vid, 0, 0);
+        paths.emplace_back(path);
+        path.pop_back();
+        return;
+    }
+    for (auto i = node.parents; i != kNone; i = to_.parents[i].next) {
+        auto &parent = to_.parents[i];
+        path.emplace_back(node.vid, parent.type, parent.rank);
+        enumerateTo(parent.node, path, paths);
+        path.pop_back();
+    }
+}
+
+}   // namespace graph
+}   // namespace nebula
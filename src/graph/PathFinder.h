@@ -0,0 +1,153 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_PATHFINDER_H_
+#define GRAPH_PATHFINDER_H_
+
+#include "base/Base.h"
+#include <folly/container/F14Map.h>
+
+namespace nebula {
+namespace graph {
+
+using Neighbor = std::tuple<VertexID, EdgeType, EdgeRanking>; /* dst, type, rank*/
+using Neighbors = std::vector<Neighbor>;
+using Frontiers =
+        std::vector<
+                    std::pair<
+                              VertexID, /* start */
+                              Neighbors /* frontiers of vertex*/
+                             >
+                   >;
+
+/**
+ * The search core of FIND PATH, a bidirectional BFS from the sources and the targets.
+ *
+ * Each side keeps its vertices reached as nodes in an arena, layer by layer, and each node
+ * keeps the indices of its predecessors in the previous layer along with the edges, rather
+ * than the paths to it. The side with the smaller frontier is expanded each time, until the
+ * two sides are deep enough, and the paths are enumerated from the meeting points only
+ * at last.
+ *
+ * For SHORTEST PATH, a vertex is reached only once on each side, by the shortest distance.
+ * The target side keeps the vertices for each target respectively, so the shortest paths
+ * to every target are found, and a target is not expanded any more once found.
+ *
+ * For ALL PATH, which includes the paths with loops, a vertex is reached once per layer.
+ * A path of length L is split at min(L, the depth of the source side), so it's found from
+ * exactly one meeting point.
+ */
+class PathFinder final {
+public:
+    // The vertex, and the edge to the next vertex, which is 0 for the last one
+    using Step = std::tuple<VertexID, EdgeType, EdgeRanking>;
+    using Path = std::vector<Step>;
+
+    PathFinder(const std::vector<VertexID> &from,
+               const std::vector<VertexID> &to,
+               uint32_t steps,
+               bool shortest);
+
+    bool finished() const;
+
+    // The source side is to be expanded next, or else the target side
+    bool isFromNext() const {
+        return from_.layerSize() <= to_.layerSize();
+    }
+
+    // The vertices to get the neighbors of, for the side to be expanded next
+    std::vector<VertexID> frontier() const;
+
+    /**
+     * Expand the side with the neighbors of its frontier, which are the out-neighbors for
+     * the source side, and the in-neighbors with the reversed edge types for the other.
+     */
+    void expand(const Frontiers &frontiers);
+
+    std::vector<Path> paths() const;
+
+    // The vertices reached on both sides
+    size_t nodesNum() const {
+        return from_.nodes.size() + to_.nodes.size();
+    }
+
+private:
+    static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+    struct Node {
+        VertexID        vid;
+        // The index of the target for the target side of SHORTEST PATH, 0 otherwise
+        uint32_t        origin;
+        uint32_t        depth;
+        // The head of the list of the predecessors
+        uint32_t        parents{kNone};
+        // The previous node of the same vertex
+        uint32_t        sameVid{kNone};
+    };
+
+    struct Parent {
+        uint32_t        node;
+        // The type of the edge in the direction from the source to the target
+        EdgeType        type;
+        EdgeRanking     rank;
+        uint32_t        next;
+    };
+
+    struct Side {
+        std::vector<Node>                           nodes;
+        std::vector<Parent>                         parents;
+        // The vertex to the last node of it
+        folly::F14FastMap<VertexID, uint32_t>       vids;
+        // The nodes of the last layer begin at `layerBegin'
+        uint32_t                                    layerBegin{0};
+        uint32_t                                    depth{0};
+
+        size_t layerSize() const {
+            return nodes.size() - layerBegin;
+        }
+
+        uint32_t find(VertexID vid, uint32_t origin) const;
+
+        uint32_t add(VertexID vid, uint32_t origin, uint32_t depth);
+
+        void addParent(uint32_t node, uint32_t parent, EdgeType type, EdgeRanking rank);
+    };
+
+    // Whether the node is still to be expanded, not the one of a target found
+    bool isExpanding(const Side &side, const Node &node) const;
+
+    /**
+     * SHORTEST PATH: whether a vertex is a source and a target not found yet, which is
+     * reached again by a loop, and should be added once more to meet the other side.
+     */
+    bool isLoop(const Side &side, const Node &node) const;
+
+    void meet(uint32_t fromNode, uint32_t toNode);
+
+    void enumerateFrom(uint32_t fromNode,
+                       uint32_t toNode,
+                       Path &prefix,
+                       std::vector<Path> &paths) const;
+
+    void enumerateTo(uint32_t toNode, Path &path, std::vector<Path> &paths) const;
+
+private:
+    const uint32_t                                          steps_;
+    const bool                                              shortest_;
+    Side                                                    from_;
+    Side                                                    to_;
+    // SHORTEST PATH: the shortest length to each target, and the meeting points of them.
+    // A target is found once the expansion meeting it is done.
+    std::vector<uint32_t>                                   lengths_;
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> meetings_;
+    std::vector<bool>                                       found_;
+    size_t                                                  targetsFound_{0};
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_PATHFINDER_H_
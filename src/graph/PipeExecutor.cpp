@@ -93,6 +93,14 @@ Status PipeExecutor::prepare() {
         return status;
     }
 
+    // `right_' takes only the first `offset + count' rows of `left_'.
+    // Both are not negative, which has been checked by the prepare of `right_'.
+    if (sentence_->right()->kind() == Sentence::Kind::kLimit) {
+        auto *limit = static_cast<LimitSentence*>(sentence_->right());
+        if (limit->count() <= std::numeric_limits<int64_t>::max() - limit->offset()) {
+            left_->setOutputLimit(limit->offset() + limit->count());
+        }
+    }
 
     return Status::OK();
 }
@@ -122,6 +130,11 @@ void PipeExecutor::feedResult(std::unique_ptr<InterimResult> result) {
 }
 
 
+void PipeExecutor::setOutputLimit(int64_t limit) {
+    right_->setOutputLimit(limit);
+}
+
+
 void PipeExecutor::setupResponse(cpp2::ExecutionResponse &resp) {
     /**
      * `setupResponse()' could be invoked if and only if this executor
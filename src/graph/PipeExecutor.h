@@ -27,6 +27,8 @@ public:
 
     void feedResult(std::unique_ptr<InterimResult> result) override;
 
+    void setOutputLimit(int64_t limit) override;
+
     void setupResponse(cpp2::ExecutionResponse &resp) override;
 
 private:
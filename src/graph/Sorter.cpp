@@ -0,0 +1,219 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/Sorter.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+// Each row of a run is the key and the index of the row
+Status writeRun(SpillFile *run, folly::StringPiece key, uint32_t row) {
+    std::vector<cpp2::ColumnValue> values(2);
+    values[0].set_str(key.str());
+    values[1].set_integer(row);
+    return run->write(values);
+}
+
+}   // namespace
+
+Sorter::Sorter(int64_t memoryBudget, int64_t limit)
+    : memoryBudget_(memoryBudget)
+    , limit_(limit)
+    , arena_(std::make_unique<Arena>()) {
+}
+
+
+Status Sorter::add(folly::StringPiece key, uint32_t row) {
+    if (limit_ >= 0) {
+        if (static_cast<int64_t>(entries_.size()) < limit_) {
+            push(key, row);
+            std::push_heap(entries_.begin(), entries_.end(), less);
+            return Status::OK();
+        }
+        // Replace the last one of the kept rows if it is before that
+        if (limit_ == 0 || !less(Entry{key, row}, entries_.front())) {
+            return Status::OK();
+        }
+        std::pop_heap(entries_.begin(), entries_.end(), less);
+        keysSize_ -= entries_.back().key.size();
+        entries_.pop_back();
+        push(key, row);
+        std::push_heap(entries_.begin(), entries_.end(), less);
+        auto allocated = arena_->allocated();
+        if (allocated > kMinCompactSize && allocated > keysSize_ * 2) {
+            compact();
+        }
+        return Status::OK();
+    }
+
+    if (static_cast<int64_t>(memoryUsage()) >= memoryBudget_ && entries_.size() >= kMinRunRows) {
+        auto status = spill();
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    push(key, row);
+    return Status::OK();
+}
+
+
+void Sorter::push(folly::StringPiece key, uint32_t row) {
+    entries_.emplace_back(Entry{arena_->copy(key), row});
+    keysSize_ += key.size();
+}
+
+
+void Sorter::compact() {
+    auto arena = std::make_unique<Arena>();
+    for (auto &entry : entries_) {
+        entry.key = arena->copy(entry.key);
+    }
+    arena_ = std::move(arena);
+}
+
+
+Status Sorter::spill() {
+    if (runs_.empty()) {
+        LOG(INFO) << "Spill the sorted runs, " << entries_.size()
+                  << " rows take " << memoryUsage() << " bytes";
+    }
+    std::sort(entries_.begin(), entries_.end(), less);
+    auto ret = SpillFile::create();
+    if (!ret.ok()) {
+        return ret.status();
+    }
+    auto run = std::move(ret).value();
+    for (auto &entry : entries_) {
+        auto status = writeRun(run.get(), entry.key, entry.row);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    runs_.emplace_back(std::move(run));
+    entries_.clear();
+    entries_.shrink_to_fit();
+    arena_ = std::make_unique<Arena>();
+    keysSize_ = 0;
+    return Status::OK();
+}
+
+
+Status Sorter::finish(Output output) {
+    if (limit_ >= 0) {
+        std::sort_heap(entries_.begin(), entries_.end(), less);
+    } else if (runs_.empty()) {
+        std::sort(entries_.begin(), entries_.end(), less);
+    } else {
+        if (!entries_.empty()) {
+            auto status = spill();
+            if (!status.ok()) {
+                return status;
+            }
+        }
+        // Merge the runs into fewer ones, until they could be merged at once
+        while (runs_.size() > kMaxMergeWays) {
+            std::vector<std::unique_ptr<SpillFile>> merged;
+            for (auto i = 0u; i < runs_.size(); i += kMaxMergeWays) {
+                auto end = std::min(i + kMaxMergeWays, runs_.size());
+                if (end - i == 1) {
+                    merged.emplace_back(std::move(runs_[i]));
+                    continue;
+                }
+                auto ret = SpillFile::create();
+                if (!ret.ok()) {
+                    return ret.status();
+                }
+                auto run = std::move(ret).value();
+                std::vector<std::unique_ptr<SpillFile>> runs(
+                        std::make_move_iterator(runs_.begin() + i),
+                        std::make_move_iterator(runs_.begin() + end));
+                auto status = merge(std::move(runs), [&run] (folly::StringPiece key,
+                                                             uint32_t row) {
+                    return writeRun(run.get(), key, row);
+                });
+                if (!status.ok()) {
+                    return status;
+                }
+                merged.emplace_back(std::move(run));
+            }
+            runs_ = std::move(merged);
+        }
+        auto runs = std::move(runs_);
+        runs_.clear();
+        return merge(std::move(runs), [&output] (folly::StringPiece, uint32_t row) {
+            output(row);
+            return Status::OK();
+        });
+    }
+
+    for (auto &entry : entries_) {
+        output(entry.row);
+    }
+    entries_.clear();
+    arena_ = std::make_unique<Arena>();
+    keysSize_ = 0;
+    return Status::OK();
+}
+
+
+// static
+Status Sorter::merge(std::vector<std::unique_ptr<SpillFile>> runs, MergeOutput output) {
+    struct Head {
+        std::string     key;
+        uint32_t        row;
+        size_t          run;
+    };
+    auto greater = [] (const Head &lhs, const Head &rhs) {
+        auto ret = lhs.key.compare(rhs.key);
+        return ret > 0 || (ret == 0 && lhs.row > rhs.row);
+    };
+    std::priority_queue<Head, std::vector<Head>, decltype(greater)> heads(greater);
+
+    std::vector<cpp2::ColumnValue> values;
+    auto next = [&] (size_t run) -> Status {
+        auto ret = runs[run]->read(values);
+        if (!ret.ok()) {
+            return ret.status();
+        }
+        if (ret.value()) {
+            DCHECK_EQ(2, values.size());
+            heads.push(Head{values[0].get_str(),
+                            static_cast<uint32_t>(values[1].get_integer()),
+                            run});
+        }
+        return Status::OK();
+    };
+
+    for (auto i = 0u; i < runs.size(); i++) {
+        auto status = runs[i]->rewind();
+        if (!status.ok()) {
+            return status;
+        }
+        status = next(i);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    while (!heads.empty()) {
+        auto head = heads.top();
+        heads.pop();
+        auto status = output(head.key, head.row);
+        if (!status.ok()) {
+            return status;
+        }
+        status = next(head.run);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    return Status::OK();
+}
+
+}   // namespace graph
+}   // namespace nebula
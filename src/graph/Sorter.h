@@ -0,0 +1,94 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_SORTER_H_
+#define GRAPH_SORTER_H_
+
+#include "base/Base.h"
+#include "base/Arena.h"
+#include "base/StatusOr.h"
+#include "graph/SpillFile.h"
+
+namespace nebula {
+namespace graph {
+
+/**
+ * Sort the rows by their sort keys, which are compared byte by byte, and the rows with the
+ * same keys are kept in the order they are added. Only the keys and the indices of the rows
+ * are kept, the rows themselves are untouched.
+ *
+ * With a limit, only the first `limit' rows are kept in a bounded heap, so the rows which
+ * could never be output are dropped as soon as they are added.
+ *
+ * Without a limit, the keys are sorted in memory until they take more memory than the
+ * budget. Beyond that, each time the budget is used up, the keys are sorted and spilled
+ * to disk as a sorted run, and the runs are merged once finished.
+ */
+class Sorter final {
+public:
+    using Output = std::function<void(uint32_t row)>;
+
+    // Keep only the first `limit' rows, if it is not negative
+    explicit Sorter(int64_t memoryBudget, int64_t limit = -1);
+
+    Status add(folly::StringPiece key, uint32_t row);
+
+    // Output the rows in order
+    Status finish(Output output);
+
+    // The sorted runs spilled to disk
+    size_t runsNum() const {
+        return runs_.size();
+    }
+
+    size_t memoryUsage() const {
+        return arena_->allocated() + entries_.capacity() * sizeof(Entry);
+    }
+
+private:
+    struct Entry {
+        folly::StringPiece      key;
+        uint32_t                row;
+    };
+
+    // The rows with the same keys are in the order they are added
+    static bool less(const Entry &lhs, const Entry &rhs) {
+        auto ret = lhs.key.compare(rhs.key);
+        return ret < 0 || (ret == 0 && lhs.row < rhs.row);
+    }
+
+    using MergeOutput = std::function<Status(folly::StringPiece key, uint32_t row)>;
+
+    static constexpr size_t kMinRunRows = 1024;
+    // The runs merged at once, which are all open during the merge
+    static constexpr size_t kMaxMergeWays = 16;
+    static constexpr size_t kMinCompactSize = 1024 * 1024;
+
+    void push(folly::StringPiece key, uint32_t row);
+
+    // Copy the keys in the heap to a new arena, to drop the ones popped out
+    void compact();
+
+    Status spill();
+
+    static Status merge(std::vector<std::unique_ptr<SpillFile>> runs, MergeOutput output);
+
+private:
+    const int64_t                               memoryBudget_;
+    const int64_t                               limit_;
+
+    std::unique_ptr<Arena>                      arena_;
+    // A max-heap with a limit, or the rows not spilled yet without
+    std::vector<Entry>                          entries_;
+    // The bytes of the keys in `entries_'
+    size_t                                      keysSize_{0};
+    std::vector<std::unique_ptr<SpillFile>>     runs_;
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_SORTER_H_
@@ -0,0 +1,234 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "graph/SpillFile.h"
+#include "graph/GraphFlags.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+template <typename T>
+void appendPod(std::string &buf, T v) {
+    buf.append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <typename T>
+bool readPod(folly::StringPiece &data, T &v) {
+    if (data.size() < sizeof(T)) {
+        return false;
+    }
+    memcpy(&v, data.data(), sizeof(T));
+    data.advance(sizeof(T));
+    return true;
+}
+
+}   // namespace
+
+// static
+StatusOr<std::unique_ptr<SpillFile>> SpillFile::create() {
+    std::unique_ptr<fs::TempFile> file;
+    try {
+        auto path = folly::stringPrintf("%s/nebula_spill.XXXXXX", FLAGS_query_spill_path.c_str());
+        file = std::make_unique<fs::TempFile>(path.c_str());
+    } catch (const std::exception &e) {
+        LOG(ERROR) << "Create the spill file failed: " << e.what();
+        return Status::Error("Create the spill file failed: %s", e.what());
+    }
+    auto *fp = ::fopen(file->path(), "w+b");
+    if (fp == nullptr) {
+        LOG(ERROR) << "Open " << file->path() << " failed: " << ::strerror(errno);
+        return Status::Error("Open the spill file failed: %s", ::strerror(errno));
+    }
+    VLOG(1) << "Spill to " << file->path();
+    return std::unique_ptr<SpillFile>(new SpillFile(std::move(file), fp));
+}
+
+
+SpillFile::~SpillFile() {
+    if (fp_ != nullptr) {
+        ::fclose(fp_);
+    }
+}
+
+
+Status SpillFile::write(const std::vector<cpp2::ColumnValue> &row) {
+    buf_.clear();
+    encodeRow(row, buf_);
+    uint32_t len = buf_.size();
+    if (::fwrite(&len, sizeof(len), 1, fp_) != 1 ||
+            ::fwrite(buf_.data(), 1, buf_.size(), fp_) != buf_.size()) {
+        LOG(ERROR) << "Write " << file_->path() << " failed: " << ::strerror(errno);
+        return Status::Error("Write the spill file failed: %s", ::strerror(errno));
+    }
+    rowsNum_++;
+    return Status::OK();
+}
+
+
+Status SpillFile::rewind() {
+    if (::fflush(fp_) != 0 || ::fseek(fp_, 0, SEEK_SET) != 0) {
+        LOG(ERROR) << "Rewind " << file_->path() << " failed: " << ::strerror(errno);
+        return Status::Error("Rewind the spill file failed: %s", ::strerror(errno));
+    }
+    return Status::OK();
+}
+
+
+StatusOr<bool> SpillFile::read(std::vector<cpp2::ColumnValue> &row) {
+    uint32_t len = 0;
+    if (::fread(&len, sizeof(len), 1, fp_) != 1) {
+        if (::feof(fp_)) {
+            return false;
+        }
+        return Status::Error("Read the spill file failed: %s", ::strerror(errno));
+    }
+    buf_.resize(len);
+    if (::fread(&buf_[0], 1, len, fp_) != len) {
+        return Status::Error("Read the spill file failed, the row is truncated");
+    }
+    auto status = decodeRow(buf_, row);
+    if (!status.ok()) {
+        return status;
+    }
+    return true;
+}
+
+
+// static
+void SpillFile::encodeValue(const cpp2::ColumnValue &value, std::string &buf) {
+    using Type = cpp2::ColumnValue::Type;
+    buf.push_back(static_cast<char>(value.getType()));
+    switch (value.getType()) {
+        case Type::id:
+            appendPod<int64_t>(buf, value.get_id());
+            break;
+        case Type::integer:
+            appendPod<int64_t>(buf, value.get_integer());
+            break;
+        case Type::timestamp:
+            appendPod<int64_t>(buf, value.get_timestamp());
+            break;
+        case Type::single_precision:
+            appendPod<float>(buf, value.get_single_precision());
+            break;
+        case Type::double_precision: {
+            // 0.0 and -0.0 are the same
+            auto v = value.get_double_precision();
+            appendPod<double>(buf, v == 0.0 ? 0.0 : v);
+            break;
+        }
+        case Type::bool_val:
+            buf.push_back(value.get_bool_val() ? 1 : 0);
+            break;
+        case Type::str:
+            appendPod<uint32_t>(buf, value.get_str().size());
+            buf.append(value.get_str());
+            break;
+        case Type::__EMPTY__:
+            break;
+        default:
+            LOG(ERROR) << "Unsupported type: " << static_cast<int32_t>(value.getType());
+            buf.back() = static_cast<char>(Type::__EMPTY__);
+            break;
+    }
+}
+
+
+// static
+void SpillFile::encodeRow(const std::vector<cpp2::ColumnValue> &row, std::string &buf) {
+    appendPod<uint32_t>(buf, row.size());
+    for (auto &value : row) {
+        encodeValue(value, buf);
+    }
+}
+
+
+// static
+Status SpillFile::decodeValue(folly::StringPiece &data, cpp2::ColumnValue &value) {
+    using Type = cpp2::ColumnValue::Type;
+    if (data.empty()) {
+        return Status::Error("Decode value failed, no data");
+    }
+    auto type = static_cast<Type>(data.front());
+    data.advance(1);
+    bool ok = true;
+    switch (type) {
+        case Type::id:
+        case Type::integer:
+        case Type::timestamp: {
+            int64_t v = 0;
+            ok = readPod(data, v);
+            if (type == Type::id) {
+                value.set_id(v);
+            } else if (type == Type::integer) {
+                value.set_integer(v);
+            } else {
+                value.set_timestamp(v);
+            }
+            break;
+        }
+        case Type::single_precision: {
+            float v = 0;
+            ok = readPod(data, v);
+            value.set_single_precision(v);
+            break;
+        }
+        case Type::double_precision: {
+            double v = 0;
+            ok = readPod(data, v);
+            value.set_double_precision(v);
+            break;
+        }
+        case Type::bool_val: {
+            char v = 0;
+            ok = readPod(data, v);
+            value.set_bool_val(v != 0);
+            break;
+        }
+        case Type::str: {
+            uint32_t len = 0;
+            ok = readPod(data, len) && data.size() >= len;
+            if (ok) {
+                value.set_str(std::string(data.data(), len));
+                data.advance(len);
+            }
+            break;
+        }
+        case Type::__EMPTY__:
+            value = cpp2::ColumnValue();
+            break;
+        default:
+            return Status::Error("Decode value failed, unknown type %d",
+                                 static_cast<int32_t>(type));
+    }
+    if (!ok) {
+        return Status::Error("Decode value failed, the data is truncated");
+    }
+    return Status::OK();
+}
+
+
+// static
+Status SpillFile::decodeRow(folly::StringPiece data, std::vector<cpp2::ColumnValue> &row) {
+    uint32_t count = 0;
+    if (!readPod(data, count)) {
+        return Status::Error("Decode row failed, no data");
+    }
+    row.resize(count);
+    for (auto &value : row) {
+        auto status = decodeValue(data, value);
+        if (!status.ok()) {
+            return status;
+        }
+    }
+    return Status::OK();
+}
+
+}   // namespace graph
+}   // namespace nebula
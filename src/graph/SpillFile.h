@@ -0,0 +1,67 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef GRAPH_SPILLFILE_H_
+#define GRAPH_SPILLFILE_H_
+
+#include "base/Base.h"
+#include "base/StatusOr.h"
+#include "fs/TempFile.h"
+#include "gen-cpp2/graph_types.h"
+
+namespace nebula {
+namespace graph {
+
+/**
+ * The rows spilled by the executors when they are out of the memory budget. The rows
+ * are appended to a temporary file under --query_spill_path, and read back in the same
+ * order once finished. The file is removed on destruction.
+ */
+class SpillFile final {
+public:
+    static StatusOr<std::unique_ptr<SpillFile>> create();
+
+    ~SpillFile();
+
+    Status write(const std::vector<cpp2::ColumnValue> &row);
+
+    // Finish writing, and move to the first row for reading
+    Status rewind();
+
+    // Read the next row, returns false at the end
+    StatusOr<bool> read(std::vector<cpp2::ColumnValue> &row);
+
+    size_t rowsNum() const {
+        return rowsNum_;
+    }
+
+    /**
+     * The values are encoded with the types, the same values are encoded into the same
+     * bytes. So the encoded rows could be compared for equality as the keys.
+     */
+    static void encodeValue(const cpp2::ColumnValue &value, std::string &buf);
+
+    static void encodeRow(const std::vector<cpp2::ColumnValue> &row, std::string &buf);
+
+    static Status decodeRow(folly::StringPiece data, std::vector<cpp2::ColumnValue> &row);
+
+private:
+    SpillFile(std::unique_ptr<fs::TempFile> file, FILE *fp)
+        : file_(std::move(file)), fp_(fp) {}
+
+    static Status decodeValue(folly::StringPiece &data, cpp2::ColumnValue &value);
+
+private:
+    std::unique_ptr<fs::TempFile>           file_;
+    FILE                                   *fp_{nullptr};
+    size_t                                  rowsNum_{0};
+    std::string                             buf_;
+};
+
+}   // namespace graph
+}   // namespace nebula
+
+#endif  // GRAPH_SPILLFILE_H_
@@ -152,6 +152,15 @@ public:
         onResult_ = std::move(onResult);
     }
 
+    /**
+     * The executor depending on this one takes only the first `limit' rows of its results,
+     * e.g. `ORDER BY ... | LIMIT', so it could produce no more than that.
+     * It's ignored by default.
+     */
+    virtual void setOutputLimit(int64_t limit) {
+        UNUSED(limit);
+    }
+
     static std::unique_ptr<TraverseExecutor>
     makeTraverseExecutor(Sentence *sentence, ExecutionContext *ectx);
 
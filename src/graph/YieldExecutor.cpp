@@ -200,15 +200,17 @@ Status YieldExecutor::executeInputs() {
         return status;
     }
 
-    auto rsWriter = std::make_unique<RowSetWriter>(outputSchema);
-    auto visitor =
-        [inputs, &outputSchema, &rsWriter, &status, this] (const RowReader *reader) -> Status {
+    auto outputs = std::make_unique<InterimResult>();
+    outputs->setSchema(outputSchema);
+    std::vector<VariantType> record;
+    record.reserve(yields_.size());
+    for (auto row = 0u; row < inputs->rowsNum(); row++) {
         Getters getters;
-        getters.getVariableProp = [inputs, reader] (const std::string &prop) {
-            return Collector::getProp(inputs->schema().get(), prop, reader);
+        getters.getVariableProp = [inputs, row] (const std::string &prop) {
+            return inputs->getColumn(row, prop);
         };
-        getters.getInputProp = [inputs, reader] (const std::string &prop) {
-            return Collector::getProp(inputs->schema().get(), prop, reader);
+        getters.getInputProp = [inputs, row] (const std::string &prop) {
+            return inputs->getColumn(row, prop);
         };
         if (filter_ != nullptr) {
             auto val = filter_->eval(getters);
@@ -216,24 +218,24 @@ Status YieldExecutor::executeInputs() {
                 return val.status();
             }
             if (!Expression::asBool(val.value())) {
-                return Status::OK();
+                continue;
             }
         }
 
         if (aggFuns_.empty()) {
-            auto writer = std::make_unique<RowWriter>(outputSchema);
+            record.clear();
             for (auto col : yields_) {
                 auto *expr = col->expr();
                 auto value = expr->eval(getters);
                 if (!value.ok()) {
                     return value.status();
                 }
-                status = Collector::collect(value.value(), writer.get());
-                if (!status.ok()) {
-                    return status;
-                }
+                record.emplace_back(std::move(value).value());
+            }
+            status = outputs->addRow(record);
+            if (!status.ok()) {
+                return status;
             }
-            rsWriter->addRow(*writer);
         } else {
             auto i = 0u;
             for (auto col : yields_) {
@@ -251,13 +253,6 @@ Status YieldExecutor::executeInputs() {
                 i++;
             }
         }
-
-        return Status::OK();
-    };
-
-    status = inputs->applyTo(visitor);
-    if (!status.ok()) {
-        return status;
     }
 
     if (!aggFuns_.empty()) {
@@ -273,23 +268,18 @@ Status YieldExecutor::executeInputs() {
             i++;
         }
         row.set_columns(std::move(cols));
-        rsWriter->setSchema(std::move(schema));
-        status = getAggResultWriter(std::move(row), rsWriter.get());
+        outputs = std::make_unique<InterimResult>();
+        outputs->setSchema(std::move(schema));
+        status = outputs->addRow(row);
         if (!status.ok()) {
             return status;
         }
     }
 
-    finishExecution(std::move(rsWriter));
+    finishExecution(std::move(outputs));
     return Status::OK();
 }
 
-Status YieldExecutor::getAggResultWriter(cpp2::RowValue row, RowSetWriter* rsWriter) {
-    std::vector<cpp2::RowValue> rows;
-    rows.emplace_back(std::move(row));
-    return InterimResult::getResultWriter(rows, rsWriter);
-}
-
 Status YieldExecutor::getOutputSchema(const InterimResult *inputs,
                                       SchemaWriter *outputSchema) const {
     if (expCtx_ == nullptr || resultColNames_.empty()) {
@@ -320,13 +310,14 @@ Status YieldExecutor::getOutputSchema(const InterimResult *inputs,
 
     std::vector<VariantType> record;
     record.reserve(yields_.size());
-    auto visitor = [inputSchema, &record, this] (const RowReader *reader) -> Status {
+    if (inputs->rowsNum() > 0) {
+        // The types of the columns are decided by the first row
         Getters getters;
-        getters.getVariableProp = [inputSchema, reader] (const std::string &prop) {
-            return Collector::getProp(inputSchema, prop, reader);
+        getters.getVariableProp = [inputs] (const std::string &prop) {
+            return inputs->getColumn(0, prop);
         };
-        getters.getInputProp = [inputSchema, reader] (const std::string &prop) {
-            return Collector::getProp(inputSchema, prop, reader);
+        getters.getInputProp = [inputs] (const std::string &prop) {
+            return inputs->getColumn(0, prop);
         };
         for (auto *column : yields_) {
             auto *expr = column->expr();
@@ -336,9 +327,7 @@ Status YieldExecutor::getOutputSchema(const InterimResult *inputs,
             }
             record.emplace_back(std::move(value).value());
         }
-        return Status::OK();
-    };
-    inputs->applyTo(visitor, 1);
+    }
 
     return Collector::getSchema(record, resultColNames_, colTypes_, outputSchema);
 }
@@ -366,16 +355,13 @@ Status YieldExecutor::executeConstant() {
             return status;
         }
 
-        RowWriter writer(outputSchema);
-        auto rsWriter = std::make_unique<RowSetWriter>(outputSchema);
-        for (auto col : values) {
-            status = Collector::collect(col, &writer);
-            if (!status.ok()) {
-                return status;
-            }
+        auto outputs = std::make_unique<InterimResult>();
+        outputs->setSchema(std::move(outputSchema));
+        status = outputs->addRow(values);
+        if (!status.ok()) {
+            return status;
         }
-        rsWriter->addRow(writer);
-        finishExecution(std::move(rsWriter));
+        finishExecution(std::move(outputs));
     } else {
         return AggregateConstant();
     }
@@ -410,20 +396,21 @@ Status YieldExecutor::AggregateConstant() {
         i++;
     }
     row.set_columns(std::move(cols));
-    auto rsWriter = std::make_unique<RowSetWriter>(schema);
-    auto status = getAggResultWriter(std::move(row), rsWriter.get());
+    auto outputs = std::make_unique<InterimResult>();
+    outputs->setSchema(std::move(schema));
+    auto status = outputs->addRow(row);
     if (!status.ok()) {
         return status;
     }
-    finishExecution(std::move(rsWriter));
+    finishExecution(std::move(outputs));
     return Status::OK();
 }
 
-void YieldExecutor::finishExecution(std::unique_ptr<RowSetWriter> rsWriter) {
-    auto outputs = std::make_unique<InterimResult>(std::move(resultColNames_));
-    if (rsWriter != nullptr) {
-        outputs->setInterim(std::move(rsWriter));
+void YieldExecutor::finishExecution(std::unique_ptr<InterimResult> outputs) {
+    if (outputs == nullptr) {
+        outputs = std::make_unique<InterimResult>();
     }
+    outputs->setColNames(std::move(resultColNames_));
 
     if (onResult_) {
         onResult_(std::move(outputs));
@@ -46,12 +46,10 @@ private:
 
     Status executeConstant();
 
-    void finishExecution(std::unique_ptr<RowSetWriter> rsWriter);
+    void finishExecution(std::unique_ptr<InterimResult> outputs);
 
     Status checkAggFun();
 
-    Status getAggResultWriter(cpp2::RowValue row, RowSetWriter* rsWriter);
-
     Status AggregateConstant();
 
 private:
@@ -184,6 +184,45 @@ TEST_F(FetchEdgesTest, Base) {
         }
         ASSERT_TRUE(verifyResult(resp, expected));
     }
+    {
+        // The rank piped in is an INT column
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Boris Diaw"];
+        auto *fmt = "GO FROM %ld OVER serve"
+                    " YIELD serve._src AS src, serve._dst AS dst, serve._rank AS rank"
+                    "| FETCH PROP ON serve $-.src->$-.dst@$-.rank"
+                    " YIELD serve.start_year, serve.end_year";
+        auto query = folly::stringPrintf(fmt, player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+
+        std::vector<std::tuple<int64_t, int64_t, int64_t, int64_t, int64_t>> expected;
+        for (auto &serve : player.serves()) {
+            std::tuple<int64_t, int64_t, int64_t, int64_t, int64_t> result(player.vid(),
+                    teams_[std::get<0>(serve)].vid(), 0, std::get<1>(serve), std::get<2>(serve));
+            expected.emplace_back(std::move(result));
+        }
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Boris Diaw"];
+        auto *fmt = "$var = GO FROM %ld OVER serve"
+                    " YIELD serve._src AS src, serve._dst AS dst, serve._rank AS rank;"
+                    "FETCH PROP ON serve $var.src->$var.dst@$var.rank"
+                    " YIELD serve.start_year, serve.end_year";
+        auto query = folly::stringPrintf(fmt, player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+
+        std::vector<std::tuple<int64_t, int64_t, int64_t, int64_t, int64_t>> expected;
+        for (auto &serve : player.serves()) {
+            std::tuple<int64_t, int64_t, int64_t, int64_t, int64_t> result(player.vid(),
+                    teams_[std::get<0>(serve)].vid(), 0, std::get<1>(serve), std::get<2>(serve));
+            expected.emplace_back(std::move(result));
+        }
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
     {
         cpp2::ExecutionResponse resp;
         auto &player = players_["Boris Diaw"];
@@ -13,6 +13,8 @@
 #include "graph/TraverseExecutor.h"
 #include "graph/GoExecutor.h"
 
+DECLARE_int32(go_step_page_size);
+DECLARE_int64(go_final_step_max_bytes);
 
 namespace nebula {
 namespace graph {
@@ -2199,6 +2201,54 @@ TEST_P(GoTest, DuplicateColumnName) {
     }
 }
 
+TEST_P(GoTest, PagedStepOut) {
+    FLAGS_go_step_page_size = 1;
+    {
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Tony Parker"];
+        auto *fmt = "GO 2 STEPS FROM %ld OVER like YIELD like._dst";
+        auto query = folly::stringPrintf(fmt, player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<VertexID>> expected = {
+            {3394245602834314645},
+            {-7579316172763586624},
+            {-7579316172763586624},
+            {5662213458193308137},
+            {5662213458193308137}
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto &player = players_["Boris Diaw"];
+        auto *fmt = "GO FROM %ld OVER serve YIELD "
+                    "$^.player.name, serve.start_year, serve.end_year, $$.team.name";
+        auto query = folly::stringPrintf(fmt, player.vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<std::string, int64_t, int64_t, std::string>> expected = {
+            {player.name(), 2003, 2005, "Hawks"},
+            {player.name(), 2005, 2008, "Suns"},
+            {player.name(), 2008, 2012, "Hornets"},
+            {player.name(), 2012, 2016, "Spurs"},
+            {player.name(), 2016, 2017, "Jazz"},
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        // The final step takes more than the limit
+        FLAGS_go_final_step_max_bytes = 1;
+        cpp2::ExecutionResponse resp;
+        auto *fmt = "GO 2 STEPS FROM %ld OVER like YIELD like._dst";
+        auto query = folly::stringPrintf(fmt, players_["Tony Parker"].vid());
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::E_EXECUTION_ERROR, code);
+        FLAGS_go_final_step_max_bytes = 512 * 1024 * 1024;
+    }
+    FLAGS_go_step_page_size = 0;
+}
+
 INSTANTIATE_TEST_CASE_P(IfPushdownFilter, GoTest, ::testing::Bool());
 }   // namespace graph
 }   // namespace nebula
@@ -0,0 +1,180 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "fs/TempDir.h"
+#include "graph/GraphFlags.h"
+#include "graph/HashAggregator.h"
+
+namespace nebula {
+namespace graph {
+
+static cpp2::ColumnValue intValue(int64_t v) {
+    cpp2::ColumnValue value;
+    value.set_integer(v);
+    return value;
+}
+
+static cpp2::ColumnValue strValue(std::string v) {
+    cpp2::ColumnValue value;
+    value.set_str(std::move(v));
+    return value;
+}
+
+// Group the numbers 0..num-1 by the remainders of 10, with the results keyed by the group
+static std::map<int64_t, std::vector<cpp2::ColumnValue>> aggregate(int64_t num,
+                                                                   int64_t budget,
+                                                                   size_t *spilled) {
+    HashAggregator aggregator({"", kCount, kSum, kMax, kCountDist}, budget);
+    for (int64_t i = 0; i < num; i++) {
+        std::vector<cpp2::ColumnValue> keys = {intValue(i % 10),
+                                               strValue(folly::stringPrintf("key_%ld", i % 10))};
+        std::vector<cpp2::ColumnValue> vals = {intValue(i % 10),
+                                               intValue(i),
+                                               intValue(i),
+                                               intValue(i),
+                                               intValue(i / 1000)};
+        auto status = aggregator.apply(keys, vals);
+        EXPECT_TRUE(status.ok()) << status;
+    }
+    if (spilled != nullptr) {
+        *spilled = aggregator.spilledRows();
+    }
+    std::map<int64_t, std::vector<cpp2::ColumnValue>> results;
+    auto status = aggregator.finish([&results] (std::vector<cpp2::ColumnValue> row) {
+        auto key = row[0].get_integer();
+        EXPECT_TRUE(results.emplace(key, std::move(row)).second);
+    });
+    EXPECT_TRUE(status.ok()) << status;
+    return results;
+}
+
+
+TEST(HashAggregatorTest, AggregateTest) {
+    size_t spilled = 0;
+    auto results = aggregate(10000, 256 * 1024 * 1024, &spilled);
+    ASSERT_EQ(0, spilled);
+    ASSERT_EQ(10, results.size());
+    for (auto &result : results) {
+        auto key = result.first;
+        auto &row = result.second;
+        ASSERT_EQ(1000, row[1].get_integer());
+        // key + (key + 10) + ... + (key + 9990)
+        ASSERT_EQ(1000 * key + 10 * 999 * 1000 / 2, row[2].get_integer());
+        ASSERT_EQ(9990 + key, row[3].get_integer());
+        ASSERT_EQ(10, row[4].get_integer());
+    }
+}
+
+
+TEST(HashAggregatorTest, SpillTest) {
+    fs::TempDir dir("/tmp/hash_aggregator_test.XXXXXX");
+    FLAGS_query_spill_path = dir.path();
+
+    auto expected = aggregate(10000, 256 * 1024 * 1024, nullptr);
+    size_t spilled = 0;
+    // No group is kept in memory until the last level
+    auto results = aggregate(10000, 0, &spilled);
+    ASSERT_EQ(10000, spilled);
+    ASSERT_EQ(expected, results);
+
+    // Only the new groups are spilled, the one in memory is still aggregated. The budget
+    // is more than the empty table, and less than the first block of the arena.
+    HashAggregator aggregator({kCount}, 8192);
+    for (auto i = 0; i < 100; i++) {
+        std::vector<cpp2::ColumnValue> keys = {intValue(i < 50 ? 0 : i)};
+        std::vector<cpp2::ColumnValue> vals = {intValue(i)};
+        ASSERT_TRUE(aggregator.apply(keys, vals).ok());
+    }
+    ASSERT_EQ(1, aggregator.groupsNum());
+    ASSERT_EQ(50, aggregator.spilledRows());
+    int64_t total = 0;
+    size_t groups = 0;
+    ASSERT_TRUE(aggregator.finish([&] (std::vector<cpp2::ColumnValue> row) {
+        total += row[0].get_integer();
+        groups++;
+    }).ok());
+    ASSERT_EQ(100, total);
+    ASSERT_EQ(51, groups);
+}
+
+
+TEST(HashAggregatorTest, MemoryUsageTest) {
+    fs::TempDir dir("/tmp/hash_aggregator_test.XXXXXX");
+    FLAGS_query_spill_path = dir.path();
+    {
+        // The strings kept by the functions are charged
+        HashAggregator aggregator({"", kMax}, 256 * 1024 * 1024);
+        auto empty = aggregator.memoryUsage();
+        for (auto i = 0; i < 100; i++) {
+            std::vector<cpp2::ColumnValue> keys = {intValue(i)};
+            std::vector<cpp2::ColumnValue> vals = {strValue(std::string(1024, 'a')),
+                                                   strValue(std::string(1024, 'b'))};
+            ASSERT_TRUE(aggregator.apply(keys, vals).ok());
+        }
+        ASSERT_LE(empty + 100 * 2 * 1024, aggregator.memoryUsage());
+    }
+    {
+        // So are the hashes and the registers of COUNT_DISTINCT, which spill the new groups
+        // once a few of them are in memory
+        HashAggregator aggregator({kCountDist}, 256 * 1024);
+        for (auto i = 0; i < 100; i++) {
+            for (auto j = 0; j < 2000; j++) {
+                std::vector<cpp2::ColumnValue> keys = {intValue(i)};
+                std::vector<cpp2::ColumnValue> vals = {intValue(j)};
+                ASSERT_TRUE(aggregator.apply(keys, vals).ok());
+            }
+        }
+        ASSERT_GT(100, aggregator.groupsNum());
+        ASSERT_LT(0, aggregator.spilledRows());
+        ASSERT_LE(aggregator.groupsNum() * (1UL << 14), aggregator.memoryUsage());
+        size_t groups = 0;
+        ASSERT_TRUE(aggregator.finish([&] (std::vector<cpp2::ColumnValue> row) {
+            ASSERT_LT(std::abs(row[0].get_integer() - 2000), 100);
+            groups++;
+        }).ok());
+        ASSERT_EQ(100, groups);
+    }
+}
+
+
+TEST(HashAggregatorTest, StdevTest) {
+    Stdev stdev;
+    for (auto v : {2, 4, 4, 4, 5, 5, 7, 9}) {
+        auto value = intValue(v);
+        stdev.apply(value);
+    }
+    ASSERT_DOUBLE_EQ(2.0, stdev.getResult().get_double_precision());
+
+    Stdev empty;
+    ASSERT_EQ(0, empty.getResult().get_integer());
+}
+
+
+TEST(HashAggregatorTest, CountDistinctTest) {
+    {
+        // Exact for the small cardinalities
+        CountDistinct count;
+        for (auto i = 0; i < 3000; i++) {
+            auto value = strValue(folly::to<std::string>(i % 1000));
+            count.apply(value);
+        }
+        ASSERT_EQ(1000, count.getResult().get_integer());
+    }
+    {
+        CountDistinct count;
+        for (auto i = 0; i < 200000; i++) {
+            auto value = intValue(i % 100000);
+            count.apply(value);
+        }
+        auto estimate = count.getResult().get_integer();
+        ASSERT_LT(std::abs(estimate - 100000), 3000) << estimate;
+    }
+}
+
+}   // namespace graph
+}   // namespace nebula
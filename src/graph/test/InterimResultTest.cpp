@@ -0,0 +1,227 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "graph/InterimResult.h"
+#include "dataman/RowWriter.h"
+
+namespace nebula {
+namespace graph {
+
+static std::shared_ptr<SchemaWriter> genSchema() {
+    auto schema = std::make_shared<SchemaWriter>();
+    schema->appendCol("id", nebula::cpp2::SupportedType::VID);
+    schema->appendCol("name", nebula::cpp2::SupportedType::STRING);
+    schema->appendCol("age", nebula::cpp2::SupportedType::INT);
+    schema->appendCol("score", nebula::cpp2::SupportedType::DOUBLE);
+    schema->appendCol("male", nebula::cpp2::SupportedType::BOOL);
+    return schema;
+}
+
+
+TEST(InterimResultTest, SetInterimTest) {
+    auto schema = genSchema();
+    auto rsWriter = std::make_unique<RowSetWriter>(schema);
+    for (auto i = 0; i < 10; i++) {
+        RowWriter writer(schema);
+        writer << static_cast<int64_t>(i)
+               << folly::stringPrintf("name_%d", i)
+               << static_cast<int64_t>(20 + i)
+               << 0.5 * i
+               << (i % 2 == 0);
+        rsWriter->addRow(writer);
+    }
+    InterimResult result({"id", "name", "age", "score", "male"});
+    result.setInterim(std::move(rsWriter));
+    ASSERT_TRUE(result.hasData());
+    ASSERT_EQ(10, result.rowsNum());
+
+    auto vids = result.getVIDs("id");
+    ASSERT_TRUE(vids.ok());
+    ASSERT_EQ(10, vids.value().size());
+    ASSERT_FALSE(result.getVIDs("name").ok());
+    ASSERT_FALSE(result.getVIDs("score").ok());
+    ASSERT_FALSE(result.getVIDs("not_exist").ok());
+    // The integers are read as the ids, as the ranks piped in are
+    auto ages = result.getVIDs("age");
+    ASSERT_TRUE(ages.ok());
+    ASSERT_EQ(10, ages.value().size());
+    for (auto i = 0; i < 10; i++) {
+        ASSERT_EQ(20 + i, ages.value()[i]);
+    }
+
+    auto name = result.getColumn(3, "name");
+    ASSERT_TRUE(name.ok());
+    ASSERT_EQ("name_3", boost::get<std::string>(name.value()));
+    ASSERT_FALSE(result.getColumn(3, "not_exist").ok());
+
+    auto rows = result.getRows();
+    ASSERT_TRUE(rows.ok());
+    ASSERT_EQ(10, rows.value().size());
+    for (auto i = 0; i < 10; i++) {
+        auto &cols = rows.value()[i].get_columns();
+        ASSERT_EQ(5, cols.size());
+        ASSERT_EQ(i, cols[0].get_id());
+        ASSERT_EQ(folly::stringPrintf("name_%d", i), cols[1].get_str());
+        ASSERT_EQ(20 + i, cols[2].get_integer());
+        ASSERT_DOUBLE_EQ(0.5 * i, cols[3].get_double_precision());
+        ASSERT_EQ(i % 2 == 0, cols[4].get_bool_val());
+    }
+}
+
+
+TEST(InterimResultTest, AddRowTest) {
+    InterimResult result({"id", "name", "age", "score", "male"});
+    result.setSchema(genSchema());
+
+    // The numeric values are converted to the types of the columns
+    std::vector<VariantType> row = {1L, std::string("Tim"), 18.0, 60L, true};
+    ASSERT_TRUE(result.addRow(row).ok());
+    ASSERT_EQ(18L, boost::get<int64_t>(result.getColumn(0, 2)));
+    ASSERT_DOUBLE_EQ(60.0, boost::get<double>(result.getColumn(0, 3)));
+
+    // A failed row is not added partially
+    row = {2L, std::string("Tony"), std::string("18"), 60.0, false};
+    ASSERT_FALSE(result.addRow(row).ok());
+    ASSERT_EQ(1, result.rowsNum());
+
+    cpp2::RowValue value;
+    std::vector<cpp2::ColumnValue> cols(5);
+    cols[0].set_id(3);
+    cols[1].set_str("Tom");
+    cols[2].set_integer(20);
+    cols[3].set_double_precision(70.5);
+    cols[4].set_bool_val(true);
+    value.set_columns(std::move(cols));
+    ASSERT_TRUE(result.addRow(value).ok());
+    ASSERT_EQ(2, result.rowsNum());
+
+    auto vids = result.getVIDs("id");
+    ASSERT_TRUE(vids.ok());
+    ASSERT_EQ(std::vector<VertexID>({1, 3}), vids.value());
+    ASSERT_EQ("Tom", boost::get<std::string>(result.getColumn(1, 1)));
+}
+
+
+TEST(InterimResultTest, ShareRowsTest) {
+    auto schema = genSchema();
+    std::unique_ptr<InterimResult> result;
+    {
+        auto inputs = std::make_unique<InterimResult>();
+        inputs->setSchema(schema);
+        for (auto i = 0; i < 100; i++) {
+            std::vector<VariantType> row = {static_cast<int64_t>(i),
+                                            folly::stringPrintf("name_%03d", 99 - i),
+                                            static_cast<int64_t>(i % 10),
+                                            0.1 * i,
+                                            i % 2 == 0};
+            ASSERT_TRUE(inputs->addRow(row).ok());
+        }
+
+        // Sort by the name, as OrderBy does
+        std::vector<uint32_t> indices(inputs->rowsNum());
+        for (auto i = 0u; i < indices.size(); i++) {
+            indices[i] = i;
+        }
+        std::sort(indices.begin(), indices.end(), [&inputs] (uint32_t lhs, uint32_t rhs) {
+            return inputs->compare(1, lhs, rhs) < 0;
+        });
+        result = std::make_unique<InterimResult>();
+        result->setSchema(schema);
+        for (auto index : indices) {
+            result->addRow(*inputs, index);
+        }
+    }
+
+    // The strings are still alive after the inputs are gone
+    ASSERT_EQ(100, result->rowsNum());
+    for (auto i = 0; i < 100; i++) {
+        ASSERT_EQ(folly::stringPrintf("name_%03d", i),
+                  boost::get<std::string>(result->getColumn(i, 1)));
+        ASSERT_EQ(99 - i, boost::get<int64_t>(result->getColumn(i, 0)));
+    }
+}
+
+
+TEST(InterimResultTest, SortKeyTest) {
+    auto schema = std::make_shared<SchemaWriter>();
+    schema->appendCol("age", nebula::cpp2::SupportedType::INT);
+    schema->appendCol("name", nebula::cpp2::SupportedType::STRING);
+    schema->appendCol("score", nebula::cpp2::SupportedType::DOUBLE);
+    InterimResult result;
+    result.setSchema(schema);
+    std::vector<std::vector<VariantType>> rows = {
+        {-5L, std::string("a"), -1.5},
+        {3L, std::string(""), 0.0},
+        {-100L, std::string("a\0b", 3), -0.0},
+        {100L, std::string("ab"), 2.25},
+        {0L, std::string("a\0", 2), -1000.0},
+    };
+    for (auto &row : rows) {
+        ASSERT_TRUE(result.addRow(row).ok());
+    }
+
+    // The keys are ordered as the values of each column, in both orders
+    for (auto col = 0u; col < 3; col++) {
+        for (auto descend : {false, true}) {
+            for (auto lhs = 0u; lhs < rows.size(); lhs++) {
+                for (auto rhs = 0u; rhs < rows.size(); rhs++) {
+                    std::string lkey;
+                    std::string rkey;
+                    result.encodeSortKey(col, lhs, descend, lkey);
+                    result.encodeSortKey(col, rhs, descend, rkey);
+                    auto expected = result.compare(col, lhs, rhs);
+                    auto actual = lkey.compare(rkey);
+                    if (descend) {
+                        expected = -expected;
+                    }
+                    ASSERT_EQ(expected < 0, actual < 0) << col << " " << lhs << " " << rhs;
+                    ASSERT_EQ(expected == 0, actual == 0) << col << " " << lhs << " " << rhs;
+                }
+            }
+        }
+    }
+
+    // A string is before the ones it is a prefix of, whatever follows in the key
+    std::string lkey;
+    std::string rkey;
+    result.encodeSortKey(1, 0, false, lkey);
+    result.encodeSortKey(0, 3, false, lkey);
+    result.encodeSortKey(1, 3, false, rkey);
+    result.encodeSortKey(0, 0, false, rkey);
+    ASSERT_LT(lkey, rkey);
+}
+
+
+TEST(InterimResultTest, BuildIndexTest) {
+    InterimResult result({"id", "name", "age", "score", "male"});
+    result.setSchema(genSchema());
+    for (auto i = 0; i < 10; i++) {
+        std::vector<VariantType> row = {static_cast<int64_t>(i * 100),
+                                        folly::stringPrintf("name_%d", i),
+                                        static_cast<int64_t>(i),
+                                        0.5 * i,
+                                        false};
+        ASSERT_TRUE(result.addRow(row).ok());
+    }
+    ASSERT_FALSE(result.buildIndex("name").ok());
+
+    auto ret = result.buildIndex("id");
+    ASSERT_TRUE(ret.ok());
+    auto index = std::move(ret).value();
+    auto age = index->getColumnWithVID(300, "age");
+    ASSERT_TRUE(age.ok());
+    ASSERT_EQ(3, boost::get<int64_t>(age.value()));
+    auto name = index->getColumnWithVID(500, "name");
+    ASSERT_TRUE(name.ok());
+    ASSERT_EQ("name_5", boost::get<std::string>(name.value()));
+    ASSERT_FALSE(index->getColumnWithVID(500, "not_exist").ok());
+    ASSERT_EQ(nebula::cpp2::SupportedType::DOUBLE, index->getColumnType("score"));
+}
+
+}   // namespace graph
+}   // namespace nebula
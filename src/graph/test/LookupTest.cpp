@@ -687,5 +687,82 @@ TEST_F(LookupTest, FunctionExprTest) {
     }
 }
 
+TEST_F(LookupTest, ConstantOnTheLeft) {
+    {
+        cpp2::ExecutionResponse resp;
+        auto query = "INSERT VERTEX lookup_tag_2(col1, col2, col3, col4) VALUES "
+                     "220:(\"col1_220\", 100, 100.5, true), "
+                     "221:(\"col1_221\", 200, 200.5, true), "
+                     "222:(\"col1_222\", 300, 300.5, true), "
+                     "223:(\"col1_223\", 400, 400.5, true), "
+                     "224:(\"col1_224\", 500, 500.5, true), "
+                     "225:(\"col1_225\", 600, 600.5, true)";
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+    }
+    // The range is bounded as if the prop were on the left
+    {
+        cpp2::ExecutionResponse resp;
+        auto query = "LOOKUP ON lookup_tag_2 WHERE 300 > lookup_tag_2.col2";
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<VertexID>> expected = {
+            {220},
+            {221}
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto query = "LOOKUP ON lookup_tag_2 WHERE 300 >= lookup_tag_2.col2";
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<VertexID>> expected = {
+            {220},
+            {221},
+            {222}
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto query = "LOOKUP ON lookup_tag_2 WHERE 300 < lookup_tag_2.col2";
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<VertexID>> expected = {
+            {223},
+            {224},
+            {225}
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto query = "LOOKUP ON lookup_tag_2 WHERE 300 <= lookup_tag_2.col2";
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<VertexID>> expected = {
+            {222},
+            {223},
+            {224},
+            {225}
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+    {
+        cpp2::ExecutionResponse resp;
+        auto query = "LOOKUP ON lookup_tag_2 WHERE 100 < lookup_tag_2.col2 "
+                     "AND 400 >= lookup_tag_2.col2";
+        auto code = client_->execute(query, resp);
+        ASSERT_EQ(cpp2::ErrorCode::SUCCEEDED, code);
+        std::vector<std::tuple<VertexID>> expected = {
+            {221},
+            {222},
+            {223}
+        };
+        ASSERT_TRUE(verifyResult(resp, expected));
+    }
+}
+
 }   // namespace graph
 }   // namespace nebula
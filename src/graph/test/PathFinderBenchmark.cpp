@@ -0,0 +1,86 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include "graph/PathFinder.h"
+
+DEFINE_int32(vertices, 100000, "Number of the vertices of the random graph");
+DEFINE_int32(degree, 8, "Out-degree of each vertex of the random graph");
+
+using nebula::graph::Frontiers;
+using nebula::graph::Neighbors;
+using nebula::graph::PathFinder;
+
+// The out-neighbors, and the in-neighbors with the reversed edge types
+static std::vector<Neighbors> outEdges;     // NOLINT
+static std::vector<Neighbors> inEdges;      // NOLINT
+static std::vector<std::pair<VertexID, VertexID>> queries;     // NOLINT
+
+void prepareGraph() {
+    std::mt19937 random(0);
+    outEdges.resize(FLAGS_vertices);
+    inEdges.resize(FLAGS_vertices);
+    for (VertexID src = 0; src < FLAGS_vertices; src++) {
+        for (auto i = 0; i < FLAGS_degree; i++) {
+            VertexID dst = random() % FLAGS_vertices;
+            EdgeType type = random() % 2 + 1;
+            outEdges[src].emplace_back(dst, type, 0);
+            inEdges[dst].emplace_back(src, -type, 0);
+        }
+    }
+    for (auto i = 0; i < 1000; i++) {
+        queries.emplace_back(random() % FLAGS_vertices, random() % FLAGS_vertices);
+    }
+}
+
+size_t findPath(size_t query, uint32_t steps, bool shortest) {
+    auto &pair = queries[query % queries.size()];
+    PathFinder finder({pair.first}, {pair.second}, steps, shortest);
+    while (!finder.finished()) {
+        auto &edges = finder.isFromNext() ? outEdges : inEdges;
+        Frontiers frontiers;
+        for (auto vid : finder.frontier()) {
+            frontiers.emplace_back(vid, edges[vid]);
+        }
+        finder.expand(frontiers);
+    }
+    return finder.paths().size();
+}
+
+BENCHMARK(ShortestPath_6Hops, iters) {
+    size_t paths = 0;
+    for (size_t i = 0; i < iters; i++) {
+        paths += findPath(i, 6, true);
+    }
+    folly::doNotOptimizeAway(paths);
+}
+
+BENCHMARK(AllPath_4Hops, iters) {
+    size_t paths = 0;
+    for (size_t i = 0; i < iters; i++) {
+        paths += findPath(i, 4, false);
+    }
+    folly::doNotOptimizeAway(paths);
+}
+
+BENCHMARK(AllPath_6Hops, iters) {
+    size_t paths = 0;
+    for (size_t i = 0; i < iters; i++) {
+        paths += findPath(i, 6, false);
+    }
+    folly::doNotOptimizeAway(paths);
+}
+
+
+int main(int argc, char** argv) {
+    folly::init(&argc, &argv, true);
+
+    prepareGraph();
+
+    folly::runBenchmarks();
+    return 0;
+}
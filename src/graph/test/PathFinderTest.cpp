@@ -0,0 +1,182 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "graph/PathFinder.h"
+
+namespace nebula {
+namespace graph {
+
+struct Graph {
+    std::unordered_map<VertexID, Neighbors>     outEdges;
+    // The in-neighbors with the reversed edge types, as the storage returns
+    std::unordered_map<VertexID, Neighbors>     inEdges;
+
+    void addEdge(VertexID src, VertexID dst, EdgeType type, EdgeRanking rank = 0) {
+        outEdges[src].emplace_back(dst, type, rank);
+        inEdges[dst].emplace_back(src, -type, rank);
+    }
+};
+
+static std::string toString(const PathFinder::Path &path) {
+    std::string str;
+    for (auto &step : path) {
+        str += folly::to<std::string>(std::get<0>(step));
+        if (std::get<1>(step) != 0) {
+            str += folly::stringPrintf("<%d,%ld>", std::get<1>(step), std::get<2>(step));
+        }
+    }
+    return str;
+}
+
+static std::vector<std::string> findPath(const Graph &graph,
+                                         const std::vector<VertexID> &from,
+                                         const std::vector<VertexID> &to,
+                                         uint32_t steps,
+                                         bool shortest) {
+    PathFinder finder(from, to, steps, shortest);
+    while (!finder.finished()) {
+        auto &edges = finder.isFromNext() ? graph.outEdges : graph.inEdges;
+        Frontiers frontiers;
+        for (auto vid : finder.frontier()) {
+            auto iter = edges.find(vid);
+            if (iter != edges.end()) {
+                frontiers.emplace_back(vid, iter->second);
+            }
+        }
+        finder.expand(frontiers);
+    }
+    std::vector<std::string> paths;
+    for (auto &path : finder.paths()) {
+        paths.emplace_back(toString(path));
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+// All the paths including the loops, keyed by the target, found by DFS from the sources
+static void walk(const Graph &graph,
+                 const std::set<VertexID> &targets,
+                 uint32_t steps,
+                 PathFinder::Path &path,
+                 std::map<VertexID, std::vector<PathFinder::Path>> &paths) {
+    auto vid = std::get<0>(path.back());
+    if (path.size() > 1 && targets.count(vid) != 0) {
+        paths[vid].emplace_back(path);
+    }
+    auto iter = graph.outEdges.find(vid);
+    if (path.size() > steps || iter == graph.outEdges.end()) {
+        return;
+    }
+    for (auto &neighbor : iter->second) {
+        std::get<1>(path.back()) = std::get<1>(neighbor);
+        std::get<2>(path.back()) = std::get<2>(neighbor);
+        path.emplace_back(std::get<0>(neighbor), 0, 0);
+        walk(graph, targets, steps, path, paths);
+        path.pop_back();
+    }
+    std::get<1>(path.back()) = 0;
+    std::get<2>(path.back()) = 0;
+}
+
+static std::vector<std::string> findPathByDFS(const Graph &graph,
+                                              const std::vector<VertexID> &from,
+                                              const std::vector<VertexID> &to,
+                                              uint32_t steps,
+                                              bool shortest) {
+    std::set<VertexID> sources(from.begin(), from.end());
+    std::set<VertexID> targets(to.begin(), to.end());
+    std::map<VertexID, std::vector<PathFinder::Path>> paths;
+    for (auto vid : sources) {
+        PathFinder::Path path = {PathFinder::Step(vid, 0, 0)};
+        walk(graph, targets, steps, path, paths);
+    }
+    std::vector<std::string> results;
+    for (auto &target : paths) {
+        size_t length = std::numeric_limits<size_t>::max();
+        for (auto &path : target.second) {
+            length = std::min(length, path.size());
+        }
+        for (auto &path : target.second) {
+            if (!shortest || path.size() == length) {
+                results.emplace_back(toString(path));
+            }
+        }
+    }
+    std::sort(results.begin(), results.end());
+    return results;
+}
+
+
+TEST(PathFinderTest, ShortestTest) {
+    // 1 -> 2 -> 3 -> 4, 1 -> 5 -> 4, 1 -> 5 => 4, 4 -> 1, 6 -> 2
+    Graph graph;
+    graph.addEdge(1, 2, 1);
+    graph.addEdge(2, 3, 1);
+    graph.addEdge(3, 4, 1);
+    graph.addEdge(1, 5, 1);
+    graph.addEdge(5, 4, 1);
+    graph.addEdge(5, 4, 2, 7);
+    graph.addEdge(4, 1, 1);
+    graph.addEdge(6, 2, 1);
+
+    std::vector<std::string> expected = {"1<1,0>5<1,0>4", "1<1,0>5<2,7>4"};
+    ASSERT_EQ(expected, findPath(graph, {1}, {4}, 5, true));
+    // Too far
+    ASSERT_TRUE(findPath(graph, {1}, {4}, 1, true).empty());
+    // The shortest paths to each target, from any of the sources
+    expected = {"1<1,0>2<1,0>3", "1<1,0>5<1,0>4", "1<1,0>5<2,7>4", "6<1,0>2<1,0>3"};
+    ASSERT_EQ(expected, findPath(graph, {1, 6}, {3, 4}, 5, true));
+    // No path back, nor to the vertex not exist
+    ASSERT_TRUE(findPath(graph, {3}, {6, 100}, 5, true).empty());
+    ASSERT_TRUE(findPath(graph, {100}, {1}, 5, true).empty());
+}
+
+
+TEST(PathFinderTest, AllTest) {
+    Graph graph;
+    graph.addEdge(1, 2, 1);
+    graph.addEdge(2, 1, 1);
+    graph.addEdge(2, 3, 1);
+    graph.addEdge(1, 3, 2);
+
+    std::vector<std::string> expected = {
+        "1<1,0>2<1,0>1<1,0>2<1,0>3",
+        "1<1,0>2<1,0>1<2,0>3",
+        "1<1,0>2<1,0>3",
+        "1<2,0>3",
+    };
+    ASSERT_EQ(expected, findPath(graph, {1}, {3}, 4, false));
+    expected = {"1<1,0>2<1,0>3", "1<2,0>3"};
+    ASSERT_EQ(expected, findPath(graph, {1}, {3}, 2, false));
+}
+
+
+TEST(PathFinderTest, RandomTest) {
+    for (auto seed = 0; seed < 20; seed++) {
+        std::mt19937 random(seed);
+        Graph graph;
+        for (auto i = 0; i < 60; i++) {
+            VertexID src = random() % 30;
+            VertexID dst = random() % 30;
+            EdgeType type = random() % 2 + 1;
+            graph.addEdge(src, dst, type, random() % 2);
+        }
+        std::vector<VertexID> from = {0, 1};
+        std::vector<VertexID> to = {2, 3, 4, 1};
+        for (auto steps : {1, 2, 3, 4, 5}) {
+            for (auto shortest : {true, false}) {
+                ASSERT_EQ(findPathByDFS(graph, from, to, steps, shortest),
+                          findPath(graph, from, to, steps, shortest))
+                    << "seed " << seed << ", steps " << steps << ", shortest " << shortest;
+            }
+        }
+    }
+}
+
+}   // namespace graph
+}   // namespace nebula
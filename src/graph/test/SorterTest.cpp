@@ -0,0 +1,85 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "fs/TempDir.h"
+#include "graph/GraphFlags.h"
+#include "graph/Sorter.h"
+
+namespace nebula {
+namespace graph {
+
+// The key of the row i, in which every 7 rows have the same keys
+static std::string genKey(uint32_t i) {
+    return folly::stringPrintf("key_%05u", (i * 7919) % 10007 / 7);
+}
+
+// Sort the rows 0..num-1 by their keys, which are ordered stably
+static std::vector<uint32_t> sort(uint32_t num, int64_t budget, int64_t limit, size_t *runs) {
+    Sorter sorter(budget, limit);
+    for (auto i = 0u; i < num; i++) {
+        auto status = sorter.add(genKey(i), i);
+        EXPECT_TRUE(status.ok()) << status;
+    }
+    if (runs != nullptr) {
+        *runs = sorter.runsNum();
+    }
+    std::vector<uint32_t> rows;
+    auto status = sorter.finish([&rows] (uint32_t row) {
+        rows.emplace_back(row);
+    });
+    EXPECT_TRUE(status.ok()) << status;
+    return rows;
+}
+
+
+static std::vector<uint32_t> expectedRows(uint32_t num, int64_t limit) {
+    std::vector<uint32_t> rows(num);
+    for (auto i = 0u; i < num; i++) {
+        rows[i] = i;
+    }
+    std::stable_sort(rows.begin(), rows.end(), [] (uint32_t lhs, uint32_t rhs) {
+        return genKey(lhs) < genKey(rhs);
+    });
+    if (limit >= 0 && limit < static_cast<int64_t>(num)) {
+        rows.resize(limit);
+    }
+    return rows;
+}
+
+
+TEST(SorterTest, SortTest) {
+    size_t runs = 0;
+    ASSERT_EQ(expectedRows(10000, -1), sort(10000, 256 * 1024 * 1024, -1, &runs));
+    ASSERT_EQ(0, runs);
+    ASSERT_TRUE(sort(0, 256 * 1024 * 1024, -1, nullptr).empty());
+}
+
+
+TEST(SorterTest, TopKTest) {
+    for (auto limit : {0, 1, 10, 9999, 10000, 20000}) {
+        ASSERT_EQ(expectedRows(10000, limit), sort(10000, 0, limit, nullptr)) << limit;
+    }
+}
+
+
+TEST(SorterTest, SpillTest) {
+    fs::TempDir dir("/tmp/sorter_test.XXXXXX");
+    FLAGS_query_spill_path = dir.path();
+
+    size_t runs = 0;
+    // Spill every 1024 rows, the runs are merged at once
+    ASSERT_EQ(expectedRows(10000, -1), sort(10000, 0, -1, &runs));
+    ASSERT_EQ(9, runs);
+
+    // The runs are merged into fewer ones first
+    ASSERT_EQ(expectedRows(50000, -1), sort(50000, 0, -1, &runs));
+    ASSERT_EQ(48, runs);
+}
+
+}   // namespace graph
+}   // namespace nebula
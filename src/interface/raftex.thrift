@@ -8,8 +8,12 @@ namespace cpp nebula.raftex
 namespace java com.vesoft.nebula.raftex
 namespace go nebula.raftex
 
+cpp_include "<folly/io/IOBuf.h>"
+
 include "common.thrift"
 
+typedef binary (cpp.type = "folly::IOBuf") IOBuf
+
 enum ErrorCode {
     SUCCEEDED = 0;
 
@@ -62,7 +66,8 @@ struct AskForVoteResponse {
 
 struct LogEntry {
     1: common.ClusterID cluster;
-    2: binary           log_str;
+    // Shares the log in the wal buffer of the leader without copying
+    2: IOBuf            log_str;
 }
 
 
@@ -116,6 +121,13 @@ struct AppendLogResponse {
     7: TermID              last_log_term;
 }
 
+// A chunk of one sst file of the snapshot, written at the offset of the file
+struct SnapshotFile {
+    1: string   name;
+    2: i64      offset;
+    3: binary   data;
+}
+
 struct SendSnapshotRequest {
     1:  common.GraphSpaceID space;
     2:  common.PartitionID  part;
@@ -128,16 +140,37 @@ struct SendSnapshotRequest {
     9:  i64                 total_size;
     10: i64                 total_count;
     11: bool                done;
+    // The snapshot is sent as sst files instead of rows, which are ingested when done
+    12: optional SnapshotFile file;
 }
 
 struct SendSnapshotResponse {
     1: ErrorCode    error_code;
 }
 
+
+/*
+  A follower asks the leader for the read index before serving a read. The leader
+  returns its committed log id if it still holds the lease of the term, the read is
+  linearizable once the follower has committed up to it.
+*/
+struct GetReadIndexRequest {
+    1: common.GraphSpaceID space;
+    2: common.PartitionID  part;
+    3: TermID              current_term;
+}
+
+struct GetReadIndexResponse {
+    1: ErrorCode           error_code;
+    2: TermID              current_term;
+    3: LogID               committed_log_id;
+}
+
 service RaftexService {
     AskForVoteResponse askForVote(1: AskForVoteRequest req);
     AppendLogResponse appendLog(1: AppendLogRequest req);
     SendSnapshotResponse  sendSnapshot(1: SendSnapshotRequest req);
+    GetReadIndexResponse  getReadIndex(1: GetReadIndexRequest req);
 }
 
 
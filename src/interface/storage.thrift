@@ -148,6 +148,8 @@ struct QueryResponse {
     3: optional map<common.EdgeType, common.Schema>(cpp.template = "std::unordered_map")    edge_schema,
     4: optional list<VertexData> vertices,
     5: optional i32 total_edges,
+    // The cursor of the next page of a paged getBound, unset on the last page
+    6: optional binary next_cursor,
 }
 
 struct ExecResponse {
@@ -184,6 +186,10 @@ struct GetNeighborsRequest {
     3: list<common.EdgeType> edge_types,
     4: binary filter,
     5: list<PropDef> return_columns,
+    // Only used by getBound. When limit > 0, only the edges of at most limit vertices,
+    // starting from the cursor, are returned, with the next_cursor if there are more.
+    6: optional i32 limit,
+    7: optional binary cursor,
 }
 
 struct VertexPropRequest {
@@ -207,6 +213,10 @@ struct AddVerticesRequest {
     2: map<common.PartitionID, list<Vertex>>(cpp.template = "std::unordered_map") parts,
     // If true, it equals an upsert operation.
     3: bool overwritable,
+    // If true, the index entries of the vertices are inserted without reading their old
+    // rows. Only for the append-only data, e.g. bulk loading, since the index entries of
+    // an overwritten row are left behind.
+    4: bool index_blind_write = false,
 }
 
 struct AddEdgesRequest {
@@ -215,6 +225,8 @@ struct AddEdgesRequest {
     2: map<common.PartitionID, list<Edge>>(cpp.template = "std::unordered_map") parts,
     // If true, it equals an upsert operation.
     3: bool overwritable,
+    // The same as the one of AddVerticesRequest
+    4: bool index_blind_write = false,
 }
 
 struct DeleteVerticesRequest {
@@ -464,6 +476,24 @@ struct LookUpIndexRequest {
     5: list<string>              return_columns,
 }
 
+struct GetPartStatsRequest {
+    1: common.GraphSpaceID       space_id,
+    2: list<common.PartitionID>  parts,
+}
+
+// The approximate statistics of one part
+struct PartStats {
+    1: map<common.TagID, i64> (cpp.template = "std::unordered_map")         tag_vertices,
+    2: map<common.EdgeType, i64> (cpp.template = "std::unordered_map")      edge_counts,
+    // The i-th bucket counts the vertices whose out degree is in [2^i, 2^(i+1))
+    3: map<common.EdgeType, list<i64>> (cpp.template = "std::unordered_map") degree_histograms,
+}
+
+struct GetPartStatsResponse {
+    1: required ResponseCommon result,
+    2: map<common.PartitionID, PartStats> (cpp.template = "std::unordered_map") stats,
+}
+
 service StorageService {
     QueryResponse getBound(1: GetNeighborsRequest req)
 
@@ -485,6 +515,8 @@ service StorageService {
     ScanEdgeResponse scanEdge(1: ScanEdgeRequest req)
     ScanVertexResponse scanVertex(1: ScanVertexRequest req)
 
+    GetPartStatsResponse getPartStats(1: GetPartStatsRequest req)
+
     // Interfaces for admin operations
     AdminExecResp transLeader(1: TransLeaderReq req);
     AdminExecResp addPart(1: AddPartReq req);
@@ -23,6 +23,15 @@ enum class ResultType {
     E_DATA_INVALID = -5,
 };
 
+/**
+ * The header byte of an encoded row is
+ *   bits 0-2 : the number of bytes for each offset - 1
+ *   bit  3   : set for the rows with the offsets of every field (V2), which are
+ *              written for the spaces in --fixed_offset_row_spaces
+ *   bits 5-7 : the number of bytes for the schema version
+ * */
+constexpr uint8_t kRowFormatV2Bit = 0x08;
+
 template<typename IntType>
 typename std::enable_if<
     std::is_integral<
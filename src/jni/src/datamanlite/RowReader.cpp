@@ -182,9 +182,14 @@ bool RowReader::processHeader(Slice row) {
     // schena version. If the number is zero, no schema version
     // presents
     numBytesForOffset_ = (*it & 0x07) + 1;
+    bool fieldOffsets = (*it & kRowFormatV2Bit) != 0;
     int32_t verBytes = *(it++) >> 5;
     it += verBytes;
 
+    if (fieldOffsets) {
+        return processFieldOffsets(row, it, verBytes);
+    }
+
     // Process the block offsets
     // Block offsets point to the start of every 16 fields, except the
     // first 16 fields
@@ -217,6 +222,37 @@ bool RowReader::processHeader(Slice row) {
 }
 
 
+bool RowReader::processFieldOffsets(Slice row, const uint8_t* it, int32_t verBytes) {
+    // The offsets of all fields except the first one are stored
+    // in Little Endian, so every field could be located directly
+    uint32_t numFields = schema_->getNumFields();
+    uint32_t numOffsets = numFields > 0 ? numFields - 1 : 0;
+    if (numBytesForOffset_ * numOffsets + verBytes + 1 > row.size()) {
+        // Data is too short
+        return false;
+    }
+    offsets_.resize(numFields + 1, -1);
+    offsets_[0] = 0;
+    for (uint32_t i = 1; i <= numOffsets; i++) {
+        int64_t offset = 0;
+        for (int32_t j = 0; j < numBytesForOffset_; j++) {
+            offset |= (uint64_t(*(it++)) << (8 * j));
+        }
+        offsets_[i] = offset;
+    }
+    headerLen_ = reinterpret_cast<const char*>(it) - row.begin();
+    offsets_[numFields] = row.size() - headerLen_;
+
+    // Mark all fields in every block as visited, so no field will be skipped
+    uint32_t numBlocks = (numFields >> 4) + 1;
+    blockOffsets_.reserve(numBlocks);
+    for (uint32_t i = 0; i < numBlocks; i++) {
+        blockOffsets_.emplace_back(offsets_[i << 4], 0x0F);
+    }
+    return true;
+}
+
+
 int32_t RowReader::numFields() const noexcept {
     return schema_->getNumFields();
 }
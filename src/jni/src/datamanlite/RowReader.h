@@ -182,6 +182,10 @@ private:
     // Returns false when the row data is invalid
     bool processBlockOffsets(Slice row, int32_t verBytes);
 
+    // Process the offsets of all fields of the V2 rows
+    // Returns false when the row data is invalid
+    bool processFieldOffsets(Slice row, const uint8_t* it, int32_t verBytes);
+
     // Skip to the next field
     // Parameter:
     //  index   : the current field index
@@ -260,6 +260,44 @@ TEST(RowReader, iterator) {
     EXPECT_EQ(it, reader->end());
 }
 
+TEST(RowReader, fieldOffsets) {
+    auto schema = std::make_shared<NebulaSchemaProvider>();
+    schema->addField(Slice("int_col"), ValueType::INT);
+    schema->addField(Slice("str_col"), ValueType::STRING);
+    schema->addField(Slice("bool_col"), ValueType::BOOL);
+
+    // The V2 header with one byte for each offset, then the offsets of
+    // col 1 and col 2
+    char data[] = {0x08, 0x01, 0x05,
+                   0x07,
+                   0x03, 'a', 'b', 'c',
+                   0x01};
+    auto reader = RowReader::getRowReader(Slice(data, sizeof(data)), schema);
+
+    // Any field is read without the ones before it
+    bool bVal;
+    EXPECT_EQ(ResultType::SUCCEEDED, reader->getBool(2, bVal));
+    EXPECT_TRUE(bVal);
+    Slice sVal;
+    EXPECT_EQ(ResultType::SUCCEEDED, reader->getString(1, sVal));
+    EXPECT_EQ("abc", sVal.toString());
+    int64_t iVal;
+    EXPECT_EQ(ResultType::SUCCEEDED, reader->getInt(0, iVal));
+    EXPECT_EQ(7, iVal);
+
+    auto it = reader->begin();
+    EXPECT_EQ(ResultType::SUCCEEDED, it->getInt(iVal));
+    EXPECT_EQ(7, iVal);
+    ++it;
+    EXPECT_EQ(ResultType::SUCCEEDED, it->getString(sVal));
+    EXPECT_EQ("abc", sVal.toString());
+    ++it;
+    EXPECT_EQ(ResultType::SUCCEEDED, it->getBool(bVal));
+    EXPECT_TRUE(bVal);
+    ++it;
+    EXPECT_EQ(it, reader->end());
+}
+
 }  // namespace codec
 }  // namespace dataman
 }  // namespace nebula
@@ -0,0 +1,65 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef KVSTORE_COMMITLISTENER_H_
+#define KVSTORE_COMMITLISTENER_H_
+
+#include "base/Base.h"
+#include "kvstore/Common.h"
+#include "kvstore/KVEngine.h"
+
+namespace nebula {
+namespace kvstore {
+
+/**
+ * Watches the writes committed on one part, on the leader and the followers alike.
+ *
+ * Part::commitLogs calls it back with every key written by the logs in a commit, then
+ * onCommit() before the batch is written, so the listener could put its own state into the
+ * same batch, and onCommitted() once the batch is written or failed. All the calls of a part
+ * are made by its commit thread, one commit at a time.
+ * */
+class PartCommitListener {
+public:
+    virtual ~PartCommitListener() = default;
+
+    virtual void onPut(folly::StringPiece key) = 0;
+
+    virtual void onRemove(folly::StringPiece key) = 0;
+
+    // Called before the prefix is removed, so the keys removed could still be read
+    virtual void onRemovePrefix(folly::StringPiece prefix) = 0;
+
+    // Called before the range [start, end) is removed
+    virtual void onRemoveRange(folly::StringPiece start, folly::StringPiece end) = 0;
+
+    virtual ResultCode onCommit(WriteBatch* batch) = 0;
+
+    virtual void onCommitted(bool succeeded) = 0;
+
+    // The part is cleaned up, drop the state kept for it
+    virtual void onReset() = 0;
+
+    // The files of a snapshot are ingested into the part, whose keys are not called back
+    virtual void onIngested() = 0;
+};
+
+class CommitListenerFactory {
+public:
+    virtual ~CommitListenerFactory() = default;
+
+    /**
+     * Create the listener of a part when it is opened. Return nullptr if the part is not
+     * watched.
+     * */
+    virtual std::unique_ptr<PartCommitListener> create(GraphSpaceID spaceId,
+                                                       PartitionID partId,
+                                                       KVEngine* engine) = 0;
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+#endif  // KVSTORE_COMMITLISTENER_H_
@@ -46,6 +46,29 @@ public:
                         const folly::StringPiece& val) const = 0;
 };
 
+/**
+ * A consistent point-in-time view of one engine. The engine releases it
+ * when the last reference is gone.
+ * */
+class KVSnapshot {
+public:
+    virtual ~KVSnapshot() = default;
+};
+
+/**
+ * Per request read options passed down to the engine.
+ * */
+struct ReadContext {
+    // Pin all reads to the snapshot, read the latest data if it is nullptr.
+    // The snapshot must come from the engine which serves the read.
+    std::shared_ptr<const KVSnapshot> snapshot_{nullptr};
+    // Full scans should set it to false, to avoid evicting the hot blocks from cache.
+    bool fillCache_{true};
+    // Allow a follower to serve the read. The caller should check the part by
+    // KVStore::readIndex before the reads, or the follower may return stale data.
+    bool followerRead_{false};
+};
+
 using KV = std::pair<std::string, std::string>;
 using KVCallback = folly::Function<void(ResultCode code)>;
 using NewLeaderCallback = folly::Function<void(HostAddr nLeader)>;
@@ -54,6 +77,22 @@ inline rocksdb::Slice toSlice(const folly::StringPiece& str) {
     return rocksdb::Slice(str.begin(), str.size());
 }
 
+/**
+ * Return the smallest key which is greater than all keys starting with prefix,
+ * or an empty string if there is no such key.
+ * */
+inline std::string prefixSuccessor(std::string prefix) {
+    while (!prefix.empty()) {
+        auto c = static_cast<uint8_t>(prefix.back());
+        if (c != 0xFF) {
+            prefix.back() = static_cast<char>(c + 1);
+            return prefix;
+        }
+        prefix.pop_back();
+    }
+    return prefix;
+}
+
 using KVMap = std::unordered_map<std::string, std::string>;
 using KVArrayIterator = std::vector<KV>::const_iterator;
 
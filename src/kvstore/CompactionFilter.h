@@ -55,13 +55,13 @@ public:
         if (context.is_full_compaction) {
             LOG(INFO) << "Do full compaction!";
             lastRunCustomFilterTimeSec_ = now;
-            return std::make_unique<KVCompactionFilter>(spaceId_, createKVFilter());
+            return std::make_unique<KVCompactionFilter>(spaceId_, createKVFilter(true));
         } else {
             if (customFilterIntervalSecs_ >= 0
                     && now - lastRunCustomFilterTimeSec_ > customFilterIntervalSecs_) {
                 LOG(INFO) << "Do custom minor compaction!";
                 lastRunCustomFilterTimeSec_ = now;
-                return std::make_unique<KVCompactionFilter>(spaceId_, createKVFilter());
+                return std::make_unique<KVCompactionFilter>(spaceId_, createKVFilter(false));
             }
             LOG(INFO) << "Do default minor compaction!";
             return std::unique_ptr<rocksdb::CompactionFilter>(nullptr);
@@ -72,7 +72,7 @@ public:
         return "KVCompactionFilterFactory";
     }
 
-    virtual std::unique_ptr<KVFilter> createKVFilter() = 0;
+    virtual std::unique_ptr<KVFilter> createKVFilter(bool fullCompaction) = 0;
 
 private:
     GraphSpaceID spaceId_;
@@ -55,18 +55,41 @@ public:
                                          std::vector<std::string>* values) = 0;
 
     // Get all results in range [start, end)
+    ResultCode range(const std::string& start,
+                     const std::string& end,
+                     std::unique_ptr<KVIterator>* iter) {
+        return range(start, end, iter, ReadContext());
+    }
+
     virtual ResultCode range(const std::string& start,
                              const std::string& end,
-                             std::unique_ptr<KVIterator>* iter) = 0;
+                             std::unique_ptr<KVIterator>* iter,
+                             const ReadContext& ctx) = 0;
 
     // Get all results with 'prefix' str as prefix.
+    ResultCode prefix(const std::string& prefix,
+                      std::unique_ptr<KVIterator>* iter) {
+        return this->prefix(prefix, iter, ReadContext());
+    }
+
     virtual ResultCode prefix(const std::string& prefix,
-                              std::unique_ptr<KVIterator>* iter) = 0;
+                              std::unique_ptr<KVIterator>* iter,
+                              const ReadContext& ctx) = 0;
 
     // Get all results with 'prefix' str as prefix starting form 'start'
+    ResultCode rangeWithPrefix(const std::string& start,
+                               const std::string& prefix,
+                               std::unique_ptr<KVIterator>* iter) {
+        return rangeWithPrefix(start, prefix, iter, ReadContext());
+    }
+
     virtual ResultCode rangeWithPrefix(const std::string& start,
                                        const std::string& prefix,
-                                       std::unique_ptr<KVIterator>* iter) = 0;
+                                       std::unique_ptr<KVIterator>* iter,
+                                       const ReadContext& ctx) = 0;
+
+    // Take a snapshot of the engine, it could be passed to the reads via ReadContext.
+    virtual std::shared_ptr<const KVSnapshot> getSnapshot() = 0;
 
     // Get all results in range [start, end)
     virtual ResultCode put(std::string key, std::string value) = 0;
@@ -117,6 +140,31 @@ public:
 
     virtual ResultCode createCheckpoint(const std::string& name) = 0;
 
+    /**
+     * The commit log id of the part which the engine holds durably, the logs after it
+     * must be kept in the wal to be replayed. The engines persisting each write hold all.
+     * */
+    virtual LogID durableLogId(PartitionID partId) {
+        UNUSED(partId);
+        return std::numeric_limits<LogID>::max();
+    }
+
+    /**
+     * Dump all the data of the part into sst files under dir, each of about fileSize bytes.
+     * onFile is called with the path once each file is finished, and it could take the file
+     * away, so the files do not pile up. Stop if onFile returns false.
+     * */
+    virtual ResultCode exportPart(PartitionID partId,
+                                  const std::string& dir,
+                                  int64_t fileSize,
+                                  folly::Function<bool(const std::string& file)> onFile) {
+        UNUSED(partId);
+        UNUSED(dir);
+        UNUSED(fileSize);
+        UNUSED(onFile);
+        return ResultCode::ERR_UNSUPPORTED;
+    }
+
 protected:
     GraphSpaceID spaceId_;
 };
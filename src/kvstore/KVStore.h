@@ -15,6 +15,7 @@
 #include "kvstore/KVIterator.h"
 #include "kvstore/PartManager.h"
 #include "kvstore/CompactionFilter.h"
+#include "kvstore/CommitListener.h"
 #include "meta/SchemaManager.h"
 #include "base/ErrorOr.h"
 #include "base/Status.h"
@@ -43,6 +44,10 @@ struct KVOptions {
      * Custom CompactionFilter used in compaction.
      * */
     std::unique_ptr<CompactionFilterFactoryBuilder> cffBuilder_{nullptr};
+    /**
+     * Custom listener of the writes committed on each part.
+     * */
+    std::unique_ptr<CommitListenerFactory> listenerFactory_{nullptr};
 };
 
 
@@ -128,6 +133,59 @@ public:
                                        std::string&& prefix,
                                        std::unique_ptr<KVIterator>* iter) = delete;
 
+    // The overloads below take a ReadContext, the store could ignore it
+    // if it does not support the read options.
+    virtual ResultCode range(GraphSpaceID spaceId,
+                             PartitionID  partId,
+                             const std::string& start,
+                             const std::string& end,
+                             std::unique_ptr<KVIterator>* iter,
+                             const ReadContext& ctx) {
+        UNUSED(ctx);
+        return range(spaceId, partId, start, end, iter);
+    }
+
+    virtual ResultCode prefix(GraphSpaceID spaceId,
+                              PartitionID  partId,
+                              const std::string& prefix,
+                              std::unique_ptr<KVIterator>* iter,
+                              const ReadContext& ctx) {
+        UNUSED(ctx);
+        return this->prefix(spaceId, partId, prefix, iter);
+    }
+
+    virtual ResultCode rangeWithPrefix(GraphSpaceID spaceId,
+                                       PartitionID  partId,
+                                       const std::string& start,
+                                       const std::string& prefix,
+                                       std::unique_ptr<KVIterator>* iter,
+                                       const ReadContext& ctx) {
+        UNUSED(ctx);
+        return rangeWithPrefix(spaceId, partId, start, prefix, iter);
+    }
+
+    // Take a snapshot of the part, all reads with it in ReadContext see the same data.
+    virtual ResultCode getSnapshot(GraphSpaceID spaceId,
+                                   PartitionID partId,
+                                   std::shared_ptr<const KVSnapshot>* snapshot) {
+        UNUSED(spaceId);
+        UNUSED(partId);
+        UNUSED(snapshot);
+        return ResultCode::ERR_UNSUPPORTED;
+    }
+
+    /**
+     * Make sure the local replica of the part could serve the reads with followerRead_
+     * in ReadContext, the leader or a follower which has caught up with the leader.
+     * The follower waits for the leader without blocking, so the parts could be checked
+     * concurrently.
+     * */
+    virtual folly::Future<ResultCode> readIndex(GraphSpaceID spaceId, PartitionID partId) {
+        UNUSED(spaceId);
+        UNUSED(partId);
+        return folly::makeFuture(ResultCode::ERR_UNSUPPORTED);
+    }
+
     virtual ResultCode sync(GraphSpaceID spaceId,
                             PartitionID partId) = 0;
 
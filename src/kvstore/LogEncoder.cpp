@@ -147,28 +147,43 @@ std::string encodeMultiValues(LogType type,
 
 
 std::vector<folly::StringPiece> decodeMultiValues(folly::StringPiece encoded) {
+    std::vector<folly::StringPiece> values;
+    visitMultiValues(encoded, [&values] (folly::StringPiece value) {
+        values.emplace_back(value);
+        return true;
+    });
+    return values;
+}
+
+
+bool visitMultiValues(folly::StringPiece encoded,
+                      folly::FunctionRef<bool(folly::StringPiece)> fn) {
     // Skip the timestamp and the first type byte
     auto* p = encoded.begin() + sizeof(int64_t) + 1;
     uint32_t numValues = *(reinterpret_cast<const uint32_t*>(p));
 
-    std::vector<folly::StringPiece> values;
     p += sizeof(uint32_t);
     for (auto i = 0U; i < numValues; i++) {
         uint32_t len = *(reinterpret_cast<const uint32_t*>(p));
         DCHECK_LE(p + sizeof(uint32_t) + len, encoded.begin() + encoded.size());
-        values.emplace_back(p + sizeof(uint32_t), len);
+        if (!fn(folly::StringPiece(p + sizeof(uint32_t), len))) {
+            return false;
+        }
         p += (sizeof(uint32_t) + len);
     }
     DCHECK_EQ(p, encoded.begin() + encoded.size());
-
-    return values;
+    return true;
 }
 
 std::string
 encodeBatchValue(const std::vector<std::tuple<BatchLogType, std::string, std::string>>& batch) {
     auto type = LogType::OP_BATCH_WRITE;
+    size_t totalLen = kHeadLen;
+    for (auto& op : batch) {
+        totalLen += 1 + 2 * sizeof(uint32_t) + std::get<1>(op).size() + std::get<2>(op).size();
+    }
     std::string encoded;
-    encoded.reserve(1024);
+    encoded.reserve(totalLen);
 
     // Timestamp (8 bytes)
     int64_t ts = time::WallClock::fastNowInMilliSec();
@@ -181,10 +196,10 @@ encodeBatchValue(const std::vector<std::tuple<BatchLogType, std::string, std::st
     // Values
     for (auto& op : batch) {
         auto opType = std::get<0>(op);
-        auto key = std::get<1>(op);
-        auto val = std::get<2>(op);
-        auto keySize = key.size();
-        auto valSize = val.size();
+        const auto& key = std::get<1>(op);
+        const auto& val = std::get<2>(op);
+        uint32_t keySize = key.size();
+        uint32_t valSize = val.size();
         encoded.append(reinterpret_cast<char*>(&opType), 1)
                .append(reinterpret_cast<char*>(&keySize), sizeof(uint32_t))
                .append(key.data(), keySize)
@@ -197,11 +212,22 @@ encodeBatchValue(const std::vector<std::tuple<BatchLogType, std::string, std::st
 
 std::vector<std::pair<BatchLogType, std::pair<folly::StringPiece, folly::StringPiece>>>
 decodeBatchValue(folly::StringPiece encoded) {
+    std::vector<std::pair<BatchLogType, std::pair<folly::StringPiece, folly::StringPiece>>> batch;
+    visitBatchValue(encoded,
+                    [&batch] (BatchLogType type, folly::StringPiece k, folly::StringPiece v) {
+        batch.emplace_back(type, std::make_pair(k, v));
+        return true;
+    });
+    return batch;
+}
+
+bool visitBatchValue(
+        folly::StringPiece encoded,
+        folly::FunctionRef<bool(BatchLogType, folly::StringPiece, folly::StringPiece)> fn) {
     // Skip the timestamp and the first type byte
     auto* p = encoded.begin() + sizeof(int64_t) + 1;
     uint32_t numValues = *(reinterpret_cast<const uint32_t*>(p));
     p += sizeof(uint32_t);
-    std::vector<std::pair<BatchLogType, std::pair<folly::StringPiece, folly::StringPiece>>> batch;
     for (auto i = 0U; i < numValues; i++) {
         auto offset = 0;
         BatchLogType type = *(reinterpret_cast<const BatchLogType *>(p));
@@ -210,12 +236,14 @@ decodeBatchValue(folly::StringPiece encoded) {
         offset += sizeof(uint32_t) + len1;
         uint32_t len2 = *(reinterpret_cast<const uint32_t*>(p + offset));
         offset += sizeof(uint32_t);
-        batch.emplace_back(type, std::pair<folly::StringPiece, folly::StringPiece>
-                (folly::StringPiece(p + sizeof(uint32_t), len1),
-                 folly::StringPiece(p + offset, len2)));
+        if (!fn(type,
+                folly::StringPiece(p + sizeof(uint32_t), len1),
+                folly::StringPiece(p + offset, len2))) {
+            return false;
+        }
         p += offset + len2;
     }
-    return batch;
+    return true;
 }
 
 std::string encodeHost(LogType type, const HostAddr& host) {
@@ -8,6 +8,7 @@
 #define KVSTORE_LOGENCODER_H_
 
 #include "kvstore/Common.h"
+#include <folly/Function.h>
 
 namespace nebula {
 namespace kvstore {
@@ -48,12 +49,24 @@ std::string encodeMultiValues(LogType type,
                               folly::StringPiece v2);
 std::vector<folly::StringPiece> decodeMultiValues(folly::StringPiece encoded);
 
+/**
+ * Visit the values of the encoded log in order without materializing them,
+ * it stops once fn returns false. Returns false if any fn returns false.
+ * */
+bool visitMultiValues(folly::StringPiece encoded,
+                      folly::FunctionRef<bool(folly::StringPiece)> fn);
+
 std::string
 encodeBatchValue(const std::vector<std::tuple<BatchLogType, std::string, std::string>>& batch);
 
 std::vector<std::pair<BatchLogType, std::pair<folly::StringPiece, folly::StringPiece>>>
 decodeBatchValue(folly::StringPiece encoded);
 
+// Visit the operations of the encoded batch in order, like visitMultiValues()
+bool visitBatchValue(
+        folly::StringPiece encoded,
+        folly::FunctionRef<bool(BatchLogType, folly::StringPiece, folly::StringPiece)> fn);
+
 std::string encodeHost(LogType type, const HostAddr& learner);
 HostAddr decodeHost(LogType type, const folly::StringPiece& encoded);
 
@@ -0,0 +1,713 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "kvstore/MemEngine.h"
+#include <folly/FileUtil.h>
+#include <folly/ScopeGuard.h>
+#include <rocksdb/sst_file_reader.h>
+#include <fstream>
+#include "base/NebulaKeyUtils.h"
+#include "fs/FileUtils.h"
+
+DEFINE_int64(memory_engine_gc_writes, 1000000,
+             "Remove the stale versions in the memory engine once there are so many writes "
+             "since the last time");
+DEFINE_int32(memory_engine_gc_batch_keys, 10000,
+             "The keys checked for the stale versions by each write, a round of the garbage "
+             "collection is spread over the writes so none of them is blocked long");
+DEFINE_int32(memory_engine_dump_interval_secs, 60,
+             "Dump the memory engine into the data file in the interval, the raft wal "
+             "is kept until the logs are dumped");
+
+namespace nebula {
+namespace kvstore {
+
+using fs::FileUtils;
+using fs::FileType;
+
+namespace {
+
+constexpr size_t kDumpBufferSize = 4 * 1024 * 1024;
+
+void appendPiece(std::string& buf, folly::StringPiece piece) {
+    int32_t len = piece.size();
+    buf.append(reinterpret_cast<const char*>(&len), sizeof(len));
+    buf.append(piece.data(), piece.size());
+}
+
+bool readPiece(std::ifstream& in, int32_t len, std::string* piece) {
+    piece->resize(len);
+    return len == 0 || !!in.read(&(*piece)[0], len);
+}
+
+MemEntry entryOf(const std::string& key, uint64_t seq) {
+    MemEntry entry;
+    entry.key = key;
+    entry.seq = seq;
+    return entry;
+}
+
+}  // Anonymous namespace
+
+
+/***************************************
+ *
+ * Implementation of WriteBatch
+ *
+ **************************************/
+class MemWriteBatch : public WriteBatch {
+public:
+    ResultCode put(folly::StringPiece key, folly::StringPiece value) override {
+        ops_.emplace_back(MemEngine::Op{MemEngine::Op::Type::PUT, key.str(), value.str()});
+        return ResultCode::SUCCEEDED;
+    }
+
+    ResultCode remove(folly::StringPiece key) override {
+        ops_.emplace_back(MemEngine::Op{MemEngine::Op::Type::REMOVE, key.str(), ""});
+        return ResultCode::SUCCEEDED;
+    }
+
+    ResultCode removePrefix(folly::StringPiece prefix) override {
+        ops_.emplace_back(MemEngine::Op{MemEngine::Op::Type::REMOVE_PREFIX, prefix.str(), ""});
+        return ResultCode::SUCCEEDED;
+    }
+
+    // Remove all keys in the range [start, end)
+    ResultCode removeRange(folly::StringPiece start, folly::StringPiece end) override {
+        ops_.emplace_back(MemEngine::Op{MemEngine::Op::Type::REMOVE_RANGE,
+                                        start.str(),
+                                        end.str()});
+        return ResultCode::SUCCEEDED;
+    }
+
+    std::vector<MemEngine::Op> ops_;
+};
+
+
+MemSnapshot::~MemSnapshot() {
+    engine_->release(seq_);
+}
+
+
+MemIter::MemIter(std::shared_ptr<MemSkipList> list,
+                 const std::string& start,
+                 std::string end,
+                 std::shared_ptr<const MemSnapshot> snapshot)
+        : accessor_(std::move(list))
+        , end_(std::move(end))
+        , snapshot_(std::move(snapshot)) {
+    // The latest visible version of the start key comes first
+    iter_ = accessor_.lower_bound(entryOf(start, snapshot_->seq()));
+    skipInvisible();
+}
+
+
+void MemIter::next() {
+    skipKey();
+    skipInvisible();
+}
+
+
+void MemIter::skipInvisible() {
+    while (iter_ != accessor_.end()) {
+        if (!end_.empty() && iter_->key >= end_) {
+            return;
+        }
+        if (iter_->seq > snapshot_->seq()) {
+            ++iter_;
+            continue;
+        }
+        if (!iter_->deleted) {
+            return;
+        }
+        skipKey();
+    }
+}
+
+
+void MemIter::skipKey() {
+    // The entry is kept alive by the accessor
+    const auto* key = &iter_->key;
+    do {
+        ++iter_;
+    } while (iter_ != accessor_.end() && iter_->key == *key);
+}
+
+
+/***************************************
+ *
+ * Implementation of MemEngine
+ *
+ **************************************/
+MemEngine::MemEngine(GraphSpaceID spaceId, const std::string& dataPath)
+        : KVEngine(spaceId)
+        , dataPath_(folly::stringPrintf("%s/nebula/%d", dataPath.c_str(), spaceId))
+        , list_(MemSkipList::createInstance()) {
+    auto path = folly::stringPrintf("%s/data", dataPath_.c_str());
+    if (FileUtils::fileType(path.c_str()) == FileType::NOTEXIST) {
+        if (!FileUtils::makeDir(path)) {
+            LOG(FATAL) << "makeDir " << path << " failed";
+        }
+    }
+
+    if (FileUtils::fileType(path.c_str()) != FileType::DIRECTORY) {
+        LOG(FATAL) << path << " is not directory";
+    }
+
+    auto file = dataFile();
+    if (FileUtils::exist(file)) {
+        CHECK(load(file)) << "Load the memory engine from " << file << " failed";
+    }
+    dumpedSeq_ = lastSeq_;
+    partsNum_ = allParts().size();
+    LOG(INFO) << "open memory engine on " << path << ", " << lastSeq_ << " keys loaded";
+
+    CHECK(dumper_.start(folly::stringPrintf("mem-dump-%d", spaceId)));
+    dumper_.addRepeatTask(FLAGS_memory_engine_dump_interval_secs * 1000, [this] {
+        if (dumpData() != ResultCode::SUCCEEDED) {
+            LOG(ERROR) << "Dump the memory engine on " << dataPath_ << " failed";
+        }
+    });
+}
+
+
+MemEngine::~MemEngine() {
+    dumper_.stop();
+    dumper_.wait();
+    if (dumpData() != ResultCode::SUCCEEDED) {
+        LOG(ERROR) << "Dump the memory engine on " << dataPath_ << " failed";
+    }
+    LOG(INFO) << "Release memory engine on " << dataPath_;
+}
+
+
+std::unique_ptr<WriteBatch> MemEngine::startBatchWrite() {
+    return std::make_unique<MemWriteBatch>();
+}
+
+
+ResultCode MemEngine::commitBatchWrite(std::unique_ptr<WriteBatch> batch) {
+    auto* b = static_cast<MemWriteBatch*>(batch.get());
+    return write(std::move(b->ops_));
+}
+
+
+std::shared_ptr<const MemSnapshot> MemEngine::acquire(const ReadContext& ctx) {
+    if (ctx.snapshot_ != nullptr) {
+        return std::static_pointer_cast<const MemSnapshot>(ctx.snapshot_);
+    }
+    uint64_t seq;
+    {
+        // Read the sequence under the lock, so the garbage collection would not miss it
+        std::lock_guard<std::mutex> g(snapshotsLock_);
+        seq = visibleSeq_.load(std::memory_order_acquire);
+        snapshots_.emplace(seq);
+    }
+    return std::make_shared<MemSnapshot>(this, seq);
+}
+
+
+void MemEngine::release(uint64_t seq) {
+    std::lock_guard<std::mutex> g(snapshotsLock_);
+    auto it = snapshots_.find(seq);
+    CHECK(it != snapshots_.end());
+    snapshots_.erase(it);
+}
+
+
+ResultCode MemEngine::get(const std::string& key, std::string* value) {
+    auto snapshot = acquire();
+    MemSkipList::Accessor accessor(list_);
+    auto it = accessor.lower_bound(entryOf(key, snapshot->seq()));
+    if (it == accessor.end() || it->key != key || it->deleted) {
+        VLOG(3) << "Get: " << key << " Not Found";
+        return ResultCode::ERR_KEY_NOT_FOUND;
+    }
+    *value = it->value;
+    return ResultCode::SUCCEEDED;
+}
+
+
+std::vector<Status> MemEngine::multiGet(const std::vector<std::string>& keys,
+                                        std::vector<std::string>* values) {
+    std::vector<Status> ret;
+    values->resize(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (get(keys[i], &(*values)[i]) == ResultCode::SUCCEEDED) {
+            ret.emplace_back(Status::OK());
+        } else {
+            ret.emplace_back(Status::KeyNotFound());
+        }
+    }
+    return ret;
+}
+
+
+ResultCode MemEngine::range(const std::string& start,
+                            const std::string& end,
+                            std::unique_ptr<KVIterator>* storageIter,
+                            const ReadContext& ctx) {
+    if (end.empty()) {
+        // Nothing is less than an empty end
+        storageIter->reset(new MemIter(list_, start, start, acquire(ctx)));
+    } else {
+        storageIter->reset(new MemIter(list_, start, end, acquire(ctx)));
+    }
+    return ResultCode::SUCCEEDED;
+}
+
+
+ResultCode MemEngine::prefix(const std::string& prefix,
+                             std::unique_ptr<KVIterator>* storageIter,
+                             const ReadContext& ctx) {
+    // All the keys from the prefix start with it if there is no successor
+    storageIter->reset(new MemIter(list_, prefix, prefixSuccessor(prefix), acquire(ctx)));
+    return ResultCode::SUCCEEDED;
+}
+
+
+ResultCode MemEngine::rangeWithPrefix(const std::string& start,
+                                      const std::string& prefix,
+                                      std::unique_ptr<KVIterator>* storageIter,
+                                      const ReadContext& ctx) {
+    storageIter->reset(new MemIter(list_,
+                                   std::max(start, prefix),
+                                   prefixSuccessor(prefix),
+                                   acquire(ctx)));
+    return ResultCode::SUCCEEDED;
+}
+
+
+std::shared_ptr<const KVSnapshot> MemEngine::getSnapshot() {
+    return acquire();
+}
+
+
+ResultCode MemEngine::put(std::string key, std::string value) {
+    std::vector<Op> ops;
+    ops.emplace_back(Op{Op::Type::PUT, std::move(key), std::move(value)});
+    return write(std::move(ops));
+}
+
+
+ResultCode MemEngine::multiPut(std::vector<KV> keyValues) {
+    std::vector<Op> ops;
+    ops.reserve(keyValues.size());
+    for (auto& kv : keyValues) {
+        ops.emplace_back(Op{Op::Type::PUT, std::move(kv.first), std::move(kv.second)});
+    }
+    return write(std::move(ops));
+}
+
+
+ResultCode MemEngine::remove(const std::string& key) {
+    std::vector<Op> ops;
+    ops.emplace_back(Op{Op::Type::REMOVE, key, ""});
+    return write(std::move(ops));
+}
+
+
+ResultCode MemEngine::multiRemove(std::vector<std::string> keys) {
+    std::vector<Op> ops;
+    ops.reserve(keys.size());
+    for (auto& key : keys) {
+        ops.emplace_back(Op{Op::Type::REMOVE, std::move(key), ""});
+    }
+    return write(std::move(ops));
+}
+
+
+ResultCode MemEngine::removeRange(const std::string& start,
+                                  const std::string& end) {
+    std::vector<Op> ops;
+    ops.emplace_back(Op{Op::Type::REMOVE_RANGE, start, end});
+    return write(std::move(ops));
+}
+
+
+ResultCode MemEngine::removePrefix(const std::string& prefix) {
+    std::vector<Op> ops;
+    ops.emplace_back(Op{Op::Type::REMOVE_PREFIX, prefix, ""});
+    return write(std::move(ops));
+}
+
+
+ResultCode MemEngine::write(std::vector<Op> ops) {
+    std::lock_guard<std::mutex> g(writeLock_);
+    for (auto& op : ops) {
+        switch (op.type) {
+            case Op::Type::PUT:
+                addEntry(std::move(op.first), false, std::move(op.second));
+                break;
+            case Op::Type::REMOVE:
+                addEntry(std::move(op.first), true, "");
+                break;
+            case Op::Type::REMOVE_PREFIX:
+                removeVisible(op.first, prefixSuccessor(op.first));
+                break;
+            case Op::Type::REMOVE_RANGE:
+                if (op.first < op.second) {
+                    removeVisible(op.first, op.second);
+                }
+                break;
+        }
+    }
+    // All the writes are visible at once
+    visibleSeq_.store(lastSeq_, std::memory_order_release);
+    writesSinceGc_ += ops.size();
+    if (writesSinceGc_ >= FLAGS_memory_engine_gc_writes) {
+        collectGarbage(FLAGS_memory_engine_gc_batch_keys);
+    }
+    return ResultCode::SUCCEEDED;
+}
+
+
+void MemEngine::addEntry(std::string key, bool deleted, std::string value) {
+    MemEntry entry;
+    entry.key = std::move(key);
+    entry.seq = ++lastSeq_;
+    entry.deleted = deleted;
+    entry.value = std::move(value);
+    MemSkipList::Accessor accessor(list_);
+    accessor.insert(std::move(entry));
+}
+
+
+void MemEngine::removeVisible(const std::string& start, const std::string& end) {
+    std::vector<std::string> keys;
+    {
+        MemSkipList::Accessor accessor(list_);
+        // All the writes are done by the holder of writeLock_, so the first version
+        // of each key is the latest one, including the ones not visible yet
+        auto it = accessor.lower_bound(entryOf(start, std::numeric_limits<uint64_t>::max()));
+        while (it != accessor.end() && (end.empty() || it->key < end)) {
+            const auto* key = &it->key;
+            if (!it->deleted) {
+                keys.emplace_back(*key);
+            }
+            do {
+                ++it;
+            } while (it != accessor.end() && it->key == *key);
+        }
+    }
+    for (auto& key : keys) {
+        addEntry(std::move(key), true, "");
+    }
+}
+
+
+bool MemEngine::collectGarbage(int32_t maxKeys) {
+    uint64_t minSeq = visibleSeq_.load(std::memory_order_acquire);
+    {
+        std::lock_guard<std::mutex> g(snapshotsLock_);
+        if (!snapshots_.empty()) {
+            minSeq = std::min(minSeq, *snapshots_.begin());
+        }
+    }
+
+    // The latest version no later than minSeq is seen by all the reads, and the older
+    // ones are seen by none. The tombstone is not needed either once nothing is older.
+    std::vector<MemEntry> garbage;
+    MemSkipList::Accessor accessor(list_);
+    auto it = accessor.lower_bound(entryOf(gcCursor_, std::numeric_limits<uint64_t>::max()));
+    const std::string* key = nullptr;
+    bool covered = false;
+    int32_t keys = 0;
+    for (; it != accessor.end(); ++it) {
+        if (key == nullptr || it->key != *key) {
+            // Stop at the boundary of the keys, the versions of one key are checked at once
+            if (maxKeys > 0 && keys >= maxKeys) {
+                break;
+            }
+            key = &it->key;
+            covered = false;
+            keys++;
+        }
+        if (covered) {
+            garbage.emplace_back(entryOf(it->key, it->seq));
+        } else if (it->seq <= minSeq) {
+            covered = true;
+            if (it->deleted) {
+                garbage.emplace_back(entryOf(it->key, it->seq));
+            }
+        }
+    }
+    bool done = it == accessor.end();
+    gcCursor_ = done ? "" : it->key;
+    // Remove the older versions first, or a read could see them after the tombstone is gone
+    for (auto rit = garbage.rbegin(); rit != garbage.rend(); ++rit) {
+        accessor.erase(*rit);
+    }
+    if (done) {
+        writesSinceGc_ = 0;
+    }
+    VLOG(2) << "Removed " << garbage.size() << " stale versions of " << keys
+            << " keys from the memory engine on " << dataPath_;
+    return done;
+}
+
+
+std::string MemEngine::dataFile() const {
+    return folly::stringPrintf("%s/data/mem.dat", dataPath_.c_str());
+}
+
+
+ResultCode MemEngine::dumpData() {
+    std::lock_guard<std::mutex> g(dumpLock_);
+    auto seq = visibleSeq_.load(std::memory_order_acquire);
+    if (seq == dumpedSeq_) {
+        return ResultCode::SUCCEEDED;
+    }
+    std::unordered_map<PartitionID, LogID> logIds;
+    auto ret = dump(dataFile(), &logIds);
+    if (ret != ResultCode::SUCCEEDED) {
+        return ret;
+    }
+    // The writes after seq could have been dumped as well, which are dumped again
+    dumpedSeq_ = seq;
+    std::lock_guard<std::mutex> lg(logIdsLock_);
+    dumpedLogIds_.swap(logIds);
+    return ResultCode::SUCCEEDED;
+}
+
+
+LogID MemEngine::durableLogId(PartitionID partId) {
+    std::lock_guard<std::mutex> g(logIdsLock_);
+    auto it = dumpedLogIds_.find(partId);
+    return it == dumpedLogIds_.end() ? 0 : it->second;
+}
+
+
+ResultCode MemEngine::dump(const std::string& path,
+                           std::unordered_map<PartitionID, LogID>* logIds) {
+    /*
+     * The file is a list of records of the visible keys in order:
+     *   keyLen(int32), key, valLen(int32), val
+     * and ends with -1(int32) and the number of the records(int64).
+     */
+    auto tmp = folly::stringPrintf("%s.tmp", path.c_str());
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        LOG(ERROR) << "Open " << tmp << " failed: " << strerror(errno);
+        return ResultCode::ERR_IO_ERROR;
+    }
+    SCOPE_EXIT {
+        ::close(fd);
+    };
+    std::string buf;
+    buf.reserve(kDumpBufferSize);
+    auto flushBuf = [&] () {
+        if (folly::writeFull(fd, buf.data(), buf.size()) != static_cast<ssize_t>(buf.size())) {
+            LOG(ERROR) << "Write " << tmp << " failed: " << strerror(errno);
+            return false;
+        }
+        buf.clear();
+        return true;
+    };
+
+    std::unique_ptr<KVIterator> iter;
+    prefix("", &iter);
+    int64_t count = 0;
+    for (; iter->valid(); iter->next()) {
+        if (logIds != nullptr
+                && NebulaKeyUtils::isSystemCommit(iter->key())
+                && iter->val().size() >= sizeof(LogID)) {
+            LogID logId;
+            memcpy(&logId, iter->val().data(), sizeof(LogID));
+            (*logIds)[NebulaKeyUtils::getPart(iter->key())] = logId;
+        }
+        appendPiece(buf, iter->key());
+        appendPiece(buf, iter->val());
+        count++;
+        if (buf.size() >= kDumpBufferSize && !flushBuf()) {
+            return ResultCode::ERR_IO_ERROR;
+        }
+    }
+    int32_t end = -1;
+    buf.append(reinterpret_cast<const char*>(&end), sizeof(end));
+    buf.append(reinterpret_cast<const char*>(&count), sizeof(count));
+    if (!flushBuf()) {
+        return ResultCode::ERR_IO_ERROR;
+    }
+    if (::fsync(fd) < 0 || ::rename(tmp.c_str(), path.c_str()) < 0) {
+        LOG(ERROR) << "Sync or rename " << tmp << " failed: " << strerror(errno);
+        return ResultCode::ERR_IO_ERROR;
+    }
+    LOG(INFO) << "Dumped " << count << " keys into " << path;
+    return ResultCode::SUCCEEDED;
+}
+
+
+bool MemEngine::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        LOG(ERROR) << "Open " << path << " failed";
+        return false;
+    }
+    std::lock_guard<std::mutex> g(writeLock_);
+    SCOPE_EXIT {
+        visibleSeq_.store(lastSeq_, std::memory_order_release);
+    };
+    int64_t count = 0;
+    while (true) {
+        int32_t len;
+        if (!in.read(reinterpret_cast<char*>(&len), sizeof(len))) {
+            LOG(ERROR) << path << " is truncated after " << count << " keys";
+            return false;
+        }
+        if (len < 0) {
+            int64_t total;
+            if (!in.read(reinterpret_cast<char*>(&total), sizeof(total)) || total != count) {
+                LOG(ERROR) << path << " is broken, " << count << " keys read";
+                return false;
+            }
+            return true;
+        }
+        std::string key;
+        std::string val;
+        int32_t valLen;
+        if (!readPiece(in, len, &key)
+                || !in.read(reinterpret_cast<char*>(&valLen), sizeof(valLen))
+                || valLen < 0
+                || !readPiece(in, valLen, &val)) {
+            LOG(ERROR) << path << " is truncated after " << count << " keys";
+            return false;
+        }
+        if (NebulaKeyUtils::isSystemCommit(key) && val.size() >= sizeof(LogID)) {
+            LogID logId;
+            memcpy(&logId, val.data(), sizeof(LogID));
+            dumpedLogIds_[NebulaKeyUtils::getPart(key)] = logId;
+        }
+        addEntry(std::move(key), false, std::move(val));
+        count++;
+    }
+}
+
+
+std::string MemEngine::partKey(PartitionID partId) {
+    return NebulaKeyUtils::systemPartKey(partId);
+}
+
+
+void MemEngine::addPart(PartitionID partId) {
+    auto ret = put(partKey(partId), "");
+    if (ret == ResultCode::SUCCEEDED) {
+        partsNum_++;
+        CHECK_GE(partsNum_, 0);
+    }
+}
+
+
+void MemEngine::removePart(PartitionID partId) {
+    auto ret = remove(partKey(partId));
+    if (ret == ResultCode::SUCCEEDED) {
+        partsNum_--;
+        CHECK_GE(partsNum_, 0);
+    }
+}
+
+
+std::vector<PartitionID> MemEngine::allParts() {
+    std::unique_ptr<KVIterator> iter;
+    static const std::string prefixStr = NebulaKeyUtils::systemPrefix();
+    CHECK_EQ(ResultCode::SUCCEEDED, this->prefix(prefixStr, &iter));
+
+    std::vector<PartitionID> parts;
+    while (iter->valid()) {
+        auto key = iter->key();
+        CHECK_EQ(key.size(), sizeof(PartitionID) + sizeof(NebulaSystemKeyType));
+        PartitionID partId = *reinterpret_cast<const PartitionID*>(key.data());
+        if (!NebulaKeyUtils::isSystemPart(key)) {
+            iter->next();
+            continue;
+        }
+        parts.emplace_back(partId >> 8);
+        iter->next();
+    }
+    return parts;
+}
+
+
+int32_t MemEngine::totalPartsNum() {
+    return partsNum_;
+}
+
+
+ResultCode MemEngine::ingest(const std::vector<std::string>& files) {
+    std::vector<Op> ops;
+    for (auto& file : files) {
+        rocksdb::SstFileReader reader(rocksdb::Options{});
+        auto status = reader.Open(file);
+        if (!status.ok()) {
+            LOG(ERROR) << "Open sst file " << file << " failed: " << status.ToString();
+            return ResultCode::ERR_IO_ERROR;
+        }
+        std::unique_ptr<rocksdb::Iterator> iter(reader.NewIterator(rocksdb::ReadOptions()));
+        for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+            ops.emplace_back(Op{Op::Type::PUT, iter->key().ToString(), iter->value().ToString()});
+        }
+        if (!iter->status().ok()) {
+            LOG(ERROR) << "Read sst file " << file << " failed: " << iter->status().ToString();
+            return ResultCode::ERR_IO_ERROR;
+        }
+    }
+    return write(std::move(ops));
+}
+
+
+ResultCode MemEngine::setOption(const std::string& configKey,
+                                const std::string& configValue) {
+    LOG(ERROR) << "SetOption is not supported by the memory engine: "
+               << configKey << ":" << configValue;
+    return ResultCode::ERR_UNSUPPORTED;
+}
+
+
+ResultCode MemEngine::setDBOption(const std::string& configKey,
+                                  const std::string& configValue) {
+    LOG(ERROR) << "SetDBOption is not supported by the memory engine: "
+               << configKey << ":" << configValue;
+    return ResultCode::ERR_UNSUPPORTED;
+}
+
+
+ResultCode MemEngine::compact() {
+    std::lock_guard<std::mutex> g(writeLock_);
+    // A full round from the first key, regardless of the one spread over the writes
+    gcCursor_.clear();
+    collectGarbage(0);
+    return ResultCode::SUCCEEDED;
+}
+
+
+ResultCode MemEngine::flush() {
+    return dumpData();
+}
+
+
+ResultCode MemEngine::createCheckpoint(const std::string& name) {
+    // The same directory structure as the one of RocksEngine
+    auto checkpointPath = folly::stringPrintf("%s/checkpoints/%s/data",
+                                              dataPath_.c_str(), name.c_str());
+    LOG(INFO) << "Target checkpoint path : " << checkpointPath;
+    if (fs::FileUtils::exist(checkpointPath)) {
+        LOG(ERROR) << "The snapshot file already exists: " << checkpointPath;
+        return ResultCode::ERR_CHECKPOINT_ERROR;
+    }
+    if (!FileUtils::makeDir(checkpointPath)) {
+        LOG(ERROR) << "Make dir " << checkpointPath << " failed";
+        return ResultCode::ERR_CHECKPOINT_ERROR;
+    }
+    auto ret = dump(folly::stringPrintf("%s/mem.dat", checkpointPath.c_str()));
+    if (ret != ResultCode::SUCCEEDED) {
+        return ResultCode::ERR_CHECKPOINT_ERROR;
+    }
+    return ResultCode::SUCCEEDED;
+}
+
+}  // namespace kvstore
+}  // namespace nebula
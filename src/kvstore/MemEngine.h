@@ -0,0 +1,295 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef KVSTORE_MEMENGINE_H_
+#define KVSTORE_MEMENGINE_H_
+
+#include "base/Base.h"
+#include <folly/ConcurrentSkipList.h>
+#include <gtest/gtest_prod.h>
+#include "thread/GenericWorker.h"
+#include "kvstore/KVIterator.h"
+#include "kvstore/KVEngine.h"
+
+namespace nebula {
+namespace kvstore {
+
+/**
+ * One version of a key. The versions of a key are ordered by the descending sequence,
+ * so the latest one comes first.
+ * */
+struct MemEntry {
+    std::string key;
+    uint64_t seq{0};
+    // A tombstone hides all the older versions of the key
+    bool deleted{false};
+    std::string value;
+};
+
+struct MemEntryComp {
+    bool operator()(const MemEntry& lhs, const MemEntry& rhs) const {
+        auto ret = lhs.key.compare(rhs.key);
+        if (ret != 0) {
+            return ret < 0;
+        }
+        return lhs.seq > rhs.seq;
+    }
+};
+
+using MemSkipList = folly::ConcurrentSkipList<MemEntry, MemEntryComp>;
+
+class MemEngine;
+
+/**
+ * The reads see the versions no later than the sequence of the snapshot. Every read
+ * holds one, so the versions it could see are kept by the garbage collection.
+ * */
+class MemSnapshot : public KVSnapshot {
+public:
+    MemSnapshot(MemEngine* engine, uint64_t seq)
+        : engine_(engine)
+        , seq_(seq) {}
+
+    ~MemSnapshot();
+
+    uint64_t seq() const {
+        return seq_;
+    }
+
+private:
+    MemEngine* engine_{nullptr};
+    uint64_t seq_{0};
+};
+
+/**
+ * Iterate the latest visible version of the keys in [start, end). An empty end means
+ * no upper bound. The accessor keeps the entries alive during the iteration.
+ * */
+class MemIter : public KVIterator {
+public:
+    MemIter(std::shared_ptr<MemSkipList> list,
+            const std::string& start,
+            std::string end,
+            std::shared_ptr<const MemSnapshot> snapshot);
+
+    bool valid() const override {
+        return iter_ != accessor_.end() && (end_.empty() || iter_->key < end_);
+    }
+
+    void next() override;
+
+    void prev() override {
+        LOG(FATAL) << "MemIter could not iterate backward";
+    }
+
+    folly::StringPiece key() const override {
+        return iter_->key;
+    }
+
+    folly::StringPiece val() const override {
+        return iter_->value;
+    }
+
+private:
+    // Move to the latest visible version of the current or the following key
+    void skipInvisible();
+
+    void skipKey();
+
+private:
+    MemSkipList::Accessor accessor_;
+    MemSkipList::iterator iter_;
+    std::string end_;
+    std::shared_ptr<const MemSnapshot> snapshot_;
+};
+
+/**************************************************************************
+ *
+ * An implementation of KVEngine which holds all the data in memory
+ *
+ * All the versions of the keys are kept in a concurrent skiplist. Each write takes a new
+ * sequence, and the writes of a batch are visible at once by publishing the sequence of
+ * the last one, so the reads go without any lock. The versions hidden from all the reads
+ * are removed by compact(), or once there are enough writes since the last time.
+ *
+ * The stale versions are removed once there are --memory_engine_gc_writes writes, a batch
+ * of --memory_engine_gc_batch_keys keys by each of the following writes until the round
+ * reaches the last key.
+ *
+ * The data is dumped into <data root>/data/mem.dat in the background periodically, by
+ * flush() and on destruction, and loaded on start. The raft wal after the dumped commit
+ * log id is replayed as usual, and it is kept until the logs are dumped.
+ *
+ *************************************************************************/
+class MemEngine : public KVEngine {
+    FRIEND_TEST(MemEngineTest, CompactTest);
+    FRIEND_TEST(MemEngineTest, IncrementalGcTest);
+
+public:
+    MemEngine(GraphSpaceID spaceId, const std::string& dataPath);
+
+    ~MemEngine();
+
+    const char* getDataRoot() const override {
+        return dataPath_.c_str();
+    }
+
+    std::unique_ptr<WriteBatch> startBatchWrite() override;
+    ResultCode commitBatchWrite(std::unique_ptr<WriteBatch> batch) override;
+
+    /*********************
+     * Data retrieval
+     ********************/
+    ResultCode get(const std::string& key, std::string* value) override;
+
+    std::vector<Status> multiGet(const std::vector<std::string>& keys,
+                                 std::vector<std::string>* values) override;
+
+    using KVEngine::range;
+    using KVEngine::prefix;
+    using KVEngine::rangeWithPrefix;
+
+    ResultCode range(const std::string& start,
+                     const std::string& end,
+                     std::unique_ptr<KVIterator>* iter,
+                     const ReadContext& ctx) override;
+
+    ResultCode prefix(const std::string& prefix,
+                      std::unique_ptr<KVIterator>* iter,
+                      const ReadContext& ctx) override;
+
+    ResultCode rangeWithPrefix(const std::string& start,
+                               const std::string& prefix,
+                               std::unique_ptr<KVIterator>* iter,
+                               const ReadContext& ctx) override;
+
+    std::shared_ptr<const KVSnapshot> getSnapshot() override;
+
+    /*********************
+     * Data modification
+     ********************/
+    ResultCode put(std::string key, std::string value) override;
+
+    ResultCode multiPut(std::vector<KV> keyValues) override;
+
+    ResultCode remove(const std::string& key) override;
+
+    ResultCode multiRemove(std::vector<std::string> keys) override;
+
+    ResultCode removeRange(const std::string& start,
+                           const std::string& end) override;
+
+    ResultCode removePrefix(const std::string& prefix) override;
+
+    /*********************
+     * Non-data operation
+     ********************/
+    void addPart(PartitionID partId) override;
+
+    void removePart(PartitionID partId) override;
+
+    std::vector<PartitionID> allParts() override;
+
+    int32_t totalPartsNum() override;
+
+    ResultCode ingest(const std::vector<std::string>& files) override;
+
+    ResultCode setOption(const std::string& configKey,
+                         const std::string& configValue) override;
+
+    ResultCode setDBOption(const std::string& configKey,
+                           const std::string& configValue) override;
+
+    ResultCode compact() override;
+
+    ResultCode flush() override;
+
+    LogID durableLogId(PartitionID partId) override;
+
+    /*********************
+     * Checkpoint operation
+     ********************/
+    ResultCode createCheckpoint(const std::string& name) override;
+
+private:
+    friend class MemSnapshot;
+    friend class MemWriteBatch;
+
+    // The operations are applied in order, and visible at once
+    struct Op {
+        enum class Type {
+            PUT,
+            REMOVE,
+            REMOVE_PREFIX,
+            REMOVE_RANGE,
+        };
+        Type type;
+        std::string first;
+        std::string second;
+    };
+
+    std::shared_ptr<const MemSnapshot> acquire(const ReadContext& ctx = ReadContext());
+
+    void release(uint64_t seq);
+
+    ResultCode write(std::vector<Op> ops);
+
+    // Add a version of the key, requires writeLock_
+    void addEntry(std::string key, bool deleted, std::string value);
+
+    // Add the tombstones of the visible keys in [start, end), requires writeLock_
+    void removeVisible(const std::string& start, const std::string& end);
+
+    // Remove the versions hidden from all the reads of at most maxKeys keys from gcCursor_,
+    // or of all the keys left if maxKeys is 0. Returns true once the round reaches the
+    // last key. Requires writeLock_
+    bool collectGarbage(int32_t maxKeys);
+
+    // Dump the visible data into the file atomically, and the commit log ids of the parts
+    // dumped are returned in logIds
+    ResultCode dump(const std::string& path,
+                    std::unordered_map<PartitionID, LogID>* logIds = nullptr);
+
+    // Dump into the data file if there are writes since the last time
+    ResultCode dumpData();
+
+    bool load(const std::string& path);
+
+    std::string dataFile() const;
+
+    std::string partKey(PartitionID partId);
+
+private:
+    std::string dataPath_;
+    std::shared_ptr<MemSkipList> list_;
+
+    // Serializes the writes
+    std::mutex writeLock_;
+    uint64_t lastSeq_{0};
+    int64_t writesSinceGc_{0};
+    // The first key not checked yet by the round of the garbage collection in progress
+    std::string gcCursor_;
+    // The sequence of the latest write visible to the reads
+    std::atomic<uint64_t> visibleSeq_{0};
+
+    // The sequences held by the reads
+    std::mutex snapshotsLock_;
+    std::multiset<uint64_t> snapshots_;
+
+    std::atomic<int32_t> partsNum_{0};
+
+    // Serializes dumping into the data file
+    std::mutex dumpLock_;
+    uint64_t dumpedSeq_{0};
+    // The commit log ids of the parts in the data file
+    std::mutex logIdsLock_;
+    std::unordered_map<PartitionID, LogID> dumpedLogIds_;
+    thread::GenericWorker dumper_;
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+#endif  // KVSTORE_MEMENGINE_H_
@@ -0,0 +1,57 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef KVSTORE_NEBULASLICETRANSFORM_H_
+#define KVSTORE_NEBULASLICETRANSFORM_H_
+
+#include "base/Base.h"
+#include <rocksdb/slice_transform.h>
+#include "base/NebulaKeyUtils.h"
+
+namespace nebula {
+namespace kvstore {
+
+/**
+ * The vertex keys and the edge keys share the same fixed-length head:
+ *   PartitionID + VertexID + TagID / EdgeType
+ * which is exactly what NebulaKeyUtils::vertexPrefix(partId, vId, tagId) and
+ * NebulaKeyUtils::edgePrefix(partId, vId, edgeType) produce.
+ *
+ * The transform extracts the head from data keys, so that the bloom filters can
+ * reject the prefix seeks on (vertex, tag/edgeType) which have no data.
+ * Other keys (index, system, uuid, kv) are out of the domain.
+ * */
+class NebulaSliceTransform final : public rocksdb::SliceTransform {
+public:
+    static_assert(sizeof(TagID) == sizeof(EdgeType),
+                  "The tag id and the edge type should have the same length");
+    static constexpr size_t kPrefixLen = sizeof(PartitionID) + sizeof(VertexID) + sizeof(TagID);
+
+    const char* Name() const override {
+        return "nebula.NebulaSliceTransform";
+    }
+
+    rocksdb::Slice Transform(const rocksdb::Slice& key) const override {
+        return rocksdb::Slice(key.data(), kPrefixLen);
+    }
+
+    bool InDomain(const rocksdb::Slice& key) const override {
+        return key.size() >= kPrefixLen &&
+               NebulaKeyUtils::isDataKey(folly::StringPiece(key.data(), key.size()));
+    }
+
+    bool InRange(const rocksdb::Slice& dst) const override {
+        return dst.size() == kPrefixLen;
+    }
+
+    bool SameResultWhenAppended(const rocksdb::Slice& prefix) const override {
+        return InDomain(prefix);
+    }
+};
+
+}  // namespace kvstore
+}  // namespace nebula
+#endif  // KVSTORE_NEBULASLICETRANSFORM_H_
@@ -12,12 +12,22 @@
 #include "network/NetworkUtils.h"
 #include "fs/FileUtils.h"
 #include "kvstore/RocksEngine.h"
+#include "kvstore/MemEngine.h"
 #include "kvstore/SnapshotManagerImpl.h"
 
 DEFINE_string(engine_type, "rocksdb", "rocksdb, memory...");
 DEFINE_int32(custom_filter_interval_secs, 24 * 3600, "interval to trigger custom compaction");
 DEFINE_int32(num_workers, 4, "Number of worker threads");
 DEFINE_bool(check_leader, true, "Check leader or not");
+DEFINE_int32(follower_read_max_staleness_ms, 0,
+             "The max staleness of the follower reads, 0 means linearizable reads, "
+             "which ask the leader for the read index every time");
+DEFINE_bool(wal_shared_log, false, "Whether all parts on one data path share one wal");
+DEFINE_int64(wal_shared_file_size, 64 * 1024 * 1024, "The segment size of the shared wal");
+DEFINE_string(wal_shared_sync, "none",
+              "When to sync the shared wal: none, interval or batch");
+DEFINE_int32(wal_shared_sync_interval_ms, 100,
+             "The sync interval of the shared wal when wal_shared_sync is interval");
 
 namespace nebula {
 namespace kvstore {
@@ -48,6 +58,25 @@ bool NebulaStore::init() {
         return false;
     }
 
+    if (FLAGS_wal_shared_log) {
+        wal::SharedWalPolicy policy;
+        policy.fileSize = FLAGS_wal_shared_file_size;
+        policy.syncIntervalMs = FLAGS_wal_shared_sync_interval_ms;
+        if (FLAGS_wal_shared_sync == "batch") {
+            policy.sync = wal::SharedWalSync::BATCH;
+        } else if (FLAGS_wal_shared_sync == "interval") {
+            policy.sync = wal::SharedWalSync::INTERVAL;
+        } else if (FLAGS_wal_shared_sync != "none") {
+            LOG(ERROR) << "Unknown wal_shared_sync " << FLAGS_wal_shared_sync;
+            return false;
+        }
+        for (auto& path : options_.dataPaths_) {
+            // Not under the "nebula" dir, which only holds the spaces
+            sharedWals_.emplace(path, wal::SharedWal::getSharedWal(
+                folly::stringPrintf("%s/wal", path.c_str()), policy));
+        }
+    }
+
     CHECK(!!options_.partMan_);
     LOG(INFO) << "Scan the local path, and init the spaces_";
     {
@@ -131,7 +160,11 @@ bool NebulaStore::init() {
                                                                ioPool_,
                                                                bgWorkers_,
                                                                workers_,
-                                                               snapshot_);
+                                                               snapshot_,
+                                                               sharedWal(enginePtr),
+                                                               commitListener(spaceId,
+                                                                              partId,
+                                                                              enginePtr));
                             auto status = options_.partMan_->partMeta(spaceId, partId);
                             if (!status.ok()) {
                                 LOG(WARNING) << status.status().toString();
@@ -169,6 +202,10 @@ bool NebulaStore::init() {
             }
         }
     }
+    // The logs of the parts not loaded are useless
+    for (auto& sharedWal : sharedWals_) {
+        sharedWal.second->releaseUnclaimed();
+    }
 
     LOG(INFO) << "Init data from partManager for " << storeSvcAddr_;
     auto partsMap = options_.partMan_->parts(storeSvcAddr_);
@@ -203,12 +240,39 @@ std::unique_ptr<KVEngine> NebulaStore::newEngine(GraphSpaceID spaceId,
                                              path,
                                              options_.mergeOp_,
                                              cfFactory);
+    } else if (FLAGS_engine_type == "memory") {
+        return std::make_unique<MemEngine>(spaceId, path);
     } else {
         LOG(FATAL) << "Unknown engine type " << FLAGS_engine_type;
         return nullptr;
     }
 }
 
+std::shared_ptr<wal::SharedWal> NebulaStore::sharedWal(KVEngine* engine) const {
+    if (sharedWals_.empty()) {
+        return nullptr;
+    }
+    // The data root of the engine is "<data path>/nebula/<spaceId>"
+    folly::StringPiece dataRoot(engine->getDataRoot());
+    for (auto& sharedWal : sharedWals_) {
+        if (dataRoot.startsWith(sharedWal.first + "/nebula/")) {
+            return sharedWal.second;
+        }
+    }
+    LOG(FATAL) << "No shared wal found for " << dataRoot;
+    return nullptr;
+}
+
+std::unique_ptr<PartCommitListener> NebulaStore::commitListener(GraphSpaceID spaceId,
+                                                                PartitionID partId,
+                                                                KVEngine* engine) const {
+    if (options_.listenerFactory_ == nullptr) {
+        return nullptr;
+    }
+    return options_.listenerFactory_->create(spaceId, partId, engine);
+}
+
+
 ErrorOr<ResultCode, HostAddr> NebulaStore::partLeader(GraphSpaceID spaceId, PartitionID partId) {
     folly::RWSpinLock::ReadHolder rh(&lock_);
     auto it = spaces_.find(spaceId);
@@ -262,9 +326,9 @@ void NebulaStore::addPart(GraphSpaceID spaceId, PartitionID partId, bool asLearn
 
     // Write the information into related engine.
     targetEngine->addPart(partId);
-    spaceIt->second->parts_.emplace(
-        partId,
-        newPart(spaceId, partId, targetEngine.get(), asLearner));
+    auto part = newPart(spaceId, partId, targetEngine.get(), asLearner);
+    applyWalOption(*spaceIt->second, part.get());
+    spaceIt->second->parts_.emplace(partId, std::move(part));
     LOG(INFO) << "Space " << spaceId << ", part " << partId
               << " has been added, asLearner " << asLearner;
 }
@@ -283,7 +347,9 @@ std::shared_ptr<Part> NebulaStore::newPart(GraphSpaceID spaceId,
                                        ioPool_,
                                        bgWorkers_,
                                        workers_,
-                                       snapshot_);
+                                       snapshot_,
+                                       sharedWal(engine),
+                                       commitListener(spaceId, partId, engine));
     auto metaStatus = options_.partMan_->partMeta(spaceId, partId);
     if (!metaStatus.ok()) {
         return nullptr;
@@ -305,6 +371,12 @@ std::shared_ptr<Part> NebulaStore::newPart(GraphSpaceID spaceId,
 void NebulaStore::removeSpace(GraphSpaceID spaceId) {
     folly::RWSpinLock::WriteHolder wh(&lock_);
     auto spaceIt = this->spaces_.find(spaceId);
+    // Reset the wals of the parts, so that their chunks in the shared wal are released
+    for (auto& part : spaceIt->second->parts_) {
+        raftService_->removePartition(part.second);
+        part.second->reset();
+    }
+    spaceIt->second->parts_.clear();
     auto& engines = spaceIt->second->engines_;
     for (auto& engine : engines) {
         auto parts = engine->allParts();
@@ -345,7 +417,11 @@ void NebulaStore::updateSpaceOption(GraphSpaceID spaceId,
         }
     } else {
         for (const auto& kv : options) {
-            setOption(spaceId, kv.first, kv.second);
+            if (kv.first == "wal_sync_policy" || kv.first == "wal_sync_interval_ms") {
+                setWalOption(spaceId, kv.first, kv.second);
+            } else {
+                setOption(spaceId, kv.first, kv.second);
+            }
         }
     }
 }
@@ -398,15 +474,25 @@ ResultCode NebulaStore::range(GraphSpaceID spaceId,
                               const std::string& start,
                               const std::string& end,
                               std::unique_ptr<KVIterator>* iter) {
+    return range(spaceId, partId, start, end, iter, ReadContext());
+}
+
+
+ResultCode NebulaStore::range(GraphSpaceID spaceId,
+                              PartitionID partId,
+                              const std::string& start,
+                              const std::string& end,
+                              std::unique_ptr<KVIterator>* iter,
+                              const ReadContext& ctx) {
     auto ret = part(spaceId, partId);
     if (!ok(ret)) {
         return error(ret);
     }
     auto part = nebula::value(ret);
-    if (!checkLeader(part)) {
+    if (!checkLeader(part, ctx.followerRead_)) {
         return ResultCode::ERR_LEADER_CHANGED;
     }
-    return part->engine()->range(start, end, iter);
+    return part->engine()->range(start, end, iter, ctx);
 }
 
 
@@ -414,15 +500,24 @@ ResultCode NebulaStore::prefix(GraphSpaceID spaceId,
                                PartitionID partId,
                                const std::string& prefix,
                                std::unique_ptr<KVIterator>* iter) {
+    return this->prefix(spaceId, partId, prefix, iter, ReadContext());
+}
+
+
+ResultCode NebulaStore::prefix(GraphSpaceID spaceId,
+                               PartitionID partId,
+                               const std::string& prefix,
+                               std::unique_ptr<KVIterator>* iter,
+                               const ReadContext& ctx) {
     auto ret = part(spaceId, partId);
     if (!ok(ret)) {
         return error(ret);
     }
     auto part = nebula::value(ret);
-    if (!checkLeader(part)) {
+    if (!checkLeader(part, ctx.followerRead_)) {
         return ResultCode::ERR_LEADER_CHANGED;
     }
-    return part->engine()->prefix(prefix, iter);
+    return part->engine()->prefix(prefix, iter, ctx);
 }
 
 
@@ -431,6 +526,31 @@ ResultCode NebulaStore::rangeWithPrefix(GraphSpaceID spaceId,
                                         const std::string& start,
                                         const std::string& prefix,
                                         std::unique_ptr<KVIterator>* iter) {
+    return rangeWithPrefix(spaceId, partId, start, prefix, iter, ReadContext());
+}
+
+
+ResultCode NebulaStore::rangeWithPrefix(GraphSpaceID spaceId,
+                                        PartitionID  partId,
+                                        const std::string& start,
+                                        const std::string& prefix,
+                                        std::unique_ptr<KVIterator>* iter,
+                                        const ReadContext& ctx) {
+    auto ret = part(spaceId, partId);
+    if (!ok(ret)) {
+        return error(ret);
+    }
+    auto part = nebula::value(ret);
+    if (!checkLeader(part, ctx.followerRead_)) {
+        return ResultCode::ERR_LEADER_CHANGED;
+    }
+    return part->engine()->rangeWithPrefix(start, prefix, iter, ctx);
+}
+
+
+ResultCode NebulaStore::getSnapshot(GraphSpaceID spaceId,
+                                    PartitionID partId,
+                                    std::shared_ptr<const KVSnapshot>* snapshot) {
     auto ret = part(spaceId, partId);
     if (!ok(ret)) {
         return error(ret);
@@ -439,7 +559,23 @@ ResultCode NebulaStore::rangeWithPrefix(GraphSpaceID spaceId,
     if (!checkLeader(part)) {
         return ResultCode::ERR_LEADER_CHANGED;
     }
-    return part->engine()->rangeWithPrefix(start, prefix, iter);
+    *snapshot = part->engine()->getSnapshot();
+    return ResultCode::SUCCEEDED;
+}
+
+
+folly::Future<ResultCode> NebulaStore::readIndex(GraphSpaceID spaceId, PartitionID partId) {
+    auto ret = part(spaceId, partId);
+    if (!ok(ret)) {
+        return folly::makeFuture(error(ret));
+    }
+    auto part = nebula::value(ret);
+    if (checkLeader(part)) {
+        return folly::makeFuture(ResultCode::SUCCEEDED);
+    }
+    return part->readIndex(FLAGS_follower_read_max_staleness_ms).thenValue([] (bool caughtUp) {
+        return caughtUp ? ResultCode::SUCCEEDED : ResultCode::ERR_LEADER_CHANGED;
+    });
 }
 
 
@@ -632,6 +768,53 @@ ResultCode NebulaStore::setDBOption(GraphSpaceID spaceId,
 }
 
 
+ResultCode NebulaStore::setWalOption(GraphSpaceID spaceId,
+                                     const std::string& configKey,
+                                     const std::string& configValue) {
+    folly::RWSpinLock::WriteHolder wh(&lock_);
+    auto spaceIt = spaces_.find(spaceId);
+    if (spaceIt == spaces_.end()) {
+        return ResultCode::ERR_SPACE_NOT_FOUND;
+    }
+    auto& space = spaceIt->second;
+    if (configKey == "wal_sync_policy") {
+        auto policy = wal::FileBasedWal::toSyncPolicy(configValue);
+        if (!policy.ok()) {
+            LOG(ERROR) << "Space " << spaceId << ": " << policy.status();
+            return ResultCode::ERR_INVALID_ARGUMENT;
+        }
+        space->walSyncPolicy_ = policy.value();
+    } else if (configKey == "wal_sync_interval_ms") {
+        auto interval = folly::tryTo<int32_t>(configValue);
+        if (!interval.hasValue() || interval.value() <= 0) {
+            LOG(ERROR) << "Space " << spaceId << ": invalid wal sync interval " << configValue;
+            return ResultCode::ERR_INVALID_ARGUMENT;
+        }
+        space->walSyncIntervalMs_ = interval.value();
+    } else {
+        return ResultCode::ERR_INVALID_ARGUMENT;
+    }
+    LOG(INFO) << "Space " << spaceId << ": set " << configKey << " to " << configValue;
+    for (auto& part : space->parts_) {
+        applyWalOption(*space, part.second.get());
+    }
+    return ResultCode::SUCCEEDED;
+}
+
+
+void NebulaStore::applyWalOption(const SpacePartInfo& space, Part* part) const {
+    if (part == nullptr) {
+        return;
+    }
+    if (space.walSyncPolicy_.hasValue()) {
+        part->wal()->setSyncPolicy(space.walSyncPolicy_.value());
+    }
+    if (space.walSyncIntervalMs_.hasValue()) {
+        part->wal()->setSyncInterval(space.walSyncIntervalMs_.value());
+    }
+}
+
+
 ResultCode NebulaStore::compact(GraphSpaceID spaceId) {
     auto spaceRet = space(spaceId);
     if (!ok(spaceRet)) {
@@ -821,8 +1004,10 @@ int32_t NebulaStore::allLeader(std::unordered_map<GraphSpaceID,
     return count;
 }
 
-bool NebulaStore::checkLeader(std::shared_ptr<Part> part) const {
-    return !FLAGS_check_leader || (part->isLeader() && part->leaseValid());
+bool NebulaStore::checkLeader(std::shared_ptr<Part> part, bool followerRead) const {
+    return !FLAGS_check_leader
+        || (part->isLeader() && part->leaseValid())
+        || (followerRead && part->isFollower());
 }
 
 
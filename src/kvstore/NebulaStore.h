@@ -10,12 +10,14 @@
 #include "base/Base.h"
 #include <gtest/gtest_prod.h>
 #include <folly/RWSpinLock.h>
+#include <folly/Optional.h>
 #include "kvstore/raftex/RaftexService.h"
 #include "kvstore/KVStore.h"
 #include "kvstore/PartManager.h"
 #include "kvstore/Part.h"
 #include "kvstore/KVEngine.h"
 #include "kvstore/raftex/SnapshotManager.h"
+#include "kvstore/wal/FileBasedWal.h"
 
 namespace nebula {
 namespace kvstore {
@@ -29,6 +31,9 @@ struct SpacePartInfo {
 
     std::unordered_map<PartitionID, std::shared_ptr<Part>> parts_;
     std::vector<std::unique_ptr<KVEngine>> engines_;
+    // The wal sync options of the space, which override the flags
+    folly::Optional<wal::WalSyncPolicy> walSyncPolicy_;
+    folly::Optional<int32_t> walSyncIntervalMs_;
 };
 
 class NebulaStore : public KVStore, public Handler {
@@ -146,6 +151,32 @@ public:
                                std::string&& prefix,
                                std::unique_ptr<KVIterator>* iter) override = delete;
 
+    ResultCode range(GraphSpaceID spaceId,
+                     PartitionID  partId,
+                     const std::string& start,
+                     const std::string& end,
+                     std::unique_ptr<KVIterator>* iter,
+                     const ReadContext& ctx) override;
+
+    ResultCode prefix(GraphSpaceID spaceId,
+                      PartitionID  partId,
+                      const std::string& prefix,
+                      std::unique_ptr<KVIterator>* iter,
+                      const ReadContext& ctx) override;
+
+    ResultCode rangeWithPrefix(GraphSpaceID spaceId,
+                               PartitionID  partId,
+                               const std::string& start,
+                               const std::string& prefix,
+                               std::unique_ptr<KVIterator>* iter,
+                               const ReadContext& ctx) override;
+
+    ResultCode getSnapshot(GraphSpaceID spaceId,
+                           PartitionID partId,
+                           std::shared_ptr<const KVSnapshot>* snapshot) override;
+
+    folly::Future<ResultCode> readIndex(GraphSpaceID spaceId, PartitionID partId) override;
+
     ResultCode sync(GraphSpaceID spaceId,
                     PartitionID partId) override;
 
@@ -194,6 +225,15 @@ public:
                            const std::string& configKey,
                            const std::string& configValue);
 
+    /**
+     * Set the wal durability of all the parts in the space, including the ones added later.
+     * The configKey is either "wal_sync_policy" (async, interval or sync),
+     * or "wal_sync_interval_ms".
+     * */
+    ResultCode setWalOption(GraphSpaceID spaceId,
+                            const std::string& configKey,
+                            const std::string& configValue);
+
     ResultCode compact(GraphSpaceID spaceId) override;
 
     ResultCode flush(GraphSpaceID spaceId) override;
@@ -236,7 +276,19 @@ private:
 
     ErrorOr<ResultCode, KVEngine*> engine(GraphSpaceID spaceId, PartitionID partId);
 
-    bool checkLeader(std::shared_ptr<Part> part) const;
+    // The followers could serve the reads with followerRead set, see readIndex()
+    bool checkLeader(std::shared_ptr<Part> part, bool followerRead = false) const;
+
+    // Apply the wal sync options of the space to the part
+    void applyWalOption(const SpacePartInfo& space, Part* part) const;
+
+    // The shared wal of the data path where the engine is, or nullptr if not in shared mode
+    std::shared_ptr<wal::SharedWal> sharedWal(KVEngine* engine) const;
+
+    // The listener of the writes committed on the part, or nullptr if no one is watching
+    std::unique_ptr<PartCommitListener> commitListener(GraphSpaceID spaceId,
+                                                       PartitionID partId,
+                                                       KVEngine* engine) const;
 
 private:
     // The lock used to protect spaces_
@@ -252,6 +304,8 @@ private:
 
     std::shared_ptr<raftex::RaftexService> raftService_;
     std::shared_ptr<raftex::SnapshotManager> snapshot_;
+    // data path -> the wal shared by the parts on it
+    std::unordered_map<std::string, std::shared_ptr<wal::SharedWal>> sharedWals_;
 };
 
 }  // namespace kvstore
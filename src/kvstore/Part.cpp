@@ -7,8 +7,17 @@
 #include "kvstore/Part.h"
 #include "kvstore/LogEncoder.h"
 #include "base/NebulaKeyUtils.h"
+#include "fs/FileUtils.h"
+#include <folly/ScopeGuard.h>
 
 DEFINE_int32(cluster_id, 0, "A unique id for each cluster");
+DEFINE_bool(enable_write_coalescing, false,
+            "Merge the writes of a part issued while raft_max_inflight_batches ones are in "
+            "flight into one log");
+DEFINE_int32(write_coalescing_max_bytes, 4 * 1024 * 1024,
+             "The maximum size of the writes merged into one log");
+
+DECLARE_uint32(raft_max_inflight_batches);
 
 namespace nebula {
 namespace kvstore {
@@ -23,7 +32,9 @@ Part::Part(GraphSpaceID spaceId,
            std::shared_ptr<folly::IOThreadPoolExecutor> ioPool,
            std::shared_ptr<thread::GenericThreadPool> workers,
            std::shared_ptr<folly::Executor> handlers,
-           std::shared_ptr<raftex::SnapshotManager> snapshotMan)
+           std::shared_ptr<raftex::SnapshotManager> snapshotMan,
+           std::shared_ptr<wal::SharedWal> sharedWal,
+           std::unique_ptr<PartCommitListener> listener)
         : RaftPart(FLAGS_cluster_id,
                    spaceId,
                    partId,
@@ -32,11 +43,13 @@ Part::Part(GraphSpaceID spaceId,
                    ioPool,
                    workers,
                    handlers,
-                   snapshotMan)
+                   snapshotMan,
+                   std::move(sharedWal))
         , spaceId_(spaceId)
         , partId_(partId)
         , walPath_(walPath)
-        , engine_(engine) {
+        , engine_(engine)
+        , listener_(std::move(listener)) {
 }
 
 
@@ -59,66 +72,167 @@ std::pair<LogID, TermID> Part::lastCommittedLogId() {
 
 
 void Part::asyncPut(folly::StringPiece key, folly::StringPiece value, KVCallback cb) {
-    std::string log = encodeMultiValues(OP_PUT, key, value);
-
-    appendAsync(FLAGS_cluster_id, std::move(log))
-        .thenValue([this, callback = std::move(cb)] (AppendLogResult res) mutable {
-            callback(this->toResultCode(res));
-        });
+    appendWrite(key.size() + value.size(),
+                [&] {
+                    return encodeMultiValues(OP_PUT, key, value);
+                },
+                [&] (BatchHolder& batch) {
+                    batch.put(key.str(), value.str());
+                },
+                std::move(cb));
 }
 
 
 void Part::asyncMultiPut(const std::vector<KV>& keyValues, KVCallback cb) {
-    std::string log = encodeMultiValues(OP_MULTI_PUT, keyValues);
-
-    appendAsync(FLAGS_cluster_id, std::move(log))
-        .thenValue([this, callback = std::move(cb)] (AppendLogResult res) mutable {
-            callback(this->toResultCode(res));
-        });
+    size_t bytes = 0;
+    for (auto& kv : keyValues) {
+        bytes += kv.first.size() + kv.second.size();
+    }
+    appendWrite(bytes,
+                [&] {
+                    return encodeMultiValues(OP_MULTI_PUT, keyValues);
+                },
+                [&] (BatchHolder& batch) {
+                    for (auto& kv : keyValues) {
+                        batch.put(std::string(kv.first), std::string(kv.second));
+                    }
+                },
+                std::move(cb));
 }
 
 
 void Part::asyncRemove(folly::StringPiece key, KVCallback cb) {
-    std::string log = encodeSingleValue(OP_REMOVE, key);
-
-    appendAsync(FLAGS_cluster_id, std::move(log))
-        .thenValue([this, callback = std::move(cb)] (AppendLogResult res) mutable {
-            callback(this->toResultCode(res));
-        });
+    appendWrite(key.size(),
+                [&] {
+                    return encodeSingleValue(OP_REMOVE, key);
+                },
+                [&] (BatchHolder& batch) {
+                    batch.remove(key.str());
+                },
+                std::move(cb));
 }
 
 
 void Part::asyncMultiRemove(const std::vector<std::string>& keys, KVCallback cb) {
-    std::string log = encodeMultiValues(OP_MULTI_REMOVE, keys);
-
-    appendAsync(FLAGS_cluster_id, std::move(log))
-        .thenValue([this, callback = std::move(cb)] (AppendLogResult res) mutable {
-            callback(this->toResultCode(res));
-        });
+    size_t bytes = 0;
+    for (auto& key : keys) {
+        bytes += key.size();
+    }
+    appendWrite(bytes,
+                [&] {
+                    return encodeMultiValues(OP_MULTI_REMOVE, keys);
+                },
+                [&] (BatchHolder& batch) {
+                    for (auto& key : keys) {
+                        batch.remove(std::string(key));
+                    }
+                },
+                std::move(cb));
 }
 
 
 void Part::asyncRemovePrefix(folly::StringPiece prefix, KVCallback cb) {
-    std::string log = encodeSingleValue(OP_REMOVE_PREFIX, prefix);
-
-    appendAsync(FLAGS_cluster_id, std::move(log))
-        .thenValue([this, callback = std::move(cb)] (AppendLogResult res) mutable {
-            callback(this->toResultCode(res));
-        });
+    appendWrite(prefix.size(),
+                [&] {
+                    return encodeSingleValue(OP_REMOVE_PREFIX, prefix);
+                },
+                [&] (BatchHolder& batch) {
+                    batch.removePrefix(prefix.str());
+                },
+                std::move(cb));
 }
 
 
 void Part::asyncRemoveRange(folly::StringPiece start,
                             folly::StringPiece end,
                             KVCallback cb) {
-    std::string log = encodeMultiValues(OP_REMOVE_RANGE, start, end);
+    appendWrite(start.size() + end.size(),
+                [&] {
+                    return encodeMultiValues(OP_REMOVE_RANGE, start, end);
+                },
+                [&] (BatchHolder& batch) {
+                    batch.rangeRemove(start.str(), end.str());
+                },
+                std::move(cb));
+}
+
+
+void Part::appendWrite(size_t bytes,
+                       folly::FunctionRef<std::string()> encode,
+                       folly::FunctionRef<void(BatchHolder&)> toBatch,
+                       KVCallback cb) {
+    std::vector<KVCallback> cbs;
+    if (!FLAGS_enable_write_coalescing) {
+        cbs.emplace_back(std::move(cb));
+        sendWrites(encode(), std::move(cbs), false);
+        return;
+    }
+    std::string log;
+    {
+        std::lock_guard<std::mutex> g(writesLock_);
+        if (writesInFlight_ >= std::max(FLAGS_raft_max_inflight_batches, 1U)) {
+            // The writes in the batch are applied in the order they come
+            toBatch(pendingWrites_);
+            pendingBytes_ += bytes;
+            pendingCbs_.emplace_back(std::move(cb));
+            if (pendingBytes_ < static_cast<size_t>(FLAGS_write_coalescing_max_bytes)) {
+                return;
+            }
+            log = encodeBatchValue(pendingWrites_.getBatch());
+            pendingWrites_.clear();
+            pendingBytes_ = 0;
+            cbs.swap(pendingCbs_);
+        } else {
+            cbs.emplace_back(std::move(cb));
+        }
+        writesInFlight_++;
+    }
+    if (log.empty()) {
+        // Only the writes not merged are encoded on their own
+        log = encode();
+    }
+    sendWrites(std::move(log), std::move(cbs), true);
+}
 
+
+void Part::sendWrites(std::string log, std::vector<KVCallback> cbs, bool coalesced) {
+    VLOG_IF(3, cbs.size() > 1) << idStr_ << "Merge " << cbs.size() << " writes into one log";
     appendAsync(FLAGS_cluster_id, std::move(log))
-        .thenValue([this, callback = std::move(cb)] (AppendLogResult res) mutable {
-            callback(this->toResultCode(res));
+        .thenValue([this, self = shared_from_this(), cbs = std::move(cbs), coalesced]
+                   (AppendLogResult res) mutable {
+            auto code = this->toResultCode(res);
+            for (auto& cb : cbs) {
+                cb(code);
+            }
+            if (coalesced) {
+                // The promises could be fulfilled with the raft locks held, so the
+                // pending batch is sent out of the callback
+                executor_->add([this, self = std::move(self)] {
+                    onWritesDone();
+                });
+            }
         });
 }
 
+
+void Part::onWritesDone() {
+    std::string log;
+    std::vector<KVCallback> cbs;
+    {
+        std::lock_guard<std::mutex> g(writesLock_);
+        writesInFlight_--;
+        if (pendingCbs_.empty()) {
+            return;
+        }
+        log = encodeBatchValue(pendingWrites_.getBatch());
+        pendingWrites_.clear();
+        pendingBytes_ = 0;
+        cbs.swap(pendingCbs_);
+        writesInFlight_++;
+    }
+    sendWrites(std::move(log), std::move(cbs), true);
+}
+
 void Part::sync(KVCallback cb) {
     sendCommandAsync("")
         .thenValue([this, callback = std::move(cb)] (AppendLogResult res) mutable {
@@ -196,6 +310,12 @@ void Part::onDiscoverNewLeader(HostAddr nLeader) {
 
 bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
     auto batch = engine_->startBatchWrite();
+    bool committed = false;
+    SCOPE_EXIT {
+        if (listener_ != nullptr) {
+            listener_->onCommitted(committed);
+        }
+    };
     LogID lastId = -1;
     TermID lastTerm = -1;
     while (iter->valid()) {
@@ -217,17 +337,32 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
                 LOG(ERROR) << idStr_ << "Failed to call WriteBatch::put()";
                 return false;
             }
+            if (listener_ != nullptr) {
+                listener_->onPut(pieces[0]);
+            }
             break;
         }
         case OP_MULTI_PUT: {
-            auto kvs = decodeMultiValues(log);
-            // Make the number of values are an even number
-            DCHECK_EQ((kvs.size() + 1) / 2, kvs.size() / 2);
-            for (size_t i = 0; i < kvs.size(); i += 2) {
-                if (batch->put(kvs[i], kvs[i + 1]) != ResultCode::SUCCEEDED) {
-                    LOG(ERROR) << idStr_ << "Failed to call WriteBatch::put()";
-                    return false;
+            // The keys and values are in turn, and put straight from the log
+            folly::StringPiece key;
+            bool isKey = true;
+            auto succeeded = visitMultiValues(log, [&] (folly::StringPiece value) {
+                if (isKey) {
+                    key = value;
+                    isKey = false;
+                    return true;
                 }
+                isKey = true;
+                if (listener_ != nullptr) {
+                    listener_->onPut(key);
+                }
+                return batch->put(key, value) == ResultCode::SUCCEEDED;
+            });
+            // Make the number of values are an even number
+            DCHECK(isKey);
+            if (!succeeded) {
+                LOG(ERROR) << idStr_ << "Failed to call WriteBatch::put()";
+                return false;
             }
             break;
         }
@@ -237,20 +372,29 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
                 LOG(ERROR) << idStr_ << "Failed to call WriteBatch::remove()";
                 return false;
             }
+            if (listener_ != nullptr) {
+                listener_->onRemove(key);
+            }
             break;
         }
         case OP_MULTI_REMOVE: {
-            auto keys = decodeMultiValues(log);
-            for (auto k : keys) {
-                if (batch->remove(k) != ResultCode::SUCCEEDED) {
-                    LOG(ERROR) << idStr_ << "Failed to call WriteBatch::remove()";
-                    return false;
+            auto succeeded = visitMultiValues(log, [&] (folly::StringPiece key) {
+                if (listener_ != nullptr) {
+                    listener_->onRemove(key);
                 }
+                return batch->remove(key) == ResultCode::SUCCEEDED;
+            });
+            if (!succeeded) {
+                LOG(ERROR) << idStr_ << "Failed to call WriteBatch::remove()";
+                return false;
             }
             break;
         }
         case OP_REMOVE_PREFIX: {
             auto prefix = decodeSingleValue(log);
+            if (listener_ != nullptr) {
+                listener_->onRemovePrefix(prefix);
+            }
             if (batch->removePrefix(prefix) != ResultCode::SUCCEEDED) {
                 LOG(ERROR) << idStr_ << "Failed to call WriteBatch::removePrefix()";
                 return false;
@@ -260,6 +404,9 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
         case OP_REMOVE_RANGE: {
             auto range = decodeMultiValues(log);
             DCHECK_EQ(2, range.size());
+            if (listener_ != nullptr) {
+                listener_->onRemoveRange(range[0], range[1]);
+            }
             if (batch->removeRange(range[0], range[1]) != ResultCode::SUCCEEDED) {
                 LOG(ERROR) << idStr_ << "Failed to call WriteBatch::removeRange()";
                 return false;
@@ -267,23 +414,27 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
             break;
         }
         case OP_BATCH_WRITE: {
-            auto data = decodeBatchValue(log);
-            for (auto& op : data) {
+            auto succeeded = visitBatchValue(log, [&] (BatchLogType type,
+                                                       folly::StringPiece first,
+                                                       folly::StringPiece second) {
                 ResultCode code = ResultCode::SUCCEEDED;
-                if (op.first == BatchLogType::OP_BATCH_PUT) {
-                    code = batch->put(op.second.first, op.second.second);
-                } else if (op.first == BatchLogType::OP_BATCH_REMOVE) {
-                    code = batch->remove(op.second.first);
-                } else if (op.first == BatchLogType::OP_BATCH_REMOVE_RANGE) {
-                    code = batch->removeRange(op.second.first, op.second.second);
-                } else if (op.first == BatchLogType::OP_BATCH_REMOVE_PREFIX) {
-                    code = batch->removePrefix(op.second.first);
+                if (listener_ != nullptr) {
+                    notifyListener(type, first, second);
                 }
-
-                if (code != ResultCode::SUCCEEDED) {
-                    LOG(ERROR) << idStr_ << "Failed to call WriteBatch";
-                    return false;
+                if (type == BatchLogType::OP_BATCH_PUT) {
+                    code = batch->put(first, second);
+                } else if (type == BatchLogType::OP_BATCH_REMOVE) {
+                    code = batch->remove(first);
+                } else if (type == BatchLogType::OP_BATCH_REMOVE_RANGE) {
+                    code = batch->removeRange(first, second);
+                } else if (type == BatchLogType::OP_BATCH_REMOVE_PREFIX) {
+                    code = batch->removePrefix(first);
                 }
+                return code == ResultCode::SUCCEEDED;
+            });
+            if (!succeeded) {
+                LOG(ERROR) << idStr_ << "Failed to call WriteBatch";
+                return false;
             }
             break;
         }
@@ -319,20 +470,136 @@ bool Part::commitLogs(std::unique_ptr<LogIterator> iter) {
         ++(*iter);
     }
 
+    if (listener_ != nullptr && listener_->onCommit(batch.get()) != ResultCode::SUCCEEDED) {
+        LOG(ERROR) << idStr_ << "The commit listener failed";
+        return false;
+    }
     if (lastId >= 0) {
         if (putCommitMsg(batch.get(), lastId, lastTerm) != ResultCode::SUCCEEDED) {
             LOG(ERROR) << idStr_ << "Commit msg failed";
             return false;
         }
     }
-    return engine_->commitBatchWrite(std::move(batch)) == ResultCode::SUCCEEDED;
+    committed = engine_->commitBatchWrite(std::move(batch)) == ResultCode::SUCCEEDED;
+    return committed;
+}
+
+void Part::notifyListener(BatchLogType type,
+                          folly::StringPiece first,
+                          folly::StringPiece second) {
+    switch (type) {
+    case BatchLogType::OP_BATCH_PUT:
+        listener_->onPut(first);
+        break;
+    case BatchLogType::OP_BATCH_REMOVE:
+        listener_->onRemove(first);
+        break;
+    case BatchLogType::OP_BATCH_REMOVE_RANGE:
+        listener_->onRemoveRange(first, second);
+        break;
+    case BatchLogType::OP_BATCH_REMOVE_PREFIX:
+        listener_->onRemovePrefix(first);
+        break;
+    }
+}
+
+std::pair<int64_t, int64_t> Part::commitSnapshotFile(const raftex::cpp2::SnapshotFile& file) {
+    const auto& name = file.get_name();
+    auto idLen = name.find('_');
+    if (engine_->getDataRoot() == nullptr
+            || idLen == 0
+            || idLen == std::string::npos
+            || name.find('/') != std::string::npos) {
+        LOG(ERROR) << idStr_ << "Bad snapshot file " << name;
+        return std::make_pair(0, 0);
+    }
+    // The files left by another snapshot, which is abandoned or received before a restart,
+    // are dropped, so the chunks written are only skipped for the same snapshot
+    auto snapshotId = name.substr(0, idLen);
+    if (snapshotId != snapshotId_) {
+        LOG(INFO) << idStr_ << "Begin to receive the files of snapshot " << snapshotId;
+        removeSnapshotFiles();
+        snapshotId_ = std::move(snapshotId);
+    }
+    auto dir = snapshotDir();
+    if (!fs::FileUtils::exist(dir) && !fs::FileUtils::makeDir(dir)) {
+        LOG(ERROR) << idStr_ << "Make dir " << dir << " failed";
+        return std::make_pair(0, 0);
+    }
+    auto path = folly::stringPrintf("%s/%s", dir.c_str(), name.c_str());
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+    if (fd < 0) {
+        LOG(ERROR) << idStr_ << "Open " << path << " failed: " << strerror(errno);
+        return std::make_pair(0, 0);
+    }
+    SCOPE_EXIT {
+        ::close(fd);
+    };
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+        LOG(ERROR) << idStr_ << "Stat " << path << " failed: " << strerror(errno);
+        return std::make_pair(0, 0);
+    }
+
+    // The leader resends the chunk if it does not know whether the chunk is written,
+    // so only the part not written yet is written.
+    const auto& data = file.get_data();
+    int64_t size = st.st_size;
+    int64_t offset = file.get_offset();
+    int64_t end = offset + static_cast<int64_t>(data.size());
+    if (offset > size) {
+        LOG(ERROR) << idStr_ << "The snapshot file " << name << " has a gap, offset "
+                   << offset << ", size " << size;
+        return std::make_pair(0, 0);
+    }
+    if (end <= size) {
+        VLOG(1) << idStr_ << "Skip the chunk written of the snapshot file " << name
+                << ", offset " << offset;
+        return std::make_pair(0, 0);
+    }
+    const char* buf = data.data() + (size - offset);
+    while (size < end) {
+        auto written = ::pwrite(fd, buf, end - size, size);
+        if (written < 0) {
+            LOG(ERROR) << idStr_ << "Write " << path << " failed: " << strerror(errno);
+            return std::make_pair(0, 0);
+        }
+        buf += written;
+        size += written;
+    }
+    snapshotFiles_.emplace(name);
+    return std::make_pair(1, data.size());
 }
 
 std::pair<int64_t, int64_t> Part::commitSnapshot(const std::vector<std::string>& rows,
                                                  LogID committedLogId,
                                                  TermID committedLogTerm,
                                                  bool finished) {
+    if (finished && !snapshotFiles_.empty()) {
+        std::vector<std::string> files;
+        for (auto& name : snapshotFiles_) {
+            files.emplace_back(folly::stringPrintf("%s/%s", snapshotDir().c_str(), name.c_str()));
+        }
+        auto code = engine_->ingest(files);
+        removeSnapshotFiles();
+        if (code != ResultCode::SUCCEEDED) {
+            LOG(ERROR) << idStr_ << "Ingest the snapshot files failed, error "
+                       << static_cast<int32_t>(code);
+            // The counts never match, so the snapshot fails
+            return std::make_pair(-1, -1);
+        }
+        LOG(INFO) << idStr_ << "Ingested " << files.size() << " snapshot files";
+        if (listener_ != nullptr) {
+            listener_->onIngested();
+        }
+    }
     auto batch = engine_->startBatchWrite();
+    bool committed = false;
+    SCOPE_EXIT {
+        if (listener_ != nullptr) {
+            listener_->onCommitted(committed);
+        }
+    };
     int64_t count = 0;
     int64_t size = 0;
     for (auto& row : rows) {
@@ -343,6 +610,13 @@ std::pair<int64_t, int64_t> Part::commitSnapshot(const std::vector<std::string>&
             LOG(ERROR) << idStr_ << "Put failed in commit";
             return std::make_pair(0, 0);
         }
+        if (listener_ != nullptr) {
+            listener_->onPut(kv.first);
+        }
+    }
+    if (listener_ != nullptr && listener_->onCommit(batch.get()) != ResultCode::SUCCEEDED) {
+        LOG(ERROR) << idStr_ << "The commit listener failed";
+        return std::make_pair(0, 0);
     }
     if (finished) {
         if (ResultCode::SUCCEEDED != putCommitMsg(batch.get(), committedLogId, committedLogTerm)) {
@@ -354,9 +628,22 @@ std::pair<int64_t, int64_t> Part::commitSnapshot(const std::vector<std::string>&
         LOG(ERROR) << idStr_ << "Put failed in commit";
         return std::make_pair(0, 0);
     }
+    committed = true;
     return std::make_pair(count, size);
 }
 
+std::string Part::snapshotDir() const {
+    return folly::stringPrintf("%s/snapshot/recv_%d", engine_->getDataRoot(), partId_);
+}
+
+void Part::removeSnapshotFiles() {
+    snapshotId_.clear();
+    snapshotFiles_.clear();
+    if (engine_->getDataRoot() != nullptr) {
+        fs::FileUtils::remove(snapshotDir().c_str(), true);
+    }
+}
+
 ResultCode Part::putCommitMsg(WriteBatch* batch, LogID committedLogId, TermID committedLogTerm) {
     std::string commitMsg;
     commitMsg.reserve(sizeof(LogID) + sizeof(TermID));
@@ -368,7 +655,7 @@ ResultCode Part::putCommitMsg(WriteBatch* batch, LogID committedLogId, TermID co
 bool Part::preProcessLog(LogID logId,
                          TermID termId,
                          ClusterID clusterId,
-                         const std::string& log) {
+                         folly::StringPiece log) {
     VLOG(3) << idStr_ << "logId " << logId
             << ", termId " << termId
             << ", clusterId " << clusterId;
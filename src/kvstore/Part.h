@@ -11,16 +11,25 @@
 #include "base/NebulaKeyUtils.h"
 #include "raftex/RaftPart.h"
 #include "kvstore/Common.h"
+#include "kvstore/CommitListener.h"
 #include "kvstore/KVEngine.h"
+#include "kvstore/LogEncoder.h"
 #include "kvstore/raftex/SnapshotManager.h"
 #include "kvstore/wal/FileBasedWal.h"
 
 namespace nebula {
+namespace storage {
+class PartStatsTest_SnapshotFilesTest_Test;
+}  // namespace storage
+
 namespace kvstore {
 
 
 class Part : public raftex::RaftPart {
     friend class SnapshotManager;
+    FRIEND_TEST(PartTest, SnapshotFilesTest);
+    friend class storage::PartStatsTest_SnapshotFilesTest_Test;
+
 public:
     Part(GraphSpaceID spaceId,
          PartitionID partId,
@@ -30,7 +39,9 @@ public:
          std::shared_ptr<folly::IOThreadPoolExecutor> pool,
          std::shared_ptr<thread::GenericThreadPool> workers,
          std::shared_ptr<folly::Executor> handlers,
-         std::shared_ptr<raftex::SnapshotManager> snapshotMan);
+         std::shared_ptr<raftex::SnapshotManager> snapshotMan,
+         std::shared_ptr<wal::SharedWal> sharedWal = nullptr,
+         std::unique_ptr<PartCommitListener> listener = nullptr);
 
     virtual ~Part() {
         LOG(INFO) << idStr_ << "~Part()";
@@ -82,6 +93,9 @@ public:
             LOG(WARNING) << idStr_ << "Remove the committedLogId failed, error "
                          << static_cast<int32_t>(res);
         }
+        if (listener_ != nullptr) {
+            listener_->onReset();
+        }
     }
 
 private:
@@ -98,10 +112,14 @@ private:
 
     bool commitLogs(std::unique_ptr<LogIterator> iter) override;
 
+    void notifyListener(BatchLogType type, folly::StringPiece first, folly::StringPiece second);
+
     bool preProcessLog(LogID logId,
                        TermID termId,
                        ClusterID clusterId,
-                       const std::string& log) override;
+                       folly::StringPiece log) override;
+
+    std::pair<int64_t, int64_t> commitSnapshotFile(const raftex::cpp2::SnapshotFile& file) override;
 
     std::pair<int64_t, int64_t> commitSnapshot(const std::vector<std::string>& data,
                                                LogID committedLogId,
@@ -110,8 +128,17 @@ private:
 
     ResultCode putCommitMsg(WriteBatch* batch, LogID committedLogId, TermID committedLogTerm);
 
+    LogID durableLogId() override {
+        return engine_->durableLogId(partId_);
+    }
+
     void cleanup() override {
         LOG(INFO) << idStr_ << "Clean up all data, just reset the committedLogId!";
+        removeSnapshotFiles();
+        if (listener_ != nullptr) {
+            // The data is replaced by the snapshot
+            listener_->onReset();
+        }
         auto batch = engine_->startBatchWrite();
         if (ResultCode::SUCCEEDED != putCommitMsg(batch.get(), 0, 0)) {
             LOG(ERROR) << idStr_ << "Put failed in commit";
@@ -127,12 +154,46 @@ private:
 
     ResultCode toResultCode(raftex::AppendLogResult res);
 
+    /**
+     * Append the log of a write encoded by encode(). If raft_max_inflight_batches writes of
+     * the part are in flight, the write is merged into the pending batch by toBatch()
+     * instead, and the batch is appended as one log once a write in flight is done or the
+     * batch holds write_coalescing_max_bytes of the keys and values, counted by bytes.
+     * */
+    void appendWrite(size_t bytes,
+                     folly::FunctionRef<std::string()> encode,
+                     folly::FunctionRef<void(BatchHolder&)> toBatch,
+                     KVCallback cb);
+
+    // The coalesced writes send the pending batch when they are done
+    void sendWrites(std::string log, std::vector<KVCallback> cbs, bool coalesced);
+
+    void onWritesDone();
+
+    // The directory holding the snapshot files received
+    std::string snapshotDir() const;
+
+    void removeSnapshotFiles();
+
 protected:
     GraphSpaceID spaceId_;
     PartitionID partId_;
     std::string walPath_;
     KVEngine* engine_ = nullptr;
     NewLeaderCallback newLeaderCb_ = nullptr;
+    // Watches the writes committed, called by the commit thread only
+    std::unique_ptr<PartCommitListener> listener_;
+    // The id of the snapshot whose files are received, which prefixes their names
+    std::string snapshotId_;
+    // The names of the snapshot files received, they are ingested in order
+    std::set<std::string> snapshotFiles_;
+
+    // Protects the writes coalesced
+    std::mutex writesLock_;
+    uint32_t writesInFlight_{0};
+    BatchHolder pendingWrites_;
+    size_t pendingBytes_{0};
+    std::vector<KVCallback> pendingCbs_;
 };
 
 }  // namespace kvstore
@@ -107,7 +107,10 @@ void MetaServerBasedPartManager::onSpaceOptionUpdated(
         "max_bytes_for_level_multiplier",
         "ttl",
         "block_size",
-        "block_restart_interval"
+        "block_restart_interval",
+        // Handled by the wal of the parts instead of rocksdb
+        "wal_sync_policy",
+        "wal_sync_interval_ms"
     };
     static std::unordered_set<std::string> supportedDbOpt = {
         "max_total_wal_size",
@@ -53,6 +53,8 @@ public:
     ResultCode removePrefix(folly::StringPiece prefix) override {
         rocksdb::Slice pre(prefix.begin(), prefix.size());
         rocksdb::ReadOptions options;
+        // The prefix may be shorter than the one of the prefix extractor
+        options.total_order_seek = true;
         std::unique_ptr<rocksdb::Iterator> iter(db_->NewIterator(options));
         iter->Seek(pre);
         while (iter->Valid()) {
@@ -110,7 +112,7 @@ RocksEngine::RocksEngine(GraphSpaceID spaceId,
 
     rocksdb::Options options;
     rocksdb::DB* db = nullptr;
-    rocksdb::Status status = initRocksdbOptions(options);
+    rocksdb::Status status = initRocksdbOptions(options, spaceId);
     CHECK(status.ok());
     if (mergeOp != nullptr) {
         options.merge_operator = mergeOp;
@@ -118,6 +120,7 @@ RocksEngine::RocksEngine(GraphSpaceID spaceId,
     if (cfFactory != nullptr) {
         options.compaction_filter_factory = cfFactory;
     }
+    prefixExtractor_ = options.prefix_extractor;
     status = rocksdb::DB::Open(options, path, &db);
     CHECK(status.ok()) << status.ToString();
     db_.reset(db);
@@ -183,44 +186,78 @@ std::vector<Status> RocksEngine::multiGet(const std::vector<std::string>& keys,
 }
 
 
+rocksdb::Iterator* RocksEngine::newIterator(std::string upperBound,
+                                            const ReadContext& ctx,
+                                            std::unique_ptr<RocksReadResource>* res,
+                                            folly::StringPiece seekPrefix) {
+    *res = std::make_unique<RocksReadResource>(std::move(upperBound), ctx.snapshot_);
+    rocksdb::ReadOptions options;
+    // Stop the iterator at the upper bound, instead of walking through
+    // the tombstones beyond it.
+    options.iterate_upper_bound = (*res)->upperBound();
+    options.fill_cache = ctx.fillCache_;
+    if (prefixExtractor_ != nullptr) {
+        // Only the seeks which cover a whole extracted prefix could use the
+        // prefix bloom filter, all others must be in total order.
+        if (prefixExtractor_->InDomain(toSlice(seekPrefix))) {
+            options.prefix_same_as_start = true;
+        } else {
+            options.total_order_seek = true;
+        }
+    }
+    if (ctx.snapshot_ != nullptr) {
+        options.snapshot = static_cast<const RocksSnapshot*>(ctx.snapshot_.get())->get();
+    }
+    return db_->NewIterator(options);
+}
+
+
 ResultCode RocksEngine::range(const std::string& start,
                               const std::string& end,
-                              std::unique_ptr<KVIterator>* storageIter) {
-    rocksdb::ReadOptions options;
-    rocksdb::Iterator* iter = db_->NewIterator(options);
+                              std::unique_ptr<KVIterator>* storageIter,
+                              const ReadContext& ctx) {
+    std::unique_ptr<RocksReadResource> res;
+    rocksdb::Iterator* iter = newIterator(end, ctx, &res);
     if (iter) {
         iter->Seek(rocksdb::Slice(start));
     }
-    storageIter->reset(new RocksRangeIter(iter, start, end));
+    storageIter->reset(new RocksRangeIter(iter, start, end, std::move(res)));
     return ResultCode::SUCCEEDED;
 }
 
 
 ResultCode RocksEngine::prefix(const std::string& prefix,
-                               std::unique_ptr<KVIterator>* storageIter) {
-    rocksdb::ReadOptions options;
-    rocksdb::Iterator* iter = db_->NewIterator(options);
+                               std::unique_ptr<KVIterator>* storageIter,
+                               const ReadContext& ctx) {
+    std::unique_ptr<RocksReadResource> res;
+    rocksdb::Iterator* iter = newIterator(prefixSuccessor(prefix), ctx, &res, prefix);
     if (iter) {
         iter->Seek(rocksdb::Slice(prefix));
     }
-    storageIter->reset(new RocksPrefixIter(iter, prefix));
+    storageIter->reset(new RocksPrefixIter(iter, prefix, std::move(res)));
     return ResultCode::SUCCEEDED;
 }
 
 
 ResultCode RocksEngine::rangeWithPrefix(const std::string& start,
                                         const std::string& prefix,
-                                        std::unique_ptr<KVIterator>* storageIter) {
-    rocksdb::ReadOptions options;
-    rocksdb::Iterator* iter = db_->NewIterator(options);
+                                        std::unique_ptr<KVIterator>* storageIter,
+                                        const ReadContext& ctx) {
+    std::unique_ptr<RocksReadResource> res;
+    rocksdb::Iterator* iter = newIterator(prefixSuccessor(prefix), ctx, &res);
     if (iter) {
         iter->Seek(rocksdb::Slice(start));
     }
-    storageIter->reset(new RocksPrefixIter(iter, prefix));
+    storageIter->reset(new RocksPrefixIter(iter, prefix, std::move(res)));
     return ResultCode::SUCCEEDED;
 }
 
 
+std::shared_ptr<const KVSnapshot> RocksEngine::getSnapshot() {
+    return std::make_shared<RocksSnapshot>(db_.get());
+}
+
+
 ResultCode RocksEngine::put(std::string key, std::string value) {
     rocksdb::WriteOptions options;
     options.disableWAL = FLAGS_rocksdb_disable_wal;
@@ -300,6 +337,7 @@ ResultCode RocksEngine::removeRange(const std::string& start,
 ResultCode RocksEngine::removePrefix(const std::string& prefix) {
     rocksdb::Slice pre(prefix.data(), prefix.size());
     rocksdb::ReadOptions readOptions;
+    readOptions.total_order_seek = true;
     rocksdb::WriteBatch batch;
     std::unique_ptr<rocksdb::Iterator> iter(db_->NewIterator(readOptions));
     iter->Seek(pre);
@@ -498,5 +536,67 @@ ResultCode RocksEngine::createCheckpoint(const std::string& name) {
     return ResultCode::SUCCEEDED;
 }
 
+
+ResultCode RocksEngine::exportPart(PartitionID partId,
+                                   const std::string& dir,
+                                   int64_t fileSize,
+                                   folly::Function<bool(const std::string& file)> onFile) {
+    if (!FileUtils::exist(dir) && !FileUtils::makeDir(dir)) {
+        LOG(ERROR) << "Make dir " << dir << " failed";
+        return ResultCode::ERR_IO_ERROR;
+    }
+    // Iterate all the data of the part at a point in time, without polluting the cache
+    ReadContext ctx;
+    ctx.snapshot_ = getSnapshot();
+    ctx.fillCache_ = false;
+    std::unique_ptr<KVIterator> iter;
+    auto ret = prefix(NebulaKeyUtils::prefix(partId), &iter, ctx);
+    if (ret != ResultCode::SUCCEEDED) {
+        return ret;
+    }
+
+    // The sst files must be built with the same comparator as the db
+    rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), db_->GetOptions());
+    std::string path;
+    int32_t fileNum = 0;
+    auto finishFile = [&] () -> ResultCode {
+        auto status = writer.Finish();
+        if (!status.ok()) {
+            LOG(ERROR) << "Finish sst file " << path << " failed: " << status.ToString();
+            return ResultCode::ERR_IO_ERROR;
+        }
+        if (!onFile(path)) {
+            return ResultCode::ERR_UNKNOWN;
+        }
+        path.clear();
+        return ResultCode::SUCCEEDED;
+    };
+    for (; iter && iter->valid(); iter->next()) {
+        if (path.empty()) {
+            path = folly::stringPrintf("%s/%d_%06d.sst", dir.c_str(), partId, fileNum++);
+            auto status = writer.Open(path);
+            if (!status.ok()) {
+                LOG(ERROR) << "Open sst file " << path << " failed: " << status.ToString();
+                return ResultCode::ERR_IO_ERROR;
+            }
+        }
+        auto status = writer.Put(toSlice(iter->key()), toSlice(iter->val()));
+        if (!status.ok()) {
+            LOG(ERROR) << "Write sst file " << path << " failed: " << status.ToString();
+            return ResultCode::ERR_IO_ERROR;
+        }
+        if (static_cast<int64_t>(writer.FileSize()) >= fileSize) {
+            ret = finishFile();
+            if (ret != ResultCode::SUCCEEDED) {
+                return ret;
+            }
+        }
+    }
+    if (!path.empty()) {
+        return finishFile();
+    }
+    return ResultCode::SUCCEEDED;
+}
+
 }  // namespace kvstore
 }  // namespace nebula
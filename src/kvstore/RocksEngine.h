@@ -10,6 +10,7 @@
 #include <gtest/gtest_prod.h>
 #include <rocksdb/db.h>
 #include <rocksdb/utilities/checkpoint.h>
+#include <rocksdb/sst_file_writer.h>
 #include "base/Base.h"
 #include "kvstore/KVIterator.h"
 #include "kvstore/KVEngine.h"
@@ -17,10 +18,55 @@
 namespace nebula {
 namespace kvstore {
 
+class RocksSnapshot : public KVSnapshot {
+public:
+    explicit RocksSnapshot(rocksdb::DB* db)
+        : db_(db)
+        , snapshot_(db->GetSnapshot()) {}
+
+    ~RocksSnapshot() {
+        db_->ReleaseSnapshot(snapshot_);
+    }
+
+    const rocksdb::Snapshot* get() const {
+        return snapshot_;
+    }
+
+private:
+    rocksdb::DB* db_{nullptr};
+    const rocksdb::Snapshot* snapshot_{nullptr};
+};
+
+/**
+ * Holds what the rocksdb iterator refers to through its ReadOptions,
+ * so it must be destroyed after the iterator.
+ * */
+class RocksReadResource {
+public:
+    RocksReadResource(std::string upperBound, std::shared_ptr<const KVSnapshot> snapshot)
+        : upperBound_(std::move(upperBound))
+        , upperBoundSlice_(upperBound_)
+        , snapshot_(std::move(snapshot)) {}
+
+    // Return nullptr if there is no upper bound
+    const rocksdb::Slice* upperBound() const {
+        return upperBound_.empty() ? nullptr : &upperBoundSlice_;
+    }
+
+private:
+    std::string upperBound_;
+    rocksdb::Slice upperBoundSlice_;
+    std::shared_ptr<const KVSnapshot> snapshot_;
+};
+
 class RocksRangeIter : public KVIterator {
 public:
-    RocksRangeIter(rocksdb::Iterator* iter, rocksdb::Slice start, rocksdb::Slice end)
-        : iter_(iter)
+    RocksRangeIter(rocksdb::Iterator* iter,
+                   rocksdb::Slice start,
+                   rocksdb::Slice end,
+                   std::unique_ptr<RocksReadResource> res = nullptr)
+        : res_(std::move(res))
+        , iter_(iter)
         , start_(start)
         , end_(end) {}
 
@@ -47,6 +93,7 @@ public:
     }
 
 private:
+    std::unique_ptr<RocksReadResource> res_;
     std::unique_ptr<rocksdb::Iterator> iter_;
     rocksdb::Slice start_;
     rocksdb::Slice end_;
@@ -54,8 +101,11 @@ private:
 
 class RocksPrefixIter : public KVIterator {
 public:
-    RocksPrefixIter(rocksdb::Iterator* iter, rocksdb::Slice prefix)
-        : iter_(iter)
+    RocksPrefixIter(rocksdb::Iterator* iter,
+                    rocksdb::Slice prefix,
+                    std::unique_ptr<RocksReadResource> res = nullptr)
+        : res_(std::move(res))
+        , iter_(iter)
         , prefix_(prefix) {}
 
     ~RocksPrefixIter()  = default;
@@ -81,6 +131,7 @@ public:
     }
 
 protected:
+    std::unique_ptr<RocksReadResource> res_;
     std::unique_ptr<rocksdb::Iterator> iter_;
     rocksdb::Slice prefix_;
 };
@@ -118,16 +169,25 @@ public:
     std::vector<Status> multiGet(const std::vector<std::string>& keys,
                                  std::vector<std::string>* values) override;
 
+    using KVEngine::range;
+    using KVEngine::prefix;
+    using KVEngine::rangeWithPrefix;
+
     ResultCode range(const std::string& start,
                      const std::string& end,
-                     std::unique_ptr<KVIterator>* iter) override;
+                     std::unique_ptr<KVIterator>* iter,
+                     const ReadContext& ctx) override;
 
     ResultCode prefix(const std::string& prefix,
-                      std::unique_ptr<KVIterator>* iter) override;
+                      std::unique_ptr<KVIterator>* iter,
+                      const ReadContext& ctx) override;
 
     ResultCode rangeWithPrefix(const std::string& start,
                                const std::string& prefix,
-                               std::unique_ptr<KVIterator>* iter) override;
+                               std::unique_ptr<KVIterator>* iter,
+                               const ReadContext& ctx) override;
+
+    std::shared_ptr<const KVSnapshot> getSnapshot() override;
 
     /*********************
      * Data modification
@@ -173,12 +233,26 @@ public:
      ********************/
     ResultCode createCheckpoint(const std::string& path) override;
 
+    ResultCode exportPart(PartitionID partId,
+                          const std::string& dir,
+                          int64_t fileSize,
+                          folly::Function<bool(const std::string& file)> onFile) override;
+
 private:
     std::string partKey(PartitionID partId);
 
+    // Build the rocksdb iterator with the upper bound and the read context.
+    // If the seekPrefix is not empty, the iterator only reads the keys with it,
+    // which could be served by the prefix bloom filter.
+    rocksdb::Iterator* newIterator(std::string upperBound,
+                                   const ReadContext& ctx,
+                                   std::unique_ptr<RocksReadResource>* res,
+                                   folly::StringPiece seekPrefix = "");
+
 private:
     std::string  dataPath_;
     std::unique_ptr<rocksdb::DB> db_{nullptr};
+    std::shared_ptr<const rocksdb::SliceTransform> prefixExtractor_{nullptr};
     int32_t partsNum_ = -1;
 };
 
@@ -11,7 +11,9 @@
 #include "rocksdb/convenience.h"
 #include "rocksdb/utilities/options_util.h"
 #include "rocksdb/slice_transform.h"
+#include "rocksdb/filter_policy.h"
 #include "base/Configuration.h"
+#include "kvstore/NebulaSliceTransform.h"
 
 // [WAL]
 DEFINE_bool(rocksdb_disable_wal,
@@ -44,11 +46,22 @@ DEFINE_int32(rocksdb_batch_size,
 DEFINE_int64(rocksdb_block_cache, 1024,
              "The default block cache size used in BlockBasedTable. The unit is MB");
 
+DEFINE_bool(enable_rocksdb_prefix_filtering, false,
+            "Whether to enable the prefix bloom filter on (partId, vertexId, tagId/edgeType)");
+
+DEFINE_string(rocksdb_prefix_filtering_spaces, "",
+              "Comma separated space ids to enable the prefix bloom filter, "
+              "empty means all spaces");
+
+DEFINE_double(rocksdb_memtable_prefix_bloom_size_ratio, 0.1,
+              "The memtable prefix bloom size ratio to write_buffer_size, "
+              "only used when the prefix filtering is enabled");
+
 
 namespace nebula {
 namespace kvstore {
 
-rocksdb::Status initRocksdbOptions(rocksdb::Options &baseOpts) {
+rocksdb::Status initRocksdbOptions(rocksdb::Options &baseOpts, GraphSpaceID spaceId) {
     rocksdb::Status s;
     rocksdb::DBOptions dbOpts;
     rocksdb::ColumnFamilyOptions cfOpts;
@@ -87,11 +100,34 @@ rocksdb::Status initRocksdbOptions(rocksdb::Options &baseOpts) {
     static std::shared_ptr<rocksdb::Cache> blockCache
         = rocksdb::NewLRUCache(FLAGS_rocksdb_block_cache * 1024 * 1024);
     bbtOpts.block_cache = blockCache;
+    if (prefixFilteringEnabled(spaceId)) {
+        LOG(INFO) << "Enable the prefix bloom filter for space " << spaceId;
+        baseOpts.prefix_extractor = std::make_shared<NebulaSliceTransform>();
+        baseOpts.memtable_prefix_bloom_size_ratio = FLAGS_rocksdb_memtable_prefix_bloom_size_ratio;
+        if (bbtOpts.filter_policy == nullptr) {
+            bbtOpts.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10, false));
+        }
+    }
     baseOpts.table_factory.reset(NewBlockBasedTableFactory(bbtOpts));
     baseOpts.create_if_missing = true;
     return s;
 }
 
+bool prefixFilteringEnabled(GraphSpaceID spaceId) {
+    if (!FLAGS_enable_rocksdb_prefix_filtering) {
+        return false;
+    }
+    if (FLAGS_rocksdb_prefix_filtering_spaces.empty()) {
+        return true;
+    }
+    std::vector<std::string> spaces;
+    folly::split(",", FLAGS_rocksdb_prefix_filtering_spaces, spaces, true);
+    return std::any_of(spaces.begin(), spaces.end(), [spaceId] (const auto& space) {
+        auto id = folly::tryTo<GraphSpaceID>(folly::trimWhitespace(space));
+        return id.hasValue() && id.value() == spaceId;
+    });
+}
+
 bool loadOptionsMap(std::unordered_map<std::string, std::string> &map, const std::string& gflags) {
     Configuration conf;
     auto status = conf.parseFromString(gflags);
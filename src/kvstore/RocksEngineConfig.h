@@ -33,13 +33,21 @@ DECLARE_int64(rocksdb_block_cache);
 
 DECLARE_int32(rocksdb_batch_size);
 
+// Prefix bloom filter on the vertex and edge keys
+DECLARE_bool(enable_rocksdb_prefix_filtering);
+DECLARE_string(rocksdb_prefix_filtering_spaces);
+DECLARE_double(rocksdb_memtable_prefix_bloom_size_ratio);
+
 DECLARE_string(part_man_type);
 
 
 namespace nebula {
 namespace kvstore {
 
-rocksdb::Status initRocksdbOptions(rocksdb::Options &baseOpts);
+rocksdb::Status initRocksdbOptions(rocksdb::Options &baseOpts, GraphSpaceID spaceId);
+
+// Whether the prefix bloom filter is enabled for the space
+bool prefixFilteringEnabled(GraphSpaceID spaceId);
 
 bool loadOptionsMap(std::unordered_map<std::string, std::string> &map, const std::string& gflags);
 
@@ -6,8 +6,17 @@
 #include "kvstore/SnapshotManagerImpl.h"
 #include "base/NebulaKeyUtils.h"
 #include "kvstore/LogEncoder.h"
+#include "kvstore/Part.h"
+#include "fs/FileUtils.h"
+#include "time/WallClock.h"
+#include <folly/ScopeGuard.h>
 
 DEFINE_int32(snapshot_batch_size, 1024 * 1024 * 10, "batch size for snapshot");
+DEFINE_bool(snapshot_send_files, true,
+            "Send the snapshot as sst files, which the receiver ingests directly, "
+            "if the engine supports it");
+DEFINE_int64(snapshot_file_size, 256 * 1024 * 1024,
+             "The size of each sst file when the snapshot is sent as files");
 
 namespace nebula {
 namespace kvstore {
@@ -51,6 +60,94 @@ void SnapshotManagerImpl::accessAllRowsInSnapshot(GraphSpaceID spaceId,
     }
     cb(data, totalCount, totalSize, raftex::SnapshotStatus::DONE);
 }
+
+bool SnapshotManagerImpl::accessAllFilesInSnapshot(GraphSpaceID spaceId,
+                                                   PartitionID partId,
+                                                   raftex::SnapshotFileCallback cb) {
+    CHECK_NOTNULL(store_);
+    if (!FLAGS_snapshot_send_files) {
+        return false;
+    }
+    auto partRet = store_->part(spaceId, partId);
+    if (!nebula::ok(partRet)) {
+        return false;
+    }
+    auto* engine = nebula::value(partRet)->engine();
+    if (engine->getDataRoot() == nullptr) {
+        return false;
+    }
+    // Only one file is kept locally at a time, it is removed once sent
+    auto dir = folly::stringPrintf("%s/snapshot/send_%d", engine->getDataRoot(), partId);
+    fs::FileUtils::remove(dir.c_str(), true);
+    SCOPE_EXIT {
+        fs::FileUtils::remove(dir.c_str(), true);
+    };
+
+    // The names are prefixed by the id of the snapshot, so the receiver never mixes up the
+    // files of another snapshot of the part with the same names
+    auto snapshotId = time::WallClock::slowNowInMicroSec();
+    int64_t totalSize = 0;
+    int64_t totalCount = 0;
+    bool failed = false;
+    auto ret = engine->exportPart(partId,
+                                  dir,
+                                  FLAGS_snapshot_file_size,
+                                  [&] (const std::string& path) -> bool {
+        SCOPE_EXIT {
+            fs::FileUtils::remove(path.c_str());
+        };
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            LOG(ERROR) << "Open " << path << " failed: " << strerror(errno);
+            return false;
+        }
+        SCOPE_EXIT {
+            ::close(fd);
+        };
+        raftex::cpp2::SnapshotFile file;
+        file.set_name(folly::stringPrintf("%ld_%s",
+                                          snapshotId,
+                                          path.substr(path.rfind('/') + 1).c_str()));
+        file.set_offset(0);
+        std::string buf;
+        while (true) {
+            buf.resize(FLAGS_snapshot_batch_size);
+            auto len = ::pread(fd, &buf[0], buf.size(), file.get_offset());
+            if (len < 0) {
+                LOG(ERROR) << "Read " << path << " failed: " << strerror(errno);
+                return false;
+            }
+            if (len == 0) {
+                return true;
+            }
+            buf.resize(len);
+            totalCount++;
+            totalSize += len;
+            file.set_data(std::move(buf));
+            if (!cb(&file, totalCount, totalSize, raftex::SnapshotStatus::IN_PROGRESS)) {
+                // The callback has failed the snapshot
+                failed = true;
+                return false;
+            }
+            file.set_offset(file.get_offset() + len);
+            buf = std::move(file.data);
+        }
+    });
+    if (ret == ResultCode::ERR_UNSUPPORTED && totalCount == 0) {
+        return false;
+    }
+    if (failed) {
+        return true;
+    }
+    if (ret != ResultCode::SUCCEEDED) {
+        LOG(INFO) << "[spaceId:" << spaceId << ", partId:" << partId << "] export files failed"
+                  << ", error code:" << static_cast<int32_t>(ret);
+        cb(nullptr, totalCount, totalSize, raftex::SnapshotStatus::FAILED);
+        return true;
+    }
+    cb(nullptr, totalCount, totalSize, raftex::SnapshotStatus::DONE);
+    return true;
+}
 }  // namespace kvstore
 }  // namespace nebula
 
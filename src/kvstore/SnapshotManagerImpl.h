@@ -22,6 +22,10 @@ public:
                                  PartitionID partId,
                                  raftex::SnapshotCallback cb) override;
 
+    bool accessAllFilesInSnapshot(GraphSpaceID spaceId,
+                                  PartitionID partId,
+                                  raftex::SnapshotFileCallback cb) override;
+
 private:
     KVStore* store_;
 };
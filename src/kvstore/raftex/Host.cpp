@@ -17,6 +17,9 @@ DEFINE_uint32(max_appendlog_batch_size, 128,
 DEFINE_uint32(max_outstanding_requests, 1024,
               "The max number of outstanding appendLog requests");
 DEFINE_int32(raft_rpc_timeout_ms, 500, "rpc timeout for raft client");
+DEFINE_uint32(raft_max_inflight_append_requests, 1,
+              "The max number of appendLog requests sent to one host without waiting"
+              " for the responses");
 
 DECLARE_bool(trace_raft);
 
@@ -33,8 +36,7 @@ Host::Host(const HostAddr& addr, std::shared_ptr<RaftPart> part, bool isLearner)
             "%s[Host: %s:%d] ",
             part_->idStr_.c_str(),
             NetworkUtils::intToIPv4(addr_.first).c_str(),
-            addr_.second))
-        , cachingPromise_(folly::SharedPromise<cpp2::AppendLogResponse>()) {
+            addr_.second)) {
 }
 
 
@@ -43,7 +45,7 @@ void Host::waitForStop() {
 
     CHECK(stopped_);
     noMoreRequestCV_.wait(g, [this] {
-        return !requestOnGoing_;
+        return inflightRequests_ == 0;
     });
     LOG(INFO) << idStr_ << "The host has been stopped!";
 }
@@ -104,34 +106,19 @@ folly::Future<cpp2::AppendLogResponse> Host::appendLogs(
                   << "]";
     }
     auto ret = folly::Future<cpp2::AppendLogResponse>::makeEmpty();
-    std::shared_ptr<cpp2::AppendLogRequest> req;
+    std::vector<std::shared_ptr<cpp2::AppendLogRequest>> reqs;
     {
         std::lock_guard<std::mutex> g(lock_);
 
         auto res = checkStatus();
-        if (logId <= lastLogIdSent_) {
+        if (logId <= lastLogIdAccepted_) {
             LOG(INFO) << idStr_ << "The log " << logId << " has been sended"
-                      << ", lastLogIdSent " << lastLogIdSent_;
+                      << ", lastLogIdAccepted " << lastLogIdAccepted_;
             cpp2::AppendLogResponse r;
             r.set_error_code(cpp2::ErrorCode::SUCCEEDED);
             return r;
         }
 
-        if (requestOnGoing_ && res == cpp2::ErrorCode::SUCCEEDED) {
-            if (cachingPromise_.size() <= FLAGS_max_outstanding_requests) {
-                pendingReq_ = std::make_tuple(term,
-                                              logId,
-                                              committedLogId);
-                return cachingPromise_.getFuture();
-            } else {
-                PLOG_EVERY_N(INFO, 200) << idStr_
-                          << "Too many requests are waiting, return error";
-                cpp2::AppendLogResponse r;
-                r.set_error_code(cpp2::ErrorCode::E_TOO_MANY_REQUESTS);
-                return r;
-            }
-        }
-
         if (res != cpp2::ErrorCode::SUCCEEDED) {
             VLOG(2) << idStr_
                     << "The host is not in a proper status, just return";
@@ -140,66 +127,82 @@ folly::Future<cpp2::AppendLogResponse> Host::appendLogs(
             return r;
         }
 
-        VLOG(2) << idStr_ << "About to send the AppendLog request";
-
-        // No request is ongoing, let's send a new request
-        if (UNLIKELY(lastLogIdSent_ == 0 && lastLogTermSent_ == 0)) {
-            LOG(INFO) << idStr_ << "This is the first time to send the logs to this host";
-            lastLogIdSent_ = prevLogId;
-            lastLogTermSent_ = prevLogTerm;
-        }
-        if (prevLogTerm < lastLogTermSent_ || prevLogId < lastLogIdSent_) {
-            LOG(INFO) << idStr_ << "We have sended this log, so go on from id " << lastLogIdSent_
-                      << ", term " << lastLogTermSent_ << "; current prev log id " << prevLogId
-                      << ", current prev log term " << prevLogTerm;
+        if (inflightRequests_ > 0) {
+            if (promises_.size() > FLAGS_max_outstanding_requests) {
+                PLOG_EVERY_N(INFO, 200) << idStr_
+                          << "Too many requests are waiting, return error";
+                cpp2::AppendLogResponse r;
+                r.set_error_code(cpp2::ErrorCode::E_TOO_MANY_REQUESTS);
+                return r;
+            }
+            // The logs follow the ones being sent
+            logIdToSend_ = std::max(logIdToSend_, logId);
+            committedLogId_ = std::max(committedLogId_, committedLogId);
+        } else {
+            if (UNLIKELY(lastLogIdSent_ == 0 && lastLogTermSent_ == 0)) {
+                LOG(INFO) << idStr_ << "This is the first time to send the logs to this host";
+                lastLogIdSent_ = lastLogIdAccepted_ = prevLogId;
+                lastLogTermSent_ = lastLogTermAccepted_ = prevLogTerm;
+            }
+            if (prevLogTerm < lastLogTermSent_ || prevLogId < lastLogIdSent_) {
+                LOG(INFO) << idStr_ << "We have sended this log, so go on from id "
+                          << lastLogIdSent_ << ", term " << lastLogTermSent_
+                          << "; current prev log id " << prevLogId
+                          << ", current prev log term " << prevLogTerm;
+            }
+            logIdToSend_ = logId;
+            committedLogId_ = committedLogId;
         }
         logTermToSend_ = term;
-        logIdToSend_ = logId;
-        committedLogId_ = committedLogId;
-        pendingReq_ = std::make_tuple(0, 0, 0);
-        promise_ = std::move(cachingPromise_);
-        cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
-        ret = promise_.getFuture();
-
-        requestOnGoing_ = true;
+        ret = promises_[logId].getFuture();
 
-        req = prepareAppendLogRequest();
+        VLOG(2) << idStr_ << "About to send the AppendLog request";
+        reqs = prepareAppendLogRequests();
     }
 
-    // Get a new promise
-    appendLogsInternal(eb, std::move(req));
+    for (auto& req : reqs) {
+        appendLogsInternal(eb, std::move(req));
+    }
 
     return ret;
 }
 
+void Host::setAccepted(const cpp2::AppendLogResponse& r) {
+    CHECK(!lock_.try_lock());
+    if (r.get_last_log_id() > lastLogIdAccepted_) {
+        lastLogIdAccepted_ = r.get_last_log_id();
+        lastLogTermAccepted_ = r.get_last_log_term();
+    }
+    followerCommittedLogId_ = r.get_committed_log_id();
+    auto it = promises_.begin();
+    while (it != promises_.end() && it->first <= lastLogIdAccepted_) {
+        it->second.setValue(r);
+        it = promises_.erase(it);
+    }
+}
+
 void Host::setResponse(const cpp2::AppendLogResponse& r) {
     CHECK(!lock_.try_lock());
-    promise_.setValue(r);
-    cachingPromise_.setValue(r);
-    cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
-    pendingReq_ = std::make_tuple(0, 0, 0);
-    requestOnGoing_ = false;
+    for (auto& p : promises_) {
+        p.second.setValue(r);
+    }
+    promises_.clear();
 }
 
 void Host::appendLogsInternal(folly::EventBase* eb,
                               std::shared_ptr<cpp2::AppendLogRequest> req) {
+    bool sentNothing = req->get_log_str_list().empty();
     sendAppendLogRequest(eb, std::move(req)).via(eb).then(
-            [eb, self = shared_from_this()] (folly::Try<cpp2::AppendLogResponse>&& t) {
+            [eb, sentNothing, self = shared_from_this()]
+            (folly::Try<cpp2::AppendLogResponse>&& t) {
         VLOG(3) << self->idStr_ << "appendLogs() call got response";
+        cpp2::AppendLogResponse resp;
         if (t.hasException()) {
             VLOG(2) << self->idStr_ << t.exception().what();
-            cpp2::AppendLogResponse r;
-            r.set_error_code(cpp2::ErrorCode::E_EXCEPTION);
-            {
-                std::lock_guard<std::mutex> g(self->lock_);
-                self->setResponse(r);
-                self->lastLogIdSent_ = self->logIdToSend_ - 1;
-            }
-            self->noMoreRequestCV_.notify_all();
-            return;
+            resp.set_error_code(cpp2::ErrorCode::E_EXCEPTION);
+        } else {
+            resp = std::move(t).value();
         }
-
-        cpp2::AppendLogResponse resp = std::move(t).value();
         if (FLAGS_trace_raft) {
             LOG(INFO)
                 << self->idStr_ << "AppendLogResponse "
@@ -211,193 +214,170 @@ void Host::appendLogsInternal(folly::EventBase* eb,
                 << ", lastLogIdSent_ " << self->lastLogIdSent_
                 << ", lastLogTermSent_ " << self->lastLogTermSent_;
         }
-        switch (resp.get_error_code()) {
-            case cpp2::ErrorCode::SUCCEEDED: {
-                VLOG(2) << self->idStr_
-                        << "AppendLog request sent successfully";
-
-                std::shared_ptr<cpp2::AppendLogRequest> newReq;
-                {
-                    std::lock_guard<std::mutex> g(self->lock_);
-                    auto res = self->checkStatus();
-                    if (res != cpp2::ErrorCode::SUCCEEDED) {
-                        VLOG(2) << self->idStr_
-                                << "The host is not in a proper status,"
-                                   " just return";
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(res);
-                        self->setResponse(r);
-                    } else if (self->lastLogIdSent_ >= resp.get_last_log_id()) {
-                        VLOG(1) << self->idStr_
-                                << "We send nothing in the last request"
-                                << ", so we don't send the same logs again";
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(res);
-                        self->setResponse(r);
-                    } else {
-                        self->lastLogIdSent_ = resp.get_last_log_id();
-                        self->lastLogTermSent_ = resp.get_last_log_term();
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        if (self->lastLogIdSent_ < self->logIdToSend_) {
-                            // More to send
-                            VLOG(2) << self->idStr_
-                                    << "There are more logs to send";
-                            newReq = self->prepareAppendLogRequest();
-                        } else {
-                            VLOG(2) << self->idStr_
-                                    << "Fulfill the promise, size = " << self->promise_.size();
-                            // Fulfill the promise
-                            self->promise_.setValue(resp);
-
-                            if (self->noRequest()) {
-                                VLOG(2) << self->idStr_ << "No request any more!";
-                                self->requestOnGoing_ = false;
-                            } else {
-                                auto& tup = self->pendingReq_;
-                                self->logTermToSend_ = std::get<0>(tup);
-                                self->logIdToSend_ = std::get<1>(tup);
-                                self->committedLogId_ = std::get<2>(tup);
-                                VLOG(2) << self->idStr_
-                                        << "Sending the pending request in the queue"
-                                        << ", from " << self->lastLogIdSent_ + 1
-                                        << " to " << self->logIdToSend_;
-                                newReq = self->prepareAppendLogRequest();
-                                self->promise_ = std::move(self->cachingPromise_);
-                                self->cachingPromise_
-                                    = folly::SharedPromise<cpp2::AppendLogResponse>();
-                                self->pendingReq_ = std::make_tuple(0, 0, 0);
-                            }  // self->noRequest()
-                        }  // self->lastLogIdSent_ < self->logIdToSend_
-                    }  // else
-                }
-                if (newReq) {
-                    self->appendLogsInternal(eb, newReq);
-                } else {
-                    self->noMoreRequestCV_.notify_all();
-                }
-                return;
+
+        std::vector<std::shared_ptr<cpp2::AppendLogRequest>> newReqs;
+        bool noMoreRequest = false;
+        {
+            std::lock_guard<std::mutex> g(self->lock_);
+            newReqs = self->processAppendLogResponse(resp, sentNothing);
+            noMoreRequest = self->inflightRequests_ == 0;
+        }
+        for (auto& newReq : newReqs) {
+            self->appendLogsInternal(eb, std::move(newReq));
+        }
+        if (noMoreRequest) {
+            self->noMoreRequestCV_.notify_all();
+        }
+    });
+}
+
+
+std::vector<std::shared_ptr<cpp2::AppendLogRequest>>
+Host::processAppendLogResponse(const cpp2::AppendLogResponse& resp, bool sentNothing) {
+    CHECK(!lock_.try_lock());
+    CHECK_GT(inflightRequests_, 0);
+    --inflightRequests_;
+
+    auto res = checkStatus();
+    if (res != cpp2::ErrorCode::SUCCEEDED) {
+        VLOG(2) << idStr_
+                << "The host is not in a proper status, just return";
+        cpp2::AppendLogResponse r;
+        r.set_error_code(res);
+        setResponse(r);
+        return {};
+    }
+
+    switch (resp.get_error_code()) {
+        case cpp2::ErrorCode::SUCCEEDED: {
+            VLOG(2) << idStr_ << "AppendLog request sent successfully";
+            setAccepted(resp);
+            if (inflightRequests_ > 0) {
+                break;
+            }
+            // All the requests sent have been responded
+            if (probing_) {
+                VLOG(1) << idStr_ << "The follower accepts the logs again, from "
+                        << lastLogIdAccepted_;
+                probing_ = false;
+            }
+            lastLogIdSent_ = lastLogIdAccepted_;
+            lastLogTermSent_ = lastLogTermAccepted_;
+            if (sentNothing) {
+                VLOG(1) << idStr_
+                        << "We send nothing in the last request"
+                        << ", so we don't send the same logs again";
+                setResponse(resp);
+                return {};
+            }
+            break;
+        }
+        case cpp2::ErrorCode::E_LOG_GAP:
+        case cpp2::ErrorCode::E_WAITING_SNAPSHOT:
+        case cpp2::ErrorCode::E_LOG_STALE: {
+            // The follower might receive the pipelined requests out of order, so wait for
+            // all the inflight ones to be responded, then go on one request at a time
+            // from the position the follower tells
+            probing_ = true;
+            if (inflightRequests_ > 0) {
+                VLOG(2) << idStr_ << "Wait for the inflight requests to catch up the follower";
+                return {};
             }
-            case cpp2::ErrorCode::E_LOG_GAP: {
-                VLOG(2) << self->idStr_
+            if (resp.get_error_code() == cpp2::ErrorCode::E_LOG_GAP) {
+                VLOG(2) << idStr_
                         << "The host's log is behind, need to catch up";
-                std::shared_ptr<cpp2::AppendLogRequest> newReq;
-                {
-                    std::lock_guard<std::mutex> g(self->lock_);
-                    auto res = self->checkStatus();
-                    if (res != cpp2::ErrorCode::SUCCEEDED) {
-                        VLOG(2) << self->idStr_
-                                << "The host is not in a proper status,"
-                                   " skip catching up the gap";
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(res);
-                        self->setResponse(r);
-                    } else if (self->lastLogIdSent_ == resp.get_last_log_id()) {
-                        VLOG(1) << self->idStr_
-                                << "We send nothing in the last request"
-                                << ", so we don't send the same logs again";
-                        self->lastLogIdSent_ = resp.get_last_log_id();
-                        self->lastLogTermSent_ = resp.get_last_log_term();
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(cpp2::ErrorCode::SUCCEEDED);
-                        self->setResponse(r);
-                    } else {
-                        self->lastLogIdSent_ = resp.get_last_log_id();
-                        self->lastLogTermSent_ = resp.get_last_log_term();
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        newReq = self->prepareAppendLogRequest();
-                    }
-                }
-                if (newReq) {
-                    self->appendLogsInternal(eb, newReq);
-                } else {
-                    self->noMoreRequestCV_.notify_all();
+                if (lastLogIdSent_ == resp.get_last_log_id()) {
+                    VLOG(1) << idStr_
+                            << "We send nothing in the last request"
+                            << ", so we don't send the same logs again";
+                    lastLogIdSent_ = resp.get_last_log_id();
+                    lastLogTermSent_ = resp.get_last_log_term();
+                    cpp2::AppendLogResponse r;
+                    r.set_error_code(cpp2::ErrorCode::SUCCEEDED);
+                    r.set_last_log_id(resp.get_last_log_id());
+                    r.set_last_log_term(resp.get_last_log_term());
+                    r.set_committed_log_id(resp.get_committed_log_id());
+                    setAccepted(r);
+                    setResponse(r);
+                    return {};
                 }
-                return;
-            }
-            case cpp2::ErrorCode::E_WAITING_SNAPSHOT: {
-                VLOG(2) << self->idStr_
+                lastLogIdSent_ = resp.get_last_log_id();
+                lastLogTermSent_ = resp.get_last_log_term();
+            } else if (resp.get_error_code() == cpp2::ErrorCode::E_WAITING_SNAPSHOT) {
+                VLOG(2) << idStr_
                         << "The host is waiting for the snapshot, so we need to send log from "
-                        << " current committedLogId " << self->committedLogId_;
-                std::shared_ptr<cpp2::AppendLogRequest> newReq;
-                {
-                    std::lock_guard<std::mutex> g(self->lock_);
-                    auto res = self->checkStatus();
-                    if (res != cpp2::ErrorCode::SUCCEEDED) {
-                        VLOG(2) << self->idStr_
-                                << "The host is not in a proper status,"
-                                   " skip waiting the snapshot";
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(res);
-                        self->setResponse(r);
-                    } else {
-                        self->lastLogIdSent_ = self->committedLogId_;
-                        self->lastLogTermSent_ = self->logTermToSend_;
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        newReq = self->prepareAppendLogRequest();
-                    }
-                }
-                if (newReq) {
-                    self->appendLogsInternal(eb, newReq);
-                } else {
-                    self->noMoreRequestCV_.notify_all();
-                }
-                return;
-            }
-            case cpp2::ErrorCode::E_LOG_STALE: {
-                VLOG(2) << self->idStr_ << "Log stale, reset lastLogIdSent " << self->lastLogIdSent_
+                        << " current committedLogId " << committedLogId_;
+                lastLogIdSent_ = committedLogId_;
+                lastLogTermSent_ = logTermToSend_;
+            } else {
+                VLOG(2) << idStr_ << "Log stale, reset lastLogIdSent " << lastLogIdSent_
                         << " to the followers lastLodId " << resp.get_last_log_id();
-                std::shared_ptr<cpp2::AppendLogRequest> newReq;
-                {
-                    std::lock_guard<std::mutex> g(self->lock_);
-                    auto res = self->checkStatus();
-                    if (res != cpp2::ErrorCode::SUCCEEDED) {
-                        VLOG(2) << self->idStr_
-                                << "The host is not in a proper status,"
-                                   " skip waiting the snapshot";
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(res);
-                        self->setResponse(r);
-                    } else if (self->logIdToSend_ <= resp.get_last_log_id()) {
-                        VLOG(1) << self->idStr_
-                                << "It means the request has been received by follower";
-                        self->lastLogIdSent_ = resp.get_last_log_id();
-                        self->lastLogTermSent_ = resp.get_last_log_term();
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        cpp2::AppendLogResponse r;
-                        r.set_error_code(cpp2::ErrorCode::SUCCEEDED);
-                        self->setResponse(r);
-                    } else {
-                        self->lastLogIdSent_ = resp.get_last_log_id();
-                        self->lastLogTermSent_ = resp.get_last_log_term();
-                        self->followerCommittedLogId_ = resp.get_committed_log_id();
-                        newReq = self->prepareAppendLogRequest();
-                    }
-                }
-                if (newReq) {
-                    self->appendLogsInternal(eb, newReq);
-                } else {
-                    self->noMoreRequestCV_.notify_all();
+                lastLogIdSent_ = resp.get_last_log_id();
+                lastLogTermSent_ = resp.get_last_log_term();
+                if (logIdToSend_ <= resp.get_last_log_id()) {
+                    VLOG(1) << idStr_
+                            << "It means the request has been received by follower";
+                    cpp2::AppendLogResponse r;
+                    r.set_error_code(cpp2::ErrorCode::SUCCEEDED);
+                    r.set_last_log_id(resp.get_last_log_id());
+                    r.set_last_log_term(resp.get_last_log_term());
+                    r.set_committed_log_id(resp.get_committed_log_id());
+                    setAccepted(r);
+                    setResponse(r);
+                    return {};
                 }
-                return;
             }
-            default: {
-                PLOG_EVERY_N(ERROR, 100)
-                           << self->idStr_
-                           << "Failed to append logs to the host (Err: "
-                           << static_cast<int32_t>(resp.get_error_code())
-                           << ")";
-                {
-                    std::lock_guard<std::mutex> g(self->lock_);
-                    self->setResponse(resp);
-                    self->lastLogIdSent_ = self->logIdToSend_ - 1;
-                }
-                self->noMoreRequestCV_.notify_all();
-                return;
+            followerCommittedLogId_ = resp.get_committed_log_id();
+            break;
+        }
+        default: {
+            PLOG_EVERY_N(ERROR, 100)
+                       << idStr_
+                       << "Failed to append logs to the host (Err: "
+                       << static_cast<int32_t>(resp.get_error_code())
+                       << ")";
+            setResponse(resp);
+            // Go on from the logs accepted when the next logs come
+            probing_ = true;
+            if (inflightRequests_ == 0) {
+                lastLogIdSent_ = lastLogIdAccepted_;
+                lastLogTermSent_ = lastLogTermAccepted_;
             }
+            return {};
         }
-    });
+    }
+    return prepareAppendLogRequests();
+}
+
+
+std::vector<std::shared_ptr<cpp2::AppendLogRequest>>
+Host::prepareAppendLogRequests() {
+    CHECK(!lock_.try_lock());
+    std::vector<std::shared_ptr<cpp2::AppendLogRequest>> reqs;
+    size_t maxInflight = probing_
+        ? 1
+        : std::max<size_t>(FLAGS_raft_max_inflight_append_requests, 1);
+    while (inflightRequests_ < maxInflight
+            && !promises_.empty()
+            && lastLogIdSent_ < logIdToSend_) {
+        auto nextLogId = lastLogIdSent_ + 1;
+        if (inflightRequests_ > 0
+                && (nextLogId < part_->wal()->firstLogId()
+                        || nextLogId > part_->wal()->lastLogId())) {
+            // Send the snapshot or nothing after the inflight requests are responded
+            break;
+        }
+        auto req = prepareAppendLogRequest();
+        ++inflightRequests_;
+        reqs.emplace_back(req);
+        if (req->get_log_str_list().empty()) {
+            break;
+        }
+        // The next request follows this one without waiting for its response
+        lastLogIdSent_ += req->get_log_str_list().size();
+        lastLogTermSent_ = req->get_log_term();
+    }
+    return reqs;
 }
 
 
@@ -438,7 +418,7 @@ Host::prepareAppendLogRequest() {
              ++(*it), ++cnt) {
             cpp2::LogEntry le;
             le.set_cluster(it->logSource());
-            le.set_log_str(it->logMsg().toString());
+            le.set_log_str(it->logBuf());
             logs.emplace_back(std::move(le));
         }
         req->set_log_str_list(std::move(logs));
@@ -498,12 +478,6 @@ folly::Future<cpp2::AppendLogResponse> Host::sendAppendLogRequest(
     return client->future_appendLog(*req);
 }
 
-bool Host::noRequest() const {
-    CHECK(!lock_.try_lock());
-    static auto emptyTup = std::make_tuple(0, 0, 0);
-    return pendingReq_ == emptyTup;
-}
-
 }  // namespace raftex
 }  // namespace nebula
 
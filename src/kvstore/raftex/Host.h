@@ -91,10 +91,20 @@ private:
         folly::EventBase* eb,
         std::shared_ptr<cpp2::AppendLogRequest> req);
 
+    // Process the response of one inflight request, and return the requests to send next
+    std::vector<std::shared_ptr<cpp2::AppendLogRequest>> processAppendLogResponse(
+        const cpp2::AppendLogResponse& resp,
+        bool sentNothing);
+
+    // Prepare the requests which could be sent without waiting for the inflight ones
+    std::vector<std::shared_ptr<cpp2::AppendLogRequest>> prepareAppendLogRequests();
+
     std::shared_ptr<cpp2::AppendLogRequest> prepareAppendLogRequest();
 
-    bool noRequest() const;
+    // Fulfill the promises of the logs accepted by the follower
+    void setAccepted(const cpp2::AppendLogResponse& r);
 
+    // Fulfill all the promises left
     void setResponse(const cpp2::AppendLogResponse& r);
 
     thrift::ThriftClientManager<cpp2::RaftexServiceAsyncClient>& tcManager() {
@@ -103,9 +113,6 @@ private:
     }
 
 private:
-    // <term, logId, committedLogId>
-    using Request = std::tuple<TermID, LogID, LogID>;
-
     std::shared_ptr<RaftPart> part_;
     const HostAddr addr_;
     bool isLearner_ = false;
@@ -116,21 +123,28 @@ private:
     bool paused_{false};
     bool stopped_{false};
 
-    bool requestOnGoing_{false};
+    // The number of requests sent but not responded, at most
+    // FLAGS_raft_max_inflight_append_requests
+    size_t inflightRequests_{0};
+    // After an error response, only one request is sent at a time, until the follower
+    // accepts the logs again
+    bool probing_{false};
     std::condition_variable noMoreRequestCV_;
-    folly::SharedPromise<cpp2::AppendLogResponse> promise_;
-    folly::SharedPromise<cpp2::AppendLogResponse> cachingPromise_;
-
-    Request pendingReq_{0, 0, 0};
+    // The promises waiting for the follower to accept the log id
+    std::map<LogID, folly::SharedPromise<cpp2::AppendLogResponse>> promises_;
 
     // These logId and term pointing to the latest log we need to send
     LogID logIdToSend_{0};
     TermID logTermToSend_{0};
 
-    // The previous log before this batch
+    // The last log sent, the next request starts after it
     LogID lastLogIdSent_{0};
     TermID lastLogTermSent_{0};
 
+    // The last log the follower has accepted
+    LogID lastLogIdAccepted_{0};
+    TermID lastLogTermAccepted_{0};
+
     LogID committedLogId_{0};
     std::atomic_bool sendingSnapshot_{false};
 
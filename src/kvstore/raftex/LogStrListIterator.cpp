@@ -18,6 +18,10 @@ LogStrListIterator::LogStrListIterator(
         , term_(term)
         , logEntries_(std::move(logEntries)) {
     idx_ = 0;
+    // Each log is read as a piece of string, so make it contiguous
+    for (auto& entry : logEntries_) {
+        entry.log_str.coalesce();
+    }
 }
 
 
@@ -52,7 +56,14 @@ ClusterID LogStrListIterator::logSource() const {
 
 folly::StringPiece LogStrListIterator::logMsg() const {
     DCHECK(valid());
-    return logEntries_.at(idx_).get_log_str();
+    auto& log = logEntries_.at(idx_).get_log_str();
+    return folly::StringPiece(reinterpret_cast<const char*>(log.data()), log.length());
+}
+
+
+folly::IOBuf LogStrListIterator::logBuf() const {
+    DCHECK(valid());
+    return logEntries_.at(idx_).get_log_str().cloneOneAsValue();
 }
 
 }  // namespace raftex
@@ -14,6 +14,10 @@
 namespace nebula {
 namespace raftex {
 
+/**
+ * Iterates the logs received in an AppendLog request. The logs share the
+ * buffer of the request, which is received without copying.
+ * */
 class LogStrListIterator final : public LogIterator {
 public:
     LogStrListIterator(LogID firstLogId,
@@ -28,6 +32,7 @@ public:
     TermID logTerm() const override;
     ClusterID logSource() const override;
     folly::StringPiece logMsg() const override;
+    folly::IOBuf logBuf() const override;
 
 private:
     const LogID firstLogId_;
@@ -9,6 +9,7 @@
 #include <folly/io/async/EventBaseManager.h>
 #include <folly/executors/IOThreadPoolExecutor.h>
 #include <folly/gen/Base.h>
+#include <folly/ScopeGuard.h>
 #include "gen-cpp2/RaftexServiceAsyncClient.h"
 #include "base/CollectNSucceeded.h"
 #include "thrift/ThriftClientManager.h"
@@ -27,13 +28,23 @@ DEFINE_uint32(raft_heartbeat_interval_secs, 5,
 DEFINE_uint64(raft_snapshot_timeout, 60 * 5, "Max seconds between two snapshot requests");
 
 DEFINE_uint32(max_batch_size, 256, "The max number of logs in a batch");
+DEFINE_uint32(raft_max_inflight_batches, 1,
+              "The max number of log batches being replicated at the same time,"
+              " the batches are committed in order");
 
 DEFINE_int32(wal_ttl, 86400, "Default wal ttl");
 DEFINE_int64(wal_file_size, 16 * 1024 * 1024, "Default wal file size");
 DEFINE_int32(wal_buffer_size, 8 * 1024 * 1024, "Default wal buffer size");
 DEFINE_int32(wal_buffer_num, 2, "Default wal buffer number");
+DEFINE_string(wal_sync_policy, "async",
+              "Default wal durability: async (synced when the file is closed), "
+              "interval (synced every wal_sync_interval_ms), "
+              "or sync (synced before acknowledging)");
+DEFINE_int32(wal_sync_interval_ms, 100, "Default wal sync interval for the interval policy");
 DEFINE_bool(trace_raft, false, "Enable trace one raft request");
 
+DECLARE_int32(raft_rpc_timeout_ms);
+
 namespace nebula {
 namespace raftex {
 
@@ -202,7 +213,8 @@ RaftPart::RaftPart(ClusterID clusterId,
                    std::shared_ptr<folly::IOThreadPoolExecutor> pool,
                    std::shared_ptr<thread::GenericThreadPool> workers,
                    std::shared_ptr<folly::Executor> executor,
-                   std::shared_ptr<SnapshotManager> snapshotMan)
+                   std::shared_ptr<SnapshotManager> snapshotMan,
+                   std::shared_ptr<wal::SharedWal> sharedWal)
         : idStr_{folly::stringPrintf("[Port: %d, Space: %d, Part: %d] ",
                                      localAddr.second, spaceId, partId)}
         , clusterId_{clusterId}
@@ -222,18 +234,28 @@ RaftPart::RaftPart(ClusterID clusterId,
     policy.fileSize = FLAGS_wal_file_size;
     policy.bufferSize = FLAGS_wal_buffer_size;
     policy.numBuffers = FLAGS_wal_buffer_num;
+    auto syncPolicy = FileBasedWal::toSyncPolicy(FLAGS_wal_sync_policy);
+    if (syncPolicy.ok()) {
+        policy.sync = syncPolicy.value();
+    } else {
+        LOG(WARNING) << idStr_ << syncPolicy.status() << ", use async";
+    }
+    policy.syncIntervalMs = FLAGS_wal_sync_interval_ms;
     wal_ = FileBasedWal::getWal(walRoot,
                                 idStr_,
                                 policy,
                                 [this] (LogID logId,
                                         TermID logTermId,
                                         ClusterID logClusterId,
-                                        const std::string& log) {
+                                        folly::StringPiece log) {
                                     return this->preProcessLog(logId,
                                                                logTermId,
                                                                logClusterId,
                                                                log);
-                                });
+                                },
+                                std::move(sharedWal),
+                                spaceId,
+                                partId);
     logs_.reserve(FLAGS_max_batch_size);
     CHECK(!!executor_) << idStr_ << "Should not be nullptr";
 }
@@ -328,6 +350,7 @@ void RaftPart::stop() {
         role_ = Role::FOLLOWER;
 
         hosts = std::move(hosts_);
+        notifyCommitWaiters();
     }
 
     for (auto& h : hosts) {
@@ -553,7 +576,6 @@ folly::Future<AppendLogResult> RaftPart::appendLogAsync(ClusterID source,
         return AppendLogResult::E_WRITE_BLOCKING;
     }
 
-    LogCache swappedOutLogs;
     auto retFuture = folly::Future<AppendLogResult>::makeEmpty();
 
     if (bufferOverFlow_) {
@@ -595,77 +617,149 @@ folly::Future<AppendLogResult> RaftPart::appendLogAsync(ClusterID source,
                 break;
         }
 
-        bool expected = false;
-        if (replicatingLogs_.compare_exchange_strong(expected, true)) {
-            // We need to send logs to all followers
-            VLOG(2) << idStr_ << "Preparing to send AppendLog request";
-            sendingPromise_ = std::move(cachingPromise_);
-            cachingPromise_.reset();
-            std::swap(swappedOutLogs, logs_);
-            bufferOverFlow_ = false;
-        } else {
+        if (replicatingLogs_) {
             VLOG(2) << idStr_
-                    << "Another AppendLogs request is ongoing,"
+                    << "Another thread is writing the logs,"
                        " just return";
             return retFuture;
         }
-    }
-
-    LogID firstId = 0;
-    TermID termId = 0;
-    AppendLogResult res;
-    {
-        std::lock_guard<std::mutex> g(raftLock_);
-        res = canAppendLogs();
-        if (res == AppendLogResult::SUCCEEDED) {
-            firstId = lastLogId_ + 1;
-            termId = term_;
+        if (!hasBatchToReplicate()) {
+            VLOG(2) << idStr_
+                    << "Too many batches are being replicated,"
+                       " just return";
+            return retFuture;
         }
+        // We need to send logs to all followers
+        VLOG(2) << idStr_ << "Preparing to send AppendLog request";
+        replicatingLogs_ = true;
     }
 
-    if (!checkAppendLogResult(res)) {
-        // Mosy likely failed because the parttion is not leader
-        PLOG_EVERY_N(ERROR, 100) << idStr_ << "Cannot append logs, clean the buffer";
-        return res;
-    }
     // Replicate buffered logs to all followers
     // Replication will happen on a separate thread and will block
     // until majority accept the logs, the leadership changes, or
     // the partition stops
-    VLOG(2) << idStr_ << "Calling appendLogsInternal()";
-    AppendLogsIterator it(
-        firstId,
-        termId,
-        std::move(swappedOutLogs),
-        [this] (AtomicOp opCB) -> std::string {
-            CHECK(opCB != nullptr);
-            auto opRet = opCB();
-            if (opRet.empty()) {
-                // Failed
-                sendingPromise_.setOneSingleValue(AppendLogResult::E_ATOMIC_OP_FAILURE);
-            }
-            return opRet;
-        });
-    appendLogsInternal(std::move(it), termId);
+    replicateBatches();
 
     return retFuture;
 }
 
-void RaftPart::appendLogsInternal(AppendLogsIterator iter, TermID termId) {
-    TermID currTerm = 0;
-    LogID prevLogId = 0;
-    TermID prevLogTerm = 0;
-    LogID committed = 0;
-    LogID lastId = 0;
-    if (iter.valid()) {
-        VLOG(2) << idStr_ << "Ready to append logs from id "
-                << iter.logId() << " (Current term is "
-                << currTerm << ")";
-    } else {
-        LOG(ERROR) << idStr_ << "Only happend when Atomic op failed";
-        replicatingLogs_ = false;
-        return;
+
+bool RaftPart::hasBatchToReplicate() const {
+    CHECK(!logsLock_.try_lock());
+    if (pendingIter_ != nullptr
+            || (!logs_.empty() && std::get<1>(logs_.front()) == LogType::ATOMIC_OP)) {
+        // An AtomicOp should be evaluated after all previous logs have been committed,
+        // and the logs after a COMMAND should wait for it, so the batch waits for
+        // all the inflight ones
+        return inflightBatches_.empty();
+    }
+    return !logs_.empty()
+        && inflightBatches_.size() < std::max(FLAGS_raft_max_inflight_batches, 1U);
+}
+
+
+void RaftPart::replicateBatches() {
+    while (true) {
+        std::shared_ptr<ReplicatingBatch> batch;
+        std::unique_ptr<AppendLogsIterator> iter;
+        std::shared_ptr<PromiseSet<AppendLogResult>> promise;
+        AppendLogResult res = AppendLogResult::SUCCEEDED;
+        {
+            std::lock_guard<std::mutex> lck(logsLock_);
+            CHECK(replicatingLogs_);
+            res = prepareNextBatch(batch, iter, promise);
+            if (res == AppendLogResult::SUCCEEDED && batch == nullptr) {
+                replicatingLogs_ = false;
+                VLOG(2) << idStr_ << "No more log to be replicated for now";
+                return;
+            }
+        }
+
+        if (!checkAppendLogResult(res)) {
+            // Mosy likely failed because the parttion is not leader
+            PLOG_EVERY_N(ERROR, 100) << idStr_ << "Cannot append logs, clean the buffer";
+            continue;
+        }
+        VLOG(2) << idStr_ << "Calling appendLogsInternal()";
+        appendLogsInternal(std::move(iter), std::move(promise), std::move(batch));
+    }
+}
+
+
+AppendLogResult RaftPart::prepareNextBatch(
+        std::shared_ptr<ReplicatingBatch>& batch,
+        std::unique_ptr<AppendLogsIterator>& iter,
+        std::shared_ptr<PromiseSet<AppendLogResult>>& promise) {
+    CHECK(!logsLock_.try_lock());
+    while (hasBatchToReplicate()) {
+        TermID termId = 0;
+        LogID prevLogId = 0;
+        TermID prevLogTerm = 0;
+        {
+            std::lock_guard<std::mutex> g(raftLock_);
+            auto res = canAppendLogs();
+            if (res != AppendLogResult::SUCCEEDED) {
+                return res;
+            }
+            termId = term_;
+            prevLogId = lastLogId_;
+            prevLogTerm = lastLogTerm_;
+        }
+        if (!inflightBatches_.empty()) {
+            // The batch follows the last inflight one
+            prevLogId = inflightBatches_.back()->lastLogId;
+            prevLogTerm = inflightBatches_.back()->term;
+        }
+
+        if (pendingIter_ != nullptr) {
+            // Continue to process the remaining logs, all the logs before have been committed
+            iter = std::move(pendingIter_);
+            promise = std::move(pendingPromise_);
+            iter->resume();
+        } else {
+            promise = std::make_shared<PromiseSet<AppendLogResult>>(std::move(cachingPromise_));
+            cachingPromise_.reset();
+            iter = std::make_unique<AppendLogsIterator>(
+                prevLogId + 1,
+                termId,
+                std::move(logs_),
+                [promise] (AtomicOp op) -> std::string {
+                    CHECK(op != nullptr);
+                    auto opRet = op();
+                    if (opRet.empty()) {
+                        // Failed
+                        promise->setOneSingleValue(AppendLogResult::E_ATOMIC_OP_FAILURE);
+                    }
+                    return opRet;
+                });
+            logs_.clear();
+            bufferOverFlow_ = false;
+        }
+
+        if (!iter->valid()) {
+            // All the AtomicOps left have failed
+            VLOG(2) << idStr_ << "No valid log in the batch";
+            iter.reset();
+            promise.reset();
+            continue;
+        }
+
+        batch = std::make_shared<ReplicatingBatch>();
+        batch->term = iter->logTerm();
+        batch->prevLogId = prevLogId;
+        batch->prevLogTerm = prevLogTerm;
+        return AppendLogResult::SUCCEEDED;
     }
+    return AppendLogResult::SUCCEEDED;
+}
+
+
+void RaftPart::appendLogsInternal(std::unique_ptr<AppendLogsIterator> iter,
+                                  std::shared_ptr<PromiseSet<AppendLogResult>> promise,
+                                  std::shared_ptr<ReplicatingBatch> batch) {
+    VLOG(2) << idStr_ << "Ready to append logs from id "
+            << iter->logId() << " (Current term is "
+            << batch->term << ")";
     AppendLogResult res = AppendLogResult::SUCCEEDED;
     do {
         std::lock_guard<std::mutex> g(raftLock_);
@@ -682,56 +776,58 @@ void RaftPart::appendLogsInternal(AppendLogsIterator iter, TermID termId) {
             res = AppendLogResult::E_NOT_A_LEADER;
             break;
         }
-        if (term_ != termId) {
+        if (term_ != batch->term) {
             VLOG(2) << idStr_ << "Term has been updated, origin "
-                    << termId << ", new " << term_;
+                    << batch->term << ", new " << term_;
             res = AppendLogResult::E_TERM_OUT_OF_DATE;
             break;
         }
-        currTerm = term_;
-        prevLogId = lastLogId_;
-        prevLogTerm = lastLogTerm_;
-        committed = committedLogId_;
+        batch->committedId = committedLogId_;
         // Step 1: Write WAL
         SlowOpTracker tracker;
-        if (!wal_->appendLogs(iter)) {
+        if (!wal_->appendLogs(*iter)) {
             LOG(ERROR) << idStr_ << "Failed to write into WAL";
             res = AppendLogResult::E_WAL_FAILURE;
             break;
         }
-        lastId = wal_->lastLogId();
+        batch->lastLogId = wal_->lastLogId();
         if (tracker.slow()) {
             tracker.output(idStr_, folly::stringPrintf("Write WAL, total %ld",
-                                                       lastId - prevLogId + 1));
+                                                       batch->lastLogId - batch->prevLogId + 1));
         }
         VLOG(2) << idStr_ << "Succeeded writing logs ["
-                << iter.firstLogId() << ", " << lastId << "] to WAL";
+                << batch->prevLogId + 1 << ", " << batch->lastLogId << "] to WAL";
     } while (false);
 
     if (!checkAppendLogResult(res)) {
         LOG(ERROR) << idStr_ << "Failed append logs";
+        // The logs of the batch and the remaining ones are dropped as well
+        promise->setValue(res);
         return;
     }
+
+    {
+        std::lock_guard<std::mutex> lck(logsLock_);
+        if (iter->empty()) {
+            batch->promise = std::move(*promise);
+        } else {
+            // The remaining logs lead by an AtomicOp or follow a COMMAND, they will be
+            // replicated after all the inflight batches have been committed
+            batch->promise = promise->splitFront(iter->hasNonAtomicOpLogs(),
+                                                 iter->leadByAtomicOp());
+            pendingIter_ = std::move(iter);
+            pendingPromise_ = std::move(promise);
+        }
+        inflightBatches_.emplace_back(batch);
+    }
+
     // Step 2: Replicate to followers
     auto* eb = ioThreadPool_->getEventBase();
-    replicateLogs(eb,
-                  std::move(iter),
-                  currTerm,
-                  lastId,
-                  committed,
-                  prevLogTerm,
-                  prevLogId);
-    return;
+    replicateLogs(eb, std::move(batch));
 }
 
 
-void RaftPart::replicateLogs(folly::EventBase* eb,
-                             AppendLogsIterator iter,
-                             TermID currTerm,
-                             LogID lastLogId,
-                             LogID committedId,
-                             TermID prevLogTerm,
-                             LogID prevLogId) {
+void RaftPart::replicateLogs(folly::EventBase* eb, std::shared_ptr<ReplicatingBatch> batch) {
     using namespace folly;  // NOLINT since the fancy overload of | operator
 
     decltype(hosts_) hosts;
@@ -763,6 +859,11 @@ void RaftPart::replicateLogs(folly::EventBase* eb,
 
     VLOG(2) << idStr_ << "About to replicate logs to all peer hosts";
 
+    auto currTerm = batch->term;
+    auto lastLogId = batch->lastLogId;
+    auto committedId = batch->committedId;
+    auto prevLogTerm = batch->prevLogTerm;
+    auto prevLogId = batch->prevLogId;
     lastMsgSentDur_.reset();
     SlowOpTracker tracker;
     collectNSucceeded(
@@ -797,12 +898,9 @@ void RaftPart::replicateLogs(folly::EventBase* eb,
         .via(executor_.get())
             .then([self = shared_from_this(),
                    eb,
-                   it = std::move(iter),
-                   currTerm,
+                   batch = std::move(batch),
                    lastLogId,
-                   committedId,
                    prevLogId,
-                   prevLogTerm,
                    pHosts = std::move(hosts),
                    tracker] (folly::Try<AppendLogResponses>&& result) mutable {
             VLOG(2) << self->idStr_ << "Received enough response";
@@ -813,12 +911,7 @@ void RaftPart::replicateLogs(folly::EventBase* eb,
             }
             self->processAppendLogResponses(*result,
                                             eb,
-                                            std::move(it),
-                                            currTerm,
-                                            lastLogId,
-                                            committedId,
-                                            prevLogTerm,
-                                            prevLogId,
+                                            std::move(batch),
                                             std::move(pHosts));
 
             return *result;
@@ -829,12 +922,7 @@ void RaftPart::replicateLogs(folly::EventBase* eb,
 void RaftPart::processAppendLogResponses(
         const AppendLogResponses& resps,
         folly::EventBase* eb,
-        AppendLogsIterator iter,
-        TermID currTerm,
-        LogID lastLogId,
-        LogID committedId,
-        TermID prevLogTerm,
-        LogID prevLogId,
+        std::shared_ptr<ReplicatingBatch> batch,
         std::vector<std::shared_ptr<Host>> hosts) {
     // Make sure majority have succeeded
     size_t numSucceeded = 0;
@@ -848,9 +936,61 @@ void RaftPart::processAppendLogResponses(
     if (numSucceeded >= quorum_) {
         // Majority have succeeded
         VLOG(2) << idStr_ << numSucceeded
-                << " hosts have accepted the logs";
+                << " hosts have accepted the logs ["
+                << batch->prevLogId + 1 << ", " << batch->lastLogId << "]";
+        {
+            std::lock_guard<std::mutex> lck(logsLock_);
+            // The batches before might not be accepted yet, they will be committed in order
+            batch->accepted = true;
+        }
+        commitBatches();
+    } else {
+        // Not enough hosts accepted the log, re-try
+        LOG(WARNING) << idStr_ << "Only " << numSucceeded
+                     << " hosts succeeded, Need to try again";
+        replicateLogs(eb, std::move(batch));
+    }
+}
+
+
+void RaftPart::commitBatches() {
+    while (true) {
+        std::vector<std::shared_ptr<ReplicatingBatch>> batches;
+        {
+            std::lock_guard<std::mutex> lck(logsLock_);
+            if (committingLogs_) {
+                // The thread committing now will check the accepted batches again
+                return;
+            }
+            for (auto& batch : inflightBatches_) {
+                if (!batch->accepted) {
+                    break;
+                }
+                batches.emplace_back(batch);
+            }
+            if (batches.empty()) {
+                // Step 5: Check whether need to continue the log replication,
+                // the committed batches have made room for new ones
+                if (replicatingLogs_ || !hasBatchToReplicate()) {
+                    VLOG(2) << idStr_ << "No more log to be replicated by this thread";
+                    return;
+                }
+                replicatingLogs_ = true;
+            } else {
+                committingLogs_ = true;
+            }
+        }
+        if (batches.empty()) {
+            replicateBatches();
+            return;
+        }
 
-        LogID firstLogId = 0;
+        // Make the local logs durable before committing them. It is out of raftLock_,
+        // so the batches appended meanwhile are synced along with them
+        wal_->sync();
+
+        auto currTerm = batches.back()->term;
+        auto lastLogId = batches.back()->lastLogId;
         AppendLogResult res = AppendLogResult::SUCCEEDED;
         do {
             std::lock_guard<std::mutex> g(raftLock_);
@@ -869,15 +1009,15 @@ void RaftPart::processAppendLogResponses(
                 res = AppendLogResult::E_TERM_OUT_OF_DATE;
                 break;
             }
+            auto committedId = committedLogId_;
             lastLogId_ = lastLogId;
             lastLogTerm_ = currTerm;
 
             auto walIt = wal_->iterator(committedId + 1, lastLogId);
             SlowOpTracker tracker;
-            // Step 3: Commit the batch
+            // Step 3: Commit the batches
             if (commitLogs(std::move(walIt))) {
                 committedLogId_ = lastLogId;
-                firstLogId = lastLogId_ + 1;
             } else {
                 LOG(FATAL) << idStr_ << "Failed to commit logs";
             }
@@ -892,70 +1032,30 @@ void RaftPart::processAppendLogResponses(
             lastMsgAcceptedTime_ = time::WallClock::fastNowInMilliSec();
         } while (false);
 
-        if (!checkAppendLogResult(res)) {
-            LOG(ERROR) << idStr_ << "processAppendLogResponses failed!";
-            return;
-        }
-        // Step 4: Fulfill the promise
-        if (iter.hasNonAtomicOpLogs()) {
-            sendingPromise_.setOneSharedValue(AppendLogResult::SUCCEEDED);
-        }
-        if (iter.leadByAtomicOp()) {
-            sendingPromise_.setOneSingleValue(AppendLogResult::SUCCEEDED);
-        }
-        // Step 5: Check whether need to continue
-        // the log replication
         {
             std::lock_guard<std::mutex> lck(logsLock_);
-            CHECK(replicatingLogs_);
-            // Continue to process the original AppendLogsIterator if necessary
-            iter.resume();
-            // If no more valid logs to be replicated in iter, create a new one if we have new log
-            if (iter.empty()) {
-                VLOG(2) << idStr_ << "logs size " << logs_.size();
-                if (logs_.size() > 0) {
-                    // continue to replicate the logs
-                    sendingPromise_ = std::move(cachingPromise_);
-                    cachingPromise_.reset();
-                    iter = AppendLogsIterator(
-                        firstLogId,
-                        currTerm,
-                        std::move(logs_),
-                        [this] (AtomicOp op) -> std::string {
-                            auto opRet = op();
-                            if (opRet.empty()) {
-                                // Failed
-                                sendingPromise_.setOneSingleValue(
-                                    AppendLogResult::E_ATOMIC_OP_FAILURE);
-                            }
-                            return opRet;
-                        });
-                    logs_.clear();
-                    bufferOverFlow_ = false;
-                }
-                // Reset replicatingLogs_ one of the following is true:
-                // 1. old iter is empty && logs_.size() == 0
-                // 2. old iter is empty && logs_.size() > 0, but all logs in new iter is atomic op,
-                //    and all of them failed, which would make iter is empty again
-                if (iter.empty()) {
-                    replicatingLogs_ = false;
-                    VLOG(2) << idStr_ << "No more log to be replicated";
-                    return;
+            committingLogs_ = false;
+            if (res == AppendLogResult::SUCCEEDED) {
+                // The batches have been failed if the leadership changed meanwhile
+                auto it = batches.begin();
+                while (it != batches.end()
+                        && !inflightBatches_.empty()
+                        && inflightBatches_.front() == *it) {
+                    inflightBatches_.pop_front();
+                    ++it;
                 }
+                batches.erase(it, batches.end());
             }
         }
-        this->appendLogsInternal(std::move(iter), currTerm);
-    } else {
-        // Not enough hosts accepted the log, re-try
-        LOG(WARNING) << idStr_ << "Only " << numSucceeded
-                     << " hosts succeeded, Need to try again";
-        replicateLogs(eb,
-                      std::move(iter),
-                      currTerm,
-                      lastLogId,
-                      committedId,
-                      prevLogTerm,
-                      prevLogId);
+
+        if (!checkAppendLogResult(res)) {
+            LOG(ERROR) << idStr_ << "processAppendLogResponses failed!";
+            return;
+        }
+        // Step 4: Fulfill the promises
+        for (auto& batch : batches) {
+            batch->promise.setValue(AppendLogResult::SUCCEEDED);
+        }
     }
 }
 
@@ -1221,8 +1321,10 @@ void RaftPart::statusPolling() {
         cleanupSnapshot();
     }
     if (needToCleanWal()) {
-        wal_->cleanWAL(FLAGS_wal_ttl);
+        wal_->cleanWAL(FLAGS_wal_ttl, durableLogId());
     }
+    // Sync the logs left behind by the interval policy
+    wal_->sync();
     {
         std::lock_guard<std::mutex> g(raftLock_);
         if (status_ == Status::RUNNING || status_ == Status::WAITING_SNAPSHOT) {
@@ -1429,6 +1531,14 @@ void RaftPart::processAppendLogRequest(
                   << ", local committedLogId = " << committedLogId_
                   << ", local current term = " << term_;
     }
+    // Sync the logs after raftLock_ is released, so the logs appended by the following
+    // requests meanwhile are synced along with them
+    SCOPE_EXIT {
+        if (resp.get_error_code() == cpp2::ErrorCode::SUCCEEDED
+                && !req.get_log_str_list().empty()) {
+            wal_->sync();
+        }
+    };
     std::lock_guard<std::mutex> g(raftLock_);
 
     resp.set_current_term(term_);
@@ -1461,6 +1571,7 @@ void RaftPart::processAppendLogRequest(
 
     // Reset the timeout timer
     lastMsgRecvDur_.reset();
+    leaderCommittedLogId_ = req.get_committed_log_id();
 
     if (req.get_sending_snapshot() && status_ != Status::WAITING_SNAPSHOT) {
         LOG(INFO) << idStr_ << "Begin to wait for the snapshot"
@@ -1600,6 +1711,7 @@ void RaftPart::processAppendLogRequest(
                               << lastLogIdCanCommit;
             committedLogId_ = lastLogIdCanCommit;
             resp.set_committed_log_id(lastLogIdCanCommit);
+            notifyCommitWaiters();
         } else {
             LOG(ERROR) << idStr_ << "Failed to commit log "
                        << committedLogId_ + 1 << " to "
@@ -1746,6 +1858,11 @@ void RaftPart::processSendSnapshotRequest(const cpp2::SendSnapshotRequest& req,
         status_ = Status::WAITING_SNAPSHOT;
     }
     lastSnapshotRecvDur_.reset();
+    if (req.get_file() != nullptr) {
+        auto ret = commitSnapshotFile(*req.get_file());
+        lastTotalCount_ += ret.first;
+        lastTotalSize_ += ret.second;
+    }
     // TODO(heng): Maybe we should save them into one sst firstly?
     auto ret = commitSnapshot(req.get_rows(),
                               req.get_committed_log_id(),
@@ -1773,6 +1890,7 @@ void RaftPart::processSendSnapshotRequest(const cpp2::SendSnapshotRequest& req,
             wal_->reset();
         }
         status_ = Status::RUNNING;
+        notifyCommitWaiters();
         LOG(INFO) << idStr_ << "Receive all snapshot, committedLogId_ " << committedLogId_
                   << ", lastLodId " << lastLogId_ << ", lastLogTermId " << lastLogTerm_;
     }
@@ -1799,16 +1917,27 @@ std::vector<std::shared_ptr<Host>> RaftPart::followers() const {
 
 bool RaftPart::checkAppendLogResult(AppendLogResult res) {
     if (res != AppendLogResult::SUCCEEDED) {
+        decltype(inflightBatches_) batches;
+        std::shared_ptr<PromiseSet<AppendLogResult>> pendingPromise;
         {
             std::lock_guard<std::mutex> lck(logsLock_);
             logs_.clear();
             cachingPromise_.setValue(res);
             cachingPromise_.reset();
             bufferOverFlow_ = false;
+            // All the inflight batches fail, since the batches after a failed one
+            // could not be committed either
+            batches.swap(inflightBatches_);
+            pendingIter_.reset();
+            pendingPromise = std::move(pendingPromise_);
         }
-        sendingPromise_.setValue(res);
-        replicatingLogs_ = false;
-        return false;;
+        for (auto& batch : batches) {
+            batch->promise.setValue(res);
+        }
+        if (pendingPromise != nullptr) {
+            pendingPromise->setValue(res);
+        }
+        return false;
     }
     return true;
 }
@@ -1881,6 +2010,114 @@ bool RaftPart::leaseValid() {
         < FLAGS_raft_heartbeat_interval_secs * 1000 - lastMsgAcceptedCostMs_;
 }
 
+void RaftPart::processGetReadIndexRequest(
+        const cpp2::GetReadIndexRequest& req,
+        cpp2::GetReadIndexResponse& resp) {
+    std::lock_guard<std::mutex> g(raftLock_);
+    resp.set_current_term(term_);
+    resp.set_committed_log_id(committedLogId_);
+    if (UNLIKELY(status_ != Status::RUNNING)) {
+        resp.set_error_code(cpp2::ErrorCode::E_BAD_STATE);
+        return;
+    }
+    if (role_ != Role::LEADER) {
+        resp.set_error_code(cpp2::ErrorCode::E_NOT_A_LEADER);
+        return;
+    }
+    if (req.get_current_term() != term_) {
+        resp.set_error_code(cpp2::ErrorCode::E_TERM_OUT_OF_DATE);
+        return;
+    }
+    // The lease is obtained by the first log of the term being accepted by majority, so
+    // the committed log id covers all the logs committed by the previous leaders, and no
+    // other leader could commit logs meanwhile
+    if (!leaseValid()) {
+        resp.set_error_code(cpp2::ErrorCode::E_NOT_READY);
+        return;
+    }
+    resp.set_error_code(cpp2::ErrorCode::SUCCEEDED);
+}
+
+
+folly::Future<bool> RaftPart::readIndex(int32_t maxStalenessMs) {
+    HostAddr leader;
+    cpp2::GetReadIndexRequest req;
+    {
+        std::lock_guard<std::mutex> g(raftLock_);
+        if (status_ != Status::RUNNING) {
+            return folly::makeFuture<bool>(false);
+        }
+        if (role_ == Role::LEADER) {
+            return folly::makeFuture<bool>(leaseValid());
+        }
+        if (role_ != Role::FOLLOWER || leader_ == HostAddr(0, 0)) {
+            return folly::makeFuture<bool>(false);
+        }
+        if (maxStalenessMs > 0
+                && lastMsgRecvDur_.elapsedInMSec() < static_cast<uint64_t>(maxStalenessMs)
+                && committedLogId_ >= leaderCommittedLogId_) {
+            return folly::makeFuture<bool>(true);
+        }
+        leader = leader_;
+        req.set_space(spaceId_);
+        req.set_part(partId_);
+        req.set_current_term(term_);
+    }
+
+    static ThriftClientManager<cpp2::RaftexServiceAsyncClient> clientMan;
+    auto* eb = ioThreadPool_->getEventBase();
+    return folly::via(eb, [eb, leader, req = std::move(req)] {
+        auto client = clientMan.client(leader, eb, false, FLAGS_raft_rpc_timeout_ms);
+        return client->future_getReadIndex(req);
+    }).thenTry([self = shared_from_this(), leader] (auto&& t) {
+        if (t.hasException()) {
+            VLOG(2) << self->idStr_ << "Failed to get the read index from " << leader
+                    << ", exception " << t.exception().what();
+            return folly::makeFuture<bool>(false);
+        }
+        auto& resp = t.value();
+        if (resp.get_error_code() != cpp2::ErrorCode::SUCCEEDED) {
+            VLOG(2) << self->idStr_ << "Failed to get the read index from " << leader
+                    << ", error " << static_cast<int32_t>(resp.get_error_code());
+            return folly::makeFuture<bool>(false);
+        }
+        return self->waitForCommit(resp.get_committed_log_id());
+    });
+}
+
+
+folly::Future<bool> RaftPart::waitForCommit(LogID readIndex) {
+    folly::Promise<bool> promise;
+    auto future = promise.getFuture();
+    {
+        std::lock_guard<std::mutex> g(raftLock_);
+        if (status_ != Status::RUNNING) {
+            return folly::makeFuture<bool>(false);
+        }
+        if (committedLogId_ >= readIndex) {
+            return folly::makeFuture<bool>(true);
+        }
+        commitWaiters_.emplace(readIndex, std::move(promise));
+    }
+    // Wait for the next append log request carrying the leader's committed log id. The
+    // waiter left is dropped once the logs are committed.
+    return std::move(future)
+        .via(executor_.get())
+        .onTimeout(std::chrono::milliseconds(FLAGS_raft_heartbeat_interval_secs * 1000),
+                   [] { return false; });
+}
+
+
+void RaftPart::notifyCommitWaiters() {
+    bool running = status_ == Status::RUNNING;
+    auto end = running ? commitWaiters_.upper_bound(committedLogId_) : commitWaiters_.end();
+    for (auto it = commitWaiters_.begin(); it != end; ++it) {
+        // The continuations run on the executor, not under raftLock_
+        it->second.setValue(running);
+    }
+    commitWaiters_.erase(commitWaiters_.begin(), end);
+}
+
 }  // namespace raftex
 }  // namespace nebula
 
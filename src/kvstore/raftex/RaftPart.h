@@ -26,6 +26,7 @@ namespace nebula {
 
 namespace wal {
 class FileBasedWal;
+class SharedWal;
 }  // namespace wal
 
 
@@ -209,8 +210,26 @@ public:
         const cpp2::SendSnapshotRequest& req,
         cpp2::SendSnapshotResponse& resp);
 
+    // Process getReadIndex request
+    void processGetReadIndexRequest(
+        const cpp2::GetReadIndexRequest& req,
+        cpp2::GetReadIndexResponse& resp);
+
     bool leaseValid();
 
+    /**
+     * Check whether the replica could serve linearizable reads now.
+     *
+     * The leader could if its lease is valid. The follower asks the leader for the
+     * read index, i.e. its committed log id, and waits until it has committed up to it.
+     * If maxStalenessMs is positive, the follower skips the round trip when it heard
+     * from the leader within maxStalenessMs and has committed all the logs the leader
+     * had committed then, so the reads are at most maxStalenessMs stale.
+     *
+     * Nothing blocks while waiting, the future is fulfilled on the executor of the part.
+     * */
+    folly::Future<bool> readIndex(int32_t maxStalenessMs = 0);
+
 protected:
     // Protected constructor to prevent from instantiating directly
     RaftPart(ClusterID clusterId,
@@ -221,7 +240,8 @@ protected:
              std::shared_ptr<folly::IOThreadPoolExecutor> pool,
              std::shared_ptr<thread::GenericThreadPool> workers,
              std::shared_ptr<folly::Executor> executor,
-             std::shared_ptr<SnapshotManager> snapshotMan);
+             std::shared_ptr<SnapshotManager> snapshotMan,
+             std::shared_ptr<wal::SharedWal> sharedWal = nullptr);
 
     const char* idStr() const {
         return idStr_.c_str();
@@ -251,7 +271,11 @@ protected:
     virtual bool preProcessLog(LogID logId,
                                TermID termId,
                                ClusterID clusterId,
-                               const std::string& log) = 0;
+                               folly::StringPiece log) = 0;
+
+    // Write the chunk of the snapshot file, the files are applied by commitSnapshot() when
+    // it is finished. Return <count, size> written, a chunk written before is skipped.
+    virtual std::pair<int64_t, int64_t> commitSnapshotFile(const cpp2::SnapshotFile& file) = 0;
 
     // Return <size, count> committed;
     virtual std::pair<int64_t, int64_t> commitSnapshot(const std::vector<std::string>& data,
@@ -262,6 +286,12 @@ protected:
     // Clean up all data about current part in storage.
     virtual void cleanup() = 0;
 
+    // The logs after the id are not durable in the state machine yet, so they are never
+    // cleaned from the wal. By default all the committed logs are durable.
+    virtual LogID durableLogId() {
+        return std::numeric_limits<LogID>::max();
+    }
+
     // Reset the part, clean up all data and WALs.
     void reset();
 
@@ -269,6 +299,11 @@ protected:
 
     void removePeer(const HostAddr& peer);
 
+    template<class ValueType>
+    class PromiseSet;
+
+    struct ReplicatingBatch;
+
 private:
     enum class Status {
         STARTING = 0,   // The part is starting, not ready for service
@@ -358,34 +393,49 @@ private:
                                                   std::string log,
                                                   AtomicOp cb = nullptr);
 
-    void appendLogsInternal(AppendLogsIterator iter, TermID termId);
+    // Whether a new batch could be replicated now
+    // Pre-condition: The caller needs to hold the logsLock_
+    bool hasBatchToReplicate() const;
 
-    void replicateLogs(
-        folly::EventBase* eb,
-        AppendLogsIterator iter,
-        TermID currTerm,
-        LogID lastLogId,
-        LogID committedId,
-        TermID prevLogTerm,
-        LogID prevLogId);
+    // Write the buffered logs into the WAL and replicate them batch by batch, until
+    // no more batch could be replicated for now
+    // Pre-condition: The caller needs to have set replicatingLogs_
+    void replicateBatches();
+
+    // Cut the next batch from the remaining logs or the buffered logs. The batch is
+    // nullptr if no more batch could be replicated for now
+    // Pre-condition: The caller needs to hold the logsLock_
+    AppendLogResult prepareNextBatch(std::shared_ptr<ReplicatingBatch>& batch,
+                                     std::unique_ptr<AppendLogsIterator>& iter,
+                                     std::shared_ptr<PromiseSet<AppendLogResult>>& promise);
+
+    void appendLogsInternal(std::unique_ptr<AppendLogsIterator> iter,
+                            std::shared_ptr<PromiseSet<AppendLogResult>> promise,
+                            std::shared_ptr<ReplicatingBatch> batch);
+
+    void replicateLogs(folly::EventBase* eb, std::shared_ptr<ReplicatingBatch> batch);
 
     void processAppendLogResponses(
         const AppendLogResponses& resps,
         folly::EventBase* eb,
-        AppendLogsIterator iter,
-        TermID currTerm,
-        LogID lastLogId,
-        LogID committedId,
-        TermID prevLogTerm,
-        LogID prevLogId,
+        std::shared_ptr<ReplicatingBatch> batch,
         std::vector<std::shared_ptr<Host>> hosts);
 
+    // Commit the batches accepted by the quorum in the order of log id
+    void commitBatches();
+
     std::vector<std::shared_ptr<Host>> followers() const;
 
     bool checkAppendLogResult(AppendLogResult res);
 
     void updateQuorum();
 
+    // Wait until the follower has committed up to the read index
+    folly::Future<bool> waitForCommit(LogID readIndex);
+
+    // Fulfill the follower reads waiting for the logs committed, called with raftLock_ held
+    void notifyCommitWaiters();
+
 protected:
     template<class ValueType>
     class PromiseSet final {
@@ -443,6 +493,26 @@ protected:
             singlePromises_.pop_front();
         }
 
+        // Move out the promises of the first batch, one shared promise for its normal logs
+        // and one single promise for its leading AtomicOp, so that the batch could be
+        // fulfilled separately from the remaining logs
+        PromiseSet splitFront(bool hasShared, bool hasSingle) {
+            PromiseSet front;
+            if (hasShared) {
+                CHECK(!sharedPromises_.empty());
+                front.sharedPromises_.splice(front.sharedPromises_.end(),
+                                             sharedPromises_,
+                                             sharedPromises_.begin());
+            }
+            if (hasSingle) {
+                CHECK(!singlePromises_.empty());
+                front.singlePromises_.splice(front.singlePromises_.end(),
+                                             singlePromises_,
+                                             singlePromises_.begin());
+            }
+            return front;
+        }
+
         void setValue(ValueType val) {
             for (auto& p : sharedPromises_) {
                 p.setValue(val);
@@ -463,6 +533,19 @@ protected:
         std::list<folly::Promise<ValueType>> singlePromises_;
     };
 
+    // A batch of logs which has been written into the WAL and is being replicated
+    struct ReplicatingBatch {
+        TermID term{0};
+        LogID prevLogId{0};
+        TermID prevLogTerm{0};
+        LogID lastLogId{0};
+        LogID committedId{0};
+        // Whether the quorum has accepted the batch
+        bool accepted{false};
+        // The promises of the logs in the batch only
+        PromiseSet<AppendLogResult> promise;
+    };
+
 
     const std::string idStr_;
 
@@ -473,18 +556,27 @@ protected:
     std::vector<std::shared_ptr<Host>> hosts_;
     size_t quorum_{0};
 
-    // The lock is used to protect logs_ and cachingPromise_
+    // The lock is used to protect logs_, cachingPromise_ and the batches being replicated
     mutable std::mutex logsLock_;
+    // Whether one thread is writing the batches into the WAL
     std::atomic_bool replicatingLogs_{false};
     std::atomic_bool bufferOverFlow_{false};
     PromiseSet<AppendLogResult> cachingPromise_;
     LogCache logs_;
 
+    // The batches being replicated in the order of log id, at most
+    // FLAGS_raft_max_inflight_batches. They are removed once committed.
+    std::deque<std::shared_ptr<ReplicatingBatch>> inflightBatches_;
+    // Whether one thread is committing the accepted batches
+    bool committingLogs_{false};
+    // The remaining logs of a swapped out buffer, which lead by an AtomicOp or follow a
+    // COMMAND. They wait until all the inflight batches have been committed.
+    std::unique_ptr<AppendLogsIterator> pendingIter_;
+    std::shared_ptr<PromiseSet<AppendLogResult>> pendingPromise_;
+
     // Partition level lock to synchronize the access of the partition
     mutable std::mutex raftLock_;
 
-    PromiseSet<AppendLogResult> sendingPromise_;
-
     Status status_;
     Role role_;
 
@@ -507,6 +599,11 @@ protected:
     TermID lastLogTerm_{0};
     // The id for the last globally committed log (from the leader)
     LogID committedLogId_{0};
+    // The committed log id of the leader in its last message, used by the follower reads
+    LogID leaderCommittedLogId_{0};
+    // The follower reads waiting for the committed log id to reach the read index,
+    // fulfilled when the follower commits logs or stops
+    std::multimap<LogID, folly::Promise<bool>> commitWaiters_;
 
     // To record how long ago when the last leader message received
     time::Duration lastMsgRecvDur_;
@@ -226,6 +226,20 @@ void RaftexService::sendSnapshot(
 
     part->processSendSnapshotRequest(req, resp);
 }
+
+
+void RaftexService::getReadIndex(
+        cpp2::GetReadIndexResponse& resp,
+        const cpp2::GetReadIndexRequest& req) {
+    auto part = findPart(req.get_space(), req.get_part());
+    if (!part) {
+        // Not found
+        resp.set_error_code(cpp2::ErrorCode::E_UNKNOWN_PART);
+        return;
+    }
+
+    part->processGetReadIndexRequest(req, resp);
+}
 }  // namespace raftex
 }  // namespace nebula
 
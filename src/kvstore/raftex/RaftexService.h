@@ -50,6 +50,10 @@ public:
         cpp2::SendSnapshotResponse& resp,
         const cpp2::SendSnapshotRequest& req) override;
 
+    void getReadIndex(
+        cpp2::GetReadIndexResponse& resp,
+        const cpp2::GetReadIndexRequest& req) override;
+
     void addPartition(std::shared_ptr<RaftPart> part);
     void removePartition(std::shared_ptr<RaftPart> part);
 
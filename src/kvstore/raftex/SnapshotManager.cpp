@@ -11,6 +11,8 @@ DEFINE_int32(snapshot_worker_threads, 4, "Threads number for snapshot");
 DEFINE_int32(snapshot_io_threads, 4, "Threads number for snapshot");
 DEFINE_int32(snapshot_send_retry_times, 3, "Retry times if send failed");
 DEFINE_int32(snapshot_send_timeout_ms, 60000, "Rpc timeout for sending snapshot");
+DEFINE_int32(snapshot_send_rate_limit_mb, 0,
+             "The max MB per second of all the snapshots being sent, 0 means no limit");
 
 namespace nebula {
 namespace raftex {
@@ -32,24 +34,26 @@ folly::Future<Status> SnapshotManager::sendSnapshot(std::shared_ptr<RaftPart> pa
         // It will not loss the data, but maybe some record will be committed twice.
         auto commitLogIdAndTerm = part->lastCommittedLogId();
         const auto& localhost = part->address();
-        std::vector<folly::Future<raftex::cpp2::SendSnapshotResponse>> results;
         LOG(INFO) << part->idStr_ << "Begin to send the snapshot"
                                   << ", commitLogId = " << commitLogIdAndTerm.first
                                   << ", commitLogTerm = " << commitLogIdAndTerm.second;
-        accessAllRowsInSnapshot(spaceId,
-                                partId,
-                                [&, this, p = std::move(p)] (
-                                           const std::vector<std::string>& data,
-                                           int64_t totalCount,
-                                           int64_t totalSize,
-                                           SnapshotStatus status) mutable -> bool {
+        int64_t bytesSent = 0;
+        auto sendOne = [&] (const std::vector<std::string>& data,
+                            const cpp2::SnapshotFile* file,
+                            int64_t totalCount,
+                            int64_t totalSize,
+                            SnapshotStatus status) -> bool {
             if (status == SnapshotStatus::FAILED) {
                 LOG(INFO) << part->idStr_ << "Snapshot send failed, the leader changed?";
                 p.setValue(Status::Error("Send snapshot failed!"));
                 return false;
             }
+            throttle(totalSize - bytesSent);
+            bytesSent = totalSize;
             int retry = FLAGS_snapshot_send_retry_times;
             while (retry-- > 0) {
+                // The receiver skips the part of a file chunk it has written, so a chunk
+                // resent after a failure resumes from where it was
                 auto f = send(spaceId,
                               partId,
                               termId,
@@ -57,6 +61,7 @@ folly::Future<Status> SnapshotManager::sendSnapshot(std::shared_ptr<RaftPart> pa
                               commitLogIdAndTerm.second,
                               localhost,
                               data,
+                              file,
                               totalSize,
                               totalCount,
                               dst,
@@ -89,11 +94,52 @@ folly::Future<Status> SnapshotManager::sendSnapshot(std::shared_ptr<RaftPart> pa
             LOG(WARNING) << part->idStr_ << "Send snapshot failed!";
             p.setValue(Status::Error("Send snapshot failed!"));
             return false;
+        };
+
+        const std::vector<std::string> noRows;
+        if (accessAllFilesInSnapshot(spaceId,
+                                     partId,
+                                     [&] (const cpp2::SnapshotFile* file,
+                                          int64_t totalCount,
+                                          int64_t totalSize,
+                                          SnapshotStatus status) -> bool {
+                                         return sendOne(noRows,
+                                                        file,
+                                                        totalCount,
+                                                        totalSize,
+                                                        status);
+                                     })) {
+            return;
+        }
+        accessAllRowsInSnapshot(spaceId,
+                                partId,
+                                [&] (const std::vector<std::string>& data,
+                                     int64_t totalCount,
+                                     int64_t totalSize,
+                                     SnapshotStatus status) -> bool {
+            return sendOne(data, nullptr, totalCount, totalSize, status);
         });
     });
     return fut;
 }
 
+void SnapshotManager::throttle(int64_t bytes) {
+    if (FLAGS_snapshot_send_rate_limit_mb <= 0 || bytes <= 0) {
+        return;
+    }
+    auto cost = std::chrono::microseconds(
+        bytes * 1000000L / (FLAGS_snapshot_send_rate_limit_mb * 1024L * 1024L));
+    std::chrono::steady_clock::time_point sendTime;
+    {
+        std::lock_guard<std::mutex> g(throttleLock_);
+        // The idle time is not saved up for the later bursts
+        nextSendTime_ = std::max(nextSendTime_, std::chrono::steady_clock::now());
+        sendTime = nextSendTime_;
+        nextSendTime_ += cost;
+    }
+    std::this_thread::sleep_until(sendTime);
+}
+
 folly::Future<raftex::cpp2::SendSnapshotResponse> SnapshotManager::send(
                                                             GraphSpaceID spaceId,
                                                             PartitionID partId,
@@ -102,6 +148,7 @@ folly::Future<raftex::cpp2::SendSnapshotResponse> SnapshotManager::send(
                                                             TermID committedLogTerm,
                                                             const HostAddr& localhost,
                                                             const std::vector<std::string>& data,
+                                                            const cpp2::SnapshotFile* file,
                                                             int64_t totalSize,
                                                             int64_t totalCount,
                                                             const HostAddr& addr,
@@ -119,6 +166,9 @@ folly::Future<raftex::cpp2::SendSnapshotResponse> SnapshotManager::send(
     req.set_total_size(totalSize);
     req.set_total_count(totalCount);
     req.set_done(finished);
+    if (file != nullptr) {
+        req.set_file(*file);
+    }
     auto* evb = ioThreadPool_->getEventBase();
     return folly::via(evb, [this, addr, evb, req = std::move(req)] () mutable {
         auto client = connManager_.client(addr, evb, false, FLAGS_snapshot_send_timeout_ms);
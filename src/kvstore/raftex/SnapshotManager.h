@@ -30,6 +30,11 @@ using SnapshotCallback = folly::Function<bool(const std::vector<std::string>& ro
                                               int64_t totalCount,
                                               int64_t totalSize,
                                               SnapshotStatus status)>;
+// Called with each chunk of the sst files in order, and with nullptr at last when DONE
+using SnapshotFileCallback = folly::Function<bool(const cpp2::SnapshotFile* file,
+                                                  int64_t totalCount,
+                                                  int64_t totalSize,
+                                                  SnapshotStatus status)>;
 class RaftPart;
 
 class SnapshotManager {
@@ -50,6 +55,7 @@ private:
                                                    TermID committedLogTerm,
                                                    const HostAddr& localhost,
                                                    const std::vector<std::string>& data,
+                                                   const cpp2::SnapshotFile* file,
                                                    int64_t totalSize,
                                                    int64_t totalCount,
                                                    const HostAddr& addr,
@@ -59,10 +65,31 @@ private:
                                          PartitionID partId,
                                          SnapshotCallback cb) = 0;
 
+    /**
+     * Access the snapshot as sst files, which the receiver ingests directly instead of
+     * writing the rows one by one. Return false without calling cb if the part could not
+     * be dumped into files, then the rows are sent instead.
+     * */
+    virtual bool accessAllFilesInSnapshot(GraphSpaceID spaceId,
+                                          PartitionID partId,
+                                          SnapshotFileCallback cb) {
+        UNUSED(spaceId);
+        UNUSED(partId);
+        UNUSED(cb);
+        return false;
+    }
+
+    // Wait until the bytes could be sent under FLAGS_snapshot_send_rate_limit_mb,
+    // which is shared by all the snapshots being sent
+    void throttle(int64_t bytes);
+
 private:
     std::unique_ptr<folly::IOThreadPoolExecutor> executor_;
     std::unique_ptr<folly::IOThreadPoolExecutor> ioThreadPool_;
     thrift::ThriftClientManager<raftex::cpp2::RaftexServiceAsyncClient> connManager_;
+
+    std::mutex throttleLock_;
+    std::chrono::steady_clock::time_point nextSendTime_;
 };
 
 }  // namespace raftex
@@ -17,6 +17,8 @@
 
 DECLARE_uint32(raft_heartbeat_interval_secs);
 DECLARE_uint32(max_batch_size);
+DECLARE_uint32(raft_max_inflight_batches);
+DECLARE_uint32(raft_max_inflight_append_requests);
 
 namespace nebula {
 namespace raftex {
@@ -135,6 +137,86 @@ TEST(LogAppend, MultiThreadAppend) {
     finishRaft(services, copies, workers, leader);
 }
 
+
+TEST(LogAppend, PipelinedAppend) {
+    fs::TempDir walRoot("/tmp/pipelined_append.XXXXXX");
+    FLAGS_raft_max_inflight_batches = 4;
+    FLAGS_raft_max_inflight_append_requests = 4;
+    std::shared_ptr<thread::GenericThreadPool> workers;
+    std::vector<std::string> wals;
+    std::vector<HostAddr> allHosts;
+    std::vector<std::shared_ptr<RaftexService>> services;
+    std::vector<std::shared_ptr<test::TestShard>> copies;
+
+    std::shared_ptr<test::TestShard> leader;
+    setupRaft(3, walRoot, workers, wals, allHosts, services, copies, leader);
+
+    // Check all hosts agree on the same leader
+    checkLeadership(copies, leader);
+
+    // Append the logs without waiting, so that several batches are replicated at
+    // the same time, and every log should be committed in order
+    const int numLogs = 500;
+    std::vector<std::string> msgs;
+    std::vector<folly::Future<AppendLogResult>> futures;
+    for (int i = 0; i < numLogs; ++i) {
+        msgs.emplace_back(folly::stringPrintf("Test Log Message %03d", i));
+        futures.emplace_back(leader->appendAsync(0, msgs.back()));
+        if (futures.back().isReady()
+                && futures.back().value() == AppendLogResult::E_BUFFER_OVERFLOW) {
+            // Wait for the batches in flight, and append it again
+            futures.pop_back();
+            for (auto& fut : futures) {
+                fut.wait();
+            }
+            futures.emplace_back(leader->appendAsync(0, msgs.back()));
+        }
+    }
+    for (auto& fut : futures) {
+        ASSERT_EQ(AppendLogResult::SUCCEEDED, std::move(fut).get());
+    }
+    checkConsensus(copies, 0, numLogs - 1, msgs);
+
+    finishRaft(services, copies, workers, leader);
+    FLAGS_raft_max_inflight_batches = 1;
+    FLAGS_raft_max_inflight_append_requests = 1;
+}
+
+
+TEST(LogAppend, ReadIndex) {
+    fs::TempDir walRoot("/tmp/read_index.XXXXXX");
+    std::shared_ptr<thread::GenericThreadPool> workers;
+    std::vector<std::string> wals;
+    std::vector<HostAddr> allHosts;
+    std::vector<std::shared_ptr<RaftexService>> services;
+    std::vector<std::shared_ptr<test::TestShard>> copies;
+
+    std::shared_ptr<test::TestShard> leader;
+    setupRaft(3, walRoot, workers, wals, allHosts, services, copies, leader);
+    checkLeadership(copies, leader);
+
+    std::vector<std::string> msgs;
+    appendLogs(0, 99, leader, msgs);
+    EXPECT_TRUE(leader->readIndex().get());
+    // The followers could lag behind by one heartbeat, the read index waits for it
+    for (auto& c : copies) {
+        if (c != leader) {
+            ASSERT_TRUE(c->readIndex().get());
+            EXPECT_EQ(msgs.size(), c->getNumLogs());
+        }
+    }
+
+    // The bounded staleness reads need no round trip once the followers caught up
+    for (auto& c : copies) {
+        if (c != leader) {
+            EXPECT_TRUE(c->readIndex(FLAGS_raft_heartbeat_interval_secs * 1000).get());
+        }
+    }
+    checkConsensus(copies, 0, 99, msgs);
+
+    finishRaft(services, copies, workers, leader);
+}
+
 }  // namespace raftex
 }  // namespace nebula
 
@@ -85,7 +85,7 @@ public:
     bool preProcessLog(LogID,
                        TermID,
                        ClusterID,
-                       const std::string& log) override {
+                       folly::StringPiece log) override {
         if (!log.empty()) {
             switch (static_cast<CommandType>(log[0])) {
                 case CommandType::ADD_LEARNER: {
@@ -120,6 +120,12 @@ public:
         return true;
     }
 
+    // The test snapshots are always sent as rows
+    std::pair<int64_t, int64_t> commitSnapshotFile(const cpp2::SnapshotFile&) override {
+        LOG(FATAL) << idStr_ << "Unexpected snapshot file";
+        return std::make_pair(0, 0);
+    }
+
     std::pair<int64_t, int64_t> commitSnapshot(const std::vector<std::string>& data,
                                                LogID committedLogId,
                                                TermID committedLogTerm,
@@ -150,6 +150,48 @@ TEST(LogEncoderTest, BatchTest) {
     ASSERT_EQ(expectd, decoded);
 }
 
+TEST(LogEncoderTest, VisitTest) {
+    std::vector<std::string> values{"key1", "val1", "key2", "val2"};
+    auto encoded = encodeMultiValues(OP_MULTI_PUT, values);
+    std::vector<folly::StringPiece> visited;
+    EXPECT_TRUE(visitMultiValues(encoded, [&] (folly::StringPiece value) {
+        visited.emplace_back(value);
+        return true;
+    }));
+    EXPECT_EQ(decodeMultiValues(encoded), visited);
+    // The values are pieces of the encoded log
+    EXPECT_EQ(encoded.data() + encoded.size() - 4, visited.back().data());
+
+    // Stop at the second value
+    visited.clear();
+    EXPECT_FALSE(visitMultiValues(encoded, [&] (folly::StringPiece value) {
+        visited.emplace_back(value);
+        return visited.size() < 2;
+    }));
+    EXPECT_EQ(2, visited.size());
+
+    BatchHolder holder;
+    holder.put("put_key", "put_value");
+    holder.remove("remove");
+    auto batch = encodeBatchValue(holder.getBatch());
+    size_t num = 0;
+    EXPECT_TRUE(visitBatchValue(batch, [&] (BatchLogType type,
+                                            folly::StringPiece first,
+                                            folly::StringPiece second) {
+        if (num++ == 0) {
+            EXPECT_EQ(OP_BATCH_PUT, type);
+            EXPECT_EQ("put_key", first);
+            EXPECT_EQ("put_value", second);
+        } else {
+            EXPECT_EQ(OP_BATCH_REMOVE, type);
+            EXPECT_EQ("remove", first);
+            EXPECT_TRUE(second.empty());
+        }
+        return true;
+    }));
+    EXPECT_EQ(2, num);
+}
+
 }  // namespace kvstore
 }  // namespace nebula
 
@@ -0,0 +1,381 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include <rocksdb/sst_file_writer.h>
+#include "fs/TempDir.h"
+#include "fs/FileUtils.h"
+#include "kvstore/MemEngine.h"
+#include "base/NebulaKeyUtils.h"
+
+DECLARE_int64(memory_engine_gc_writes);
+DECLARE_int32(memory_engine_gc_batch_keys);
+DECLARE_int32(memory_engine_dump_interval_secs);
+
+namespace nebula {
+namespace kvstore {
+
+static int32_t countKeys(std::unique_ptr<KVIterator>& iter) {
+    int32_t num = 0;
+    while (iter->valid()) {
+        num++;
+        iter->next();
+    }
+    return num;
+}
+
+
+TEST(MemEngineTest, SimpleTest) {
+    fs::TempDir rootPath("/tmp/mem_engine_SimpleTest.XXXXXX");
+    auto engine = std::make_unique<MemEngine>(0, rootPath.path());
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("key", "val"));
+    std::string val;
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->get("key", &val));
+    EXPECT_EQ("val", val);
+
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("key", "val2"));
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->get("key", &val));
+    EXPECT_EQ("val2", val);
+
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->remove("key"));
+    EXPECT_EQ(ResultCode::ERR_KEY_NOT_FOUND, engine->get("key", &val));
+    EXPECT_EQ(ResultCode::ERR_KEY_NOT_FOUND, engine->get("key_not_exist", &val));
+}
+
+
+TEST(MemEngineTest, RangeTest) {
+    fs::TempDir rootPath("/tmp/mem_engine_RangeTest.XXXXXX");
+    auto engine = std::make_unique<MemEngine>(0, rootPath.path());
+    std::vector<KV> data;
+    for (int32_t i = 0; i < 10; i++) {
+        data.emplace_back(folly::stringPrintf("a_%d", i), folly::stringPrintf("val_%d", i));
+        data.emplace_back(folly::stringPrintf("b_%d", i), folly::stringPrintf("val_%d", i));
+    }
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(std::move(data)));
+    // The old versions and the removed keys are not seen
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("a_3", "new_val_3"));
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->remove("a_4"));
+
+    {
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->range("a_2", "a_6", &iter));
+        std::vector<std::string> keys;
+        while (iter->valid()) {
+            keys.emplace_back(iter->key().str());
+            if (iter->key() == "a_3") {
+                EXPECT_EQ("new_val_3", iter->val());
+            }
+            iter->next();
+        }
+        EXPECT_EQ((std::vector<std::string>{"a_2", "a_3", "a_5"}), keys);
+    }
+    {
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix("a_", &iter));
+        EXPECT_EQ(9, countKeys(iter));
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix("", &iter));
+        EXPECT_EQ(19, countKeys(iter));
+    }
+    {
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->rangeWithPrefix("b_5", "b_", &iter));
+        EXPECT_EQ(5, countKeys(iter));
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->rangeWithPrefix("a_5", "b_", &iter));
+        EXPECT_EQ(10, countKeys(iter));
+    }
+}
+
+
+TEST(MemEngineTest, RemoveTest) {
+    fs::TempDir rootPath("/tmp/mem_engine_RemoveTest.XXXXXX");
+    auto engine = std::make_unique<MemEngine>(0, rootPath.path());
+    std::vector<KV> data;
+    for (int32_t i = 0; i < 10; i++) {
+        data.emplace_back(folly::stringPrintf("a_%d", i), folly::stringPrintf("val_%d", i));
+        data.emplace_back(folly::stringPrintf("b_%d", i), folly::stringPrintf("val_%d", i));
+    }
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(std::move(data)));
+
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->removeRange("a_2", "a_5"));
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiRemove({"a_0", "a_9"}));
+    std::unique_ptr<KVIterator> iter;
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix("a_", &iter));
+    EXPECT_EQ(5, countKeys(iter));
+
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->removePrefix("b_"));
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix("b_", &iter));
+    EXPECT_EQ(0, countKeys(iter));
+
+    // The operations of a batch are applied in order
+    auto batch = engine->startBatchWrite();
+    batch->put("c_1", "val_1");
+    batch->put("c_2", "val_2");
+    batch->removePrefix("c_");
+    batch->put("c_3", "val_3");
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->commitBatchWrite(std::move(batch)));
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix("c_", &iter));
+    ASSERT_TRUE(iter->valid());
+    EXPECT_EQ("c_3", iter->key());
+    iter->next();
+    EXPECT_FALSE(iter->valid());
+}
+
+
+TEST(MemEngineTest, ReadContextTest) {
+    fs::TempDir rootPath("/tmp/mem_engine_ReadContextTest.XXXXXX");
+    auto engine = std::make_unique<MemEngine>(0, rootPath.path());
+    std::vector<KV> data;
+    for (int32_t i = 0; i < 10; i++) {
+        data.emplace_back(folly::stringPrintf("a_%d", i), folly::stringPrintf("val_%d", i));
+    }
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(std::move(data)));
+
+    ReadContext ctx;
+    ctx.snapshot_ = engine->getSnapshot();
+    // The writes after the snapshot should not be seen
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("a_10", "val_10"));
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->remove("a_0"));
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("a_1", "new_val_1"));
+
+    std::unique_ptr<KVIterator> iter;
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix("a_", &iter, ctx));
+    EXPECT_EQ("a_0", iter->key());
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->range("a_1", "a_2", &iter, ctx));
+    EXPECT_EQ("val_1", iter->val());
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix("a_", &iter, ctx));
+    // The iterator keeps the snapshot alive, even after a compaction
+    ctx.snapshot_.reset();
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->compact());
+    EXPECT_EQ(10, countKeys(iter));
+
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix("a_", &iter));
+    EXPECT_EQ(10, countKeys(iter));
+}
+
+
+TEST(MemEngineTest, CompactTest) {
+    fs::TempDir rootPath("/tmp/mem_engine_CompactTest.XXXXXX");
+    auto engine = std::make_unique<MemEngine>(0, rootPath.path());
+    auto versions = [&] () {
+        MemSkipList::Accessor accessor(engine->list_);
+        return accessor.size();
+    };
+    for (int32_t i = 0; i < 10; i++) {
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("key", folly::stringPrintf("val_%d", i)));
+    }
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("removed", "val"));
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->remove("removed"));
+    EXPECT_EQ(12, versions());
+
+    // The versions seen by the snapshot are kept
+    auto snapshot = engine->getSnapshot();
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("key", "val_10"));
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->compact());
+    EXPECT_EQ(2, versions());
+
+    ReadContext ctx;
+    ctx.snapshot_ = snapshot;
+    std::unique_ptr<KVIterator> iter;
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix("key", &iter, ctx));
+    ASSERT_TRUE(iter->valid());
+    EXPECT_EQ("val_9", iter->val());
+    iter.reset();
+    ctx.snapshot_.reset();
+    snapshot.reset();
+
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->compact());
+    EXPECT_EQ(1, versions());
+    std::string val;
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->get("key", &val));
+    EXPECT_EQ("val_10", val);
+}
+
+
+TEST(MemEngineTest, IncrementalGcTest) {
+    fs::TempDir rootPath("/tmp/mem_engine_IncrementalGcTest.XXXXXX");
+    auto engine = std::make_unique<MemEngine>(0, rootPath.path());
+    auto versions = [&] () {
+        MemSkipList::Accessor accessor(engine->list_);
+        return accessor.size();
+    };
+    for (int32_t version = 0; version < 3; version++) {
+        for (int32_t i = 0; i < 5; i++) {
+            EXPECT_EQ(ResultCode::SUCCEEDED,
+                      engine->put(folly::stringPrintf("key_%d", i),
+                                  folly::stringPrintf("val_%d", version)));
+        }
+    }
+    EXPECT_EQ(15, versions());
+
+    // Each write checks the next two keys
+    FLAGS_memory_engine_gc_writes = 1;
+    FLAGS_memory_engine_gc_batch_keys = 2;
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("key_0", "val_3"));
+    EXPECT_EQ(1 + 1 + 3 + 3 + 3, versions());
+    EXPECT_EQ("key_2", engine->gcCursor_);
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("key_0", "val_4"));
+    EXPECT_EQ(2 + 1 + 1 + 1 + 3, versions());
+    EXPECT_EQ("key_4", engine->gcCursor_);
+    // The round reaches the last key, and the next one starts over
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("key_0", "val_5"));
+    EXPECT_EQ(3 + 1 + 1 + 1 + 1, versions());
+    EXPECT_EQ("", engine->gcCursor_);
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("key_0", "val_6"));
+    EXPECT_EQ(5, versions());
+    FLAGS_memory_engine_gc_writes = 1000000;
+    FLAGS_memory_engine_gc_batch_keys = 10000;
+
+    for (int32_t i = 0; i < 5; i++) {
+        std::string val;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->get(folly::stringPrintf("key_%d", i), &val));
+        EXPECT_EQ(i == 0 ? "val_6" : "val_2", val);
+    }
+}
+
+
+TEST(MemEngineTest, ConcurrentTest) {
+    fs::TempDir rootPath("/tmp/mem_engine_ConcurrentTest.XXXXXX");
+    auto engine = std::make_unique<MemEngine>(0, rootPath.path());
+    FLAGS_memory_engine_gc_writes = 100;
+    std::atomic<bool> stopped{false};
+    std::thread writer([&] {
+        for (int32_t round = 0; round < 100; round++) {
+            std::vector<KV> data;
+            for (int32_t i = 0; i < 10; i++) {
+                data.emplace_back(folly::stringPrintf("key_%d", i),
+                                  folly::stringPrintf("val_%d", round));
+            }
+            EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(std::move(data)));
+            if (round % 2 == 0) {
+                EXPECT_EQ(ResultCode::SUCCEEDED, engine->removePrefix("key_"));
+            }
+        }
+        stopped = true;
+    });
+    // A read sees either all the keys of a round or none of them
+    while (!stopped) {
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix("key_", &iter));
+        std::set<std::string> vals;
+        int32_t num = 0;
+        for (; iter->valid(); iter->next()) {
+            vals.emplace(iter->val().str());
+            num++;
+        }
+        EXPECT_TRUE(num == 0 || num == 10);
+        EXPECT_GE(1, vals.size());
+    }
+    writer.join();
+    FLAGS_memory_engine_gc_writes = 1000000;
+}
+
+
+TEST(MemEngineTest, PersistTest) {
+    fs::TempDir rootPath("/tmp/mem_engine_PersistTest.XXXXXX");
+    {
+        auto engine = std::make_unique<MemEngine>(0, rootPath.path());
+        engine->addPart(1);
+        engine->addPart(2);
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("key", "val"));
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("key_empty", ""));
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("removed", "val"));
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->remove("removed"));
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->flush());
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->createCheckpoint("checkpoint"));
+        EXPECT_EQ(ResultCode::ERR_CHECKPOINT_ERROR, engine->createCheckpoint("checkpoint"));
+        // The writes after flush are dumped on destruction
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("key_after_flush", "val"));
+    }
+    EXPECT_TRUE(fs::FileUtils::exist(folly::stringPrintf(
+        "%s/nebula/0/checkpoints/checkpoint/data/mem.dat", rootPath.path())));
+
+    auto engine = std::make_unique<MemEngine>(0, rootPath.path());
+    EXPECT_EQ(2, engine->totalPartsNum());
+    EXPECT_EQ((std::vector<PartitionID>{1, 2}), engine->allParts());
+    std::string val;
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->get("key", &val));
+    EXPECT_EQ("val", val);
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->get("key_empty", &val));
+    EXPECT_EQ("", val);
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->get("key_after_flush", &val));
+    EXPECT_EQ(ResultCode::ERR_KEY_NOT_FOUND, engine->get("removed", &val));
+}
+
+
+TEST(MemEngineTest, DumpTest) {
+    FLAGS_memory_engine_dump_interval_secs = 1;
+    fs::TempDir rootPath("/tmp/mem_engine_DumpTest.XXXXXX");
+    auto commit = [] (LogID logId) {
+        std::string val;
+        TermID term = 1;
+        val.append(reinterpret_cast<const char*>(&logId), sizeof(LogID));
+        val.append(reinterpret_cast<const char*>(&term), sizeof(TermID));
+        return val;
+    };
+    {
+        auto engine = std::make_unique<MemEngine>(0, rootPath.path());
+        engine->addPart(1);
+        EXPECT_EQ(0, engine->durableLogId(1));
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("key", "val"));
+        EXPECT_EQ(ResultCode::SUCCEEDED,
+                  engine->put(NebulaKeyUtils::systemCommitKey(1), commit(10)));
+        // The commit log id is durable once dumped in the background
+        sleep(FLAGS_memory_engine_dump_interval_secs + 1);
+        EXPECT_EQ(10, engine->durableLogId(1));
+        EXPECT_EQ(0, engine->durableLogId(2));
+        EXPECT_TRUE(fs::FileUtils::exist(
+            folly::stringPrintf("%s/nebula/0/data/mem.dat", rootPath.path())));
+
+        EXPECT_EQ(ResultCode::SUCCEEDED,
+                  engine->put(NebulaKeyUtils::systemCommitKey(1), commit(20)));
+        EXPECT_EQ(10, engine->durableLogId(1));
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->flush());
+        EXPECT_EQ(20, engine->durableLogId(1));
+    }
+
+    auto engine = std::make_unique<MemEngine>(0, rootPath.path());
+    EXPECT_EQ(20, engine->durableLogId(1));
+    std::string val;
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->get("key", &val));
+    EXPECT_EQ("val", val);
+    FLAGS_memory_engine_dump_interval_secs = 60;
+}
+
+
+TEST(MemEngineTest, IngestTest) {
+    rocksdb::Options options;
+    rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), options);
+    fs::TempDir rootPath("/tmp/mem_engine_IngestTest.XXXXXX");
+    auto file = folly::stringPrintf("%s/%s", rootPath.path(), "data.sst");
+    ASSERT_TRUE(writer.Open(file).ok());
+    ASSERT_TRUE(writer.Put("key", "value").ok());
+    ASSERT_TRUE(writer.Put("key_empty", "").ok());
+    writer.Finish();
+
+    auto engine = std::make_unique<MemEngine>(0, rootPath.path());
+    std::vector<std::string> files = {file};
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->ingest(files));
+
+    std::string result;
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->get("key", &result));
+    EXPECT_EQ("value", result);
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->get("key_empty", &result));
+    EXPECT_EQ("", result);
+    EXPECT_EQ(ResultCode::ERR_KEY_NOT_FOUND, engine->get("key_not_exist", &result));
+}
+
+}  // namespace kvstore
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    return RUN_ALL_TESTS();
+}
@@ -18,6 +18,7 @@
 #include <thrift/lib/cpp/concurrency/ThreadManager.h>
 
 DECLARE_uint32(raft_heartbeat_interval_secs);
+DECLARE_bool(enable_write_coalescing);
 
 namespace nebula {
 namespace kvstore {
@@ -830,6 +831,68 @@ TEST(NebulaStoreTest, ThreeCopiesCheckpointTest) {
     }
 }
 
+TEST(NebulaStoreTest, CoalesceWritesTest) {
+    FLAGS_enable_write_coalescing = true;
+    auto partMan = std::make_unique<MemPartManager>();
+    auto ioThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+    partMan->partsMap_[1][0] = PartMeta();
+
+    fs::TempDir rootPath("/tmp/nebula_store_test.XXXXXX");
+    std::vector<std::string> paths;
+    paths.emplace_back(folly::stringPrintf("%s/disk1", rootPath.path()));
+
+    KVOptions options;
+    options.dataPaths_ = std::move(paths);
+    options.partMan_ = std::move(partMan);
+    HostAddr local = {0, 0};
+    auto store = std::make_unique<NebulaStore>(std::move(options),
+                                               ioThreadPool,
+                                               local,
+                                               getHandlers());
+    store->init();
+    sleep(FLAGS_raft_heartbeat_interval_secs);
+    auto part = nebula::value(store->part(1, 0));
+    auto firstLogId = part->wal()->lastLogId();
+
+    // Issue all the writes without waiting, every tenth key is removed after put
+    const int32_t total = 1000;
+    std::atomic<int32_t> count{0};
+    folly::Baton<true, std::atomic> baton;
+    auto callback = [&] (ResultCode code) {
+        EXPECT_EQ(ResultCode::SUCCEEDED, code);
+        if (++count == total + total / 10) {
+            baton.post();
+        }
+    };
+    for (int32_t i = 0; i < total; i++) {
+        auto key = folly::stringPrintf("key_%04d", i);
+        store->asyncMultiPut(1, 0, {{key, folly::stringPrintf("val_%d", i)}}, callback);
+        if (i % 10 == 0) {
+            store->asyncRemove(1, 0, key, callback);
+        }
+    }
+    baton.wait();
+
+    std::unique_ptr<KVIterator> iter;
+    EXPECT_EQ(ResultCode::SUCCEEDED, store->prefix(1, 0, "key_", &iter));
+    int32_t num = 0;
+    for (int32_t i = 0; i < total; i++) {
+        if (i % 10 == 0) {
+            continue;
+        }
+        ASSERT_TRUE(iter->valid());
+        EXPECT_EQ(folly::stringPrintf("key_%04d", i), iter->key());
+        EXPECT_EQ(folly::stringPrintf("val_%d", i), iter->val());
+        iter->next();
+        num++;
+    }
+    EXPECT_FALSE(iter->valid());
+    EXPECT_EQ(total - total / 10, num);
+    // The writes issued meanwhile are merged into much fewer logs
+    EXPECT_GT(total, part->wal()->lastLogId() - firstLogId);
+    FLAGS_enable_write_coalescing = false;
+}
+
 TEST(NebulaStoreTest, AtomicOpBatchTest) {
     auto partMan = std::make_unique<MemPartManager>();
     auto ioThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
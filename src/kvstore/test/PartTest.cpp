@@ -8,7 +8,17 @@
 #include <gtest/gtest.h>
 #include <rocksdb/db.h>
 #include "fs/TempDir.h"
+#include "base/NebulaKeyUtils.h"
 #include "kvstore/Part.h"
+#include "kvstore/NebulaStore.h"
+#include "kvstore/PartManager.h"
+#include "kvstore/SnapshotManagerImpl.h"
+#include <folly/synchronization/Baton.h>
+#include <thrift/lib/cpp/concurrency/ThreadManager.h>
+
+DECLARE_uint32(raft_heartbeat_interval_secs);
+DECLARE_int32(snapshot_batch_size);
+DECLARE_int64(snapshot_file_size);
 
 namespace nebula {
 namespace kvstore {
@@ -46,6 +56,115 @@ TEST(PartTest, RocksTest) {
     delete db;
 }
 
+static void putRows(NebulaStore* store, GraphSpaceID spaceId, PartitionID partId,
+                    const std::string& valPrefix) {
+    std::vector<KV> data;
+    for (auto vId = 0; vId < 100; vId++) {
+        data.emplace_back(NebulaKeyUtils::vertexKey(partId, vId, 1, 0),
+                          folly::stringPrintf("%s_%0100d", valPrefix.c_str(), vId));
+    }
+    folly::Baton<true, std::atomic> baton;
+    store->asyncMultiPut(spaceId, partId, std::move(data), [&] (ResultCode code) {
+        EXPECT_EQ(ResultCode::SUCCEEDED, code);
+        baton.post();
+    });
+    baton.wait();
+}
+
+// The chunks of the files of a snapshot, in the order they are sent
+static std::vector<raftex::cpp2::SnapshotFile> exportFiles(NebulaStore* store,
+                                                           GraphSpaceID spaceId,
+                                                           PartitionID partId) {
+    std::vector<raftex::cpp2::SnapshotFile> chunks;
+    bool done = false;
+    SnapshotManagerImpl snapshot(store);
+    EXPECT_TRUE(snapshot.accessAllFilesInSnapshot(spaceId,
+                                                  partId,
+                                                  [&] (const raftex::cpp2::SnapshotFile* file,
+                                                       int64_t,
+                                                       int64_t,
+                                                       raftex::SnapshotStatus status) {
+        if (status == raftex::SnapshotStatus::DONE) {
+            done = true;
+        } else {
+            EXPECT_EQ(raftex::SnapshotStatus::IN_PROGRESS, status);
+            chunks.emplace_back(*file);
+        }
+        return true;
+    }));
+    EXPECT_TRUE(done);
+    return chunks;
+}
+
+TEST(PartTest, SnapshotFilesTest) {
+    FLAGS_snapshot_file_size = 4096;
+    FLAGS_snapshot_batch_size = 1024;
+    fs::TempDir rootPath("/tmp/part_test.XXXXXX");
+    auto partMan = std::make_unique<MemPartManager>();
+    // The snapshot of space 1 is received by the same part of space 2
+    partMan->partsMap_[1][1] = PartMeta();
+    partMan->partsMap_[2][1] = PartMeta();
+    KVOptions options;
+    options.dataPaths_ = {folly::stringPrintf("%s/disk1", rootPath.path())};
+    options.partMan_ = std::move(partMan);
+    auto workers = apache::thrift::concurrency::PriorityThreadManager::newPriorityThreadManager(
+                             1, true /*stats*/);
+    workers->setNamePrefix("executor");
+    workers->start();
+    auto store = std::make_unique<NebulaStore>(std::move(options),
+                                               std::make_shared<folly::IOThreadPoolExecutor>(4),
+                                               HostAddr(0, 0),
+                                               workers);
+    store->init();
+    sleep(FLAGS_raft_heartbeat_interval_secs);
+
+    putRows(store.get(), 1, 1, "old");
+    auto oldChunks = exportFiles(store.get(), 1, 1);
+    putRows(store.get(), 1, 1, "new");
+    auto newChunks = exportFiles(store.get(), 1, 1);
+    ASSERT_LT(4, newChunks.size());
+    ASSERT_EQ(oldChunks.size(), newChunks.size());
+    // The files are named the same besides the ids of the snapshots
+    auto fileName = [] (const std::string& name) {
+        return name.substr(name.find('_') + 1);
+    };
+    ASSERT_EQ(fileName(oldChunks[0].get_name()), fileName(newChunks[0].get_name()));
+    ASSERT_NE(oldChunks[0].get_name(), newChunks[0].get_name());
+
+    auto part = nebula::value(store->part(2, 1));
+    // The old snapshot is abandoned half way
+    for (size_t i = 0; i < oldChunks.size() / 2; i++) {
+        ASSERT_EQ(1, part->commitSnapshotFile(oldChunks[i]).first);
+    }
+    size_t count = 0;
+    for (auto& chunk : newChunks) {
+        auto ret = part->commitSnapshotFile(chunk);
+        ASSERT_EQ(1, ret.first);
+        ASSERT_EQ(static_cast<int64_t>(chunk.get_data().size()), ret.second);
+        count += ret.first;
+        // The chunk resent is skipped, as it is written
+        ret = part->commitSnapshotFile(chunk);
+        ASSERT_EQ(0, ret.first);
+        ASSERT_EQ(0, ret.second);
+    }
+    ASSERT_EQ(newChunks.size(), count);
+    ASSERT_EQ(0, part->commitSnapshot({}, 10, 1, true).first);
+
+    // Only the rows of the new snapshot are ingested
+    std::map<std::string, std::string> expected;
+    for (auto vId = 0; vId < 100; vId++) {
+        expected.emplace(NebulaKeyUtils::vertexKey(1, vId, 1, 0),
+                         folly::stringPrintf("new_%0100d", vId));
+    }
+    std::map<std::string, std::string> rows;
+    std::unique_ptr<KVIterator> iter;
+    ASSERT_EQ(ResultCode::SUCCEEDED, store->prefix(2, 1, NebulaKeyUtils::prefix(1), &iter));
+    for (; iter->valid(); iter->next()) {
+        rows.emplace(iter->key().str(), iter->val().str());
+    }
+    ASSERT_EQ(expected, rows);
+}
+
 }  // namespace kvstore
 }  // namespace nebula
 
@@ -79,7 +79,7 @@ TEST(RocksEngineConfigTest, createOptionsTest) {
     rocksdb::Options options;
     FLAGS_rocksdb_db_options = R"({"stats_dump_period_sec":"aaaaaa"})";
 
-    rocksdb::Status s = initRocksdbOptions(options);
+    rocksdb::Status s = initRocksdbOptions(options, 0);
     ASSERT_EQ(rocksdb::Status::kInvalidArgument , s.code());
     EXPECT_EQ("Invalid argument: Unable to parse DBOptions:: stats_dump_period_sec",
               s.ToString());
@@ -88,6 +88,38 @@ TEST(RocksEngineConfigTest, createOptionsTest) {
     FLAGS_rocksdb_db_options = "{}";
 }
 
+
+TEST(RocksEngineConfigTest, PrefixFilteringOptionTest) {
+    {
+        rocksdb::Options options;
+        auto s = initRocksdbOptions(options, 1);
+        ASSERT_TRUE(s.ok());
+        EXPECT_EQ(nullptr, options.prefix_extractor);
+    }
+    FLAGS_enable_rocksdb_prefix_filtering = true;
+    {
+        rocksdb::Options options;
+        auto s = initRocksdbOptions(options, 1);
+        ASSERT_TRUE(s.ok());
+        ASSERT_NE(nullptr, options.prefix_extractor);
+        EXPECT_STREQ("nebula.NebulaSliceTransform", options.prefix_extractor->Name());
+    }
+    FLAGS_rocksdb_prefix_filtering_spaces = "2, 3";
+    EXPECT_FALSE(prefixFilteringEnabled(1));
+    EXPECT_TRUE(prefixFilteringEnabled(2));
+    EXPECT_TRUE(prefixFilteringEnabled(3));
+    {
+        rocksdb::Options options;
+        auto s = initRocksdbOptions(options, 1);
+        ASSERT_TRUE(s.ok());
+        EXPECT_EQ(nullptr, options.prefix_extractor);
+    }
+
+    // Clean up
+    FLAGS_enable_rocksdb_prefix_filtering = false;
+    FLAGS_rocksdb_prefix_filtering_spaces = "";
+}
+
 }  // namespace kvstore
 }  // namespace nebula
 
@@ -9,7 +9,9 @@
 #include <rocksdb/db.h>
 #include <folly/lang/Bits.h>
 #include "fs/TempDir.h"
+#include "base/NebulaKeyUtils.h"
 #include "kvstore/RocksEngine.h"
+#include "kvstore/RocksEngineConfig.h"
 
 namespace nebula {
 namespace kvstore {
@@ -113,6 +115,122 @@ TEST(RocksEngineTest, PrefixTest) {
 }
 
 
+TEST(RocksEngineTest, ReadContextTest) {
+    fs::TempDir rootPath("/tmp/rocksdb_engine_ReadContextTest.XXXXXX");
+    auto engine = std::make_unique<RocksEngine>(0, rootPath.path());
+    std::vector<KV> data;
+    for (int32_t i = 0; i < 10;  i++) {
+        data.emplace_back(folly::stringPrintf("a_%d", i),
+                          folly::stringPrintf("val_%d", i));
+    }
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(std::move(data)));
+
+    ReadContext ctx;
+    ctx.snapshot_ = engine->getSnapshot();
+    ctx.fillCache_ = false;
+    // The writes after the snapshot should not be seen
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("a_10", "val_10"));
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->remove("a_0"));
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->put("b_0", "val_0"));
+
+    auto countKeys = [] (std::unique_ptr<KVIterator>& iter) {
+        int32_t num = 0;
+        while (iter->valid()) {
+            num++;
+            iter->next();
+        }
+        return num;
+    };
+    {
+        std::string prefix = "a_";
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix(prefix, &iter, ctx));
+        EXPECT_EQ(10, countKeys(iter));
+    }
+    {
+        std::string prefix = "a_";
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix(prefix, &iter));
+        EXPECT_EQ(10, countKeys(iter));
+    }
+    {
+        std::string start = "a_5";
+        std::string prefix = "a_";
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->rangeWithPrefix(start, prefix, &iter, ctx));
+        EXPECT_EQ(5, countKeys(iter));
+    }
+    {
+        std::string start = "a_";
+        std::string end = "b_1";
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->range(start, end, &iter, ctx));
+        EXPECT_EQ(10, countKeys(iter));
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->range(start, end, &iter));
+        EXPECT_EQ(11, countKeys(iter));
+    }
+    // The iterator keeps the snapshot alive
+    {
+        std::string prefix = "a_";
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix(prefix, &iter, ctx));
+        ctx.snapshot_.reset();
+        EXPECT_EQ(10, countKeys(iter));
+    }
+}
+
+
+TEST(RocksEngineTest, PrefixSuccessorTest) {
+    EXPECT_EQ("b", prefixSuccessor("a"));
+    EXPECT_EQ("ab", prefixSuccessor("aa"));
+    EXPECT_EQ("b", prefixSuccessor("a\xFF"));
+    EXPECT_EQ("", prefixSuccessor("\xFF\xFF"));
+    EXPECT_EQ("", prefixSuccessor(""));
+}
+
+
+TEST(RocksEngineTest, PrefixFilteringTest) {
+    FLAGS_enable_rocksdb_prefix_filtering = true;
+    fs::TempDir rootPath("/tmp/rocksdb_engine_PrefixFilteringTest.XXXXXX");
+    auto engine = std::make_unique<RocksEngine>(0, rootPath.path());
+    PartitionID partId = 1;
+    EdgeType edgeType = 101;
+    TagID tagId = 201;
+    std::vector<KV> data;
+    for (VertexID vId = 0; vId < 10; vId++) {
+        data.emplace_back(NebulaKeyUtils::vertexKey(partId, vId, tagId, 0), "tag");
+        for (VertexID dst = 0; dst < 5; dst++) {
+            data.emplace_back(NebulaKeyUtils::edgeKey(partId, vId, edgeType, 0, dst, 0), "edge");
+        }
+    }
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(std::move(data)));
+    // Flush the memtable, so that the sst filters are used too
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->flush());
+
+    auto countPrefix = [&engine] (const std::string& prefix) {
+        std::unique_ptr<KVIterator> iter;
+        EXPECT_EQ(ResultCode::SUCCEEDED, engine->prefix(prefix, &iter));
+        int32_t num = 0;
+        while (iter->valid()) {
+            num++;
+            iter->next();
+        }
+        return num;
+    };
+    // The prefix covers the whole extracted prefix
+    EXPECT_EQ(5, countPrefix(NebulaKeyUtils::edgePrefix(partId, 3, edgeType)));
+    EXPECT_EQ(1, countPrefix(NebulaKeyUtils::vertexPrefix(partId, 3, tagId)));
+    EXPECT_EQ(0, countPrefix(NebulaKeyUtils::edgePrefix(partId, 3, edgeType + 1)));
+    EXPECT_EQ(0, countPrefix(NebulaKeyUtils::edgePrefix(partId, 100, edgeType)));
+    EXPECT_EQ(1, countPrefix(NebulaKeyUtils::edgePrefix(partId, 3, edgeType, 0, 2)));
+    // The prefix is shorter than the extracted one, need total order seek
+    EXPECT_EQ(6, countPrefix(NebulaKeyUtils::vertexPrefix(partId, 3)));
+    EXPECT_EQ(60, countPrefix(NebulaKeyUtils::prefix(partId)));
+
+    FLAGS_enable_rocksdb_prefix_filtering = false;
+}
+
+
 TEST(RocksEngineTest, RemoveTest) {
     fs::TempDir rootPath("/tmp/rocksdb_engine_RemoveTest.XXXXXX");
     auto engine = std::make_unique<RocksEngine>(0, rootPath.path());
@@ -224,6 +342,47 @@ TEST(RocksEngineTest, IngestTest) {
     EXPECT_EQ(ResultCode::ERR_KEY_NOT_FOUND, engine->get("key_not_exist", &result));
 }
 
+
+
+TEST(RocksEngineTest, ExportPartTest) {
+    fs::TempDir rootPath("/tmp/rocksdb_engine_ExportPartTest.XXXXXX");
+    auto engine = std::make_unique<RocksEngine>(0, folly::stringPrintf("%s/src", rootPath.path()));
+    std::vector<KV> data;
+    for (PartitionID partId = 1; partId <= 2; partId++) {
+        for (VertexID vId = 0; vId < 1000; vId++) {
+            data.emplace_back(NebulaKeyUtils::vertexKey(partId, vId, 201, 0),
+                              folly::stringPrintf("val_%d_%ld", partId, vId));
+        }
+    }
+    EXPECT_EQ(ResultCode::SUCCEEDED, engine->multiPut(std::move(data)));
+
+    // Roll a new file every few kilobytes
+    std::vector<std::string> files;
+    auto dir = folly::stringPrintf("%s/export", rootPath.path());
+    EXPECT_EQ(ResultCode::SUCCEEDED,
+              engine->exportPart(1, dir, 4096, [&files] (const std::string& file) {
+                  files.emplace_back(file);
+                  return true;
+              }));
+    EXPECT_LT(1, files.size());
+
+    auto dst = std::make_unique<RocksEngine>(0, folly::stringPrintf("%s/dst", rootPath.path()));
+    EXPECT_EQ(ResultCode::SUCCEEDED, dst->ingest(files));
+    std::unique_ptr<KVIterator> iter;
+    EXPECT_EQ(ResultCode::SUCCEEDED, dst->prefix(NebulaKeyUtils::prefix(1), &iter));
+    VertexID vId = 0;
+    while (iter->valid()) {
+        EXPECT_EQ(NebulaKeyUtils::vertexKey(1, vId, 201, 0), iter->key());
+        EXPECT_EQ(folly::stringPrintf("val_1_%ld", vId), iter->val());
+        vId++;
+        iter->next();
+    }
+    EXPECT_EQ(1000, vId);
+    // Only the part exported is ingested
+    EXPECT_EQ(ResultCode::SUCCEEDED, dst->prefix(NebulaKeyUtils::prefix(2), &iter));
+    EXPECT_FALSE(iter->valid());
+}
+
 }  // namespace kvstore
 }  // namespace nebula
 
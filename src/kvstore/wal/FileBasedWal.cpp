@@ -10,6 +10,13 @@
 #include "kvstore/wal/FileBasedWalIterator.h"
 #include "fs/FileUtils.h"
 #include "time/WallClock.h"
+#include "time/Duration.h"
+#include "stats/StatsManager.h"
+
+DECLARE_uint32(histogram_min);
+DECLARE_uint32(histogram_max);
+DEFINE_int32(wal_latency_histogram_buckets, 50,
+             "The number of buckets of the wal latency histograms of each space");
 
 namespace nebula {
 namespace wal {
@@ -26,22 +33,54 @@ std::shared_ptr<FileBasedWal> FileBasedWal::getWal(
         const folly::StringPiece dir,
         const std::string& idStr,
         FileBasedWalPolicy policy,
-        PreProcessor preProcessor) {
+        PreProcessor preProcessor,
+        std::shared_ptr<SharedWal> sharedWal,
+        GraphSpaceID spaceId,
+        PartitionID partId) {
     return std::shared_ptr<FileBasedWal>(
-        new FileBasedWal(dir, idStr, std::move(policy), std::move(preProcessor)));
+        new FileBasedWal(dir,
+                         idStr,
+                         std::move(policy),
+                         std::move(preProcessor),
+                         std::move(sharedWal),
+                         spaceId,
+                         partId));
 }
 
 
 FileBasedWal::FileBasedWal(const folly::StringPiece dir,
                            const std::string& idStr,
                            FileBasedWalPolicy policy,
-                           PreProcessor preProcessor)
+                           PreProcessor preProcessor,
+                           std::shared_ptr<SharedWal> sharedWal,
+                           GraphSpaceID spaceId,
+                           PartitionID partId)
         : dir_(dir.toString())
         , idStr_(idStr)
         , policy_(std::move(policy))
         , maxFileSize_(policy_.fileSize)
         , maxBufferSize_(policy_.bufferSize)
-        , preProcessor_(std::move(preProcessor)) {
+        , preProcessor_(std::move(preProcessor))
+        , sharedWal_(std::move(sharedWal))
+        , spaceId_(spaceId)
+        , partId_(partId)
+        , syncPolicy_(policy_.sync)
+        , syncIntervalMs_(policy_.syncIntervalMs)
+        , lastSync_(std::chrono::steady_clock::now()) {
+    // The histograms are shared by the parts of the space, registering returns the existing one
+    auto bucketSize = std::max<int64_t>(
+        1, (FLAGS_histogram_max - FLAGS_histogram_min) / FLAGS_wal_latency_histogram_buckets);
+    appendLatencyStat_ = stats::StatsManager::registerHisto(
+        folly::stringPrintf("wal_append_latency_%d", spaceId_),
+        bucketSize,
+        FLAGS_histogram_min,
+        FLAGS_histogram_max);
+    syncLatencyStat_ = stats::StatsManager::registerHisto(
+        folly::stringPrintf("wal_sync_latency_%d", spaceId_),
+        bucketSize,
+        FLAGS_histogram_min,
+        FLAGS_histogram_max);
+
     // Make sure WAL directory exist
     if (FileUtils::fileType(dir_.c_str()) == fs::FileType::NOTEXIST) {
         if (!FileUtils::makeDir(dir_)) {
@@ -58,9 +97,12 @@ FileBasedWal::FileBasedWal(const folly::StringPiece dir,
         LOG(INFO) << idStr_ << "lastLogId in wal is " << lastLogId_
                   << ", lastLogTerm is " << lastLogTerm_
                   << ", path is " << info->path();
-        currFd_ = open(info->path(), O_WRONLY | O_APPEND);
-        currInfo_ = info;
-        CHECK_GE(currFd_, 0);
+        if (!sharedWal_) {
+            std::lock_guard<std::mutex> g(syncLock_);
+            currFd_ = open(info->path(), O_WRONLY | O_APPEND);
+            currInfo_ = info;
+            CHECK_GE(currFd_, 0);
+        }
     }
 }
 
@@ -247,6 +289,17 @@ void FileBasedWal::scanAllWalFiles() {
         }
     }
 
+    if (sharedWal_) {
+        // The chunks in the shared wal follow the wal files written before
+        for (auto& chunk : sharedWal_->claimChunks(spaceId_, partId_)) {
+            if (!walFiles_.emplace(chunk->firstId(), chunk).second) {
+                LOG(ERROR) << idStr_ << "The chunk of log " << chunk->firstId()
+                           << " overlaps with the wal files, ignore it";
+                sharedWal_->release(chunk);
+            }
+        }
+    }
+
     // Make sure there is no gap in the logs
     if (!walFiles_.empty()) {
         LogID logIdAfterLastGap = -1;
@@ -268,7 +321,7 @@ void FileBasedWal::scanAllWalFiles() {
             while (it->second->firstId() < logIdAfterLastGap) {
                 LOG(INFO) << "Removing the wal file \""
                           << it->second->path() << "\"";
-                unlink(it->second->path());
+                removeWalFile(it->second);
                 it = walFiles_.erase(it);
             }
         }
@@ -283,10 +336,14 @@ void FileBasedWal::closeCurrFile() {
         return;
     }
 
-    CHECK_EQ(fsync(currFd_), 0) << strerror(errno);
-    // Close the file
-    CHECK_EQ(close(currFd_), 0) << strerror(errno);
-    currFd_ = -1;
+    {
+        // The closed file is synced, so sync() skips it
+        std::lock_guard<std::mutex> g(syncLock_);
+        CHECK_EQ(fsync(currFd_), 0) << strerror(errno);
+        // Close the file
+        CHECK_EQ(close(currFd_), 0) << strerror(errno);
+        currFd_ = -1;
+    }
 
     auto now = time::WallClock::fastNowInSec();
     currInfo_->setMTime(now);
@@ -314,6 +371,7 @@ void FileBasedWal::prepareNewFile(LogID startLogId) {
     walFiles_.emplace(std::make_pair(startLogId, info));
 
     // Create the file for write
+    std::lock_guard<std::mutex> g(syncLock_);
     currFd_ = open(
         info->path(),
         O_CREAT | O_EXCL | O_WRONLY | O_APPEND | O_CLOEXEC | O_LARGEFILE,
@@ -328,6 +386,17 @@ void FileBasedWal::prepareNewFile(LogID startLogId) {
 
 
 void FileBasedWal::rollbackInFile(WalFileInfoPtr info, LogID logId) {
+    if (info->segment() >= 0) {
+        // The chunk is only trimmed in memory, the rollback is persisted in the shared wal
+        if (!SharedWal::trimChunk(info, spaceId_, partId_, logId)) {
+            LOG(FATAL) << idStr_ << "Didn't found log " << logId << " in " << info->path();
+        }
+        lastLogId_ = logId;
+        lastLogTerm_ = info->lastTerm();
+        LOG(INFO) << idStr_ << "Rollback to log " << logId;
+        return;
+    }
+
     auto path = info->path();
     int32_t fd = open(path, O_RDWR);
     if (fd < 0) {
@@ -495,13 +564,20 @@ BufferPtr FileBasedWal::getLastBuffer(LogID id, size_t expectedToWrite) {
 bool FileBasedWal::appendLogInternal(LogID id,
                                      TermID term,
                                      ClusterID cluster,
-                                     std::string msg) {
+                                     folly::StringPiece msg) {
     if (stopped_) {
         LOG(ERROR) << idStr_ << "WAL has stopped. Do not accept logs any more";
         return false;
     }
 
-    if (lastLogId_ != 0 && firstLogId_ != 0 && id != lastLogId_ + 1) {
+    if (!pendingLogs_.empty()) {
+        if (id != pendingLogs_.back().id + 1) {
+            LOG(ERROR) << idStr_ << "There is a gap in the log id. The last log id is "
+                       << pendingLogs_.back().id
+                       << ", and the id being appended is " << id;
+            return false;
+        }
+    } else if (lastLogId_ != 0 && firstLogId_ != 0 && id != lastLogId_ + 1) {
         LOG(ERROR) << idStr_ << "There is a gap in the log id. The last log id is "
                    << lastLogId_
                    << ", and the id being appended is " << id;
@@ -513,25 +589,43 @@ bool FileBasedWal::appendLogInternal(LogID id,
         return false;
     }
 
-    // Write to the WAL file first
-    std::string strBuf;
-    strBuf.reserve(sizeof(LogID)
-                    + sizeof(TermID)
-                    + sizeof(ClusterID)
-                    + msg.size()
-                    + 2 * sizeof(int32_t));
-    strBuf.append(reinterpret_cast<char*>(&id), sizeof(LogID));
-    strBuf.append(reinterpret_cast<char*>(&term), sizeof(TermID));
+    // Encode the record, the msg is only copied here. The buffers share the record
+    // instead of keeping another copy of the msg
+    constexpr size_t headLen = sizeof(LogID) + sizeof(TermID) + sizeof(int32_t)
+                               + sizeof(ClusterID);
+    size_t recordLen = headLen + msg.size() + sizeof(int32_t);
+    auto record = folly::IOBuf::create(recordLen);
+    auto append = [&record] (const void* data, size_t size) {
+        memcpy(record->writableTail(), data, size);
+        record->append(size);
+    };
     int32_t len = msg.size();
-    strBuf.append(reinterpret_cast<char*>(&len), sizeof(int32_t));
-    strBuf.append(reinterpret_cast<char*>(&cluster), sizeof(ClusterID));
-    strBuf.append(reinterpret_cast<const char*>(msg.data()), msg.size());
-    strBuf.append(reinterpret_cast<char*>(&len), sizeof(int32_t));
+    append(&id, sizeof(LogID));
+    append(&term, sizeof(TermID));
+    append(&len, sizeof(int32_t));
+    append(&cluster, sizeof(ClusterID));
+    append(msg.data(), msg.size());
+    append(&len, sizeof(int32_t));
+
+    auto log = record->cloneOneAsValue();
+    log.trimStart(headLen);
+    log.trimEnd(sizeof(int32_t));
+
+    if (sharedWal_) {
+        // Written to the shared wal along with the other logs of the batch
+        pendingLogs_.emplace_back(PendingLog{id, term, cluster, std::move(log), recordLen});
+        if (chunk_) {
+            chunk_->prependChain(std::move(record));
+        } else {
+            chunk_ = std::move(record);
+        }
+        return true;
+    }
 
     // Prepare the WAL file if it's not opened
     if (currFd_ < 0) {
         prepareNewFile(id);
-    } else if (currInfo_->size() + strBuf.size() > maxFileSize_) {
+    } else if (currInfo_->size() + recordLen > maxFileSize_) {
         // Need to roll over
         closeCurrFile();
 
@@ -539,12 +633,14 @@ bool FileBasedWal::appendLogInternal(LogID id,
         prepareNewFile(id);
     }
 
-    ssize_t bytesWritten = write(currFd_, strBuf.data(), strBuf.size());
-    if (bytesWritten != (ssize_t)strBuf.size()) {
-        LOG(FATAL) << idStr_ << "bytesWritten:" << bytesWritten << ", expected:" << strBuf.size()
+    time::Duration duration;
+    ssize_t bytesWritten = write(currFd_, record->data(), recordLen);
+    if (bytesWritten != (ssize_t)recordLen) {
+        LOG(FATAL) << idStr_ << "bytesWritten:" << bytesWritten << ", expected:" << recordLen
                    << ", error:" << strerror(errno);
     }
-    currInfo_->setSize(currInfo_->size() + strBuf.size());
+    onWritten(duration.elapsedInUSec());
+    currInfo_->setSize(currInfo_->size() + recordLen);
     currInfo_->setLastId(id);
     currInfo_->setLastTerm(term);
 
@@ -555,22 +651,142 @@ bool FileBasedWal::appendLogInternal(LogID id,
     }
 
     // Append to the in-memory buffer
-    auto buffer = getLastBuffer(id, strBuf.size());
+    auto buffer = getLastBuffer(id, recordLen);
     DCHECK_EQ(id, static_cast<int64_t>(buffer->firstLogId() + buffer->numLogs()));
-    buffer->push(term, cluster, std::move(msg));
+    buffer->push(term, cluster, std::move(log));
 
     return true;
 }
 
 
+void FileBasedWal::flushChunk() {
+    if (pendingLogs_.empty()) {
+        return;
+    }
+    auto firstId = pendingLogs_.front().id;
+    auto lastId = pendingLogs_.back().id;
+    auto lastTerm = pendingLogs_.back().term;
+    std::lock_guard<std::mutex> appendGuard(appendLock_);
+    WalFileInfoPtr last;
+    {
+        std::lock_guard<std::mutex> g(walFilesMutex_);
+        if (!walFiles_.empty()) {
+            last = walFiles_.rbegin()->second;
+        }
+    }
+    time::Duration duration;
+    size_t end = 0;
+    auto chunk = sharedWal_->appendChunk(spaceId_,
+                                         partId_,
+                                         firstId,
+                                         lastId,
+                                         lastTerm,
+                                         *chunk_,
+                                         syncPolicy_ == WalSyncPolicy::SYNC,
+                                         last.get(),
+                                         &end);
+    stats::StatsManager::addValue(appendLatencyStat_, duration.elapsedInUSec());
+    chunk_.reset();
+    {
+        std::lock_guard<std::mutex> g(walFilesMutex_);
+        if (chunk != nullptr) {
+            walFiles_.emplace(firstId, std::move(chunk));
+        } else {
+            // The last chunk in the segment covers the logs
+            last->setSize(end - last->offset());
+            last->setLastId(lastId);
+            last->setLastTerm(lastTerm);
+            last->setMTime(time::WallClock::fastNowInSec());
+        }
+    }
+
+    lastLogId_ = lastId;
+    lastLogTerm_ = lastTerm;
+    if (firstLogId_ == 0) {
+        firstLogId_ = firstId;
+    }
+
+    // Append to the in-memory buffer
+    for (auto& log : pendingLogs_) {
+        auto buffer = getLastBuffer(log.id, log.size);
+        DCHECK_EQ(log.id, static_cast<int64_t>(buffer->firstLogId() + buffer->numLogs()));
+        buffer->push(log.term, log.cluster, std::move(log.msg));
+    }
+    pendingLogs_.clear();
+}
+
+
+void FileBasedWal::onWritten(int64_t latencyUs) {
+    stats::StatsManager::addValue(appendLatencyStat_, latencyUs);
+    writtenSeq_++;
+}
+
+
+// static
+StatusOr<WalSyncPolicy> FileBasedWal::toSyncPolicy(const std::string& str) {
+    if (str == "async") {
+        return WalSyncPolicy::ASYNC;
+    } else if (str == "interval") {
+        return WalSyncPolicy::INTERVAL;
+    } else if (str == "sync") {
+        return WalSyncPolicy::SYNC;
+    }
+    return Status::Error("Unknown wal sync policy \"%s\"", str.c_str());
+}
+
+
+void FileBasedWal::sync() {
+    auto policy = syncPolicy_.load();
+    if (policy == WalSyncPolicy::ASYNC || sharedWal_) {
+        // The shared wal syncs the chunks when writing them
+        return;
+    }
+    auto target = writtenSeq_.load();
+    std::unique_lock<std::mutex> g(syncLock_);
+    if (policy == WalSyncPolicy::INTERVAL
+            && std::chrono::steady_clock::now() - lastSync_
+                < std::chrono::milliseconds(syncIntervalMs_.load())) {
+        return;
+    }
+    while (syncedSeq_ < target) {
+        if (syncing_) {
+            // Wait for the one syncing, it may have covered the target
+            syncCV_.wait(g);
+            continue;
+        }
+        // Sync all the writes so far on behalf of the waiting ones. The fd is duplicated,
+        // since the appending thread may close it meanwhile, and the closed one is synced
+        syncing_ = true;
+        auto seq = writtenSeq_.load();
+        int32_t fd = currFd_ < 0 ? -1 : dup(currFd_);
+        CHECK(currFd_ < 0 || fd >= 0) << strerror(errno);
+        g.unlock();
+
+        time::Duration duration;
+        if (fd >= 0) {
+            CHECK_EQ(fdatasync(fd), 0) << strerror(errno);
+            CHECK_EQ(close(fd), 0) << strerror(errno);
+        }
+        stats::StatsManager::addValue(syncLatencyStat_, duration.elapsedInUSec());
+
+        g.lock();
+        syncing_ = false;
+        syncedSeq_ = std::max(syncedSeq_, seq);
+        lastSync_ = std::chrono::steady_clock::now();
+        syncCV_.notify_all();
+    }
+}
+
+
 bool FileBasedWal::appendLog(LogID id,
                              TermID term,
                              ClusterID cluster,
                              std::string msg) {
-    if (!appendLogInternal(id, term, cluster, std::move(msg))) {
+    if (!appendLogInternal(id, term, cluster, msg)) {
         LOG(ERROR) << "Failed to append log for logId " << id;
         return false;
     }
+    flushChunk();
     return true;
 }
 
@@ -580,13 +796,15 @@ bool FileBasedWal::appendLogs(LogIterator& iter) {
         if (!appendLogInternal(iter.logId(),
                                iter.logTerm(),
                                iter.logSource(),
-                               iter.logMsg().toString())) {
+                               iter.logMsg())) {
             LOG(ERROR) << idStr_ << "Failed to append log for logId "
                        << iter.logId();
+            flushChunk();
             return false;
         }
     }
 
+    flushChunk();
     return true;
 }
 
@@ -609,6 +827,9 @@ bool FileBasedWal::linkCurrentWAL(const char* newPath) {
     }
 
     auto it = walFiles_.rbegin();
+    if (it->second->segment() >= 0) {
+        return copyChunks(newPath);
+    }
 
     // Using the original wal file name.
     auto targetFile = fs::FileUtils::joinPath(newPath,
@@ -624,6 +845,62 @@ bool FileBasedWal::linkCurrentWAL(const char* newPath) {
     return true;
 }
 
+bool FileBasedWal::copyChunks(const char* newPath) {
+    // The chunks could not be linked, so copy the latest ones up to the file size
+    std::vector<WalFileInfoPtr> chunks;
+    size_t size = 0;
+    for (auto it = walFiles_.rbegin();
+         it != walFiles_.rend() && it->second->segment() >= 0;
+         ++it) {
+        if (!chunks.empty() && size + it->second->size() > maxFileSize_) {
+            break;
+        }
+        size += it->second->size();
+        chunks.emplace_back(it->second);
+    }
+    std::reverse(chunks.begin(), chunks.end());
+
+    auto targetFile = fs::FileUtils::joinPath(
+        newPath,
+        folly::stringPrintf("%019ld.wal", chunks.front()->firstId()));
+    int32_t fd = open(targetFile.c_str(), O_CREAT | O_EXCL | O_WRONLY | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG(INFO) << idStr_ << "Create file failed for " << targetFile
+                  << ", error:" << strerror(errno);
+        return false;
+    }
+    std::string buf;
+    bool succeeded = true;
+    for (auto& chunk : chunks) {
+        if (!SharedWal::readLogs(*chunk, spaceId_, partId_, buf)
+                || write(fd, buf.data(), buf.size()) != static_cast<ssize_t>(buf.size())) {
+            succeeded = false;
+            break;
+        }
+    }
+    if (succeeded && fsync(fd) != 0) {
+        succeeded = false;
+    }
+    close(fd);
+    if (!succeeded) {
+        LOG(INFO) << idStr_ << "Copy chunks failed on " << targetFile
+                  << ", error:" << strerror(errno);
+        return false;
+    }
+    LOG(INFO) << idStr_ << "Copy " << chunks.size() << " chunks success on " << targetFile;
+    return true;
+}
+
+
+void FileBasedWal::removeWalFile(WalFileInfoPtr info) {
+    if (info->segment() >= 0) {
+        sharedWal_->release(info);
+    } else {
+        unlink(info->path());
+    }
+}
+
+
 bool FileBasedWal::rollbackToLog(LogID id) {
     if (id < firstLogId_ - 1 || id > lastLogId_) {
         LOG(ERROR) << idStr_ << "Rollback target id " << id
@@ -633,6 +910,7 @@ bool FileBasedWal::rollbackToLog(LogID id) {
         return false;
     }
 
+    std::lock_guard<std::mutex> appendGuard(appendLock_);
     folly::RWSpinLock::WriteHolder holder(rollbackLock_);
     //-----------------------
     // 1. Roll back WAL files
@@ -640,6 +918,9 @@ bool FileBasedWal::rollbackToLog(LogID id) {
 
     // First close the current file
     closeCurrFile();
+    if (sharedWal_) {
+        sharedWal_->rollback(spaceId_, partId_, id);
+    }
 
     {
         std::lock_guard<std::mutex> g(walFilesMutex_);
@@ -651,7 +932,7 @@ bool FileBasedWal::rollbackToLog(LogID id) {
             while (it != walFiles_.end()) {
                 // Need to remove the file
                 VLOG(1) << "Removing file " << it->second->path();
-                unlink(it->second->path());
+                removeWalFile(it->second);
                 it = walFiles_.erase(it);
             }
         }
@@ -667,6 +948,8 @@ bool FileBasedWal::rollbackToLog(LogID id) {
                     << ", the last WAL file is now \""
                     << walFiles_.rbegin()->second->path() << "\"";
             rollbackInFile(walFiles_.rbegin()->second, id);
+            // The chunk must not cover the records rolled back by extending it
+            walFiles_.rbegin()->second->seal();
         }
     }
 
@@ -683,13 +966,22 @@ bool FileBasedWal::rollbackToLog(LogID id) {
 
 
 bool FileBasedWal::reset() {
+    std::lock_guard<std::mutex> appendGuard(appendLock_);
     closeCurrFile();
+    if (sharedWal_) {
+        sharedWal_->reset(spaceId_, partId_);
+    }
     {
         std::lock_guard<std::mutex> g(buffersMutex_);
         buffers_.clear();
     }
     {
         std::lock_guard<std::mutex> g(walFilesMutex_);
+        for (auto& info : walFiles_) {
+            if (info.second->segment() >= 0) {
+                sharedWal_->release(info.second);
+            }
+        }
         walFiles_.clear();
     }
     std::vector<std::string> files =
@@ -703,7 +995,12 @@ bool FileBasedWal::reset() {
     return true;
 }
 
-void FileBasedWal::cleanWAL(int32_t ttl) {
+void FileBasedWal::cleanWAL(int32_t ttl, LogID durableId) {
+    int walTTL = ttl == 0 ? policy_.ttl : ttl;
+    if (sharedWal_) {
+        relocateLastChunk(walTTL);
+    }
+
     std::lock_guard<std::mutex> g(walFilesMutex_);
     if (walFiles_.empty()) {
         return;
@@ -714,12 +1011,13 @@ void FileBasedWal::cleanWAL(int32_t ttl) {
     auto it = walFiles_.begin();
     auto size = walFiles_.size();
     int count = 0;
-    int walTTL = ttl == 0 ? policy_.ttl : ttl;
     while (it != walFiles_.end()) {
-        if (index++ < size - 1 &&  (now - it->second->mtime() > walTTL)) {
+        if (index++ < size - 1
+                && now - it->second->mtime() > walTTL
+                && it->second->lastId() <= durableId) {
             VLOG(1) << "Clean wals, Remove " << it->second->path() << ", now: " << now
                     << ", mtime: " << it->second->mtime();
-            unlink(it->second->path());
+            removeWalFile(it->second);
             it = walFiles_.erase(it);
             count++;
         } else {
@@ -733,6 +1031,49 @@ void FileBasedWal::cleanWAL(int32_t ttl) {
 }
 
 
+void FileBasedWal::relocateLastChunk(int32_t ttl) {
+    // Never write the chunk after the logs being appended, which would roll them back
+    std::unique_lock<std::mutex> appendGuard(appendLock_, std::try_to_lock);
+    if (!appendGuard.owns_lock()) {
+        return;
+    }
+    WalFileInfoPtr last;
+    {
+        std::lock_guard<std::mutex> g(walFilesMutex_);
+        if (walFiles_.empty()) {
+            return;
+        }
+        last = walFiles_.rbegin()->second;
+    }
+    if (last->segment() < 0
+            || last->segment() == sharedWal_->currentSegment()
+            || time::WallClock::fastNowInSec() - last->mtime() <= ttl) {
+        return;
+    }
+
+    std::string logs;
+    if (!SharedWal::readLogs(*last, spaceId_, partId_, logs)) {
+        LOG(ERROR) << idStr_ << "Failed to read the chunk [" << last->firstId() << ", "
+                   << last->lastId() << "] in " << last->path();
+        return;
+    }
+    folly::IOBuf buf(folly::IOBuf::WRAP_BUFFER, logs.data(), logs.size());
+    auto chunk = sharedWal_->appendChunk(spaceId_,
+                                         partId_,
+                                         last->firstId(),
+                                         last->lastId(),
+                                         last->lastTerm(),
+                                         buf);
+    {
+        std::lock_guard<std::mutex> g(walFilesMutex_);
+        walFiles_[last->firstId()] = std::move(chunk);
+    }
+    LOG(INFO) << idStr_ << "Relocate the chunk [" << last->firstId() << ", "
+              << last->lastId() << "] from " << last->path();
+    sharedWal_->release(last);
+}
+
+
 size_t FileBasedWal::accessAllWalInfo(std::function<bool(WalFileInfoPtr info)> fn) const {
     std::lock_guard<std::mutex> g(walFilesMutex_);
 
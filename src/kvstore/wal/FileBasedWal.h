@@ -9,15 +9,28 @@
 
 #include "base/Base.h"
 #include <folly/Function.h>
+#include <folly/io/IOBuf.h>
 #include <gtest/gtest_prod.h>
 #include "base/Cord.h"
+#include "base/StatusOr.h"
 #include "kvstore/wal/Wal.h"
 #include "kvstore/wal/InMemoryLogBuffer.h"
 #include "kvstore/wal/WalFileInfo.h"
+#include "kvstore/wal/SharedWal.h"
 
 namespace nebula {
 namespace wal {
 
+enum class WalSyncPolicy {
+    // Leave it to the os, the wal file is synced when it is closed
+    ASYNC,
+    // Sync the written logs at most once in the interval
+    INTERVAL,
+    // Sync the written logs before acknowledging them
+    SYNC,
+};
+
+
 struct FileBasedWalPolicy {
     // The life span of the log messages (number of seconds)
     // This is only a hint, the FileBasedWal will try to keep all messages
@@ -33,25 +46,53 @@ struct FileBasedWalPolicy {
     // Number of buffers allowed. When the number of buffers reach this
     // number, appendLogs() will be blocked until some buffers are flushed
     size_t numBuffers = 2;
+
+    WalSyncPolicy sync = WalSyncPolicy::ASYNC;
+
+    // The sync interval when the sync policy is INTERVAL
+    int32_t syncIntervalMs = 100;
 };
 
 
-using PreProcessor = folly::Function<bool(LogID, TermID, ClusterID, const std::string& log)>;
+using PreProcessor = folly::Function<bool(LogID, TermID, ClusterID, folly::StringPiece log)>;
 
 
+/**
+ * The WAL of one part.
+ *
+ * By default the logs are written to the wal files in the directory of the part.
+ * In the shared mode, the logs are written as chunks to the SharedWal of the data path,
+ * each chunk is indexed like a wal file, so the iterators, rollback and cleanWAL work
+ * on the part in the same way. The wal files written before switching to the shared
+ * mode are still read, but not appended any more.
+ *
+ * The durability of the appended logs is decided by the sync policy. The raft appends
+ * the logs under its lock, and calls sync() after releasing it, so that the logs appended
+ * by the concurrent callers meanwhile are synced by one fdatasync. In the shared mode
+ * the logs are synced by the SharedWal along with the chunks of the other parts.
+ *
+ * The append and sync latency (in us) of the parts in a space are exported through
+ * StatsManager, as wal_append_latency_<space> and wal_sync_latency_<space>. The histograms
+ * are coarse, see --wal_latency_histogram_buckets, since they are never unregistered.
+ * */
 class FileBasedWal final : public Wal
                          , public std::enable_shared_from_this<FileBasedWal> {
     FRIEND_TEST(FileBasedWal, TTLTest);
     FRIEND_TEST(FileBasedWal, CheckLastWalTest);
     FRIEND_TEST(FileBasedWal, LinkTest);
+    FRIEND_TEST(FileBasedWal, SyncTest);
     friend class FileBasedWalIterator;
 public:
     // A factory method to create a new WAL
+    // The logs are written to the sharedWal if it is given
     static std::shared_ptr<FileBasedWal> getWal(
         const folly::StringPiece dir,
         const std::string& idStr,
         FileBasedWalPolicy policy,
-        PreProcessor preProcessor);
+        PreProcessor preProcessor,
+        std::shared_ptr<SharedWal> sharedWal = nullptr,
+        GraphSpaceID spaceId = 0,
+        PartitionID partId = 0);
 
     virtual ~FileBasedWal();
 
@@ -63,6 +104,30 @@ public:
         return stopped_.load();
     }
 
+    // Parse the sync policy from "async", "interval" or "sync"
+    static StatusOr<WalSyncPolicy> toSyncPolicy(const std::string& str);
+
+    // The sync policy could be changed at runtime, it takes effect on the next append
+    void setSyncPolicy(WalSyncPolicy policy) {
+        syncPolicy_ = policy;
+    }
+    WalSyncPolicy syncPolicy() const {
+        return syncPolicy_.load();
+    }
+    void setSyncInterval(int32_t intervalMs) {
+        syncIntervalMs_ = intervalMs;
+    }
+
+    /**
+     * Make the logs appended before the call durable, if the sync policy requires.
+     * For the INTERVAL policy they are synced only if the interval has elapsed since the
+     * last sync, so it is called periodically as well.
+     *
+     * This method IS thread-safe. The concurrent callers wait for the one syncing, and
+     * all of them are satisfied by at most one more fdatasync.
+     * */
+    void sync();
+
     // Return the ID of the first log message in the WAL
     LogID firstLogId() const override {
         return firstLogId_;
@@ -102,7 +167,8 @@ public:
     // This method is *NOT* thread safe
     bool reset() override;
 
-    void cleanWAL(int32_t ttl = 0) override;
+    void cleanWAL(int32_t ttl = 0,
+                  LogID durableId = std::numeric_limits<LogID>::max()) override;
 
     // Scan [firstLogId, lastLogId]
     // This method IS thread-safe
@@ -141,7 +207,10 @@ private:
     FileBasedWal(const folly::StringPiece dir,
                  const std::string& idStr,
                  FileBasedWalPolicy policy,
-                 PreProcessor preProcessor);
+                 PreProcessor preProcessor,
+                 std::shared_ptr<SharedWal> sharedWal,
+                 GraphSpaceID spaceId,
+                 PartitionID partId);
 
     // Scan all WAL files
     void scanAllWalFiles();
@@ -159,11 +228,28 @@ private:
     // If the last buffer is big enough, create a new one
     BufferPtr getLastBuffer(LogID id, size_t expectedToWrite);
 
-    // Implementation of appendLog()
+    // Implementation of appendLog(), the msg is copied into the record of the wal once,
+    // which is shared by the buffers
     bool appendLogInternal(LogID id,
                            TermID term,
                            ClusterID cluster,
-                           std::string msg);
+                           folly::StringPiece msg);
+
+    // Write the logs encoded in the shared mode to the shared wal as one chunk
+    void flushChunk();
+
+    // Remove the wal file, or release the chunk in the shared wal
+    void removeWalFile(WalFileInfoPtr info);
+
+    // Append the last chunk to the current segment again if it expires in an old one,
+    // which would keep the segments from being removed
+    void relocateLastChunk(int32_t ttl);
+
+    // Copy the latest chunks into one wal file in the newPath
+    bool copyChunks(const char* newPath);
+
+    // Called after each write to the wal file
+    void onWritten(int64_t latencyUs);
 
 
 private:
@@ -193,7 +279,8 @@ private:
 
     // The current fd (which is the last file in walFiles_)
     // for appending new log messages.
-    // Please be aware: accessing currFd_ is not thread-safe
+    // Please be aware: accessing currFd_ is not thread-safe, except that
+    // changing it is guarded by syncLock_ for sync()
     int32_t currFd_{-1};
     // The WalFileInfo corresponding to the currFd_
     WalFileInfoPtr currInfo_;
@@ -205,6 +292,40 @@ private:
     PreProcessor preProcessor_;
 
     folly::RWSpinLock rollbackLock_;
+    // Serializes writing the shared wal, i.e. appending, rolling back, resetting and
+    // relocating the last chunk
+    std::mutex appendLock_;
+
+    std::shared_ptr<SharedWal> sharedWal_;
+    const GraphSpaceID spaceId_;
+    const PartitionID partId_;
+
+    struct PendingLog {
+        LogID id;
+        TermID term;
+        ClusterID cluster;
+        // Shares the record in chunk_
+        folly::IOBuf msg;
+        // The encoded size
+        size_t size;
+    };
+    // The records of the logs not written to the shared wal yet
+    std::unique_ptr<folly::IOBuf> chunk_;
+    std::vector<PendingLog> pendingLogs_;
+
+    std::atomic<WalSyncPolicy> syncPolicy_;
+    std::atomic<int32_t> syncIntervalMs_;
+    // The number of writes to the wal files, it is increased after each write
+    std::atomic<uint64_t> writtenSeq_{0};
+    // The first syncedSeq_ writes are durable
+    std::mutex syncLock_;
+    std::condition_variable syncCV_;
+    bool syncing_{false};
+    uint64_t syncedSeq_{0};
+    std::chrono::steady_clock::time_point lastSync_;
+
+    int32_t appendLatencyStat_{0};
+    int32_t syncLatencyStat_{0};
 };
 
 }  // namespace wal
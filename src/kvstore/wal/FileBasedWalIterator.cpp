@@ -61,12 +61,18 @@ FileBasedWalIterator::FileBasedWalIterator(
 
     if (firstIdInBuffer_ > currId_) {
         // We need to read from the WAL files
-        wal_->accessAllWalInfo([this] (WalFileInfoPtr info) {
+        std::string lastPath;
+        wal_->accessAllWalInfo([this, &lastPath] (WalFileInfoPtr info) {
             if (info->firstId() >= firstIdInBuffer_) {
                 // Skip this file
                 return true;
             }
-            int fd = open(info->path(), O_RDONLY);
+            int fd = -1;
+            if (!fds_.empty() && info->segment() >= 0 && info->path() == lastPath) {
+                fd = fds_.front();
+            } else {
+                fd = open(info->path(), O_RDONLY);
+            }
             if (fd < 0) {
                 LOG(ERROR) << "Failed to open wal file \""
                            << info->path()
@@ -75,7 +81,10 @@ FileBasedWalIterator::FileBasedWalIterator(
                 currId_ = lastId_ + 1;
                 return false;
             }
+            lastPath = info->path();
             fds_.push_front(fd);
+            offsets_.push_front(info->offset());
+            ends_.push_front(info->segment() >= 0 ? info->offset() + info->size() : -1);
             idRanges_.push_front(std::make_pair(info->firstId(), info->lastId()));
 
             if (info->firstId() <= currId_) {
@@ -106,7 +115,7 @@ FileBasedWalIterator::FileBasedWalIterator(
 
     if (!idRanges_.empty()) {
         // Find the correct position in the first WAL file
-        currPos_ = 0;
+        seekFileStart();
         while (true) {
             LogID logId;
             // Read the logID
@@ -131,19 +140,23 @@ FileBasedWalIterator::FileBasedWalIterator(
             if (logId == currId_) {
                 break;
             }
-            currPos_ += sizeof(LogID)
+            seekNextLog(sizeof(LogID)
                         + sizeof(TermID)
                         + sizeof(int32_t) * 2
                         + currMsgLen_
-                        + sizeof(ClusterID);
+                        + sizeof(ClusterID));
         }
     }
 }
 
 
 FileBasedWalIterator::~FileBasedWalIterator() {
+    int prevFd = -1;
     for (auto& fd : fds_) {
-        close(fd);
+        if (fd != prevFd) {
+            close(fd);
+        }
+        prevFd = fd;
     }
 }
 
@@ -158,10 +171,15 @@ LogIterator& FileBasedWalIterator::operator++() {
                     << ", and the first ID in the next file is "
                     << nextFirstId_
                     << ", so need to move to the next file";
-            // Close the current file
-            CHECK_EQ(close(fds_.front()), 0);
+            // Close the current file, unless the next chunk is in it too
+            int fd = fds_.front();
             fds_.pop_front();
+            offsets_.pop_front();
+            ends_.pop_front();
             idRanges_.pop_front();
+            if (fds_.empty() || fds_.front() != fd) {
+                CHECK_EQ(close(fd), 0);
+            }
 
             if (idRanges_.empty()) {
                 // Reached the end of wal files, only happens
@@ -174,14 +192,14 @@ LogIterator& FileBasedWalIterator::operator++() {
 
             nextFirstId_ = getFirstIdInNextFile();
             CHECK_EQ(currId_, idRanges_.front().first);
-            currPos_ = 0;
+            seekFileStart();
         } else {
             // Move to the next log
-            currPos_ += sizeof(LogID)
+            seekNextLog(sizeof(LogID)
                         + sizeof(TermID)
                         + sizeof(int32_t) * 2
                         + currMsgLen_
-                        + sizeof(ClusterID);
+                        + sizeof(ClusterID));
         }
 
         if (idRanges_.front().second <= 0) {
@@ -319,6 +337,37 @@ folly::StringPiece FileBasedWalIterator::logMsg() const {
 }
 
 
+folly::IOBuf FileBasedWalIterator::logBuf() const {
+    if (currId_ >= firstIdInBuffer_) {
+        DCHECK(!buffers_.empty());
+        return buffers_.front()->getLogBuf(currIdx_);
+    }
+    return folly::IOBuf(folly::IOBuf::COPY_BUFFER, logMsg());
+}
+
+
+void FileBasedWalIterator::seekFileStart() {
+    currPos_ = offsets_.front();
+    if (ends_.front() >= 0) {
+        recordEnd_ = SharedWal::payloadEnd(fds_.front(), currPos_);
+    }
+}
+
+
+void FileBasedWalIterator::seekNextLog(size_t logSize) {
+    currPos_ += logSize;
+    if (ends_.front() >= 0) {
+        // Skip the records of the other parts in the segment
+        currPos_ = SharedWal::nextLogPos(fds_.front(),
+                                         wal_->spaceId_,
+                                         wal_->partId_,
+                                         currPos_,
+                                         recordEnd_,
+                                         ends_.front());
+    }
+}
+
+
 LogID FileBasedWalIterator::getFirstIdInNextBuffer() const {
     auto it = buffers_.begin();
     ++it;
@@ -46,10 +46,18 @@ public:
 
     folly::StringPiece logMsg() const override;
 
+    // The logs in the buffers are shared, the ones in the files are copied
+    folly::IOBuf logBuf() const override;
+
 private:
     LogID getFirstIdInNextBuffer() const;
     LogID getFirstIdInNextFile() const;
 
+    // Move to the first log of the current file
+    void seekFileStart();
+    // Move to the next log in the current file, past the one of the given size
+    void seekNextLog(size_t logSize);
+
 private:
     // Holds the Wal object, so that it will not be destroyed before the iterator
     std::shared_ptr<FileBasedWal> wal_;
@@ -67,8 +75,15 @@ private:
 
     // [firstId, lastId]
     std::list<std::pair<LogID, LogID>> idRanges_;
+    // The chunks in the same segment of the shared wal share the fd
     std::list<int> fds_;
+    // The offset where the logs start in each file
+    std::list<int64_t> offsets_;
+    // The end of the logs of each chunk, or -1 for a wal file
+    std::list<int64_t> ends_;
     int64_t currPos_{0};
+    // The end of the record holding the current log in the chunk
+    size_t recordEnd_{0};
     int32_t currMsgLen_{0};
     mutable std::string currLog_;
     // we hold the read lock to avoid wal being rolled back during iterator
@@ -13,9 +13,17 @@ namespace wal {
 void InMemoryLogBuffer::push(TermID term,
                              ClusterID cluster,
                              std::string&& msg) {
+    push(term, cluster, folly::IOBuf(folly::IOBuf::COPY_BUFFER, msg));
+}
+
+
+void InMemoryLogBuffer::push(TermID term,
+                             ClusterID cluster,
+                             folly::IOBuf&& msg) {
+    DCHECK(!msg.isChained());
     folly::RWSpinLock::WriteHolder wh(&accessLock_);
 
-    totalLen_ += msg.size()
+    totalLen_ += msg.length()
                  + sizeof(TermID)
                  + sizeof(ClusterID)
                  + sizeof(LogID);
@@ -76,7 +84,15 @@ ClusterID InMemoryLogBuffer::getCluster(size_t idx) const {
 const folly::StringPiece InMemoryLogBuffer::getLog(size_t idx) const {
     folly::RWSpinLock::ReadHolder rh(&accessLock_);
     CHECK_LT(idx, logs_.size());
-    return std::get<2>(logs_[idx]);
+    auto& msg = std::get<2>(logs_[idx]);
+    return folly::StringPiece(reinterpret_cast<const char*>(msg.data()), msg.length());
+}
+
+
+folly::IOBuf InMemoryLogBuffer::getLogBuf(size_t idx) const {
+    folly::RWSpinLock::ReadHolder rh(&accessLock_);
+    CHECK_LT(idx, logs_.size());
+    return std::get<2>(logs_[idx]).cloneOneAsValue();
 }
 
 
@@ -84,14 +100,18 @@ std::pair<LogID, TermID> InMemoryLogBuffer::accessAllLogs(
         std::function<void(LogID,
                            TermID,
                            ClusterID,
-                           const std::string&)> fn) const {
+                           folly::StringPiece)> fn) const {
     folly::RWSpinLock::ReadHolder rh(&accessLock_);
     LogID id = firstLogId_ - 1;
     TermID term = -1;
     for (auto& log : logs_) {
         ++id;
         term = std::get<0>(log);
-        fn(id, term, std::get<1>(log), std::get<2>(log));
+        auto& msg = std::get<2>(log);
+        fn(id,
+           term,
+           std::get<1>(log),
+           folly::StringPiece(reinterpret_cast<const char*>(msg.data()), msg.length()));
     }
 
     return std::make_pair(id, term);
@@ -8,6 +8,7 @@
 #define WAL_INMEMORYLOGBUFFER_H_
 
 #include "base/Base.h"
+#include <folly/io/IOBuf.h>
 
 namespace nebula {
 namespace wal {
@@ -15,6 +16,9 @@ namespace wal {
 //
 // In-memory buffer (thread-safe)
 //
+// Each log is kept in an IOBuf, which usually refers to the record written to
+// the wal file, so the readers could share it without copying
+//
 class InMemoryLogBuffer final {
 public:
     explicit InMemoryLogBuffer(LogID firstLogId, const std::string& idStr = "")
@@ -29,6 +33,8 @@ public:
 
     // Push a new message to the end of the buffer
     void push(TermID term, ClusterID cluster, std::string&& msg);
+    // The msg should be a single IOBuf, not a chain
+    void push(TermID term, ClusterID cluster, folly::IOBuf&& msg);
 
     size_t size() const;
     size_t numLogs() const;
@@ -45,6 +51,9 @@ public:
     // the returned StringPiece object will not outlive this buffer
     // object
     const folly::StringPiece getLog(size_t idx) const;
+    // The returned IOBuf shares the storage with the buffer, it could
+    // outlive this buffer object
+    folly::IOBuf getLogBuf(size_t idx) const;
 
     // Iterates through all logs and calls the given functor fn
     // for each log
@@ -53,12 +62,12 @@ public:
         std::function<void(LogID,
                            TermID,
                            ClusterID,
-                           const std::string&)> fn) const;
+                           folly::StringPiece)> fn) const;
 
 private:
     mutable folly::RWSpinLock accessLock_;
 
-    std::vector<std::tuple<TermID, ClusterID, std::string>> logs_;
+    std::vector<std::tuple<TermID, ClusterID, folly::IOBuf>> logs_;
     LogID firstLogId_{-1};
     size_t totalLen_{0};
     std::string idStr_;
@@ -0,0 +1,674 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <climits>
+#include <sys/uio.h>
+#include "kvstore/wal/SharedWal.h"
+#include "fs/FileUtils.h"
+#include "time/WallClock.h"
+
+namespace nebula {
+namespace wal {
+
+using nebula::fs::FileUtils;
+
+namespace {
+
+constexpr int32_t kChunk = 1;
+constexpr int32_t kRollback = 2;
+constexpr int32_t kReset = 3;
+
+constexpr size_t kHeaderSize = sizeof(int32_t)
+                               + sizeof(GraphSpaceID)
+                               + sizeof(PartitionID)
+                               + sizeof(int32_t)
+                               + sizeof(LogID) * 2
+                               + sizeof(TermID);
+
+template<class T>
+T decode(const char* buf, size_t& pos) {
+    T val;
+    memcpy(&val, buf + pos, sizeof(T));
+    pos += sizeof(T);
+    return val;
+}
+
+}  // Anonymous namespace
+
+
+// static
+std::shared_ptr<SharedWal> SharedWal::getSharedWal(const folly::StringPiece dir,
+                                                   SharedWalPolicy policy) {
+    return std::shared_ptr<SharedWal>(new SharedWal(dir, std::move(policy)));
+}
+
+
+SharedWal::SharedWal(const folly::StringPiece dir, SharedWalPolicy policy)
+        : dir_(dir.toString())
+        , policy_(std::move(policy))
+        , lastSync_(std::chrono::steady_clock::now()) {
+    if (FileUtils::fileType(dir_.c_str()) == fs::FileType::NOTEXIST) {
+        if (!FileUtils::makeDir(dir_)) {
+            LOG(FATAL) << "MakeDIR " << dir_ << " failed";
+        }
+    }
+    scanAllSegments();
+    writer_ = thread::NamedThread("shared-wal", &SharedWal::writerLoop, this);
+}
+
+
+SharedWal::~SharedWal() {
+    {
+        std::lock_guard<std::mutex> g(queueLock_);
+        stopped_ = true;
+    }
+    queueCV_.notify_one();
+    writer_.join();
+    LOG(INFO) << "~SharedWal, dir = " << dir_;
+}
+
+
+void SharedWal::scanAllSegments() {
+    std::vector<std::string> files = FileUtils::listAllFilesInDir(dir_.c_str(), false, "*.log");
+    for (auto& fn : files) {
+        // The file name convention is "<sequence of the segment>.log"
+        std::vector<std::string> parts;
+        folly::split('.', fn, parts);
+        if (parts.size() != 2) {
+            LOG(ERROR) << "Ignore unknown file \"" << fn << "\"";
+            continue;
+        }
+        int64_t seq;
+        try {
+            seq = folly::to<int64_t>(parts[0]);
+        } catch (const std::exception& ex) {
+            LOG(ERROR) << "Ignore bad file name \"" << fn << "\"";
+            continue;
+        }
+        segments_[seq].path = FileUtils::joinPath(dir_, fn);
+    }
+
+    // Replay the segments in order
+    for (auto it = segments_.begin(); it != segments_.end(); ++it) {
+        if (!scanSegment(it->first, it->second) && std::next(it) != segments_.end()) {
+            LOG(ERROR) << "The segment \"" << it->second.path
+                       << "\" is broken in the middle of the shared wal";
+        }
+    }
+    if (!segments_.empty()) {
+        // Never append to the recovered segments, a new one is created on the first write
+        currSeq_ = segments_.rbegin()->first;
+    }
+
+    size_t chunksNum = 0;
+    for (auto& part : recovered_) {
+        chunksNum += part.second.size();
+    }
+    LOG(INFO) << "Recovered " << chunksNum << " chunks of " << recovered_.size()
+              << " parts from " << segments_.size() << " segments in " << dir_;
+
+    std::lock_guard<std::mutex> g(lock_);
+    purgeSegments();
+}
+
+
+bool SharedWal::scanSegment(int64_t seq, Segment& segment) {
+    auto* path = segment.path.c_str();
+    int32_t fd = open(path, O_RDWR);
+    if (fd < 0) {
+        LOG(FATAL) << "Failed to open file \"" << path
+                   << "\" (errno: " << errno << "): "
+                   << strerror(errno);
+    }
+    struct stat st;
+    time_t mtime = 0;
+    if (lstat(path, &st) == 0) {
+        mtime = st.st_mtime;
+    }
+
+    size_t pos = 0;
+    char header[kHeaderSize];
+    while (true) {
+        if (pread(fd, header, kHeaderSize, pos) != static_cast<ssize_t>(kHeaderSize)) {
+            break;
+        }
+        size_t offset = 0;
+        auto type = decode<int32_t>(header, offset);
+        auto spaceId = decode<GraphSpaceID>(header, offset);
+        auto partId = decode<PartitionID>(header, offset);
+        auto len = decode<int32_t>(header, offset);
+        auto firstId = decode<LogID>(header, offset);
+        auto lastId = decode<LogID>(header, offset);
+        auto lastTerm = decode<TermID>(header, offset);
+
+        int32_t footer;
+        if (len < 0
+                || pread(fd, &footer, sizeof(int32_t), pos + kHeaderSize + len)
+                    != sizeof(int32_t)
+                || footer != len) {
+            LOG(ERROR) << "Record size doesn't match at offset " << pos << " of " << path;
+            break;
+        }
+
+        auto& chunks = recovered_[std::make_pair(spaceId, partId)];
+        if (type == kChunk) {
+            auto* last = chunks.empty() ? nullptr : chunks.rbegin()->second.get();
+            if (last != nullptr
+                    && !last->sealed()
+                    && last->segment() == seq
+                    && last->lastId() + 1 == firstId) {
+                // Extend the last chunk of the part in the segment, as it was written
+                last->setSize(pos + kHeaderSize + len - last->offset());
+                last->setLastId(lastId);
+                last->setLastTerm(lastTerm);
+            } else {
+                auto chunk = std::make_shared<WalFileInfo>(segment.path, firstId);
+                chunk->setOffset(pos + kHeaderSize);
+                chunk->setSize(len);
+                chunk->setLastId(lastId);
+                chunk->setLastTerm(lastTerm);
+                chunk->setMTime(mtime);
+                chunk->setSegment(seq);
+                // The logs overlapped should have been rolled back
+                applyRollback(chunks, spaceId, partId, firstId - 1);
+                chunks.emplace(firstId, chunk);
+                segment.refs++;
+            }
+        } else if (type == kRollback) {
+            applyRollback(chunks, spaceId, partId, firstId);
+        } else if (type == kReset) {
+            for (auto& chunk : chunks) {
+                releaseInternal(chunk.second);
+            }
+            chunks.clear();
+        } else {
+            LOG(ERROR) << "Unknown record type " << type << " at offset " << pos
+                       << " of " << path;
+            break;
+        }
+        pos += kHeaderSize + len + sizeof(int32_t);
+    }
+
+    bool intact = true;
+    if (pos < FileUtils::fileSize(path)) {
+        LOG(WARNING) << "Invalid segment " << path << ", truncate from offset " << pos;
+        if (ftruncate(fd, pos) < 0) {
+            LOG(FATAL) << "Failed to truncate file \"" << path
+                       << "\" (errno: " << errno << "): "
+                       << strerror(errno);
+        }
+        intact = false;
+    }
+    close(fd);
+    return intact;
+}
+
+
+void SharedWal::applyRollback(Chunks& chunks,
+                              GraphSpaceID spaceId,
+                              PartitionID partId,
+                              LogID id) {
+    auto it = chunks.upper_bound(id);
+    while (it != chunks.end()) {
+        releaseInternal(it->second);
+        it = chunks.erase(it);
+    }
+    if (!chunks.empty()) {
+        auto& last = chunks.rbegin()->second;
+        if (last->lastId() > id) {
+            trimChunk(last, spaceId, partId, id);
+        }
+        // The records rolled back must not be covered by extending it
+        last->seal();
+    }
+}
+
+
+// static
+size_t SharedWal::payloadEnd(int32_t fd, size_t offset) {
+    int32_t len = 0;
+    size_t lenPos = offset - kHeaderSize
+                    + sizeof(int32_t)
+                    + sizeof(GraphSpaceID)
+                    + sizeof(PartitionID);
+    if (pread(fd, &len, sizeof(int32_t), lenPos) != sizeof(int32_t)) {
+        LOG(ERROR) << "Failed to read the record length at offset " << lenPos
+                   << " (errno " << errno << "): " << strerror(errno);
+    }
+    return offset + len;
+}
+
+
+// static
+size_t SharedWal::nextLogPos(int32_t fd,
+                             GraphSpaceID spaceId,
+                             PartitionID partId,
+                             size_t pos,
+                             size_t& recordEnd,
+                             size_t end) {
+    char header[kHeaderSize];
+    while (pos >= recordEnd && pos < end) {
+        // Skip the footer of the current record, and check the next one
+        size_t start = recordEnd + sizeof(int32_t);
+        if (pread(fd, header, kHeaderSize, start) != static_cast<ssize_t>(kHeaderSize)) {
+            LOG(ERROR) << "Failed to read the record at offset " << start
+                       << " (errno " << errno << "): " << strerror(errno);
+            return end;
+        }
+        size_t offset = 0;
+        auto type = decode<int32_t>(header, offset);
+        auto space = decode<GraphSpaceID>(header, offset);
+        auto part = decode<PartitionID>(header, offset);
+        auto len = decode<int32_t>(header, offset);
+        pos = start + kHeaderSize;
+        recordEnd = pos + len;
+        if (type != kChunk || space != spaceId || part != partId) {
+            pos = recordEnd;
+        }
+    }
+    return pos;
+}
+
+
+// static
+bool SharedWal::trimChunk(WalFileInfoPtr chunk,
+                          GraphSpaceID spaceId,
+                          PartitionID partId,
+                          LogID id) {
+    int32_t fd = open(chunk->path(), O_RDONLY);
+    if (fd < 0) {
+        LOG(ERROR) << "Failed to open file \"" << chunk->path()
+                   << "\" (errno: " << errno << "): "
+                   << strerror(errno);
+        return false;
+    }
+
+    size_t pos = chunk->offset();
+    size_t end = chunk->offset() + chunk->size();
+    size_t recordEnd = payloadEnd(fd, pos);
+    LogID logId = 0;
+    TermID term = 0;
+    while (pos < end) {
+        int32_t len;
+        if (pread(fd, &logId, sizeof(LogID), pos) != sizeof(LogID)
+                || pread(fd, &term, sizeof(TermID), pos + sizeof(LogID)) != sizeof(TermID)
+                || pread(fd, &len, sizeof(int32_t), pos + sizeof(LogID) + sizeof(TermID))
+                    != sizeof(int32_t)) {
+            LOG(ERROR) << "Failed to read the log at offset " << pos
+                       << " (errno " << errno << "): " << strerror(errno);
+            break;
+        }
+        pos += sizeof(LogID)
+               + sizeof(TermID)
+               + sizeof(ClusterID)
+               + 2 * sizeof(int32_t)
+               + len;
+        if (logId == id) {
+            break;
+        }
+        pos = nextLogPos(fd, spaceId, partId, pos, recordEnd, end);
+    }
+    close(fd);
+
+    if (logId != id) {
+        LOG(ERROR) << "Didn't find log " << id << " in the chunk [" << chunk->firstId()
+                   << ", " << chunk->lastId() << "] of " << chunk->path();
+        return false;
+    }
+    chunk->setSize(pos - chunk->offset());
+    chunk->setLastId(id);
+    chunk->setLastTerm(term);
+    return true;
+}
+
+
+// static
+bool SharedWal::readLogs(const WalFileInfo& chunk,
+                         GraphSpaceID spaceId,
+                         PartitionID partId,
+                         std::string& logs) {
+    int32_t fd = open(chunk.path(), O_RDONLY);
+    if (fd < 0) {
+        LOG(ERROR) << "Failed to open file \"" << chunk.path()
+                   << "\" (errno: " << errno << "): "
+                   << strerror(errno);
+        return false;
+    }
+
+    size_t pos = chunk.offset();
+    size_t end = chunk.offset() + chunk.size();
+    size_t recordEnd = payloadEnd(fd, pos);
+    bool succeeded = true;
+    logs.clear();
+    while (pos < end) {
+        // Read the logs of the part in the current record
+        size_t len = std::min(recordEnd, end) - pos;
+        auto size = logs.size();
+        logs.resize(size + len);
+        if (pread(fd, &logs[size], len, pos) != static_cast<ssize_t>(len)) {
+            LOG(ERROR) << "Failed to read the logs at offset " << pos << " of " << chunk.path()
+                       << " (errno " << errno << "): " << strerror(errno);
+            succeeded = false;
+            break;
+        }
+        pos = nextLogPos(fd, spaceId, partId, pos + len, recordEnd, end);
+    }
+    close(fd);
+    return succeeded;
+}
+
+
+WalFileInfoPtr SharedWal::appendChunk(GraphSpaceID spaceId,
+                                      PartitionID partId,
+                                      LogID firstId,
+                                      LogID lastId,
+                                      TermID lastTerm,
+                                      const folly::IOBuf& logs,
+                                      bool sync,
+                                      const WalFileInfo* last,
+                                      size_t* end) {
+    Request req;
+    req.type = kChunk;
+    req.spaceId = spaceId;
+    req.partId = partId;
+    req.firstId = firstId;
+    req.lastId = lastId;
+    req.lastTerm = lastTerm;
+    req.payload = &logs;
+    req.payloadLen = logs.computeChainDataLength();
+    req.sync = sync;
+    req.last = last;
+    submit(&req);
+    if (req.chunk == nullptr) {
+        CHECK_NOTNULL(end);
+        *end = req.end;
+    }
+    return req.chunk;
+}
+
+
+void SharedWal::rollback(GraphSpaceID spaceId, PartitionID partId, LogID id) {
+    Request req;
+    req.type = kRollback;
+    req.spaceId = spaceId;
+    req.partId = partId;
+    req.firstId = id;
+    req.lastId = id;
+    req.lastTerm = 0;
+    submit(&req);
+}
+
+
+void SharedWal::reset(GraphSpaceID spaceId, PartitionID partId) {
+    Request req;
+    req.type = kReset;
+    req.spaceId = spaceId;
+    req.partId = partId;
+    req.firstId = 0;
+    req.lastId = 0;
+    req.lastTerm = 0;
+    submit(&req);
+}
+
+
+std::vector<WalFileInfoPtr> SharedWal::claimChunks(GraphSpaceID spaceId, PartitionID partId) {
+    std::vector<WalFileInfoPtr> chunks;
+    std::lock_guard<std::mutex> g(lock_);
+    auto it = recovered_.find(std::make_pair(spaceId, partId));
+    if (it == recovered_.end()) {
+        return chunks;
+    }
+    for (auto& chunk : it->second) {
+        chunks.emplace_back(std::move(chunk.second));
+    }
+    recovered_.erase(it);
+    return chunks;
+}
+
+
+void SharedWal::releaseUnclaimed() {
+    std::lock_guard<std::mutex> g(lock_);
+    for (auto& part : recovered_) {
+        for (auto& chunk : part.second) {
+            releaseInternal(chunk.second);
+        }
+        if (!part.second.empty()) {
+            LOG(INFO) << "Release " << part.second.size() << " chunks of space "
+                      << part.first.first << ", part " << part.first.second;
+        }
+    }
+    recovered_.clear();
+    purgeSegments();
+}
+
+
+void SharedWal::release(WalFileInfoPtr chunk) {
+    if (chunk->segment() < 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> g(lock_);
+    releaseInternal(chunk);
+    purgeSegments();
+}
+
+
+void SharedWal::releaseInternal(WalFileInfoPtr chunk) {
+    auto it = segments_.find(chunk->segment());
+    CHECK(it != segments_.end()) << "Segment " << chunk->segment() << " has been removed";
+    CHECK_GT(it->second.refs, 0);
+    it->second.refs--;
+}
+
+
+int64_t SharedWal::currentSegment() const {
+    std::lock_guard<std::mutex> g(lock_);
+    return currSeq_;
+}
+
+
+void SharedWal::purgeSegments() {
+    while (!segments_.empty()) {
+        auto it = segments_.begin();
+        if (it->second.refs > 0 || it->first == currSeq_) {
+            break;
+        }
+        VLOG(1) << "Remove the segment " << it->second.path;
+        unlink(it->second.path.c_str());
+        segments_.erase(it);
+    }
+}
+
+
+void SharedWal::submit(Request* req) {
+    req->header.reserve(kHeaderSize);
+    int32_t len = req->payloadLen;
+    req->header.append(reinterpret_cast<char*>(&req->type), sizeof(int32_t));
+    req->header.append(reinterpret_cast<char*>(&req->spaceId), sizeof(GraphSpaceID));
+    req->header.append(reinterpret_cast<char*>(&req->partId), sizeof(PartitionID));
+    req->header.append(reinterpret_cast<char*>(&len), sizeof(int32_t));
+    req->header.append(reinterpret_cast<char*>(&req->firstId), sizeof(LogID));
+    req->header.append(reinterpret_cast<char*>(&req->lastId), sizeof(LogID));
+    req->header.append(reinterpret_cast<char*>(&req->lastTerm), sizeof(TermID));
+    req->footer = len;
+
+    {
+        std::lock_guard<std::mutex> g(queueLock_);
+        CHECK(!stopped_) << "The shared wal " << dir_ << " has stopped";
+        queue_.emplace_back(req);
+    }
+    queueCV_.notify_one();
+    req->done.wait();
+}
+
+
+void SharedWal::writerLoop() {
+    auto interval = std::chrono::milliseconds(policy_.syncIntervalMs);
+    while (true) {
+        std::vector<Request*> reqs;
+        {
+            std::unique_lock<std::mutex> g(queueLock_);
+            auto ready = [this] { return stopped_ || !queue_.empty(); };
+            if (dirty_ && policy_.sync == SharedWalSync::INTERVAL) {
+                // Wake up to sync the written ones even if there is nothing to write
+                queueCV_.wait_for(g, interval, ready);
+            } else {
+                queueCV_.wait(g, ready);
+            }
+            if (queue_.empty() && stopped_) {
+                break;
+            }
+            reqs.swap(queue_);
+        }
+        if (reqs.empty()) {
+            sync(false);
+        } else {
+            writeRequests(reqs);
+        }
+    }
+    closeCurrSegment();
+}
+
+
+void SharedWal::writeRequests(std::vector<Request*>& reqs) {
+    std::vector<struct iovec> iovs;
+    iovs.reserve(reqs.size() * 3);
+    bool needSync = policy_.sync == SharedWalSync::BATCH;
+    for (auto* req : reqs) {
+        needSync = needSync || req->sync;
+        size_t size = req->header.size() + req->payloadLen + sizeof(int32_t);
+        if (currFd_ < 0 || (currSize_ > 0 && currSize_ + size > policy_.fileSize)) {
+            // Write the ones before rolling over
+            writeIovs(iovs);
+            closeCurrSegment();
+            prepareNewSegment();
+        }
+        if (req->type == kChunk
+                && req->last != nullptr
+                && !req->last->sealed()
+                && req->last->segment() == currSeq_
+                && req->last->lastId() + 1 == req->firstId) {
+            // The logs follow the last chunk of the part in the segment, which covers them
+            req->end = currSize_ + req->header.size() + req->payloadLen;
+        } else if (req->type == kChunk) {
+            auto chunk = std::make_shared<WalFileInfo>(currPath_, req->firstId);
+            chunk->setOffset(currSize_ + req->header.size());
+            chunk->setSize(req->payloadLen);
+            chunk->setLastId(req->lastId);
+            chunk->setLastTerm(req->lastTerm);
+            chunk->setMTime(time::WallClock::fastNowInSec());
+            chunk->setSegment(currSeq_);
+            {
+                std::lock_guard<std::mutex> g(lock_);
+                segments_[currSeq_].refs++;
+            }
+            req->chunk = std::move(chunk);
+        }
+        iovs.push_back({const_cast<char*>(req->header.data()), req->header.size()});
+        if (req->payload != nullptr) {
+            for (auto range : *req->payload) {
+                if (!range.empty()) {
+                    iovs.push_back({const_cast<uint8_t*>(range.data()), range.size()});
+                }
+            }
+        }
+        iovs.push_back({&req->footer, sizeof(int32_t)});
+        currSize_ += size;
+    }
+    writeIovs(iovs);
+    sync(needSync);
+
+    for (auto* req : reqs) {
+        req->done.post();
+    }
+}
+
+
+void SharedWal::writeIovs(std::vector<struct iovec>& iovs) {
+    size_t idx = 0;
+    while (idx < iovs.size()) {
+        int32_t count = std::min(iovs.size() - idx, static_cast<size_t>(IOV_MAX));
+        ssize_t bytesWritten = writev(currFd_, &iovs[idx], count);
+        if (bytesWritten < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG(FATAL) << "Failed to write the segment " << currPath_
+                       << ", error:" << strerror(errno);
+        }
+        // Skip the ones written, a partial write continues from the middle of one
+        size_t written = bytesWritten;
+        while (written > 0) {
+            if (written >= iovs[idx].iov_len) {
+                written -= iovs[idx].iov_len;
+                idx++;
+            } else {
+                iovs[idx].iov_base = static_cast<char*>(iovs[idx].iov_base) + written;
+                iovs[idx].iov_len -= written;
+                written = 0;
+            }
+        }
+    }
+    if (!iovs.empty()) {
+        dirty_ = true;
+        iovs.clear();
+    }
+}
+
+
+void SharedWal::sync(bool force) {
+    if (currFd_ < 0 || !dirty_) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (!force
+            && (policy_.sync != SharedWalSync::INTERVAL
+                || now - lastSync_ < std::chrono::milliseconds(policy_.syncIntervalMs))) {
+        return;
+    }
+    CHECK_EQ(fdatasync(currFd_), 0) << strerror(errno);
+    dirty_ = false;
+    lastSync_ = now;
+}
+
+
+void SharedWal::closeCurrSegment() {
+    if (currFd_ < 0) {
+        return;
+    }
+    CHECK_EQ(fsync(currFd_), 0) << strerror(errno);
+    CHECK_EQ(close(currFd_), 0) << strerror(errno);
+    currFd_ = -1;
+    dirty_ = false;
+}
+
+
+void SharedWal::prepareNewSegment() {
+    CHECK_LT(currFd_, 0) << "The current segment needs to be closed first";
+    auto seq = currSeq_ + 1;
+    auto path = FileUtils::joinPath(dir_, folly::stringPrintf("%019ld.log", seq));
+    VLOG(1) << "Write new segment " << path;
+    currFd_ = open(path.c_str(),
+                   O_CREAT | O_EXCL | O_WRONLY | O_APPEND | O_CLOEXEC | O_LARGEFILE,
+                   0644);
+    if (currFd_ < 0) {
+        LOG(FATAL) << "Failed to open file \"" << path
+                   << "\" (errno: " << errno << "): "
+                   << strerror(errno);
+    }
+    {
+        std::lock_guard<std::mutex> g(lock_);
+        segments_[seq].path = path;
+        currSeq_ = seq;
+        // The previous one may not be referred any more
+        purgeSegments();
+    }
+    currPath_ = std::move(path);
+    currSize_ = 0;
+}
+
+}  // namespace wal
+}  // namespace nebula
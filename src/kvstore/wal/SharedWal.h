@@ -0,0 +1,235 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef WAL_SHAREDWAL_H_
+#define WAL_SHAREDWAL_H_
+
+#include "base/Base.h"
+#include <folly/synchronization/Baton.h>
+#include <folly/io/IOBuf.h>
+#include <gtest/gtest_prod.h>
+#include "thread/NamedThread.h"
+#include "kvstore/wal/WalFileInfo.h"
+
+namespace nebula {
+namespace wal {
+
+enum class SharedWalSync {
+    // Leave it to the os, the segment is synced when it is closed
+    NONE,
+    // Sync at most once in the interval
+    INTERVAL,
+    // Sync every group of writes before acknowledging them
+    BATCH,
+};
+
+
+struct SharedWalPolicy {
+    // The maximum size of each segment (in byte). When the current segment
+    // reaches this size, a new one will be created
+    size_t fileSize = 64 * 1024L * 1024L;
+
+    SharedWalSync sync = SharedWalSync::NONE;
+
+    // The sync interval when the sync policy is INTERVAL
+    int32_t syncIntervalMs = 100;
+};
+
+
+/**
+ * The segmented log shared by all the parts on one data path.
+ *
+ * Each FileBasedWal in the shared mode appends its logs as chunks to the shared wal,
+ * a chunk holds the continuous logs of one part in the same format as a wal file.
+ * The writes of all the parts are queued, and the writer thread writes all the queued
+ * ones with one writev() and syncs them once according to the policy, so the small
+ * writes scattered across the parts become sequential large ones.
+ *
+ * The record in a segment is:
+ *   type(int32), spaceId, partId, len(int32), firstId, lastId, lastTerm, payload, len(int32)
+ * The payload of a chunk is its logs. The rollback and reset of a part is written as a
+ * record without payload, which is replayed on restart, since the segments could not
+ * be truncated.
+ *
+ * Each part indexes its logs by one chunk per segment, which is extended by the following
+ * records of the part in the same segment, until a rollback seals it. Every chunk held by
+ * a part refers to its segment. The segments are removed from the oldest one, only when no
+ * chunk refers to them, so the records could always be replayed in order. Since each part
+ * keeps its last chunk, the wal of an idle part appends it again to the current segment
+ * once it expires, so that it doesn't keep the old segments.
+ * */
+class SharedWal final {
+    FRIEND_TEST(SharedWal, CleanSegments);
+
+public:
+    // A factory method to create a new shared wal
+    static std::shared_ptr<SharedWal> getSharedWal(const folly::StringPiece dir,
+                                                   SharedWalPolicy policy);
+
+    ~SharedWal();
+
+    /**
+     * Append the chunk of logs [firstId, lastId] of the part, it blocks until the chunk is
+     * written, and synced if the policy or the caller requires. The logs could be a chain
+     * of the records, which are written as they are without copying. The chunks written in one
+     * group are synced by one fdatasync. The returned info refers to the segment, until it
+     * is released.
+     *
+     * If the logs follow the given last chunk of the part, which is in the current segment
+     * and not sealed, no new chunk is returned. Instead the end of the logs is set in `end`,
+     * to which the caller extends the last chunk.
+     * */
+    WalFileInfoPtr appendChunk(GraphSpaceID spaceId,
+                               PartitionID partId,
+                               LogID firstId,
+                               LogID lastId,
+                               TermID lastTerm,
+                               const folly::IOBuf& logs,
+                               bool sync = false,
+                               const WalFileInfo* last = nullptr,
+                               size_t* end = nullptr);
+
+    // Persist that all logs of the part after the given id are discarded
+    void rollback(GraphSpaceID spaceId, PartitionID partId, LogID id);
+
+    // Persist that all logs of the part are discarded
+    void reset(GraphSpaceID spaceId, PartitionID partId);
+
+    /**
+     * Take the chunks of the part recovered from the segments, in the order of log id.
+     * Each part takes its chunks once when it is opened.
+     * */
+    std::vector<WalFileInfoPtr> claimChunks(GraphSpaceID spaceId, PartitionID partId);
+
+    // Release the chunks which are not claimed by any part, i.e. the parts removed
+    void releaseUnclaimed();
+
+    // Release the chunk, the segments not referred any more are removed
+    void release(WalFileInfoPtr chunk);
+
+    // The sequence of the segment being written
+    int64_t currentSegment() const;
+
+    /**
+     * Drop the logs after the given id in the chunk of the part. The logs are only dropped
+     * in memory, the caller should persist it by rollback()
+     * */
+    static bool trimChunk(WalFileInfoPtr chunk,
+                          GraphSpaceID spaceId,
+                          PartitionID partId,
+                          LogID id);
+
+    // Read all the logs of the part in the chunk, in the format of a wal file
+    static bool readLogs(const WalFileInfo& chunk,
+                         GraphSpaceID spaceId,
+                         PartitionID partId,
+                         std::string& logs);
+
+    // The end of the payload of the record, whose payload starts at the given offset
+    static size_t payloadEnd(int32_t fd, size_t offset);
+
+    /**
+     * Given the position following a log of the part, in the record whose payload ends at
+     * recordEnd, return the position of the next log of the part before the end of the
+     * chunk. The records of the other parts in between are skipped, and recordEnd is moved
+     * to the end of the record holding the next log.
+     * */
+    static size_t nextLogPos(int32_t fd,
+                             GraphSpaceID spaceId,
+                             PartitionID partId,
+                             size_t pos,
+                             size_t& recordEnd,
+                             size_t end);
+
+private:
+    struct Segment {
+        std::string path;
+        // The number of chunks referring to the segment
+        int64_t refs{0};
+    };
+
+    struct Request {
+        int32_t type;
+        GraphSpaceID spaceId;
+        PartitionID partId;
+        LogID firstId;
+        LogID lastId;
+        TermID lastTerm;
+        // The caller waits until the request is done, so the payload is valid meanwhile
+        const folly::IOBuf* payload{nullptr};
+        size_t payloadLen{0};
+        // Whether the request needs to be synced before acknowledged
+        bool sync{false};
+
+        std::string header;
+        int32_t footer;
+        // The last chunk of the part, which the chunk could extend
+        const WalFileInfo* last{nullptr};
+        // The result of a chunk, or the end of it if it extends the last one
+        WalFileInfoPtr chunk;
+        size_t end{0};
+        folly::Baton<> done;
+    };
+
+    using PartKey = std::pair<GraphSpaceID, PartitionID>;
+    using Chunks = std::map<LogID, WalFileInfoPtr>;
+
+    SharedWal(const folly::StringPiece dir, SharedWalPolicy policy);
+
+    // Replay all the segments
+    void scanAllSegments();
+
+    // Returns false if the segment has a broken tail
+    bool scanSegment(int64_t seq, Segment& segment);
+
+    void applyRollback(Chunks& chunks, GraphSpaceID spaceId, PartitionID partId, LogID id);
+
+    void submit(Request* req);
+
+    void writerLoop();
+
+    void writeRequests(std::vector<Request*>& reqs);
+
+    void writeIovs(std::vector<struct iovec>& iovs);
+
+    void sync(bool force);
+
+    void closeCurrSegment();
+
+    void prepareNewSegment();
+
+    // Remove the oldest segments not referred any more, requires lock_
+    void purgeSegments();
+
+    void releaseInternal(WalFileInfoPtr chunk);
+
+private:
+    const std::string dir_;
+    const SharedWalPolicy policy_;
+
+    // Protects the segments, their refs and the recovered chunks
+    mutable std::mutex lock_;
+    std::map<int64_t, Segment> segments_;
+    std::map<PartKey, Chunks> recovered_;
+
+    // The writer thread owns the current segment, currSeq_ is changed under lock_ as well
+    int64_t currSeq_{-1};
+    std::string currPath_;
+    int32_t currFd_{-1};
+    size_t currSize_{0};
+    bool dirty_{false};
+    std::chrono::steady_clock::time_point lastSync_;
+
+    std::mutex queueLock_;
+    std::condition_variable queueCV_;
+    std::vector<Request*> queue_;
+    bool stopped_{false};
+    thread::NamedThread writer_;
+};
+
+}  // namespace wal
+}  // namespace nebula
+#endif  // WAL_SHAREDWAL_H_
@@ -50,7 +50,10 @@ public:
     // This method is *NOT* thread safe
     virtual bool reset() = 0;
 
-    virtual void cleanWAL(int32_t ttl = 0) = 0;
+    // Clean the logs expired, except the ones after durableId, which the state machine
+    // doesn't hold durably yet
+    virtual void cleanWAL(int32_t ttl = 0,
+                          LogID durableId = std::numeric_limits<LogID>::max()) = 0;
 
     // Scan [firstLogId, lastLogId]
     virtual std::unique_ptr<LogIterator> iterator(LogID firstLogId,
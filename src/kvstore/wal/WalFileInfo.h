@@ -15,6 +15,14 @@
 namespace nebula {
 namespace wal {
 
+/**
+ * The info of a wal file, or of a chunk of logs in a segment of the shared wal.
+ *
+ * A chunk holds the continuous logs of one part in one segment, in the same format as
+ * a wal file, starting from the offset in the segment. The logs could span several records
+ * of the part, between which the records of the other parts are skipped when reading.
+ * A wal file is a chunk starting from 0, which does not belong to any segment.
+ * */
 class WalFileInfo final {
 public:
     WalFileInfo(std::string path, LogID firstId)
@@ -23,7 +31,10 @@ public:
         , lastLogId_(-1)
         , lastLogTerm_(-1)
         , mtime_(0)
-        , size_(0) {}
+        , size_(0)
+        , offset_(0)
+        , segment_(-1)
+        , sealed_(false) {}
 
     const char* path() const {
         return fullpath_.c_str();
@@ -61,6 +72,29 @@ public:
         size_ = size;
     }
 
+    size_t offset() const {
+        return offset_;
+    }
+    void setOffset(size_t offset) {
+        offset_ = offset;
+    }
+
+    // The segment of the shared wal holding the chunk, or -1 for a wal file
+    int64_t segment() const {
+        return segment_;
+    }
+    void setSegment(int64_t segment) {
+        segment_ = segment;
+    }
+
+    // The chunk could not be extended any more, since the logs after it are rolled back
+    bool sealed() const {
+        return sealed_;
+    }
+    void seal() {
+        sealed_ = true;
+    }
+
 private:
     const std::string fullpath_;
     const LogID firstLogId_;
@@ -68,6 +102,9 @@ private:
     TermID lastLogTerm_;
     time_t mtime_;
     size_t size_;
+    size_t offset_;
+    int64_t segment_;
+    bool sealed_;
 };
 
 
@@ -8,6 +8,7 @@
 #include <gtest/gtest.h>
 #include "kvstore/wal/FileBasedWal.h"
 #include "fs/TempDir.h"
+#include "stats/StatsManager.h"
 
 namespace nebula {
 namespace wal {
@@ -41,7 +42,7 @@ TEST(FileBasedWal, AppendLogs) {
     auto wal = FileBasedWal::getWal(walDir.path(),
                                     "",
                                     policy,
-                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                    [](LogID, TermID, ClusterID, folly::StringPiece) {
                                         return true;
                                     });
     EXPECT_EQ(0, wal->lastLogId());
@@ -59,7 +60,7 @@ TEST(FileBasedWal, AppendLogs) {
     wal = FileBasedWal::getWal(walDir.path(),
                                "",
                                policy,
-                               [](LogID, TermID, ClusterID, const std::string&) {
+                               [](LogID, TermID, ClusterID, folly::StringPiece) {
                                    return true;
                                });
     EXPECT_EQ(10, wal->lastLogId());
@@ -89,7 +90,7 @@ TEST(FileBasedWal, CacheOverflow) {
     auto wal = FileBasedWal::getWal(walDir.path(),
                                     "",
                                     policy,
-                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                    [](LogID, TermID, ClusterID, folly::StringPiece) {
                                         return true;
                                     });
     EXPECT_EQ(0, wal->lastLogId());
@@ -112,7 +113,7 @@ TEST(FileBasedWal, CacheOverflow) {
     wal = FileBasedWal::getWal(walDir.path(),
                                "",
                                policy,
-                               [](LogID, TermID, ClusterID, const std::string&) {
+                               [](LogID, TermID, ClusterID, folly::StringPiece) {
                                    return true;
                                });
 
@@ -142,7 +143,7 @@ TEST(FileBasedWal, Rollback) {
     auto wal = FileBasedWal::getWal(walDir.path(),
                                     "",
                                     policy,
-                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                    [](LogID, TermID, ClusterID, folly::StringPiece) {
                                         return true;
                                     });
     EXPECT_EQ(0, wal->lastLogId());
@@ -220,7 +221,7 @@ TEST(FileBasedWal, RollbackThenReopen) {
     auto wal = FileBasedWal::getWal(walDir.path(),
                                     "",
                                     policy,
-                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                    [](LogID, TermID, ClusterID, folly::StringPiece) {
                                         return true;
                                     });
     EXPECT_EQ(0, wal->lastLogId());
@@ -246,7 +247,7 @@ TEST(FileBasedWal, RollbackThenReopen) {
     wal = FileBasedWal::getWal(walDir.path(),
                                "",
                                policy,
-                               [](LogID, TermID, ClusterID, const std::string&) {
+                               [](LogID, TermID, ClusterID, folly::StringPiece) {
                                    return true;
                                });
     EXPECT_EQ(800, wal->lastLogId());
@@ -275,7 +276,7 @@ TEST(FileBasedWal, RollbackToZero) {
     auto wal = FileBasedWal::getWal(walDir.path(),
                                     "",
                                     policy,
-                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                    [](LogID, TermID, ClusterID, folly::StringPiece) {
                                         return true;
                                     });
     ASSERT_EQ(0, wal->lastLogId());
@@ -317,7 +318,7 @@ TEST(FileBasedWal, BackAndForth) {
     auto wal = FileBasedWal::getWal(walDir.path(),
                                     "",
                                     policy,
-                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                    [](LogID, TermID, ClusterID, folly::StringPiece) {
                                         return true;
                                     });
     ASSERT_EQ(0, wal->lastLogId());
@@ -360,7 +361,7 @@ TEST(FileBasedWal, TTLTest) {
     auto wal = FileBasedWal::getWal(walDir.path(),
                                     "",
                                     policy,
-                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                    [](LogID, TermID, ClusterID, folly::StringPiece) {
                                         return true;
                                     });
     EXPECT_EQ(0, wal->lastLogId());
@@ -388,7 +389,7 @@ TEST(FileBasedWal, TTLTest) {
         wal = FileBasedWal::getWal(walDir.path(),
                                    "",
                                    policy,
-                                   [](LogID, TermID, ClusterID, const std::string&) {
+                                   [](LogID, TermID, ClusterID, folly::StringPiece) {
                                        return true;
                                    });
         EXPECT_EQ(200, wal->lastLogId());
@@ -405,6 +406,9 @@ TEST(FileBasedWal, TTLTest) {
         EXPECT_EQ(201, id);
     }
     auto totalFilesNum = static_cast<FileBasedWal*>(wal.get())->walFiles_.size();
+    // The logs not durable in the state machine are never cleaned
+    wal->cleanWAL(0, 0);
+    EXPECT_EQ(totalFilesNum, static_cast<FileBasedWal*>(wal.get())->walFiles_.size());
     wal->cleanWAL();
     auto numFilesAfterGC = static_cast<FileBasedWal*>(wal.get())->walFiles_.size();
     // We will hold the last expired file.
@@ -419,7 +423,7 @@ TEST(FileBasedWal, TTLTest) {
         wal = FileBasedWal::getWal(walDir.path(),
                                    "",
                                    policy,
-                                   [](LogID, TermID, ClusterID, const std::string&) {
+                                   [](LogID, TermID, ClusterID, folly::StringPiece) {
                                        return true;
                                    });
         EXPECT_EQ(200, wal->lastLogId());
@@ -445,7 +449,7 @@ TEST(FileBasedWal, CheckLastWalTest) {
     auto wal = FileBasedWal::getWal(walDir.path(),
                                     "",
                                     policy,
-                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                    [](LogID, TermID, ClusterID, folly::StringPiece) {
                                         return true;
                                     });
     {
@@ -476,7 +480,7 @@ TEST(FileBasedWal, CheckLastWalTest) {
         wal = FileBasedWal::getWal(walDir.path(),
                                    "",
                                    policy,
-                                   [](LogID, TermID, ClusterID, const std::string&) {
+                                   [](LogID, TermID, ClusterID, folly::StringPiece) {
                                        return true;
                                    });
         EXPECT_EQ(999, wal->lastLogId());
@@ -503,7 +507,7 @@ TEST(FileBasedWal, CheckLastWalTest) {
         wal = FileBasedWal::getWal(walDir.path(),
                                    "",
                                    policy,
-                                   [](LogID, TermID, ClusterID, const std::string&) {
+                                   [](LogID, TermID, ClusterID, folly::StringPiece) {
                                        return true;
                                    });
         EXPECT_EQ(expected, wal->lastLogId());
@@ -522,7 +526,7 @@ TEST(FileBasedWal, CheckLastWalTest) {
         wal = FileBasedWal::getWal(walDir.path(),
                                    "",
                                    policy,
-                                   [](LogID, TermID, ClusterID, const std::string&) {
+                                   [](LogID, TermID, ClusterID, folly::StringPiece) {
                                        return true;
                                    });
         EXPECT_EQ(expected, wal->lastLogId());
@@ -542,7 +546,7 @@ TEST(FileBasedWal, CheckLastWalTest) {
         wal = FileBasedWal::getWal(walDir.path(),
                                    "",
                                    policy,
-                                   [](LogID, TermID, ClusterID, const std::string&) {
+                                   [](LogID, TermID, ClusterID, folly::StringPiece) {
                                        return true;
                                    });
         EXPECT_EQ(1000, wal->lastLogId());
@@ -556,7 +560,7 @@ TEST(FileBasedWal, LinkTest) {
     auto wal = FileBasedWal::getWal(walDir.path(),
                                     "",
                                     policy,
-                                    [](LogID, TermID, ClusterID, const std::string&) {
+                                    [](LogID, TermID, ClusterID, folly::StringPiece) {
                                         return true;
                                     });
     EXPECT_EQ(0, wal->lastLogId());
@@ -578,6 +582,108 @@ TEST(FileBasedWal, LinkTest) {
     EXPECT_EQ(num + 1, wal->walFiles_.size());
 }
 
+
+TEST(FileBasedWal, LogBufTest) {
+    FileBasedWalPolicy policy;
+    TempDir walDir("/tmp/testWal.XXXXXX");
+    auto wal = FileBasedWal::getWal(walDir.path(),
+                                    "",
+                                    policy,
+                                    [](LogID, TermID, ClusterID, folly::StringPiece) {
+                                        return true;
+                                    });
+    for (int i = 1; i <= 10; i++) {
+        EXPECT_TRUE(
+            wal->appendLog(i /*id*/, 1 /*term*/, 0 /*cluster*/,
+                           folly::stringPrintf(kLongMsg, i)));
+    }
+
+    std::vector<folly::IOBuf> logs;
+    {
+        auto it = wal->iterator(1, 10);
+        for (; it->valid(); ++(*it)) {
+            auto buf = it->logBuf();
+            // Shared with the buffer in the wal
+            EXPECT_EQ(it->logMsg().data(), reinterpret_cast<const char*>(buf.data()));
+            logs.emplace_back(std::move(buf));
+        }
+    }
+    // The logs are still valid after the wal is gone
+    wal.reset();
+    ASSERT_EQ(10, logs.size());
+    for (int i = 1; i <= 10; i++) {
+        auto& buf = logs[i - 1];
+        EXPECT_EQ(folly::stringPrintf(kLongMsg, i),
+                  std::string(reinterpret_cast<const char*>(buf.data()), buf.length()));
+    }
+}
+
+
+TEST(FileBasedWal, SyncTest) {
+    EXPECT_EQ(WalSyncPolicy::SYNC, FileBasedWal::toSyncPolicy("sync").value());
+    EXPECT_EQ(WalSyncPolicy::INTERVAL, FileBasedWal::toSyncPolicy("interval").value());
+    EXPECT_FALSE(FileBasedWal::toSyncPolicy("fsync").ok());
+
+    FileBasedWalPolicy policy;
+    policy.fileSize = 1024 * 64;
+    policy.sync = WalSyncPolicy::SYNC;
+    TempDir walDir("/tmp/testWal.XXXXXX");
+    auto wal = FileBasedWal::getWal(walDir.path(),
+                                    "",
+                                    policy,
+                                    [](LogID, TermID, ClusterID, folly::StringPiece) {
+                                        return true;
+                                    },
+                                    nullptr,
+                                    1,
+                                    1);
+
+    // The syncing threads share the fdatasync while the logs are appended, across rolling
+    // over the wal files
+    std::atomic<bool> stopped{false};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([wal, &stopped] {
+            while (!stopped) {
+                wal->sync();
+            }
+        });
+    }
+    for (int i = 1; i <= 200; i++) {
+        EXPECT_TRUE(
+            wal->appendLog(i /*id*/, 1 /*term*/, 0 /*cluster*/,
+                           folly::stringPrintf(kLongMsg, i)));
+        wal->sync();
+        EXPECT_LE(wal->writtenSeq_.load(), wal->syncedSeq_);
+    }
+    stopped = true;
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_LT(1, wal->walFiles_.size());
+    EXPECT_TRUE(stats::StatsManager::readHisto("wal_sync_latency_1",
+                                               stats::StatsManager::TimeRange::ONE_MINUTE,
+                                               99.0).ok());
+    auto count = stats::StatsManager::readStats("wal_append_latency_1",
+                                                stats::StatsManager::TimeRange::ONE_MINUTE,
+                                                stats::StatsManager::StatsMethod::COUNT);
+    ASSERT_TRUE(count.ok());
+    EXPECT_EQ(200, count.value());
+
+    // Not synced by the async policy
+    wal->setSyncPolicy(WalSyncPolicy::ASYNC);
+    EXPECT_TRUE(wal->appendLog(201, 1, 0, folly::stringPrintf(kLongMsg, 201)));
+    wal->sync();
+    EXPECT_GT(wal->writtenSeq_.load(), wal->syncedSeq_);
+
+    // Synced once the interval elapsed
+    wal->setSyncInterval(10);
+    wal->setSyncPolicy(WalSyncPolicy::INTERVAL);
+    usleep(20 * 1000);
+    wal->sync();
+    EXPECT_EQ(wal->writtenSeq_.load(), wal->syncedSeq_);
+}
+
 }  // namespace wal
 }  // namespace nebula
 
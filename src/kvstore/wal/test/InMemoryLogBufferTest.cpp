@@ -21,7 +21,7 @@ TEST(InMemoryLogBuffer, Empty) {
         LogID id,
         TermID j,
         ClusterID k,
-        const std::string& s){
+        folly::StringPiece s){
         // Nothing
         UNUSED(id);
         UNUSED(j);
@@ -52,7 +52,7 @@ TEST(InMemoryLogBuffer, Simple) {
         LogID id,
         TermID j,
         ClusterID k,
-        const std::string& s){
+        folly::StringPiece s){
         // Nothing
         UNUSED(id);
         UNUSED(j);
@@ -0,0 +1,250 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "kvstore/wal/FileBasedWal.h"
+#include "kvstore/wal/SharedWal.h"
+#include "fs/TempDir.h"
+
+namespace nebula {
+namespace wal {
+
+using nebula::fs::FileUtils;
+using nebula::fs::TempDir;
+
+class SharedWalEnv {
+public:
+    SharedWalEnv(const char* root, SharedWalPolicy policy)
+        : root_(root)
+        , policy_(std::move(policy)) {
+        open();
+    }
+
+    // Reopen the shared wal and the wals of all parts, as restarting
+    void reopen() {
+        wals_.clear();
+        sharedWal_.reset();
+        open();
+    }
+
+    std::shared_ptr<FileBasedWal> wal(PartitionID partId) {
+        auto it = wals_.find(partId);
+        if (it != wals_.end()) {
+            return it->second;
+        }
+        FileBasedWalPolicy policy;
+        policy.bufferSize = 1024 * 64;
+        auto wal = FileBasedWal::getWal(folly::stringPrintf("%s/wal/%d", root_, partId),
+                                        folly::stringPrintf("[Part %d] ", partId),
+                                        policy,
+                                        [](LogID, TermID, ClusterID, folly::StringPiece) {
+                                            return true;
+                                        },
+                                        sharedWal_,
+                                        1,
+                                        partId);
+        wals_.emplace(partId, wal);
+        return wal;
+    }
+
+    std::shared_ptr<SharedWal> sharedWal() {
+        return sharedWal_;
+    }
+
+private:
+    void open() {
+        sharedWal_ = SharedWal::getSharedWal(folly::stringPrintf("%s/shared", root_), policy_);
+    }
+
+private:
+    const char* root_;
+    SharedWalPolicy policy_;
+    std::shared_ptr<SharedWal> sharedWal_;
+    std::unordered_map<PartitionID, std::shared_ptr<FileBasedWal>> wals_;
+};
+
+
+static void checkLogs(std::shared_ptr<FileBasedWal> wal,
+                      LogID first,
+                      LogID last,
+                      PartitionID partId) {
+    auto it = wal->iterator(first, last);
+    LogID id = first;
+    while (it->valid()) {
+        ASSERT_EQ(id, it->logId());
+        ASSERT_EQ(folly::stringPrintf("Part %d log %ld", partId, id), it->logMsg());
+        ++(*it);
+        ++id;
+    }
+    EXPECT_EQ(last + 1, id);
+}
+
+
+TEST(SharedWal, MultiParts) {
+    TempDir rootDir("/tmp/testSharedWal.XXXXXX");
+    SharedWalPolicy policy;
+    policy.fileSize = 1024 * 64;
+    policy.sync = SharedWalSync::BATCH;
+    SharedWalEnv env(rootDir.path(), policy);
+
+    std::vector<std::thread> threads;
+    for (PartitionID partId = 1; partId <= 5; partId++) {
+        auto wal = env.wal(partId);
+        threads.emplace_back([wal, partId] {
+            for (LogID id = 1; id <= 1000; id++) {
+                ASSERT_TRUE(wal->appendLog(id, 1, 0,
+                                           folly::stringPrintf("Part %d log %ld", partId, id)));
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (PartitionID partId = 1; partId <= 5; partId++) {
+        EXPECT_EQ(1000, env.wal(partId)->lastLogId());
+        checkLogs(env.wal(partId), 1, 1000, partId);
+    }
+    // All parts are written into the segments
+    EXPECT_TRUE(FileUtils::listAllFilesInDir(
+        folly::stringPrintf("%s/wal/1", rootDir.path()).c_str(), false, "*.wal").empty());
+    EXPECT_LT(1, FileUtils::listAllFilesInDir(
+        folly::stringPrintf("%s/shared", rootDir.path()).c_str(), false, "*.log").size());
+
+    env.reopen();
+    for (PartitionID partId = 1; partId <= 5; partId++) {
+        auto wal = env.wal(partId);
+        EXPECT_EQ(1, wal->firstLogId());
+        EXPECT_EQ(1000, wal->lastLogId());
+        EXPECT_EQ(1, wal->lastLogTerm());
+        // Read from the segments
+        checkLogs(wal, 1, 1000, partId);
+        checkLogs(wal, 500, 600, partId);
+    }
+
+    // The latest logs are copied into a normal wal file
+    auto linkPath = folly::stringPrintf("%s/link", rootDir.path());
+    ASSERT_TRUE(env.wal(3)->linkCurrentWAL(linkPath.c_str()));
+    FileBasedWalPolicy walPolicy;
+    auto linked = FileBasedWal::getWal(linkPath,
+                                       "",
+                                       walPolicy,
+                                       [](LogID, TermID, ClusterID, folly::StringPiece) {
+                                           return true;
+                                       });
+    EXPECT_EQ(1000, linked->lastLogId());
+    checkLogs(linked, linked->firstLogId(), 1000, 3);
+}
+
+
+TEST(SharedWal, RollbackAndReset) {
+    TempDir rootDir("/tmp/testSharedWal.XXXXXX");
+    SharedWalPolicy policy;
+    policy.fileSize = 1024 * 16;
+    SharedWalEnv env(rootDir.path(), policy);
+
+    for (PartitionID partId = 1; partId <= 2; partId++) {
+        for (LogID id = 1; id <= 1000; id++) {
+            ASSERT_TRUE(env.wal(partId)->appendLog(
+                id, 1, 0, folly::stringPrintf("Part %d log %ld", partId, id)));
+        }
+    }
+
+    ASSERT_TRUE(env.wal(1)->rollbackToLog(500));
+    EXPECT_EQ(500, env.wal(1)->lastLogId());
+    checkLogs(env.wal(1), 450, 500, 1);
+    for (LogID id = 501; id <= 600; id++) {
+        ASSERT_TRUE(env.wal(1)->appendLog(id, 2, 0, folly::stringPrintf("Part 1 log %ld", id)));
+    }
+    ASSERT_TRUE(env.wal(2)->reset());
+    EXPECT_EQ(0, env.wal(2)->lastLogId());
+    ASSERT_TRUE(env.wal(2)->appendLog(2001, 3, 0, "Part 2 log 2001"));
+
+    env.reopen();
+    // The rollback is replayed
+    EXPECT_EQ(1, env.wal(1)->firstLogId());
+    EXPECT_EQ(600, env.wal(1)->lastLogId());
+    EXPECT_EQ(2, env.wal(1)->lastLogTerm());
+    checkLogs(env.wal(1), 1, 600, 1);
+    // The reset is replayed
+    EXPECT_EQ(2001, env.wal(2)->firstLogId());
+    EXPECT_EQ(2001, env.wal(2)->lastLogId());
+    checkLogs(env.wal(2), 2001, 2001, 2);
+}
+
+
+TEST(SharedWal, CleanSegments) {
+    TempDir rootDir("/tmp/testSharedWal.XXXXXX");
+    SharedWalPolicy policy;
+    policy.fileSize = 1024 * 16;
+    SharedWalEnv env(rootDir.path(), policy);
+
+    // Part 2 holds the first segment
+    ASSERT_TRUE(env.wal(2)->appendLog(1, 1, 0, "Part 2 log 1"));
+    for (LogID id = 1; id <= 1000; id++) {
+        ASSERT_TRUE(env.wal(1)->appendLog(id, 1, 0, folly::stringPrintf("Part 1 log %ld", id)));
+    }
+    auto segmentsNum = env.sharedWal()->segments_.size();
+    EXPECT_LT(2, segmentsNum);
+    // The logs of a part in one segment are indexed by one chunk
+    EXPECT_EQ(segmentsNum, env.wal(1)->accessAllWalInfo([] (WalFileInfoPtr) {
+        return true;
+    }));
+
+    // The segments are removed in order, so the first one keeps all others
+    ASSERT_TRUE(env.wal(1)->reset());
+    EXPECT_LE(segmentsNum, env.sharedWal()->segments_.size());
+    EXPECT_EQ(0, env.sharedWal()->segments_.begin()->first);
+
+    ASSERT_TRUE(env.wal(2)->reset());
+    EXPECT_EQ(1, env.sharedWal()->segments_.size());
+
+    // The last chunk of the idle part is written again once it expires,
+    // so that it doesn't keep the old segments
+    ASSERT_TRUE(env.wal(2)->appendLog(2, 1, 0, "Part 2 log 2"));
+    for (LogID id = 1; id <= 1000; id++) {
+        ASSERT_TRUE(env.wal(1)->appendLog(id, 1, 0, folly::stringPrintf("Part 1 log %ld", id)));
+    }
+    EXPECT_LT(2, env.sharedWal()->segments_.size());
+    sleep(2);
+    env.wal(1)->cleanWAL(1);
+    env.wal(2)->cleanWAL(1);
+    EXPECT_EQ(1, env.sharedWal()->segments_.size());
+    EXPECT_EQ(2, env.wal(2)->lastLogId());
+    checkLogs(env.wal(2), 2, 2, 2);
+    EXPECT_EQ(1000, env.wal(1)->lastLogId());
+    checkLogs(env.wal(1), env.wal(1)->firstLogId(), 1000, 1);
+
+    env.reopen();
+    EXPECT_EQ(2, env.wal(2)->firstLogId());
+    checkLogs(env.wal(2), 2, 2, 2);
+    EXPECT_EQ(1000, env.wal(1)->lastLogId());
+    checkLogs(env.wal(1), env.wal(1)->firstLogId(), 1000, 1);
+
+    // The parts not opened any more are released
+    ASSERT_TRUE(env.wal(3)->appendLog(1, 1, 0, "Part 3 log 1"));
+    for (LogID id = 1001; id <= 2000; id++) {
+        ASSERT_TRUE(env.wal(1)->appendLog(id, 1, 0, folly::stringPrintf("Part 1 log %ld", id)));
+    }
+    env.reopen();
+    checkLogs(env.wal(1), 1001, 2000, 1);
+    EXPECT_LT(2, env.sharedWal()->segments_.size());
+    env.sharedWal()->releaseUnclaimed();
+    ASSERT_TRUE(env.wal(1)->reset());
+    EXPECT_EQ(1, env.sharedWal()->segments_.size());
+}
+
+}  // namespace wal
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,80 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef META_PINNEDSCHEMAS_H_
+#define META_PINNEDSCHEMAS_H_
+
+#include "base/Base.h"
+#include "meta/SchemaManager.h"
+
+namespace nebula {
+namespace meta {
+
+/**
+ * The schemas read by a request or a compaction, pinned by (space, tag or edge, version).
+ *
+ * Each schema is got from the SchemaManager only once, and then handed out as an alias
+ * which doesn't own it, so reading the rows with it takes no lock and touches no refcount.
+ * The schemas returned must not outlive the PinnedSchemas, which is not thread safe.
+ */
+class PinnedSchemas final {
+public:
+    explicit PinnedSchemas(SchemaManager* schemaMan)
+        : schemaMan_(schemaMan) {
+        CHECK_NOTNULL(schemaMan_);
+    }
+
+    // Return the newest one if ver less 0, which is pinned as well
+    std::shared_ptr<const SchemaProviderIf>
+    getTagSchema(GraphSpaceID space, TagID tag, SchemaVer ver = -1) {
+        auto& schema = tagSchemas_[std::make_pair(toKey(space, tag), ver)];
+        if (!schema.first) {
+            schema.first = true;
+            schema.second = schemaMan_->getTagSchema(space, tag, ver);
+        }
+        return alias(schema.second);
+    }
+
+    // Return the newest one if ver less 0, which is pinned as well
+    std::shared_ptr<const SchemaProviderIf>
+    getEdgeSchema(GraphSpaceID space, EdgeType edge, SchemaVer ver = -1) {
+        auto& schema = edgeSchemas_[std::make_pair(toKey(space, edge), ver)];
+        if (!schema.first) {
+            schema.first = true;
+            schema.second = schemaMan_->getEdgeSchema(space, edge, ver);
+        }
+        return alias(schema.second);
+    }
+
+    SchemaManager* schemaManager() const {
+        return schemaMan_;
+    }
+
+private:
+    // (space, tag or edge), version => whether it's got, and the schema, which could be null
+    using Schemas = std::unordered_map<std::pair<int64_t, SchemaVer>,
+                                       std::pair<bool, std::shared_ptr<const SchemaProviderIf>>>;
+
+    static int64_t toKey(GraphSpaceID space, int32_t id) {
+        return (static_cast<int64_t>(space) << 32) | static_cast<uint32_t>(id);
+    }
+
+    static std::shared_ptr<const SchemaProviderIf>
+    alias(const std::shared_ptr<const SchemaProviderIf>& schema) {
+        // Aliasing an empty shared_ptr, so copying it does no atomic operation
+        return std::shared_ptr<const SchemaProviderIf>(std::shared_ptr<const SchemaProviderIf>(),
+                                                       schema.get());
+    }
+
+private:
+    SchemaManager*              schemaMan_{nullptr};
+    Schemas                     tagSchemas_;
+    Schemas                     edgeSchemas_;
+};
+
+}  // namespace meta
+}  // namespace nebula
+#endif  // META_PINNEDSCHEMAS_H_
@@ -119,7 +119,7 @@ void MetaClient::heartBeatThreadFunc() {
         return;
     }
 
-    // if MetaServer has some changes, refesh the localCache_
+    // if MetaServer has some changes, refesh the local cache
     if (localLastUpdateTime_ < metadLastUpdateTime_) {
         bool ldRet = loadData();
         bool lcRet = true;
@@ -144,15 +144,7 @@ bool MetaClient::loadData() {
         return false;
     }
 
-    decltype(localCache_)            cache;
-    decltype(spaceIndexByName_)      spaceIndexByName;
-    decltype(spaceTagIndexByName_)   spaceTagIndexByName;
-    decltype(spaceEdgeIndexByName_)  spaceEdgeIndexByName;
-    decltype(spaceNewestTagVerMap_)  spaceNewestTagVerMap;
-    decltype(spaceNewestEdgeVerMap_) spaceNewestEdgeVerMap;
-    decltype(spaceEdgeIndexByType_)  spaceEdgeIndexByType;
-    decltype(spaceTagIndexById_)     spaceTagIndexById;
-    decltype(spaceAllEdgeMap_)       spaceAllEdgeMap;
+    auto metaCache = std::make_shared<MetaCache>();
 
     for (auto space : ret.value()) {
         auto spaceId = space.first;
@@ -173,13 +165,13 @@ bool MetaClient::loadData() {
 
         if (!loadSchemas(spaceId,
                          spaceCache,
-                         spaceTagIndexByName,
-                         spaceTagIndexById,
-                         spaceEdgeIndexByName,
-                         spaceEdgeIndexByType,
-                         spaceNewestTagVerMap,
-                         spaceNewestEdgeVerMap,
-                         spaceAllEdgeMap)) {
+                         metaCache->spaceTagIndexByName,
+                         metaCache->spaceTagIndexById,
+                         metaCache->spaceEdgeIndexByName,
+                         metaCache->spaceEdgeIndexByType,
+                         metaCache->spaceNewestTagVerMap,
+                         metaCache->spaceNewestEdgeVerMap,
+                         metaCache->spaceAllEdgeMap)) {
             LOG(ERROR) << "Load Schemas Failed";
             return false;
         }
@@ -190,28 +182,31 @@ bool MetaClient::loadData() {
             return false;
         }
 
-        cache.emplace(spaceId, spaceCache);
-        spaceIndexByName.emplace(space.second, spaceId);
+        metaCache->localCache.emplace(spaceId, spaceCache);
+        metaCache->spaceIndexByName.emplace(space.second, spaceId);
     }
-    decltype(localCache_) oldCache;
+    std::shared_ptr<const MetaCache> oldMetaCache;
     {
-        folly::RWSpinLock::WriteHolder holder(localCacheLock_);
-        oldCache               = std::move(localCache_);
-        localCache_            = std::move(cache);
-        spaceIndexByName_      = std::move(spaceIndexByName);
-        spaceTagIndexByName_   = std::move(spaceTagIndexByName);
-        spaceEdgeIndexByName_  = std::move(spaceEdgeIndexByName);
-        spaceNewestTagVerMap_  = std::move(spaceNewestTagVerMap);
-        spaceNewestEdgeVerMap_ = std::move(spaceNewestEdgeVerMap);
-        spaceEdgeIndexByType_  = std::move(spaceEdgeIndexByType);
-        spaceTagIndexById_     = std::move(spaceTagIndexById);
-        spaceAllEdgeMap_       = std::move(spaceAllEdgeMap);
-    }
-    diff(oldCache, localCache_);
+        folly::RWSpinLock::WriteHolder holder(metaCacheLock_);
+        oldMetaCache = std::move(metaCache_);
+        metaCache_   = metaCache;
+        ++metaCacheVersion_;
+    }
+    diff(oldMetaCache->localCache, metaCache->localCache);
     ready_ = true;
     return true;
 }
 
+const MetaCache& MetaClient::metaCache() {
+    auto& local = *threadMetaCache_;
+    if (local.version != metaCacheVersion_.load(std::memory_order_acquire)) {
+        folly::RWSpinLock::ReadHolder holder(metaCacheLock_);
+        local.cache   = metaCache_;
+        local.version = metaCacheVersion_.load(std::memory_order_relaxed);
+    }
+    return *local.cache;
+}
+
 bool MetaClient::loadSchemas(GraphSpaceID spaceId,
                              std::shared_ptr<SpaceInfoCache> spaceInfoCache,
                              SpaceTagNameIdMap &tagNameIdMap,
@@ -337,9 +332,9 @@ bool MetaClient::loadIndexes(GraphSpaceID spaceId,
 }
 
 Status MetaClient::checkTagIndexed(GraphSpaceID space, TagID tagID) {
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = localCache_.find(space);
-    if (it != localCache_.end()) {
+    const auto& localCache = metaCache().localCache;
+    auto it = localCache.find(space);
+    if (it != localCache.end()) {
         auto tagIt = it->second->tagIndexes_.find(tagID);
         if (tagIt != it->second->tagIndexes_.end()) {
             return Status::OK();
@@ -351,9 +346,9 @@ Status MetaClient::checkTagIndexed(GraphSpaceID space, TagID tagID) {
 }
 
 Status MetaClient::checkEdgeIndexed(GraphSpaceID space, EdgeType edgeType) {
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = localCache_.find(space);
-    if (it != localCache_.end()) {
+    const auto& localCache = metaCache().localCache;
+    auto it = localCache.find(space);
+    if (it != localCache.end()) {
         auto edgeIt = it->second->edgeIndexes_.find(edgeType);
         if (edgeIt != it->second->edgeIndexes_.end()) {
             return Status::OK();
@@ -746,9 +741,9 @@ MetaClient::getSpaceIdByNameFromCache(const std::string& name) {
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceIndexByName_.find(name);
-    if (it != spaceIndexByName_.end()) {
+    const auto& cache = metaCache();
+    auto it = cache.spaceIndexByName.find(name);
+    if (it != cache.spaceIndexByName.end()) {
         return it->second;
     }
     return Status::SpaceNotFound();
@@ -760,9 +755,9 @@ StatusOr<TagID> MetaClient::getTagIDByNameFromCache(const GraphSpaceID& space,
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceTagIndexByName_.find(std::make_pair(space, name));
-    if (it == spaceTagIndexByName_.end()) {
+    const auto& cache = metaCache();
+    auto it = cache.spaceTagIndexByName.find(std::make_pair(space, name));
+    if (it == cache.spaceTagIndexByName.end()) {
         std::string error = folly::stringPrintf("TagName `%s'  is nonexistent", name.c_str());
         return Status::Error(std::move(error));
     }
@@ -774,9 +769,9 @@ StatusOr<std::string> MetaClient::getTagNameByIdFromCache(const GraphSpaceID& sp
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceTagIndexById_.find(std::make_pair(space, tagId));
-    if (it == spaceTagIndexById_.end()) {
+    const auto& cache = metaCache();
+    auto it = cache.spaceTagIndexById.find(std::make_pair(space, tagId));
+    if (it == cache.spaceTagIndexById.end()) {
         std::string error = folly::stringPrintf("TagID `%d'  is nonexistent", tagId);
         return Status::Error(std::move(error));
     }
@@ -789,9 +784,9 @@ StatusOr<EdgeType> MetaClient::getEdgeTypeByNameFromCache(const GraphSpaceID& sp
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceEdgeIndexByName_.find(std::make_pair(space, name));
-    if (it == spaceEdgeIndexByName_.end()) {
+    const auto& cache = metaCache();
+    auto it = cache.spaceEdgeIndexByName.find(std::make_pair(space, name));
+    if (it == cache.spaceEdgeIndexByName.end()) {
         std::string error = folly::stringPrintf("EdgeName `%s'  is nonexistent", name.c_str());
         return Status::Error(std::move(error));
     }
@@ -803,9 +798,9 @@ StatusOr<std::string> MetaClient::getEdgeNameByTypeFromCache(const GraphSpaceID&
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceEdgeIndexByType_.find(std::make_pair(space, edgeType));
-    if (it == spaceEdgeIndexByType_.end()) {
+    const auto& cache = metaCache();
+    auto it = cache.spaceEdgeIndexByType.find(std::make_pair(space, edgeType));
+    if (it == cache.spaceEdgeIndexByType.end()) {
         std::string error = folly::stringPrintf("EdgeType `%d'  is nonexistent", edgeType);
         return Status::Error(std::move(error));
     }
@@ -816,9 +811,9 @@ StatusOr<std::vector<std::string>> MetaClient::getAllEdgeFromCache(const GraphSp
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceAllEdgeMap_.find(space);
-    if (it == spaceAllEdgeMap_.end()) {
+    const auto& cache = metaCache();
+    auto it = cache.spaceAllEdgeMap.find(space);
+    if (it == cache.spaceAllEdgeMap.end()) {
         std::string error = folly::stringPrintf("SpaceId `%d'  is nonexistent", space);
         return Status::Error(std::move(error));
     }
@@ -956,15 +951,14 @@ MetaClient::removeRange(std::string segment, std::string start, std::string end)
 
 
 PartsMap MetaClient::getPartsMapFromCache(const HostAddr& host) {
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    return doGetPartsMap(host, localCache_);
+    return doGetPartsMap(host, metaCache().localCache);
 }
 
 
 StatusOr<PartMeta> MetaClient::getPartMetaFromCache(GraphSpaceID spaceId, PartitionID partId) {
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = localCache_.find(spaceId);
-    if (it == localCache_.end()) {
+    const auto& localCache = metaCache().localCache;
+    auto it = localCache.find(spaceId);
+    if (it == localCache.end()) {
         return Status::Error("Space not found, spaceid: %d", spaceId);
     }
     auto& cache = it->second;
@@ -983,9 +977,9 @@ StatusOr<PartMeta> MetaClient::getPartMetaFromCache(GraphSpaceID spaceId, Partit
 Status  MetaClient::checkPartExistInCache(const HostAddr& host,
                                           GraphSpaceID spaceId,
                                           PartitionID partId) {
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = localCache_.find(spaceId);
-    if (it != localCache_.end()) {
+    const auto& localCache = metaCache().localCache;
+    auto it = localCache.find(spaceId);
+    if (it != localCache.end()) {
         auto partsIt = it->second->partsOnHost_.find(host);
         if (partsIt != it->second->partsOnHost_.end()) {
             for (auto& pId : partsIt->second) {
@@ -1003,9 +997,9 @@ Status  MetaClient::checkPartExistInCache(const HostAddr& host,
 
 Status MetaClient::checkSpaceExistInCache(const HostAddr& host,
                                           GraphSpaceID spaceId) {
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = localCache_.find(spaceId);
-    if (it != localCache_.end()) {
+    const auto& localCache = metaCache().localCache;
+    auto it = localCache.find(spaceId);
+    if (it != localCache.end()) {
         auto partsIt = it->second->partsOnHost_.find(host);
         if (partsIt != it->second->partsOnHost_.end() && !partsIt->second.empty()) {
             return Status::OK();
@@ -1017,9 +1011,9 @@ Status MetaClient::checkSpaceExistInCache(const HostAddr& host,
 }
 
 StatusOr<int32_t> MetaClient::partsNum(GraphSpaceID spaceId) {
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = localCache_.find(spaceId);
-    if (it == localCache_.end()) {
+    const auto& localCache = metaCache().localCache;
+    auto it = localCache.find(spaceId);
+    if (it == localCache.end()) {
         return Status::Error("Space not found, spaceid: %d", spaceId);
     }
     return it->second->partsAlloc_.size();
@@ -1422,9 +1416,9 @@ MetaClient::getTagSchemaFromCache(GraphSpaceID spaceId, TagID tagID, SchemaVer v
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto spaceIt = localCache_.find(spaceId);
-    if (spaceIt == localCache_.end()) {
+    const auto& localCache = metaCache().localCache;
+    auto spaceIt = localCache.find(spaceId);
+    if (spaceIt == localCache.end()) {
         LOG(ERROR) << "Space " << spaceId << " not found!";
         return std::shared_ptr<const SchemaProviderIf>();
     } else {
@@ -1443,9 +1437,9 @@ MetaClient::getEdgeSchemaFromCache(GraphSpaceID spaceId, EdgeType edgeType, Sche
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto spaceIt = localCache_.find(spaceId);
-    if (spaceIt == localCache_.end()) {
+    const auto& localCache = metaCache().localCache;
+    auto spaceIt = localCache.find(spaceId);
+    if (spaceIt == localCache.end()) {
         LOG(ERROR) << "Space " << spaceId << " not found!";
         return std::shared_ptr<const SchemaProviderIf>();
     } else {
@@ -1502,9 +1496,9 @@ MetaClient::getTagIndexFromCache(GraphSpaceID spaceId, IndexID indexID) {
         return Status::Error("Not ready!");
     }
 
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto spaceIt = localCache_.find(spaceId);
-    if (spaceIt == localCache_.end()) {
+    const auto& localCache = metaCache().localCache;
+    auto spaceIt = localCache.find(spaceId);
+    if (spaceIt == localCache.end()) {
         LOG(ERROR) << "Space " << spaceId << " not found!";
         return Status::SpaceNotFound();
     } else {
@@ -1540,9 +1534,9 @@ MetaClient::getEdgeIndexFromCache(GraphSpaceID spaceId, IndexID indexID) {
         return Status::Error("Not ready!");
     }
 
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto spaceIt = localCache_.find(spaceId);
-    if (spaceIt == localCache_.end()) {
+    const auto& localCache = metaCache().localCache;
+    auto spaceIt = localCache.find(spaceId);
+    if (spaceIt == localCache.end()) {
         VLOG(3) << "Space " << spaceId << " not found!";
         return Status::SpaceNotFound();
     } else {
@@ -1578,9 +1572,9 @@ MetaClient::getTagIndexesFromCache(GraphSpaceID spaceId) {
         return Status::Error("Not ready!");
     }
 
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto spaceIt = localCache_.find(spaceId);
-    if (spaceIt == localCache_.end()) {
+    const auto& localCache = metaCache().localCache;
+    auto spaceIt = localCache.find(spaceId);
+    if (spaceIt == localCache.end()) {
         VLOG(3) << "Space " << spaceId << " not found!";
         return Status::SpaceNotFound();
     } else {
@@ -1601,9 +1595,9 @@ MetaClient::getEdgeIndexesFromCache(GraphSpaceID spaceId) {
         return Status::Error("Not ready!");
     }
 
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto spaceIt = localCache_.find(spaceId);
-    if (spaceIt == localCache_.end()) {
+    const auto& localCache = metaCache().localCache;
+    auto spaceIt = localCache.find(spaceId);
+    if (spaceIt == localCache.end()) {
         VLOG(3) << "Space " << spaceId << " not found!";
         return Status::SpaceNotFound();
     } else {
@@ -1627,9 +1621,9 @@ StatusOr<SchemaVer> MetaClient::getLatestTagVersionFromCache(const GraphSpaceID&
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceNewestTagVerMap_.find(std::make_pair(space, tagId));
-    if (it == spaceNewestTagVerMap_.end()) {
+    const auto& cache = metaCache();
+    auto it = cache.spaceNewestTagVerMap.find(std::make_pair(space, tagId));
+    if (it == cache.spaceNewestTagVerMap.end()) {
         return Status::TagNotFound();
     }
     return it->second;
@@ -1640,9 +1634,9 @@ StatusOr<SchemaVer> MetaClient::getLatestEdgeVersionFromCache(const GraphSpaceID
     if (!ready_) {
         return Status::Error("Not ready!");
     }
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    auto it = spaceNewestEdgeVerMap_.find(std::make_pair(space, edgeType));
-    if (it == spaceNewestEdgeVerMap_.end()) {
+    const auto& cache = metaCache();
+    auto it = cache.spaceNewestEdgeVerMap.find(std::make_pair(space, edgeType));
+    if (it == cache.spaceNewestEdgeVerMap.end()) {
         return Status::EdgeNotFound();
     }
     return it->second;
@@ -2133,8 +2127,13 @@ void MetaClient::updateNestedGflags(const std::string& name) {
     conf.forEachItem([&optionMap] (const std::string& key, const folly::dynamic& val) {
         optionMap.emplace(key, val.asString());
     });
-    folly::RWSpinLock::ReadHolder holder(localCacheLock_);
-    for (const auto& spaceEntry : localCache_) {
+    // The listener may read the cache again, so the cache iterated is held here
+    std::shared_ptr<const MetaCache> cache;
+    {
+        folly::RWSpinLock::ReadHolder holder(metaCacheLock_);
+        cache = metaCache_;
+    }
+    for (const auto& spaceEntry : cache->localCache) {
         listener_->onSpaceOptionUpdated(spaceEntry.first, optionMap);
     }
 }
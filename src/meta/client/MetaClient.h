@@ -83,6 +83,22 @@ using LeaderMap = std::unordered_map<std::pair<GraphSpaceID, PartitionID>, HostA
 
 using IndexStatus = std::tuple<std::string, std::string, std::string>;
 
+/**
+ * All the cache loaded from the meta server. It's immutable once published, each refresh
+ * builds a new one and swaps it in as a whole, so a reader never sees it half updated.
+ */
+struct MetaCache {
+    LocalCache            localCache;
+    SpaceNameIdMap        spaceIndexByName;
+    SpaceTagNameIdMap     spaceTagIndexByName;
+    SpaceEdgeNameTypeMap  spaceEdgeIndexByName;
+    SpaceEdgeTypeNameMap  spaceEdgeIndexByType;
+    SpaceTagIdNameMap     spaceTagIndexById;
+    SpaceNewestTagVerMap  spaceNewestTagVerMap;
+    SpaceNewestEdgeVerMap spaceNewestEdgeVerMap;
+    SpaceAllEdgeMap       spaceAllEdgeMap;
+};
+
 struct ConfigItem {
     ConfigItem() {}
 
@@ -520,6 +536,14 @@ protected:
 
     void diff(const LocalCache& oldCache, const LocalCache& newCache);
 
+    /**
+     * The cache published latest. Each thread keeps a copy of the pointer, and only takes
+     * the lock to renew it when the version changed, so reading the cache takes no lock
+     * and touches no refcount. The cache returned stays valid until the next call
+     * in the same thread.
+     */
+    const MetaCache& metaCache();
+
     template<typename RESP>
     Status handleResponse(const RESP& resp);
 
@@ -559,7 +583,6 @@ private:
     int64_t               localLastUpdateTime_{0};
     int64_t               metadLastUpdateTime_{0};
 
-    LocalCache localCache_;
     std::vector<HostAddr> addrs_;
     // The lock used to protect active_ and leader_.
     folly::RWSpinLock hostLock_;
@@ -568,19 +591,20 @@ private:
     HostAddr localHost_;
 
     std::unique_ptr<thread::GenericWorker> bgThread_;
-    SpaceNameIdMap        spaceIndexByName_;
-    SpaceTagNameIdMap     spaceTagIndexByName_;
-    SpaceEdgeNameTypeMap  spaceEdgeIndexByName_;
-    SpaceEdgeTypeNameMap  spaceEdgeIndexByType_;
-    SpaceTagIdNameMap     spaceTagIndexById_;
-    SpaceNewestTagVerMap  spaceNewestTagVerMap_;
-    SpaceNewestEdgeVerMap spaceNewestEdgeVerMap_;
-    SpaceAllEdgeMap       spaceAllEdgeMap_;
-
     NameIndexMap          tagNameIndexMap_;
     NameIndexMap          edgeNameIndexMap_;
 
-    folly::RWSpinLock     localCacheLock_;
+    struct ThreadMetaCache {
+        uint64_t                         version{0};
+        std::shared_ptr<const MetaCache> cache;
+    };
+
+    // The lock only protects publishing metaCache_ and reading it to renew the copies
+    folly::RWSpinLock     metaCacheLock_;
+    std::shared_ptr<const MetaCache> metaCache_{std::make_shared<const MetaCache>()};
+    // Bumped on each publishing
+    std::atomic<uint64_t> metaCacheVersion_{1};
+    folly::ThreadLocal<ThreadMetaCache> threadMetaCache_;
     MetaChangedListener*  listener_{nullptr};
     folly::RWSpinLock     listenerLock_;
     std::atomic<ClusterID> clusterId_{0};
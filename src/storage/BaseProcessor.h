@@ -96,6 +96,16 @@ protected:
                                           std::string&& start, std::string&& prefix,
                                           std::unique_ptr<kvstore::KVIterator>* iter) = delete;
 
+    kvstore::ResultCode doPrefix(GraphSpaceID spaceId, PartitionID partId,
+                                 const std::string& prefix,
+                                 std::unique_ptr<kvstore::KVIterator>* iter,
+                                 const kvstore::ReadContext& ctx);
+
+    kvstore::ResultCode doRangeWithPrefix(GraphSpaceID spaceId, PartitionID partId,
+                                          const std::string& start, const std::string& prefix,
+                                          std::unique_ptr<kvstore::KVIterator>* iter,
+                                          const kvstore::ReadContext& ctx);
+
     nebula::cpp2::ColumnDef columnDef(std::string name, nebula::cpp2::SupportedType type) {
         nebula::cpp2::ColumnDef column;
         column.set_name(std::move(name));
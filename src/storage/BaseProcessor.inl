@@ -138,6 +138,23 @@ kvstore::ResultCode BaseProcessor<RESP>::doRangeWithPrefix(
     return kvstore_->rangeWithPrefix(spaceId, partId, start, prefix, iter);
 }
 
+template<typename RESP>
+kvstore::ResultCode BaseProcessor<RESP>::doPrefix(GraphSpaceID spaceId,
+                                                  PartitionID partId,
+                                                  const std::string& prefix,
+                                                  std::unique_ptr<kvstore::KVIterator>* iter,
+                                                  const kvstore::ReadContext& ctx) {
+    return kvstore_->prefix(spaceId, partId, prefix, iter, ctx);
+}
+
+template<typename RESP>
+kvstore::ResultCode BaseProcessor<RESP>::doRangeWithPrefix(
+        GraphSpaceID spaceId, PartitionID partId, const std::string& start,
+        const std::string& prefix, std::unique_ptr<kvstore::KVIterator>* iter,
+        const kvstore::ReadContext& ctx) {
+    return kvstore_->rangeWithPrefix(spaceId, partId, start, prefix, iter, ctx);
+}
+
 template <typename RESP>
 IndexValues
 BaseProcessor<RESP>::collectIndexValues(RowReader* reader,
@@ -8,7 +8,7 @@
 #define STORAGE_COMMON_H_
 
 #include "base/Base.h"
-#include "base/ConcurrentLRUCache.h"
+#include "base/ConcurrentClockCache.h"
 #include "filter/Expressions.h"
 #include "dataman/RowReader.h"
 
@@ -17,7 +17,7 @@ namespace storage {
 
 using TagProp = std::pair<std::string, std::string>;
 
-using VertexCache = ConcurrentLRUCache<std::pair<VertexID, TagID>, std::string>;
+using VertexCache = ConcurrentClockCache<std::pair<VertexID, TagID>, std::string>;
 
 struct FilterContext {
     // key: <tagName, propName> -> propValue
@@ -11,8 +11,10 @@
 #include "base/NebulaKeyUtils.h"
 #include "dataman/RowReader.h"
 #include "meta/NebulaSchemaProvider.h"
+#include "meta/PinnedSchemas.h"
 #include "kvstore/CompactionFilter.h"
 #include "storage/CommonUtils.h"
+#include "storage/PartStats.h"
 
 DEFINE_bool(storage_kv_mode, false, "True for kv mode");
 
@@ -22,10 +24,24 @@ namespace storage {
 class StorageCompactionFilter final : public kvstore::KVFilter {
 public:
     StorageCompactionFilter(meta::SchemaManager* schemaMan,
-                            meta::IndexManager* indexMan)
+                            meta::IndexManager* indexMan,
+                            GraphSpaceID spaceId,
+                            std::shared_ptr<CompactionStatsMerger> statsMerger = nullptr)
         : schemaMan_(schemaMan)
-        , indexMan_(indexMan) {
+        , schemas_(schemaMan)
+        , indexMan_(indexMan)
+        , spaceId_(spaceId)
+        , statsMerger_(std::move(statsMerger)) {
         CHECK_NOTNULL(schemaMan_);
+        if (statsMerger_ != nullptr) {
+            statsMerger_->onFilterCreated();
+        }
+    }
+
+    ~StorageCompactionFilter() {
+        if (statsMerger_ != nullptr) {
+            statsMerger_->onFilterDone(collector_.finish());
+        }
     }
 
     bool filter(GraphSpaceID spaceId,
@@ -51,6 +67,9 @@ public:
                 VLOG(3) << "Extra versions has been filtered!";
                 return true;
             }
+            if (statsMerger_ != nullptr) {
+                collector_.collect(key);
+            }
         } else if (NebulaKeyUtils::isIndexKey(key)) {
             if (!indexValid(spaceId, key)) {
                 VLOG(3) << "Index invalid for the key " << key;
@@ -97,21 +116,21 @@ public:
                   const folly::StringPiece& val) const {
         if (NebulaKeyUtils::isVertex(key)) {
             auto tagId = NebulaKeyUtils::getTagId(key);
-            auto schema = this->schemaMan_->getTagSchema(spaceId, tagId);
+            auto schema = schemas_.getTagSchema(spaceId, tagId);
             if (!schema) {
                 VLOG(3) << "Space " << spaceId << ", Tag " << tagId << " invalid";
                 return false;
             }
-            auto reader = nebula::RowReader::getTagPropReader(schemaMan_, val, spaceId, tagId);
+            auto reader = nebula::RowReader::getTagPropReader(&schemas_, val, spaceId, tagId);
             return checkDataTtlValid(schema.get(), reader.get());
         } else if (NebulaKeyUtils::isEdge(key)) {
             auto edgeType = NebulaKeyUtils::getEdgeType(key);
-            auto schema = this->schemaMan_->getEdgeSchema(spaceId, std::abs(edgeType));
+            auto schema = schemas_.getEdgeSchema(spaceId, std::abs(edgeType));
             if (!schema) {
                 VLOG(3) << "Space " << spaceId << ", EdgeType " << edgeType << " invalid";
                 return false;
             }
-            auto reader = nebula::RowReader::getEdgePropReader(schemaMan_, val,
+            auto reader = nebula::RowReader::getEdgePropReader(&schemas_, val,
                                                                spaceId, std::abs(edgeType));
             return checkDataTtlValid(schema.get(), reader.get());
         }
@@ -170,7 +189,13 @@ public:
 private:
     mutable std::string lastKeyWithNoVersion_;
     meta::SchemaManager* schemaMan_ = nullptr;
+    // The schemas are pinned during the compaction, since every row is checked against them
+    mutable meta::PinnedSchemas schemas_;
     meta::IndexManager* indexMan_ = nullptr;
+    GraphSpaceID spaceId_;
+    // Only set on the full compaction, to re-derive the statistics of the parts
+    std::shared_ptr<CompactionStatsMerger> statsMerger_;
+    mutable PartStatsCollector collector_;
 };
 
 class StorageCompactionFilterFactory final : public kvstore::KVCompactionFilterFactory {
@@ -178,13 +203,22 @@ public:
     StorageCompactionFilterFactory(meta::SchemaManager* schemaMan,
                                    meta::IndexManager* indexMan,
                                    GraphSpaceID spaceId,
-                                   int32_t customFilterIntervalSecs):
+                                   int32_t customFilterIntervalSecs,
+                                   PartStatsManager* partStats = nullptr):
         KVCompactionFilterFactory(spaceId, customFilterIntervalSecs),
         schemaMan_(schemaMan),
-        indexMan_(indexMan) {}
+        indexMan_(indexMan),
+        spaceId_(spaceId) {
+        if (partStats != nullptr) {
+            statsMerger_ = std::make_shared<CompactionStatsMerger>(partStats, spaceId);
+        }
+    }
 
-    std::unique_ptr<kvstore::KVFilter> createKVFilter() override {
-        return std::make_unique<StorageCompactionFilter>(schemaMan_, indexMan_);
+    std::unique_ptr<kvstore::KVFilter> createKVFilter(bool fullCompaction) override {
+        return std::make_unique<StorageCompactionFilter>(schemaMan_,
+                                                         indexMan_,
+                                                         spaceId_,
+                                                         fullCompaction ? statsMerger_ : nullptr);
     }
 
     const char* Name() const override {
@@ -194,14 +228,19 @@ public:
 private:
     meta::SchemaManager* schemaMan_ = nullptr;
     meta::IndexManager* indexMan_ = nullptr;
+    GraphSpaceID spaceId_;
+    // Shared by the filters of the subcompactions
+    std::shared_ptr<CompactionStatsMerger> statsMerger_;
 };
 
 class StorageCompactionFilterFactoryBuilder : public kvstore::CompactionFilterFactoryBuilder {
 public:
     StorageCompactionFilterFactoryBuilder(meta::SchemaManager* schemaMan,
-                                          meta::IndexManager* indexMan)
+                                          meta::IndexManager* indexMan,
+                                          PartStatsManager* partStats = nullptr)
         : schemaMan_(schemaMan)
-        , indexMan_(indexMan) {}
+        , indexMan_(indexMan)
+        , partStats_(partStats) {}
 
     virtual ~StorageCompactionFilterFactoryBuilder() = default;
 
@@ -210,12 +249,14 @@ public:
         return std::make_shared<StorageCompactionFilterFactory>(schemaMan_,
                                                                 indexMan_,
                                                                 spaceId,
-                                                                customFilterIntervalSecs);
+                                                                customFilterIntervalSecs,
+                                                                partStats_);
     }
 
 private:
     meta::SchemaManager* schemaMan_ = nullptr;
     meta::IndexManager* indexMan_ = nullptr;
+    PartStatsManager* partStats_ = nullptr;
 };
 
 
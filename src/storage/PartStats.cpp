@@ -0,0 +1,285 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/PartStats.h"
+
+namespace nebula {
+namespace storage {
+
+constexpr size_t PartStats::kDegreeBuckets;
+
+namespace {
+
+template<typename T>
+void appendValue(std::string& raw, T val) {
+    raw.append(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+template<typename T>
+bool readValue(folly::StringPiece& raw, T& val) {
+    if (raw.size() < sizeof(T)) {
+        return false;
+    }
+    memcpy(&val, raw.data(), sizeof(T));
+    raw.advance(sizeof(T));
+    return true;
+}
+
+}  // Anonymous namespace
+
+std::string PartStats::encode() const {
+    std::string raw;
+    appendValue<uint32_t>(raw, tagVertices.size());
+    for (auto& tag : tagVertices) {
+        appendValue(raw, tag.first);
+        appendValue(raw, tag.second);
+    }
+    appendValue<uint32_t>(raw, edgeCounts.size());
+    for (auto& edge : edgeCounts) {
+        appendValue(raw, edge.first);
+        appendValue(raw, edge.second);
+    }
+    appendValue<uint32_t>(raw, degreeHistograms.size());
+    for (auto& hist : degreeHistograms) {
+        appendValue(raw, hist.first);
+        for (size_t i = 0; i < kDegreeBuckets; i++) {
+            appendValue<int64_t>(raw, i < hist.second.size() ? hist.second[i] : 0);
+        }
+    }
+    return raw;
+}
+
+// static
+bool PartStats::decode(folly::StringPiece raw, PartStats& stats) {
+    uint32_t num = 0;
+    if (!readValue(raw, num)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < num; i++) {
+        TagID tagId;
+        int64_t count;
+        if (!readValue(raw, tagId) || !readValue(raw, count)) {
+            return false;
+        }
+        stats.tagVertices[tagId] = count;
+    }
+    if (!readValue(raw, num)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < num; i++) {
+        EdgeType edgeType;
+        int64_t count;
+        if (!readValue(raw, edgeType) || !readValue(raw, count)) {
+            return false;
+        }
+        stats.edgeCounts[edgeType] = count;
+    }
+    if (!readValue(raw, num)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < num; i++) {
+        EdgeType edgeType;
+        if (!readValue(raw, edgeType)) {
+            return false;
+        }
+        auto& hist = stats.degreeHistograms[edgeType];
+        hist.resize(kDegreeBuckets, 0);
+        for (size_t j = 0; j < kDegreeBuckets; j++) {
+            if (!readValue(raw, hist[j])) {
+                return false;
+            }
+        }
+    }
+    return raw.empty();
+}
+
+void PartStatsManager::apply(GraphSpaceID spaceId, PartitionID partId, const PartStats& delta) {
+    if (delta.empty()) {
+        return;
+    }
+    folly::RWSpinLock::WriteHolder wh(&lock_);
+    stats_[spaceId][partId].merge(delta);
+}
+
+void PartStatsManager::reset(GraphSpaceID spaceId,
+                             std::unordered_map<PartitionID, PartStats> stats) {
+    folly::RWSpinLock::WriteHolder wh(&lock_);
+    auto& spaceStats = stats_[spaceId];
+    for (auto& part : stats) {
+        spaceStats[part.first] = std::move(part.second);
+    }
+}
+
+void PartStatsManager::remove(GraphSpaceID spaceId, PartitionID partId) {
+    folly::RWSpinLock::WriteHolder wh(&lock_);
+    auto spaceIt = stats_.find(spaceId);
+    if (spaceIt != stats_.end()) {
+        spaceIt->second.erase(partId);
+    }
+}
+
+PartStats PartStatsManager::get(GraphSpaceID spaceId, PartitionID partId, bool raw) const {
+    folly::RWSpinLock::ReadHolder rh(&lock_);
+    auto spaceIt = stats_.find(spaceId);
+    if (spaceIt == stats_.end()) {
+        return PartStats();
+    }
+    auto partIt = spaceIt->second.find(partId);
+    if (partIt == spaceIt->second.end()) {
+        return PartStats();
+    }
+    auto stats = partIt->second;
+    if (raw) {
+        return stats;
+    }
+    for (auto& tag : stats.tagVertices) {
+        tag.second = std::max<int64_t>(tag.second, 0);
+    }
+    for (auto& edge : stats.edgeCounts) {
+        edge.second = std::max<int64_t>(edge.second, 0);
+    }
+    return stats;
+}
+
+void PartStatsListener::count(folly::StringPiece key, int64_t delta) {
+    if (NebulaKeyUtils::isVertex(key)) {
+        delta_.tagVertices[NebulaKeyUtils::getTagId(key)] += delta;
+    } else if (NebulaKeyUtils::isEdge(key)) {
+        auto edgeType = NebulaKeyUtils::getEdgeType(key);
+        if (edgeType > 0) {
+            delta_.edgeCounts[edgeType] += delta;
+        }
+    }
+}
+
+void PartStatsListener::uncount(kvstore::KVIterator* iter) {
+    std::string lastKey;
+    for (; iter->valid(); iter->next()) {
+        auto key = iter->key();
+        if (!NebulaKeyUtils::isVertex(key) && !NebulaKeyUtils::isEdge(key)) {
+            continue;
+        }
+        auto keyWithNoVersion = NebulaKeyUtils::keyWithNoVersion(key);
+        if (keyWithNoVersion == lastKey) {
+            continue;
+        }
+        lastKey = keyWithNoVersion.str();
+        count(key, -1);
+    }
+}
+
+void PartStatsListener::onRemovePrefix(folly::StringPiece prefix) {
+    std::unique_ptr<kvstore::KVIterator> iter;
+    if (engine_->prefix(prefix.str(), &iter) != kvstore::ResultCode::SUCCEEDED) {
+        LOG(WARNING) << "Failed to read the keys removed of space " << spaceId_
+                     << ", part " << partId_;
+        return;
+    }
+    uncount(iter.get());
+}
+
+void PartStatsListener::onRemoveRange(folly::StringPiece start, folly::StringPiece end) {
+    std::unique_ptr<kvstore::KVIterator> iter;
+    if (engine_->range(start.str(), end.str(), &iter) != kvstore::ResultCode::SUCCEEDED) {
+        LOG(WARNING) << "Failed to read the keys removed of space " << spaceId_
+                     << ", part " << partId_;
+        return;
+    }
+    uncount(iter.get());
+}
+
+kvstore::ResultCode PartStatsListener::onCommit(kvstore::WriteBatch* batch) {
+    if (delta_.empty()) {
+        return kvstore::ResultCode::SUCCEEDED;
+    }
+    auto stats = manager_->get(spaceId_, partId_, true);
+    stats.merge(delta_);
+    return batch->put(NebulaKeyUtils::systemStatsKey(partId_), stats.encode());
+}
+
+void PartStatsListener::onCommitted(bool succeeded) {
+    if (succeeded) {
+        manager_->apply(spaceId_, partId_, delta_);
+    }
+    delta_ = PartStats();
+}
+
+void PartStatsListener::onReset() {
+    auto code = engine_->remove(NebulaKeyUtils::systemStatsKey(partId_));
+    if (code != kvstore::ResultCode::SUCCEEDED) {
+        LOG(WARNING) << "Failed to remove the statistics of space " << spaceId_
+                     << ", part " << partId_;
+    }
+    manager_->remove(spaceId_, partId_);
+    delta_ = PartStats();
+}
+
+void PartStatsListener::onIngested() {
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto code = engine_->prefix(NebulaKeyUtils::prefix(partId_), &iter);
+    if (code != kvstore::ResultCode::SUCCEEDED) {
+        LOG(WARNING) << "Failed to read the keys ingested of space " << spaceId_
+                     << ", part " << partId_;
+        return;
+    }
+    PartStatsCollector collector;
+    for (; iter->valid(); iter->next()) {
+        collector.collect(iter->key());
+    }
+    auto stats = collector.finish();
+    auto& partStats = stats[partId_];
+    code = engine_->put(NebulaKeyUtils::systemStatsKey(partId_), partStats.encode());
+    if (code != kvstore::ResultCode::SUCCEEDED) {
+        LOG(WARNING) << "Failed to persist the statistics of space " << spaceId_
+                     << ", part " << partId_;
+    }
+    std::unordered_map<PartitionID, PartStats> parts;
+    parts.emplace(partId_, std::move(partStats));
+    manager_->reset(spaceId_, std::move(parts));
+}
+
+std::unique_ptr<kvstore::PartCommitListener>
+PartStatsListenerFactory::create(GraphSpaceID spaceId,
+                                 PartitionID partId,
+                                 kvstore::KVEngine* engine) {
+    if (manager_ == nullptr) {
+        return nullptr;
+    }
+    std::string val;
+    auto code = engine->get(NebulaKeyUtils::systemStatsKey(partId), &val);
+    if (code == kvstore::ResultCode::SUCCEEDED) {
+        PartStats stats;
+        if (PartStats::decode(val, stats)) {
+            std::unordered_map<PartitionID, PartStats> parts;
+            parts.emplace(partId, std::move(stats));
+            manager_->reset(spaceId, std::move(parts));
+        } else {
+            LOG(WARNING) << "Broken statistics of space " << spaceId << ", part " << partId;
+        }
+    }
+    return std::make_unique<PartStatsListener>(manager_, spaceId, partId, engine);
+}
+
+void CompactionStatsMerger::onFilterCreated() {
+    std::lock_guard<std::mutex> g(lock_);
+    running_++;
+}
+
+void CompactionStatsMerger::onFilterDone(std::unordered_map<PartitionID, PartStats> stats) {
+    std::lock_guard<std::mutex> g(lock_);
+    for (auto& part : stats) {
+        stats_[part.first].merge(part.second);
+    }
+    CHECK_GT(running_, 0);
+    if (--running_ == 0) {
+        // All the subcompactions have seen the data of the parts on this engine
+        manager_->reset(spaceId_, std::move(stats_));
+        stats_.clear();
+    }
+}
+
+}  // namespace storage
+}  // namespace nebula
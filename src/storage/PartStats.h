@@ -0,0 +1,297 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_PARTSTATS_H_
+#define STORAGE_PARTSTATS_H_
+
+#include "base/Base.h"
+#include "base/NebulaKeyUtils.h"
+#include <folly/RWSpinLock.h>
+#include "kvstore/CommitListener.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * The approximate statistics of one part: the vertex count of each tag, the edge count of
+ * each edge type, and the out degree histogram of each edge type.
+ *
+ * The i-th bucket of a degree histogram counts the vertices whose out degree is
+ * in [2^i, 2^(i+1)). Only the out edges are counted, the reverse edges are skipped.
+ * */
+struct PartStats {
+    static constexpr size_t kDegreeBuckets = 32;
+
+    std::unordered_map<TagID, int64_t>                  tagVertices;
+    std::unordered_map<EdgeType, int64_t>               edgeCounts;
+    std::unordered_map<EdgeType, std::vector<int64_t>>  degreeHistograms;
+
+    static size_t degreeBucket(int64_t degree) {
+        DCHECK_GT(degree, 0);
+        size_t bucket = 0;
+        while (degree > 1 && bucket + 1 < kDegreeBuckets) {
+            degree >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    void addDegree(EdgeType edgeType, int64_t degree) {
+        auto& hist = degreeHistograms[edgeType];
+        if (hist.empty()) {
+            hist.resize(kDegreeBuckets, 0);
+        }
+        hist[degreeBucket(degree)]++;
+    }
+
+    void merge(const PartStats& other) {
+        for (auto& tag : other.tagVertices) {
+            tagVertices[tag.first] += tag.second;
+        }
+        for (auto& edge : other.edgeCounts) {
+            edgeCounts[edge.first] += edge.second;
+        }
+        for (auto& hist : other.degreeHistograms) {
+            auto& mine = degreeHistograms[hist.first];
+            if (mine.empty()) {
+                mine.resize(kDegreeBuckets, 0);
+            }
+            for (size_t i = 0; i < hist.second.size() && i < kDegreeBuckets; i++) {
+                mine[i] += hist.second[i];
+            }
+        }
+    }
+
+    bool empty() const {
+        return tagVertices.empty() && edgeCounts.empty() && degreeHistograms.empty();
+    }
+
+    /**
+     * The statistics persisted with the part, under NebulaKeyUtils::systemStatsKey().
+     * */
+    std::string encode() const;
+
+    static bool decode(folly::StringPiece raw, PartStats& stats);
+};
+
+
+/**
+ * Derive the statistics of the parts from a scan over the data keys.
+ *
+ * The keys must be fed in order. All versions of a key are adjacent, only the first one
+ * is counted. The out edges of a vertex are adjacent as well, so the degree is counted
+ * on the fly, and the memory used does not depend on the data size.
+ * */
+class PartStatsCollector final {
+public:
+    void collect(const folly::StringPiece& key) {
+        if (NebulaKeyUtils::isVertex(key)) {
+            if (!newKey(key)) {
+                return;
+            }
+            flushDegree();
+            stats_[NebulaKeyUtils::getPart(key)].tagVertices[NebulaKeyUtils::getTagId(key)]++;
+        } else if (NebulaKeyUtils::isEdge(key)) {
+            auto edgeType = NebulaKeyUtils::getEdgeType(key);
+            if (edgeType <= 0 || !newKey(key)) {
+                return;
+            }
+            auto partId = NebulaKeyUtils::getPart(key);
+            auto srcId = NebulaKeyUtils::getSrcId(key);
+            if (degree_ == 0 || partId != partId_ || srcId != srcId_ || edgeType != edgeType_) {
+                flushDegree();
+                partId_ = partId;
+                srcId_ = srcId;
+                edgeType_ = edgeType;
+            }
+            degree_++;
+            stats_[partId].edgeCounts[edgeType]++;
+        }
+    }
+
+    std::unordered_map<PartitionID, PartStats> finish() {
+        flushDegree();
+        lastKey_.clear();
+        return std::move(stats_);
+    }
+
+private:
+    bool newKey(const folly::StringPiece& key) {
+        auto keyWithNoVersion = NebulaKeyUtils::keyWithNoVersion(key);
+        if (keyWithNoVersion == lastKey_) {
+            return false;
+        }
+        lastKey_ = keyWithNoVersion.str();
+        return true;
+    }
+
+    void flushDegree() {
+        if (degree_ > 0) {
+            stats_[partId_].addDegree(edgeType_, degree_);
+            degree_ = 0;
+        }
+    }
+
+private:
+    std::unordered_map<PartitionID, PartStats>  stats_;
+    std::string                                 lastKey_;
+    // The out edges of the vertex being counted
+    PartitionID                                 partId_{0};
+    VertexID                                    srcId_{0};
+    EdgeType                                    edgeType_{0};
+    int64_t                                     degree_{0};
+};
+
+
+/**
+ * PartStatsManager holds the statistics of all the parts on this host.
+ *
+ * The edge and vertex counts are maintained incrementally by PartStatsListener when the
+ * writes are committed, on the leader and the followers alike, and persisted with the part.
+ * The puts are counted without reading before writing, so overwriting an existing edge counts
+ * it twice. The snapshot files ingested by a new replica are counted by a scan over the part
+ * once they are ingested. The full compaction re-derives the statistics of the space through PartStatsCollector, including the
+ * degree histograms, which could not be maintained incrementally, and fixes the drift.
+ * */
+class PartStatsManager final {
+public:
+    PartStatsManager() = default;
+
+    /**
+     * Add the deltas of a write committed on the part.
+     * */
+    void apply(GraphSpaceID spaceId, PartitionID partId, const PartStats& delta);
+
+    /**
+     * Replace the statistics of the parts, derived by a full compaction or loaded from the
+     * engine. The parts of the space on other engines are kept.
+     * */
+    void reset(GraphSpaceID spaceId, std::unordered_map<PartitionID, PartStats> stats);
+
+    void remove(GraphSpaceID spaceId, PartitionID partId);
+
+    /**
+     * The counts are clamped to zero unless raw, since the incremental ones could go below
+     * zero when the keys removed are not counted yet.
+     * */
+    PartStats get(GraphSpaceID spaceId, PartitionID partId, bool raw = false) const;
+
+private:
+    mutable folly::RWSpinLock                                                       lock_;
+    std::unordered_map<GraphSpaceID, std::unordered_map<PartitionID, PartStats>>    stats_;
+};
+
+
+/**
+ * Counts the vertices and the out edges put and removed by the writes committed on a part.
+ *
+ * The keys removed by a prefix or a range, e.g. all the tags of a vertex or all the versions
+ * of an edge, are read from the engine before they are removed, so only the existing ones are
+ * uncounted. The deltas are persisted in the same batch as the writes, and applied to the
+ * PartStatsManager once the batch is written.
+ * */
+class PartStatsListener final : public kvstore::PartCommitListener {
+public:
+    PartStatsListener(PartStatsManager* manager,
+                      GraphSpaceID spaceId,
+                      PartitionID partId,
+                      kvstore::KVEngine* engine)
+        : manager_(manager)
+        , spaceId_(spaceId)
+        , partId_(partId)
+        , engine_(engine) {
+        CHECK_NOTNULL(manager_);
+        CHECK_NOTNULL(engine_);
+    }
+
+    void onPut(folly::StringPiece key) override {
+        count(key, 1);
+    }
+
+    void onRemove(folly::StringPiece key) override {
+        count(key, -1);
+    }
+
+    void onRemovePrefix(folly::StringPiece prefix) override;
+
+    void onRemoveRange(folly::StringPiece start, folly::StringPiece end) override;
+
+    kvstore::ResultCode onCommit(kvstore::WriteBatch* batch) override;
+
+    void onCommitted(bool succeeded) override;
+
+    void onReset() override;
+
+    /**
+     * Derive the statistics of the part from a scan over its keys, since the keys of the
+     * files ingested are not called back. The statistics replace the ones counted so far.
+     * */
+    void onIngested() override;
+
+private:
+    void count(folly::StringPiece key, int64_t delta);
+
+    // Uncount the keys of the iterator, only the first version of a key is counted
+    void uncount(kvstore::KVIterator* iter);
+
+private:
+    PartStatsManager*       manager_{nullptr};
+    GraphSpaceID            spaceId_;
+    PartitionID             partId_;
+    kvstore::KVEngine*      engine_{nullptr};
+    // The deltas of the logs being committed
+    PartStats               delta_;
+};
+
+
+class PartStatsListenerFactory final : public kvstore::CommitListenerFactory {
+public:
+    explicit PartStatsListenerFactory(PartStatsManager* manager)
+        : manager_(manager) {}
+
+    /**
+     * Load the statistics persisted with the part into the manager, and watch the part.
+     * */
+    std::unique_ptr<kvstore::PartCommitListener> create(GraphSpaceID spaceId,
+                                                        PartitionID partId,
+                                                        kvstore::KVEngine* engine) override;
+
+private:
+    PartStatsManager* manager_{nullptr};
+};
+
+
+/**
+ * Merges the statistics derived by the filters of the full compactions of one space.
+ *
+ * A full compaction could be split into subcompactions running concurrently, each with its
+ * own filter seeing a key range, so the statistics of the space are replaced only when the
+ * last filter running is done. The out degree of a vertex whose edges span two key ranges is
+ * counted into two buckets.
+ * */
+class CompactionStatsMerger final {
+public:
+    CompactionStatsMerger(PartStatsManager* manager, GraphSpaceID spaceId)
+        : manager_(manager)
+        , spaceId_(spaceId) {
+        CHECK_NOTNULL(manager_);
+    }
+
+    void onFilterCreated();
+
+    void onFilterDone(std::unordered_map<PartitionID, PartStats> stats);
+
+private:
+    PartStatsManager*                           manager_{nullptr};
+    GraphSpaceID                                spaceId_;
+    std::mutex                                  lock_;
+    int32_t                                     running_{0};
+    std::unordered_map<PartitionID, PartStats>  stats_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_PARTSTATS_H_
@@ -21,4 +21,5 @@ DECLARE_int32(waiting_new_leader_interval_in_secs);
 
 DECLARE_int32(rebuild_index_batch_num);
 
+
 #endif  // STORAGE_STORAGEFLAGS_H_
@@ -46,7 +46,9 @@ std::unique_ptr<kvstore::KVStore> StorageServer::getStoreInstance() {
                                                 localHost_,
                                                 metaClient_.get());
     options.cffBuilder_ = std::make_unique<StorageCompactionFilterFactoryBuilder>(schemaMan_.get(),
-                                                                                  indexMan_.get());
+                                                                                  indexMan_.get(),
+                                                                                  partStats_.get());
+    options.listenerFactory_ = std::make_unique<PartStatsListenerFactory>(partStats_.get());
     if (FLAGS_store_type == "nebula") {
         auto nbStore = std::make_unique<kvstore::NebulaStore>(std::move(options),
                                                               ioThreadPool_,
@@ -123,6 +125,8 @@ bool StorageServer::start() {
     indexMan_ = meta::IndexManager::create();
     indexMan_->init(metaClient_.get());
 
+    partStats_ = std::make_unique<PartStatsManager>();
+
     LOG(INFO) << "Init kvstore";
     kvstore_ = getStoreInstance();
 
@@ -139,7 +143,8 @@ bool StorageServer::start() {
     auto handler = std::make_shared<StorageServiceHandler>(kvstore_.get(),
                                                            schemaMan_.get(),
                                                            indexMan_.get(),
-                                                           metaClient_.get());
+                                                           metaClient_.get(),
+                                                           partStats_.get());
     try {
         LOG(INFO) << "The storage deamon start on " << localHost_;
         tfServer_ = std::make_unique<apache::thrift::ThriftServer>();
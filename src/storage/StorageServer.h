@@ -15,6 +15,7 @@
 #include "meta/client/MetaClient.h"
 #include "meta/ClientBasedGflagsManager.h"
 #include "hdfs/HdfsHelper.h"
+#include "storage/PartStats.h"
 
 namespace nebula {
 
@@ -46,6 +47,8 @@ private:
     std::unique_ptr<apache::thrift::ThriftServer> tfServer_;
     std::unique_ptr<nebula::WebService> webSvc_;
     std::unique_ptr<meta::MetaClient> metaClient_;
+    // Declared before kvstore_, the compaction filters of the store refer to it
+    std::unique_ptr<PartStatsManager> partStats_;
     std::unique_ptr<kvstore::KVStore> kvstore_;
 
     std::unique_ptr<nebula::hdfs::HdfsHelper> hdfsHelper_;
@@ -13,6 +13,7 @@
 #include "storage/query/GetUUIDProcessor.h"
 #include "storage/query/ScanEdgeProcessor.h"
 #include "storage/query/ScanVertexProcessor.h"
+#include "storage/query/GetPartStatsProcessor.h"
 #include "storage/mutate/AddVerticesProcessor.h"
 #include "storage/mutate/AddEdgesProcessor.h"
 #include "storage/mutate/DeleteVerticesProcessor.h"
@@ -29,21 +30,43 @@
 #include "storage/admin/RebuildEdgeIndexProcessor.h"
 #include "storage/index/LookUpVertexIndexProcessor.h"
 #include "storage/index/LookUpEdgeIndexProcessor.h"
+#include "time/WallClock.h"
 
 #define RETURN_FUTURE(processor) \
     auto f = processor->getFuture(); \
     processor->process(req); \
     return f;
 
-DEFINE_int32(vertex_cache_num, 16 * 1000 * 1000, "Total keys inside the cache");
-DEFINE_int32(vertex_cache_bucket_exp, 4, "Total buckets number is 1 << cache_bucket_exp");
+DEFINE_int64(vertex_cache_bytes, 1024L * 1024 * 1024,
+             "Total bytes charged by the keys and values inside the cache");
+DEFINE_int32(vertex_cache_bucket_exp, 4, "Total shards number is 1 << cache_bucket_exp");
 DEFINE_int32(reader_handlers, 32, "Total reader handlers");
 
 namespace nebula {
 namespace storage {
 
+void StorageServiceHandler::reportCacheStats() {
+    auto now = time::WallClock::fastNowInSec();
+    auto last = lastCacheReport_.load();
+    if (now <= last || !lastCacheReport_.compare_exchange_strong(last, now)) {
+        return;
+    }
+    auto report = [] (uint64_t curr, uint64_t& reported, int32_t statId) {
+        // The counters are reset with the cache
+        if (curr > reported) {
+            stats::StatsManager::addValue(statId, curr - reported);
+        }
+        reported = curr;
+    };
+    report(vertexCache_.hits(), reportedHits_, cacheHitsStat_);
+    report(vertexCache_.misses(), reportedMisses_, cacheMissesStat_);
+    report(vertexCache_.evicts(), reportedEvicts_, cacheEvictsStat_);
+    report(vertexCache_.rejects(), reportedRejects_, cacheRejectsStat_);
+}
+
 folly::Future<cpp2::QueryResponse>
 StorageServiceHandler::future_getBound(const cpp2::GetNeighborsRequest& req) {
+    reportCacheStats();
     auto* processor = QueryBoundProcessor::instance(kvstore_,
                                                     schemaMan_,
                                                     &getBoundQpsStat_,
@@ -54,6 +77,7 @@ StorageServiceHandler::future_getBound(const cpp2::GetNeighborsRequest& req) {
 
 folly::Future<cpp2::QueryStatsResponse>
 StorageServiceHandler::future_boundStats(const cpp2::GetNeighborsRequest& req) {
+    reportCacheStats();
     auto* processor = QueryStatsProcessor::instance(kvstore_,
                                                     schemaMan_,
                                                     &boundStatsQpsStat_,
@@ -64,6 +88,7 @@ StorageServiceHandler::future_boundStats(const cpp2::GetNeighborsRequest& req) {
 
 folly::Future<cpp2::QueryResponse>
 StorageServiceHandler::future_getProps(const cpp2::VertexPropRequest& req) {
+    reportCacheStats();
     auto* processor = QueryVertexPropsProcessor::instance(kvstore_,
                                                           schemaMan_,
                                                           &vertexPropsQpsStat_,
@@ -147,6 +172,12 @@ StorageServiceHandler::future_scanVertex(const cpp2::ScanVertexRequest& req) {
     RETURN_FUTURE(processor);
 }
 
+folly::Future<cpp2::GetPartStatsResponse>
+StorageServiceHandler::future_getPartStats(const cpp2::GetPartStatsRequest& req) {
+    auto* processor = GetPartStatsProcessor::instance(kvstore_, partStats_);
+    RETURN_FUTURE(processor);
+}
+
 folly::Future<cpp2::AdminExecResp>
 StorageServiceHandler::future_transLeader(const cpp2::TransLeaderReq& req) {
     auto* processor = TransLeaderProcessor::instance(kvstore_);
@@ -249,6 +280,7 @@ StorageServiceHandler::future_rebuildEdgeIndex(const cpp2::RebuildIndexRequest&
 
 folly::Future<cpp2::LookUpVertexIndexResp>
 StorageServiceHandler::future_lookUpVertexIndex(const cpp2::LookUpIndexRequest& req) {
+    reportCacheStats();
     auto* processor = LookUpVertexIndexProcessor::instance(kvstore_,
                                                            schemaMan_,
                                                            indexMan_,
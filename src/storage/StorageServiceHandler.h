@@ -15,9 +15,10 @@
 #include "meta/IndexManager.h"
 #include "stats/StatsManager.h"
 #include "storage/CommonUtils.h"
+#include "storage/PartStats.h"
 #include "stats/Stats.h"
 
-DECLARE_int32(vertex_cache_num);
+DECLARE_int64(vertex_cache_bytes);
 DECLARE_int32(vertex_cache_bucket_exp);
 DECLARE_int32(reader_handlers);
 
@@ -31,12 +32,14 @@ public:
     StorageServiceHandler(kvstore::KVStore* kvstore,
                           meta::SchemaManager* schemaMan,
                           meta::IndexManager* indexMan,
-                          meta::MetaClient* client)
+                          meta::MetaClient* client,
+                          PartStatsManager* partStats = nullptr)
         : kvstore_(kvstore)
         , schemaMan_(schemaMan)
         , indexMan_(indexMan)
         , metaClient_(client)
-        , vertexCache_(FLAGS_vertex_cache_num, FLAGS_vertex_cache_bucket_exp)
+        , partStats_(partStats)
+        , vertexCache_(FLAGS_vertex_cache_bytes, FLAGS_vertex_cache_bucket_exp)
         , readerPool_(std::make_unique<folly::IOThreadPoolExecutor>(FLAGS_reader_handlers)) {
         getBoundQpsStat_ = stats::Stats("storage", "get_bound");
         boundStatsQpsStat_ = stats::Stats("storage", "bound_stats");
@@ -53,6 +56,10 @@ public:
         putKvQpsStat_ = stats::Stats("storage", "put_kv");
         lookupVerticesQpsStat_ = stats::Stats("storage", "lookup_vertices");
         lookupEdgesQpsStat_ = stats::Stats("storage", "lookup_edges");
+        cacheHitsStat_ = stats::StatsManager::registerStats("storage_vertex_cache_hits");
+        cacheMissesStat_ = stats::StatsManager::registerStats("storage_vertex_cache_misses");
+        cacheEvictsStat_ = stats::StatsManager::registerStats("storage_vertex_cache_evicts");
+        cacheRejectsStat_ = stats::StatsManager::registerStats("storage_vertex_cache_rejects");
     }
 
     folly::Future<cpp2::QueryResponse>
@@ -91,6 +98,9 @@ public:
     folly::Future<cpp2::ScanVertexResponse>
     future_scanVertex(const cpp2::ScanVertexRequest& req) override;
 
+    folly::Future<cpp2::GetPartStatsResponse>
+    future_getPartStats(const cpp2::GetPartStatsRequest& req) override;
+
     // Admin operations
     folly::Future<cpp2::AdminExecResp>
     future_transLeader(const cpp2::TransLeaderReq& req) override;
@@ -146,11 +156,16 @@ public:
     folly::Future<cpp2::LookUpEdgeIndexResp>
     future_lookUpEdgeIndex(const cpp2::LookUpIndexRequest& req) override;
 
+private:
+    // Add the deltas of the vertex cache counters to the stats, at most once a second
+    void reportCacheStats();
+
 private:
     kvstore::KVStore* kvstore_{nullptr};
     meta::SchemaManager* schemaMan_{nullptr};
     meta::IndexManager* indexMan_{nullptr};
     meta::MetaClient* metaClient_{nullptr};
+    PartStatsManager* partStats_{nullptr};
     VertexCache vertexCache_;
     std::unique_ptr<folly::IOThreadPoolExecutor> readerPool_;
 
@@ -169,6 +184,17 @@ private:
     stats::Stats putKvQpsStat_;
     stats::Stats lookupVerticesQpsStat_;
     stats::Stats lookupEdgesQpsStat_;
+
+    int32_t cacheHitsStat_;
+    int32_t cacheMissesStat_;
+    int32_t cacheEvictsStat_;
+    int32_t cacheRejectsStat_;
+    std::atomic<int64_t> lastCacheReport_{0};
+    // Only the reporting thread of each second touches them
+    uint64_t reportedHits_{0};
+    uint64_t reportedMisses_{0};
+    uint64_t reportedEvicts_{0};
+    uint64_t reportedRejects_{0};
 };
 
 }  // namespace storage
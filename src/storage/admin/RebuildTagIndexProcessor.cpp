@@ -34,7 +34,19 @@ void RebuildTagIndexProcessor::process(const cpp2::RebuildIndexRequest& req) {
         if (isOffline) {
             std::unique_ptr<kvstore::KVIterator> iter;
             auto prefix = NebulaKeyUtils::prefix(part);
-            auto ret = kvstore_->prefix(space, part, prefix, &iter);
+            // Rebuild from a consistent view of the part, and keep the
+            // full scan out of the block cache.
+            kvstore::ReadContext ctx;
+            ctx.fillCache_ = false;
+            auto ret = kvstore_->getSnapshot(space, part, &ctx.snapshot_);
+            if (ret != kvstore::ResultCode::SUCCEEDED &&
+                ret != kvstore::ResultCode::ERR_UNSUPPORTED) {
+                LOG(ERROR) << "Processing Part " << part << " Failed";
+                this->pushResultCode(to(ret), part);
+                onFinished();
+                return;
+            }
+            ret = kvstore_->prefix(space, part, prefix, &iter, ctx);
             if (ret != kvstore::ResultCode::SUCCEEDED) {
                 LOG(ERROR) << "Processing Part " << part << " Failed";
                 this->pushResultCode(to(ret), part);
@@ -8,6 +8,9 @@
 #include "storage/client/StorageClient.h"
 
 DEFINE_int32(storage_client_timeout_ms, 60 * 1000, "storage client timeout");
+DEFINE_bool(storage_client_follower_read, false,
+            "Spread the neighbors and vertex props queries across all the replicas, "
+            "the storage should enable_follower_read");
 
 namespace nebula {
 namespace storage {
@@ -35,6 +38,7 @@ folly::SemiFuture<StorageRpcResponse<cpp2::ExecResponse>> StorageClient::addVert
         GraphSpaceID space,
         std::vector<cpp2::Vertex> vertices,
         bool overwritable,
+        bool indexBlindWrite,
         folly::EventBase* evb) {
     auto status =
         clusterIdsToHosts(space, vertices, [](const cpp2::Vertex& v) { return v.get_id(); });
@@ -51,6 +55,7 @@ folly::SemiFuture<StorageRpcResponse<cpp2::ExecResponse>> StorageClient::addVert
         auto& req = requests[host];
         req.set_space_id(space);
         req.set_overwritable(overwritable);
+        req.set_index_blind_write(indexBlindWrite);
         req.set_parts(std::move(c.second));
     }
 
@@ -70,6 +75,7 @@ folly::SemiFuture<StorageRpcResponse<cpp2::ExecResponse>> StorageClient::addEdge
         GraphSpaceID space,
         std::vector<storage::cpp2::Edge> edges,
         bool overwritable,
+        bool indexBlindWrite,
         folly::EventBase* evb) {
     auto status =
         clusterIdsToHosts(space, edges, [](const cpp2::Edge& e) { return e.get_key().get_src(); });
@@ -86,6 +92,7 @@ folly::SemiFuture<StorageRpcResponse<cpp2::ExecResponse>> StorageClient::addEdge
         auto& req = requests[host];
         req.set_space_id(space);
         req.set_overwritable(overwritable);
+        req.set_index_blind_write(indexBlindWrite);
         req.set_parts(std::move(c.second));
     }
 
@@ -108,7 +115,10 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getNei
         std::string filter,
         std::vector<cpp2::PropDef> returnCols,
         folly::EventBase* evb) {
-    auto status = clusterIdsToHosts(space, vertices, [](const VertexID& v) { return v; });
+    auto status = clusterIdsToHosts(space,
+                                    vertices,
+                                    [](const VertexID& v) { return v; },
+                                    FLAGS_storage_client_follower_read);
 
     if (!status.ok()) {
         return folly::makeFuture<StorageRpcResponse<cpp2::QueryResponse>>(
@@ -139,6 +149,130 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getNei
 }
 
 
+struct StorageClient::NeighborsPageContext {
+    NeighborsPageContext(size_t hosts, NeighborsPageCallback cb, folly::EventBase* base)
+        : resp(hosts)
+        , pending(hosts)
+        , onPage(std::move(cb))
+        , evb(base) {}
+
+    std::mutex lock;
+    StorageRpcResponse<cpp2::QueryResponse> resp;
+    // The number of hosts whose last page has not arrived
+    size_t pending;
+    NeighborsPageCallback onPage;
+    folly::EventBase* evb;
+    folly::Promise<StorageRpcResponse<cpp2::QueryResponse>> promise;
+};
+
+
+folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getNeighborsPaged(
+        GraphSpaceID space,
+        const std::vector<VertexID> &vertices,
+        const std::vector<EdgeType> &edgeTypes,
+        std::string filter,
+        std::vector<cpp2::PropDef> returnCols,
+        int32_t pageSize,
+        NeighborsPageCallback onPage,
+        folly::EventBase* evb) {
+    auto status = clusterIdsToHosts(space,
+                                    vertices,
+                                    [](const VertexID& v) { return v; },
+                                    FLAGS_storage_client_follower_read);
+
+    if (!status.ok()) {
+        return folly::makeFuture<StorageRpcResponse<cpp2::QueryResponse>>(
+            std::runtime_error(status.status().toString()));
+    }
+
+    auto& clusters = status.value();
+    if (evb == nullptr) {
+        DCHECK(!!ioThreadPool_);
+        evb = ioThreadPool_->getEventBase();
+    }
+    auto ctx = std::make_shared<NeighborsPageContext>(clusters.size(), std::move(onPage), evb);
+    auto future = ctx->promise.getSemiFuture();
+    if (clusters.empty()) {
+        ctx->promise.setValue(std::move(ctx->resp));
+        return future;
+    }
+
+    for (auto& c : clusters) {
+        cpp2::GetNeighborsRequest req;
+        req.set_space_id(space);
+        req.set_parts(std::move(c.second));
+        req.set_edge_types(edgeTypes);
+        req.set_filter(filter);
+        req.set_return_columns(returnCols);
+        req.set_limit(pageSize);
+        getNeighborsPage(ctx, c.first, std::move(req), false);
+    }
+    return future;
+}
+
+
+void StorageClient::getNeighborsPage(std::shared_ptr<NeighborsPageContext> ctx,
+                                     HostAddr host,
+                                     cpp2::GetNeighborsRequest req,
+                                     bool failed) {
+    std::unordered_map<HostAddr, cpp2::GetNeighborsRequest> requests;
+    requests.emplace(host, req);
+    collectResponse(
+        ctx->evb, std::move(requests),
+        [](cpp2::StorageServiceAsyncClient* client, const cpp2::GetNeighborsRequest& r) {
+            return client->future_getBound(r); },
+        [](const std::pair<const PartitionID,
+                           std::vector<VertexID>>& p) {
+            return p.first;
+        })
+    .via(ctx->evb)
+    .thenValue([this, ctx, host, req = std::move(req), failed]
+               (StorageRpcResponse<cpp2::QueryResponse>&& resp) mutable {
+        {
+            std::lock_guard<std::mutex> g(ctx->lock);
+            for (auto& part : resp.failedParts()) {
+                ctx->resp.failedParts().emplace(part.first, part.second);
+            }
+            // A host is counted as failed once, whichever page fails
+            if (!resp.succeeded() && !failed) {
+                ctx->resp.markFailure();
+                failed = true;
+            }
+            for (auto& latency : resp.hostLatency()) {
+                ctx->resp.setLatency(std::get<0>(latency),
+                                     std::get<1>(latency),
+                                     std::get<2>(latency));
+            }
+        }
+
+        folly::Optional<std::string> cursor;
+        bool more = true;
+        for (auto& r : resp.responses()) {
+            if (r.__isset.next_cursor) {
+                cursor = r.next_cursor;
+            }
+            if (!ctx->onPage(std::move(r))) {
+                more = false;
+            }
+        }
+        if (more && cursor.hasValue()) {
+            req.set_cursor(std::move(cursor).value());
+            getNeighborsPage(std::move(ctx), host, std::move(req), failed);
+            return;
+        }
+
+        bool done = false;
+        {
+            std::lock_guard<std::mutex> g(ctx->lock);
+            done = --ctx->pending == 0;
+        }
+        if (done) {
+            ctx->promise.setValue(std::move(ctx->resp));
+        }
+    });
+}
+
+
 folly::SemiFuture<StorageRpcResponse<cpp2::QueryStatsResponse>> StorageClient::neighborStats(
         GraphSpaceID space,
         std::vector<VertexID> vertices,
@@ -146,7 +280,10 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryStatsResponse>> StorageClient::n
         std::string filter,
         std::vector<cpp2::PropDef> returnCols,
         folly::EventBase* evb) {
-    auto status = clusterIdsToHosts(space, vertices, [](const VertexID& v) { return v; });
+    auto status = clusterIdsToHosts(space,
+                                    vertices,
+                                    [](const VertexID& v) { return v; },
+                                    FLAGS_storage_client_follower_read);
 
     if (!status.ok()) {
         return folly::makeFuture<StorageRpcResponse<cpp2::QueryStatsResponse>>(
@@ -182,7 +319,10 @@ folly::SemiFuture<StorageRpcResponse<cpp2::QueryResponse>> StorageClient::getVer
         std::vector<VertexID> vertices,
         std::vector<cpp2::PropDef> returnCols,
         folly::EventBase* evb) {
-    auto status = clusterIdsToHosts(space, vertices, [](const VertexID& v) { return v; });
+    auto status = clusterIdsToHosts(space,
+                                    vertices,
+                                    [](const VertexID& v) { return v; },
+                                    FLAGS_storage_client_follower_read);
 
     if (!status.ok()) {
         return folly::makeFuture<StorageRpcResponse<cpp2::QueryResponse>>(
@@ -575,5 +715,29 @@ StorageClient::lookUpEdgeIndex(GraphSpaceID space,
                            });
 }
 
+folly::SemiFuture<StorageRpcResponse<storage::cpp2::GetPartStatsResponse>>
+StorageClient::getPartStats(GraphSpaceID space, folly::EventBase *evb) {
+    auto status = getHostParts(space);
+    if (!status.ok()) {
+        return folly::makeFuture<StorageRpcResponse<storage::cpp2::GetPartStatsResponse>>(
+            std::runtime_error(status.status().toString()));
+    }
+    auto& clusters = status.value();
+    std::unordered_map<HostAddr, cpp2::GetPartStatsRequest> requests;
+    for (auto& c : clusters) {
+        auto& host = c.first;
+        auto& req = requests[host];
+        req.set_space_id(space);
+        req.set_parts(std::move(c.second));
+    }
+    return collectResponse(evb, std::move(requests),
+                           [](cpp2::StorageServiceAsyncClient* client,
+                              const cpp2::GetPartStatsRequest& r) {
+                               return client->future_getPartStats(r); },
+                           [](const PartitionID& part) {
+                               return part;
+                           });
+}
+
 }   // namespace storage
 }   // namespace nebula
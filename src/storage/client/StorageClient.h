@@ -109,12 +109,14 @@ public:
         GraphSpaceID space,
         std::vector<storage::cpp2::Vertex> vertices,
         bool overwritable,
+        bool indexBlindWrite = false,
         folly::EventBase* evb = nullptr);
 
     folly::SemiFuture<StorageRpcResponse<storage::cpp2::ExecResponse>> addEdges(
         GraphSpaceID space,
         std::vector<storage::cpp2::Edge> edges,
         bool overwritable,
+        bool indexBlindWrite = false,
         folly::EventBase* evb = nullptr);
 
     folly::SemiFuture<StorageRpcResponse<storage::cpp2::QueryResponse>> getNeighbors(
@@ -125,6 +127,27 @@ public:
         std::vector<storage::cpp2::PropDef> returnCols,
         folly::EventBase* evb = nullptr);
 
+    // Return false to stop asking the host of the page for more pages
+    using NeighborsPageCallback = std::function<bool(storage::cpp2::QueryResponse&&)>;
+
+    /**
+     * Get the neighbors page by page. Each host returns the edges of at most pageSize vertices
+     * at a time, and is asked for the next page as soon as the previous one arrives.
+     * onPage is invoked on every page in the IO threads, possibly for several hosts at the
+     * same time. The returned response only carries the failures and the latencies,
+     * and it is fulfilled after the last page of all hosts, or once all hosts are stopped
+     * by onPage.
+     */
+    folly::SemiFuture<StorageRpcResponse<storage::cpp2::QueryResponse>> getNeighborsPaged(
+        GraphSpaceID space,
+        const std::vector<VertexID> &vertices,
+        const std::vector<EdgeType> &edgeTypes,
+        std::string filter,
+        std::vector<storage::cpp2::PropDef> returnCols,
+        int32_t pageSize,
+        NeighborsPageCallback onPage,
+        folly::EventBase* evb = nullptr);
+
     folly::SemiFuture<StorageRpcResponse<storage::cpp2::QueryStatsResponse>> neighborStats(
         GraphSpaceID space,
         std::vector<VertexID> vertices,
@@ -192,6 +215,14 @@ public:
             std::vector<std::string> returnCols,
             folly::EventBase *evb = nullptr);
 
+    /**
+     * Get the approximate statistics of all the parts of the space from their leaders,
+     * which are held in memory by storage, so it does not scan the data.
+     * */
+    folly::SemiFuture<StorageRpcResponse<storage::cpp2::GetPartStatsResponse>> getPartStats(
+            GraphSpaceID space,
+            folly::EventBase *evb = nullptr);
+
 protected:
     // Calculate the partition id for the given vertex id
     StatusOr<PartitionID> partId(GraphSpaceID spaceId, int64_t id) const;
@@ -215,6 +246,11 @@ protected:
         }
     }
 
+    // Choose a random replica of the part, for the reads which the followers could serve
+    const HostAddr replica(const PartMeta& partMeta) const {
+        return partMeta.peers_[folly::Random::rand32(partMeta.peers_.size())];
+    }
+
     void updateLeader(GraphSpaceID spaceId, PartitionID partId, const HostAddr& leader) {
         LOG(INFO) << "Update leader for " << spaceId << ", " << partId << " to " << leader;
         folly::RWSpinLock::WriteHolder wh(leadersLock_);
@@ -229,6 +265,14 @@ protected:
         }
     }
 
+    struct NeighborsPageContext;
+
+    // Get one page of the neighbors from the host, and go on with the next page
+    void getNeighborsPage(std::shared_ptr<NeighborsPageContext> ctx,
+                          HostAddr host,
+                          cpp2::GetNeighborsRequest req,
+                          bool failed);
+
     template<class Request,
              class RemoteFunc,
              class GetPartIDFunc,
@@ -259,18 +303,24 @@ protected:
     // The method returns a map
     //  host_addr (A host, but in most case, the leader will be chosen)
     //      => (partition -> [ids that belong to the shard])
+    // If anyReplica is true, a random replica is chosen for each part instead of the leader
     template<class Container, class GetIdFunc>
     StatusOr<std::unordered_map<HostAddr,
                        std::unordered_map<PartitionID,
                                           std::vector<typename Container::value_type>
                                          >
                       >>
-    clusterIdsToHosts(GraphSpaceID spaceId, Container ids, GetIdFunc f) const {
+    clusterIdsToHosts(GraphSpaceID spaceId,
+                      Container ids,
+                      GetIdFunc f,
+                      bool anyReplica = false) const {
         std::unordered_map<HostAddr,
                            std::unordered_map<PartitionID,
                                               std::vector<typename Container::value_type>
                                              >
                           > clusters;
+        // All the ids of one part go to the same replica
+        std::unordered_map<PartitionID, HostAddr> replicas;
         for (auto& id : ids) {
             auto status = partId(spaceId, f(id));
             if (!status.ok()) {
@@ -285,6 +335,14 @@ protected:
 
             auto partMeta = metaStatus.value();
             CHECK_GT(partMeta.peers_.size(), 0U);
+            if (anyReplica) {
+                auto it = replicas.find(part);
+                if (it == replicas.end()) {
+                    it = replicas.emplace(part, this->replica(partMeta)).first;
+                }
+                clusters[it->second][part].emplace_back(std::move(id));
+                continue;
+            }
             const auto leader = this->leader(partMeta);
             clusters[leader][part].emplace_back(std::move(id));
         }
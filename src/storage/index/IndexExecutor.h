@@ -58,6 +58,11 @@ private:
 
     cpp2::ErrorCode checkReturnColumns(const std::vector<std::string> &cols);
 
+    /**
+     * Details Build the [start, end) keys of the range scan under the index prefix.
+     **/
+    std::pair<std::string, std::string> rangeBoundKeys(const std::string& prefix);
+
     kvstore::ResultCode getDataRow(PartitionID partId,
                                    const folly::StringPiece& key);
 
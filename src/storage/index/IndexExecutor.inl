@@ -119,10 +119,21 @@ kvstore::ResultCode IndexExecutor<RESP>::executeExecutionPlan(PartitionID part)
                         .append(prefix_);
     std::unique_ptr<kvstore::KVIterator> iter;
     std::vector<std::string> keys;
-    auto ret = this->kvstore_->prefix(spaceId_,
-                                      part,
-                                      prefix,
-                                      &iter);
+    kvstore::ResultCode ret;
+    /**
+     * The range interface holds the references of start and end in iter,
+     * so they must outlive the iterator.
+     */
+    std::string start;
+    std::string end;
+    if (rangeScan_) {
+        std::tie(start, end) = rangeBoundKeys(prefix);
+    }
+    if (rangeScan_ && !end.empty()) {
+        ret = this->kvstore_->range(spaceId_, part, start, end, &iter);
+    } else {
+        ret = this->kvstore_->prefix(spaceId_, part, prefix, &iter);
+    }
     if (ret != nebula::kvstore::SUCCEEDED) {
         return ret;
     }
@@ -148,6 +159,28 @@ kvstore::ResultCode IndexExecutor<RESP>::executeExecutionPlan(PartitionID part)
     return ret;
 }
 
+template <typename RESP>
+std::pair<std::string, std::string>
+IndexExecutor<RESP>::rangeBoundKeys(const std::string& prefix) {
+    std::string start = prefix;
+    if (lowerBound_.hasValue()) {
+        start.append(lowerBound_->value);
+        if (!lowerBound_->inclusive) {
+            start = kvstore::prefixSuccessor(std::move(start));
+        }
+    }
+    std::string end = prefix;
+    if (upperBound_.hasValue()) {
+        end.append(upperBound_->value);
+        if (upperBound_->inclusive) {
+            end = kvstore::prefixSuccessor(std::move(end));
+        }
+    } else {
+        end = kvstore::prefixSuccessor(std::move(end));
+    }
+    return std::make_pair(std::move(start), std::move(end));
+}
+
 template<typename RESP>
 kvstore::ResultCode IndexExecutor<RESP>::getDataRow(PartitionID partId,
                                                     const folly::StringPiece& key) {
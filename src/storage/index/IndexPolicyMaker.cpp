@@ -45,30 +45,109 @@ void IndexPolicyMaker::buildPolicy() {
     prefix_.reserve(256);
     decltype(operatorList_.size()) hintNum = 0;
     bool hasStr = false;
+    bool hasDouble = false;
     for (auto& col : index_->get_fields()) {
         auto it = std::find_if(operatorList_.begin(), operatorList_.end(),
                                [&col] (const auto& tup) {
-                                   return col.get_name() == std::get<0>(tup);;
+                                   return col.get_name() == std::get<0>(tup) &&
+                                          std::get<2>(tup) == RelationalExpression::Operator::EQ;
                                });
         if (it != operatorList_.end()) {
-            if (std::get<2>(*it) == RelationalExpression::Operator::EQ) {
-                /**
-                 * TODO sky : drop the sub-exp from root expression tree.
-                 */
-                hintNum++;
-                auto v = std::get<1>(*it);
-                hasStr = (v.which() == VAR_STR);
-                prefix_.append(NebulaKeyUtils::encodeVariant(v));
-            } else {
+            /**
+             * TODO sky : drop the sub-exp from root expression tree.
+             */
+            hintNum++;
+            auto v = std::get<1>(*it);
+            hasStr = hasStr || (v.which() == VAR_STR);
+            prefix_.append(NebulaKeyUtils::encodeVariant(v));
+            continue;
+        }
+        /**
+         * The first column without equality condition, try to bound it by range.
+         */
+        auto rangeNum = buildRangeBounds(col);
+        if (rangeNum > 0) {
+            rangeScan_ = true;
+            hintNum += rangeNum;
+            auto type = col.get_type().get_type();
+            hasDouble = (type == nebula::cpp2::SupportedType::DOUBLE ||
+                         type == nebula::cpp2::SupportedType::FLOAT);
+        }
+        break;
+    }
+    /**
+     * The double encoding is not precise for all values, so keep the filter for it.
+     */
+    if (optimizedPolicy_ && hintNum == operatorList_.size() && !hasStr && !hasDouble) {
+        requiredFilter_ = false;
+    }
+}
+
+size_t IndexPolicyMaker::buildRangeBounds(const nebula::cpp2::ColumnDef& col) {
+    using nebula::cpp2::SupportedType;
+    auto type = col.get_type().get_type();
+    size_t num = 0;
+    for (const auto& item : operatorList_) {
+        if (col.get_name() != std::get<0>(item)) {
+            continue;
+        }
+        auto op = std::get<2>(item);
+        if (op != RelationalExpression::Operator::GT &&
+            op != RelationalExpression::Operator::GE &&
+            op != RelationalExpression::Operator::LT &&
+            op != RelationalExpression::Operator::LE) {
+            continue;
+        }
+        /**
+         * The bound value must be encoded as same as the index column.
+         */
+        auto v = std::get<1>(item);
+        switch (type) {
+            case SupportedType::INT:
+            case SupportedType::TIMESTAMP:
+                if (v.which() != VAR_INT64) {
+                    continue;
+                }
                 break;
+            case SupportedType::FLOAT:
+            case SupportedType::DOUBLE:
+                if (v.which() == VAR_INT64) {
+                    v = static_cast<double>(boost::get<int64_t>(v));
+                } else if (v.which() != VAR_DOUBLE) {
+                    continue;
+                }
+                break;
+            case SupportedType::BOOL:
+                if (v.which() != VAR_BOOL) {
+                    continue;
+                }
+                break;
+            default:
+                return 0;
+        }
+        RangeBound bound;
+        bound.value = NebulaKeyUtils::encodeVariant(v);
+        bound.inclusive = (op == RelationalExpression::Operator::GE ||
+                           op == RelationalExpression::Operator::LE);
+        if (op == RelationalExpression::Operator::GT ||
+            op == RelationalExpression::Operator::GE) {
+            // Keep the tighter lower bound
+            if (!lowerBound_.hasValue() ||
+                bound.value > lowerBound_->value ||
+                (bound.value == lowerBound_->value && !bound.inclusive)) {
+                lowerBound_ = std::move(bound);
             }
         } else {
-            break;
+            // Keep the tighter upper bound
+            if (!upperBound_.hasValue() ||
+                bound.value < upperBound_->value ||
+                (bound.value == upperBound_->value && !bound.inclusive)) {
+                upperBound_ = std::move(bound);
+            }
         }
+        num++;
     }
-    if (optimizedPolicy_ && hintNum == operatorList_.size() && !hasStr) {
-        requiredFilter_ = false;
-    }
+    return num;
 }
 
 cpp2::ErrorCode IndexPolicyMaker::traversalExpression(const Expression *expr) {
@@ -106,6 +185,7 @@ cpp2::ErrorCode IndexPolicyMaker::traversalExpression(const Expression *expr) {
             std::string prop;
             VariantType v;
             auto* rExpr = dynamic_cast<const RelationalExpression*>(expr);
+            auto op = rExpr->op();
             auto* left = rExpr->left();
             auto* right = rExpr->right();
             if (left->kind() == nebula::Expression::kAliasProp) {
@@ -126,11 +206,13 @@ cpp2::ErrorCode IndexPolicyMaker::traversalExpression(const Expression *expr) {
                 v = value.value();
                 auto* aExpr = dynamic_cast<const AliasPropertyExpression*>(right);
                 prop = *aExpr->prop();
+                // The constant is on the left, so mirror the operator as if the prop were
+                op = mirror(op);
             } else {
                 optimizedPolicy_ = false;
                 break;
             }
-            operatorList_.emplace_back(std::make_tuple(std::move(prop), std::move(v), rExpr->op()));
+            operatorList_.emplace_back(std::make_tuple(std::move(prop), std::move(v), op));
             break;
         }
         case nebula::Expression::kFunctionCall : {
@@ -144,6 +226,23 @@ cpp2::ErrorCode IndexPolicyMaker::traversalExpression(const Expression *expr) {
     return code;
 }
 
+// static
+RelationalExpression::Operator
+IndexPolicyMaker::mirror(RelationalExpression::Operator op) {
+    switch (op) {
+        case RelationalExpression::Operator::LT:
+            return RelationalExpression::Operator::GT;
+        case RelationalExpression::Operator::LE:
+            return RelationalExpression::Operator::GE;
+        case RelationalExpression::Operator::GT:
+            return RelationalExpression::Operator::LT;
+        case RelationalExpression::Operator::GE:
+            return RelationalExpression::Operator::LE;
+        default:
+            return op;
+    }
+}
+
 bool IndexPolicyMaker::exprEval(Getters &getters) {
     if (exp_ != nullptr) {
         auto value = exp_->eval(getters);
@@ -7,6 +7,7 @@
 #ifndef STORAGE_INDEXPOLICYMAKER_H
 #define STORAGE_INDEXPOLICYMAKER_H
 #include "base/Base.h"
+#include <folly/Optional.h>
 #include "meta/SchemaManager.h"
 #include "meta/IndexManager.h"
 #include "storage/CommonUtils.h"
@@ -22,6 +23,15 @@ namespace storage {
  */
 using OperatorItem = std::tuple<std::string, VariantType, RelationalExpression::Operator>;
 
+/**
+ * One side of a range scan on the first index column after the equality prefix.
+ * value is the encoded column value (NebulaKeyUtils::encodeVariant).
+ */
+struct RangeBound {
+    std::string value;
+    bool        inclusive{true};
+};
+
 class IndexPolicyMaker {
 public:
     virtual ~IndexPolicyMaker() = default;
@@ -64,6 +74,18 @@ private:
 
     cpp2::ErrorCode traversalExpression(const Expression *expr);
 
+    /**
+     * Details Collect the range bounds on column col, return the number of used operators.
+     *         Only fixed-length columns could be scanned by range, because the string
+     *         column values are not terminated inside the index key.
+     */
+    size_t buildRangeBounds(const nebula::cpp2::ColumnDef& col);
+
+    /**
+     * Details The operator of "value op prop" as "prop op' value", e.g. LT for "30 > prop".
+     */
+    static RelationalExpression::Operator mirror(RelationalExpression::Operator op);
+
 protected:
     meta::SchemaManager*                     schemaMan_{nullptr};
     meta::IndexManager*                      indexMan_{nullptr};
@@ -74,6 +96,9 @@ protected:
     bool                                     optimizedPolicy_{true};
     bool                                     requiredFilter_{true};
     std::vector<OperatorItem>                operatorList_;
+    bool                                     rangeScan_{false};
+    folly::Optional<RangeBound>              lowerBound_;
+    folly::Optional<RangeBound>              upperBound_;
 };
 }  // namespace storage
 }  // namespace nebula
@@ -14,6 +14,7 @@ namespace storage {
 
 void AddEdgesProcessor::process(const cpp2::AddEdgesRequest& req) {
     spaceId_ = req.get_space_id();
+    indexBlindWrite_ = req.get_index_blind_write();
     auto version =
         std::numeric_limits<int64_t>::max() - time::WallClock::fastNowInMicroSec();
     // Switch version to big-endian, make sure the key is in ordered.
@@ -85,37 +86,44 @@ std::string AddEdgesProcessor::addEdges(int64_t version, PartitionID partId,
         auto key = NebulaKeyUtils::edgeKey(partId, srcId, type, rank, dstId, version);
         newEdges[key] = std::move(prop);
     });
+    std::unordered_map<EdgeType, std::vector<std::shared_ptr<nebula::cpp2::IndexItem>>>
+        edgeIndexes;
+    for (auto& index : indexes_) {
+        edgeIndexes[index->get_schema_id().get_edge_type()].emplace_back(index);
+    }
     for (auto& e : newEdges) {
-        std::string val;
-        std::unique_ptr<RowReader> nReader;
         auto edgeType = NebulaKeyUtils::getEdgeType(e.first);
-        for (auto& index : indexes_) {
-            if (edgeType == index->get_schema_id().get_edge_type()) {
-                /*
-                 * step 1 , Delete old version index if exists.
-                 */
-                if (val.empty()) {
-                    val = findObsoleteIndex(partId, e.first);
-                }
+        auto it = edgeIndexes.find(edgeType);
+        if (it != edgeIndexes.end()) {
+            /*
+             * step 1 , Delete old version index if exists.
+             * The old row is read and decoded once for all the indexes of the edge type.
+             */
+            std::string val;
+            std::unique_ptr<RowReader> oReader;
+            if (!indexBlindWrite_) {
+                val = findObsoleteIndex(partId, e.first);
                 if (!val.empty()) {
-                    auto reader = RowReader::getEdgePropReader(this->schemaMan_,
-                                                               val,
-                                                               spaceId_,
-                                                               edgeType);
-                    auto oi = indexKey(partId, reader.get(), e.first, index);
+                    oReader = RowReader::getEdgePropReader(this->schemaMan_,
+                                                           val,
+                                                           spaceId_,
+                                                           edgeType);
+                }
+            }
+            /*
+             * step 2 , Insert new edge index
+             */
+            auto nReader = RowReader::getEdgePropReader(this->schemaMan_,
+                                                        e.second,
+                                                        spaceId_,
+                                                        edgeType);
+            for (auto& index : it->second) {
+                if (oReader != nullptr) {
+                    auto oi = indexKey(partId, oReader.get(), e.first, index);
                     if (!oi.empty()) {
                         batchHolder->remove(std::move(oi));
                     }
                 }
-                /*
-                 * step 2 , Insert new edge index
-                 */
-                if (nReader == nullptr) {
-                    nReader = RowReader::getEdgePropReader(this->schemaMan_,
-                                                           e.second,
-                                                           spaceId_,
-                                                           edgeType);
-                }
                 auto ni = indexKey(partId, nReader.get(), e.first, index);
                 batchHolder->put(std::move(ni), "");
             }
@@ -49,6 +49,8 @@ private:
     GraphSpaceID                                          spaceId_;
     meta::IndexManager*                                   indexMan_{nullptr};
     std::vector<std::shared_ptr<nebula::cpp2::IndexItem>> indexes_;
+    // The old rows are not read for the index entries, see AddEdgesRequest
+    bool                                                  indexBlindWrite_{false};
 };
 
 }  // namespace storage
@@ -23,6 +23,7 @@ void AddVerticesProcessor::process(const cpp2::AddVerticesRequest& req) {
 
     const auto& partVertices = req.get_parts();
     spaceId_ = req.get_space_id();
+    indexBlindWrite_ = req.get_index_blind_write();
     callingNum_ = partVertices.size();
     auto iRet = indexMan_->getTagIndexes(spaceId_);
     if (iRet.ok()) {
@@ -101,38 +102,42 @@ std::string AddVerticesProcessor::addVertices(int64_t version, PartitionID partI
         });
     });
 
+    std::unordered_map<TagID, std::vector<std::shared_ptr<nebula::cpp2::IndexItem>>> tagIndexes;
+    for (auto& index : indexes_) {
+        tagIndexes[index->get_schema_id().get_tag_id()].emplace_back(index);
+    }
     for (auto& v : newVertices) {
-        std::string val;
-        std::unique_ptr<RowReader> nReader;
         auto tagId = NebulaKeyUtils::getTagId(v.first);
         auto vId = NebulaKeyUtils::getVertexId(v.first);
-        for (auto& index : indexes_) {
-            if (tagId == index->get_schema_id().get_tag_id()) {
-                /*
-                 * step 1 , Delete old version index if exists.
-                 */
-                if (val.empty()) {
-                    val = findObsoleteIndex(partId, vId, tagId);
+        auto it = tagIndexes.find(tagId);
+        if (it != tagIndexes.end()) {
+            /*
+             * step 1 , Delete old version index if exists.
+             */
+            std::unique_ptr<RowReader> oReader;
+            if (!indexBlindWrite_) {
+                auto oldRow = findObsoleteRow(partId, vId, tagId);
+                if (!oldRow.empty()) {
+                    oReader = RowReader::getTagPropReader(this->schemaMan_,
+                                                          oldRow,
+                                                          spaceId_,
+                                                          tagId);
                 }
-                if (!val.empty()) {
-                    auto reader = RowReader::getTagPropReader(this->schemaMan_,
-                                                              val,
-                                                              spaceId_,
-                                                              tagId);
-                    auto oi = indexKey(partId, vId, reader.get(), index);
+            }
+            /*
+             * step 2 , Insert new vertex index
+             */
+            auto nReader = RowReader::getTagPropReader(this->schemaMan_,
+                                                       v.second,
+                                                       spaceId_,
+                                                       tagId);
+            for (auto& index : it->second) {
+                if (oReader != nullptr) {
+                    auto oi = indexKey(partId, vId, oReader.get(), index);
                     if (!oi.empty()) {
                         batchHolder->remove(std::move(oi));
                     }
                 }
-                /*
-                 * step 2 , Insert new vertex index
-                 */
-                if (nReader == nullptr) {
-                    nReader = RowReader::getTagPropReader(this->schemaMan_,
-                                                          v.second,
-                                                          spaceId_,
-                                                          tagId);
-                }
                 auto ni = indexKey(partId, vId, nReader.get(), index);
                 batchHolder->put(std::move(ni), "");
             }
@@ -147,9 +152,9 @@ std::string AddVerticesProcessor::addVertices(int64_t version, PartitionID partI
     return encodeBatchValue(batchHolder->getBatch());
 }
 
-std::string AddVerticesProcessor::findObsoleteIndex(PartitionID partId,
-                                                    VertexID vId,
-                                                    TagID tagId) {
+std::string AddVerticesProcessor::findObsoleteRow(PartitionID partId,
+                                                  VertexID vId,
+                                                  TagID tagId) {
     auto prefix = NebulaKeyUtils::vertexPrefix(partId, vId, tagId);
     std::unique_ptr<kvstore::KVIterator> iter;
     auto ret = kvstore_->prefix(this->spaceId_, partId, prefix, &iter);
@@ -158,6 +163,7 @@ std::string AddVerticesProcessor::findObsoleteIndex(PartitionID partId,
                    << ", spaceId " << this->spaceId_;
         return "";
     }
+    // The latest version comes first
     if (iter && iter->valid()) {
         return iter->val().str();
     }
@@ -8,7 +8,6 @@
 #define STORAGE_MUTATE_ADDVERTICESPROCESSOR_H_
 
 #include "base/Base.h"
-#include "base/ConcurrentLRUCache.h"
 #include "storage/BaseProcessor.h"
 #include "storage/CommonUtils.h"
 #include "kvstore/LogEncoder.h"
@@ -42,9 +41,11 @@ private:
     std::string addVertices(int64_t version, PartitionID partId,
                             const std::vector<cpp2::Vertex>& vertices);
 
-    std::string findObsoleteIndex(PartitionID partId,
-                                  VertexID vId,
-                                  TagID tagId);
+    /**
+     * Read the latest row of the tag of the vertex, or "" if none. Only the keys of the tag
+     * are sought, rather than all the tags and edges of the vertex.
+     * */
+    std::string findObsoleteRow(PartitionID partId, VertexID vId, TagID tagId);
 
     std::string indexKey(PartitionID partId,
                          VertexID vId,
@@ -56,6 +57,8 @@ private:
     meta::IndexManager*                                   indexMan_{nullptr};
     VertexCache*                                          vertexCache_{nullptr};
     std::vector<std::shared_ptr<nebula::cpp2::IndexItem>> indexes_;
+    // The old rows are not read for the index entries, see AddVerticesRequest
+    bool                                                  indexBlindWrite_{false};
 };
 
 }  // namespace storage
@@ -35,7 +35,7 @@ private:
                              cpp2::UpdateResponse>(kvstore, schemaMan, stats)
         , indexMan_(indexMan) {}
 
-    kvstore::ResultCode processVertex(PartitionID, VertexID) override {
+    kvstore::ResultCode processVertex(PartitionID, VertexID, size_t) override {
         LOG(FATAL) << "Unimplement!";
         return kvstore::ResultCode::SUCCEEDED;
     }
@@ -0,0 +1,698 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "storage/query/EdgeFilter.h"
+#include "base/NebulaKeyUtils.h"
+
+namespace nebula {
+namespace storage {
+
+constexpr uint8_t EdgeFilter::kFalse;
+constexpr uint8_t EdgeFilter::kTrue;
+constexpr uint8_t EdgeFilter::kError;
+
+namespace {
+
+/**
+ * The kernels below are plain loops over contiguous columns without branches
+ * in the loop body, so that the compiler could vectorize them.
+ * */
+template <typename T, typename Cmp>
+void compareWith(const std::vector<T>& l,
+                 const std::vector<T>& r,
+                 std::vector<uint8_t>& out,
+                 Cmp cmp) {
+    auto n = out.size();
+    for (size_t i = 0; i < n; i++) {
+        out[i] = cmp(l[i], r[i]) ? 1 : 0;
+    }
+}
+
+template <typename T>
+void compareColumns(RelationalExpression::Operator op,
+                    const std::vector<T>& l,
+                    const std::vector<T>& r,
+                    std::vector<uint8_t>& out,
+                    bool approximate) {
+    UNUSED(approximate);
+    switch (op) {
+        case RelationalExpression::LT:
+            compareWith(l, r, out, [] (const T& a, const T& b) { return a < b; });
+            break;
+        case RelationalExpression::LE:
+            compareWith(l, r, out, [] (const T& a, const T& b) { return a <= b; });
+            break;
+        case RelationalExpression::GT:
+            compareWith(l, r, out, [] (const T& a, const T& b) { return a > b; });
+            break;
+        case RelationalExpression::GE:
+            compareWith(l, r, out, [] (const T& a, const T& b) { return a >= b; });
+            break;
+        case RelationalExpression::EQ:
+            compareWith(l, r, out, [] (const T& a, const T& b) { return a == b; });
+            break;
+        case RelationalExpression::NE:
+            compareWith(l, r, out, [] (const T& a, const T& b) { return a != b; });
+            break;
+    }
+}
+
+void compareColumns(RelationalExpression::Operator op,
+                    const std::vector<double>& l,
+                    const std::vector<double>& r,
+                    std::vector<uint8_t>& out,
+                    bool approximate) {
+    // The same as RelationalExpression, doubles are compared approximately for equality
+    if (approximate && op == RelationalExpression::EQ) {
+        compareWith(l, r, out, [] (double a, double b) {
+            return Expression::almostEqual(a, b);
+        });
+    } else if (approximate && op == RelationalExpression::NE) {
+        compareWith(l, r, out, [] (double a, double b) {
+            return !Expression::almostEqual(a, b);
+        });
+    } else {
+        compareColumns<double>(op, l, r, out, false);
+    }
+}
+
+}  // namespace
+
+
+EdgeFilter::Context::Context(const EdgeFilter* filter, FilterContext* fcontext) {
+    getters_.getAliasProp = [this, filter] (const std::string& edgeName,
+                                            const std::string& prop) -> OptVariantType {
+        auto edgeFound = filter->edgeMap_->find(edgeName);
+        if (edgeFound == filter->edgeMap_->end()) {
+            return Status::Error(
+                    "Edge `%s' not found when call getters.", edgeName.c_str());
+        }
+        if (std::abs(filter->edgeType_) != edgeFound->second) {
+            return Status::Error("Ignore this edge");
+        }
+
+        if (prop == _SRC) {
+            return NebulaKeyUtils::getSrcId(edge_->key);
+        } else if (prop == _DST) {
+            return NebulaKeyUtils::getDstId(edge_->key);
+        } else if (prop == _RANK) {
+            return NebulaKeyUtils::getRank(edge_->key);
+        } else if (prop == _TYPE) {
+            return static_cast<int64_t>(NebulaKeyUtils::getEdgeType(edge_->key));
+        }
+
+        if (edge_->reader == nullptr) {
+            return Status::Error("Invalid Prop");
+        }
+        auto res = RowReader::getPropByName(edge_->reader, prop);
+        if (!ok(res)) {
+            return Status::Error("Invalid Prop");
+        }
+        return value(std::move(res));
+    };
+    getters_.getEdgeRank = [this] () -> VariantType {
+        return edge_->rank;
+    };
+    getters_.getEdgeDstId = [this, filter] (const std::string& edgeName) -> OptVariantType {
+        auto edgeFound = filter->edgeMap_->find(edgeName);
+        if (edgeFound == filter->edgeMap_->end()) {
+            return Status::Error(
+                    "Edge `%s' not found when call getters.", edgeName.c_str());
+        }
+        if (std::abs(filter->edgeType_) != edgeFound->second) {
+            return Status::Error("Ignore this edge");
+        }
+        return edge_->dstId;
+    };
+    getters_.getSrcTagProp = [fcontext] (const std::string& tag,
+                                         const std::string& prop) -> OptVariantType {
+        auto it = fcontext->tagFilters_.find(std::make_pair(tag, prop));
+        if (it == fcontext->tagFilters_.end()) {
+            return Status::Error("Invalid Tag Filter");
+        }
+        VLOG(1) << "Hit srcProp filter for tag " << tag << ", prop "
+                << prop << ", value " << it->second;
+        return it->second;
+    };
+}
+
+
+// static
+std::unique_ptr<EdgeFilter> EdgeFilter::compile(
+        const Expression* exp,
+        EdgeType edgeType,
+        std::shared_ptr<const meta::SchemaProviderIf> schema,
+        const std::unordered_map<std::string, EdgeType>* edgeMap) {
+    DCHECK(exp != nullptr);
+    DCHECK(edgeMap != nullptr);
+    std::unique_ptr<EdgeFilter> filter(new EdgeFilter(edgeType, std::move(schema), edgeMap));
+    if (filter->schema_ != nullptr) {
+        filter->schemaVer_ = filter->schema_->getVersion();
+    }
+    filter->root_ = filter->compileExp(exp);
+    return filter;
+}
+
+
+void EdgeFilter::filter(Context& ctx,
+                        const std::vector<Edge>& edges,
+                        std::vector<uint8_t>& selected) const {
+    selected.resize(edges.size());
+    if (edges.empty()) {
+        return;
+    }
+    root_.pred(ctx, edges, selected);
+    for (auto& s : selected) {
+        s = (s != kFalse) ? 1 : 0;
+    }
+}
+
+
+bool EdgeFilter::accept(Context& ctx, const Edge& edge) const {
+    std::vector<Edge> edges{edge};
+    std::vector<uint8_t> selected;
+    filter(ctx, edges, selected);
+    return selected[0] != 0;
+}
+
+
+EdgeFilter::Compiled EdgeFilter::compileExp(const Expression* exp) const {
+    switch (exp->kind()) {
+        case Expression::kLogical:
+            return compileLogical(static_cast<const LogicalExpression*>(exp));
+        case Expression::kRelational:
+            return compileRelational(static_cast<const RelationalExpression*>(exp));
+        default:
+            return compileGeneric(exp);
+    }
+}
+
+
+EdgeFilter::Compiled EdgeFilter::compileLogical(const LogicalExpression* exp) const {
+    // Both sides are always evaluated by LogicalExpression::eval, so the errors
+    // from either side must be kept.
+    auto left = compileExp(exp->left());
+    auto right = compileExp(exp->right());
+    if (left.alwaysFail || right.alwaysFail) {
+        return failure();
+    }
+
+    Compiled compiled;
+    auto op = exp->op();
+    compiled.pred = [op, l = std::move(left.pred), r = std::move(right.pred)]
+                    (Context& ctx, const std::vector<Edge>& edges, Results& out) {
+        l(ctx, edges, out);
+        Results rv(edges.size());
+        r(ctx, edges, rv);
+        auto n = edges.size();
+        switch (op) {
+            case LogicalExpression::AND:
+                for (size_t i = 0; i < n; i++) {
+                    out[i] = (out[i] == kError || rv[i] == kError)
+                           ? kError : (out[i] & rv[i]);
+                }
+                break;
+            case LogicalExpression::OR:
+                for (size_t i = 0; i < n; i++) {
+                    out[i] = (out[i] == kError || rv[i] == kError)
+                           ? kError : (out[i] | rv[i]);
+                }
+                break;
+            case LogicalExpression::XOR:
+                for (size_t i = 0; i < n; i++) {
+                    out[i] = (out[i] == kError || rv[i] == kError)
+                           ? kError : (out[i] ^ rv[i]);
+                }
+                break;
+        }
+    };
+    return compiled;
+}
+
+
+EdgeFilter::Compiled EdgeFilter::compileRelational(const RelationalExpression* exp) const {
+    bool alwaysFail = false;
+    // Lower both sides, since an error on either side fails the expression
+    std::shared_ptr<const TypedExp> lhs = compileTyped(exp->left(), alwaysFail);
+    std::shared_ptr<const TypedExp> rhs = compileTyped(exp->right(), alwaysFail);
+    if (alwaysFail) {
+        return failure();
+    }
+    if (lhs == nullptr || rhs == nullptr) {
+        return compileGeneric(exp);
+    }
+
+    // The same implicit casting as RelationalExpression: bool -> int64_t -> double
+    auto l = lhs->varType;
+    auto r = rhs->varType;
+    if (l == r) {
+        switch (l) {
+            case VAR_INT64:
+                return makeComparison<int64_t>(exp, std::move(lhs), std::move(rhs), false);
+            case VAR_DOUBLE:
+                return makeComparison<double>(exp, std::move(lhs), std::move(rhs), true);
+            case VAR_STR:
+                return makeComparison<folly::StringPiece>(
+                    exp, std::move(lhs), std::move(rhs), false);
+            default:
+                return compileGeneric(exp);
+        }
+    }
+    if (l == VAR_STR || r == VAR_STR) {
+        // A string can not be compared with a non-string
+        return failure();
+    }
+    if (l == VAR_DOUBLE || r == VAR_DOUBLE) {
+        return makeComparison<double>(exp, std::move(lhs), std::move(rhs), true);
+    }
+    return makeComparison<int64_t>(exp, std::move(lhs), std::move(rhs), false);
+}
+
+
+EdgeFilter::Compiled EdgeFilter::compileGeneric(const Expression* exp) const {
+    Compiled compiled;
+    compiled.pred = [exp] (Context& ctx, const std::vector<Edge>& edges, Results& out) {
+        for (size_t i = 0; i < edges.size(); i++) {
+            out[i] = evalGeneric(exp, ctx, edges[i]);
+        }
+    };
+    return compiled;
+}
+
+
+// static
+EdgeFilter::Compiled EdgeFilter::failure() {
+    Compiled compiled;
+    compiled.pred = [] (Context&, const std::vector<Edge>& edges, Results& out) {
+        std::fill(out.begin(), out.begin() + edges.size(), kError);
+    };
+    compiled.alwaysFail = true;
+    return compiled;
+}
+
+
+// static
+uint8_t EdgeFilter::evalGeneric(const Expression* exp, Context& ctx, const Edge& edge) {
+    ctx.edge_ = &edge;
+    auto value = exp->eval(ctx.getters_);
+    ctx.edge_ = nullptr;
+    if (!value.ok()) {
+        return kError;
+    }
+    return Expression::asBool(value.value()) ? kTrue : kFalse;
+}
+
+
+template <typename T>
+EdgeFilter::Compiled EdgeFilter::makeComparison(const RelationalExpression* exp,
+                                                std::shared_ptr<const TypedExp> lhs,
+                                                std::shared_ptr<const TypedExp> rhs,
+                                                bool approximate) const {
+    bool hasField = lhs->hasField() || rhs->hasField();
+    Compiled compiled;
+    compiled.pred = [this, exp, hasField, approximate, op = exp->op(),
+                     lhs = std::move(lhs), rhs = std::move(rhs)]
+                    (Context& ctx, const std::vector<Edge>& edges, Results& out) {
+        auto n = edges.size();
+        std::vector<T> l(n);
+        std::vector<T> r(n);
+        std::vector<uint8_t> failed(n, 0);
+        evalColumn(*lhs, edges, l, failed);
+        evalColumn(*rhs, edges, r, failed);
+        compareColumns(op, l, r, out, approximate);
+        for (size_t i = 0; i < n; i++) {
+            out[i] = failed[i] ? kError : out[i];
+        }
+        if (hasField) {
+            // The field indexes are resolved against the latest schema only
+            for (size_t i = 0; i < n; i++) {
+                if (!typedReadable(edges[i])) {
+                    out[i] = evalGeneric(exp, ctx, edges[i]);
+                }
+            }
+        }
+    };
+    return compiled;
+}
+
+
+std::unique_ptr<EdgeFilter::TypedExp>
+EdgeFilter::compileTyped(const Expression* exp, bool& alwaysFail) const {
+    auto typed = std::make_unique<TypedExp>();
+    if (exp->kind() != Expression::kArithmetic) {
+        if (!resolveOperand(exp, *typed, alwaysFail)) {
+            return nullptr;
+        }
+        return typed;
+    }
+
+    auto* ariExp = static_cast<const ArithmeticExpression*>(exp);
+    auto op = ariExp->op();
+    auto left = compileTyped(ariExp->left(), alwaysFail);
+    auto right = compileTyped(ariExp->right(), alwaysFail);
+    if (left == nullptr || right == nullptr) {
+        return nullptr;
+    }
+    // Only the numeric addition, subtraction and multiplication are lowered
+    if (op != ArithmeticExpression::ADD
+            && op != ArithmeticExpression::SUB
+            && op != ArithmeticExpression::MUL) {
+        return nullptr;
+    }
+    auto isNumeric = [] (int32_t varType) {
+        return varType == VAR_INT64 || varType == VAR_DOUBLE;
+    };
+    if (!isNumeric(left->varType) || !isNumeric(right->varType)) {
+        return nullptr;
+    }
+    typed->isOperand = false;
+    typed->op = op;
+    typed->varType = (left->varType == VAR_DOUBLE || right->varType == VAR_DOUBLE)
+                   ? VAR_DOUBLE : VAR_INT64;
+    typed->left = std::move(left);
+    typed->right = std::move(right);
+    return typed;
+}
+
+
+bool EdgeFilter::resolveOperand(const Expression* exp,
+                                TypedExp& typed,
+                                bool& alwaysFail) const {
+    auto& operand = typed.operand;
+    switch (exp->kind()) {
+        case Expression::kPrimary: {
+            // The constants do not depend on the getters
+            Getters getters;
+            auto value = exp->eval(getters);
+            if (!value.ok()) {
+                alwaysFail = true;
+                return false;
+            }
+            const auto& v = value.value();
+            operand.source = Operand::Source::kConstant;
+            typed.varType = v.which();
+            switch (typed.varType) {
+                case VAR_INT64:
+                    operand.intVal = Expression::asInt(v);
+                    operand.doubleVal = static_cast<double>(operand.intVal);
+                    break;
+                case VAR_DOUBLE:
+                    operand.doubleVal = Expression::asDouble(v);
+                    break;
+                case VAR_BOOL:
+                    operand.intVal = boost::get<bool>(v) ? 1 : 0;
+                    operand.doubleVal = boost::get<bool>(v) ? 1.0 : 0.0;
+                    break;
+                case VAR_STR:
+                    operand.strVal = Expression::asString(v);
+                    break;
+                default:
+                    return false;
+            }
+            return true;
+        }
+        case Expression::kEdgeDstId: {
+            auto* dstExp = static_cast<const EdgeDstIdExpression*>(exp);
+            if (!checkAlias(*dstExp->alias())) {
+                alwaysFail = true;
+                return false;
+            }
+            operand.source = Operand::Source::kDstId;
+            typed.varType = VAR_INT64;
+            return true;
+        }
+        case Expression::kAliasProp:
+        case Expression::kEdgeSrcId:
+        case Expression::kEdgeRank:
+        case Expression::kEdgeType: {
+            auto* aliasExp = static_cast<const AliasPropertyExpression*>(exp);
+            if (!checkAlias(*aliasExp->alias())) {
+                alwaysFail = true;
+                return false;
+            }
+            const auto& prop = *aliasExp->prop();
+            typed.varType = VAR_INT64;
+            if (prop == _SRC) {
+                operand.source = Operand::Source::kSrcId;
+                return true;
+            } else if (prop == _DST) {
+                operand.source = Operand::Source::kDstId;
+                return true;
+            } else if (prop == _RANK) {
+                operand.source = Operand::Source::kRank;
+                return true;
+            } else if (prop == _TYPE) {
+                operand.source = Operand::Source::kType;
+                return true;
+            }
+
+            if (schema_ == nullptr) {
+                return false;
+            }
+            auto index = schema_->getFieldIndex(prop);
+            if (index < 0) {
+                return false;
+            }
+            operand.source = Operand::Source::kField;
+            operand.index = index;
+            operand.fieldType = schema_->getFieldType(index).get_type();
+            switch (operand.fieldType) {
+                case nebula::cpp2::SupportedType::BOOL:
+                    typed.varType = VAR_BOOL;
+                    return true;
+                case nebula::cpp2::SupportedType::INT:
+                case nebula::cpp2::SupportedType::VID:
+                case nebula::cpp2::SupportedType::TIMESTAMP:
+                    typed.varType = VAR_INT64;
+                    return true;
+                case nebula::cpp2::SupportedType::FLOAT:
+                case nebula::cpp2::SupportedType::DOUBLE:
+                    typed.varType = VAR_DOUBLE;
+                    return true;
+                case nebula::cpp2::SupportedType::STRING:
+                    typed.varType = VAR_STR;
+                    return true;
+                default:
+                    return false;
+            }
+        }
+        default:
+            return false;
+    }
+}
+
+
+bool EdgeFilter::checkAlias(const std::string& alias) const {
+    auto edgeFound = edgeMap_->find(alias);
+    if (edgeFound == edgeMap_->end()) {
+        return false;
+    }
+    return std::abs(edgeType_) == edgeFound->second;
+}
+
+
+void EdgeFilter::evalColumn(const TypedExp& typed,
+                            const std::vector<Edge>& edges,
+                            std::vector<int64_t>& column,
+                            std::vector<uint8_t>& failed) const {
+    auto n = edges.size();
+    if (typed.isOperand) {
+        if (typed.operand.source == Operand::Source::kConstant) {
+            std::fill(column.begin(), column.end(), typed.operand.intVal);
+            return;
+        }
+        for (size_t i = 0; i < n; i++) {
+            failed[i] |= read(typed.operand, edges[i], column[i]) ? 0 : 1;
+        }
+        return;
+    }
+
+    DCHECK_EQ(VAR_INT64, typed.varType);
+    std::vector<int64_t> right(n);
+    evalColumn(*typed.left, edges, column, failed);
+    evalColumn(*typed.right, edges, right, failed);
+    // The same as ArithmeticExpression, the overflow of integers fails
+    switch (typed.op) {
+        case ArithmeticExpression::ADD:
+            for (size_t i = 0; i < n; i++) {
+                failed[i] |= __builtin_add_overflow(column[i], right[i], &column[i]);
+            }
+            break;
+        case ArithmeticExpression::SUB:
+            for (size_t i = 0; i < n; i++) {
+                failed[i] |= __builtin_sub_overflow(column[i], right[i], &column[i]);
+            }
+            break;
+        case ArithmeticExpression::MUL:
+            for (size_t i = 0; i < n; i++) {
+                failed[i] |= __builtin_mul_overflow(column[i], right[i], &column[i]);
+            }
+            break;
+        default:
+            LOG(FATAL) << "Unsupported arithmetic operator " << static_cast<int32_t>(typed.op);
+    }
+}
+
+
+void EdgeFilter::evalColumn(const TypedExp& typed,
+                            const std::vector<Edge>& edges,
+                            std::vector<double>& column,
+                            std::vector<uint8_t>& failed) const {
+    auto n = edges.size();
+    if (typed.isOperand) {
+        if (typed.operand.source == Operand::Source::kConstant) {
+            std::fill(column.begin(), column.end(), typed.operand.doubleVal);
+            return;
+        }
+        for (size_t i = 0; i < n; i++) {
+            failed[i] |= read(typed.operand, edges[i], column[i]) ? 0 : 1;
+        }
+        return;
+    }
+
+    if (typed.varType == VAR_INT64) {
+        // The integer arithmetic is calculated as integers, then casted
+        std::vector<int64_t> ints(n);
+        evalColumn(typed, edges, ints, failed);
+        for (size_t i = 0; i < n; i++) {
+            column[i] = static_cast<double>(ints[i]);
+        }
+        return;
+    }
+
+    std::vector<double> right(n);
+    evalColumn(*typed.left, edges, column, failed);
+    evalColumn(*typed.right, edges, right, failed);
+    switch (typed.op) {
+        case ArithmeticExpression::ADD:
+            for (size_t i = 0; i < n; i++) {
+                column[i] += right[i];
+            }
+            break;
+        case ArithmeticExpression::SUB:
+            for (size_t i = 0; i < n; i++) {
+                column[i] -= right[i];
+            }
+            break;
+        case ArithmeticExpression::MUL:
+            for (size_t i = 0; i < n; i++) {
+                column[i] *= right[i];
+            }
+            break;
+        default:
+            LOG(FATAL) << "Unsupported arithmetic operator " << static_cast<int32_t>(typed.op);
+    }
+}
+
+
+void EdgeFilter::evalColumn(const TypedExp& typed,
+                            const std::vector<Edge>& edges,
+                            std::vector<folly::StringPiece>& column,
+                            std::vector<uint8_t>& failed) const {
+    DCHECK(typed.isOperand);
+    if (typed.operand.source == Operand::Source::kConstant) {
+        std::fill(column.begin(), column.end(), folly::StringPiece(typed.operand.strVal));
+        return;
+    }
+    for (size_t i = 0; i < edges.size(); i++) {
+        failed[i] |= read(typed.operand, edges[i], column[i]) ? 0 : 1;
+    }
+}
+
+
+bool EdgeFilter::read(const Operand& operand, const Edge& edge, int64_t& v) const {
+    switch (operand.source) {
+        case Operand::Source::kConstant:
+            v = operand.intVal;
+            return true;
+        case Operand::Source::kSrcId:
+            v = NebulaKeyUtils::getSrcId(edge.key);
+            return true;
+        case Operand::Source::kDstId:
+            v = edge.dstId;
+            return true;
+        case Operand::Source::kRank:
+            v = edge.rank;
+            return true;
+        case Operand::Source::kType:
+            v = static_cast<int64_t>(NebulaKeyUtils::getEdgeType(edge.key));
+            return true;
+        case Operand::Source::kField:
+            break;
+    }
+    if (!typedReadable(edge)) {
+        return false;
+    }
+    switch (operand.fieldType) {
+        case nebula::cpp2::SupportedType::INT:
+        case nebula::cpp2::SupportedType::TIMESTAMP:
+            return edge.reader->getInt(operand.index, v) == ResultType::SUCCEEDED;
+        case nebula::cpp2::SupportedType::VID:
+            return edge.reader->getVid(operand.index, v) == ResultType::SUCCEEDED;
+        case nebula::cpp2::SupportedType::BOOL: {
+            bool b;
+            if (edge.reader->getBool(operand.index, b) != ResultType::SUCCEEDED) {
+                return false;
+            }
+            v = b ? 1 : 0;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+
+bool EdgeFilter::read(const Operand& operand, const Edge& edge, double& v) const {
+    if (operand.source == Operand::Source::kConstant) {
+        v = operand.doubleVal;
+        return true;
+    }
+    if (operand.source == Operand::Source::kField) {
+        if (!typedReadable(edge)) {
+            return false;
+        }
+        switch (operand.fieldType) {
+            case nebula::cpp2::SupportedType::FLOAT: {
+                float f;
+                if (edge.reader->getFloat(operand.index, f) != ResultType::SUCCEEDED) {
+                    return false;
+                }
+                v = static_cast<double>(f);
+                return true;
+            }
+            case nebula::cpp2::SupportedType::DOUBLE:
+                return edge.reader->getDouble(operand.index, v) == ResultType::SUCCEEDED;
+            default:
+                break;
+        }
+    }
+    int64_t i;
+    if (!read(operand, edge, i)) {
+        return false;
+    }
+    v = static_cast<double>(i);
+    return true;
+}
+
+
+bool EdgeFilter::read(const Operand& operand,
+                      const Edge& edge,
+                      folly::StringPiece& v) const {
+    if (operand.source == Operand::Source::kConstant) {
+        v = operand.strVal;
+        return true;
+    }
+    if (operand.source == Operand::Source::kField
+            && operand.fieldType == nebula::cpp2::SupportedType::STRING
+            && typedReadable(edge)) {
+        return edge.reader->getString(operand.index, v) == ResultType::SUCCEEDED;
+    }
+    return false;
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,215 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_QUERY_EDGEFILTER_H_
+#define STORAGE_QUERY_EDGEFILTER_H_
+
+#include "base/Base.h"
+#include "filter/Expressions.h"
+#include "dataman/RowReader.h"
+#include "storage/CommonUtils.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * EdgeFilter is the compiled form of the filter pushed down to storage, for one edge type.
+ *
+ * It is compiled once per request: the aliases are resolved against the edge type, the props
+ * are resolved to the field indexes of the latest edge schema, and the relational, arithmetic
+ * and logical expressions over props and constants are lowered into typed kernels.
+ *
+ * The filter is evaluated on a batch of edges at a time. Each kernel decodes its operands into
+ * plain columns (int64_t, double or StringPiece) for the whole batch, and then runs a tight
+ * loop over the columns, so there is neither virtual call nor VariantType per edge.
+ *
+ * The subexpressions which could not be lowered (function calls, $^ props, ...) and the rows
+ * written with an older schema version are evaluated by Expression::eval, through the getters
+ * of the EdgeFilter::Context. So the result is always the same as evaluating the whole
+ * expression on every edge, including the errors, which keep the edge.
+ * */
+class EdgeFilter final {
+public:
+    struct Edge {
+        folly::StringPiece  key;
+        const RowReader*    reader{nullptr};
+        EdgeRanking         rank{0};
+        VertexID            dstId{0};
+    };
+
+    /**
+     * The per scan evaluation state. The EdgeFilter is shared by all the worker threads of the
+     * request, while each scan owns its Context.
+     * */
+    class Context final {
+    public:
+        Context(const EdgeFilter* filter, FilterContext* fcontext);
+
+        Context(const Context&) = delete;
+        Context& operator=(const Context&) = delete;
+
+    private:
+        friend class EdgeFilter;
+
+        // The edge being evaluated by the getters
+        const Edge*     edge_{nullptr};
+        Getters         getters_;
+    };
+
+    static std::unique_ptr<EdgeFilter> compile(
+            const Expression* exp,
+            EdgeType edgeType,
+            std::shared_ptr<const meta::SchemaProviderIf> schema,
+            const std::unordered_map<std::string, EdgeType>* edgeMap);
+
+    /**
+     * Evaluate the filter on a batch of edges.
+     * selected[i] is set to 0 if edges[i] should be filtered out, otherwise 1.
+     * */
+    void filter(Context& ctx,
+                const std::vector<Edge>& edges,
+                std::vector<uint8_t>& selected) const;
+
+    /**
+     * Return false if the edge should be filtered out.
+     * */
+    bool accept(Context& ctx, const Edge& edge) const;
+
+private:
+    // The result of the predicate on each edge, kError keeps the edge as Expression::eval does
+    static constexpr uint8_t kFalse = 0;
+    static constexpr uint8_t kTrue  = 1;
+    static constexpr uint8_t kError = 2;
+
+    using Results = std::vector<uint8_t>;
+    using Predicate = std::function<void(Context&, const std::vector<Edge>&, Results&)>;
+
+    struct Compiled {
+        Predicate   pred;
+        // The predicate fails on all edges
+        bool        alwaysFail{false};
+    };
+
+    // A leaf of the typed expressions
+    struct Operand {
+        enum class Source : uint8_t {
+            kConstant,
+            kField,
+            kSrcId,
+            kDstId,
+            kRank,
+            kType,
+        };
+
+        Source                          source{Source::kConstant};
+        // Only used by kField
+        nebula::cpp2::SupportedType     fieldType{nebula::cpp2::SupportedType::UNKNOWN};
+        int64_t                         index{-1};
+        // Only used by kConstant, converted to all compatible types in advance
+        int64_t                         intVal{0};
+        double                          doubleVal{0.0};
+        std::string                     strVal;
+    };
+
+    // An expression whose type is known before scanning, either an operand, or an
+    // arithmetic expression of two numeric typed expressions.
+    struct TypedExp {
+        // VAR_INT64, VAR_DOUBLE, VAR_BOOL or VAR_STR
+        int32_t                             varType{VAR_INT64};
+        bool                                isOperand{true};
+        Operand                             operand;
+        ArithmeticExpression::Operator      op{ArithmeticExpression::ADD};
+        std::unique_ptr<TypedExp>           left;
+        std::unique_ptr<TypedExp>           right;
+
+        bool hasField() const {
+            if (isOperand) {
+                return operand.source == Operand::Source::kField;
+            }
+            return left->hasField() || right->hasField();
+        }
+    };
+
+    EdgeFilter(EdgeType edgeType,
+               std::shared_ptr<const meta::SchemaProviderIf> schema,
+               const std::unordered_map<std::string, EdgeType>* edgeMap)
+        : edgeType_(edgeType)
+        , schema_(std::move(schema))
+        , edgeMap_(edgeMap) {}
+
+    Compiled compileExp(const Expression* exp) const;
+
+    Compiled compileLogical(const LogicalExpression* exp) const;
+
+    Compiled compileRelational(const RelationalExpression* exp) const;
+
+    Compiled compileGeneric(const Expression* exp) const;
+
+    // The predicate of the expressions which fail on all edges
+    static Compiled failure();
+
+    /**
+     * Lower an operand of the relational expression.
+     * Return nullptr if it could not be typed before scanning,
+     * and set alwaysFail if evaluating it always fails.
+     * */
+    std::unique_ptr<TypedExp> compileTyped(const Expression* exp, bool& alwaysFail) const;
+
+    bool resolveOperand(const Expression* exp,
+                        TypedExp& typed,
+                        bool& alwaysFail) const;
+
+    // Return false if the alias does not refer to the edge type being scanned,
+    // in which case Expression::eval fails as well.
+    bool checkAlias(const std::string& alias) const;
+
+    template <typename T>
+    Compiled makeComparison(const RelationalExpression* exp,
+                            std::shared_ptr<const TypedExp> lhs,
+                            std::shared_ptr<const TypedExp> rhs,
+                            bool approximate) const;
+
+    /**
+     * Evaluate the typed expression on the batch into a column.
+     * failed[i] is set to 1 if it fails on edges[i].
+     * */
+    void evalColumn(const TypedExp& typed,
+                    const std::vector<Edge>& edges,
+                    std::vector<int64_t>& column,
+                    std::vector<uint8_t>& failed) const;
+    void evalColumn(const TypedExp& typed,
+                    const std::vector<Edge>& edges,
+                    std::vector<double>& column,
+                    std::vector<uint8_t>& failed) const;
+    void evalColumn(const TypedExp& typed,
+                    const std::vector<Edge>& edges,
+                    std::vector<folly::StringPiece>& column,
+                    std::vector<uint8_t>& failed) const;
+
+    // Read the value of the operand on one edge, return false on failure
+    bool read(const Operand& operand, const Edge& edge, int64_t& v) const;
+    bool read(const Operand& operand, const Edge& edge, double& v) const;
+    bool read(const Operand& operand, const Edge& edge, folly::StringPiece& v) const;
+
+    // Evaluate the original expression on one edge
+    static uint8_t evalGeneric(const Expression* exp, Context& ctx, const Edge& edge);
+
+    // Whether the typed expressions could read the row of the edge
+    bool typedReadable(const Edge& edge) const {
+        return edge.reader != nullptr && edge.reader->schemaVer() == schemaVer_;
+    }
+
+private:
+    EdgeType                                            edgeType_;
+    std::shared_ptr<const meta::SchemaProviderIf>       schema_;
+    SchemaVer                                           schemaVer_{0};
+    const std::unordered_map<std::string, EdgeType>*    edgeMap_;
+    Compiled                                            root_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_QUERY_EDGEFILTER_H_
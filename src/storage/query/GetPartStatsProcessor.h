@@ -0,0 +1,68 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#ifndef STORAGE_QUERY_GETPARTSTATSPROCESSOR_H_
+#define STORAGE_QUERY_GETPARTSTATSPROCESSOR_H_
+
+#include "base/Base.h"
+#include "storage/BaseProcessor.h"
+#include "storage/PartStats.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * Return the approximate statistics of the parts, which are held in memory,
+ * so it costs O(parts) instead of scanning the data.
+ *
+ * The counts are maintained by every replica when the writes are committed, but only the
+ * leader answers, as a follower could lag behind.
+ * */
+class GetPartStatsProcessor : public BaseProcessor<cpp2::GetPartStatsResponse> {
+public:
+    static GetPartStatsProcessor* instance(kvstore::KVStore* kvstore,
+                                           PartStatsManager* partStats) {
+        return new GetPartStatsProcessor(kvstore, partStats);
+    }
+
+    void process(const cpp2::GetPartStatsRequest& req) {
+        CHECK_NOTNULL(kvstore_);
+        auto spaceId = req.get_space_id();
+        std::unordered_map<PartitionID, cpp2::PartStats> result;
+        for (auto partId : req.get_parts()) {
+            auto ret = kvstore_->part(spaceId, partId);
+            if (!ok(ret)) {
+                handleErrorCode(error(ret), spaceId, partId);
+                continue;
+            }
+            if (!value(ret)->isLeader()) {
+                handleLeaderChanged(spaceId, partId);
+                continue;
+            }
+            auto stats = partStats_ == nullptr ? PartStats() : partStats_->get(spaceId, partId);
+            cpp2::PartStats thriftStats;
+            thriftStats.set_tag_vertices(std::move(stats.tagVertices));
+            thriftStats.set_edge_counts(std::move(stats.edgeCounts));
+            thriftStats.set_degree_histograms(std::move(stats.degreeHistograms));
+            result.emplace(partId, std::move(thriftStats));
+        }
+        resp_.set_stats(std::move(result));
+        this->onFinished();
+    }
+
+private:
+    GetPartStatsProcessor(kvstore::KVStore* kvstore, PartStatsManager* partStats)
+            : BaseProcessor<cpp2::GetPartStatsResponse>(kvstore, nullptr)
+            , partStats_(partStats) {}
+
+private:
+    PartStatsManager*   partStats_{nullptr};
+};
+
+}  // namespace storage
+}  // namespace nebula
+
+#endif  // STORAGE_QUERY_GETPARTSTATSPROCESSOR_H_
@@ -11,6 +11,17 @@ DEFINE_int32(min_vertices_per_bucket, 3, "The min vertices number in one bucket"
 DEFINE_int32(max_edge_returned_per_vertex, INT_MAX, "Max edge number returnred searching vertex");
 DEFINE_bool(enable_vertex_cache, true, "Enable vertex cache");
 DEFINE_bool(enable_reservoir_sampling, false, "Will do reservoir sampling if set true.");
+DEFINE_int32(edge_filter_batch_size, 1024,
+             "The number of edges evaluated by the filter at a time, "
+             "0 or 1 to evaluate edge by edge");
+DEFINE_int32(supernode_edges_threshold, 100000,
+             "The edges of one vertex beyond this number are split into ranges "
+             "and scanned in parallel, 0 to disable");
+DEFINE_int32(supernode_scan_parallelism, 8,
+             "The max number of ranges the edges of a super vertex are split into");
+DEFINE_bool(enable_follower_read, false,
+            "Serve the neighbors and vertex props queries on the followers, "
+            "which catch up with the leader by the read index before reading");
 
 namespace nebula {
 namespace storage {
@@ -12,8 +12,11 @@
 #include "storage/BaseProcessor.h"
 #include "storage/Collector.h"
 #include "filter/Expressions.h"
+#include "meta/PinnedSchemas.h"
 #include "storage/CommonUtils.h"
+#include "storage/query/EdgeFilter.h"
 #include "stats/Stats.h"
+#include "algorithm/ReservoirSampling.h"
 #include <random>
 
 namespace nebula {
@@ -30,6 +33,11 @@ using EdgeProcessor
     = std::function<void(RowReader* reader,
                          folly::StringPiece key,
                          const std::vector<PropContext>& props)>;
+/**
+ * Create the processors for the ranges of a super vertex's edges, which are scanned
+ * concurrently, so the processors should not share any mutable state.
+ * */
+using EdgeProcessorFactory = std::function<std::vector<EdgeProcessor>(size_t num)>;
 struct Bucket {
     std::vector<std::pair<PartitionID, VertexID>> vertices_;
 };
@@ -78,7 +86,21 @@ protected:
                       FilterContext* fcontext,
                       Collector* collector);
 
-    virtual kvstore::ResultCode processVertex(PartitionID partId, VertexID vId) = 0;
+    /**
+     * Called before the buckets are processed, so that each bucket could accumulate its
+     * results on its own without any lock, and merge them in onProcessFinished.
+     * */
+    virtual void prepareBuckets(size_t bucketsNum) {
+        UNUSED(bucketsNum);
+    }
+
+    /**
+     * Process one vertex of the bucketIdx-th bucket. The vertices of one bucket are
+     * processed one by one in the same thread.
+     * */
+    virtual kvstore::ResultCode processVertex(PartitionID partId,
+                                              VertexID vId,
+                                              size_t bucketIdx) = 0;
 
     virtual void onProcessFinished(int32_t retNum) = 0;
 
@@ -101,6 +123,14 @@ protected:
                             std::vector<cpp2::TagData> &tds);
     /**
      * Collect props for one vertex edge.
+     *
+     * If procFactory is given and the vertex has more than FLAGS_supernode_edges_threshold
+     * edges, the rest edges are split into ranges and scanned in parallel. The i-th range is
+     * handed to the i-th processor created by procFactory, and the ranges follow the edges
+     * handed to proc in the key order. Each range returns at most as many edges as proc could
+     * still take, so the caller should truncate the concatenation to
+     * FLAGS_max_edge_returned_per_vertex.
+     * With reservoir sampling, the samples are always handed to proc.
      * */
     kvstore::ResultCode collectEdgeProps(
                                PartitionID partId,
@@ -108,11 +138,37 @@ protected:
                                EdgeType edgeType,
                                const std::vector<PropContext>& props,
                                FilterContext* fcontext,
-                               EdgeProcessor proc);
+                               EdgeProcessor proc,
+                               EdgeProcessorFactory procFactory = nullptr);
+
+    /**
+     * Take the vertices of the request, or only the vertices of the page starting from the
+     * cursor for a paged request, in which case nextCursor_ is set if there are more.
+     * */
+    std::vector<std::pair<PartitionID, VertexID>> pageVertices(
+        const cpp2::GetNeighborsRequest& req);
+
+    /**
+     * With FLAGS_enable_follower_read, check the parts on which the local replica is a
+     * follower by KVStore::readIndex, and serve the reads of the parts passed on it.
+     *
+     * The parts are checked concurrently, and the future is fulfilled on executor_ once all
+     * are done, or right away if no part needs to wait.
+     * */
+    folly::Future<folly::Unit>
+    prepareFollowerReads(const std::unordered_map<PartitionID, std::vector<VertexID>>& parts);
+
+    kvstore::ReadContext readContext(PartitionID partId) const {
+        kvstore::ReadContext ctx;
+        ctx.followerRead_ = followerReadParts_.count(partId) > 0;
+        return ctx;
+    }
 
     std::vector<Bucket> genBuckets(const cpp2::GetNeighborsRequest& req);
 
-    folly::Future<std::vector<OneVertexResp>> asyncProcessBucket(Bucket bucket);
+    folly::Future<std::vector<OneVertexResp>> asyncProcessBucket(size_t bucketIdx, Bucket bucket);
+
+    void processBuckets(std::vector<Bucket> buckets, int32_t returnColumnsNum);
 
     int32_t getBucketsNum(int32_t verticesNum, int32_t minVerticesPerBucket, int32_t handlerNum);
 
@@ -124,10 +180,70 @@ protected:
 
     folly::Optional<std::pair<std::string, int64_t>> getEdgeTTLInfo(EdgeType edgeType);
 
+private:
+    using EdgeSampler = algorithm::ReservoirSampling<std::pair<std::string, std::string>>;
+
+    // The state of scanning the edges of one vertex, or one range of them
+    struct EdgeScan {
+        EdgeType                                edgeType{0};
+        bool                                    onlyStructure{false};
+        const std::vector<PropContext>*         props{nullptr};
+        EdgeProcessor                           proc;
+        const EdgeFilter*                       filter{nullptr};
+        std::unique_ptr<EdgeFilter::Context>    filterCtx;
+        // The key and value of the sampled edges, only used by reservoir sampling
+        std::unique_ptr<EdgeSampler>            sampler;
+        // The number of edges handed to proc or offered to the sampler
+        int64_t                                 cnt{0};
+        int64_t                                 maxCnt{0};
+        EdgeRanking                             lastRank{-1};
+        VertexID                                lastDstId{0};
+        bool                                    firstLoop{true};
+        // The schemas pinned by the thread scanning it
+        meta::PinnedSchemas*                    schemas{nullptr};
+    };
+
+    /**
+     * The schemas pinned by the bucket being processed on the current thread, or null out of
+     * the buckets. PinnedSchemas is not thread safe, so the other threads pin their own.
+     * */
+    static meta::PinnedSchemas*& bucketSchemas() {
+        static thread_local meta::PinnedSchemas* schemas = nullptr;
+        return schemas;
+    }
+
+    /**
+     * Scan the edges from iter, and stop before visiting the (limit + 1)-th edge.
+     * Return true if it stops by the limit, then iter is at the latest version of the next edge.
+     * */
+    bool scanEdges(VertexID vId, EdgeScan& scan, kvstore::KVIterator* iter, int64_t limit);
+
+    /**
+     * Split the edges in [start, end) into at most num ranges on the (rank, dst) boundaries,
+     * so that all versions of an edge are in the same range.
+     * Return the boundaries of the ranges, from start to end.
+     * */
+    std::vector<std::string> splitEdgeRange(PartitionID partId,
+                                            const std::string& prefix,
+                                            const std::string& start,
+                                            const std::string& end,
+                                            int32_t num);
+
+    // Scan the ranges by the worker threads of executor_ and the current thread
+    kvstore::ResultCode scanEdgeRanges(PartitionID partId,
+                                       VertexID vId,
+                                       const std::vector<std::string>& bounds,
+                                       std::vector<std::unique_ptr<EdgeScan>>& scans);
+
+    // Merge the samples of the scans into one uniform sample, and hand them to proc
+    void processSamples(std::vector<std::unique_ptr<EdgeScan>>& scans, EdgeProcessor& proc);
+
 protected:
     GraphSpaceID  spaceId_;
     std::unique_ptr<ExpressionContext> expCtx_;
     std::unique_ptr<Expression> exp_;
+    // The filter compiled for each edge type in edgeContexts_
+    std::unordered_map<EdgeType, std::unique_ptr<EdgeFilter>> edgeFilters_;
     std::vector<TagContext> tagContexts_;
     std::unordered_map<EdgeType, std::vector<PropContext>> edgeContexts_;
 
@@ -147,6 +263,12 @@ protected:
     std::unordered_map<EdgeType, std::pair<std::string, int64_t>> edgeTTLInfo_;
 
     std::unordered_map<TagID, std::pair<std::string, int64_t>> tagTTLInfo_;
+
+    // The cursor of the next page of a paged request
+    folly::Optional<std::string> nextCursor_;
+
+    // The parts served by the local follower, only changed before processing the vertices
+    std::unordered_set<PartitionID> followerReadParts_;
 };
 
 }  // namespace storage
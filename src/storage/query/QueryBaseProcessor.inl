@@ -11,13 +11,19 @@
 #include "meta/NebulaSchemaProvider.h"
 #include "filter/FunctionManager.h"
 #include "time/WallClock.h"
-#include "algorithm/ReservoirSampling.h"
+#include "kvstore/Common.h"
+#include <folly/Random.h>
+#include <folly/synchronization/Baton.h>
 
 DECLARE_int32(max_handlers_per_req);
 DECLARE_int32(min_vertices_per_bucket);
 DECLARE_int32(max_edge_returned_per_vertex);
 DECLARE_bool(enable_vertex_cache);
 DECLARE_bool(enable_reservoir_sampling);
+DECLARE_int32(edge_filter_batch_size);
+DECLARE_int32(supernode_edges_threshold);
+DECLARE_int32(supernode_scan_parallelism);
+DECLARE_bool(enable_follower_read);
 
 namespace nebula {
 namespace storage {
@@ -163,6 +169,13 @@ cpp2::ErrorCode QueryBaseProcessor<REQ, RESP>::checkAndBuildContexts(const REQ&
         }
         expCtx_ = std::make_unique<ExpressionContext>();
         exp_->setContext(expCtx_.get());
+        for (auto& ec : edgeContexts_) {
+            auto edgeType = ec.first;
+            auto schema = this->schemaMan_->getEdgeSchema(spaceId_, std::abs(edgeType));
+            edgeFilters_.emplace(edgeType,
+                                 EdgeFilter::compile(exp_.get(), edgeType,
+                                                     std::move(schema), &edgeMap_));
+        }
     }
 
     buildTTLInfoAndRespSchema();
@@ -407,7 +420,10 @@ kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::collectVertexProps(
                             FilterContext* fcontext,
                             Collector* collector) {
     auto schema = this->schemaMan_->getTagSchema(spaceId_, tagId);
-    if (FLAGS_enable_vertex_cache && vertexCache_ != nullptr) {
+    auto ctx = readContext(partId);
+    // The cache of a follower is not invalidated by the writes
+    bool useCache = FLAGS_enable_vertex_cache && vertexCache_ != nullptr && !ctx.followerRead_;
+    if (useCache) {
         auto result = vertexCache_->get(std::make_pair(vId, tagId), partId);
         if (result.ok()) {
             auto v = std::move(result).value();
@@ -436,7 +452,7 @@ kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::collectVertexProps(
     }
     auto prefix = NebulaKeyUtils::vertexPrefix(partId, vId, tagId);
     std::unique_ptr<kvstore::KVIterator> iter;
-    auto ret = this->kvstore_->prefix(spaceId_, partId, prefix, &iter);
+    auto ret = this->kvstore_->prefix(spaceId_, partId, prefix, &iter, ctx);
     if (ret != kvstore::ResultCode::SUCCEEDED) {
         VLOG(3) << "Error! ret = " << static_cast<int32_t>(ret) << ", spaceId " << spaceId_;
         return ret;
@@ -458,7 +474,7 @@ kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::collectVertexProps(
             }
         }
         this->collectProps(reader.get(), iter->key(), props, fcontext, collector);
-        if (FLAGS_enable_vertex_cache && vertexCache_ != nullptr) {
+        if (useCache) {
             vertexCache_->insert(std::make_pair(vId, tagId),
                                  iter->val().str(), partId);
             VLOG(3) << "Insert cache for vId " << vId << ", tagId " << tagId;
@@ -477,54 +493,241 @@ kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::collectEdgeProps(
                                                EdgeType edgeType,
                                                const std::vector<PropContext>& props,
                                                FilterContext* fcontext,
-                                               EdgeProcessor proc) {
+                                               EdgeProcessor proc,
+                                               EdgeProcessorFactory procFactory) {
     auto prefix = NebulaKeyUtils::edgePrefix(partId, vId, edgeType);
     std::unique_ptr<kvstore::KVIterator> iter;
-    auto ret = this->kvstore_->prefix(spaceId_, partId, prefix, &iter);
+    auto ret = this->kvstore_->prefix(spaceId_, partId, prefix, &iter, readContext(partId));
     if (ret != kvstore::ResultCode::SUCCEEDED || !iter) {
         return ret;
     }
 
-    EdgeRanking lastRank  = -1;
-    VertexID    lastDstId = 0;
-    bool        firstLoop = true;
-    int         cnt = 0;
     bool onlyStructure = onlyStructures_[edgeType];
-    Getters getters;
-    std::unique_ptr<nebula::algorithm::ReservoirSampling<
-        std::pair<std::unique_ptr<RowReader>, std::string>>> sampler;
+    const EdgeFilter* filter = nullptr;
+    if (exp_ != nullptr) {
+        auto filterFound = edgeFilters_.find(edgeType);
+        DCHECK(filterFound != edgeFilters_.end());
+        if (filterFound != edgeFilters_.end()) {
+            filter = filterFound->second.get();
+        }
+    }
+    // Out of the buckets, the schemas are pinned by each call
+    std::unique_ptr<meta::PinnedSchemas> ownSchemas;
+    auto* schemas = bucketSchemas();
+    if (schemas == nullptr) {
+        ownSchemas = std::make_unique<meta::PinnedSchemas>(this->schemaMan_);
+        schemas = ownSchemas.get();
+    }
+    auto newScan = [&] (EdgeProcessor p, int64_t maxCnt) {
+        auto scan = std::make_unique<EdgeScan>();
+        scan->edgeType = edgeType;
+        scan->schemas = schemas;
+        scan->onlyStructure = onlyStructure;
+        scan->props = &props;
+        scan->proc = std::move(p);
+        scan->maxCnt = maxCnt;
+        if (filter != nullptr) {
+            scan->filter = filter;
+            scan->filterCtx = std::make_unique<EdgeFilter::Context>(filter, fcontext);
+        }
+        if (FLAGS_enable_reservoir_sampling) {
+            scan->sampler = std::make_unique<EdgeSampler>(FLAGS_max_edge_returned_per_vertex);
+        }
+        return scan;
+    };
+
+    std::vector<std::unique_ptr<EdgeScan>> scans;
+    scans.emplace_back(newScan(proc, FLAGS_max_edge_returned_per_vertex));
+    // The samples are handed to proc at last, so the ranges need no processor of their own
+    bool parallel = FLAGS_supernode_edges_threshold > 0
+                 && FLAGS_supernode_scan_parallelism > 1
+                 && (FLAGS_enable_reservoir_sampling || procFactory != nullptr);
+    auto limit = parallel ? FLAGS_supernode_edges_threshold
+                          : std::numeric_limits<int64_t>::max();
+    if (scanEdges(vId, *scans[0], iter.get(), limit)) {
+        // A super vertex, scan the rest edges by ranges in parallel
+        auto key = iter->key();
+        auto start = NebulaKeyUtils::edgePrefix(partId,
+                                                vId,
+                                                edgeType,
+                                                NebulaKeyUtils::getRank(key),
+                                                NebulaKeyUtils::getDstId(key));
+        iter.reset();
+        auto end = kvstore::prefixSuccessor(prefix);
+        auto bounds = splitEdgeRange(partId,
+                                     prefix,
+                                     start,
+                                     end,
+                                     FLAGS_supernode_scan_parallelism);
+        auto num = bounds.size() - 1;
+        VLOG(1) << "Scan the edges of the super vertex " << vId << ":" << edgeType
+                << " by " << num << " ranges";
+        std::vector<EdgeProcessor> procs;
+        if (!FLAGS_enable_reservoir_sampling) {
+            procs = procFactory(num);
+            CHECK_EQ(num, procs.size());
+        } else {
+            procs.resize(num);
+        }
+        auto maxCnt = FLAGS_max_edge_returned_per_vertex - scans[0]->cnt;
+        for (size_t i = 0; i < num; i++) {
+            scans.emplace_back(newScan(std::move(procs[i]), maxCnt));
+        }
+        auto code = scanEdgeRanges(partId, vId, bounds, scans);
+        if (code != kvstore::ResultCode::SUCCEEDED) {
+            return code;
+        }
+    }
+
     if (FLAGS_enable_reservoir_sampling) {
-        sampler = std::make_unique<
-            nebula::algorithm::ReservoirSampling<
-                std::pair<std::unique_ptr<RowReader>, std::string>
-            >
-        >(FLAGS_max_edge_returned_per_vertex);
+        processSamples(scans, proc);
     }
+    return ret;
+}
 
-    auto schema = this->schemaMan_->getEdgeSchema(spaceId_, std::abs(edgeType));
+template<typename REQ, typename RESP>
+bool QueryBaseProcessor<REQ, RESP>::scanEdges(VertexID vId,
+                                              EdgeScan& scan,
+                                              kvstore::KVIterator* iter,
+                                              int64_t limit) {
+    auto edgeType = scan.edgeType;
+    auto* filter = scan.filter;
+    bool sampling = scan.sampler != nullptr;
+    auto schema = scan.schemas->getEdgeSchema(spaceId_, std::abs(edgeType));
     auto retTTL = getEdgeTTLInfo(edgeType);
+
+    // When there is a filter, the edges are filtered in batches. The keys and values
+    // are copied, since the iterator only keeps them valid until next()
+    bool batched = filter != nullptr
+                && !scan.onlyStructure
+                && FLAGS_edge_filter_batch_size > 1;
+    std::vector<std::string> batchKeys;
+    std::vector<std::string> batchVals;
+    std::vector<std::unique_ptr<RowReader>> batchReaders;
+    std::vector<uint8_t> batchKept;
+    std::vector<EdgeFilter::Edge> filterEdges;
+    std::vector<size_t> filterIndexes;
+    std::vector<uint8_t> selected;
+    if (batched) {
+        batchKeys.reserve(FLAGS_edge_filter_batch_size);
+        batchVals.reserve(FLAGS_edge_filter_batch_size);
+    }
+    // Return false once enough edges have been collected
+    auto flushBatch = [&] () -> bool {
+        auto n = batchKeys.size();
+        batchReaders.clear();
+        batchReaders.resize(n);
+        batchKept.assign(n, 1);
+        filterEdges.clear();
+        filterIndexes.clear();
+        for (size_t i = 0; i < n; i++) {
+            if (batchVals[i].empty()) {
+                continue;
+            }
+            batchReaders[i] = RowReader::getEdgePropReader(scan.schemas,
+                                                           batchVals[i],
+                                                           spaceId_,
+                                                           std::abs(edgeType));
+            if (batchReaders[i] == nullptr) {
+                VLOG(3) << "The schema of the edge is not found.";
+                batchKept[i] = 0;
+                continue;
+            }
+            // Check if ttl data expired
+            if (retTTL.has_value() && checkDataExpiredForTTL(schema.get(),
+                                                             batchReaders[i].get(),
+                                                             retTTL.value().first,
+                                                             retTTL.value().second)) {
+                VLOG(3) << "Data expired.";
+                batchKept[i] = 0;
+                continue;
+            }
+            folly::StringPiece key = batchKeys[i];
+            filterEdges.emplace_back(EdgeFilter::Edge{key,
+                                                      batchReaders[i].get(),
+                                                      NebulaKeyUtils::getRank(key),
+                                                      NebulaKeyUtils::getDstId(key)});
+            filterIndexes.emplace_back(i);
+        }
+
+        filter->filter(*scan.filterCtx, filterEdges, selected);
+        for (size_t j = 0; j < filterEdges.size(); j++) {
+            if (!selected[j]) {
+                VLOG(1) << "Filter the edge "
+                        << vId << "-> " << filterEdges[j].dstId << "@" << filterEdges[j].rank
+                        << ":" << edgeType;
+                batchKept[filterIndexes[j]] = 0;
+            }
+        }
+
+        bool more = true;
+        for (size_t i = 0; i < n; i++) {
+            if (!batchKept[i]) {
+                continue;
+            }
+            if (sampling) {
+                scan.sampler->sampling(std::make_pair(std::move(batchKeys[i]),
+                                                      std::move(batchVals[i])));
+                ++scan.cnt;
+                continue;
+            }
+            if (!(scan.cnt < scan.maxCnt)) {
+                more = false;
+                break;
+            }
+            scan.proc(batchReaders[i].get(), batchKeys[i], *scan.props);
+            ++scan.cnt;
+        }
+        batchReaders.clear();
+        batchKeys.clear();
+        batchVals.clear();
+        return more;
+    };
+
+    int64_t visited = 0;
+    bool stopped = false;
     for (; iter->valid(); iter->next()) {
-        if (!FLAGS_enable_reservoir_sampling
-                && !(cnt < FLAGS_max_edge_returned_per_vertex)) {
+        if (!sampling && !(scan.cnt < scan.maxCnt)) {
             break;
         }
         auto key = iter->key();
         auto val = iter->val();
         auto rank = NebulaKeyUtils::getRank(key);
         auto dstId = NebulaKeyUtils::getDstId(key);
-        if (!firstLoop && rank == lastRank && lastDstId == dstId) {
+        if (!scan.firstLoop && rank == scan.lastRank && scan.lastDstId == dstId) {
             VLOG(3) << "Only get the latest version for each edge.";
             continue;
         }
-        lastRank = rank;
-        lastDstId = dstId;
+        if (visited >= limit) {
+            stopped = true;
+            break;
+        }
+        ++visited;
+        scan.lastRank = rank;
+        scan.lastDstId = dstId;
+
+        if (batched) {
+            batchKeys.emplace_back(key.str());
+            batchVals.emplace_back(val.str());
+            scan.firstLoop = false;
+            if (batchKeys.size() >= static_cast<size_t>(FLAGS_edge_filter_batch_size)
+                    && !flushBatch()) {
+                break;
+            }
+            continue;
+        }
+
         std::unique_ptr<RowReader> reader;
-        if (!onlyStructure
+        if (!scan.onlyStructure
                 && !val.empty()) {
-            reader = RowReader::getEdgePropReader(this->schemaMan_,
+            reader = RowReader::getEdgePropReader(scan.schemas,
                                                   val,
                                                   spaceId_,
                                                   std::abs(edgeType));
+            if (reader == nullptr) {
+                VLOG(3) << "The schema of the edge is not found.";
+                continue;
+            }
             // Check if ttl data expired
             if (retTTL.has_value() && checkDataExpiredForTTL(schema.get(),
                                                              reader.get(),
@@ -534,103 +737,223 @@ kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::collectEdgeProps(
                     continue;
             }
 
-            if (exp_ != nullptr) {
-                getters.getAliasProp = [this, edgeType, &reader, &key](const std::string& edgeName,
-                                           const std::string& prop) -> OptVariantType {
-                    auto edgeFound = this->edgeMap_.find(edgeName);
-                    if (edgeFound == edgeMap_.end()) {
-                        return Status::Error(
-                                "Edge `%s' not found when call getters.", edgeName.c_str());
-                    }
-                    if (std::abs(edgeType) != edgeFound->second) {
-                        return Status::Error("Ignore this edge");
-                    }
+            if (filter != nullptr
+                    && !filter->accept(*scan.filterCtx,
+                                       EdgeFilter::Edge{key, reader.get(), rank, dstId})) {
+                VLOG(1) << "Filter the edge "
+                        << vId << "-> " << dstId << "@" << rank << ":" << edgeType;
+                continue;
+            }
+        }
 
-                    if (prop == _SRC) {
-                        return NebulaKeyUtils::getSrcId(key);
-                    } else if (prop == _DST) {
-                        return NebulaKeyUtils::getDstId(key);
-                    } else if (prop == _RANK) {
-                        return NebulaKeyUtils::getRank(key);
-                    } else if (prop == _TYPE) {
-                        return static_cast<int64_t>(NebulaKeyUtils::getEdgeType(key));
-                    }
+        if (sampling) {
+            scan.sampler->sampling(std::make_pair(key.str(), val.str()));
+        } else {
+            scan.proc(reader.get(), key, *scan.props);
+        }
+        ++scan.cnt;
+        if (scan.firstLoop) {
+            scan.firstLoop = false;
+        }
+    }
+    if (batched && !batchKeys.empty() && !flushBatch()) {
+        return false;
+    }
+    return stopped;
+}
 
-                    auto res = RowReader::getPropByName(reader.get(), prop);
-                    if (!ok(res)) {
-                        return Status::Error("Invalid Prop");
-                    }
-                    return value(std::move(res));
-                };
-                getters.getEdgeRank = [&rank] () -> VariantType {
-                    return rank;
-                };
-                getters.getEdgeDstId = [this,
-                                        &edgeType,
-                                        &dstId] (const std::string& edgeName) -> OptVariantType {
-                    auto edgeFound = this->edgeMap_.find(edgeName);
-                    if (edgeFound == edgeMap_.end()) {
-                        return Status::Error(
-                                "Edge `%s' not found when call getters.", edgeName.c_str());
-                    }
-                    if (std::abs(edgeType) != edgeFound->second) {
-                        return Status::Error("Ignore this edge");
-                    }
-                    return dstId;
-                };
-                getters.getSrcTagProp = [&fcontext] (const std::string& tag,
-                                                     const std::string& prop) -> OptVariantType {
-                    auto it = fcontext->tagFilters_.find(std::make_pair(tag, prop));
-                    if (it == fcontext->tagFilters_.end()) {
-                        return Status::Error("Invalid Tag Filter");
+template<typename REQ, typename RESP>
+std::vector<std::string> QueryBaseProcessor<REQ, RESP>::splitEdgeRange(
+                                                            PartitionID partId,
+                                                            const std::string& prefix,
+                                                            const std::string& start,
+                                                            const std::string& end,
+                                                            int32_t num) {
+    // The (rank, dst) after the prefix is taken as a 128-bit big endian number,
+    // which keeps the order of the keys.
+    using Suffix = unsigned __int128;
+    constexpr size_t kSuffixLen = sizeof(EdgeRanking) + sizeof(VertexID);
+    static_assert(sizeof(Suffix) == kSuffixLen, "The suffix should be 128 bits");
+    auto toSuffix = [&prefix] (const std::string& key) {
+        Suffix suffix = 0;
+        for (size_t i = 0; i < kSuffixLen; i++) {
+            suffix = (suffix << 8) | static_cast<uint8_t>(key[prefix.size() + i]);
+        }
+        return suffix;
+    };
+    auto toKey = [&prefix] (Suffix suffix) {
+        std::string key = prefix;
+        key.resize(prefix.size() + kSuffixLen);
+        for (size_t i = 0; i < kSuffixLen; i++) {
+            key[key.size() - 1 - i] = static_cast<char>(suffix & 0xFF);
+            suffix >>= 8;
+        }
+        return key;
+    };
+
+    // Find the (rank, dst) of the last edge bit by bit, which is the largest suffix
+    // that still has keys at or after it.
+    Suffix last = 0;
+    auto ctx = readContext(partId);
+    for (int32_t bit = kSuffixLen * 8 - 1; bit >= 0; bit--) {
+        auto candidate = last | (static_cast<Suffix>(1) << bit);
+        auto key = toKey(candidate);
+        std::unique_ptr<kvstore::KVIterator> iter;
+        auto ret = this->kvstore_->range(spaceId_, partId, key, end, &iter, ctx);
+        if (ret == kvstore::ResultCode::SUCCEEDED && iter && iter->valid()) {
+            last = candidate;
+        }
+    }
+
+    // Split evenly between the first and the last edge. The keys are not distributed
+    // evenly in general, but the low bytes of the little endian dst usually are.
+    std::vector<std::string> bounds{start};
+    auto first = toSuffix(start);
+    if (num > 1 && last > first) {
+        auto step = (last - first) / num;
+        for (int32_t i = 1; i < num && step > 0; i++) {
+            bounds.emplace_back(toKey(first + step * i));
+        }
+    }
+    bounds.emplace_back(end);
+    return bounds;
+}
+
+template<typename REQ, typename RESP>
+kvstore::ResultCode QueryBaseProcessor<REQ, RESP>::scanEdgeRanges(
+                                                    PartitionID partId,
+                                                    VertexID vId,
+                                                    const std::vector<std::string>& bounds,
+                                                    std::vector<std::unique_ptr<EdgeScan>>& scans) {
+    // scans[0] has scanned the edges before bounds[0]
+    auto num = bounds.size() - 1;
+    CHECK_EQ(num + 1, scans.size());
+    // The current thread takes the ranges as well, and it only waits for the ranges which
+    // are being scanned, so it never waits for a worker thread blocked by itself.
+    // The tasks which start late find no range left, and touch nothing but the shared state.
+    struct Shared {
+        std::atomic<size_t>     next{0};
+        std::atomic<size_t>     finished{0};
+        folly::Baton<>          done;
+    };
+    auto shared = std::make_shared<Shared>();
+    std::vector<kvstore::ResultCode> codes(num, kvstore::ResultCode::SUCCEEDED);
+    auto work = [this, partId, vId, num, &bounds, &scans, &codes] (Shared* s, bool worker) {
+        // Pinned once a range is taken, so the tasks which start late don't touch it
+        std::unique_ptr<meta::PinnedSchemas> schemas;
+        size_t i;
+        while ((i = s->next.fetch_add(1)) < num) {
+            std::unique_ptr<kvstore::KVIterator> iter;
+            codes[i] = this->kvstore_->range(spaceId_,
+                                             partId,
+                                             bounds[i],
+                                             bounds[i + 1],
+                                             &iter,
+                                             readContext(partId));
+            if (codes[i] == kvstore::ResultCode::SUCCEEDED && iter) {
+                auto& scan = *scans[i + 1];
+                if (worker) {
+                    if (schemas == nullptr) {
+                        schemas = std::make_unique<meta::PinnedSchemas>(this->schemaMan_);
                     }
-                    VLOG(1) << "Hit srcProp filter for tag " << tag << ", prop "
-                            << prop << ", value " << it->second;
-                    return it->second;
-                };
-                auto value = exp_->eval(getters);
-                if (value.ok() && !Expression::asBool(value.value())) {
-                    VLOG(1) << "Filter the edge "
-                            << vId << "-> " << dstId << "@" << rank << ":" << edgeType;
-                    continue;
+                    scan.schemas = schemas.get();
                 }
+                scanEdges(vId, scan, iter.get(), std::numeric_limits<int64_t>::max());
+            }
+            if (s->finished.fetch_add(1) + 1 == num) {
+                s->done.post();
             }
         }
-
-        if (FLAGS_enable_reservoir_sampling) {
-            sampler->sampling(std::make_pair(std::move(reader), key.str()));
-        } else {
-            proc(reader.get(), key, props);
+    };
+    if (executor_ != nullptr) {
+        for (size_t i = 1; i < num; i++) {
+            executor_->add([shared, work] () {
+                work(shared.get(), true);
+            });
         }
-        ++cnt;
-        if (firstLoop) {
-            firstLoop = false;
+    }
+    work(shared.get(), false);
+    shared->done.wait();
+
+    for (auto code : codes) {
+        if (code != kvstore::ResultCode::SUCCEEDED) {
+            return code;
         }
     }
+    return kvstore::ResultCode::SUCCEEDED;
+}
 
-    if (FLAGS_enable_reservoir_sampling) {
-        auto samples = std::move(*sampler).samples();
+template<typename REQ, typename RESP>
+void QueryBaseProcessor<REQ, RESP>::processSamples(std::vector<std::unique_ptr<EdgeScan>>& scans,
+                                                   EdgeProcessor& proc) {
+    auto& first = *scans[0];
+    auto process = [&] (std::pair<std::string, std::string>& sample) {
+        std::unique_ptr<RowReader> reader;
+        if (!first.onlyStructure && !sample.second.empty()) {
+            reader = RowReader::getEdgePropReader(first.schemas,
+                                                  sample.second,
+                                                  spaceId_,
+                                                  std::abs(first.edgeType));
+            if (reader == nullptr) {
+                VLOG(3) << "The schema of the edge is not found.";
+                return;
+            }
+        }
+        proc(reader.get(), sample.first, *first.props);
+    };
+
+    if (scans.size() == 1) {
+        auto samples = std::move(*first.sampler).samples();
         for (auto& sample : samples) {
-            proc(sample.first.get(), sample.second, props);
+            process(sample);
         }
+        return;
     }
 
-    return ret;
+    // Each scan holds a uniform sample of its own edges. Draw the edges one by one: pick
+    // a scan with the probability of its share of the edges not drawn yet, and take the
+    // next sample of it in a random order.
+    std::vector<std::vector<std::pair<std::string, std::string>>> pools;
+    std::vector<int64_t> remains;
+    std::vector<size_t> taken(scans.size(), 0);
+    int64_t total = 0;
+    for (auto& scan : scans) {
+        pools.emplace_back(std::move(*scan->sampler).samples());
+        std::shuffle(pools.back().begin(), pools.back().end(), folly::ThreadLocalPRNG());
+        remains.emplace_back(scan->cnt);
+        total += scan->cnt;
+    }
+    auto num = std::min<int64_t>(total, FLAGS_max_edge_returned_per_vertex);
+    for (int64_t k = 0; k < num; k++) {
+        auto r = static_cast<int64_t>(folly::Random::rand64(total));
+        size_t i = 0;
+        while (r >= remains[i]) {
+            r -= remains[i];
+            ++i;
+        }
+        process(pools[i][taken[i]++]);
+        --remains[i];
+        --total;
+    }
 }
 
 template<typename REQ, typename RESP>
 folly::Future<std::vector<OneVertexResp>>
-QueryBaseProcessor<REQ, RESP>::asyncProcessBucket(Bucket bucket) {
+QueryBaseProcessor<REQ, RESP>::asyncProcessBucket(size_t bucketIdx, Bucket bucket) {
     folly::Promise<std::vector<OneVertexResp>> pro;
     auto f = pro.getFuture();
-    executor_->add([this, p = std::move(pro), b = std::move(bucket)] () mutable {
+    executor_->add([this, bucketIdx, p = std::move(pro), b = std::move(bucket)] () mutable {
+        // Every edge read by the bucket is of one of the schemas pinned here
+        meta::PinnedSchemas schemas(this->schemaMan_);
+        bucketSchemas() = &schemas;
         std::vector<OneVertexResp> codes;
         codes.reserve(b.vertices_.size());
         for (auto& pv : b.vertices_) {
             codes.emplace_back(pv.first,
                                pv.second,
-                               processVertex(pv.first, pv.second));
+                               processVertex(pv.first, pv.second, bucketIdx));
         }
+        bucketSchemas() = nullptr;
         p.setValue(std::move(codes));
     });
     return f;
@@ -644,13 +967,59 @@ int32_t QueryBaseProcessor<REQ, RESP>::getBucketsNum(int32_t verticesNum,
 }
 
 template<typename REQ, typename RESP>
-std::vector<Bucket> QueryBaseProcessor<REQ, RESP>::genBuckets(
+std::vector<std::pair<PartitionID, VertexID>> QueryBaseProcessor<REQ, RESP>::pageVertices(
                                                     const cpp2::GetNeighborsRequest& req) {
-    std::vector<Bucket> buckets;
-    int32_t verticesNum = 0;
+    std::vector<std::pair<PartitionID, VertexID>> vertices;
+    if (!req.__isset.limit || req.limit <= 0) {
+        for (auto& pv : req.get_parts()) {
+            for (auto& vId : pv.second) {
+                vertices.emplace_back(pv.first, vId);
+            }
+        }
+        return vertices;
+    }
+
+    // The vertices are paged in the order of (partId, the order in the request),
+    // and the cursor is the number of vertices in the previous pages.
+    int64_t offset = 0;
+    if (req.__isset.cursor && req.cursor.size() == sizeof(int64_t)) {
+        memcpy(&offset, req.cursor.data(), sizeof(int64_t));
+    }
+    std::vector<PartitionID> partIds;
+    partIds.reserve(req.get_parts().size());
     for (auto& pv : req.get_parts()) {
-        verticesNum += pv.second.size();
+        partIds.emplace_back(pv.first);
     }
+    std::sort(partIds.begin(), partIds.end());
+
+    int64_t index = 0;
+    for (auto partId : partIds) {
+        auto& vIds = req.get_parts().at(partId);
+        if (index + static_cast<int64_t>(vIds.size()) <= offset) {
+            index += vIds.size();
+            continue;
+        }
+        for (auto& vId : vIds) {
+            if (index >= offset) {
+                if (vertices.size() >= static_cast<size_t>(req.limit)) {
+                    nextCursor_.assign(std::string(reinterpret_cast<const char*>(&index),
+                                                   sizeof(int64_t)));
+                    return vertices;
+                }
+                vertices.emplace_back(partId, vId);
+            }
+            ++index;
+        }
+    }
+    return vertices;
+}
+
+template<typename REQ, typename RESP>
+std::vector<Bucket> QueryBaseProcessor<REQ, RESP>::genBuckets(
+                                                    const cpp2::GetNeighborsRequest& req) {
+    std::vector<Bucket> buckets;
+    auto vertices = pageVertices(req);
+    int32_t verticesNum = vertices.size();
     auto bucketsNum = getBucketsNum(verticesNum,
                                     FLAGS_min_vertices_per_bucket,
                                     FLAGS_max_handlers_per_req);
@@ -659,16 +1028,14 @@ std::vector<Bucket> QueryBaseProcessor<REQ, RESP>::genBuckets(
     auto leftVertices = verticesNum % bucketsNum;
     int32_t bucketIndex = -1;
     size_t thresHold = vNumPerBucket;
-    for (auto& pv : req.get_parts()) {
-        for (auto& vId : pv.second) {
-            if (bucketIndex < 0 || buckets[bucketIndex].vertices_.size() >= thresHold) {
-                ++bucketIndex;
-                thresHold = bucketIndex < leftVertices ? vNumPerBucket + 1 : vNumPerBucket;
-                buckets[bucketIndex].vertices_.reserve(thresHold);
-            }
-            CHECK_LT(bucketIndex, bucketsNum);
-            buckets[bucketIndex].vertices_.emplace_back(pv.first, vId);
+    for (auto& pv : vertices) {
+        if (bucketIndex < 0 || buckets[bucketIndex].vertices_.size() >= thresHold) {
+            ++bucketIndex;
+            thresHold = bucketIndex < leftVertices ? vNumPerBucket + 1 : vNumPerBucket;
+            buckets[bucketIndex].vertices_.reserve(thresHold);
         }
+        CHECK_LT(bucketIndex, bucketsNum);
+        buckets[bucketIndex].vertices_.emplace_back(pv);
     }
     return buckets;
 }
@@ -803,6 +1170,44 @@ void QueryBaseProcessor<REQ, RESP>::buildTTLInfoAndRespSchema() {
     }
 }
 
+template<typename REQ, typename RESP>
+folly::Future<folly::Unit> QueryBaseProcessor<REQ, RESP>::prepareFollowerReads(
+        const std::unordered_map<PartitionID, std::vector<VertexID>>& parts) {
+    if (!FLAGS_enable_follower_read) {
+        return folly::makeFuture();
+    }
+    // The leaders are answered at once by readIndex, so the followers are all waited together
+    std::vector<PartitionID> partIds;
+    std::vector<folly::Future<kvstore::ResultCode>> results;
+    for (auto& part : parts) {
+        partIds.emplace_back(part.first);
+        results.emplace_back(this->kvstore_->readIndex(spaceId_, part.first));
+    }
+    if (results.empty()) {
+        return folly::makeFuture();
+    }
+    CHECK_NOTNULL(executor_);
+    return folly::collectAll(results).via(executor_).thenValue([
+                this,
+                partIds = std::move(partIds)] (auto&& tries) {
+        for (size_t i = 0; i < tries.size(); i++) {
+            auto ret = tries[i].hasException() ? kvstore::ResultCode::ERR_LEADER_CHANGED
+                                               : tries[i].value();
+            // The reads of the parts failed are rejected by the follower as usual,
+            // so the client is redirected to the leader
+            if (ret == kvstore::ResultCode::SUCCEEDED) {
+                auto partRet = this->kvstore_->part(spaceId_, partIds[i]);
+                if (nebula::ok(partRet) && !nebula::value(partRet)->isLeader()) {
+                    followerReadParts_.emplace(partIds[i]);
+                }
+            } else {
+                VLOG(1) << "Could not serve the follower read of space " << spaceId_
+                        << ", part " << partIds[i] << ", error " << static_cast<int32_t>(ret);
+            }
+        }
+    });
+}
+
 template<typename REQ, typename RESP>
 void QueryBaseProcessor<REQ, RESP>::process(const cpp2::GetNeighborsRequest& req) {
     CHECK_NOTNULL(executor_);
@@ -830,9 +1235,22 @@ void QueryBaseProcessor<REQ, RESP>::process(const cpp2::GetNeighborsRequest& req
 
     // const auto& filter = req.get_filter();
     auto buckets = genBuckets(req);
+    prepareBuckets(buckets.size());
+    // The request is not kept once returned, the buckets are processed by the continuation
+    prepareFollowerReads(req.get_parts()).thenValue([
+                this,
+                returnColumnsNum,
+                buckets = std::move(buckets)] (auto&&) mutable {
+        processBuckets(std::move(buckets), returnColumnsNum);
+    });
+}
+
+template<typename REQ, typename RESP>
+void QueryBaseProcessor<REQ, RESP>::processBuckets(std::vector<Bucket> buckets,
+                                                   int32_t returnColumnsNum) {
     std::vector<folly::Future<std::vector<OneVertexResp>>> results;
-    for (auto& bucket : buckets) {
-        results.emplace_back(asyncProcessBucket(std::move(bucket)));
+    for (size_t i = 0; i < buckets.size(); i++) {
+        results.emplace_back(asyncProcessBucket(i, std::move(buckets[i])));
     }
     folly::collectAll(results).via(executor_).thenTry([
                      this,
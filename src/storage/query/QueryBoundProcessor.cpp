@@ -11,6 +11,7 @@
 #include "dataman/RowWriter.h"
 
 DEFINE_int32(reserved_edges_one_vertex, 1024, "reserve edges for one vertex");
+DECLARE_int32(max_edge_returned_per_vertex);
 
 namespace nebula {
 namespace storage {
@@ -33,9 +34,12 @@ kvstore::ResultCode QueryBoundProcessor::processEdgeImpl(const PartitionID partI
     }
     std::vector<cpp2::IdAndProp> edges;
     edges.reserve(FLAGS_reserved_edges_one_vertex);
-    auto ret = collectEdgeProps(
-        partId, vId, edgeType, props, &fcontext,
-        [&, this](RowReader* reader, folly::StringPiece k, const std::vector<PropContext>& p) {
+    // The edges of each range, when the edges of a super vertex are scanned in parallel
+    std::vector<std::vector<cpp2::IdAndProp>> rangeEdges;
+    auto makeProc = [&, this] (std::vector<cpp2::IdAndProp>* output) -> EdgeProcessor {
+        return [&, this, output] (RowReader* reader,
+                                  folly::StringPiece k,
+                                  const std::vector<PropContext>& p) {
             cpp2::IdAndProp edge;
             if (!onlyStructure) {
                 RowWriter writer(currEdgeSchema);
@@ -48,11 +52,31 @@ kvstore::ResultCode QueryBoundProcessor::processEdgeImpl(const PartitionID partI
                 this->collectProps(reader, k, p, &fcontext, &collector);
                 edge.set_dst(collector.getDstId());
             }
-            edges.emplace_back(std::move(edge));
+            output->emplace_back(std::move(edge));
+        };
+    };
+    auto ret = collectEdgeProps(
+        partId, vId, edgeType, props, &fcontext, makeProc(&edges),
+        [&] (size_t num) {
+            rangeEdges.resize(num);
+            std::vector<EdgeProcessor> procs;
+            procs.reserve(num);
+            for (auto& output : rangeEdges) {
+                procs.emplace_back(makeProc(&output));
+            }
+            return procs;
         });
     if (ret != kvstore::ResultCode::SUCCEEDED) {
         return ret;
     }
+    for (auto& output : rangeEdges) {
+        for (auto& edge : output) {
+            if (edges.size() >= static_cast<size_t>(FLAGS_max_edge_returned_per_vertex)) {
+                break;
+            }
+            edges.emplace_back(std::move(edge));
+        }
+    }
     if (!edges.empty()) {
         cpp2::EdgeData edgeData;
         edgeData.set_type(edgeType);
@@ -80,7 +104,14 @@ kvstore::ResultCode QueryBoundProcessor::processEdge(PartitionID partId, VertexI
     return kvstore::ResultCode::SUCCEEDED;
 }
 
-kvstore::ResultCode QueryBoundProcessor::processVertex(PartitionID partId, VertexID vId) {
+void QueryBoundProcessor::prepareBuckets(size_t bucketsNum) {
+    bucketResults_.resize(bucketsNum);
+}
+
+kvstore::ResultCode QueryBoundProcessor::processVertex(PartitionID partId,
+                                                       VertexID vId,
+                                                       size_t bucketIdx) {
+    auto& result = bucketResults_[bucketIdx];
     cpp2::VertexData vResp;
     vResp.set_vertex_id(vId);
     FilterContext fcontext;
@@ -114,8 +145,7 @@ kvstore::ResultCode QueryBoundProcessor::processVertex(PartitionID partId, Verte
     }
 
     if (onlyVertexProps_) {
-        std::lock_guard<std::mutex> lg(this->lock_);
-        vertices_.emplace_back(std::move(vResp));
+        result.vertices.emplace_back(std::move(vResp));
         return kvstore::ResultCode::SUCCEEDED;
     }
 
@@ -127,11 +157,10 @@ kvstore::ResultCode QueryBoundProcessor::processVertex(PartitionID partId, Verte
 
     if (!vResp.edge_data.empty()) {
         // Only return the vertex if edges existed.
-        std::lock_guard<std::mutex> lg(this->lock_);
         for (auto& edata : vResp.edge_data) {
-            totalEdges_ += edata.edges.size();
+            result.totalEdges += edata.edges.size();
         }
-        vertices_.emplace_back(std::move(vResp));
+        result.vertices.emplace_back(std::move(vResp));
     }
 
     return kvstore::ResultCode::SUCCEEDED;
@@ -139,8 +168,20 @@ kvstore::ResultCode QueryBoundProcessor::processVertex(PartitionID partId, Verte
 
 void QueryBoundProcessor::onProcessFinished(int32_t retNum) {
     (void)retNum;
-    resp_.set_vertices(std::move(vertices_));
-    resp_.set_total_edges(totalEdges_);
+    size_t verticesNum = 0;
+    for (auto& result : bucketResults_) {
+        verticesNum += result.vertices.size();
+    }
+    std::vector<cpp2::VertexData> vertices;
+    vertices.reserve(verticesNum);
+    int32_t totalEdges = 0;
+    for (auto& result : bucketResults_) {
+        std::move(result.vertices.begin(), result.vertices.end(), std::back_inserter(vertices));
+        totalEdges += result.totalEdges;
+    }
+    bucketResults_.clear();
+    resp_.set_vertices(std::move(vertices));
+    resp_.set_total_edges(totalEdges);
     if (!vertexSchemaResp_.empty()) {
         resp_.set_vertex_schema(std::move(vertexSchemaResp_));
     }
@@ -148,6 +189,10 @@ void QueryBoundProcessor::onProcessFinished(int32_t retNum) {
     if (!edgeSchemaResp_.empty()) {
         resp_.set_edge_schema(std::move(edgeSchemaResp_));
     }
+
+    if (nextCursor_.hasValue()) {
+        resp_.set_next_cursor(std::move(nextCursor_).value());
+    }
 }
 
 }  // namespace storage
@@ -9,6 +9,8 @@
 
 #include "base/Base.h"
 #include <gtest/gtest_prod.h>
+#include <folly/Memory.h>
+#include <folly/lang/Align.h>
 #include "storage/query/QueryBaseProcessor.h"
 
 namespace nebula {
@@ -37,12 +39,25 @@ protected:
         : QueryBaseProcessor<cpp2::GetNeighborsRequest,
                              cpp2::QueryResponse>(kvstore, schemaMan, stats, executor, cache) {}
 
-    kvstore::ResultCode processVertex(PartitionID partId, VertexID vId) override;
+    void prepareBuckets(size_t bucketsNum) override;
+
+    kvstore::ResultCode processVertex(PartitionID partId, VertexID vId, size_t bucketIdx) override;
 
     void onProcessFinished(int32_t retNum) override;
 
 private:
-    std::vector<cpp2::VertexData> vertices_;
+    // The results of one bucket, only touched by the thread processing the bucket.
+    // Each one takes its own cache lines, so the buckets don't write the same line.
+    struct alignas(folly::hardware_destructive_interference_size) BucketResult {
+        std::vector<cpp2::VertexData>   vertices;
+        int32_t                         totalEdges{0};
+    };
+
+    // std::allocator doesn't honor the alignment beyond max_align_t before C++17
+    std::vector<BucketResult,
+                folly::AlignedSysAllocator<BucketResult,
+                                           folly::FixedAlign<alignof(BucketResult)>>>
+        bucketResults_;
 
     kvstore::ResultCode processEdge(PartitionID partId, VertexID vId, FilterContext &fcontext,
                                     cpp2::VertexData& vdata);
@@ -54,7 +69,6 @@ private:
 protected:
     // Indicate the request only get vertex props.
     bool onlyVertexProps_ = false;
-    int32_t totalEdges_ = 0;
 };
 
 }  // namespace storage
@@ -67,7 +67,9 @@ void QueryStatsProcessor::calcResult(std::vector<PropContext>&& props) {
 
 
 kvstore::ResultCode QueryStatsProcessor::processVertex(PartitionID partId,
-                                                       VertexID vId) {
+                                                       VertexID vId,
+                                                       size_t bucketIdx) {
+    UNUSED(bucketIdx);
     FilterContext fcontext;
     for (auto& tc : tagContexts_) {
         auto ret = this->collectVertexProps(partId,
@@ -37,7 +37,7 @@ private:
                                                        executor,
                                                        cache) {}
 
-    kvstore::ResultCode processVertex(PartitionID partId, VertexID vId) override;
+    kvstore::ResultCode processVertex(PartitionID partId, VertexID vId, size_t bucketIdx) override;
 
     void onProcessFinished(int32_t retNum) override;
 
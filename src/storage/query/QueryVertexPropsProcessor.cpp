@@ -29,32 +29,40 @@ void QueryVertexPropsProcessor::process(const cpp2::VertexPropRequest& vertexReq
         this->onlyVertexProps_ = true;
         QueryBoundProcessor::process(req);
     } else {
-        std::vector<cpp2::VertexData> vertices;
-        for (auto& part : vertexReq.get_parts()) {
-            auto partId = part.first;
-            for (auto& vId : part.second) {
-                cpp2::VertexData vResp;
-                vResp.set_vertex_id(vId);
-                std::vector<cpp2::TagData> td;
-                auto ret = collectVertexProps(partId, vId, td);
-                if (ret != kvstore::ResultCode::ERR_KEY_NOT_FOUND
-                        && ret != kvstore::ResultCode::SUCCEEDED) {
-                    if (ret == kvstore::ResultCode::ERR_LEADER_CHANGED) {
-                        this->handleLeaderChanged(spaceId_, partId);
-                    } else {
-                        this->pushResultCode(this->to(ret), partId);
-                    }
-                    continue;
+        auto parts = vertexReq.get_parts();
+        prepareFollowerReads(parts).thenValue([this, parts] (auto&&) {
+            collectVertices(parts);
+        });
+    }
+}
+
+void QueryVertexPropsProcessor::collectVertices(
+        const std::unordered_map<PartitionID, std::vector<VertexID>>& parts) {
+    std::vector<cpp2::VertexData> vertices;
+    for (auto& part : parts) {
+        auto partId = part.first;
+        for (auto& vId : part.second) {
+            cpp2::VertexData vResp;
+            vResp.set_vertex_id(vId);
+            std::vector<cpp2::TagData> td;
+            auto ret = collectVertexProps(partId, vId, td);
+            if (ret != kvstore::ResultCode::ERR_KEY_NOT_FOUND
+                    && ret != kvstore::ResultCode::SUCCEEDED) {
+                if (ret == kvstore::ResultCode::ERR_LEADER_CHANGED) {
+                    this->handleLeaderChanged(spaceId_, partId);
+                } else {
+                    this->pushResultCode(this->to(ret), partId);
                 }
-                VLOG(3) << "Vid: " << vId << " found tag size: " << td.size();
-                vResp.set_tag_data(std::move(td));
-                vertices.emplace_back(std::move(vResp));
+                continue;
             }
+            VLOG(3) << "Vid: " << vId << " found tag size: " << td.size();
+            vResp.set_tag_data(std::move(td));
+            vertices.emplace_back(std::move(vResp));
         }
-        VLOG(3) << "Seek vertices num: " << vertices.size();
-        resp_.set_vertices(std::move(vertices));
-        onFinished();
     }
+    VLOG(3) << "Seek vertices num: " << vertices.size();
+    resp_.set_vertices(std::move(vertices));
+    onFinished();
 }
 
 kvstore::ResultCode QueryVertexPropsProcessor::collectVertexProps(
@@ -63,7 +71,8 @@ kvstore::ResultCode QueryVertexPropsProcessor::collectVertexProps(
                             std::vector<cpp2::TagData> &tds) {
     auto prefix = NebulaKeyUtils::vertexPrefix(partId, vId);
     std::unique_ptr<kvstore::KVIterator> iter;
-    auto ret = this->kvstore_->prefix(spaceId_, partId, prefix, &iter);
+    auto ctx = readContext(partId);
+    auto ret = this->kvstore_->prefix(spaceId_, partId, prefix, &iter, ctx);
     if (ret != kvstore::ResultCode::SUCCEEDED) {
         return ret;
     }
@@ -106,7 +115,7 @@ kvstore::ResultCode QueryVertexPropsProcessor::collectVertexProps(
             continue;
         }
         auto valStr = val.str();
-        if (FLAGS_enable_vertex_cache && vertexCache_ != nullptr) {
+        if (FLAGS_enable_vertex_cache && vertexCache_ != nullptr && !ctx.followerRead_) {
             vertexCache_->insert(std::make_pair(vId, tagId),
                                  valStr, partId);
             VLOG(3) << "Insert cache for vId " << vId << ", tagId " << tagId;
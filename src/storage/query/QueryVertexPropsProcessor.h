@@ -33,6 +33,8 @@ private:
                                        VertexCache* cache)
         : QueryBoundProcessor(kvstore, schemaMan, stats, executor, cache) {}
 
+    void collectVertices(const std::unordered_map<PartitionID, std::vector<VertexID>>& parts);
+
     kvstore::ResultCode collectVertexProps(
                             PartitionID partId,
                             VertexID vId,
@@ -38,8 +38,11 @@ void ScanEdgeProcessor::process(const cpp2::ScanEdgeRequest& req) {
         start = *req.get_cursor();
     }
 
+    // The scan touches each block once, don't let it evict the hot blocks
+    kvstore::ReadContext ctx;
+    ctx.fillCache_ = false;
     std::unique_ptr<kvstore::KVIterator> iter;
-    auto kvRet = doRangeWithPrefix(spaceId_, partId_, start, prefix, &iter);
+    auto kvRet = doRangeWithPrefix(spaceId_, partId_, start, prefix, &iter, ctx);
     if (kvRet != kvstore::ResultCode::SUCCEEDED) {
         pushResultCode(to(kvRet), partId_);
         onFinished();
@@ -0,0 +1,264 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "base/NebulaKeyUtils.h"
+#include <gtest/gtest.h>
+#include "dataman/RowWriter.h"
+#include "dataman/RowReader.h"
+#include "dataman/SchemaWriter.h"
+#include "storage/query/EdgeFilter.h"
+
+namespace nebula {
+namespace storage {
+
+class EdgeFilterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        schema_ = mockSchema(0);
+        edgeMap_.emplace("e1", 101);
+        edgeMap_.emplace("e2", 102);
+        key_ = NebulaKeyUtils::edgeKey(0, 1, 101, 0, 10007, 0);
+    }
+
+    static std::shared_ptr<SchemaWriter> mockSchema(SchemaVer ver) {
+        auto schema = std::make_shared<SchemaWriter>(ver);
+        schema->appendCol("col_int", nebula::cpp2::SupportedType::INT);
+        schema->appendCol("col_double", nebula::cpp2::SupportedType::DOUBLE);
+        schema->appendCol("col_str", nebula::cpp2::SupportedType::STRING);
+        schema->appendCol("col_bool", nebula::cpp2::SupportedType::BOOL);
+        return schema;
+    }
+
+    std::string encodeRow(int64_t i, double d, const std::string& s, bool b) {
+        RowWriter writer(schema_);
+        writer << i << d << s << b;
+        return writer.encode();
+    }
+
+    bool accept(const Expression* exp,
+                const std::string& row,
+                std::shared_ptr<const meta::SchemaProviderIf> compileSchema = nullptr) {
+        if (compileSchema == nullptr) {
+            compileSchema = schema_;
+        }
+        auto filter = EdgeFilter::compile(exp, 101, compileSchema, &edgeMap_);
+        auto reader = RowReader::getRowReader(row, schema_);
+        EdgeFilter::Context ctx(filter.get(), &fcontext_);
+        return filter->accept(ctx, EdgeFilter::Edge{key_,
+                                                    reader.get(),
+                                                    NebulaKeyUtils::getRank(key_),
+                                                    NebulaKeyUtils::getDstId(key_)});
+    }
+
+    static Expression* edgeProp(const char* alias, const char* prop) {
+        return new AliasPropertyExpression(new std::string(""),
+                                           new std::string(alias),
+                                           new std::string(prop));
+    }
+
+protected:
+    std::shared_ptr<SchemaWriter> schema_;
+    std::unordered_map<std::string, EdgeType> edgeMap_;
+    FilterContext fcontext_;
+    std::string key_;
+};
+
+
+TEST_F(EdgeFilterTest, TypedComparison) {
+    auto row = encodeRow(10, 3.0000000001, "abc", true);
+    {
+        RelationalExpression exp(edgeProp("e1", "col_int"),
+                                 RelationalExpression::GE,
+                                 new PrimaryExpression(10L));
+        EXPECT_TRUE(accept(&exp, row));
+        EXPECT_FALSE(accept(&exp, encodeRow(9, 0.0, "", false)));
+    }
+    {
+        // Compare a double with an int approximately
+        RelationalExpression exp(edgeProp("e1", "col_double"),
+                                 RelationalExpression::EQ,
+                                 new PrimaryExpression(3L));
+        EXPECT_TRUE(accept(&exp, row));
+    }
+    {
+        RelationalExpression exp(new PrimaryExpression(std::string("abc")),
+                                 RelationalExpression::EQ,
+                                 edgeProp("e1", "col_str"));
+        EXPECT_TRUE(accept(&exp, row));
+        EXPECT_FALSE(accept(&exp, encodeRow(10, 0.0, "abd", true)));
+    }
+    {
+        RelationalExpression exp(edgeProp("e1", "col_bool"),
+                                 RelationalExpression::NE,
+                                 new PrimaryExpression(true));
+        EXPECT_FALSE(accept(&exp, row));
+    }
+    {
+        RelationalExpression exp(edgeProp("e1", "_rank"),
+                                 RelationalExpression::GT,
+                                 new PrimaryExpression(0L));
+        EXPECT_FALSE(accept(&exp, row));
+    }
+    {
+        RelationalExpression exp(new EdgeDstIdExpression(new std::string("e1")),
+                                 RelationalExpression::EQ,
+                                 new PrimaryExpression(10007L));
+        EXPECT_TRUE(accept(&exp, row));
+    }
+}
+
+
+TEST_F(EdgeFilterTest, ErrorsKeepEdge) {
+    auto row = encodeRow(10, 3.14, "abc", true);
+    {
+        // A string could not be compared with an int
+        RelationalExpression exp(edgeProp("e1", "col_str"),
+                                 RelationalExpression::GT,
+                                 new PrimaryExpression(1L));
+        EXPECT_TRUE(accept(&exp, row));
+    }
+    {
+        // The alias refers to another edge type
+        RelationalExpression exp(edgeProp("e2", "col_int"),
+                                 RelationalExpression::GT,
+                                 new PrimaryExpression(100L));
+        EXPECT_TRUE(accept(&exp, row));
+    }
+    {
+        // The error on the right side is kept even if the left side is false
+        LogicalExpression exp(new RelationalExpression(edgeProp("e1", "col_int"),
+                                                       RelationalExpression::GT,
+                                                       new PrimaryExpression(100L)),
+                              LogicalExpression::AND,
+                              new RelationalExpression(edgeProp("e1", "not_exist"),
+                                                       RelationalExpression::GT,
+                                                       new PrimaryExpression(100L)));
+        EXPECT_TRUE(accept(&exp, row));
+    }
+}
+
+
+TEST_F(EdgeFilterTest, LogicalAndGeneric) {
+    auto row = encodeRow(10, 3.14, "abc", true);
+    fcontext_.tagFilters_.emplace(std::make_pair("tag", "prop"), 5L);
+    {
+        LogicalExpression exp(new RelationalExpression(edgeProp("e1", "_rank"),
+                                                       RelationalExpression::NE,
+                                                       new PrimaryExpression(0L)),
+                              LogicalExpression::AND,
+                              new RelationalExpression(edgeProp("e1", "col_int"),
+                                                       RelationalExpression::EQ,
+                                                       new PrimaryExpression(10L)));
+        EXPECT_FALSE(accept(&exp, row));
+    }
+    {
+        // The source prop is evaluated through the getters
+        LogicalExpression exp(new RelationalExpression(
+                                  new SourcePropertyExpression(new std::string("tag"),
+                                                               new std::string("prop")),
+                                  RelationalExpression::GT,
+                                  new PrimaryExpression(10L)),
+                              LogicalExpression::OR,
+                              new RelationalExpression(edgeProp("e1", "col_double"),
+                                                       RelationalExpression::LT,
+                                                       new PrimaryExpression(3.0)));
+        EXPECT_FALSE(accept(&exp, row));
+    }
+    {
+        LogicalExpression exp(new RelationalExpression(
+                                  new SourcePropertyExpression(new std::string("tag"),
+                                                               new std::string("prop")),
+                                  RelationalExpression::EQ,
+                                  new PrimaryExpression(5L)),
+                              LogicalExpression::XOR,
+                              new RelationalExpression(edgeProp("e1", "col_str"),
+                                                       RelationalExpression::EQ,
+                                                       new PrimaryExpression(std::string("a"))));
+        EXPECT_TRUE(accept(&exp, row));
+    }
+}
+
+
+TEST_F(EdgeFilterTest, SchemaVersionMismatch) {
+    // The row is written with version 0, while the filter is compiled against version 1,
+    // so the props are read by name.
+    auto row = encodeRow(10, 3.14, "abc", true);
+    auto latest = mockSchema(1);
+    RelationalExpression exp(edgeProp("e1", "col_int"),
+                             RelationalExpression::LT,
+                             new PrimaryExpression(10L));
+    EXPECT_FALSE(accept(&exp, row, latest));
+    RelationalExpression exp2(edgeProp("e1", "col_str"),
+                              RelationalExpression::EQ,
+                              new PrimaryExpression(std::string("abc")));
+    EXPECT_TRUE(accept(&exp2, row, latest));
+}
+
+
+
+TEST_F(EdgeFilterTest, BatchFilter) {
+    // (e1.col_int * 2 + e1.col_double > 20.5) && e1._dst != 3
+    auto* mul = new ArithmeticExpression(edgeProp("e1", "col_int"),
+                                         ArithmeticExpression::MUL,
+                                         new PrimaryExpression(2L));
+    auto* add = new ArithmeticExpression(mul,
+                                         ArithmeticExpression::ADD,
+                                         edgeProp("e1", "col_double"));
+    LogicalExpression exp(new RelationalExpression(add,
+                                                   RelationalExpression::GT,
+                                                   new PrimaryExpression(20.5)),
+                          LogicalExpression::AND,
+                          new RelationalExpression(new EdgeDstIdExpression(new std::string("e1")),
+                                                   RelationalExpression::NE,
+                                                   new PrimaryExpression(3L)));
+    auto filter = EdgeFilter::compile(&exp, 101, schema_, &edgeMap_);
+
+    std::vector<std::string> keys;
+    std::vector<std::string> rows;
+    for (int64_t i = 0; i < 100; i++) {
+        keys.emplace_back(NebulaKeyUtils::edgeKey(0, 1, 101, 0, i, 0));
+        rows.emplace_back(encodeRow(i, 0.5, "abc", true));
+    }
+    // The multiplication overflows, which keeps the edge
+    keys.emplace_back(NebulaKeyUtils::edgeKey(0, 1, 101, 0, 100, 0));
+    rows.emplace_back(encodeRow(std::numeric_limits<int64_t>::max(), 0.5, "abc", true));
+
+    std::vector<std::unique_ptr<RowReader>> readers;
+    std::vector<EdgeFilter::Edge> edges;
+    for (size_t i = 0; i < keys.size(); i++) {
+        readers.emplace_back(RowReader::getRowReader(rows[i], schema_));
+        edges.emplace_back(EdgeFilter::Edge{keys[i],
+                                            readers.back().get(),
+                                            NebulaKeyUtils::getRank(keys[i]),
+                                            NebulaKeyUtils::getDstId(keys[i])});
+    }
+
+    EdgeFilter::Context ctx(filter.get(), &fcontext_);
+    std::vector<uint8_t> selected;
+    filter->filter(ctx, edges, selected);
+    ASSERT_EQ(edges.size(), selected.size());
+    for (size_t i = 0; i < edges.size(); i++) {
+        // The same as evaluating edge by edge
+        EXPECT_EQ(filter->accept(ctx, edges[i]), selected[i] != 0);
+        if (i < 100) {
+            EXPECT_EQ(i * 2 + 0.5 > 20.5 && i != 3, selected[i] != 0) << "edge " << i;
+        } else {
+            EXPECT_TRUE(selected[i]);
+        }
+    }
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+    return RUN_ALL_TESTS();
+}
@@ -969,6 +969,97 @@ TEST(IndexScanTest, PrefixScanTest) {
     }
 }
 
+TEST(IndexScanTest, RangeScanTest) {
+    auto buildRel = [] (const char* colName, const char* aliasName,
+                        RelationalExpression::Operator op, int64_t val) {
+        auto* col = new std::string(colName);
+        auto* alias = new std::string(aliasName);
+        auto* ape = new AliasPropertyExpression(new std::string(""), alias, col);
+        auto* pe = new PrimaryExpression(val);
+        return new RelationalExpression(ape, op, pe);
+    };
+    {
+        LOG(INFO) << "Build filter...";
+        /**
+         * where tag_3001_col_0 >= 1
+         */
+        std::unique_ptr<RelationalExpression> r1(
+            buildRel("tag_3001_col_0", "3001", RelationalExpression::Operator::GE, 1L));
+        auto resp = execLookupVertices(Expression::encode(r1.get()));
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+        EXPECT_EQ(30, resp.rows.size());
+    }
+    {
+        LOG(INFO) << "Build filter...";
+        /**
+         * where tag_3001_col_0 > 1
+         */
+        std::unique_ptr<RelationalExpression> r1(
+            buildRel("tag_3001_col_0", "3001", RelationalExpression::Operator::GT, 1L));
+        auto resp = execLookupVertices(Expression::encode(r1.get()));
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+        EXPECT_EQ(0, resp.rows.size());
+    }
+    {
+        LOG(INFO) << "Build filter...";
+        /**
+         * where tag_3001_col_0 == 1 and
+         *       tag_3001_col_1 < 2
+         */
+        auto* r1 = buildRel("tag_3001_col_0", "3001", RelationalExpression::Operator::EQ, 1L);
+        auto* r2 = buildRel("tag_3001_col_1", "3001", RelationalExpression::Operator::LT, 2L);
+        auto logExp = std::make_unique<LogicalExpression>(r1, LogicalExpression::AND, r2);
+        auto resp = execLookupVertices(Expression::encode(logExp.get()));
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+        EXPECT_EQ(0, resp.rows.size());
+    }
+    {
+        LOG(INFO) << "Build filter...";
+        /**
+         * where tag_3001_col_0 == 1 and
+         *       tag_3001_col_1 <= 2
+         */
+        auto* r1 = buildRel("tag_3001_col_0", "3001", RelationalExpression::Operator::EQ, 1L);
+        auto* r2 = buildRel("tag_3001_col_1", "3001", RelationalExpression::Operator::LE, 2L);
+        auto logExp = std::make_unique<LogicalExpression>(r1, LogicalExpression::AND, r2);
+        auto resp = execLookupVertices(Expression::encode(logExp.get()));
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+        EXPECT_EQ(30, resp.rows.size());
+    }
+    {
+        LOG(INFO) << "Build filter...";
+        /**
+         * where col_0 == 1 and
+         *       col_1 > 1 and
+         *       col_1 < 3
+         */
+        auto* r1 = buildRel("col_0", "101", RelationalExpression::Operator::EQ, 1L);
+        auto* r2 = buildRel("col_1", "101", RelationalExpression::Operator::GT, 1L);
+        auto* r3 = buildRel("col_1", "101", RelationalExpression::Operator::LT, 3L);
+        auto* l1 = new LogicalExpression(r1, LogicalExpression::AND, r2);
+        auto logExp = std::make_unique<LogicalExpression>(l1, LogicalExpression::AND, r3);
+        auto resp = execLookupEdges(Expression::encode(logExp.get()));
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+        EXPECT_EQ(210, resp.rows.size());
+    }
+    {
+        LOG(INFO) << "Build filter...";
+        /**
+         * where col_0 == 1 and
+         *       col_1 > 2 and
+         *       col_1 <= 3
+         */
+        auto* r1 = buildRel("col_0", "101", RelationalExpression::Operator::EQ, 1L);
+        auto* r2 = buildRel("col_1", "101", RelationalExpression::Operator::GT, 2L);
+        auto* r3 = buildRel("col_1", "101", RelationalExpression::Operator::LE, 3L);
+        auto* l1 = new LogicalExpression(r1, LogicalExpression::AND, r2);
+        auto logExp = std::make_unique<LogicalExpression>(l1, LogicalExpression::AND, r3);
+        auto resp = execLookupEdges(Expression::encode(logExp.get()));
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+        EXPECT_EQ(0, resp.rows.size());
+    }
+}
+
 TEST(IndexScanTest, NoReturnColumnsTest) {
     {
         LOG(INFO) << "Build filter...";
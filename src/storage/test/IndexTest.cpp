@@ -130,6 +130,44 @@ TEST(IndexTest, AddEdgeTest) {
     }
 }
 
+TEST(IndexTest, OverwriteEdgeTest) {
+    auto check = [] (bool blindWrite, int32_t expected) {
+        fs::TempDir rootPath("/tmp/OverwriteEdgeTest.XXXXXX");
+        std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
+        auto schemaMan = TestUtils::mockSchemaMan();
+        auto indexMan = TestUtils::mockIndexMan();
+        // Write the same edges twice with different values
+        for (auto fmt : {"%d_%d_%ld_%ld_%d_%ld", "new_%d_%d_%ld_%ld_%d_%ld"}) {
+            auto* processor = AddEdgesProcessor::instance(kv.get(),
+                                                          schemaMan.get(),
+                                                          indexMan.get(),
+                                                          nullptr);
+            cpp2::AddEdgesRequest req;
+            req.space_id = 0;
+            req.overwritable = true;
+            req.index_blind_write = blindWrite;
+            req.parts.emplace(1, TestUtils::setupEdges(1, 10, 20, 101, 1, fmt));
+            auto fut = processor->getFuture();
+            processor->process(req);
+            auto resp = std::move(fut).get();
+            EXPECT_EQ(0, resp.result.failed_codes.size());
+        }
+        auto prefix = NebulaKeyUtils::indexPrefix(1, 201);
+        std::unique_ptr<kvstore::KVIterator> iter;
+        EXPECT_EQ(kvstore::ResultCode::SUCCEEDED, kv->prefix(0, 1, prefix, &iter));
+        int32_t rowCount = 0;
+        while (iter->valid()) {
+            rowCount++;
+            iter->next();
+        }
+        EXPECT_EQ(expected, rowCount);
+    };
+    // The old index entries are replaced
+    check(false, 10);
+    // The old rows are not read, so their index entries are left behind
+    check(true, 20);
+}
+
 TEST(IndexTest, DeleteVertexTest) {
     fs::TempDir rootPath("/tmp/DeleteVertexTest.XXXXXX");
     std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
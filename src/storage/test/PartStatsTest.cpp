@@ -0,0 +1,409 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include "base/NebulaKeyUtils.h"
+#include <gtest/gtest.h>
+#include <folly/synchronization/Baton.h>
+#include "fs/TempDir.h"
+#include "storage/test/TestUtils.h"
+#include "storage/PartStats.h"
+#include "storage/CompactionFilter.h"
+#include "storage/mutate/AddEdgesProcessor.h"
+#include "storage/mutate/AddVerticesProcessor.h"
+#include "storage/mutate/DeleteEdgesProcessor.h"
+#include "storage/mutate/DeleteVerticesProcessor.h"
+#include "storage/query/GetPartStatsProcessor.h"
+#include "kvstore/NebulaStore.h"
+#include "kvstore/SnapshotManagerImpl.h"
+
+DECLARE_int32(snapshot_batch_size);
+DECLARE_int64(snapshot_file_size);
+
+namespace nebula {
+namespace storage {
+
+TEST(PartStatsTest, DegreeBucketTest) {
+    EXPECT_EQ(0, PartStats::degreeBucket(1));
+    EXPECT_EQ(1, PartStats::degreeBucket(2));
+    EXPECT_EQ(1, PartStats::degreeBucket(3));
+    EXPECT_EQ(2, PartStats::degreeBucket(7));
+    EXPECT_EQ(10, PartStats::degreeBucket(1024));
+    EXPECT_EQ(PartStats::kDegreeBuckets - 1,
+              PartStats::degreeBucket(std::numeric_limits<int64_t>::max()));
+}
+
+
+TEST(PartStatsTest, CollectorTest) {
+    PartStatsCollector collector;
+    for (PartitionID partId = 1; partId <= 2; partId++) {
+        for (VertexID vId = 0; vId < 10; vId++) {
+            // Two versions of each tag
+            for (EdgeVersion version = 0; version < 2; version++) {
+                collector.collect(NebulaKeyUtils::vertexKey(partId, vId, 3001, version));
+            }
+            // The vertex vId has vId + 1 out edges of 101, and 3 out edges of 102
+            for (VertexID dstId = 0; dstId <= vId; dstId++) {
+                for (EdgeVersion version = 0; version < 2; version++) {
+                    collector.collect(NebulaKeyUtils::edgeKey(partId, vId, 101, 0, dstId,
+                                                              version));
+                }
+            }
+            for (VertexID dstId = 0; dstId < 3; dstId++) {
+                collector.collect(NebulaKeyUtils::edgeKey(partId, vId, 102, 0, dstId, 0));
+            }
+            // The reverse edges are skipped
+            collector.collect(NebulaKeyUtils::edgeKey(partId, vId, -101, 0, 100, 0));
+        }
+    }
+    auto stats = collector.finish();
+    ASSERT_EQ(2, stats.size());
+    for (PartitionID partId = 1; partId <= 2; partId++) {
+        auto& partStats = stats[partId];
+        ASSERT_EQ(1, partStats.tagVertices.size());
+        EXPECT_EQ(10, partStats.tagVertices[3001]);
+        ASSERT_EQ(2, partStats.edgeCounts.size());
+        EXPECT_EQ(55, partStats.edgeCounts[101]);
+        EXPECT_EQ(30, partStats.edgeCounts[102]);
+
+        // Degrees 1, 2-3, 4-7, 8-10
+        const auto& hist = partStats.degreeHistograms[101];
+        ASSERT_EQ(PartStats::kDegreeBuckets, hist.size());
+        EXPECT_EQ(1, hist[0]);
+        EXPECT_EQ(2, hist[1]);
+        EXPECT_EQ(4, hist[2]);
+        EXPECT_EQ(3, hist[3]);
+        EXPECT_EQ(10, partStats.degreeHistograms[102][1]);
+        EXPECT_EQ(0, partStats.degreeHistograms.count(-101));
+    }
+}
+
+
+TEST(PartStatsTest, EncodeTest) {
+    PartStats stats;
+    stats.tagVertices[3001] = 10;
+    stats.tagVertices[3002] = -1;
+    stats.edgeCounts[101] = 1L << 40;
+    stats.addDegree(101, 5);
+    stats.addDegree(101, 6);
+
+    PartStats decoded;
+    ASSERT_TRUE(PartStats::decode(stats.encode(), decoded));
+    EXPECT_EQ(stats.tagVertices, decoded.tagVertices);
+    EXPECT_EQ(stats.edgeCounts, decoded.edgeCounts);
+    EXPECT_EQ(stats.degreeHistograms, decoded.degreeHistograms);
+
+    auto raw = stats.encode();
+    PartStats broken;
+    EXPECT_FALSE(PartStats::decode(folly::StringPiece(raw.data(), raw.size() - 1), broken));
+}
+
+
+TEST(PartStatsTest, ProcessorsTest) {
+    fs::TempDir rootPath("/tmp/PartStatsTest.XXXXXX");
+    auto partStats = std::make_unique<PartStatsManager>();
+    std::unique_ptr<kvstore::KVStore> kv(TestUtils::initKV(
+                                    rootPath.path(),
+                                    6,
+                                    {0, 0},
+                                    nullptr,
+                                    false,
+                                    nullptr,
+                                    std::make_unique<PartStatsListenerFactory>(partStats.get())));
+    auto schemaMan = TestUtils::mockSchemaMan();
+    auto indexMan = TestUtils::mockIndexMan();
+    // The deletes without indexes remove the keys by a range or a prefix
+    auto noIndexMan = std::make_unique<AdHocIndexManager>();
+    {
+        auto* processor = AddVerticesProcessor::instance(kv.get(),
+                                                         schemaMan.get(),
+                                                         indexMan.get(),
+                                                         nullptr);
+        cpp2::AddVerticesRequest req;
+        req.space_id = 0;
+        req.overwritable = true;
+        for (PartitionID partId = 1; partId <= 3; partId++) {
+            req.parts.emplace(partId,
+                              TestUtils::setupVertices(partId, partId * 10, 10 * (partId + 1)));
+        }
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+    }
+    {
+        auto* processor = AddEdgesProcessor::instance(kv.get(),
+                                                      schemaMan.get(),
+                                                      indexMan.get(),
+                                                      nullptr);
+        cpp2::AddEdgesRequest req;
+        req.space_id = 0;
+        req.overwritable = true;
+        for (PartitionID partId = 1; partId <= 3; partId++) {
+            auto edges = TestUtils::setupEdges(partId, partId * 10, 10 * (partId + 1));
+            auto reverse = TestUtils::setupEdges(partId, partId * 10, 10 * (partId + 1), -101);
+            std::move(reverse.begin(), reverse.end(), std::back_inserter(edges));
+            req.parts.emplace(partId, std::move(edges));
+        }
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+    }
+    {
+        // Delete the edges of the first two sources in each part, and two absent edges
+        auto* processor = DeleteEdgesProcessor::instance(kv.get(),
+                                                         schemaMan.get(),
+                                                         noIndexMan.get());
+        cpp2::DeleteEdgesRequest req;
+        req.space_id = 0;
+        for (PartitionID partId = 1; partId <= 3; partId++) {
+            std::vector<cpp2::EdgeKey> keys;
+            for (auto& edge : TestUtils::setupEdges(partId, partId * 10, partId * 10 + 2)) {
+                keys.emplace_back(edge.key);
+            }
+            for (auto& edge : TestUtils::setupEdges(partId, 100, 102)) {
+                keys.emplace_back(edge.key);
+            }
+            req.parts.emplace(partId, std::move(keys));
+        }
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+    }
+    {
+        // Delete the last vertex in each part, with all its tags and out edges
+        auto* processor = DeleteVerticesProcessor::instance(kv.get(),
+                                                            schemaMan.get(),
+                                                            noIndexMan.get(),
+                                                            nullptr);
+        cpp2::DeleteVerticesRequest req;
+        req.space_id = 0;
+        for (PartitionID partId = 1; partId <= 3; partId++) {
+            req.parts.emplace(partId, std::vector<VertexID>{partId * 10 + 9});
+        }
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+    }
+
+    auto check = [] (const PartStatsManager& manager) {
+        for (PartitionID partId = 1; partId <= 3; partId++) {
+            auto stats = manager.get(0, partId, true);
+            EXPECT_EQ(10, stats.tagVertices.size());
+            EXPECT_EQ(9, stats.tagVertices[0]);
+            EXPECT_EQ(1, stats.edgeCounts.size());
+            EXPECT_EQ(7, stats.edgeCounts[101]);
+            // The degree histograms are derived by compaction only
+            EXPECT_TRUE(stats.degreeHistograms.empty());
+        }
+    };
+    check(*partStats);
+
+    {
+        auto* processor = GetPartStatsProcessor::instance(kv.get(), partStats.get());
+        cpp2::GetPartStatsRequest req;
+        req.set_space_id(0);
+        req.set_parts({1, 2, 3});
+        auto fut = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(fut).get();
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+        ASSERT_EQ(3, resp.stats.size());
+        for (PartitionID partId = 1; partId <= 3; partId++) {
+            EXPECT_EQ(9, resp.stats[partId].tag_vertices[0]);
+            EXPECT_EQ(7, resp.stats[partId].edge_counts[101]);
+        }
+    }
+
+    // The statistics are persisted with the parts, and loaded when they are opened
+    kv.reset();
+    partStats = std::make_unique<PartStatsManager>();
+    kv = TestUtils::initKV(rootPath.path(),
+                           6,
+                           {0, 0},
+                           nullptr,
+                           false,
+                           nullptr,
+                           std::make_unique<PartStatsListenerFactory>(partStats.get()));
+    check(*partStats);
+}
+
+
+TEST(PartStatsTest, MergerTest) {
+    PartStatsManager partStats;
+    CompactionStatsMerger merger(&partStats, 0);
+    // Two subcompactions, each sees the half of part 1
+    merger.onFilterCreated();
+    merger.onFilterCreated();
+    {
+        std::unordered_map<PartitionID, PartStats> stats;
+        stats[1].edgeCounts[101] = 5;
+        merger.onFilterDone(std::move(stats));
+    }
+    EXPECT_TRUE(partStats.get(0, 1).empty());
+    {
+        std::unordered_map<PartitionID, PartStats> stats;
+        stats[1].edgeCounts[101] = 7;
+        stats[2].tagVertices[3001] = 1;
+        merger.onFilterDone(std::move(stats));
+    }
+    EXPECT_EQ(12, partStats.get(0, 1).edgeCounts[101]);
+    EXPECT_EQ(1, partStats.get(0, 2).tagVertices[3001]);
+
+    // The next full compaction starts over
+    merger.onFilterCreated();
+    {
+        std::unordered_map<PartitionID, PartStats> stats;
+        stats[1].edgeCounts[101] = 3;
+        merger.onFilterDone(std::move(stats));
+    }
+    EXPECT_EQ(3, partStats.get(0, 1).edgeCounts[101]);
+}
+
+
+TEST(PartStatsTest, CompactionTest) {
+    fs::TempDir rootPath("/tmp/PartStatsTest.XXXXXX");
+    auto schemaMan = TestUtils::mockSchemaMan();
+    PartStatsManager partStats;
+    std::unique_ptr<kvstore::CompactionFilterFactoryBuilder> cffBuilder(
+                                    new StorageCompactionFilterFactoryBuilder(schemaMan.get(),
+                                                                              nullptr,
+                                                                              &partStats));
+    std::unique_ptr<kvstore::KVStore> kv(TestUtils::initKV(rootPath.path(),
+                                                           6,
+                                                           {0, 0},
+                                                           nullptr,
+                                                           false,
+                                                           std::move(cffBuilder)));
+    for (PartitionID partId = 0; partId < 3; partId++) {
+        std::vector<kvstore::KV> data;
+        for (VertexID vId = partId * 10; vId < (partId + 1) * 10; vId++) {
+            for (TagID tagId = 3001; tagId < 3003; tagId++) {
+                data.emplace_back(NebulaKeyUtils::vertexKey(partId, vId, tagId, 0),
+                                  TestUtils::encodeValue(partId, vId, tagId));
+            }
+            // 7 out edges with 3 versions, and 5 in edges
+            for (VertexID dstId = 10001; dstId <= 10007; dstId++) {
+                for (EdgeVersion version = 0; version < 3; version++) {
+                    data.emplace_back(NebulaKeyUtils::edgeKey(partId, vId, 101, 0, dstId,
+                                                              version),
+                                      TestUtils::encodeValue(partId, vId, dstId, 101));
+                }
+            }
+            for (VertexID srcId = 20001; srcId <= 20005; srcId++) {
+                data.emplace_back(NebulaKeyUtils::edgeKey(partId, vId, -101, 0, srcId, 0),
+                                  TestUtils::setupEncode(10, 20));
+            }
+        }
+        folly::Baton<true, std::atomic> baton;
+        kv->asyncMultiPut(0, partId, std::move(data), [&](kvstore::ResultCode code) {
+            EXPECT_EQ(code, kvstore::ResultCode::SUCCEEDED);
+            baton.post();
+        });
+        baton.wait();
+    }
+
+    auto* ns = static_cast<kvstore::NebulaStore*>(kv.get());
+    ns->compact(0);
+
+    for (PartitionID partId = 0; partId < 3; partId++) {
+        auto stats = partStats.get(0, partId);
+        EXPECT_EQ(10, stats.tagVertices[3001]);
+        EXPECT_EQ(10, stats.tagVertices[3002]);
+        ASSERT_EQ(1, stats.edgeCounts.size());
+        EXPECT_EQ(70, stats.edgeCounts[101]);
+        ASSERT_EQ(1, stats.degreeHistograms.size());
+        EXPECT_EQ(10, stats.degreeHistograms[101][2]);
+    }
+}
+
+
+
+TEST(PartStatsTest, SnapshotFilesTest) {
+    FLAGS_snapshot_file_size = 4096;
+    FLAGS_snapshot_batch_size = 1024;
+    fs::TempDir rootPath("/tmp/PartStatsSnapshotFilesTest.XXXXXX");
+    auto partStats = std::make_unique<PartStatsManager>();
+    auto kv = TestUtils::initKV(rootPath.path(),
+                                6,
+                                {0, 0},
+                                nullptr,
+                                false,
+                                nullptr,
+                                std::make_unique<PartStatsListenerFactory>(partStats.get()));
+    {
+        std::vector<kvstore::KV> data;
+        for (VertexID vId = 0; vId < 100; vId++) {
+            data.emplace_back(NebulaKeyUtils::vertexKey(1, vId, 3001, 0),
+                              TestUtils::encodeValue(1, vId, 3001));
+            for (VertexID dstId = 10001; dstId <= 10002; dstId++) {
+                data.emplace_back(NebulaKeyUtils::edgeKey(1, vId, 101, 0, dstId, 0),
+                                  TestUtils::encodeValue(1, vId, dstId, 101));
+            }
+        }
+        folly::Baton<true, std::atomic> baton;
+        kv->asyncMultiPut(0, 1, std::move(data), [&](kvstore::ResultCode code) {
+            EXPECT_EQ(code, kvstore::ResultCode::SUCCEEDED);
+            baton.post();
+        });
+        baton.wait();
+    }
+    EXPECT_EQ(100, partStats->get(0, 1).tagVertices[3001]);
+    EXPECT_EQ(200, partStats->get(0, 1).edgeCounts[101]);
+
+    auto* store = static_cast<kvstore::NebulaStore*>(kv.get());
+    std::vector<raftex::cpp2::SnapshotFile> chunks;
+    kvstore::SnapshotManagerImpl snapshot(store);
+    ASSERT_TRUE(snapshot.accessAllFilesInSnapshot(0,
+                                                  1,
+                                                  [&] (const raftex::cpp2::SnapshotFile* file,
+                                                       int64_t,
+                                                       int64_t,
+                                                       raftex::SnapshotStatus status) {
+        if (status == raftex::SnapshotStatus::IN_PROGRESS) {
+            chunks.emplace_back(*file);
+        }
+        return true;
+    }));
+    ASSERT_FALSE(chunks.empty());
+
+    // A new replica starts from scratch, and none of the ingested keys is called back
+    auto part = nebula::value(store->part(0, 1));
+    part->cleanup();
+    EXPECT_TRUE(partStats->get(0, 1).empty());
+    for (auto& chunk : chunks) {
+        ASSERT_EQ(1, part->commitSnapshotFile(chunk).first);
+    }
+    part->commitSnapshot({}, 10, 1, true);
+
+    auto stats = partStats->get(0, 1);
+    EXPECT_EQ(100, stats.tagVertices[3001]);
+    EXPECT_EQ(200, stats.edgeCounts[101]);
+    EXPECT_EQ(100, stats.degreeHistograms[101][PartStats::degreeBucket(2)]);
+
+    // The statistics are persisted as well
+    std::string raw;
+    ASSERT_EQ(kvstore::ResultCode::SUCCEEDED,
+              kv->get(0, 1, NebulaKeyUtils::systemStatsKey(1), &raw));
+    PartStats persisted;
+    ASSERT_TRUE(PartStats::decode(raw, persisted));
+    EXPECT_EQ(100, persisted.tagVertices[3001]);
+    EXPECT_EQ(200, persisted.edgeCounts[101]);
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+    return RUN_ALL_TESTS();
+}
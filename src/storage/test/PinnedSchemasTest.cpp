@@ -0,0 +1,89 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <gtest/gtest.h>
+#include "dataman/RowReader.h"
+#include "dataman/RowWriter.h"
+#include "meta/PinnedSchemas.h"
+#include "storage/test/TestUtils.h"
+
+namespace nebula {
+namespace storage {
+
+TEST(PinnedSchemasTest, PinTest) {
+    GraphSpaceID spaceId = 0;
+    auto schemaMan = TestUtils::mockSchemaMan(spaceId);
+    meta::PinnedSchemas schemas(schemaMan.get());
+
+    auto schema = schemas.getTagSchema(spaceId, 3001);
+    ASSERT_NE(nullptr, schema);
+    ASSERT_EQ(schemaMan->getTagSchema(spaceId, 3001).get(), schema.get());
+    // The schema handed out doesn't own it
+    ASSERT_EQ(0, schema.use_count());
+    ASSERT_EQ(schema.get(), schemas.getTagSchema(spaceId, 3001).get());
+    ASSERT_EQ(nullptr, schemas.getTagSchema(spaceId, 3001, 1));
+    ASSERT_EQ(nullptr, schemas.getTagSchema(spaceId + 1, 3001));
+
+    // The schemas are kept once pinned, and so are the ones not exist
+    schemaMan->removeTagSchema(spaceId, 3001);
+    ASSERT_EQ(nullptr, schemaMan->getTagSchema(spaceId, 3001));
+    ASSERT_EQ(schema.get(), schemas.getTagSchema(spaceId, 3001).get());
+    ASSERT_EQ(schema.get(), schemas.getTagSchema(spaceId, 3001, 0).get());
+    schemaMan->addTagSchema(spaceId + 1, 3001, TestUtils::genTagSchemaProvider(3001, 3, 3));
+    ASSERT_EQ(nullptr, schemas.getTagSchema(spaceId + 1, 3001));
+
+    // The tags and the edges are pinned respectively
+    auto edgeSchema = schemas.getEdgeSchema(spaceId, 101);
+    ASSERT_NE(nullptr, edgeSchema);
+    ASSERT_EQ(schemaMan->getEdgeSchema(spaceId, 101).get(), edgeSchema.get());
+    ASSERT_NE(schema.get(), edgeSchema.get());
+    ASSERT_EQ(nullptr, schemas.getEdgeSchema(spaceId, 3001));
+}
+
+
+TEST(PinnedSchemasTest, RowReaderTest) {
+    GraphSpaceID spaceId = 0;
+    auto schemaMan = TestUtils::mockSchemaMan(spaceId);
+    meta::PinnedSchemas schemas(schemaMan.get());
+
+    auto schema = schemaMan->getEdgeSchema(spaceId, 101);
+    RowWriter writer(schema);
+    for (int64_t i = 0; i < 10; i++) {
+        writer << i;
+    }
+    for (int32_t i = 10; i < 20; i++) {
+        writer << folly::stringPrintf("string_col_%d", i);
+    }
+    auto row = writer.encode();
+
+    for (auto i = 0; i < 3; i++) {
+        auto reader = RowReader::getEdgePropReader(&schemas, row, spaceId, 101);
+        ASSERT_NE(nullptr, reader);
+        ASSERT_EQ(schema.get(), reader->getSchema().get());
+        int64_t intVal;
+        ASSERT_EQ(ResultType::SUCCEEDED, reader->getInt("col_9", intVal));
+        ASSERT_EQ(9, intVal);
+        folly::StringPiece strVal;
+        ASSERT_EQ(ResultType::SUCCEEDED, reader->getString("col_10", strVal));
+        ASSERT_EQ("string_col_10", strVal);
+    }
+    // No reader without the schema
+    ASSERT_EQ(nullptr, RowReader::getTagPropReader(&schemas, row, spaceId, 3100));
+    ASSERT_EQ(nullptr, RowReader::getEdgePropReader(&schemas, row, spaceId, 3001));
+    ASSERT_EQ(nullptr, RowReader::getEdgePropReader(schemaMan.get(), row, spaceId, 3001));
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    folly::init(&argc, &argv, true);
+    google::SetStderrLogging(google::INFO);
+    return RUN_ALL_TESTS();
+}
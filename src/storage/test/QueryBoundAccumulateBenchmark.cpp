@@ -0,0 +1,125 @@
+/* Copyright (c) 2020 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License,
+ * attached with Common Clause Condition 1.0, found in the LICENSES directory.
+ */
+
+#include "base/Base.h"
+#include <folly/Benchmark.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <limits>
+#include "fs/TempDir.h"
+#include "base/NebulaKeyUtils.h"
+#include "storage/test/TestUtils.h"
+#include "storage/test/AdHocSchemaManager.h"
+#include "storage/query/QueryBoundProcessor.h"
+
+DEFINE_int32(accumulate_parts, 6, "The parts requested");
+DEFINE_int32(accumulate_vertices, 10000, "The vertices requested in each part");
+DEFINE_int32(accumulate_edges, 2, "The edges of each vertex");
+DEFINE_int32(accumulate_threads, 20, "The threads of the executor");
+DECLARE_int32(max_handlers_per_req);
+
+/**
+ * The accumulation of the results of QueryBoundProcessor, for the requests with many
+ * small-degree vertices, where most of the time is spent on pushing the vertices of all
+ * the buckets into the response.
+ * */
+
+std::unique_ptr<nebula::kvstore::KVStore> gKV;
+std::unique_ptr<nebula::storage::AdHocSchemaManager> gSchemaMan;
+
+namespace nebula {
+namespace storage {
+
+void mockData(kvstore::KVStore* kv) {
+    for (PartitionID partId = 0; partId < FLAGS_accumulate_parts; partId++) {
+        std::vector<kvstore::KV> data;
+        for (VertexID vId = 0; vId < FLAGS_accumulate_vertices; vId++) {
+            for (int32_t i = 0; i < FLAGS_accumulate_edges; i++) {
+                auto key = NebulaKeyUtils::edgeKey(partId, vId, 101, 0, vId + i,
+                                                   std::numeric_limits<int>::max());
+                data.emplace_back(std::move(key), "");
+            }
+        }
+        kv->asyncMultiPut(0, partId, std::move(data), [] (kvstore::ResultCode code) {
+            CHECK_EQ(code, kvstore::ResultCode::SUCCEEDED);
+        });
+    }
+}
+
+void setUp(const char* path) {
+    gKV = TestUtils::initKV(path);
+    gSchemaMan = std::make_unique<AdHocSchemaManager>();
+    gSchemaMan->addEdgeSchema(0, 101, TestUtils::genEdgeSchemaProvider(10, 10));
+    mockData(gKV.get());
+}
+
+cpp2::GetNeighborsRequest buildRequest() {
+    cpp2::GetNeighborsRequest req;
+    req.set_space_id(0);
+    decltype(req.parts) parts;
+    for (PartitionID partId = 0; partId < FLAGS_accumulate_parts; partId++) {
+        for (VertexID vId = 0; vId < FLAGS_accumulate_vertices; vId++) {
+            parts[partId].emplace_back(vId);
+        }
+    }
+    req.set_parts(std::move(parts));
+    std::vector<EdgeType> edgeTypes = {101};
+    req.set_edge_types(std::move(edgeTypes));
+    decltype(req.return_columns) columns;
+    columns.emplace_back(TestUtils::edgePropDef("_dst", PropContext::PropInKeyType::DST));
+    req.set_return_columns(std::move(columns));
+    return req;
+}
+
+void run(int32_t iters, int32_t handlerNum) {
+    cpp2::GetNeighborsRequest req;
+    std::unique_ptr<folly::CPUThreadPoolExecutor> executor;
+    BENCHMARK_SUSPEND {
+        FLAGS_max_handlers_per_req = handlerNum;
+        req = buildRequest();
+        executor = std::make_unique<folly::CPUThreadPoolExecutor>(FLAGS_accumulate_threads);
+    }
+    for (int32_t i = 0; i < iters; i++) {
+        auto* processor = QueryBoundProcessor::instance(gKV.get(),
+                                                        gSchemaMan.get(),
+                                                        nullptr,
+                                                        executor.get());
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+        folly::doNotOptimizeAway(resp);
+    }
+    BENCHMARK_SUSPEND {
+        executor.reset();
+    }
+}
+
+}  // namespace storage
+}  // namespace nebula
+
+BENCHMARK(query_bound_accumulate_1, iters) {
+    nebula::storage::run(iters, 1);
+}
+
+BENCHMARK_RELATIVE(query_bound_accumulate_10, iters) {
+    nebula::storage::run(iters, 10);
+}
+
+BENCHMARK_RELATIVE(query_bound_accumulate_20, iters) {
+    nebula::storage::run(iters, 20);
+}
+/*************************
+ * End of benchmarks
+ ************************/
+
+
+int main(int argc, char** argv) {
+    folly::init(&argc, &argv, true);
+    nebula::fs::TempDir rootPath("/tmp/QueryBoundAccumulateBenchmark.XXXXXX");
+    nebula::storage::setUp(rootPath.path());
+    folly::runBenchmarks();
+    gKV.reset();
+    return 0;
+}
@@ -17,6 +17,7 @@
 
 DECLARE_int32(max_handlers_per_req);
 DECLARE_int32(min_vertices_per_bucket);
+DECLARE_bool(enable_follower_read);
 
 namespace nebula {
 namespace storage {
@@ -609,6 +610,173 @@ TEST(QueryBoundTest, SamplingTest) {
     checkSamplingResponse(resp, 30, 12, 10001, 10007, FLAGS_max_edge_returned_per_vertex);
     FLAGS_max_edge_returned_per_vertex = old_max_edge_returned;
 }
+
+TEST(QueryBoundTest, PagedTest) {
+    fs::TempDir rootPath("/tmp/QueryBoundTest.XXXXXX");
+    LOG(INFO) << "Prepare meta...";
+    std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
+
+    auto schemaMan = TestUtils::mockSchemaMan();
+    mockData(kv.get());
+    auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(3);
+
+    cpp2::GetNeighborsRequest req;
+    std::vector<EdgeType> et = {101};
+    buildRequest(req, et);
+    req.set_limit(7);
+
+    std::unordered_set<VertexID> vertices;
+    int32_t pages = 0;
+    while (true) {
+        auto* processor = QueryBoundProcessor::instance(kv.get(), schemaMan.get(),
+                                                        nullptr, executor.get());
+        auto f = processor->getFuture();
+        processor->process(req);
+        auto resp = std::move(f).get();
+        pages++;
+
+        EXPECT_EQ(0, resp.result.failed_codes.size());
+        ASSERT_LE(resp.vertices.size(), 7);
+        for (auto& vp : resp.vertices) {
+            EXPECT_TRUE(vertices.emplace(vp.vertex_id).second);
+            ASSERT_EQ(1, vp.edge_data.size());
+            EXPECT_EQ(7, vp.edge_data[0].edges.size());
+        }
+        if (!resp.__isset.next_cursor) {
+            break;
+        }
+        ASSERT_EQ(7, resp.vertices.size());
+        req.set_cursor(resp.next_cursor);
+    }
+    EXPECT_EQ(5, pages);
+    EXPECT_EQ(30, vertices.size());
+}
+
+TEST(QueryBoundTest, SupernodeScanTest) {
+    // Every vertex is taken as a super vertex, the edges after the first two are scanned
+    // by ranges in parallel.
+    FLAGS_enable_reservoir_sampling = false;
+    FLAGS_supernode_edges_threshold = 2;
+    FLAGS_supernode_scan_parallelism = 3;
+    fs::TempDir rootPath("/tmp/QueryBoundTest.XXXXXX");
+    LOG(INFO) << "Prepare meta...";
+    std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
+
+    auto schemaMan = TestUtils::mockSchemaMan();
+    mockData(kv.get());
+    auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(3);
+
+    auto query = [&] () {
+        cpp2::GetNeighborsRequest req;
+        std::vector<EdgeType> et = {101};
+        buildRequest(req, et);
+        auto* processor = QueryBoundProcessor::instance(kv.get(), schemaMan.get(),
+                                                        nullptr, executor.get());
+        auto f = processor->getFuture();
+        processor->process(req);
+        return std::move(f).get();
+    };
+    {
+        LOG(INFO) << "The latest version of all edges in order";
+        auto resp = query();
+        checkResponse(resp, 30, 12, 10001, 7);
+    }
+    {
+        LOG(INFO) << "The ranges are truncated to the max edges returned";
+        int old_max_edge_returned = FLAGS_max_edge_returned_per_vertex;
+        FLAGS_max_edge_returned_per_vertex = 5;
+        auto resp = query();
+        checkResponse(resp, 30, 12, 10001, 5);
+
+        LOG(INFO) << "The samples of the ranges are merged";
+        FLAGS_enable_reservoir_sampling = true;
+        resp = query();
+        checkSamplingResponse(resp, 30, 12, 10001, 10007, 5);
+        FLAGS_enable_reservoir_sampling = false;
+        FLAGS_max_edge_returned_per_vertex = old_max_edge_returned;
+    }
+    FLAGS_supernode_edges_threshold = 100000;
+    FLAGS_supernode_scan_parallelism = 8;
+}
+/**
+ * Holds the readIndex of every part until released, so the test could tell whether the
+ * parts are waited together.
+ * */
+class ReadIndexHeldStore : public kvstore::NebulaStore {
+public:
+    using kvstore::NebulaStore::NebulaStore;
+
+    folly::Future<kvstore::ResultCode> readIndex(GraphSpaceID, PartitionID partId) override {
+        std::lock_guard<std::mutex> g(lock_);
+        return held_[partId].getFuture();
+    }
+
+    size_t heldNum() {
+        std::lock_guard<std::mutex> g(lock_);
+        return held_.size();
+    }
+
+    // Answered in the reversed order of the parts
+    void release() {
+        std::map<PartitionID, folly::Promise<kvstore::ResultCode>> held;
+        {
+            std::lock_guard<std::mutex> g(lock_);
+            held.swap(held_);
+        }
+        for (auto it = held.rbegin(); it != held.rend(); it++) {
+            it->second.setValue(kvstore::ResultCode::SUCCEEDED);
+        }
+    }
+
+private:
+    std::mutex lock_;
+    std::map<PartitionID, folly::Promise<kvstore::ResultCode>> held_;
+};
+
+TEST(QueryBoundTest, FollowerReadTest) {
+    FLAGS_enable_follower_read = true;
+    fs::TempDir rootPath("/tmp/QueryBoundTest.XXXXXX");
+    auto ioPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+    auto workers = apache::thrift::concurrency::PriorityThreadManager::newPriorityThreadManager(
+                             1, true /*stats*/);
+    workers->setNamePrefix("executor");
+    workers->start();
+    kvstore::KVOptions options;
+    auto memPartMan = std::make_unique<kvstore::MemPartManager>();
+    for (PartitionID partId = 0; partId < 6; partId++) {
+        memPartMan->partsMap()[0][partId] = PartMeta();
+    }
+    options.partMan_ = std::move(memPartMan);
+    options.dataPaths_ = {folly::stringPrintf("%s/disk1", rootPath.path())};
+    auto kv = std::make_unique<ReadIndexHeldStore>(std::move(options), ioPool,
+                                                   HostAddr(0, 0), workers);
+    kv->init();
+    sleep(1);
+
+    auto schemaMan = TestUtils::mockSchemaMan();
+    mockData(kv.get());
+
+    cpp2::GetNeighborsRequest req;
+    std::vector<EdgeType> et = {101};
+    buildRequest(req, et);
+
+    auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(3);
+    auto* processor = QueryBoundProcessor::instance(kv.get(), schemaMan.get(),
+                                                    nullptr, executor.get());
+    auto f = processor->getFuture();
+    processor->process(req);
+    // All the parts are asked before any is answered, and nothing is read till then
+    ASSERT_EQ(3, kv->heldNum());
+    usleep(100 * 1000);
+    ASSERT_FALSE(f.isReady());
+
+    kv->release();
+    auto resp = std::move(f).get();
+    // The local replicas are the leaders, so the reads are served as usual
+    checkResponse(resp, 30, 12, 10001, 7);
+    FLAGS_enable_follower_read = false;
+}
+
 }  // namespace storage
 }  // namespace nebula
 
@@ -234,6 +234,51 @@ TEST(StorageClientTest, VerticesInterfacesTest) {
         }
         EXPECT_EQ(it, rsReader.end());
     }
+    // Get the neighbors by pages
+    {
+        std::vector<VertexID> vertices;
+        for (int64_t srcId = 0; srcId < 10; srcId++) {
+            vertices.emplace_back(srcId);
+        }
+        std::vector<cpp2::PropDef> retCols;
+        retCols.emplace_back(TestUtils::edgePropDef("_dst", 101));
+        std::mutex lock;
+        size_t pages = 0;
+        std::set<VertexID> dsts;
+        auto f = client->getNeighborsPaged(spaceId, vertices, {101}, "", retCols, 3,
+                                           [&] (cpp2::QueryResponse&& page) {
+            std::lock_guard<std::mutex> g(lock);
+            pages++;
+            EXPECT_EQ(0, page.result.failed_codes.size());
+            EXPECT_GE(3, page.vertices.size());
+            for (auto& vdata : page.vertices) {
+                for (auto& edata : vdata.edge_data) {
+                    for (auto& edge : edata.edges) {
+                        EXPECT_EQ(vdata.vertex_id * 100 + 2, edge.dst);
+                        EXPECT_TRUE(dsts.emplace(edge.dst).second);
+                    }
+                }
+            }
+            return true;
+        });
+        auto resp = std::move(f).get();
+        ASSERT_TRUE(resp.succeeded());
+        // The ten vertices on the only host are returned by four pages
+        ASSERT_EQ(4, pages);
+        ASSERT_EQ(10, dsts.size());
+
+        // No page is asked for once the callback stops it
+        pages = 0;
+        f = client->getNeighborsPaged(spaceId, vertices, {101}, "", retCols, 3,
+                                      [&] (cpp2::QueryResponse&&) {
+            std::lock_guard<std::mutex> g(lock);
+            pages++;
+            return false;
+        });
+        resp = std::move(f).get();
+        ASSERT_TRUE(resp.succeeded());
+        ASSERT_EQ(1, pages);
+    }
     {
         std::unordered_map<VertexID, std::vector<cpp2::EdgeKey>> edgeKeys;
         std::vector<VertexID> vertices;
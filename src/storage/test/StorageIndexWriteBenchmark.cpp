@@ -46,11 +46,13 @@ std::vector<storage::cpp2::Vertex> genVertices(VertexID &vId, TagID tagId) {
 bool processVertices(kvstore::KVStore* kv,
                      meta::SchemaManager* schemaMan,
                      meta::IndexManager* indexMan,
-                     VertexID &vId) {
+                     VertexID &vId,
+                     bool blindWrite = false) {
     cpp2::AddVerticesRequest req;
     BENCHMARK_SUSPEND {
         req.space_id = 0;
         req.overwritable = true;
+        req.index_blind_write = blindWrite;
         std::vector<cpp2::Vertex> vertices;
         auto v = genVertices(vId, 1);
         vertices.insert(vertices.end(), v.begin(), v.end());
@@ -69,7 +71,7 @@ bool processVertices(kvstore::KVStore* kv,
     return true;
 }
 
-void insertVertices(bool withoutIndex) {
+void insertVertices(bool withoutIndex, bool blindWrite = false) {
     std::unique_ptr<kvstore::KVStore> kv;
     std::unique_ptr<meta::SchemaManager> schemaMan;
     std::unique_ptr<meta::IndexManager> indexMan;
@@ -95,7 +97,7 @@ void insertVertices(bool withoutIndex) {
         }
     };
     while (vId < FLAGS_total_vertices_size) {
-        if (!processVertices(kv.get(), schemaMan.get(), indexMan.get(), vId)) {
+        if (!processVertices(kv.get(), schemaMan.get(), indexMan.get(), vId, blindWrite)) {
             LOG(ERROR) << "Vertices bulk insert error";
             return;
         }
@@ -393,6 +395,10 @@ BENCHMARK(attachIndex) {
     insertVertices(false);
 }
 
+BENCHMARK(attachIndexBlindWrite) {
+    insertVertices(false, true);
+}
+
 BENCHMARK(duplicateVerticesIndex) {
     insertDupVertices();
 }
@@ -414,6 +420,7 @@ int main(int argc, char** argv) {
 withoutIndex: Without index, and doesn't through way asyncAtomicOp.
 unmatchIndex: Without match index, and through asyncAtomicOp.
 attachIndex: One index, the index contains all the columns of tag.
+attachIndexBlindWrite: Same as attachIndex, but the old rows are not read by the request.
 duplicateVerticesIndex: One index, and insert deplicate vertices.
 multipleIndex: Three indexes by one tag.
 
@@ -38,7 +38,8 @@ public:
            HostAddr localhost = {0, 0},
            meta::MetaClient* mClient = nullptr,
            bool useMetaServer = false,
-           std::unique_ptr<kvstore::CompactionFilterFactoryBuilder> cffBuilder = nullptr) {
+           std::unique_ptr<kvstore::CompactionFilterFactoryBuilder> cffBuilder = nullptr,
+           std::unique_ptr<kvstore::CommitListenerFactory> listenerFactory = nullptr) {
         auto ioPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
         auto workers = apache::thrift::concurrency::PriorityThreadManager::newPriorityThreadManager(
                                  1, true /*stats*/);
@@ -69,6 +70,7 @@ public:
         // Prepare KVStore
         options.dataPaths_ = std::move(paths);
         options.cffBuilder_ = std::move(cffBuilder);
+        options.listenerFactory_ = std::move(listenerFactory);
         auto store = std::make_unique<kvstore::NebulaStore>(std::move(options),
                                                             ioPool,
                                                             localhost,
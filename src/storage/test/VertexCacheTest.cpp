@@ -41,6 +41,7 @@ void checkCache(VertexCache* cache, uint64_t evicts, uint64_t hits, uint64_t tot
     EXPECT_EQ(evicts, cache->evicts());
     EXPECT_EQ(hits, cache->hits());
     EXPECT_EQ(total, cache->total());
+    EXPECT_EQ(total - hits, cache->misses());
 }
 
 void prepareData(kvstore::KVStore* kv) {
@@ -131,18 +132,53 @@ TEST(VertexCacheTest, SimpleTest) {
     auto indexMan = std::make_unique<AdHocIndexManager>();
     auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(1);
     prepareData(kv.get());
-    VertexCache cache(1000, 0);
+    VertexCache cache(16 * 1024 * 1024, 0);
 
     LOG(INFO) << "Fetch some vertices...";
     fetchVertices(kv.get(), schemaMan.get(), executor.get(), &cache, 0, 1000);
     checkCache(&cache, 0, 0, 1000);
+    EXPECT_EQ(1000, cache.size());
 
     fetchVertices(kv.get(), schemaMan.get(), executor.get(), &cache, 500, 1500);
-    checkCache(&cache, 500, 500, 2000);
+    checkCache(&cache, 0, 500, 2000);
+    EXPECT_EQ(1500, cache.size());
 
     LOG(INFO) << "Insert vertices from 0 to 1000";
     addVertices(kv.get(), schemaMan.get(), indexMan.get(), &cache, 1000);
-    checkCache(&cache, 1000, 500, 2000);
+    // The updated vertices are invalidated, which are not counted as evictions
+    checkCache(&cache, 0, 500, 2000);
+    EXPECT_EQ(500, cache.size());
+    for (VertexID vId = 0; vId < 1000; vId++) {
+        EXPECT_FALSE(cache.contains(std::make_pair(vId, 3001), 0));
+    }
+}
+
+
+TEST(VertexCacheTest, ScanTest) {
+    FLAGS_max_handlers_per_req = 1;
+    fs::TempDir rootPath("/tmp/VertexCacheTest.XXXXXX");
+    std::unique_ptr<kvstore::KVStore> kv = TestUtils::initKV(rootPath.path());
+    auto schemaMan = TestUtils::mockSchemaMan();
+    auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(1);
+    prepareData(kv.get());
+    // About one hundred vertices fit in
+    VertexCache cache(32 * 1024, 0);
+
+    LOG(INFO) << "Fetch the hot vertices...";
+    for (int32_t round = 0; round < 10; round++) {
+        fetchVertices(kv.get(), schemaMan.get(), executor.get(), &cache, 0, 50);
+    }
+    checkCache(&cache, 0, 450, 500);
+
+    LOG(INFO) << "Scan all the vertices once...";
+    fetchVertices(kv.get(), schemaMan.get(), executor.get(), &cache, 50, 10000);
+    EXPECT_LT(0, cache.rejects());
+    EXPECT_LE(cache.usage(), 32 * 1024);
+
+    // The hot vertices are not flushed by the scan
+    auto hits = cache.hits();
+    fetchVertices(kv.get(), schemaMan.get(), executor.get(), &cache, 0, 50);
+    EXPECT_LE(hits + 45, cache.hits());
 }
 
 }  // namespace storage
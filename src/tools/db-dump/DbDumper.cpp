@@ -359,6 +359,21 @@ void DbDumper::run() {
     for (auto &e : edgeStat_) {
         std::cout << "\t" << getEdgeName(e.first) << " : " << e.second << "\n";
     }
+    PartStats total;
+    for (auto &part : statsCollector_.finish()) {
+        total.merge(part.second);
+    }
+    std::cout << "DEGREE HISTOGRAMS: \n";
+    for (auto &h : total.degreeHistograms) {
+        std::cout << "\t" << getEdgeName(h.first) << " :";
+        for (size_t i = 0; i < h.second.size(); i++) {
+            if (h.second[i] > 0) {
+                std::cout << " [" << (1L << i) << ", " << (1L << (i + 1)) << "): "
+                          << h.second[i];
+            }
+        }
+        std::cout << "\n";
+    }
     std::cout << "============================STATISTICS===========================\n";
     std::cout << "Time cost: " << dur.elapsedInUSec() << " us\n\n";
 }
@@ -409,6 +424,7 @@ void DbDumper::iterates(kvstore::RocksPrefixIter* it) {
             }
 
             // statistics
+            statsCollector_.collect(key);
             auto tagStat = tagStat_.find(NebulaKeyUtils::getTagId(key));
             if (tagStat == tagStat_.end()) {
                 tagStat_.emplace(tagId, 1);
@@ -444,6 +460,7 @@ void DbDumper::iterates(kvstore::RocksPrefixIter* it) {
             }
 
             // statistics
+            statsCollector_.collect(key);
             auto edgeStat = edgeStat_.find(edgeType);
             if (edgeStat == edgeStat_.end()) {
                 edgeStat_.emplace(edgeType, 1);
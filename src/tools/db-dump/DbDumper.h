@@ -14,6 +14,7 @@
 #include "meta/ServerBasedSchemaManager.h"
 #include "kvstore/RocksEngine.h"
 #include "dataman/RowReader.h"
+#include "storage/PartStats.h"
 
 DECLARE_string(space);
 DECLARE_string(db_path);
@@ -81,6 +82,8 @@ private:
     int64_t                                                        count_{0};
     int64_t                                                        vertexCount_{0};
     int64_t                                                        edgeCount_{0};
+    // The degree histograms, the same as the ones derived by compaction
+    PartStatsCollector                                             statsCollector_;
 };
 }  // namespace storage
 }  // namespace nebula